@@ -0,0 +1,784 @@
+/**
+ * @file frontier_bench.cpp
+ * @brief Google Benchmark suite for the core data paths
+ *
+ * Each benchmark runs against a synthetic database seeded once per
+ * dataset size and kept for the rest of the run. The size argument is
+ * roughly the number of transactions over three years; items and recipes
+ * scale with it, and SyntheticDataGenerator adds the shifts, production,
+ * cycles and fuel entries of each work day (see seedDatabase). Build with
+ * -DFRONTIER_BUILD_BENCHMARKS=ON and run frontier_bench.
+ *
+ * Every benchmark also reports heap allocations per iteration ("allocs";
+ * counted through malloc on glibc, 0 elsewhere). The BM_Scenario set
+ * covers the user-facing paths end to end and doubles as a regression
+ * gate against recorded budgets:
+ *
+ *   frontier_bench --benchmark_filter=Scenario --record-budgets=budgets.json
+ *   frontier_bench --benchmark_filter=Scenario --budgets=budgets.json
+ *
+ * The second run exits with 1 when a benchmark's wall time or allocation
+ * count exceeds its budget by more than the file's tolerances (overridden
+ * with --time-tolerance=0.25 and --alloc-tolerance=0.1), when a benchmark
+ * that ran has no budget and is not listed under "exempt" in the file, or
+ * when the filter matched no benchmark at all. It exits with
+ * NoBudgetsExitCode, before measuring anything, when the budgets file does
+ * not exist yet, so ctest reports the scenarios as skipped rather than
+ * failed; ctest runs each scenario this way as a test labelled perf
+ * (ctest -L perf).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QTimeZone>
+#include <QtEndian>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/itemimporter.h"
+#include "core/productionsolver.h"
+#include "core/pricescenarioengine.h"
+#include "core/saveparser.h"
+#include "core/syntheticdata.h"
+#include "core/transactionstore.h"
+
+using namespace Frontier;
+
+// =============================================================================
+// Allocation Counting
+// =============================================================================
+// Qt containers allocate through malloc rather than operator new, so the
+// count comes from malloc itself; glibc exports the real allocator under
+// __libc_* names for exactly this kind of interposition.
+
+namespace {
+std::atomic<qint64> g_allocations{0};
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace {
+
+/**
+ * @brief Reports the allocations from here to the end of the benchmark,
+ * per iteration; declare it just before the timing loop
+ */
+class AllocationScope
+{
+public:
+    explicit AllocationScope(benchmark::State &state)
+        : m_state(state), m_start(g_allocations.load(std::memory_order_relaxed)) {}
+    ~AllocationScope()
+    {
+        const qint64 count = g_allocations.load(std::memory_order_relaxed) - m_start;
+        m_state.counters["allocs"] = benchmark::Counter(double(count), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State &m_state;
+    qint64 m_start;
+};
+
+QTemporaryDir &benchDir()
+{
+    static QTemporaryDir dir;
+    return dir;
+}
+
+int itemCountFor(int transactions) { return qBound(200, transactions / 10, 20000); }
+int recipeCountFor(int transactions) { return itemCountFor(transactions) / 4; }
+
+// =============================================================================
+// Seeding
+// =============================================================================
+
+void seedDatabase(Database &db, int transactions)
+{
+    SyntheticDataOptions options;
+    options.syntheticItems = itemCountFor(transactions);
+    options.syntheticRecipes = recipeCountFor(transactions);
+    options.endDate = QDate(2026, 1, 1);
+    options.years = 3;
+    options.transactionsPerDay = qMax(1, transactions / (3 * 365));
+    options.seed = quint32(transactions);
+
+    SyntheticDataGenerator generator(&db);
+    if (!generator.generate(options)) {
+        qFatal("Could not seed benchmark database: %s", qPrintable(generator.lastError()));
+    }
+}
+
+// Seeded once per size and reused by every benchmark at that size
+Database &databaseFor(int transactions)
+{
+    static std::map<int, std::unique_ptr<Database>> databases;
+    auto &db = databases[transactions];
+    if (!db) {
+        db = std::make_unique<Database>();
+        const QString path = databasePathFor(transactions);
+        if (!db->initialize(path)) {
+            qFatal("Could not create benchmark database: %s", qPrintable(db->lastError()));
+        }
+        seedDatabase(*db, transactions);
+    }
+    return *db;
+}
+
+QString itemsJsonFor(int count)
+{
+    const QString path = benchDir().filePath(QString("items_%1.json").arg(count));
+    if (QFile::exists(path)) {
+        return path;
+    }
+
+    QJsonArray array;
+    for (const Item &item : SyntheticDataGenerator::syntheticItems(count)) {
+        QJsonObject obj;
+        obj["code"] = item.code;
+        obj["name"] = item.name;
+        obj["category_main"] = item.categoryMain;
+        obj["category_sub"] = item.categorySub;
+        obj["buy_price_internal"] = item.buyPriceInternal;
+        obj["buy_price_display"] = item.buyPriceDisplay;
+        obj["sell_price_internal"] = item.sellPriceInternal;
+        obj["sell_price_display"] = item.sellPriceDisplay;
+        obj["weight"] = item.weight;
+        obj["is_craftable"] = item.isCraftable;
+        obj["pricing_group"] = "Base70";
+        array.append(obj);
+    }
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(array).toJson(QJsonDocument::Compact));
+    }
+    return path;
+}
+
+QString databasePathFor(int transactions)
+{
+    return benchDir().filePath(QString("bench_%1.db").arg(transactions));
+}
+
+// =============================================================================
+// Synthetic Save
+// =============================================================================
+
+/**
+ * @brief Writes the subset of GVAS that SaveParser reads: the header, a
+ * TransactionsHistory struct array and the player's money
+ */
+class GvasWriter
+{
+public:
+    QByteArray bytes;
+
+    template <typename T>
+    void write(T value)
+    {
+        char raw[sizeof(T)];
+        qToLittleEndian(value, raw);
+        bytes.append(raw, sizeof(T));
+    }
+
+    void writeString(const QByteArray &str)
+    {
+        write<qint32>(qint32(str.size() + 1));
+        bytes.append(str);
+        bytes.append('\0');
+    }
+
+    static qint64 stringSize(const QByteArray &str) { return 4 + str.size() + 1; }
+
+    void writeStr(const QByteArray &name, const QByteArray &value)
+    {
+        writeString(name);
+        writeString("StrProperty");
+        write<qint64>(stringSize(value));
+        write<quint8>(0);
+        writeString(value);
+    }
+
+    void writeInt(const QByteArray &name, qint32 value)
+    {
+        writeString(name);
+        writeString("IntProperty");
+        write<qint64>(4);
+        write<quint8>(0);
+        write<qint32>(value);
+    }
+
+    void writeDateTime(const QByteArray &name, const QDateTime &time)
+    {
+        constexpr qint64 UnixEpochTicks = 621355968000000000LL;
+        writeString(name);
+        writeString("StructProperty");
+        write<qint64>(8);
+        writeString("DateTime");
+        bytes.append(16, '\0');
+        write<quint8>(0);
+        write<qint64>(time.toMSecsSinceEpoch() * 10000 + UnixEpochTicks);
+    }
+};
+
+QString saveFileFor(int transactions)
+{
+    const QString path = benchDir().filePath(QString("save_%1.sav").arg(transactions));
+    if (QFile::exists(path)) {
+        return path;
+    }
+
+    GvasWriter elements;
+    const QDateTime start(QDate(2023, 1, 1), QTime(8, 0), QTimeZone::utc());
+    const int items = itemCountFor(transactions);
+    for (int i = 0; i < transactions; ++i) {
+        const bool sale = i % 3 != 0;
+        elements.writeStr("Item", QByteArray::number(100000 + i % items));
+        elements.writeStr("Category", sale ? "Sale" : "Purchase");
+        elements.writeInt("Amount", sale ? 150 + i % 900 : -(80 + i % 400));
+        elements.writeDateTime("Time", start.addSecs(qint64(i) * 600));
+        elements.writeString("None");
+    }
+
+    GvasWriter array;
+    array.write<qint32>(transactions);
+    array.writeString("TransactionsHistory");
+    array.writeString("StructProperty");
+    array.write<qint64>(elements.bytes.size());
+    array.writeString("TransactionData");
+    array.bytes.append(16, '\0');
+    array.write<quint8>(0);
+    array.bytes.append(elements.bytes);
+
+    GvasWriter save;
+    save.bytes.append("GVAS");
+    save.write<qint32>(2);                   // Save game version
+    save.write<qint32>(522);                 // Package version
+    save.write<quint16>(5);
+    save.write<quint16>(1);
+    save.write<quint16>(1);
+    save.write<quint32>(0);                  // Changelist
+    save.writeString("++UE5+Release-5.1");
+    save.write<qint32>(3);                   // Custom version format
+    save.write<qint32>(0);                   // No custom versions
+    save.writeString("/Script/OutOfOre.SaveGame");
+    save.writeString("TransactionsHistory");
+    save.writeString("ArrayProperty");
+    save.write<qint64>(array.bytes.size());
+    save.writeString("StructProperty");
+    save.write<quint8>(0);
+    save.bytes.append(array.bytes);
+    save.writeInt("NewMoney", 250000);
+    save.writeString("None");
+
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(save.bytes);
+    }
+    return path;
+}
+
+} // namespace
+
+// =============================================================================
+// Database Reads
+// =============================================================================
+
+static void BM_GetAllRecipes(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getAllRecipes());
+    }
+}
+
+static void BM_GetFinanceSummary(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const QDate to = QDate::currentDate();
+    const QDate from = to.addYears(-1);
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getFinanceSummary(from, to));
+    }
+}
+
+static void BM_CalculateBalances(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.calculateBalances());
+    }
+}
+
+static void BM_GetAllInventory(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getAllInventory());
+    }
+}
+
+// The ledger's search box typed one letter at a time: each prefix of an
+// item name re-reads the first page and the totals, as LedgerTab does
+static void BM_LedgerSearch(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const QString name = db.itemCatalog().items().value(0).name;
+    TransactionQuery filter;
+    filter.limit = 200;
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        for (int length = 1; length <= name.size(); ++length) {
+            filter.search = name.left(length);
+            benchmark::DoNotOptimize(db.queryTransactions(filter));
+            benchmark::DoNotOptimize(db.getTransactionTotals(filter));
+        }
+    }
+}
+
+// =============================================================================
+// Transaction Store
+// =============================================================================
+
+// The first call per size loads the store; iterations time the scans only
+static void BM_StoreFinanceSummary(benchmark::State &state)
+{
+    TransactionStore &store = databaseFor(int(state.range(0))).transactionStore();
+    const QDate to = QDate::currentDate();
+    const QDate from = to.addYears(-1);
+    store.size();
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.summary(from, to));
+    }
+}
+
+static void BM_StoreBalances(benchmark::State &state)
+{
+    TransactionStore &store = databaseFor(int(state.range(0))).transactionStore();
+    store.size();
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.balances());
+    }
+}
+
+// =============================================================================
+// Production Calculator
+// =============================================================================
+
+static void BM_BuildProductionTree(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    ProductionSolver solver(db.recipeGraph());
+    const ItemCatalog &catalog = db.itemCatalog();
+    const int recipes = solver.graph()->recipeCount();
+    const auto noStock = [](const QString &) { return 0; };
+    int next = 0;
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(solver.buildTree(next, 10, true, catalog, noStock));
+        next = (next + 1) % recipes;
+    }
+}
+
+// =============================================================================
+// Importers
+// =============================================================================
+
+static void BM_LoadItemsJson(benchmark::State &state)
+{
+    const QString path = itemsJsonFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ItemImporter::loadFromJson(path));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ImportItemsJson(benchmark::State &state)
+{
+    const QString path = itemsJsonFor(int(state.range(0)));
+    Database db;
+    db.initialize(benchDir().filePath(QString("import_%1.db").arg(state.range(0))));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        ItemImporter::importFromJson(path, &db, true);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// =============================================================================
+// Scenarios
+// =============================================================================
+// End-to-end versions of what the app does at a user's request, for the
+// budget gate; each one reaches the same core calls as its UI path.
+
+// Opening an existing database and loading the catalog, as main() and the
+// first tab do
+static void BM_ScenarioStartup(benchmark::State &state)
+{
+    const int transactions = int(state.range(0));
+    databaseFor(transactions);
+    const QString path = databasePathFor(transactions);
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        Database db;
+        if (!db.initialize(path)) {
+            state.SkipWithError("initialize failed");
+            break;
+        }
+        benchmark::DoNotOptimize(db.getItemCount());
+        benchmark::DoNotOptimize(db.itemCatalog().size());
+    }
+}
+
+// The ledger's full load
+static void BM_ScenarioLedgerLoad(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.getAllTransactions());
+    }
+}
+
+// CostAnalysisTab::loadRecipeProfitability and the scenario batch it runs
+static void BM_ScenarioCostAnalysisRefresh(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    const ItemCatalog &catalog = db.itemCatalog();
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        ProductionSolver solver(db.recipeGraph());
+        benchmark::DoNotOptimize(solver.evaluateRecipes(catalog));
+
+        PriceScenarioEngine engine;
+        engine.compile(solver.graph(), catalog);
+        QVector<PriceScenario> batch;
+        PriceAdjustment all;
+        all.sellPercent = -10;
+        batch.append({"What-If", {all}});
+        for (const QString &category : engine.categories()) {
+            PriceAdjustment adjustment = all;
+            adjustment.category = category;
+            batch.append({category, {adjustment}});
+        }
+        benchmark::DoNotOptimize(engine.run(batch));
+    }
+}
+
+// The production calculator on a long run count with the full chain expanded
+static void BM_ScenarioDeepProductionTree(benchmark::State &state)
+{
+    Database &db = databaseFor(int(state.range(0)));
+    ProductionSolver solver(db.recipeGraph());
+    const ItemCatalog &catalog = db.itemCatalog();
+    const int recipes = solver.graph()->recipeCount();
+    const auto noStock = [](const QString &) { return 0; };
+    int next = 0;
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        for (int i = 0; i < 16; ++i) {
+            benchmark::DoNotOptimize(solver.buildTree(next, 1000, true, catalog, noStock));
+            next = (next + 1) % recipes;
+        }
+    }
+}
+
+static void BM_ScenarioItemsImport(benchmark::State &state)
+{
+    const QString path = itemsJsonFor(int(state.range(0)));
+    Database db;
+    db.initialize(benchDir().filePath(QString("scenario_import_%1.db").arg(state.range(0))));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        ItemImporter::importFromJson(path, &db, true);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ScenarioSaveParse(benchmark::State &state)
+{
+    const QString path = saveFileFor(int(state.range(0)));
+    const AllocationScope allocations(state);
+    for (auto _ : state) {
+        const SaveGameData data = SaveParser::parseFile(path);
+        if (data.transactions.size() != state.range(0)) {
+            state.SkipWithError("synthetic save did not parse");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_GetAllRecipes)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetFinanceSummary)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CalculateBalances)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StoreFinanceSummary)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StoreBalances)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_GetAllInventory)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LedgerSearch)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildProductionTree)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadItemsJson)->Arg(500)->Arg(5000)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ImportItemsJson)->Arg(500)->Arg(5000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ScenarioStartup)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioLedgerLoad)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioCostAnalysisRefresh)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioDeepProductionTree)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioItemsImport)->Arg(5000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScenarioSaveParse)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// Budgets
+// =============================================================================
+
+namespace {
+
+// Nothing recorded to compare against; ctest's SKIP_RETURN_CODE
+constexpr int NoBudgetsExitCode = 77;
+
+struct Budget {
+    double realNs = 0;
+    double allocs = 0;
+};
+
+struct BudgetFile {
+    double timeTolerance = 0.25;
+    double allocTolerance = 0.10;
+    std::map<std::string, Budget> budgets;
+    std::set<std::string> exempt;       // Run without a budget on purpose
+};
+
+/**
+ * @brief Console output as usual, plus each finished run's time and allocations
+ */
+class BudgetReporter : public benchmark::ConsoleReporter
+{
+public:
+    void ReportRuns(const std::vector<Run> &runs) override
+    {
+        benchmark::ConsoleReporter::ReportRuns(runs);
+        for (const Run &run : runs) {
+            if (run.run_type != Run::RT_Iteration || run.iterations == 0) {
+                continue;
+            }
+            Budget measured;
+            measured.realNs = run.GetAdjustedRealTime() * 1e9 / benchmark::GetTimeUnitMultiplier(run.time_unit);
+            auto allocs = run.counters.find("allocs");
+            if (allocs != run.counters.end()) {
+                measured.allocs = allocs->second.value;
+            }
+            m_measured[run.benchmark_name()] = measured;
+        }
+    }
+
+    const std::map<std::string, Budget> &measured() const { return m_measured; }
+
+private:
+    std::map<std::string, Budget> m_measured;
+};
+
+bool readBudgets(const QString &path, BudgetFile &file)
+{
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly)) {
+        std::cerr << "Could not read budgets " << qPrintable(path) << ": "
+                  << qPrintable(in.errorString()) << '\n';
+        return false;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(in.readAll()).object();
+    file.timeTolerance = root.value("timeTolerance").toDouble(file.timeTolerance);
+    file.allocTolerance = root.value("allocTolerance").toDouble(file.allocTolerance);
+    const QJsonObject budgets = root.value("budgets").toObject();
+    for (auto it = budgets.begin(); it != budgets.end(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        file.budgets[it.key().toStdString()] = {entry.value("realNs").toDouble(),
+                                                entry.value("allocs").toDouble()};
+    }
+    for (const QJsonValue &name : root.value("exempt").toArray()) {
+        file.exempt.insert(name.toString().toStdString());
+    }
+    return true;
+}
+
+bool writeBudgets(const QString &path, const BudgetFile &file, const std::map<std::string, Budget> &measured)
+{
+    QJsonObject budgets;
+    for (const auto &[name, budget] : measured) {
+        if (file.exempt.count(name) > 0) {
+            continue;
+        }
+        budgets[QString::fromStdString(name)] = QJsonObject{
+            {"realNs", qRound64(budget.realNs)},
+            {"allocs", qRound64(budget.allocs)}
+        };
+    }
+    QJsonArray exempt;
+    for (const std::string &name : file.exempt) {
+        exempt.append(QString::fromStdString(name));
+    }
+    const QJsonObject root{
+        {"timeTolerance", file.timeTolerance},
+        {"allocTolerance", file.allocTolerance},
+        {"budgets", budgets},
+        {"exempt", exempt}
+    };
+
+    QFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        std::cerr << "Could not write budgets " << qPrintable(path) << ": "
+                  << qPrintable(out.errorString()) << '\n';
+        return false;
+    }
+    out.write(QJsonDocument(root).toJson());
+    return true;
+}
+
+// Number of runs over budget or without one; exempt runs are listed, not failed
+int checkBudgets(const BudgetFile &file, const std::map<std::string, Budget> &measured)
+{
+    if (measured.empty()) {
+        // A renamed scenario would otherwise pass by running nothing
+        std::cout << "[budget] no benchmark matched the filter\n";
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto &[name, run] : measured) {
+        auto it = file.budgets.find(name);
+        if (it == file.budgets.end()) {
+            const bool exempt = file.exempt.count(name) > 0;
+            if (!exempt) {
+                ++failures;
+            }
+            std::cout << "[budget] " << name << (exempt ? ": exempt" : ": MISSING, record one or list it as exempt")
+                      << '\n';
+            continue;
+        }
+        const Budget &budget = it->second;
+        const double timeLimit = budget.realNs * (1.0 + file.timeTolerance);
+        const double allocLimit = budget.allocs * (1.0 + file.allocTolerance);
+        const bool slow = run.realNs > timeLimit;
+        // Allocation counts are 0 when they cannot be counted; nothing to compare then
+        const bool allocating = budget.allocs > 0 && run.allocs > allocLimit;
+        if (slow || allocating) {
+            ++failures;
+        }
+        std::cout << "[budget] " << name << (slow || allocating ? ": OVER" : ": ok")
+                  << "  time " << run.realNs / 1e6 << " ms (budget " << budget.realNs / 1e6 << " ms)"
+                  << "  allocs " << qRound64(run.allocs) << " (budget " << qRound64(budget.allocs) << ")\n";
+    }
+    return failures;
+}
+
+// Removes --name=value from the arguments and returns value
+QString takeOption(int &argc, char **argv, const char *name)
+{
+    const QByteArray prefix = QByteArray("--") + name + '=';
+    QString value;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]).startsWith(prefix)) {
+            value = QString::fromLocal8Bit(argv[i] + prefix.size());
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    const QString budgetsPath = takeOption(argc, argv, "budgets");
+    const QString recordPath = takeOption(argc, argv, "record-budgets");
+    const QString timeTolerance = takeOption(argc, argv, "time-tolerance");
+    const QString allocTolerance = takeOption(argc, argv, "alloc-tolerance");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    BudgetFile budgets;
+    const bool budgetsMissing = !budgetsPath.isEmpty() && !QFileInfo::exists(budgetsPath);
+    if (budgetsMissing && recordPath.isEmpty()) {
+        std::cout << "No budgets recorded at " << qPrintable(budgetsPath)
+                  << "; record them with --record-budgets\n";
+        return NoBudgetsExitCode;
+    }
+    // When recording the first file there is nothing to check against yet
+    const bool checking = !budgetsPath.isEmpty() && !budgetsMissing;
+    if (checking && !readBudgets(budgetsPath, budgets)) {
+        return 1;
+    }
+    if (!timeTolerance.isEmpty()) {
+        budgets.timeTolerance = timeTolerance.toDouble();
+    }
+    if (!allocTolerance.isEmpty()) {
+        budgets.allocTolerance = allocTolerance.toDouble();
+    }
+
+    BudgetReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (!recordPath.isEmpty() && !writeBudgets(recordPath, budgets, reporter.measured())) {
+        return 1;
+    }
+    if (checking) {
+        const int failures = checkBudgets(budgets, reporter.measured());
+        if (failures > 0) {
+            std::cout << failures << " benchmark(s) over budget or unbudgeted\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file capitalplanservice.cpp
+ * @brief Cached capital plan totals and affordability
+ */
+
+#include "capitalplanservice.h"
+#include "database.h"
+#include "transactionstore.h"
+
+namespace Frontier {
+
+// =============================================================================
+// Summary
+// =============================================================================
+
+int CapitalPlanSummary::fundsUsedPercent() const
+{
+    if (available() <= 0) {
+        return grandTotal() > 0 ? 100 : 0;
+    }
+    return qBound(0, static_cast<int>((grandTotal() / available()) * 100), 100);
+}
+
+int CapitalPlanSummary::powerCoveragePercent() const
+{
+    if (facility.powerKw > 0) {
+        return qBound(0, static_cast<int>((facility.generatedKw / facility.powerKw) * 100), 100);
+    }
+    return facility.generatedKw > 0 ? 100 : 0;
+}
+
+// =============================================================================
+// Service
+// =============================================================================
+
+CapitalPlanService::CapitalPlanService(Database *database)
+    : m_database(database)
+{
+}
+
+const CapitalPlanSummary &CapitalPlanService::summary()
+{
+    if (!m_equipmentValid) {
+        m_summary.equipment = m_database->getEquipmentPlanTotals();
+        m_equipmentValid = true;
+    }
+    if (!m_facilityValid) {
+        m_summary.facility = m_database->getFacilityPlanTotals();
+        m_facilityValid = true;
+    }
+    if (!m_balancesValid) {
+        m_summary.balances = m_database->transactionStore().balances();
+        m_balancesValid = true;
+    }
+    return m_summary;
+}
+
+void CapitalPlanService::setEquipmentTotals(const PlanTotals &totals)
+{
+    m_summary.equipment = totals;
+    m_equipmentValid = true;
+}
+
+void CapitalPlanService::setFacilityTotals(const PlanTotals &totals)
+{
+    m_summary.facility = totals;
+    m_facilityValid = true;
+}
+
+void CapitalPlanService::invalidate(DataTables tables)
+{
+    if (tables & DataTable::CapitalPlan) {
+        m_equipmentValid = false;
+        m_facilityValid = false;
+    }
+    if (tables & DataTable::Transactions) {
+        m_balancesValid = false;
+    }
+}
+
+} // namespace Frontier
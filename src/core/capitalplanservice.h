@@ -0,0 +1,72 @@
+/**
+ * @file capitalplanservice.h
+ * @brief Cached capital plan totals and affordability
+ */
+
+#ifndef CAPITALPLANSERVICE_H
+#define CAPITALPLANSERVICE_H
+
+#include "types.h"
+#include "datachangebus.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Plan totals next to the funds available to pay for them
+ */
+struct CapitalPlanSummary {
+    PlanTotals equipment;
+    PlanTotals facility;
+    AccountBalance balances;
+
+    double grandTotal() const { return equipment.cost + facility.cost; }
+    double available() const { return balances.total(); }
+    double remaining() const { return available() - grandTotal(); }
+    bool isEmpty() const { return equipment.lineCount == 0 && facility.lineCount == 0; }
+    bool affordable() const { return remaining() >= 0; }
+
+    // Share of available funds the plan would use, clamped to 0-100
+    int fundsUsedPercent() const;
+    // Generated power as a share of the facility draw, clamped to 0-100
+    int powerCoveragePercent() const;
+};
+
+/**
+ * @brief Capital plan figures shared by the dashboard and budget overview
+ *
+ * Each part of the summary (equipment totals, facility totals, account
+ * balances) is read once, the plans with an aggregate query and the
+ * balances from the TransactionStore, and kept until a write
+ * to its table invalidates it through Database::markDirty(). The planners
+ * already hold their totals in a PlanModel and hand them over after each
+ * edit, so reading the summary after a planner change runs no query.
+ *
+ * Owned by Database and used on its thread.
+ */
+class CapitalPlanService
+{
+public:
+    explicit CapitalPlanService(Database *database);
+
+    // Loads whatever is stale, then returns the cached summary
+    const CapitalPlanSummary &summary();
+
+    // Called by the planners with their model totals after a write
+    void setEquipmentTotals(const PlanTotals &totals);
+    void setFacilityTotals(const PlanTotals &totals);
+
+    void invalidate(DataTables tables);
+
+private:
+    Database *m_database;
+    CapitalPlanSummary m_summary;
+    bool m_equipmentValid = false;
+    bool m_facilityValid = false;
+    bool m_balancesValid = false;
+};
+
+} // namespace Frontier
+
+#endif // CAPITALPLANSERVICE_H
@@ -0,0 +1,545 @@
+/**
+ * @file commandjournal.cpp
+ * @brief Undo/redo journal implementation
+ */
+
+#include "commandjournal.h"
+#include "database.h"
+#include "profiler.h"
+
+#include <QDebug>
+#include <optional>
+#include <utility>
+
+namespace Frontier {
+
+namespace {
+
+// =============================================================================
+// Row Commands
+// =============================================================================
+
+// Single-row writes per table; add() stores the new id in the row
+template <typename Row>
+struct RowOps;
+
+template <>
+struct RowOps<Transaction> {
+    static constexpr JournalChange::Table table = JournalChange::Transactions;
+
+    static bool add(Database &db, Transaction &row)
+    {
+        int id = 0;
+        if (!db.addTransaction(row, &id)) {
+            return false;
+        }
+        row.id = id;
+        return true;
+    }
+    static bool restore(Database &db, const Transaction &row) { return db.restoreTransaction(row); }
+    static bool update(Database &db, const Transaction &row) { return db.updateTransaction(row); }
+    static bool remove(Database &db, int id) { return db.deleteTransaction(id); }
+};
+
+template <>
+struct RowOps<Budget> {
+    static constexpr JournalChange::Table table = JournalChange::Budgets;
+
+    static bool add(Database &db, Budget &row)
+    {
+        const int id = db.addBudget(row);
+        if (id <= 0) {
+            return false;
+        }
+        row.id = id;
+        return true;
+    }
+    static bool restore(Database &db, const Budget &row) { return db.restoreBudget(row); }
+    static bool update(Database &db, const Budget &row) { return db.updateBudget(row); }
+    static bool remove(Database &db, int id) { return db.deleteBudget(id); }
+};
+
+// A whole row before and after: no before is an add, no after a delete
+template <typename Row>
+class RowCommand : public JournalCommand
+{
+public:
+    RowCommand(const QString &text, std::optional<Row> before, std::optional<Row> after)
+        : m_text(text)
+        , m_before(std::move(before))
+        , m_after(std::move(after))
+    {
+    }
+
+    QString text() const override { return m_text; }
+
+    bool redo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return apply(db, m_before, m_after, changes);
+    }
+
+    bool undo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return apply(db, m_after, m_before, changes);
+    }
+
+private:
+    using Ops = RowOps<Row>;
+
+    static bool apply(Database &db, const std::optional<Row> &from, std::optional<Row> &to,
+                      QVector<JournalChange> &changes)
+    {
+        if (!from.has_value()) {
+            Row &row = *to;
+            const bool ok = row.id.has_value() ? Ops::restore(db, row) : Ops::add(db, row);
+            if (ok) {
+                changes.append(JournalChange{Ops::table, row.id.value(), JournalChange::Inserted});
+            }
+            return ok;
+        }
+
+        const int id = from->id.value_or(0);
+        if (!to.has_value()) {
+            if (!Ops::remove(db, id)) {
+                return false;
+            }
+            changes.append(JournalChange{Ops::table, id, JournalChange::Removed});
+            return true;
+        }
+
+        if (!Ops::update(db, *to)) {
+            return false;
+        }
+        changes.append(JournalChange{Ops::table, id, JournalChange::Updated});
+        return true;
+    }
+
+    QString m_text;
+    std::optional<Row> m_before;
+    std::optional<Row> m_after;
+};
+
+// =============================================================================
+// Quantity Commands
+// =============================================================================
+
+class InventoryQuantityCommand : public JournalCommand
+{
+public:
+    InventoryQuantityCommand(int id, const QString &itemName, int before, int after)
+        : m_id(id)
+        , m_itemName(itemName)
+        , m_before(before)
+        , m_after(after)
+    {
+    }
+
+    QString text() const override { return QStringLiteral("Set stock: %1").arg(m_itemName); }
+
+    bool redo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return write(db, m_after, changes);
+    }
+
+    bool undo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return write(db, m_before, changes);
+    }
+
+    bool mergeWith(const JournalCommand &next) override
+    {
+        const auto *other = dynamic_cast<const InventoryQuantityCommand *>(&next);
+        if (!other || other->m_id != m_id) {
+            return false;
+        }
+        m_after = other->m_after;
+        return true;
+    }
+
+private:
+    bool write(Database &db, int quantity, QVector<JournalChange> &changes)
+    {
+        if (!db.updateInventoryQuantity(m_id, quantity)) {
+            return false;
+        }
+        changes.append(JournalChange{JournalChange::Inventory, m_id, JournalChange::Updated});
+        return true;
+    }
+
+    int m_id;
+    QString m_itemName;
+    int m_before;
+    int m_after;
+};
+
+bool updatePlanLine(Database &db, const EquipmentPlanItem &line) { return db.updateEquipmentPlanItem(line); }
+bool updatePlanLine(Database &db, const FacilityPlanItem &line) { return db.updateFacilityPlanItem(line); }
+QString planLineName(const EquipmentPlanItem &line) { return line.itemName; }
+QString planLineName(const FacilityPlanItem &line) { return line.buildingName; }
+JournalChange::Table planTable(const EquipmentPlanItem &) { return JournalChange::EquipmentPlan; }
+JournalChange::Table planTable(const FacilityPlanItem &) { return JournalChange::FacilityPlan; }
+
+template <typename Line>
+class PlanQuantityCommand : public JournalCommand
+{
+public:
+    PlanQuantityCommand(const Line &before, const Line &after)
+        : m_before(before)
+        , m_after(after)
+    {
+    }
+
+    QString text() const override { return QStringLiteral("Set quantity: %1").arg(planLineName(m_after)); }
+
+    bool redo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return write(db, m_after, changes);
+    }
+
+    bool undo(Database &db, QVector<JournalChange> &changes) override
+    {
+        return write(db, m_before, changes);
+    }
+
+    bool mergeWith(const JournalCommand &next) override
+    {
+        const auto *other = dynamic_cast<const PlanQuantityCommand *>(&next);
+        if (!other || other->m_after.id != m_after.id) {
+            return false;
+        }
+        m_after = other->m_after;
+        return true;
+    }
+
+private:
+    static bool write(Database &db, const Line &line, QVector<JournalChange> &changes)
+    {
+        if (!updatePlanLine(db, line)) {
+            return false;
+        }
+        changes.append(JournalChange{planTable(line), line.id.value_or(0), JournalChange::Updated});
+        return true;
+    }
+
+    Line m_before;
+    Line m_after;
+};
+
+} // namespace
+
+// =============================================================================
+// JournalCommand
+// =============================================================================
+
+bool JournalCommand::mergeWith(const JournalCommand &next)
+{
+    Q_UNUSED(next);
+    return false;
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::addTransaction(const Transaction &transaction)
+{
+    Transaction row = transaction;
+    row.id.reset();
+    return std::make_unique<RowCommand<Transaction>>(
+        QStringLiteral("Add transaction: %1").arg(transaction.item), std::nullopt, row);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::updateTransaction(const Transaction &before,
+                                                                  const Transaction &after)
+{
+    return std::make_unique<RowCommand<Transaction>>(
+        QStringLiteral("Edit transaction: %1").arg(after.item), before, after);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::deleteTransaction(const Transaction &transaction)
+{
+    return std::make_unique<RowCommand<Transaction>>(
+        QStringLiteral("Delete transaction: %1").arg(transaction.item), transaction, std::nullopt);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::addBudget(const Budget &budget)
+{
+    Budget row = budget;
+    row.id.reset();
+    return std::make_unique<RowCommand<Budget>>(
+        QStringLiteral("Add budget: %1").arg(budget.category), std::nullopt, row);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::updateBudget(const Budget &before, const Budget &after)
+{
+    return std::make_unique<RowCommand<Budget>>(
+        QStringLiteral("Edit budget: %1").arg(after.category), before, after);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::deleteBudget(const Budget &budget)
+{
+    return std::make_unique<RowCommand<Budget>>(
+        QStringLiteral("Delete budget: %1").arg(budget.category), budget, std::nullopt);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::setInventoryQuantity(const InventoryItem &item,
+                                                                     int before, int after)
+{
+    return std::make_unique<InventoryQuantityCommand>(item.id.value_or(0), item.itemName, before, after);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::setPlanQuantity(const EquipmentPlanItem &before,
+                                                                const EquipmentPlanItem &after)
+{
+    return std::make_unique<PlanQuantityCommand<EquipmentPlanItem>>(before, after);
+}
+
+std::unique_ptr<JournalCommand> JournalCommand::setPlanQuantity(const FacilityPlanItem &before,
+                                                                const FacilityPlanItem &after)
+{
+    return std::make_unique<PlanQuantityCommand<FacilityPlanItem>>(before, after);
+}
+
+// =============================================================================
+// CommandJournal
+// =============================================================================
+
+// Commands recorded between beginGroup() and endGroup(), as one step
+class CommandJournal::Group : public JournalCommand
+{
+public:
+    explicit Group(const QString &text) : m_text(text) {}
+
+    QString text() const override { return m_text; }
+
+    bool redo(Database &db, QVector<JournalChange> &changes) override
+    {
+        for (const auto &command : m_commands) {
+            if (!command->redo(db, changes)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool undo(Database &db, QVector<JournalChange> &changes) override
+    {
+        for (auto it = m_commands.rbegin(); it != m_commands.rend(); ++it) {
+            if (!(*it)->undo(db, changes)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void append(std::unique_ptr<JournalCommand> command)
+    {
+        if (m_commands.empty() || !m_commands.back()->mergeWith(*command)) {
+            m_commands.push_back(std::move(command));
+        }
+    }
+
+    bool isEmpty() const { return m_commands.empty(); }
+
+private:
+    QString m_text;
+    std::vector<std::unique_ptr<JournalCommand>> m_commands;
+};
+
+CommandJournal::CommandJournal(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+{
+}
+
+CommandJournal::~CommandJournal() = default;
+
+bool CommandJournal::execute(std::unique_ptr<JournalCommand> command)
+{
+    m_lastError.clear();
+
+    // Inside a group the writes join the group's open transaction
+    if (!m_group && !m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
+
+    QVector<JournalChange> changes;
+    if (!command->redo(*m_database, changes)) {
+        m_lastError = m_database->lastError();
+        if (!m_group) {
+            m_database->rollbackTransaction();
+        }
+        return false;
+    }
+
+    if (!m_group && !m_database->commitTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
+
+    record(std::move(command));
+    publish(changes);
+    return true;
+}
+
+void CommandJournal::record(std::unique_ptr<JournalCommand> command)
+{
+    if (m_replaying) {
+        return;
+    }
+    if (m_group) {
+        m_group->append(std::move(command));
+        return;
+    }
+    push(std::move(command));
+}
+
+void CommandJournal::push(std::unique_ptr<JournalCommand> command)
+{
+    m_redo.clear();
+    if (m_undo.empty() || !m_undo.back()->mergeWith(*command)) {
+        m_undo.push_back(std::move(command));
+        if (int(m_undo.size()) > MaxDepth) {
+            m_undo.erase(m_undo.begin());
+        }
+    }
+    emit stateChanged();
+}
+
+void CommandJournal::beginGroup(const QString &text)
+{
+    if (m_group) {
+        qWarning() << "Journal group already open:" << m_group->text();
+        return;
+    }
+    if (!m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
+        qWarning() << "Failed to begin journal group:" << m_lastError;
+        return;
+    }
+    m_group = std::make_unique<Group>(text);
+}
+
+bool CommandJournal::endGroup()
+{
+    if (!m_group) {
+        return false;
+    }
+
+    std::unique_ptr<Group> group = std::move(m_group);
+    const QVector<JournalChange> changes = std::exchange(m_groupChanges, {});
+    if (!m_database->commitTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
+
+    if (!group->isEmpty()) {
+        push(std::move(group));
+    }
+    publish(changes);
+    return true;
+}
+
+void CommandJournal::abortGroup()
+{
+    if (!m_group) {
+        return;
+    }
+    m_group.reset();
+    m_groupChanges.clear();
+    m_database->rollbackTransaction();
+}
+
+bool CommandJournal::undo()
+{
+    if (m_undo.empty() || m_group) {
+        return false;
+    }
+
+    ProfileScope scope("CommandJournal::undo");
+    m_lastError.clear();
+    m_replaying = true;
+
+    QVector<JournalChange> changes;
+    bool ok = m_database->beginTransaction();
+    if (ok && !m_undo.back()->undo(*m_database, changes)) {
+        m_database->rollbackTransaction();
+        ok = false;
+    } else if (ok) {
+        ok = m_database->commitTransaction();
+    }
+    m_replaying = false;
+
+    if (!ok) {
+        m_lastError = m_database->lastError();
+        qWarning() << "Undo failed:" << m_undo.back()->text() << m_lastError;
+        return false;
+    }
+
+    m_redo.push_back(std::move(m_undo.back()));
+    m_undo.pop_back();
+    publish(changes);
+    emit stateChanged();
+    return true;
+}
+
+bool CommandJournal::redo()
+{
+    if (m_redo.empty() || m_group) {
+        return false;
+    }
+
+    ProfileScope scope("CommandJournal::redo");
+    m_lastError.clear();
+    m_replaying = true;
+
+    QVector<JournalChange> changes;
+    bool ok = m_database->beginTransaction();
+    if (ok && !m_redo.back()->redo(*m_database, changes)) {
+        m_database->rollbackTransaction();
+        ok = false;
+    } else if (ok) {
+        ok = m_database->commitTransaction();
+    }
+    m_replaying = false;
+
+    if (!ok) {
+        m_lastError = m_database->lastError();
+        qWarning() << "Redo failed:" << m_redo.back()->text() << m_lastError;
+        return false;
+    }
+
+    m_undo.push_back(std::move(m_redo.back()));
+    m_redo.pop_back();
+    publish(changes);
+    emit stateChanged();
+    return true;
+}
+
+QString CommandJournal::undoText() const
+{
+    return m_undo.empty() ? QString() : m_undo.back()->text();
+}
+
+QString CommandJournal::redoText() const
+{
+    return m_redo.empty() ? QString() : m_redo.back()->text();
+}
+
+void CommandJournal::clear()
+{
+    abortGroup();
+    m_undo.clear();
+    m_redo.clear();
+    emit stateChanged();
+}
+
+void CommandJournal::publish(const QVector<JournalChange> &changes)
+{
+    if (m_group) {
+        m_groupChanges += changes;
+        return;
+    }
+    for (const JournalChange &change : changes) {
+        emit applied(change);
+    }
+}
+
+} // namespace Frontier
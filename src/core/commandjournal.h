@@ -0,0 +1,144 @@
+/**
+ * @file commandjournal.h
+ * @brief Undo/redo journal of invertible database commands
+ */
+
+#ifndef COMMANDJOURNAL_H
+#define COMMANDJOURNAL_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief One row a command wrote, for views patching themselves
+ */
+struct JournalChange {
+    enum Table { Transactions, Budgets, Inventory, EquipmentPlan, FacilityPlan };
+    enum Kind { Inserted, Updated, Removed };
+
+    Table table = Transactions;
+    int rowId = 0;
+    Kind kind = Updated;
+};
+
+/**
+ * @brief A recorded mutation that can be applied again or reversed
+ *
+ * Each command holds the row as it was before and after the edit, so
+ * redo() and undo() are plain single-row writes and need no reload. Both
+ * append the rows they touched to changes.
+ */
+class JournalCommand
+{
+public:
+    virtual ~JournalCommand() = default;
+
+    virtual QString text() const = 0;
+    virtual bool redo(Database &db, QVector<JournalChange> &changes) = 0;
+    virtual bool undo(Database &db, QVector<JournalChange> &changes) = 0;
+
+    // Absorbs a later command into this one (successive spin-box steps on
+    // one row); true if next was absorbed and can be dropped
+    virtual bool mergeWith(const JournalCommand &next);
+
+    // === Commands ===
+    // A transaction or budget added by redo() keeps its new id, so undo()
+    // deletes that row and a further redo() restores it under the same id
+    static std::unique_ptr<JournalCommand> addTransaction(const Transaction &transaction);
+    static std::unique_ptr<JournalCommand> updateTransaction(const Transaction &before,
+                                                             const Transaction &after);
+    static std::unique_ptr<JournalCommand> deleteTransaction(const Transaction &transaction);
+
+    static std::unique_ptr<JournalCommand> addBudget(const Budget &budget);
+    static std::unique_ptr<JournalCommand> updateBudget(const Budget &before, const Budget &after);
+    static std::unique_ptr<JournalCommand> deleteBudget(const Budget &budget);
+
+    static std::unique_ptr<JournalCommand> setInventoryQuantity(const InventoryItem &item,
+                                                                int before, int after);
+    static std::unique_ptr<JournalCommand> setPlanQuantity(const EquipmentPlanItem &before,
+                                                           const EquipmentPlanItem &after);
+    static std::unique_ptr<JournalCommand> setPlanQuantity(const FacilityPlanItem &before,
+                                                           const FacilityPlanItem &after);
+};
+
+/**
+ * @brief Undo and redo stacks over the primary database connection
+ *
+ * execute() runs a command and records it; record() takes one whose write
+ * the caller already made (for edits that go through the write-behind
+ * queue or a cache). undo() and redo() each run in one transaction and
+ * then emit applied() once per row touched, so views patch those rows in
+ * place; a view that does should acknowledge itself on the change bus.
+ *
+ * Between beginGroup() and endGroup() commands run as they come but are
+ * recorded, undone and redone as one step, and the whole group is a
+ * single transaction; a bulk correction across the ledger is one undo.
+ * applied() is emitted after the step, so a view patching itself must not
+ * go back through its own journaled edit paths. Owned by Database.
+ */
+class CommandJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CommandJournal(Database *database, QObject *parent = nullptr);
+    ~CommandJournal();
+
+    // Oldest steps are dropped beyond this
+    static constexpr int MaxDepth = 100;
+
+    // False, with nothing recorded, if the command's write failed
+    bool execute(std::unique_ptr<JournalCommand> command);
+    void record(std::unique_ptr<JournalCommand> command);
+
+    void beginGroup(const QString &text);
+    bool endGroup();
+    // Drops the open group: rolls its writes back and records nothing
+    void abortGroup();
+    bool inGroup() const { return m_group != nullptr; }
+
+    bool undo();
+    bool redo();
+    bool canUndo() const { return !m_undo.empty(); }
+    bool canRedo() const { return !m_redo.empty(); }
+    QString undoText() const;
+    QString redoText() const;
+    bool isReplaying() const { return m_replaying; }
+
+    void clear();
+    QString lastError() const { return m_lastError; }
+
+signals:
+    void applied(const Frontier::JournalChange &change);
+    // Undo/redo availability or texts changed
+    void stateChanged();
+
+private:
+    class Group;
+
+    void push(std::unique_ptr<JournalCommand> command);
+    void publish(const QVector<JournalChange> &changes);
+
+    Database *m_database;
+    std::vector<std::unique_ptr<JournalCommand>> m_undo;   // Most recent last
+    std::vector<std::unique_ptr<JournalCommand>> m_redo;
+    std::unique_ptr<Group> m_group;
+    QVector<JournalChange> m_groupChanges;  // Published when the group ends
+    bool m_replaying = false;
+    QString m_lastError;
+};
+
+} // namespace Frontier
+
+Q_DECLARE_METATYPE(Frontier::JournalChange)
+
+#endif // COMMANDJOURNAL_H
@@ -4,28 +4,91 @@
  */
 
 #include "database.h"
+#include "profiler.h"
+#include "itemcatalog.h"
+#include "recipegraph.h"
+#include "databaseworker.h"
+#include "readpool.h"
+#include "capitalplanservice.h"
+#include "referencesnapshot.h"
+#include "symboltable.h"
+#include "transactionstore.h"
+#include "fuelefficiency.h"
+#include "commandjournal.h"
 
 #include <QDebug>
 #include <QSqlError>
+#include <QSettings>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
 #include <QUuid>
+#include <QRegularExpression>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QThread>
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 namespace Frontier {
 
+// A non-owner thread's connection and the state that goes with it.
+// QThreadStorage deletes it when the thread exits, even after the
+// Database itself is gone, so it holds nothing that points back.
+struct Database::ThreadConnection {
+    QString name;                    // Empty until opened
+    int generation = 0;              // Database::m_generation when opened
+    QString lastError;
+    int transactionDepth = 0;
+    bool rollbackOnly = false;
+    QHash<QString, QSqlQuery *> statements;
+    QSet<int> attachedArchives;
+
+    ~ThreadConnection() { release(); }
+
+    void release()
+    {
+        // Statements must be released before the connection is removed
+        qDeleteAll(statements);
+        statements.clear();
+        if (!name.isEmpty() && QSqlDatabase::contains(name)) {
+            QSqlDatabase::database(name, false).close();
+            QSqlDatabase::removeDatabase(name);
+        }
+        name.clear();
+        transactionDepth = 0;
+        rollbackOnly = false;
+        attachedArchives.clear();
+    }
+};
+
 Database::Database(QObject *parent)
     : QObject(parent)
+    , m_itemCatalog(new ItemCatalog(this))
+    , m_changeBus(new DataChangeBus(this))
+    , m_writeBehindTimer(new QTimer(this))
 {
     // Generate unique connection name for this instance
     m_connectionName = QUuid::createUuid().toString();
+
+    m_writeBehindTimer->setSingleShot(true);
+    m_writeBehindTimer->setInterval(WriteBehindDelayMs);
+    connect(m_writeBehindTimer, &QTimer::timeout, this, &Database::flushPendingWrites);
 }
 
 Database::~Database()
 {
     close();
+    delete m_itemCatalog;
 }
 
 bool Database::initialize(const QString &dbPath)
 {
+    ProfileScope scope("Database::initialize");
+    m_memoizes = true;
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
     db.setDatabaseName(dbPath);
 
@@ -34,21 +97,196 @@ bool Database::initialize(const QString &dbPath)
         return false;
     }
 
+    // Journal and cache settings must be in place before the first write
+    if (!applyStorageProfile(savedStorageProfile())) {
+        qWarning() << "Failed to apply storage profile:" << errorText();
+    }
+
+    // The reference tables are created in the catalog, so it comes first
+    if (!m_catalogPath.isEmpty() && !attachCatalog(db, &errorText())) {
+        qWarning() << "Failed to attach catalog:" << errorText();
+        return false;
+    }
+
     // Create all tables
     if (!createTables()) {
         qWarning() << "Failed to create tables";
         return false;
     }
 
+    // Copies left in the file would hide the catalog's tables
+    if (!m_catalogPath.isEmpty() && (!moveReferenceTables() || !createCatalogIndexes())) {
+        qWarning() << "Failed to set up catalog:" << errorText();
+        return false;
+    }
+
+    // Bring older database files up to the current schema
+    if (!migrateSchema()) {
+        qWarning() << "Failed to migrate schema:" << errorText();
+        return false;
+    }
+
+    // Built after the migrations, over the tables as they now stand
+    if (!createSearchIndex()) {
+        qWarning() << "Failed to create search index:" << errorText();
+        return false;
+    }
+
+    // Only the primary connection reports; worker and pool copies are SQL-only
+    Profiler::instance().setMemoryReporter("Item catalog", [this]() {
+        return m_itemCatalog->estimatedBytes();
+    });
+    Profiler::instance().setMemoryReporter("Recipe graph", [this]() {
+        return m_recipeGraph ? m_recipeGraph->estimatedBytes() : 0;
+    });
+    Profiler::instance().setMemoryReporter("Symbol table", []() {
+        return SymbolTable::instance().estimatedBytes();
+    });
+    Profiler::instance().setMemoryReporter("Transaction store", [this]() {
+        return m_transactionStore ? m_transactionStore->estimatedBytes() : 0;
+    });
+    m_reportsMemory = true;
+
+    // Worker and pool connections never map the file, so the primary can
+    // delete or replace it (some platforms refuse while it is mapped)
+    m_usesSnapshot = true;
+    m_snapshotChecked = false;
+
+    return true;
+}
+
+bool Database::openExisting(const QString &dbPath, bool readOnly)
+{
+    // Writes through the primary never bump this copy's generations
+    m_memoizes = false;
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    db.setDatabaseName(dbPath);
+
+    if (!db.open()) {
+        errorText() = db.lastError().text();
+        qWarning() << "Failed to open database:" << errorText();
+        return false;
+    }
+
+    if (!applyStorageProfile(savedStorageProfile())) {
+        qWarning() << "Failed to apply storage profile:" << errorText();
+    }
+
+    if (!m_catalogPath.isEmpty() && !attachCatalog(db, &errorText())) {
+        qWarning() << "Failed to attach catalog:" << errorText();
+        return false;
+    }
+
+    if (schemaVersion() <= 0) {
+        errorText() = "Database has not been initialized";
+        return false;
+    }
+
+    // initialize() built the index if this SQLite has FTS5; a copy only looks
+    QSqlQuery probe(db);
+    m_hasSearchIndex = execQuery(probe, "SELECT 1 FROM main.sqlite_master "
+                                        "WHERE type = 'table' AND name = 'transactions_fts'")
+                       && probe.next();
+
+    if (readOnly) {
+        QSqlQuery query(db);
+        if (!execQuery(query, "PRAGMA query_only = ON")) {
+            errorText() = query.lastError().text();
+            return false;
+        }
+    }
+
     return true;
 }
 
 void Database::close()
 {
+    // Queued edits must reach the file before the connection goes
+    if (QSqlDatabase::contains(m_connectionName)) {
+        flushPendingWrites();
+    }
+    m_writeBehindTimer->stop();
+    m_pendingWrites.clear();
+    m_pendingWriteIndex.clear();
+
+    // Its commands name rows of this file; the object stays for its connections
+    if (m_journal) {
+        m_journal->clear();
+    }
+
+    // The worker and pool hold their own connections to the same file
+    m_worker.reset();
+    m_readPool.reset();
+    m_capitalPlan.reset();
+    m_transactionStore.reset();
+    m_fuelEfficiency.reset();
+    m_resultCache.clear();
+    m_snapshot.reset();
+    m_snapshotChecked = false;
+    m_usesSnapshot = false;
+    m_hasSearchIndex = false;
+
+    if (m_reportsMemory) {
+        Profiler::instance().removeMemoryReporter("Item catalog");
+        Profiler::instance().removeMemoryReporter("Recipe graph");
+        Profiler::instance().removeMemoryReporter("Symbol table");
+        Profiler::instance().removeMemoryReporter("Transaction store");
+        m_reportsMemory = false;
+    }
+
+    // Statements must be released before the connection is removed
+    clearStatementCache();
+    m_attachedArchives.clear();
+    m_archiveYears.reset();
+
     if (QSqlDatabase::contains(m_connectionName)) {
         QSqlDatabase::database(m_connectionName).close();
         QSqlDatabase::removeDatabase(m_connectionName);
     }
+
+    // Other threads' connections are to the file just closed; each is
+    // replaced on that thread's next call
+    m_generation.fetchAndAddRelease(1);
+}
+
+bool Database::switchTo(const QString &dbPath)
+{
+    ProfileScope scope("Database::switchTo");
+    const QString previous = databasePath();
+    close();
+
+    if (!initialize(dbPath)) {
+        const QString error = errorText().isEmpty() ? QString("Failed to open %1").arg(dbPath)
+                                                    : errorText();
+        close();
+        if (!previous.isEmpty() && !initialize(previous)) {
+            qWarning() << "Failed to reopen" << previous << ":" << errorText();
+        }
+        errorText() = error;
+        return false;
+    }
+
+    // Everything of the old file's is stale; the catalog's is not
+    DataTables tables = DataTable::All;
+    if (m_catalogPath.isEmpty()) {
+        m_itemCatalog->invalidate();
+        invalidateRecipeGraph();
+    } else {
+        const DataTables shared = DataTable::Items | DataTable::Recipes | DataTable::Locations
+                                  | DataTable::FactoryBuildings;
+        tables = tables & ~shared;
+    }
+    invalidateVocabulary(tables);
+    m_changeBus->publish(tables);
+    emit vehiclesChanged();
+
+    // Reads the whole ledger and the stock once off the GUI thread, so the
+    // file's pages are in the OS cache when the views query them
+    worker().run([](Database &db) {
+        db.getTransactionTotals(TransactionQuery());
+        return db.getAllInventory().size();
+    });
+    return true;
 }
 
 bool Database::isOpen() const
@@ -59,19 +297,532 @@ bool Database::isOpen() const
     return QSqlDatabase::database(m_connectionName).isOpen();
 }
 
+QString Database::databasePath() const
+{
+    if (!QSqlDatabase::contains(m_connectionName)) {
+        return QString();
+    }
+    return QSqlDatabase::database(m_connectionName, false).databaseName();
+}
+
+DatabaseWorker &Database::worker()
+{
+    if (!m_worker) {
+        m_worker = std::make_unique<DatabaseWorker>(databasePath(), m_catalogPath);
+    }
+    return *m_worker;
+}
+
+ReadPool &Database::readPool()
+{
+    if (!m_readPool) {
+        m_readPool = std::make_unique<ReadPool>(databasePath(), m_catalogPath);
+    }
+    return *m_readPool;
+}
+
+CapitalPlanService &Database::capitalPlan()
+{
+    if (!m_capitalPlan) {
+        m_capitalPlan = std::make_unique<CapitalPlanService>(this);
+    }
+    return *m_capitalPlan;
+}
+
+TransactionStore &Database::transactionStore()
+{
+    if (!m_transactionStore) {
+        m_transactionStore = std::make_unique<TransactionStore>(this);
+    }
+    return *m_transactionStore;
+}
+
+FuelEfficiencyTracker &Database::fuelEfficiency()
+{
+    if (!m_fuelEfficiency) {
+        m_fuelEfficiency = std::make_unique<FuelEfficiencyTracker>(this);
+    }
+    return *m_fuelEfficiency;
+}
+
+CommandJournal &Database::journal()
+{
+    if (!m_journal) {
+        m_journal = std::make_unique<CommandJournal>(this);
+    }
+    return *m_journal;
+}
+
 QString Database::lastError() const
 {
-    return m_lastError;
+    if (isOwnerThread()) {
+        return m_lastError;
+    }
+    return m_threads.hasLocalData() ? m_threads.localData()->lastError : QString();
+}
+
+// -----------------------------------------------------------------------------
+// Transactions
+// -----------------------------------------------------------------------------
+
+bool Database::beginTransaction()
+{
+    int &depth = transactionDepth();
+    if (depth > 0) {
+        depth++;
+        return true;
+    }
+
+    // Queued writes go first, in their own transaction, so a rollback of
+    // this one cannot take them with it. The queue is the owner thread's.
+    if (isOwnerThread()) {
+        flushPendingWrites();
+    }
+
+    QSqlDatabase db = connection();
+    if (!db.transaction()) {
+        errorText() = db.lastError().text();
+        qWarning() << "Failed to begin transaction:" << errorText();
+        return false;
+    }
+
+    depth = 1;
+    rollbackOnly() = false;
+    return true;
+}
+
+bool Database::commitTransaction()
+{
+    int &depth = transactionDepth();
+    if (depth == 0) {
+        errorText() = "No transaction in progress";
+        return false;
+    }
+
+    // A nested level that rolled back dooms every level above it
+    if (--depth > 0) {
+        if (rollbackOnly()) {
+            errorText() = "Transaction was rolled back by a nested level";
+            return false;
+        }
+        return true;
+    }
+
+    if (rollbackOnly()) {
+        errorText() = "Transaction was rolled back by a nested level";
+        qWarning() << "Failed to commit transaction:" << errorText();
+        abandonTransaction();
+        return false;
+    }
+
+    QSqlDatabase db = connection();
+    if (!db.commit()) {
+        errorText() = db.lastError().text();
+        qWarning() << "Failed to commit transaction:" << errorText();
+        abandonTransaction();
+        return false;
+    }
+
+    return true;
+}
+
+void Database::rollbackTransaction()
+{
+    int &depth = transactionDepth();
+    if (depth == 0) {
+        return;
+    }
+
+    // Only the outermost level ends the SQLite transaction; until then the
+    // levels above keep their depth and learn of it from commitTransaction()
+    if (--depth > 0) {
+        rollbackOnly() = true;
+        return;
+    }
+
+    abandonTransaction();
+}
+
+void Database::abandonTransaction()
+{
+    rollbackOnly() = false;
+    QSqlDatabase db = connection();
+    if (!db.rollback()) {
+        qWarning() << "Failed to roll back transaction:" << db.lastError().text();
+    }
+
+    // Rows appended to the store inside the transaction are gone again,
+    // and row changes published inside it name rows that never landed.
+    // Results cached inside it may have read those rows.
+    m_resultCache.bump(DataTable::All);
+    if (postToOwner([this]() { forgetRolledBackWrites(); })) {
+        return;
+    }
+    forgetRolledBackWrites();
+}
+
+void Database::forgetRolledBackWrites()
+{
+    if (m_transactionStore) {
+        m_transactionStore->invalidate(DataTable::Transactions);
+    }
+    if (m_fuelEfficiency) {
+        m_fuelEfficiency->invalidate(DataTable::FuelLog);
+    }
+    m_changeBus->demoteRows(DataTable::All);
+}
+
+// -----------------------------------------------------------------------------
+// Write-Behind Queue
+// -----------------------------------------------------------------------------
+
+void Database::queueWrite(const QString &key, DataTables tables,
+                          std::function<bool(Database &)> write, QObject *origin)
+{
+    auto it = m_pendingWriteIndex.constFind(key);
+    if (it != m_pendingWriteIndex.constEnd()) {
+        // Keeps its place in the queue; only the latest value is written
+        PendingWrite &pending = m_pendingWrites[it.value()];
+        pending.tables |= tables;
+        pending.write = std::move(write);
+        if (origin) {
+            pending.origin = origin;
+        }
+    } else {
+        m_pendingWriteIndex.insert(key, m_pendingWrites.size());
+        m_pendingWrites.append({key, tables, std::move(write), origin});
+    }
+
+    // Timed from the first queued write, so steady edits still land
+    if (!m_writeBehindTimer->isActive()) {
+        m_writeBehindTimer->start();
+    }
+}
+
+bool Database::flushPendingWrites()
+{
+    m_writeBehindTimer->stop();
+    if (m_pendingWrites.isEmpty() || m_flushingWrites) {
+        return true;
+    }
+
+    ProfileScope scope("Database::flushPendingWrites");
+    const QVector<PendingWrite> writes = std::exchange(m_pendingWrites, {});
+    m_pendingWriteIndex.clear();
+
+    // Inside a transaction the writes share its fate: rolled back with it
+    const bool enclosed = inTransaction();
+    m_flushingWrites = true;
+    QVector<int> failed;
+    bool ok = beginTransaction();
+    if (ok) {
+        for (int i = 0; i < writes.size(); ++i) {
+            // A row deleted since the edit was queued just fails its own
+            // write; the rest of the batch still commits
+            if (!writes[i].write(*this)) {
+                qWarning() << "Queued write failed:" << writes[i].key << errorText();
+                failed.append(i);
+            }
+        }
+        ok = commitTransaction();
+    }
+    m_flushingWrites = false;
+
+    if (!ok && enclosed) {
+        qWarning() << "Queued writes failed inside a transaction:" << errorText();
+        DataTables reload;
+        for (const PendingWrite &pending : writes) {
+            reload |= pending.tables;
+        }
+        markDirty(reload);
+        return false;
+    }
+    if (!ok) {
+        // Another connection holding the write lock is enough to get here;
+        // the views and the journal already show these edits, so keep them
+        qWarning() << "Failed to flush queued writes; will retry:" << errorText();
+        requeueWrites(writes);
+        return false;
+    }
+
+    // The views that showed a failed edit reload the stored value instead
+    DataTables reload;
+    QSet<QObject *> stale;
+    for (int i : std::as_const(failed)) {
+        reload |= writes[i].tables;
+        stale.insert(writes[i].origin.data());
+    }
+    for (const PendingWrite &pending : writes) {
+        if (pending.origin && !stale.contains(pending.origin.data())) {
+            m_changeBus->acknowledge(pending.origin);
+        }
+    }
+    if (reload) {
+        markDirty(reload);
+    }
+    return true;
+}
+
+void Database::requeueWrites(const QVector<PendingWrite> &writes)
+{
+    // Ahead of anything queued meanwhile, which is newer for its key
+    QVector<PendingWrite> queue;
+    queue.reserve(writes.size() + m_pendingWrites.size());
+    for (const PendingWrite &pending : writes) {
+        if (!m_pendingWriteIndex.contains(pending.key)) {
+            queue.append(pending);
+        }
+    }
+    queue += std::exchange(m_pendingWrites, {});
+
+    m_pendingWriteIndex.clear();
+    for (int i = 0; i < queue.size(); ++i) {
+        m_pendingWriteIndex.insert(queue[i].key, i);
+    }
+    m_pendingWrites = std::move(queue);
+    m_writeBehindTimer->start();
+}
+
+// -----------------------------------------------------------------------------
+// Prepared Statement Cache
+// -----------------------------------------------------------------------------
+
+CachedQuery Database::cachedQuery(const QString &key, const QString &sql)
+{
+    // Statements belong to one connection, so each thread has its own cache
+    QHash<QString, QSqlQuery *> &cache = isOwnerThread() ? m_statementCache
+                                                         : threadState().statements;
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        QSqlDatabase db = connection();
+        auto *query = new QSqlQuery(db);
+        query->setForwardOnly(true);
+        if (!query->prepare(sql)) {
+            qWarning() << "Failed to prepare cached statement" << key << ":"
+                       << query->lastError().text();
+        }
+        it = cache.insert(key, query);
+    }
+
+    // Release any result set left over from the previous call
+    it.value()->finish();
+    return CachedQuery(*it.value());
+}
+
+void Database::clearStatementCache()
+{
+    qDeleteAll(m_statementCache);
+    m_statementCache.clear();
+}
+
+// =============================================================================
+// Vocabulary
+// =============================================================================
+
+void Database::markDirty(DataTables tables)
+{
+    if (postToOwner([this, tables]() { markDirty(tables); })) {
+        return;
+    }
+    invalidateForWrite(tables);
+    m_changeBus->publish(tables);
+}
+
+void Database::publishRowChange(DataTable table, RowChange::Kind kind, int id)
+{
+    if (postToOwner([this, table, kind, id]() { publishRowChange(table, kind, id); })) {
+        return;
+    }
+    m_changeBus->publishRow(RowChange{table, kind, id});
+}
+
+void Database::invalidateForWrite(DataTables tables)
+{
+    // Cached results are stale from here, on whichever thread writes
+    m_resultCache.bump(tables);
+    if (postToOwner([this, tables]() { invalidateForWrite(tables); })) {
+        return;
+    }
+
+    // Every write method starts here: queued writes run before it, in the
+    // order the edits were made. Inside a transaction they already have.
+    if (!m_flushingWrites && m_transactionDepth == 0) {
+        flushPendingWrites();
+    }
+
+    if ((tables & DataTable::Items) && m_usesSnapshot) {
+        // Unmap before removing; the next import writes a fresh one
+        m_snapshot.reset();
+        m_snapshotChecked = true;
+        QFile::remove(referenceSnapshotPath());
+    }
+    invalidateVocabulary(tables);
+    if (m_capitalPlan) {
+        m_capitalPlan->invalidate(tables);
+    }
+    if (m_transactionStore) {
+        m_transactionStore->invalidate(tables);
+    }
+    if (m_fuelEfficiency) {
+        m_fuelEfficiency->invalidate(tables);
+    }
+}
+
+void Database::invalidateVocabulary(DataTables tables)
+{
+    if (tables & DataTable::Items) {
+        m_vocabulary.itemCategories.reset();
+        m_vocabulary.rowCounts.remove("items");
+    }
+    if (tables & DataTable::Transactions) {
+        m_vocabulary.transactionCategories.reset();
+    }
+    if (tables & DataTable::Locations) {
+        m_vocabulary.rowCounts.remove("maps");
+        m_vocabulary.rowCounts.remove("location_types");
+        m_vocabulary.rowCounts.remove("locations");
+    }
+}
+
+// table is always one of the literals below, never user input
+int Database::countRows(const QString &table)
+{
+    // The cache is the owner thread's; other threads always count
+    const bool owner = isOwnerThread();
+    auto it = m_vocabulary.rowCounts.constFind(table);
+    if (owner && it != m_vocabulary.rowCounts.constEnd()) {
+        return it.value();
+    }
+
+    CachedQuery statement = cachedQuery("countRows:" + table, "SELECT COUNT(*) FROM " + table);
+    QSqlQuery &query = *statement;
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to count" << table << ":" << query.lastError().text();
+        return 0;
+    }
+
+    int count = query.value(0).toInt();
+    if (owner) {
+        m_vocabulary.rowCounts.insert(table, count);
+    }
+    return count;
+}
+
+int Database::getItemCount() { return countRows("items"); }
+int Database::getMapCount() { return countRows("maps"); }
+int Database::getLocationTypeCount() { return countRows("location_types"); }
+int Database::getLocationCount() { return countRows("locations"); }
+
+// =============================================================================
+// Statement Execution
+// =============================================================================
+
+namespace {
+
+// Runs a helper statement for the tracer with the traced statement's binds
+bool execTraceStatement(QSqlQuery &helper, const QString &sql, const QVariantList &binds)
+{
+    helper.setForwardOnly(true);
+    if (!helper.prepare(sql)) {
+        return false;
+    }
+    for (int i = 0; i < binds.size(); ++i) {
+        helper.bindValue(i, binds[i]);
+    }
+    return helper.exec();
+}
+
+} // namespace
+
+bool Database::execQuery(QSqlQuery &query) const
+{
+    if (!m_queryTracer.isEnabled() || !isOwnerThread()) {
+        return query.exec();
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec();
+    traceQuery(query, timer.nsecsElapsed(), ok);
+    return ok;
+}
+
+bool Database::execQuery(QSqlQuery &query, const QString &sql) const
+{
+    if (!m_queryTracer.isEnabled() || !isOwnerThread()) {
+        return query.exec(sql);
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec(sql);
+    traceQuery(query, timer.nsecsElapsed(), ok);
+    return ok;
+}
+
+void Database::traceQuery(const QSqlQuery &query, qint64 ns, bool ok) const
+{
+    QueryTraceEntry entry;
+    entry.sql = query.lastQuery().trimmed();
+    while (entry.sql.endsWith(QLatin1Char(';'))) {
+        entry.sql.chop(1);
+    }
+    const QVariantList binds = query.boundValues();
+    entry.binds = binds.size();
+    entry.ns = ns;
+    entry.ok = ok;
+    entry.at = QDateTime::currentDateTime();
+
+    if (!ok) {
+        m_queryTracer.record(entry);
+        return;
+    }
+
+    const QString verb = entry.sql.section(QRegularExpression("\\s"), 0, 0).toUpper();
+    const bool isRead = verb == "SELECT" || verb == "WITH";
+    const bool explainable = isRead || verb == "INSERT" || verb == "UPDATE"
+                             || verb == "DELETE" || verb == "REPLACE";
+    QSqlDatabase db = connection();
+
+    if (isRead) {
+        QSqlQuery count(db);
+        if (execTraceStatement(count, "SELECT COUNT(*) FROM (" + entry.sql + ")", binds)
+            && count.next()) {
+            entry.rows = count.value(0).toInt();
+        }
+    } else {
+        entry.rows = query.numRowsAffected();
+    }
+
+    if (explainable && ns >= m_queryTracer.planThresholdNs()) {
+        if (m_queryTracer.hasPlan(entry.sql)) {
+            entry.plan = m_queryTracer.cachedPlan(entry.sql);
+        } else {
+            // Rows are (id, parent, notused, detail); indent children under parents
+            QSqlQuery explain(db);
+            if (execTraceStatement(explain, "EXPLAIN QUERY PLAN " + entry.sql, binds)) {
+                QHash<int, int> depth;
+                QStringList lines;
+                while (explain.next()) {
+                    const int level = depth.value(explain.value(1).toInt(), -1) + 1;
+                    depth.insert(explain.value(0).toInt(), level);
+                    lines.append(QString(level * 2, QLatin1Char(' ')) + explain.value(3).toString());
+                }
+                entry.plan = lines.join(QLatin1Char('\n'));
+            }
+        }
+    }
+
+    m_queryTracer.record(entry);
 }
 
 bool Database::createTables()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    ProfileScope scope("Database::createTables");
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Items table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS items (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.items (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             code TEXT UNIQUE NOT NULL,
             name TEXT NOT NULL,
@@ -83,13 +834,13 @@ bool Database::createTables()
             pricing_group TEXT DEFAULT 'Base70',
             notes TEXT
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create items table:" << query.lastError().text();
         return false;
     }
 
     // Transactions table
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS transactions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             date TEXT NOT NULL,
@@ -156,19 +907,963 @@ bool Database::createTables()
         return false;
     }
 
-    // Factory Buildings table
-    if (!createFactoryBuildingsTable()) {
-        return false;
-    }
+    // Factory Buildings table
+    if (!createFactoryBuildingsTable()) {
+        return false;
+    }
+
+    // Capital Planner tables
+    if (!createEquipmentPlanTable()) {
+        return false;
+    }
+    if (!createFacilityPlanTable()) {
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Stored Dates
+// -----------------------------------------------------------------------------
+// The dated ledgers keep their ISO text column, which exports, the rollup
+// triggers and the search snippets read, and since migration 10 an integer
+// twin that row decoding and range scans use instead: a date as its Julian
+// day number (QDate::toJulianDay()), a date-time as seconds since
+// 1970-01-01T00:00 on the clock the text was written in, with no time zone
+// applied (what SQLite's strftime('%s') reads from the same text). The hot
+// writers bind the integer themselves; triggers fill it for every other
+// writer, and a row that still has none (a column SQLite could not read,
+// or an archive from before the migration mid-upgrade) decodes its text.
+
+static constexpr qint64 UnixEpochJulianDay = 2440588;
+static constexpr qint64 SecondsPerDay = 86400;
+
+static QVariant storedDay(const QDate &date)
+{
+    return date.isValid() ? QVariant(date.toJulianDay()) : QVariant();
+}
+
+static QVariant storedSeconds(const QDateTime &dateTime)
+{
+    if (!dateTime.isValid()) {
+        return QVariant();
+    }
+    return (dateTime.date().toJulianDay() - UnixEpochJulianDay) * SecondsPerDay
+           + dateTime.time().msecsSinceStartOfDay() / 1000;
+}
+
+static QDate dateFromStored(const QVariant &day, const QVariant &text)
+{
+    if (day.isNull()) {
+        return QDate::fromString(text.toString(), Qt::ISODate);
+    }
+    return QDate::fromJulianDay(day.toLongLong());
+}
+
+static QDateTime dateTimeFromStored(const QVariant &seconds, const QVariant &text)
+{
+    if (seconds.isNull()) {
+        return QDateTime::fromString(text.toString(), Qt::ISODate);
+    }
+    const qint64 secs = seconds.toLongLong();
+    qint64 days = secs / SecondsPerDay;
+    qint64 rest = secs % SecondsPerDay;
+    if (rest < 0) {
+        rest += SecondsPerDay;
+        --days;
+    }
+    return QDateTime(QDate::fromJulianDay(UnixEpochJulianDay + days),
+                     QTime::fromMSecsSinceStartOfDay(int(rest * 1000)));
+}
+
+struct StoredDateColumn {
+    const char *table;
+    const char *column;
+    const char *expression;     // The integer, from the text column
+    bool archived;              // Also in the year archives
+};
+
+// Exactly what migration 10 added, for upgrading year archives written
+// before it and for leaving the twins out of exports
+static const StoredDateColumn StoredDateColumns[] = {
+    {"transactions", "day", "CAST(julianday(date) + 0.5 AS INTEGER)", true},
+    {"fuel_log", "ts", "CAST(strftime('%s', date_time) AS INTEGER)", true},
+    {"production_runs", "ts", "CAST(strftime('%s', timestamp) AS INTEGER)", true},
+    {"shifts", "start_ts", "CAST(strftime('%s', start_time) AS INTEGER)", false},
+    {"shifts", "end_ts", "CAST(strftime('%s', end_time) AS INTEGER)", false},
+};
+
+static bool isStoredDateColumn(const QString &table, const QString &column)
+{
+    for (const StoredDateColumn &stored : StoredDateColumns) {
+        if (table == QLatin1String(stored.table) && column == QLatin1String(stored.column)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Schema Migrations
+// -----------------------------------------------------------------------------
+// Each migration runs once, in order, inside its own transaction, and bumps
+// PRAGMA user_version to its version number. createTables() always builds
+// the baseline tables with IF NOT EXISTS, so migrations only describe what
+// changed since then. Never edit a released migration; append a new one.
+// With a shared catalog the indexes on reference tables are the catalog's
+// (see createCatalogIndexes()), and migrateSchema() skips them in the file.
+
+struct SchemaMigration {
+    int version;
+    const char *description;
+    QStringList statements;
+};
+
+static bool indexesReferenceTable(const QString &sql);
+
+static const QVector<SchemaMigration> &schemaMigrations()
+{
+    static const QVector<SchemaMigration> migrations = {
+        { 1, "Indexes for date-range scans and name lookups", {
+            "CREATE INDEX IF NOT EXISTS idx_transactions_date "
+            "ON transactions(date, id)",
+            "CREATE INDEX IF NOT EXISTS idx_transactions_account_date "
+            "ON transactions(account, date, type, total_amount)",
+            "CREATE INDEX IF NOT EXISTS idx_transactions_type_date "
+            "ON transactions(type, date, category, total_amount)",
+            "CREATE INDEX IF NOT EXISTS idx_fuel_log_date_time "
+            "ON fuel_log(date_time, equipment_id)",
+            "CREATE INDEX IF NOT EXISTS idx_production_runs_timestamp "
+            "ON production_runs(timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_production_runs_recipe "
+            "ON production_runs(recipe_id, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_shifts_start_time "
+            "ON shifts(start_time)",
+            "CREATE INDEX IF NOT EXISTS idx_cycle_records_profile "
+            "ON cycle_records(profile_id, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_items_name "
+            "ON items(name)",
+            "CREATE INDEX IF NOT EXISTS idx_items_category "
+            "ON items(category, name)",
+            "CREATE INDEX IF NOT EXISTS idx_recipes_output "
+            "ON recipes(output_item)",
+            "CREATE INDEX IF NOT EXISTS idx_recipe_ingredients_recipe "
+            "ON recipe_ingredients(recipe_id)",
+            "CREATE INDEX IF NOT EXISTS idx_movement_usage_session "
+            "ON movement_equipment_usage(session_id, equipment_id, role)",
+        }},
+        { 2, "Trigger-maintained account balance snapshots", {
+            R"(CREATE TABLE IF NOT EXISTS account_balances (
+                account TEXT PRIMARY KEY,
+                balance REAL NOT NULL DEFAULT 0
+            ))",
+            R"(CREATE TABLE IF NOT EXISTS account_daily_balances (
+                account TEXT NOT NULL,
+                date TEXT NOT NULL,
+                delta REAL NOT NULL DEFAULT 0,
+                PRIMARY KEY (account, date)
+            ) WITHOUT ROWID)",
+
+            // Backfill from the existing ledger
+            "DELETE FROM account_balances",
+            "DELETE FROM account_daily_balances",
+            R"(INSERT INTO account_daily_balances (account, date, delta)
+               SELECT account, date, SUM(CASE WHEN transactions.type IN ('Sale', 'Opening') THEN transactions.total_amount
+                 WHEN transactions.type IN ('Purchase', 'Fuel') THEN -transactions.total_amount
+                 WHEN transactions.type = 'Transfer' THEN transactions.total_amount
+                 ELSE 0 END)
+               FROM transactions GROUP BY account, date)",
+            R"(INSERT INTO account_balances (account, balance)
+               SELECT account, SUM(delta) FROM account_daily_balances GROUP BY account)",
+
+            R"(CREATE TRIGGER IF NOT EXISTS trg_transactions_balance_insert
+               AFTER INSERT ON transactions
+               BEGIN
+                   INSERT INTO account_balances (account, balance)
+                   VALUES (NEW.account, CASE WHEN NEW.type IN ('Sale', 'Opening') THEN NEW.total_amount
+                 WHEN NEW.type IN ('Purchase', 'Fuel') THEN -NEW.total_amount
+                 WHEN NEW.type = 'Transfer' THEN NEW.total_amount
+                 ELSE 0 END)
+                   ON CONFLICT(account) DO UPDATE SET balance = balance + excluded.balance;
+                   INSERT INTO account_daily_balances (account, date, delta)
+                   VALUES (NEW.account, NEW.date, CASE WHEN NEW.type IN ('Sale', 'Opening') THEN NEW.total_amount
+                 WHEN NEW.type IN ('Purchase', 'Fuel') THEN -NEW.total_amount
+                 WHEN NEW.type = 'Transfer' THEN NEW.total_amount
+                 ELSE 0 END)
+                   ON CONFLICT(account, date) DO UPDATE SET delta = delta + excluded.delta;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_transactions_balance_delete
+               AFTER DELETE ON transactions
+               BEGIN
+                   UPDATE account_balances
+                   SET balance = balance - (CASE WHEN OLD.type IN ('Sale', 'Opening') THEN OLD.total_amount
+                 WHEN OLD.type IN ('Purchase', 'Fuel') THEN -OLD.total_amount
+                 WHEN OLD.type = 'Transfer' THEN OLD.total_amount
+                 ELSE 0 END)
+                   WHERE account = OLD.account;
+                   UPDATE account_daily_balances
+                   SET delta = delta - (CASE WHEN OLD.type IN ('Sale', 'Opening') THEN OLD.total_amount
+                 WHEN OLD.type IN ('Purchase', 'Fuel') THEN -OLD.total_amount
+                 WHEN OLD.type = 'Transfer' THEN OLD.total_amount
+                 ELSE 0 END)
+                   WHERE account = OLD.account AND date = OLD.date;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_transactions_balance_update
+               AFTER UPDATE OF date, type, account, total_amount ON transactions
+               BEGIN
+                   UPDATE account_balances
+                   SET balance = balance - (CASE WHEN OLD.type IN ('Sale', 'Opening') THEN OLD.total_amount
+                 WHEN OLD.type IN ('Purchase', 'Fuel') THEN -OLD.total_amount
+                 WHEN OLD.type = 'Transfer' THEN OLD.total_amount
+                 ELSE 0 END)
+                   WHERE account = OLD.account;
+                   UPDATE account_daily_balances
+                   SET delta = delta - (CASE WHEN OLD.type IN ('Sale', 'Opening') THEN OLD.total_amount
+                 WHEN OLD.type IN ('Purchase', 'Fuel') THEN -OLD.total_amount
+                 WHEN OLD.type = 'Transfer' THEN OLD.total_amount
+                 ELSE 0 END)
+                   WHERE account = OLD.account AND date = OLD.date;
+                   INSERT INTO account_balances (account, balance)
+                   VALUES (NEW.account, CASE WHEN NEW.type IN ('Sale', 'Opening') THEN NEW.total_amount
+                 WHEN NEW.type IN ('Purchase', 'Fuel') THEN -NEW.total_amount
+                 WHEN NEW.type = 'Transfer' THEN NEW.total_amount
+                 ELSE 0 END)
+                   ON CONFLICT(account) DO UPDATE SET balance = balance + excluded.balance;
+                   INSERT INTO account_daily_balances (account, date, delta)
+                   VALUES (NEW.account, NEW.date, CASE WHEN NEW.type IN ('Sale', 'Opening') THEN NEW.total_amount
+                 WHEN NEW.type IN ('Purchase', 'Fuel') THEN -NEW.total_amount
+                 WHEN NEW.type = 'Transfer' THEN NEW.total_amount
+                 ELSE 0 END)
+                   ON CONFLICT(account, date) DO UPDATE SET delta = delta + excluded.delta;
+               END)",
+        }},
+        { 3, "One equipment usage row per session, equipment and role", {
+            "UPDATE movement_equipment_usage SET role = '' WHERE role IS NULL",
+            // Keep the most recent row of any duplicates the old check-then-insert left
+            R"(DELETE FROM movement_equipment_usage WHERE id NOT IN (
+                   SELECT MAX(id) FROM movement_equipment_usage
+                   GROUP BY session_id, equipment_id, role))",
+            "DROP INDEX IF EXISTS idx_movement_usage_session",
+            "CREATE UNIQUE INDEX IF NOT EXISTS idx_movement_usage_key "
+            "ON movement_equipment_usage(session_id, equipment_id, role)",
+        }},
+        { 4, "Trigger-maintained daily fuel rollup", {
+            R"(CREATE TABLE IF NOT EXISTS fuel_daily_rollup (
+                date TEXT NOT NULL,
+                equipment_id TEXT NOT NULL DEFAULT '',
+                liters REAL NOT NULL DEFAULT 0,
+                total_cost REAL NOT NULL DEFAULT 0,
+                entries INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY (date, equipment_id)
+            ) WITHOUT ROWID)",
+
+            // Backfill from the existing log
+            "DELETE FROM fuel_daily_rollup",
+            R"(INSERT INTO fuel_daily_rollup (date, equipment_id, liters, total_cost, entries)
+               SELECT substr(date_time, 1, 10), COALESCE(equipment_id, ''),
+                      SUM(COALESCE(liters, 0)), SUM(COALESCE(total_cost, 0)), COUNT(*)
+               FROM fuel_log GROUP BY substr(date_time, 1, 10), COALESCE(equipment_id, ''))",
+
+            R"(CREATE TRIGGER IF NOT EXISTS trg_fuel_log_rollup_insert
+               AFTER INSERT ON fuel_log
+               BEGIN
+                   INSERT INTO fuel_daily_rollup (date, equipment_id, liters, total_cost, entries)
+                   VALUES (substr(NEW.date_time, 1, 10), COALESCE(NEW.equipment_id, ''),
+                           COALESCE(NEW.liters, 0), COALESCE(NEW.total_cost, 0), 1)
+                   ON CONFLICT(date, equipment_id) DO UPDATE SET
+                       liters = liters + excluded.liters,
+                       total_cost = total_cost + excluded.total_cost,
+                       entries = entries + 1;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_fuel_log_rollup_delete
+               AFTER DELETE ON fuel_log
+               BEGIN
+                   UPDATE fuel_daily_rollup SET
+                       liters = liters - COALESCE(OLD.liters, 0),
+                       total_cost = total_cost - COALESCE(OLD.total_cost, 0),
+                       entries = entries - 1
+                   WHERE date = substr(OLD.date_time, 1, 10)
+                     AND equipment_id = COALESCE(OLD.equipment_id, '');
+                   DELETE FROM fuel_daily_rollup
+                   WHERE date = substr(OLD.date_time, 1, 10)
+                     AND equipment_id = COALESCE(OLD.equipment_id, '')
+                     AND entries <= 0;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_fuel_log_rollup_update
+               AFTER UPDATE OF date_time, equipment_id, liters, total_cost ON fuel_log
+               BEGIN
+                   UPDATE fuel_daily_rollup SET
+                       liters = liters - COALESCE(OLD.liters, 0),
+                       total_cost = total_cost - COALESCE(OLD.total_cost, 0),
+                       entries = entries - 1
+                   WHERE date = substr(OLD.date_time, 1, 10)
+                     AND equipment_id = COALESCE(OLD.equipment_id, '');
+                   DELETE FROM fuel_daily_rollup
+                   WHERE date = substr(OLD.date_time, 1, 10)
+                     AND equipment_id = COALESCE(OLD.equipment_id, '')
+                     AND entries <= 0;
+                   INSERT INTO fuel_daily_rollup (date, equipment_id, liters, total_cost, entries)
+                   VALUES (substr(NEW.date_time, 1, 10), COALESCE(NEW.equipment_id, ''),
+                           COALESCE(NEW.liters, 0), COALESCE(NEW.total_cost, 0), 1)
+                   ON CONFLICT(date, equipment_id) DO UPDATE SET
+                       liters = liters + excluded.liters,
+                       total_cost = total_cost + excluded.total_cost,
+                       entries = entries + 1;
+               END)",
+        }},
+        { 5, "Covering index for cycle time percentiles", {
+            "CREATE INDEX IF NOT EXISTS idx_cycle_records_profile_total "
+            "ON cycle_records(profile_id, total_seconds)",
+        }},
+        { 6, "Ledger replay checkpoint for inventory sync", {
+            R"(CREATE TABLE IF NOT EXISTS inventory_sync_checkpoint (
+                id INTEGER PRIMARY KEY CHECK (id = 1),
+                last_transaction_id INTEGER NOT NULL DEFAULT 0,
+                synced_at TEXT
+            ))",
+            "INSERT OR IGNORE INTO inventory_sync_checkpoint (id, last_transaction_id) VALUES (1, 0)",
+        }},
+        { 7, "Catalog of year archive files", {
+            R"(CREATE TABLE IF NOT EXISTS archived_years (
+                year INTEGER PRIMARY KEY,
+                transactions INTEGER NOT NULL DEFAULT 0,
+                fuel_entries INTEGER NOT NULL DEFAULT 0,
+                production_runs INTEGER NOT NULL DEFAULT 0,
+                company_balance REAL NOT NULL DEFAULT 0,
+                personal_balance REAL NOT NULL DEFAULT 0,
+                archived_at TEXT
+            ))",
+        }},
+        { 8, "Index for paging movement sessions newest first", {
+            "CREATE INDEX IF NOT EXISTS idx_movement_sessions_start "
+            "ON movement_sessions(start_time, id)",
+        }},
+        { 9, "Checksums of the built-in reference data a file was seeded from", {
+            R"(CREATE TABLE IF NOT EXISTS reference_sources (
+                data_set TEXT PRIMARY KEY,
+                checksum TEXT NOT NULL,
+                recorded_at TEXT
+            ))",
+        }},
+        { 10, "Integer day numbers and epoch seconds beside the ISO date text", {
+            "ALTER TABLE transactions ADD COLUMN day INTEGER",
+            "ALTER TABLE fuel_log ADD COLUMN ts INTEGER",
+            "ALTER TABLE production_runs ADD COLUMN ts INTEGER",
+            "ALTER TABLE shifts ADD COLUMN start_ts INTEGER",
+            "ALTER TABLE shifts ADD COLUMN end_ts INTEGER",
+
+            // Backfill from the text
+            "UPDATE transactions SET day = CAST(julianday(date) + 0.5 AS INTEGER)",
+            "UPDATE fuel_log SET ts = CAST(strftime('%s', date_time) AS INTEGER)",
+            "UPDATE production_runs SET ts = CAST(strftime('%s', timestamp) AS INTEGER)",
+            R"(UPDATE shifts SET start_ts = CAST(strftime('%s', start_time) AS INTEGER),
+                                 end_ts = CAST(strftime('%s', end_time) AS INTEGER))",
+
+            // Writers that only set the text get the integer from it; one
+            // that bound a matching integer skips the second write
+            R"(CREATE TRIGGER IF NOT EXISTS trg_transactions_day_insert
+               AFTER INSERT ON transactions
+               WHEN NEW.day IS NOT CAST(julianday(NEW.date) + 0.5 AS INTEGER)
+               BEGIN
+                   UPDATE transactions SET day = CAST(julianday(NEW.date) + 0.5 AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_transactions_day_update
+               AFTER UPDATE OF date, day ON transactions
+               WHEN NEW.day IS NOT CAST(julianday(NEW.date) + 0.5 AS INTEGER)
+               BEGIN
+                   UPDATE transactions SET day = CAST(julianday(NEW.date) + 0.5 AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_fuel_log_ts_insert
+               AFTER INSERT ON fuel_log
+               WHEN NEW.ts IS NOT CAST(strftime('%s', NEW.date_time) AS INTEGER)
+               BEGIN
+                   UPDATE fuel_log SET ts = CAST(strftime('%s', NEW.date_time) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_fuel_log_ts_update
+               AFTER UPDATE OF date_time, ts ON fuel_log
+               WHEN NEW.ts IS NOT CAST(strftime('%s', NEW.date_time) AS INTEGER)
+               BEGIN
+                   UPDATE fuel_log SET ts = CAST(strftime('%s', NEW.date_time) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_production_runs_ts_insert
+               AFTER INSERT ON production_runs
+               WHEN NEW.ts IS NOT CAST(strftime('%s', NEW.timestamp) AS INTEGER)
+               BEGIN
+                   UPDATE production_runs SET ts = CAST(strftime('%s', NEW.timestamp) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_production_runs_ts_update
+               AFTER UPDATE OF timestamp, ts ON production_runs
+               WHEN NEW.ts IS NOT CAST(strftime('%s', NEW.timestamp) AS INTEGER)
+               BEGIN
+                   UPDATE production_runs SET ts = CAST(strftime('%s', NEW.timestamp) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_shifts_ts_insert
+               AFTER INSERT ON shifts
+               WHEN NEW.start_ts IS NOT CAST(strftime('%s', NEW.start_time) AS INTEGER)
+                 OR NEW.end_ts IS NOT CAST(strftime('%s', NEW.end_time) AS INTEGER)
+               BEGIN
+                   UPDATE shifts SET start_ts = CAST(strftime('%s', NEW.start_time) AS INTEGER),
+                                     end_ts = CAST(strftime('%s', NEW.end_time) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS trg_shifts_ts_update
+               AFTER UPDATE OF start_time, end_time, start_ts, end_ts ON shifts
+               WHEN NEW.start_ts IS NOT CAST(strftime('%s', NEW.start_time) AS INTEGER)
+                 OR NEW.end_ts IS NOT CAST(strftime('%s', NEW.end_time) AS INTEGER)
+               BEGIN
+                   UPDATE shifts SET start_ts = CAST(strftime('%s', NEW.start_time) AS INTEGER),
+                                     end_ts = CAST(strftime('%s', NEW.end_time) AS INTEGER)
+                   WHERE id = NEW.id;
+               END)",
+
+            "CREATE INDEX IF NOT EXISTS idx_transactions_day "
+            "ON transactions(day, id)",
+            "CREATE INDEX IF NOT EXISTS idx_fuel_log_ts "
+            "ON fuel_log(ts, equipment_id)",
+            "CREATE INDEX IF NOT EXISTS idx_production_runs_ts "
+            "ON production_runs(ts)",
+            "CREATE INDEX IF NOT EXISTS idx_shifts_start_ts "
+            "ON shifts(start_ts)",
+        }},
+        { 11, "Log of bucket and dump events captured live", {
+            R"(CREATE TABLE IF NOT EXISTS movement_events (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                session_id INTEGER NOT NULL,
+                equipment_id TEXT NOT NULL,
+                kind TEXT NOT NULL,
+                time TEXT NOT NULL,
+                ts INTEGER NOT NULL,
+                FOREIGN KEY (session_id) REFERENCES movement_sessions(id)
+            ))",
+            "CREATE INDEX IF NOT EXISTS idx_movement_events_session "
+            "ON movement_events(session_id, equipment_id, kind)",
+        }},
+        { 12, "Covering index for finance summaries over day numbers", {
+            "CREATE INDEX IF NOT EXISTS idx_transactions_type_day "
+            "ON transactions(type, day, category, total_amount)",
+        }},
+    };
+    return migrations;
+}
+
+int Database::schemaVersion() const
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    if (execQuery(query, "PRAGMA user_version") && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+bool Database::migrateSchema()
+{
+    ProfileScope scope("Database::migrateSchema");
+    QSqlDatabase db = connection();
+    int current = schemaVersion();
+
+    for (const auto &migration : schemaMigrations()) {
+        if (migration.version <= current) {
+            continue;
+        }
+
+        if (!beginTransaction()) {
+            return false;
+        }
+
+        QSqlQuery query(db);
+        for (const QString &sql : migration.statements) {
+            // Unqualified, it would look for the table in main
+            if (!m_catalogPath.isEmpty() && indexesReferenceTable(sql)) {
+                continue;
+            }
+            if (!execQuery(query, sql)) {
+                errorText() = QString("Migration %1 failed: %2")
+                                  .arg(migration.version)
+                                  .arg(query.lastError().text());
+                rollbackTransaction();
+                return false;
+            }
+        }
+
+        // PRAGMA does not accept bound parameters
+        if (!execQuery(query, QString("PRAGMA user_version = %1").arg(migration.version))) {
+            errorText() = query.lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+
+        if (!commitTransaction()) {
+            return false;
+        }
+
+        qInfo() << "Applied schema migration" << migration.version << "-" << migration.description;
+        current = migration.version;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Shared Catalog
+// -----------------------------------------------------------------------------
+
+// Tables whose rows come from the reference imports, in creation order
+static const char *const ReferenceTables[] = {
+    "items", "workbenches", "recipes", "recipe_ingredients",
+    "maps", "location_types", "locations", "factory_buildings",
+};
+
+// A CREATE INDEX on one of ReferenceTables
+static bool indexesReferenceTable(const QString &sql)
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("^\\s*CREATE\\s+(UNIQUE\\s+)?INDEX\\b.*\\bON\\s+(\\w+)\\s*\\("),
+        QRegularExpression::CaseInsensitiveOption | QRegularExpression::DotMatchesEverythingOption);
+    const QRegularExpressionMatch match = pattern.match(sql);
+    if (!match.hasMatch()) {
+        return false;
+    }
+    const QString table = match.captured(2);
+    for (const char *reference : ReferenceTables) {
+        if (table == QLatin1String(reference)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString Database::referenceSchema() const
+{
+    return m_catalogPath.isEmpty() ? QStringLiteral("main") : QStringLiteral("catalog");
+}
+
+bool Database::attachCatalog(const QSqlDatabase &db, QString *error) const
+{
+    QSqlQuery query(db);
+    query.prepare("ATTACH DATABASE :path AS catalog");
+    query.bindValue(":path", m_catalogPath);
+    if (!execQuery(query)) {
+        *error = query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+// Migration 1's reference indexes, made in the catalog for every file that
+// uses one; migrateSchema() skips them there
+bool Database::createCatalogIndexes()
+{
+    QSqlQuery query(connection());
+    const QStringList statements = {
+        "CREATE INDEX IF NOT EXISTS catalog.idx_items_name ON items(name)",
+        "CREATE INDEX IF NOT EXISTS catalog.idx_items_category ON items(category, name)",
+        "CREATE INDEX IF NOT EXISTS catalog.idx_recipes_output ON recipes(output_item)",
+        "CREATE INDEX IF NOT EXISTS catalog.idx_recipe_ingredients_recipe ON recipe_ingredients(recipe_id)",
+    };
+    for (const QString &sql : statements) {
+        if (!execQuery(query, sql)) {
+            errorText() = query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Database::moveReferenceTables()
+{
+    ProfileScope scope("Database::moveReferenceTables");
+    QSqlQuery query(connection());
+
+    QStringList present;
+    for (const char *table : ReferenceTables) {
+        query.prepare("SELECT 1 FROM main.sqlite_master WHERE type = 'table' AND name = :name");
+        query.bindValue(":name", QString(table));
+        if (!execQuery(query)) {
+            errorText() = query.lastError().text();
+            return false;
+        }
+        if (query.next()) {
+            present << table;
+        }
+        query.finish();
+    }
+    if (present.isEmpty()) {
+        return true;
+    }
+
+    // Copied in one transaction and dropped in the next: a crash between
+    // them leaves both copies, and the next start finds the catalog
+    // filled and only drops. Both files have the same columns in the same
+    // order, as createTables() builds the two alike.
+    if (!beginTransaction()) {
+        return false;
+    }
+    int moved = 0;
+    for (const QString &table : present) {
+        if (!execQuery(query, QString("SELECT EXISTS (SELECT 1 FROM catalog.%1)").arg(table))
+            || !query.next()) {
+            errorText() = query.lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+        const bool filled = query.value(0).toBool();
+        query.finish();
+        if (filled) {
+            continue;
+        }
+        if (!execQuery(query, QString("INSERT INTO catalog.%1 SELECT * FROM main.%1").arg(table))) {
+            errorText() = query.lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+        moved += query.numRowsAffected();
+    }
+    if (!commitTransaction()) {
+        return false;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+    for (const QString &table : present) {
+        if (!execQuery(query, QString("DROP TABLE main.%1").arg(table))) {
+            errorText() = query.lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+    }
+    if (!commitTransaction()) {
+        return false;
+    }
+
+    // The file's own snapshot described the rows that just left it
+    QFile::remove(databasePath() + ".refsnap");
+    qInfo() << "Moved" << moved << "reference rows from" << databasePath() << "to the catalog"
+            << m_catalogPath;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Full-Text Search
+// -----------------------------------------------------------------------------
+// External-content FTS5 tables over the searchable text: the index holds
+// only the tokens and reads the text back from the table itself. Triggers
+// keep each in step with its table, and a trigger must live beside its
+// table, so the items index is in the catalog when there is one.
+
+struct SearchIndexSpec {
+    const char *table;
+    const char *columns;
+    bool reference;
+};
+
+static const SearchIndexSpec SearchIndexes[] = {
+    { "items",           "name, code, category", true  },
+    { "transactions",    "item_name, notes",     false },
+    { "shifts",          "notes",                false },
+    { "production_runs", "notes",                false },
+};
+
+// The words of a search, split where the unicode61 tokenizer splits, and
+// each as a prefix term in any column and order: "iron o" becomes
+// "iron"* "o"*. Empty when text has no word characters.
+static QStringList searchWords(const QString &text)
+{
+    static const QRegularExpression separators("[^\\w]+", QRegularExpression::UseUnicodePropertiesOption);
+    return text.split(separators, Qt::SkipEmptyParts);
+}
+
+static QString ftsMatchExpression(const QStringList &words)
+{
+    QStringList terms;
+    for (const QString &word : words) {
+        terms << '"' + word + "\"*";
+    }
+    return terms.join(' ');
+}
+
+bool Database::createSearchIndex()
+{
+    ProfileScope scope("Database::createSearchIndex");
+    QSqlQuery query(connection());
+    m_hasSearchIndex = false;
+
+    // An items index left in the file from before the catalog would be
+    // found ahead of the catalog's and never be updated again
+    if (!m_catalogPath.isEmpty() && !execQuery(query, "DROP TABLE IF EXISTS main.items_fts")) {
+        errorText() = query.lastError().text();
+        return false;
+    }
+
+    for (const SearchIndexSpec &index : SearchIndexes) {
+        const QString schema = index.reference ? referenceSchema() : QStringLiteral("main");
+        const QString table = index.table;
+        const QString fts = table + "_fts";
+
+        query.prepare(QString("SELECT 1 FROM %1.sqlite_master WHERE type = 'table' AND name = :name")
+                          .arg(schema));
+        query.bindValue(":name", fts);
+        if (!execQuery(query)) {
+            errorText() = query.lastError().text();
+            return false;
+        }
+        const bool exists = query.next();
+        query.finish();
+        if (exists) {
+            continue;
+        }
+
+        const QString columns = index.columns;
+        QStringList newValues;
+        QStringList oldValues;
+        for (const QString &column : columns.split(", ")) {
+            newValues << "new." + column;
+            oldValues << "old." + column;
+        }
+        const QString insertRow = QString("INSERT INTO %1(rowid, %2) VALUES (new.id, %3);")
+                                      .arg(fts, columns, newValues.join(", "));
+        const QString deleteRow = QString("INSERT INTO %1(%1, rowid, %2) VALUES ('delete', old.id, %3);")
+                                      .arg(fts, columns, oldValues.join(", "));
+        // prefix= keeps two- and three-letter prefix lists, so the first
+        // keystrokes of a search read one list instead of scanning terms
+        const QStringList statements = {
+            QString("CREATE VIRTUAL TABLE %1.%2 USING fts5(%3, content='%4', content_rowid='id', "
+                    "prefix='2 3')").arg(schema, fts, columns, table),
+            QString("CREATE TRIGGER %1.trg_%2_fts_insert AFTER INSERT ON %2 BEGIN %3 END")
+                .arg(schema, table, insertRow),
+            QString("CREATE TRIGGER %1.trg_%2_fts_delete AFTER DELETE ON %2 BEGIN %3 END")
+                .arg(schema, table, deleteRow),
+            QString("CREATE TRIGGER %1.trg_%2_fts_update AFTER UPDATE OF %3 ON %2 BEGIN %4 %5 END")
+                .arg(schema, table, columns, deleteRow, insertRow),
+            QString("INSERT INTO %1.%2(%2) VALUES ('rebuild')").arg(schema, fts),
+        };
+
+        if (!beginTransaction()) {
+            return false;
+        }
+        for (const QString &sql : statements) {
+            if (execQuery(query, sql)) {
+                continue;
+            }
+            const QString error = query.lastError().text();
+            rollbackTransaction();
+            // SQLite built without FTS5: searches fall back to LIKE scans
+            if (error.contains("no such module")) {
+                qInfo() << "Full-text search unavailable, searching by substring:" << error;
+                return true;
+            }
+            errorText() = error;
+            return false;
+        }
+        if (!commitTransaction()) {
+            return false;
+        }
+        qInfo() << "Built search index" << schema + "." + fts;
+    }
+
+    m_hasSearchIndex = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Storage Profile
+// -----------------------------------------------------------------------------
+// Safe keeps SQLite's defaults: every commit rewrites a rollback journal and
+// fsyncs twice. Balanced switches to WAL with synchronous=NORMAL, which is
+// still crash-safe for the database file but can drop the last commits on
+// power loss. Fast also turns sync off entirely.
+
+struct StoragePragmas {
+    const char *journalMode;
+    const char *synchronous;
+    int cacheSizeKiB;        // Negative cache_size is in KiB rather than pages
+    qint64 mmapSizeBytes;
+    const char *tempStore;
+};
+
+static StoragePragmas storagePragmas(StorageProfile profile)
+{
+    switch (profile) {
+    case StorageProfile::Safe:
+        return { "DELETE", "FULL", 2000, 0, "DEFAULT" };
+    case StorageProfile::Fast:
+        return { "WAL", "OFF", 65536, 256LL * 1024 * 1024, "MEMORY" };
+    case StorageProfile::Balanced:
+    default:
+        return { "WAL", "NORMAL", 16384, 64LL * 1024 * 1024, "MEMORY" };
+    }
+}
+
+bool Database::applyStorageProfile(StorageProfile profile)
+{
+    // journal_mode cannot change while a transaction is open
+    if (inTransaction()) {
+        errorText() = "Cannot change storage profile inside a transaction";
+        return false;
+    }
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    const StoragePragmas pragmas = storagePragmas(profile);
+
+    // PRAGMA does not accept bound parameters
+    const QStringList statements = {
+        QString("PRAGMA journal_mode = %1").arg(pragmas.journalMode),
+        QString("PRAGMA synchronous = %1").arg(pragmas.synchronous),
+        QString("PRAGMA cache_size = -%1").arg(pragmas.cacheSizeKiB),
+        QString("PRAGMA mmap_size = %1").arg(pragmas.mmapSizeBytes),
+        QString("PRAGMA temp_store = %1").arg(pragmas.tempStore),
+    };
+
+    for (const QString &sql : statements) {
+        if (!execQuery(query, sql)) {
+            errorText() = query.lastError().text();
+            return false;
+        }
+    }
+
+    // journal_mode reports the mode actually in effect (e.g. memory databases
+    // cannot use WAL); keep going with whatever SQLite chose
+    if (execQuery(query, "PRAGMA journal_mode") && query.next()) {
+        QString actual = query.value(0).toString();
+        if (actual.compare(pragmas.journalMode, Qt::CaseInsensitive) != 0) {
+            qWarning() << "Requested journal mode" << pragmas.journalMode
+                       << "but SQLite is using" << actual;
+        }
+    }
+
+    m_storageProfile = profile;
+    return true;
+}
+
+StorageProfile Database::savedStorageProfile()
+{
+    QSettings settings("FrontierMining", "Tracker");
+    return stringToStorageProfile(
+        settings.value("Database/storageProfile", "Balanced").toString());
+}
+
+void Database::saveStorageProfile(StorageProfile profile)
+{
+    QSettings settings("FrontierMining", "Tracker");
+    settings.setValue("Database/storageProfile", storageProfileToString(profile));
+}
+
+// -----------------------------------------------------------------------------
+// Threads
+// -----------------------------------------------------------------------------
+
+bool Database::isOwnerThread() const
+{
+    return QThread::currentThread() == thread();
+}
+
+bool Database::inTransaction() const
+{
+    if (isOwnerThread()) {
+        return m_transactionDepth > 0;
+    }
+    return m_threads.hasLocalData() && m_threads.localData()->transactionDepth > 0;
+}
+
+Database::ThreadConnection &Database::threadState() const
+{
+    if (!m_threads.hasLocalData()) {
+        m_threads.setLocalData(new ThreadConnection);
+    }
+    return *m_threads.localData();
+}
+
+QSqlDatabase Database::connection() const
+{
+    if (isOwnerThread()) {
+        return QSqlDatabase::database(m_connectionName);
+    }
+
+    ThreadConnection &local = threadState();
+    const int generation = m_generation.loadAcquire();
+    if (!local.name.isEmpty() && local.generation == generation) {
+        return QSqlDatabase::database(local.name, false);
+    }
+
+    local.release();
+    if (!QSqlDatabase::contains(m_connectionName)) {
+        local.lastError = "Database is not open";
+        return QSqlDatabase();
+    }
+
+    // Same driver, file and connect options as the owner's connection
+    const QString name = QString("%1/thread-%2/%3")
+                             .arg(m_connectionName)
+                             .arg(quintptr(QThread::currentThreadId()))
+                             .arg(generation);
+    {
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(m_connectionName, name);
+        if (!db.open()) {
+            local.lastError = db.lastError().text();
+            qWarning() << "Failed to open thread connection:" << local.lastError;
+        } else {
+            // journal_mode belongs to the file; the rest is per connection
+            const StoragePragmas pragmas = storagePragmas(m_storageProfile);
+            const QStringList statements = {
+                QString("PRAGMA synchronous = %1").arg(pragmas.synchronous),
+                QString("PRAGMA cache_size = -%1").arg(pragmas.cacheSizeKiB),
+                QString("PRAGMA mmap_size = %1").arg(pragmas.mmapSizeBytes),
+                QString("PRAGMA temp_store = %1").arg(pragmas.tempStore),
+            };
+            QSqlQuery query(db);
+            for (const QString &sql : statements) {
+                if (!query.exec(sql)) {
+                    qWarning() << "Failed to set up thread connection:" << query.lastError().text();
+                }
+            }
+            if (!m_catalogPath.isEmpty() && !attachCatalog(db, &local.lastError)) {
+                qWarning() << "Failed to attach catalog to thread connection:" << local.lastError;
+            }
+            local.name = name;
+            local.generation = generation;
+            return db;
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return QSqlDatabase();
+}
+
+QString &Database::errorText()
+{
+    return isOwnerThread() ? m_lastError : threadState().lastError;
+}
+
+int &Database::transactionDepth()
+{
+    return isOwnerThread() ? m_transactionDepth : threadState().transactionDepth;
+}
+
+bool &Database::rollbackOnly()
+{
+    return isOwnerThread() ? m_rollbackOnly : threadState().rollbackOnly;
+}
+
+QSet<int> &Database::attachedArchives()
+{
+    return isOwnerThread() ? m_attachedArchives : threadState().attachedArchives;
+}
 
-    // Capital Planner tables
-    if (!createEquipmentPlanTable()) {
-        return false;
-    }
-    if (!createFacilityPlanTable()) {
+bool Database::postToOwner(std::function<void()> work)
+{
+    if (isOwnerThread()) {
         return false;
     }
-
+    QMetaObject::invokeMethod(this, std::move(work), Qt::QueuedConnection);
     return true;
 }
 
@@ -178,10 +1873,10 @@ bool Database::createTables()
 
 bool Database::createEquipmentPlanTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS equipment_plan (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             item_id INTEGER NOT NULL,
@@ -204,10 +1899,10 @@ bool Database::createEquipmentPlanTable()
 
 bool Database::createFacilityPlanTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS facility_plan (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             building_id INTEGER NOT NULL,
@@ -230,11 +1925,11 @@ bool Database::createFacilityPlanTable()
 
 bool Database::createFactoryBuildingsTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS factory_buildings (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.factory_buildings (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT UNIQUE NOT NULL,
             category TEXT,
@@ -247,7 +1942,7 @@ bool Database::createFactoryBuildingsTable()
             price REAL DEFAULT 0,
             notes TEXT
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create factory_buildings table:" << query.lastError().text();
         return false;
     }
@@ -257,11 +1952,11 @@ bool Database::createFactoryBuildingsTable()
 
 bool Database::createInventoryTables()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Inventory table - one record per item (global pool)
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS inventory (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             item_id INTEGER NOT NULL UNIQUE,
@@ -277,7 +1972,7 @@ bool Database::createInventoryTables()
     }
 
     // Oil tracking table (single row for settings)
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS oil_tracking (
             id INTEGER PRIMARY KEY CHECK (id = 1),
             oil_cap INTEGER DEFAULT 10000,
@@ -290,7 +1985,7 @@ bool Database::createInventoryTables()
     }
 
     // Initialize oil tracking with default values if empty
-    if (!query.exec("INSERT OR IGNORE INTO oil_tracking (id, oil_cap, total_oil_sold) VALUES (1, 10000, 0)")) {
+    if (!execQuery(query, "INSERT OR IGNORE INTO oil_tracking (id, oil_cap, total_oil_sold) VALUES (1, 10000, 0)")) {
         qWarning() << "Failed to initialize oil_tracking:" << query.lastError().text();
         return false;
     }
@@ -300,10 +1995,10 @@ bool Database::createInventoryTables()
 
 bool Database::createVehiclesTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS vehicles (
             id TEXT PRIMARY KEY,
             name TEXT NOT NULL,
@@ -327,11 +2022,11 @@ bool Database::createVehiclesTable()
 
 bool Database::createOperationsTables()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Fuel Log table
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS fuel_log (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             date_time TEXT NOT NULL,
@@ -350,7 +2045,7 @@ bool Database::createOperationsTables()
     }
 
     // Movement Sessions table
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS movement_sessions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             start_time TEXT NOT NULL,
@@ -364,7 +2059,7 @@ bool Database::createOperationsTables()
     }
 
     // Movement Equipment Usage table
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS movement_equipment_usage (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             session_id INTEGER NOT NULL,
@@ -387,10 +2082,10 @@ bool Database::createOperationsTables()
 
 bool Database::createProductionRunsTable()
 {
-        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlDatabase db = connection();
         QSqlQuery query(db);
 
-        if (!query.exec(R"(
+        if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS production_runs (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             recipe_id INTEGER NOT NULL,
@@ -410,10 +2105,10 @@ bool Database::createProductionRunsTable()
 
 bool Database::createShiftsTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS shifts (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             start_time TEXT NOT NULL,
@@ -432,10 +2127,10 @@ bool Database::createShiftsTable()
 
 bool Database::createCycleProfilesTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS cycle_profiles (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL,
@@ -457,10 +2152,10 @@ bool Database::createCycleProfilesTable()
 
 bool Database::createCycleRecordsTable()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         CREATE TABLE IF NOT EXISTS cycle_records (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             profile_id INTEGER NOT NULL,
@@ -487,15 +2182,15 @@ bool Database::createCycleRecordsTable()
 
 bool Database::addItem(const Item &item)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Items);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addItem", R"(
         INSERT INTO items (code, name, category, buy_price, sell_price_internal,
                           sell_price_display, weight, pricing_group, notes)
         VALUES (:code, :name, :category, :buy_price, :sell_price_internal,
                 :sell_price_display, :weight, :pricing_group, :notes)
     )");
+    QSqlQuery &query = *statement;
 
     query.bindValue(":code", item.code);
     query.bindValue(":name", item.name);
@@ -507,24 +2202,49 @@ bool Database::addItem(const Item &item)
     query.bindValue(":pricing_group", pricingGroupToString(item.pricingGroup));
     query.bindValue(":notes", item.notes);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add item:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add item:" << errorText();
         return false;
     }
 
+    invalidateItemCatalog();
     return true;
 }
 
-std::optional<Item> Database::getItem(int id)
+int Database::addItems(const QVector<Item> &items)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    ProfileScope scope("Database::addItems");
+    markDirty(DataTable::Items);
+
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    int added = 0;
+    for (const auto &item : items) {
+        if (addItem(item)) {
+            added++;
+        } else {
+            qWarning() << "Failed to import item:" << item.name << "code:" << item.code;
+        }
+    }
+
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    return added;
+}
 
-    query.prepare("SELECT * FROM items WHERE id = :id");
+std::optional<Item> Database::getItem(int id)
+{
+    CachedQuery statement = cachedQuery("getItem",
+                                        "SELECT * FROM items WHERE id = :id");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -546,13 +2266,12 @@ std::optional<Item> Database::getItem(int id)
 
 std::optional<Item> Database::getItemByCode(const QString &code)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM items WHERE code = :code");
+    CachedQuery statement = cachedQuery("getItemByCode",
+                                        "SELECT * FROM items WHERE code = :code");
+    QSqlQuery &query = *statement;
     query.bindValue(":code", code);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -574,11 +2293,12 @@ std::optional<Item> Database::getItemByCode(const QString &code)
 
 QVector<Item> Database::getAllItems()
 {
+    ProfileScope scope("Database::getAllItems");
     QVector<Item> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM items ORDER BY category, name")) {
+    if (!execQuery(query, "SELECT * FROM items ORDER BY category, name")) {
         qWarning() << "Failed to get items:" << query.lastError().text();
         return items;
     }
@@ -604,11 +2324,17 @@ QVector<Item> Database::getAllItems()
 
 QVector<QString> Database::getAllCategories()
 {
+    const bool owner = isOwnerThread();
+    if (owner && m_vocabulary.itemCategories) {
+        return *m_vocabulary.itemCategories;
+    }
+
     QVector<QString> categories;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    CachedQuery statement = cachedQuery("getAllCategories",
+                                        "SELECT DISTINCT category FROM items ORDER BY category");
+    QSqlQuery &query = *statement;
 
-    if (!query.exec("SELECT DISTINCT category FROM items ORDER BY category")) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get categories:" << query.lastError().text();
         return categories;
     }
@@ -620,19 +2346,22 @@ QVector<QString> Database::getAllCategories()
         }
     }
 
+    if (owner) {
+        m_vocabulary.itemCategories = categories;
+    }
     return categories;
 }
 
 QVector<Item> Database::getItemsByCategory(const QString &category)
 {
     QVector<Item> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM items WHERE category = :category ORDER BY name");
     query.bindValue(":category", category);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get items by category:" << query.lastError().text();
         return items;
     }
@@ -658,13 +2387,15 @@ QVector<Item> Database::getItemsByCategory(const QString &category)
 
 bool Database::updateItem(const Item &item)
 {
+    markDirty(DataTable::Items);
+
     if (!item.id.has_value()) {
-        m_lastError = "Cannot update item without id";
-        qWarning() << m_lastError;
+        errorText() = "Cannot update item without id";
+        qWarning() << errorText();
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -692,48 +2423,366 @@ bool Database::updateItem(const Item &item)
     query.bindValue(":pricing_group", pricingGroupToString(item.pricingGroup));
     query.bindValue(":notes", item.notes);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to update item:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to update item:" << errorText();
         return false;
     }
 
+    invalidateItemCatalog();
+
     return query.numRowsAffected() > 0;
 }
 
+int Database::repriceItems(PricingGroup group, double sellRatio)
+{
+    ProfileScope scope("Database::repriceItems");
+    markDirty(DataTable::Items);
+
+    // Every rule is a ratio of the buy price, so pricing 1.0 reads it off
+    const double ratio = sellRatio >= 0 ? sellRatio : calculateSellPrice(1.0, group);
+
+    // ROUND() rounds half away from zero, as std::round() does on import
+    CachedQuery statement = cachedQuery("repriceItems", R"(
+        UPDATE items SET
+            sell_price_internal = buy_price * :ratio,
+            sell_price_display = ROUND(buy_price * :ratioDisplay)
+        WHERE pricing_group = :pricing_group
+          AND (sell_price_internal IS NOT buy_price * :ratioChanged
+               OR sell_price_display IS NOT ROUND(buy_price * :ratioChangedDisplay))
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":ratio", ratio);
+    query.bindValue(":ratioDisplay", ratio);
+    query.bindValue(":ratioChanged", ratio);
+    query.bindValue(":ratioChangedDisplay", ratio);
+    query.bindValue(":pricing_group", pricingGroupToString(group));
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to reprice items:" << errorText();
+        return -1;
+    }
+
+    const int changed = query.numRowsAffected();
+    if (changed > 0) {
+        invalidateItemCatalog();
+    }
+    return changed;
+}
+
 bool Database::deleteItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Items);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM items WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to delete item:" << query.lastError().text();
         return false;
     }
 
+    invalidateItemCatalog();
+
     return query.numRowsAffected() > 0;
 }
 
+bool Database::clearAllItems()
+{
+    markDirty(DataTable::Items);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    if (!execQuery(query, "DELETE FROM items")) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to clear items:" << errorText();
+        return false;
+    }
+
+    invalidateItemCatalog();
+    return true;
+}
+
+void Database::invalidateItemCatalog()
+{
+    if (postToOwner([this]() { invalidateItemCatalog(); })) {
+        return;
+    }
+    m_itemCatalog->invalidate();
+}
+
+ItemCatalog &Database::itemCatalog()
+{
+    return *m_itemCatalog;
+}
+
+// =============================================================================
+// Reference Snapshot
+// =============================================================================
+
+QString Database::referenceSnapshotPath() const
+{
+    const QString path = m_catalogPath.isEmpty() ? databasePath() : m_catalogPath;
+    return path.isEmpty() || path == ":memory:" ? QString() : path + ".refsnap";
+}
+
+const ReferenceSnapshot *Database::referenceSnapshot()
+{
+    if (m_snapshotChecked || !m_usesSnapshot) {
+        return m_snapshot.get();
+    }
+    m_snapshotChecked = true;
+
+    const QString path = referenceSnapshotPath();
+    if (path.isEmpty() || !QFile::exists(path)) {
+        return nullptr;
+    }
+
+    QString error;
+    std::unique_ptr<ReferenceSnapshot> snapshot = ReferenceSnapshot::open(path, &error);
+    if (!snapshot) {
+        qWarning() << "Ignoring reference snapshot:" << error;
+        return nullptr;
+    }
+
+    // Item writes delete the file, but another program may have edited the
+    // table; a count and max id mismatch catches inserts and deletes cheaply
+    CachedQuery statement = cachedQuery("referenceSnapshot:maxId", "SELECT MAX(id) FROM items");
+    QSqlQuery &query = *statement;
+    const int maxId = execQuery(query) && query.next() ? query.value(0).toInt() : -1;
+    if (snapshot->itemCount() != getItemCount() || snapshot->maxItemId() != maxId) {
+        qWarning() << "Ignoring reference snapshot: out of date with the items table";
+        return nullptr;
+    }
+
+    m_snapshot = std::move(snapshot);
+    return m_snapshot.get();
+}
+
+bool Database::writeReferenceSnapshot(const QByteArray &sourceChecksum)
+{
+    ProfileScope scope("Database::writeReferenceSnapshot");
+    const QString path = referenceSnapshotPath();
+    if (!m_usesSnapshot || path.isEmpty()) {
+        errorText() = "Reference snapshots need a file database opened with initialize()";
+        return false;
+    }
+
+    const QVector<Item> items = getAllItems();
+    m_snapshot.reset();
+    if (!ReferenceSnapshot::write(path, items, sourceChecksum, &errorText())) {
+        qWarning() << "Failed to write reference snapshot:" << errorText();
+        m_snapshotChecked = true;
+        return false;
+    }
+
+    m_snapshotChecked = false;           // Reopen lazily from the new file
+    return true;
+}
+
+// =============================================================================
+// Reference Sources
+// =============================================================================
+
+QByteArray Database::referenceSource(const QString &dataSet)
+{
+    CachedQuery statement = cachedQuery("referenceSource",
+        "SELECT checksum FROM reference_sources WHERE data_set = :data_set");
+    QSqlQuery &query = *statement;
+    query.bindValue(":data_set", dataSet);
+    if (!execQuery(query) || !query.next()) {
+        return QByteArray();
+    }
+    return QByteArray::fromHex(query.value(0).toString().toLatin1());
+}
+
+bool Database::setReferenceSource(const QString &dataSet, const QByteArray &checksum)
+{
+    CachedQuery statement = checksum.isEmpty()
+        ? cachedQuery("clearReferenceSource", "DELETE FROM reference_sources WHERE data_set = :data_set")
+        : cachedQuery("setReferenceSource", R"(
+              INSERT INTO reference_sources (data_set, checksum, recorded_at)
+              VALUES (:data_set, :checksum, :recorded_at)
+              ON CONFLICT(data_set) DO UPDATE SET checksum = excluded.checksum,
+                                                  recorded_at = excluded.recorded_at
+          )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":data_set", dataSet);
+    if (!checksum.isEmpty()) {
+        query.bindValue(":checksum", QString::fromLatin1(checksum.toHex()));
+        query.bindValue(":recorded_at", QDateTime::currentDateTime().toString(Qt::ISODate));
+    }
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to record reference source:" << errorText();
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Full-Text Search
+// =============================================================================
+
+// One searched table: the row alias is x, the FTS table f. detail's %1 is
+// a notes excerpt, from snippet() or, without the index, the notes' start.
+struct SearchSource {
+    DataTable table;
+    int index;                  // Into SearchIndexes
+    const char *title;
+    const char *detail;
+    const char *join;           // %1 is the reference schema
+    const char *weights;        // bm25 weight per indexed column
+};
+
+static const SearchSource SearchSources[] = {
+    { DataTable::Items, 0, "x.name", "x.code", "", "10.0, 5.0, 1.0" },
+    { DataTable::Transactions, 1, "x.item_name", "x.date || '  ' || %1", "", "4.0, 1.0" },
+    { DataTable::Shifts, 2, "substr(x.start_time, 1, 10)", "%1", "", "1.0" },
+    { DataTable::Production, 3, "COALESCE(r.output_item, 'Recipe #' || x.recipe_id)",
+      "substr(x.timestamp, 1, 10) || '  ' || %1", "LEFT JOIN %1.recipes r ON r.id = x.recipe_id", "1.0" },
+};
+
+QVector<SearchHit> Database::search(const QString &text, DataTables tables, int limit)
+{
+    ProfileScope scope("Database::search");
+    QVector<SearchHit> hits;
+
+    const QStringList words = searchWords(text);
+    if (words.isEmpty() || limit == 0) {
+        return hits;
+    }
+    const QString match = ftsMatchExpression(words);
+
+    for (const SearchSource &source : SearchSources) {
+        if (!tables.testFlag(source.table)) {
+            continue;
+        }
+        const SearchIndexSpec &index = SearchIndexes[source.index];
+        const QString schema = index.reference ? referenceSchema() : QStringLiteral("main");
+        const QString table = index.table;
+        const QString title = source.title;
+        const QString detail = source.detail;
+        const QString join = *source.join ? " " + QString(source.join).arg(referenceSchema()) : QString();
+        auto detailOf = [&detail](const QString &excerpt) {
+            return detail.contains("%1") ? detail.arg(excerpt) : detail;
+        };
+
+        QString sql;
+        QStringList likeBinds;
+        if (m_hasSearchIndex) {
+            const QString fts = table + "_fts";
+            const QString excerpt = QString("snippet(%1, -1, '', '', '...', 8)").arg(fts);
+            sql = QString("SELECT x.id, %1 AS title, %2 AS detail, bm25(%3, %4) AS score "
+                          "FROM %5.%3 JOIN %5.%6 x ON x.id = %3.rowid%7 "
+                          "WHERE %3 MATCH :match ORDER BY score LIMIT :limit")
+                      .arg(title, detailOf(excerpt), fts, QString(source.weights), schema, table, join);
+        } else {
+            // Each word in any indexed column; a placeholder per use, as
+            // the driver binds each name once
+            QStringList conditions;
+            const QStringList columns = QString(index.columns).split(", ");
+            for (const QString &word : words) {
+                QString pattern = word;
+                pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+                QStringList any;
+                for (const QString &column : columns) {
+                    any << QString("x.%1 LIKE :w%2 ESCAPE '\\'").arg(column).arg(likeBinds.size());
+                    likeBinds << "%" + pattern + "%";
+                }
+                conditions << "(" + any.join(" OR ") + ")";
+            }
+            sql = QString("SELECT x.id, %1 AS title, %2 AS detail, 0 AS score FROM %3.%4 x%5 "
+                          "WHERE %6 ORDER BY x.id DESC LIMIT :limit")
+                      .arg(title, detailOf("substr(COALESCE(x.notes, ''), 1, 64)"), schema, table, join,
+                           conditions.join(" AND "));
+        }
+
+        CachedQuery statement = cachedQuery(sql, sql);
+        QSqlQuery &query = *statement;
+        if (m_hasSearchIndex) {
+            query.bindValue(":match", match);
+        }
+        for (int i = 0; i < likeBinds.size(); ++i) {
+            query.bindValue(QString(":w%1").arg(i), likeBinds[i]);
+        }
+        query.bindValue(":limit", limit);
+        if (!execQuery(query)) {
+            qWarning() << "Failed to search" << table << ":" << query.lastError().text();
+            continue;
+        }
+        while (query.next()) {
+            SearchHit hit;
+            hit.table = source.table;
+            hit.id = query.value(0).toInt();
+            hit.title = query.value(1).toString();
+            hit.detail = query.value(2).toString();
+            hit.rank = query.value(3).toDouble();
+            hits.append(hit);
+        }
+        query.finish();
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const SearchHit &a, const SearchHit &b) {
+        return a.rank < b.rank;
+    });
+    if (limit > 0 && hits.size() > limit) {
+        hits.resize(limit);
+    }
+    return hits;
+}
+
 // =============================================================================
 // Transaction CRUD
 // =============================================================================
 
-bool Database::addTransaction(const Transaction &transaction)
+bool Database::addTransaction(const Transaction &transaction, int *insertedId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    return insertTransaction(transaction, false, insertedId);
+}
 
-    query.prepare(R"(
-        INSERT INTO transactions (date, type, account, item_name, category,
-                                  quantity, unit_price, total_amount, notes)
-        VALUES (:date, :type, :account, :item_name, :category,
-                :quantity, :unit_price, :total_amount, :notes)
-    )");
+bool Database::restoreTransaction(const Transaction &transaction)
+{
+    if (!transaction.id.has_value()) {
+        qWarning() << "Cannot restore transaction without id";
+        return false;
+    }
+    return insertTransaction(transaction, true, nullptr);
+}
+
+bool Database::insertTransaction(const Transaction &transaction, bool keepId, int *insertedId)
+{
+    // markDirty() invalidates the store; a loaded one takes the new row
+    // below instead of reloading the whole ledger
+    const bool patchStore = isOwnerThread() && m_transactionStore && m_transactionStore->isLoaded();
+    invalidateForWrite(DataTable::Transactions);
+
+    CachedQuery statement = keepId
+        ? cachedQuery("restoreTransaction", R"(
+            INSERT INTO transactions (id, date, day, type, account, item_name, category,
+                                      quantity, unit_price, total_amount, notes)
+            VALUES (:id, :date, :day, :type, :account, :item_name, :category,
+                    :quantity, :unit_price, :total_amount, :notes)
+        )")
+        : cachedQuery("addTransaction", R"(
+            INSERT INTO transactions (date, day, type, account, item_name, category,
+                                      quantity, unit_price, total_amount, notes)
+            VALUES (:date, :day, :type, :account, :item_name, :category,
+                    :quantity, :unit_price, :total_amount, :notes)
+        )");
+    QSqlQuery &query = *statement;
 
+    if (keepId) {
+        query.bindValue(":id", transaction.id.value());
+    }
     query.bindValue(":date", transaction.date.toString(Qt::ISODate));
+    query.bindValue(":day", storedDay(transaction.date));
     query.bindValue(":type", transactionTypeToString(transaction.type));
     query.bindValue(":account", accountTypeToString(transaction.account));
     query.bindValue(":item_name", transaction.item);
@@ -743,33 +2792,44 @@ bool Database::addTransaction(const Transaction &transaction)
     query.bindValue(":total_amount", transaction.totalAmount);
     query.bindValue(":notes", transaction.notes);
 
-    if (!query.exec()) {
-        qWarning() << "Failed to add transaction:" << query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add transaction:" << errorText();
         return false;
     }
 
+    Transaction added = transaction;
+    added.id = keepId ? transaction.id.value() : query.lastInsertId().toInt();
+    if (insertedId) {
+        *insertedId = added.id.value();
+    }
+    if (patchStore) {
+        m_transactionStore->insert(added);
+    }
+    publishRowChange(DataTable::Transactions, RowChange::Inserted, added.id.value());
     return true;
 }
 
 std::optional<Transaction> Database::getTransaction(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM transactions WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
     Transaction transaction;
     transaction.id = query.value("id").toInt();
-    transaction.date = QDate::fromString(query.value("date").toString(), Qt::ISODate);
+    transaction.date = dateFromStored(query.value("day"), query.value("date"));
     transaction.type = stringToTransactionType(query.value("type").toString());
     transaction.account = stringToAccountType(query.value("account").toString());
     transaction.item = query.value("item_name").toString();
     transaction.category = query.value("category").toString();
+    internStrings(transaction);
     transaction.quantity = query.value("quantity").toInt();
     transaction.unitPrice = query.value("unit_price").toDouble();
     transaction.totalAmount = query.value("total_amount").toDouble();
@@ -780,11 +2840,12 @@ std::optional<Transaction> Database::getTransaction(int id)
 
 QVector<Transaction> Database::getAllTransactions()
 {
+    ProfileScope scope("Database::getAllTransactions");
     QVector<Transaction> transactions;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM transactions ORDER BY date DESC, id DESC")) {
+    if (!execQuery(query, "SELECT * FROM " + archiveSource("transactions") + " ORDER BY date DESC, id DESC")) {
         qWarning() << "Failed to get transactions:" << query.lastError().text();
         return transactions;
     }
@@ -792,11 +2853,12 @@ QVector<Transaction> Database::getAllTransactions()
     while (query.next()) {
         Transaction transaction;
         transaction.id = query.value("id").toInt();
-        transaction.date = QDate::fromString(query.value("date").toString(), Qt::ISODate);
+        transaction.date = dateFromStored(query.value("day"), query.value("date"));
         transaction.type = stringToTransactionType(query.value("type").toString());
         transaction.account = stringToAccountType(query.value("account").toString());
         transaction.item = query.value("item_name").toString();
         transaction.category = query.value("category").toString();
+        internStrings(transaction);
         transaction.quantity = query.value("quantity").toInt();
         transaction.unitPrice = query.value("unit_price").toDouble();
         transaction.totalAmount = query.value("total_amount").toDouble();
@@ -809,55 +2871,285 @@ QVector<Transaction> Database::getAllTransactions()
 
 QVector<Transaction> Database::getTransactionsByDateRange(const QDate &from, const QDate &to)
 {
+    const bool cache = m_memoizes && isOwnerThread();
+    const QString key = QString("getTransactionsByDateRange:%1:%2").arg(from.toJulianDay()).arg(to.toJulianDay());
+    const quint64 stamp = m_resultCache.stamp(DataTable::Transactions);
+    if (cache) {
+        if (auto hit = m_resultCache.find<QVector<Transaction>>(key, stamp)) {
+            return *hit;
+        }
+    }
+
     QVector<Transaction> transactions;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare(R"(
-        SELECT * FROM transactions
-        WHERE date >= :from AND date <= :to
-        ORDER BY date DESC, id DESC
-    )");
+    query.prepare(QString(R"(
+        SELECT * FROM %1
+        WHERE day >= :from AND day <= :to
+        ORDER BY day DESC, id DESC
+    )").arg(archiveSource("transactions", from, to)));
 
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    query.bindValue(":from", storedDay(from));
+    query.bindValue(":to", storedDay(to));
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get transactions by date range:" << query.lastError().text();
         return transactions;
     }
 
     while (query.next()) {
-        Transaction transaction;
-        transaction.id = query.value("id").toInt();
-        transaction.date = QDate::fromString(query.value("date").toString(), Qt::ISODate);
-        transaction.type = stringToTransactionType(query.value("type").toString());
-        transaction.account = stringToAccountType(query.value("account").toString());
-        transaction.item = query.value("item_name").toString();
-        transaction.category = query.value("category").toString();
-        transaction.quantity = query.value("quantity").toInt();
-        transaction.unitPrice = query.value("unit_price").toDouble();
-        transaction.totalAmount = query.value("total_amount").toDouble();
-        transaction.notes = query.value("notes").toString();
-        transactions.append(transaction);
+        Transaction transaction;
+        transaction.id = query.value("id").toInt();
+        transaction.date = dateFromStored(query.value("day"), query.value("date"));
+        transaction.type = stringToTransactionType(query.value("type").toString());
+        transaction.account = stringToAccountType(query.value("account").toString());
+        transaction.item = query.value("item_name").toString();
+        transaction.category = query.value("category").toString();
+        internStrings(transaction);
+        transaction.quantity = query.value("quantity").toInt();
+        transaction.unitPrice = query.value("unit_price").toDouble();
+        transaction.totalAmount = query.value("total_amount").toDouble();
+        transaction.notes = query.value("notes").toString();
+        transactions.append(transaction);
+    }
+
+    if (cache) {
+        m_resultCache.insert(key, stamp, transactions, transactions.size());
+    }
+    return transactions;
+}
+
+// Builds the WHERE clause shared by queryTransactions/getTransactionTotals.
+// Only the placeholders for set fields appear, so the SQL text doubles as
+// the statement cache key. fullText matches the search through the item
+// column of the search index, which only covers the live table.
+static QString transactionFilterClause(const TransactionQuery &filter, bool fullText)
+{
+    QStringList conditions;
+    if (filter.from.isValid()) conditions << "day >= :from";
+    if (filter.to.isValid()) conditions << "day <= :to";
+    if (filter.type) conditions << "type = :type";
+    if (filter.account) conditions << "account = :account";
+    if (!filter.category.isEmpty()) conditions << "category = :category";
+    if (!filter.search.isEmpty()) {
+        conditions << (fullText ? "id IN (SELECT rowid FROM transactions_fts WHERE transactions_fts MATCH :search)"
+                                : "item_name LIKE :search ESCAPE '\\'");
+    }
+
+    return conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ");
+}
+
+static void bindTransactionFilter(QSqlQuery &query, const TransactionQuery &filter, bool fullText)
+{
+    if (filter.from.isValid()) query.bindValue(":from", storedDay(filter.from));
+    if (filter.to.isValid()) query.bindValue(":to", storedDay(filter.to));
+    if (filter.type) query.bindValue(":type", transactionTypeToString(*filter.type));
+    if (filter.account) query.bindValue(":account", accountTypeToString(*filter.account));
+    if (!filter.category.isEmpty()) query.bindValue(":category", filter.category);
+    if (fullText && !filter.search.isEmpty()) {
+        query.bindValue(":search", "item_name : (" + ftsMatchExpression(searchWords(filter.search)) + ")");
+    } else if (!filter.search.isEmpty()) {
+        QString pattern = filter.search;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        query.bindValue(":search", "%" + pattern + "%");
+    }
+}
+
+// Whether a filter reading source can take its search from the index; a
+// search with no words ("-") keeps the substring match
+bool Database::searchesByIndex(const QString &source, const TransactionQuery &filter) const
+{
+    return m_hasSearchIndex && source == "transactions" && !searchWords(filter.search).isEmpty();
+}
+
+QVector<Transaction> Database::queryTransactions(const TransactionQuery &filter)
+{
+    ProfileScope scope("Database::queryTransactions");
+    QVector<Transaction> transactions;
+
+    const QString source = archiveSource("transactions", filter.from, filter.to);
+    const bool fullText = searchesByIndex(source, filter);
+    QString sql = "SELECT * FROM " + source + transactionFilterClause(filter, fullText)
+                  + " ORDER BY (type = 'Opening') DESC, date DESC, id DESC";
+    if (filter.limit >= 0) {
+        sql += " LIMIT :limit OFFSET :offset";
+    }
+
+    scope.setDetail(sql);
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    bindTransactionFilter(query, filter, fullText);
+    if (filter.limit >= 0) {
+        query.bindValue(":limit", filter.limit);
+        query.bindValue(":offset", qMax(0, filter.offset));
+    }
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to query transactions:" << query.lastError().text();
+        return transactions;
+    }
+
+    while (query.next()) {
+        Transaction transaction;
+        transaction.id = query.value("id").toInt();
+        transaction.date = dateFromStored(query.value("day"), query.value("date"));
+        transaction.type = stringToTransactionType(query.value("type").toString());
+        transaction.account = stringToAccountType(query.value("account").toString());
+        transaction.item = query.value("item_name").toString();
+        transaction.category = query.value("category").toString();
+        internStrings(transaction);
+        transaction.quantity = query.value("quantity").toInt();
+        transaction.unitPrice = query.value("unit_price").toDouble();
+        transaction.totalAmount = query.value("total_amount").toDouble();
+        transaction.notes = query.value("notes").toString();
+        transactions.append(transaction);
+    }
+
+    return transactions;
+}
+
+QVector<RecentTransaction> Database::getRecentTransactions(int limit)
+{
+    ProfileScope scope("Database::getRecentTransactions");
+    QVector<RecentTransaction> recent;
+
+    // The newest rows come off idx_transactions_date; the balance after
+    // each row is today's total minus the deltas of the rows newer than it
+    CachedQuery statement = cachedQuery("getRecentTransactions", R"(
+        WITH recent AS (
+            SELECT *,
+                   CASE WHEN type IN ('Sale', 'Opening') THEN total_amount
+                        WHEN type IN ('Purchase', 'Fuel') THEN -total_amount
+                        WHEN type = 'Transfer' THEN total_amount
+                        ELSE 0 END AS delta
+            FROM transactions
+            ORDER BY date DESC, id DESC
+            LIMIT :limit
+        )
+        SELECT recent.*,
+               (SELECT COALESCE(SUM(balance), 0) FROM account_balances)
+               - COALESCE(SUM(delta) OVER (ORDER BY date DESC, id DESC
+                                           ROWS BETWEEN UNBOUNDED PRECEDING AND 1 PRECEDING), 0)
+                 AS balance_after
+        FROM recent
+        ORDER BY date DESC, id DESC
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":limit", qMax(0, limit));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get recent transactions:" << query.lastError().text();
+        return recent;
+    }
+
+    while (query.next()) {
+        RecentTransaction row;
+        Transaction &transaction = row.transaction;
+        transaction.id = query.value("id").toInt();
+        transaction.date = dateFromStored(query.value("day"), query.value("date"));
+        transaction.type = stringToTransactionType(query.value("type").toString());
+        transaction.account = stringToAccountType(query.value("account").toString());
+        transaction.item = query.value("item_name").toString();
+        transaction.category = query.value("category").toString();
+        internStrings(transaction);
+        transaction.quantity = query.value("quantity").toInt();
+        transaction.unitPrice = query.value("unit_price").toDouble();
+        transaction.totalAmount = query.value("total_amount").toDouble();
+        transaction.notes = query.value("notes").toString();
+        row.balanceAfter = query.value("balance_after").toDouble();
+        recent.append(row);
+    }
+
+    return recent;
+}
+
+TransactionTotals Database::getTransactionTotals(const TransactionQuery &filter)
+{
+    ProfileScope scope("Database::getTransactionTotals");
+    TransactionTotals totals;
+
+    const QString source = archiveSource("transactions", filter.from, filter.to);
+    const bool fullText = searchesByIndex(source, filter);
+    QString sql = R"(
+        SELECT COUNT(*) as count,
+               COALESCE(SUM(CASE WHEN type IN ('Sale', 'Opening') AND account = 'Company'
+                                 THEN total_amount END), 0) as company_income,
+               COALESCE(SUM(CASE WHEN type IN ('Sale', 'Opening') AND account = 'Personal'
+                                 THEN total_amount END), 0) as personal_income,
+               COALESCE(SUM(CASE WHEN type IN ('Purchase', 'Fuel') AND account = 'Company'
+                                 THEN total_amount END), 0) as company_expenses,
+               COALESCE(SUM(CASE WHEN type IN ('Purchase', 'Fuel') AND account = 'Personal'
+                                 THEN total_amount END), 0) as personal_expenses
+        FROM )" + source + transactionFilterClause(filter, fullText);
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    bindTransactionFilter(query, filter, fullText);
+
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to get transaction totals:" << query.lastError().text();
+        return totals;
+    }
+
+    totals.count = query.value("count").toInt();
+    totals.companyIncome = query.value("company_income").toDouble();
+    totals.personalIncome = query.value("personal_income").toDouble();
+    totals.companyExpenses = query.value("company_expenses").toDouble();
+    totals.personalExpenses = query.value("personal_expenses").toDouble();
+
+    return totals;
+}
+
+QVector<QString> Database::getTransactionCategories()
+{
+    const bool owner = isOwnerThread();
+    if (owner && m_vocabulary.transactionCategories) {
+        return *m_vocabulary.transactionCategories;
+    }
+
+    QVector<QString> categories;
+    CachedQuery statement = cachedQuery("getTransactionCategories", R"(
+        SELECT DISTINCT category FROM transactions
+        WHERE category IS NOT NULL AND category != ''
+        ORDER BY category
+    )");
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get transaction categories:" << query.lastError().text();
+        return categories;
+    }
+
+    while (query.next()) {
+        categories.append(query.value(0).toString());
     }
 
-    return transactions;
+    if (owner) {
+        m_vocabulary.transactionCategories = categories;
+    }
+    return categories;
 }
 
 bool Database::updateTransaction(const Transaction &transaction)
 {
+    // As in insertTransaction(), a loaded store is patched, not reloaded
+    const bool patchStore = isOwnerThread() && m_transactionStore && m_transactionStore->isLoaded();
+    invalidateForWrite(DataTable::Transactions);
+
     if (!transaction.id.has_value()) {
         qWarning() << "Cannot update transaction without id";
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
         UPDATE transactions SET
             date = :date,
+            day = :day,
             type = :type,
             account = :account,
             item_name = :item_name,
@@ -871,6 +3163,7 @@ bool Database::updateTransaction(const Transaction &transaction)
 
     query.bindValue(":id", transaction.id.value());
     query.bindValue(":date", transaction.date.toString(Qt::ISODate));
+    query.bindValue(":day", storedDay(transaction.date));
     query.bindValue(":type", transactionTypeToString(transaction.type));
     query.bindValue(":account", accountTypeToString(transaction.account));
     query.bindValue(":item_name", transaction.item);
@@ -880,28 +3173,47 @@ bool Database::updateTransaction(const Transaction &transaction)
     query.bindValue(":total_amount", transaction.totalAmount);
     query.bindValue(":notes", transaction.notes);
 
-    if (!query.exec()) {
-        qWarning() << "Failed to update transaction:" << query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to update transaction:" << errorText();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    const bool updated = query.numRowsAffected() > 0;
+    if (updated) {
+        if (patchStore) {
+            m_transactionStore->update(transaction);
+        }
+        publishRowChange(DataTable::Transactions, RowChange::Updated, transaction.id.value());
+    }
+    return updated;
 }
 
 bool Database::deleteTransaction(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    const bool patchStore = isOwnerThread() && m_transactionStore && m_transactionStore->isLoaded();
+    invalidateForWrite(DataTable::Transactions);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM transactions WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
-        qWarning() << "Failed to delete transaction:" << query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to delete transaction:" << errorText();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    const bool deleted = query.numRowsAffected() > 0;
+    if (deleted) {
+        if (patchStore) {
+            m_transactionStore->remove(id);
+        }
+        publishRowChange(DataTable::Transactions, RowChange::Deleted, id);
+    }
+    return deleted;
 }
 
 // =============================================================================
@@ -910,7 +3222,9 @@ bool Database::deleteTransaction(int id)
 
 bool Database::addVehicle(const Vehicle &vehicle)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Vehicles);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -936,23 +3250,86 @@ bool Database::addVehicle(const Vehicle &vehicle)
     query.bindValue(":active", vehicle.active ? 1 : 0);
     query.bindValue(":notes", vehicle.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add vehicle:" << query.lastError().text();
         return false;
     }
 
+    emit vehiclesChanged();
     return true;
 }
 
-std::optional<Vehicle> Database::getVehicle(const QString &id)
+int Database::upsertVehicles(const QVector<Vehicle> &vehicles)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    ProfileScope scope("Database::upsertVehicles");
+    markDirty(DataTable::Vehicles);
+
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    CachedQuery statement = cachedQuery("upsertVehicles", R"(
+        INSERT INTO vehicles (id, name, category_main, category_sub,
+                              bucket_capacity_m3, truck_capacity_m3,
+                              tank_capacity_l, fuel_use_l_per_hour,
+                              purchase_price, active, notes)
+        VALUES (:id, :name, :category_main, :category_sub,
+                :bucket_capacity_m3, :truck_capacity_m3,
+                :tank_capacity_l, :fuel_use_l_per_hour,
+                :purchase_price, :active, :notes)
+        ON CONFLICT(id) DO UPDATE SET
+            name = excluded.name,
+            category_main = excluded.category_main,
+            category_sub = excluded.category_sub,
+            bucket_capacity_m3 = excluded.bucket_capacity_m3,
+            truck_capacity_m3 = excluded.truck_capacity_m3,
+            tank_capacity_l = excluded.tank_capacity_l,
+            fuel_use_l_per_hour = excluded.fuel_use_l_per_hour,
+            purchase_price = excluded.purchase_price,
+            active = excluded.active,
+            notes = excluded.notes
+    )");
+    QSqlQuery &query = *statement;
+
+    int written = 0;
+    for (const auto &vehicle : vehicles) {
+        query.bindValue(":id", vehicle.id);
+        query.bindValue(":name", vehicle.name);
+        query.bindValue(":category_main", vehicle.categoryMain);
+        query.bindValue(":category_sub", vehicle.categorySub);
+        query.bindValue(":bucket_capacity_m3", vehicle.bucketCapacityM3);
+        query.bindValue(":truck_capacity_m3", vehicle.truckCapacityM3);
+        query.bindValue(":tank_capacity_l", vehicle.tankCapacityL);
+        query.bindValue(":fuel_use_l_per_hour", vehicle.fuelUseLPerHour);
+        query.bindValue(":purchase_price", vehicle.purchasePrice);
+        query.bindValue(":active", vehicle.active ? 1 : 0);
+        query.bindValue(":notes", vehicle.notes);
+
+        if (execQuery(query)) {
+            written++;
+        } else {
+            qWarning() << "Failed to write vehicle:" << vehicle.id << query.lastError().text();
+        }
+    }
 
-    query.prepare("SELECT * FROM vehicles WHERE id = :id");
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    if (written > 0) {
+        emit vehiclesChanged();
+    }
+    return written;
+}
+
+std::optional<Vehicle> Database::getVehicle(const QString &id)
+{
+    CachedQuery statement = cachedQuery("getVehicle",
+                                        "SELECT * FROM vehicles WHERE id = :id");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -974,8 +3351,9 @@ std::optional<Vehicle> Database::getVehicle(const QString &id)
 
 QVector<Vehicle> Database::getAllVehicles(bool activeOnly)
 {
+    ProfileScope scope("Database::getAllVehicles");
     QVector<Vehicle> vehicles;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     QString sql = "SELECT * FROM vehicles";
@@ -984,7 +3362,7 @@ QVector<Vehicle> Database::getAllVehicles(bool activeOnly)
     }
     sql += " ORDER BY category_main, name";
 
-    if (!query.exec(sql)) {
+    if (!execQuery(query, sql)) {
         qWarning() << "Failed to get vehicles:" << query.lastError().text();
         return vehicles;
     }
@@ -1010,7 +3388,9 @@ QVector<Vehicle> Database::getAllVehicles(bool activeOnly)
 
 bool Database::updateVehicle(const Vehicle &vehicle)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Vehicles);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1040,28 +3420,55 @@ bool Database::updateVehicle(const Vehicle &vehicle)
     query.bindValue(":active", vehicle.active ? 1 : 0);
     query.bindValue(":notes", vehicle.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update vehicle:" << query.lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    if (query.numRowsAffected() <= 0) {
+        return false;
+    }
+    emit vehiclesChanged();
+    return true;
 }
 
 bool Database::deleteVehicle(const QString &id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Vehicles);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM vehicles WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to delete vehicle:" << query.lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    if (query.numRowsAffected() <= 0) {
+        return false;
+    }
+    emit vehiclesChanged();
+    return true;
+}
+
+bool Database::clearAllVehicles()
+{
+    markDirty(DataTable::Vehicles);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    if (!execQuery(query, "DELETE FROM vehicles")) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to clear vehicles:" << errorText();
+        return false;
+    }
+
+    emit vehiclesChanged();
+    return true;
 }
 
 // =============================================================================
@@ -1070,17 +3477,32 @@ bool Database::deleteVehicle(const QString &id)
 
 bool Database::addFuelLogEntry(const FuelLogEntry &entry)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    // markDirty() invalidates the tracker; a loaded one takes the entry
+    // below instead of regrouping the log
+    const bool patchTracker = isOwnerThread() && m_fuelEfficiency && m_fuelEfficiency->isLoaded();
+    markDirty(DataTable::FuelLog);
 
-    query.prepare(R"(
-        INSERT INTO fuel_log (date_time, equipment_id, liters, unit_price,
+    if (!insertFuelLogEntry(entry)) {
+        return false;
+    }
+    if (patchTracker) {
+        m_fuelEfficiency->add(entry);
+    }
+    return true;
+}
+
+bool Database::insertFuelLogEntry(const FuelLogEntry &entry)
+{
+    CachedQuery statement = cachedQuery("addFuelLogEntry", R"(
+        INSERT INTO fuel_log (date_time, ts, equipment_id, liters, unit_price,
                               total_cost, meter_or_hours, source, notes)
-        VALUES (:date_time, :equipment_id, :liters, :unit_price,
+        VALUES (:date_time, :ts, :equipment_id, :liters, :unit_price,
                 :total_cost, :meter_or_hours, :source, :notes)
     )");
+    QSqlQuery &query = *statement;
 
     query.bindValue(":date_time", entry.dateTime.toString(Qt::ISODate));
+    query.bindValue(":ts", storedSeconds(entry.dateTime));
     query.bindValue(":equipment_id", entry.equipmentId);
     query.bindValue(":liters", entry.liters);
     query.bindValue(":unit_price", entry.unitPrice);
@@ -1089,7 +3511,7 @@ bool Database::addFuelLogEntry(const FuelLogEntry &entry)
     query.bindValue(":source", entry.source);
     query.bindValue(":notes", entry.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add fuel log entry:" << query.lastError().text();
         return false;
     }
@@ -1097,33 +3519,73 @@ bool Database::addFuelLogEntry(const FuelLogEntry &entry)
     return true;
 }
 
+int Database::addFuelLogEntries(const QVector<FuelLogEntry> &entries)
+{
+    const bool patchTracker = isOwnerThread() && m_fuelEfficiency && m_fuelEfficiency->isLoaded();
+    markDirty(DataTable::FuelLog);
+
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    QVector<const FuelLogEntry *> written;
+    for (const auto &entry : entries) {
+        if (insertFuelLogEntry(entry)) {
+            written.append(&entry);
+        }
+    }
+
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    // Only once committed; a rollback leaves the tracker to reload
+    if (patchTracker) {
+        for (const FuelLogEntry *entry : written) {
+            m_fuelEfficiency->add(*entry);
+        }
+    }
+    return written.size();
+}
+
 QVector<FuelLogEntry> Database::getFuelLog(const QDateTime &from, const QDateTime &to,
                                             const QString &equipmentId)
 {
+    ProfileScope scope("Database::getFuelLog");
+    const bool cache = m_memoizes && isOwnerThread();
+    const QString key = QString("getFuelLog:%1:%2:%3")
+                            .arg(from.toString(Qt::ISODateWithMs), to.toString(Qt::ISODateWithMs), equipmentId);
+    const quint64 stamp = m_resultCache.stamp(DataTable::FuelLog);
+    if (cache) {
+        if (auto hit = m_resultCache.find<QVector<FuelLogEntry>>(key, stamp)) {
+            return *hit;
+        }
+    }
+
     QVector<FuelLogEntry> entries;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    QString sql = R"(
-        SELECT * FROM fuel_log
-        WHERE date_time >= :from AND date_time <= :to
-    )";
+    QString sql = QString(R"(
+        SELECT * FROM %1
+        WHERE ts >= :from AND ts <= :to
+    )").arg(archiveSource("fuel_log", from.date(), to.date()));
 
     if (!equipmentId.isEmpty()) {
         sql += " AND equipment_id = :equipment_id";
     }
 
-    sql += " ORDER BY date_time DESC";
+    sql += " ORDER BY ts DESC";
 
     query.prepare(sql);
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    query.bindValue(":from", storedSeconds(from));
+    query.bindValue(":to", storedSeconds(to));
 
     if (!equipmentId.isEmpty()) {
         query.bindValue(":equipment_id", equipmentId);
     }
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get fuel log:" << query.lastError().text();
         return entries;
     }
@@ -1131,7 +3593,7 @@ QVector<FuelLogEntry> Database::getFuelLog(const QDateTime &from, const QDateTim
     while (query.next()) {
         FuelLogEntry entry;
         entry.id = query.value("id").toInt();
-        entry.dateTime = QDateTime::fromString(query.value("date_time").toString(), Qt::ISODate);
+        entry.dateTime = dateTimeFromStored(query.value("ts"), query.value("date_time"));
         entry.equipmentId = query.value("equipment_id").toString();
         entry.liters = query.value("liters").toDouble();
         entry.unitPrice = query.value("unit_price").toDouble();
@@ -1142,49 +3604,189 @@ QVector<FuelLogEntry> Database::getFuelLog(const QDateTime &from, const QDateTim
         entries.append(entry);
     }
 
+    if (cache) {
+        m_resultCache.insert(key, stamp, entries, entries.size());
+    }
     return entries;
 }
 
 double Database::getTotalFuelInRange(const QDateTime &from, const QDateTime &to)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    return sumFuelInRange("liters", from, to);
+}
 
-    query.prepare(R"(
-        SELECT COALESCE(SUM(liters), 0) as total
-        FROM fuel_log
-        WHERE date_time >= :from AND date_time <= :to
-    )");
+double Database::getTotalFuelCostInRange(const QDateTime &from, const QDateTime &to)
+{
+    return sumFuelInRange("total_cost", from, to);
+}
 
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+double Database::sumFuelInRange(const QString &column, const QDateTime &from, const QDateTime &to)
+{
+    ProfileScope scope("Database::sumFuelInRange");
+    // Days wholly inside [from, to] come from the rollup; only the partial
+    // first and last days are summed from raw log rows
+    const QDate firstFullDay = from.time() == QTime(0, 0) ? from.date() : from.date().addDays(1);
+    const QDate lastFullDay = to.time() >= QTime(23, 59, 59) ? to.date() : to.date().addDays(-1);
+    // The rollup keeps archived days; the edge rows may be archived
+    const QString source = archiveSource("fuel_log", from.date(), to.date());
+
+    if (firstFullDay > lastFullDay) {
+        CachedQuery statement = cachedQuery("sumFuelRaw:" + column + source, QString(R"(
+            SELECT COALESCE(SUM(%1), 0) FROM %2
+            WHERE ts >= :from AND ts <= :to
+        )").arg(column, source));
+        QSqlQuery &query = *statement;
+        query.bindValue(":from", storedSeconds(from));
+        query.bindValue(":to", storedSeconds(to));
+
+        if (execQuery(query) && query.next()) {
+            return query.value(0).toDouble();
+        }
+        return 0;
+    }
+
+    CachedQuery statement = cachedQuery("sumFuelRollup:" + column + source, QString(R"(
+        SELECT COALESCE(SUM(total), 0) FROM (
+            SELECT SUM(%1) AS total FROM fuel_daily_rollup
+            WHERE date >= :first_day AND date <= :last_day
+            UNION ALL
+            SELECT SUM(%1) FROM %2
+            WHERE ts >= :from AND ts < :first_day_start
+            UNION ALL
+            SELECT SUM(%1) FROM %2
+            WHERE ts >= :after_last_day AND ts <= :to
+        )
+    )").arg(column, source));
+    QSqlQuery &query = *statement;
+    query.bindValue(":first_day", firstFullDay.toString(Qt::ISODate));
+    query.bindValue(":last_day", lastFullDay.toString(Qt::ISODate));
+    query.bindValue(":from", storedSeconds(from));
+    query.bindValue(":first_day_start", storedSeconds(QDateTime(firstFullDay, QTime(0, 0))));
+    query.bindValue(":after_last_day", storedSeconds(QDateTime(lastFullDay.addDays(1), QTime(0, 0))));
+    query.bindValue(":to", storedSeconds(to));
 
-    if (query.exec() && query.next()) {
-        return query.value("total").toDouble();
+    if (execQuery(query) && query.next()) {
+        return query.value(0).toDouble();
     }
 
+    qWarning() << "Failed to sum fuel log:" << query.lastError().text();
     return 0;
 }
 
-double Database::getTotalFuelCostInRange(const QDateTime &from, const QDateTime &to)
+QVector<FuelDailyTotal> Database::getFuelDailyTotals(const QDate &from, const QDate &to,
+                                                     const QString &equipmentId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QVector<FuelDailyTotal> totals;
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare(R"(
-        SELECT COALESCE(SUM(total_cost), 0) as total
-        FROM fuel_log
-        WHERE date_time >= :from AND date_time <= :to
-    )");
+    QString sql = R"(
+        SELECT date, equipment_id, liters, total_cost, entries
+        FROM fuel_daily_rollup
+        WHERE date >= :from AND date <= :to
+    )";
+    if (!equipmentId.isEmpty()) {
+        sql += " AND equipment_id = :equipment_id";
+    }
+    sql += " ORDER BY date, equipment_id";
 
+    query.prepare(sql);
     query.bindValue(":from", from.toString(Qt::ISODate));
     query.bindValue(":to", to.toString(Qt::ISODate));
+    if (!equipmentId.isEmpty()) {
+        query.bindValue(":equipment_id", equipmentId);
+    }
 
-    if (query.exec() && query.next()) {
-        return query.value("total").toDouble();
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get fuel daily totals:" << query.lastError().text();
+        return totals;
     }
 
-    return 0;
+    while (query.next()) {
+        FuelDailyTotal total;
+        total.date = QDate::fromString(query.value(0).toString(), Qt::ISODate);
+        total.equipmentId = query.value(1).toString();
+        total.liters = query.value(2).toDouble();
+        total.totalCost = query.value(3).toDouble();
+        total.entries = query.value(4).toInt();
+        total.days = 1;
+        totals.append(total);
+    }
+
+    return totals;
+}
+
+QVector<FuelDailyTotal> Database::getFuelTotalsByEquipment(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("Database::getFuelTotalsByEquipment");
+    QVector<FuelDailyTotal> totals;
+    CachedQuery statement = cachedQuery("getFuelTotalsByEquipment", R"(
+        SELECT equipment_id, SUM(liters), SUM(total_cost), SUM(entries), COUNT(*)
+        FROM fuel_daily_rollup
+        WHERE date >= :from AND date <= :to
+        GROUP BY equipment_id
+        ORDER BY SUM(liters) DESC
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":to", to.toString(Qt::ISODate));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get fuel totals by equipment:" << query.lastError().text();
+        return totals;
+    }
+
+    while (query.next()) {
+        FuelDailyTotal total;
+        total.equipmentId = query.value(0).toString();
+        total.liters = query.value(1).toDouble();
+        total.totalCost = query.value(2).toDouble();
+        total.entries = query.value(3).toInt();
+        total.days = query.value(4).toInt();
+        totals.append(total);
+    }
+
+    return totals;
+}
+
+QVector<FuelHours> Database::getFuelHours(const QDate &from, const QDate &to, bool perDay)
+{
+    ProfileScope scope("Database::getFuelHours");
+    QVector<FuelHours> totals;
+
+    // [from, to] is [from 00:00, to + 1 day 00:00) in stored seconds, and
+    // a day is the seconds divided down to whole days since 1970
+    QString sql = "SELECT equipment_id, " + QString(perDay ? "ts / 86400" : "NULL")
+                  + ", SUM(liters), SUM(meter_or_hours), COUNT(*) FROM "
+                  + archiveSource("fuel_log", from, to)
+                  + " WHERE meter_or_hours > 0 AND equipment_id <> ''";
+    if (from.isValid()) sql += " AND ts >= :from";
+    if (to.isValid()) sql += " AND ts < :to";
+    sql += perDay ? " GROUP BY equipment_id, ts / 86400" : " GROUP BY equipment_id";
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    if (from.isValid()) query.bindValue(":from", storedSeconds(QDateTime(from, QTime(0, 0))));
+    if (to.isValid()) query.bindValue(":to", storedSeconds(QDateTime(to.addDays(1), QTime(0, 0))));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get fuel hours:" << query.lastError().text();
+        return totals;
+    }
+
+    while (query.next()) {
+        FuelHours total;
+        total.equipmentId = query.value(0).toString();
+        if (perDay && !query.value(1).isNull()) {
+            total.date = QDate::fromJulianDay(UnixEpochJulianDay + query.value(1).toLongLong());
+        }
+        total.liters = query.value(2).toDouble();
+        total.hours = query.value(3).toDouble();
+        total.entries = query.value(4).toInt();
+        totals.append(total);
+    }
+
+    return totals;
 }
 
 // =============================================================================
@@ -1193,7 +3795,9 @@ double Database::getTotalFuelCostInRange(const QDateTime &from, const QDateTime
 
 int Database::addMovementSession(const MovementSession &session)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Movement);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1207,7 +3811,7 @@ int Database::addMovementSession(const MovementSession &session)
     query.bindValue(":map_name", session.mapName);
     query.bindValue(":notes", session.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add movement session:" << query.lastError().text();
         return -1;
     }
@@ -1217,13 +3821,13 @@ int Database::addMovementSession(const MovementSession &session)
 
 std::optional<MovementSession> Database::getMovementSession(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM movement_sessions WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -1245,10 +3849,10 @@ std::optional<MovementSession> Database::getMovementSession(int id)
 QVector<MovementSession> Database::getAllMovementSessions()
 {
     QVector<MovementSession> sessions;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM movement_sessions ORDER BY start_time DESC")) {
+    if (!execQuery(query, "SELECT * FROM movement_sessions ORDER BY start_time DESC")) {
         qWarning() << "Failed to get movement sessions:" << query.lastError().text();
         return sessions;
     }
@@ -1271,11 +3875,124 @@ QVector<MovementSession> Database::getAllMovementSessions()
     return sessions;
 }
 
+// Totals the usage of the sessions selected by `sessions` (a subquery over
+// movement_sessions), one row each in the subquery's order. The volume
+// CASE mirrors OperationsManager::calculateVolume(): buckets over bucket
+// capacity, then dumps, then legacy loads over truck capacity.
+static QString movementSummarySql(const QString &sessions)
+{
+    return QString(R"(
+        SELECT s.id, s.start_time, s.end_time, s.map_name, s.notes,
+               COUNT(u.id) AS usage_count,
+               COALESCE(SUM(u.hours_used), 0) AS hours,
+               COALESCE(SUM(u.estimated_fuel_l), 0) AS fuel_l,
+               COALESCE(SUM(CASE WHEN u.role = 'HaulTruck' THEN 0 ELSE %2 END), 0) AS loader_m3,
+               COALESCE(SUM(CASE WHEN u.role = 'HaulTruck' THEN %2 ELSE 0 END), 0) AS truck_m3
+        FROM (%1) s
+        LEFT JOIN movement_equipment_usage u ON u.session_id = s.id
+        LEFT JOIN vehicles v ON v.id = u.equipment_id
+        GROUP BY s.id
+        ORDER BY s.start_time DESC, s.id DESC
+    )").arg(sessions, R"(CASE
+            WHEN u.buckets > 0 AND v.bucket_capacity_m3 > 0 THEN u.buckets * v.bucket_capacity_m3
+            WHEN u.dumps > 0 AND v.truck_capacity_m3 > 0 THEN u.dumps * v.truck_capacity_m3
+            WHEN u.loads > 0 AND v.truck_capacity_m3 > 0 THEN u.loads * v.truck_capacity_m3
+            ELSE 0 END)");
+}
+
+static MovementSessionSummary readMovementSummary(const QSqlQuery &query)
+{
+    MovementSessionSummary summary;
+    MovementSession &session = summary.session;
+    session.id = query.value("id").toInt();
+    session.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
+    const QString endTimeStr = query.value("end_time").toString();
+    if (!endTimeStr.isEmpty()) {
+        session.endTime = QDateTime::fromString(endTimeStr, Qt::ISODate);
+    }
+    session.mapName = query.value("map_name").toString();
+    session.notes = query.value("notes").toString();
+
+    summary.usageCount = query.value("usage_count").toInt();
+    summary.hours = query.value("hours").toDouble();
+    summary.fuelL = query.value("fuel_l").toDouble();
+    summary.loaderVolumeM3 = query.value("loader_m3").toDouble();
+    summary.truckVolumeM3 = query.value("truck_m3").toDouble();
+    return summary;
+}
+
+QVector<MovementSessionSummary> Database::queryMovementSessions(const MovementSessionQuery &filter)
+{
+    ProfileScope scope("Database::queryMovementSessions");
+    QVector<MovementSessionSummary> summaries;
+
+    // Page the sessions first so only that page's usage rows are joined
+    QString sessions = "SELECT * FROM movement_sessions";
+    const QString search = filter.search.trimmed();
+    bool idSearch = false;
+    const int searchId = search.startsWith('#') ? search.mid(1).toInt(&idSearch) : 0;
+    if (idSearch) {
+        sessions += " WHERE id = :id";
+    } else if (!search.isEmpty()) {
+        sessions += " WHERE map_name LIKE :search ESCAPE '\\' OR notes LIKE :searchNotes ESCAPE '\\'";
+    }
+    sessions += " ORDER BY start_time DESC, id DESC";
+    if (filter.limit >= 0) {
+        sessions += " LIMIT :limit OFFSET :offset";
+    }
+    const QString sql = movementSummarySql(sessions);
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    if (idSearch) {
+        query.bindValue(":id", searchId);
+    } else if (!search.isEmpty()) {
+        QString pattern = search;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        query.bindValue(":search", "%" + pattern + "%");
+        query.bindValue(":searchNotes", "%" + pattern + "%");
+    }
+    if (filter.limit >= 0) {
+        query.bindValue(":limit", filter.limit);
+        query.bindValue(":offset", qMax(0, filter.offset));
+    }
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to query movement sessions:" << query.lastError().text();
+        return summaries;
+    }
+
+    while (query.next()) {
+        summaries.append(readMovementSummary(query));
+    }
+
+    return summaries;
+}
+
+std::optional<MovementSessionSummary> Database::getMovementSessionSummary(int sessionId)
+{
+    CachedQuery statement = cachedQuery("getMovementSessionSummary",
+                                        movementSummarySql("SELECT * FROM movement_sessions WHERE id = :id"));
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", sessionId);
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get movement session summary:" << query.lastError().text();
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return std::nullopt;
+    }
+    return readMovementSummary(query);
+}
+
 bool Database::updateMovementSession(const MovementSession &session)
 {
+    markDirty(DataTable::Movement);
+
     if (!session.id.has_value()) return false;
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1294,7 +4011,7 @@ bool Database::updateMovementSession(const MovementSession &session)
     query.bindValue(":map_name", session.mapName);
     query.bindValue(":notes", session.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update movement session:" << query.lastError().text();
         return false;
     }
@@ -1304,16 +4021,24 @@ bool Database::updateMovementSession(const MovementSession &session)
 
 bool Database::deleteMovementSession(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Movement);
 
-    // First delete associated equipment usage
+    QSqlDatabase db = connection();
+
+    // First delete associated equipment usage and captured events
     deleteEquipmentUsageForSession(id);
 
     QSqlQuery query(db);
+    query.prepare("DELETE FROM movement_events WHERE session_id = :id");
+    query.bindValue(":id", id);
+    if (!execQuery(query)) {
+        qWarning() << "Failed to delete movement events:" << query.lastError().text();
+    }
+
     query.prepare("DELETE FROM movement_sessions WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to delete movement session:" << query.lastError().text();
         return false;
     }
@@ -1327,55 +4052,71 @@ bool Database::deleteMovementSession(int id)
 
 bool Database::addOrUpdateEquipmentUsage(const MovementEquipmentUsage &usage)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Movement);
 
-    // Check if entry exists for this session/equipment/role combo
-    query.prepare(R"(
-        SELECT id FROM movement_equipment_usage
-        WHERE session_id = :session_id
-          AND equipment_id = :equipment_id
-          AND role = :role
+    if (!upsertEquipmentUsage(usage)) {
+        qWarning() << "Failed to add/update equipment usage:" << errorText();
+        return false;
+    }
+
+    return true;
+}
+
+int Database::saveEquipmentUsages(int sessionId, const QVector<MovementEquipmentUsage> &usages)
+{
+    markDirty(DataTable::Movement);
+
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    int written = 0;
+    for (const auto &usage : usages) {
+        MovementEquipmentUsage row = usage;
+        row.sessionId = sessionId;
+        if (upsertEquipmentUsage(row)) {
+            written++;
+        } else {
+            qWarning() << "Failed to write equipment usage:" << row.equipmentId << errorText();
+        }
+    }
+
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    return written;
+}
+
+bool Database::upsertEquipmentUsage(const MovementEquipmentUsage &usage)
+{
+    // Relies on the unique (session_id, equipment_id, role) index
+    CachedQuery statement = cachedQuery("upsertEquipmentUsage", R"(
+        INSERT INTO movement_equipment_usage
+            (session_id, equipment_id, role, hours_used, buckets, loads, dumps, estimated_fuel_l)
+        VALUES
+            (:session_id, :equipment_id, :role, :hours_used, :buckets, :loads, :dumps, :estimated_fuel_l)
+        ON CONFLICT(session_id, equipment_id, role) DO UPDATE SET
+            hours_used = excluded.hours_used,
+            buckets = excluded.buckets,
+            loads = excluded.loads,
+            dumps = excluded.dumps,
+            estimated_fuel_l = excluded.estimated_fuel_l
     )");
+    QSqlQuery &query = *statement;
+
     query.bindValue(":session_id", usage.sessionId);
     query.bindValue(":equipment_id", usage.equipmentId);
-    query.bindValue(":role", usage.role);
-
-    if (query.exec() && query.next()) {
-        // Update existing
-        int existingId = query.value("id").toInt();
-
-        query.prepare(R"(
-            UPDATE movement_equipment_usage SET
-                hours_used = :hours_used,
-                buckets = :buckets,
-                loads = :loads,
-                dumps = :dumps,
-                estimated_fuel_l = :estimated_fuel_l
-            WHERE id = :id
-        )");
-        query.bindValue(":id", existingId);
-    } else {
-        // Insert new
-        query.prepare(R"(
-            INSERT INTO movement_equipment_usage
-                (session_id, equipment_id, role, hours_used, buckets, loads, dumps, estimated_fuel_l)
-            VALUES
-                (:session_id, :equipment_id, :role, :hours_used, :buckets, :loads, :dumps, :estimated_fuel_l)
-        )");
-        query.bindValue(":session_id", usage.sessionId);
-        query.bindValue(":equipment_id", usage.equipmentId);
-        query.bindValue(":role", usage.role);
-    }
-
+    // NULLs never conflict, so an unset role is stored as ''
+    query.bindValue(":role", usage.role.isNull() ? QStringLiteral("") : usage.role);
     query.bindValue(":hours_used", usage.hoursUsed);
     query.bindValue(":buckets", usage.buckets);
     query.bindValue(":loads", usage.loads);
     query.bindValue(":dumps", usage.dumps);
     query.bindValue(":estimated_fuel_l", usage.estimatedFuelL);
 
-    if (!query.exec()) {
-        qWarning() << "Failed to add/update equipment usage:" << query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
         return false;
     }
 
@@ -1385,7 +4126,7 @@ bool Database::addOrUpdateEquipmentUsage(const MovementEquipmentUsage &usage)
 QVector<MovementEquipmentUsage> Database::getEquipmentUsageForSession(int sessionId)
 {
     QVector<MovementEquipmentUsage> usages;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1395,7 +4136,7 @@ QVector<MovementEquipmentUsage> Database::getEquipmentUsageForSession(int sessio
     )");
     query.bindValue(":session_id", sessionId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get equipment usage:" << query.lastError().text();
         return usages;
     }
@@ -1419,34 +4160,110 @@ QVector<MovementEquipmentUsage> Database::getEquipmentUsageForSession(int sessio
 
 bool Database::deleteEquipmentUsage(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Movement);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    query.prepare("DELETE FROM movement_equipment_usage WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to delete equipment usage:" << query.lastError().text();
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
+bool Database::deleteEquipmentUsageForSession(int sessionId)
+{
+    markDirty(DataTable::Movement);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare("DELETE FROM movement_equipment_usage WHERE id = :id");
-    query.bindValue(":id", id);
+    query.prepare("DELETE FROM movement_equipment_usage WHERE session_id = :session_id");
+    query.bindValue(":session_id", sessionId);
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to delete equipment usage for session:" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+// =============================================================================
+// Movement Events
+// =============================================================================
+
+int Database::addMovementEvents(const QVector<MovementEvent> &events)
+{
+    invalidateForWrite(DataTable::Movement);
+
+    if (!beginTransaction()) {
+        return -1;
+    }
 
-    if (!query.exec()) {
-        qWarning() << "Failed to delete equipment usage:" << query.lastError().text();
-        return false;
+    CachedQuery statement = cachedQuery("addMovementEvent", R"(
+        INSERT INTO movement_events (session_id, equipment_id, kind, time, ts)
+        VALUES (:session_id, :equipment_id, :kind, :time, :ts)
+    )");
+    QSqlQuery &query = *statement;
+
+    int written = 0;
+    for (const auto &event : events) {
+        query.bindValue(":session_id", event.sessionId);
+        query.bindValue(":equipment_id", event.equipmentId);
+        query.bindValue(":kind", movementEventKindToString(event.kind));
+        query.bindValue(":time", event.time.toString(Qt::ISODateWithMs));
+        query.bindValue(":ts", storedSeconds(event.time));
+
+        if (execQuery(query)) {
+            written++;
+        } else {
+            qWarning() << "Failed to write movement event:" << event.equipmentId << query.lastError().text();
+        }
     }
 
-    return query.numRowsAffected() > 0;
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    return written;
 }
 
-bool Database::deleteEquipmentUsageForSession(int sessionId)
+QVector<MovementEvent> Database::getMovementEvents(int sessionId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QVector<MovementEvent> events;
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare("DELETE FROM movement_equipment_usage WHERE session_id = :session_id");
+    query.prepare(R"(
+        SELECT id, session_id, equipment_id, kind, time FROM movement_events
+        WHERE session_id = :session_id
+        ORDER BY id
+    )");
     query.bindValue(":session_id", sessionId);
 
-    if (!query.exec()) {
-        qWarning() << "Failed to delete equipment usage for session:" << query.lastError().text();
-        return false;
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get movement events:" << query.lastError().text();
+        return events;
     }
 
-    return true;
+    while (query.next()) {
+        MovementEvent event;
+        event.id = query.value(0).toInt();
+        event.sessionId = query.value(1).toInt();
+        event.equipmentId = query.value(2).toString();
+        event.kind = stringToMovementEventKind(query.value(3).toString());
+        // The text keeps the milliseconds that ts drops
+        event.time = QDateTime::fromString(query.value(4).toString(), Qt::ISODateWithMs);
+        events.append(event);
+    }
+
+    return events;
 }
 
 // =============================================================================
@@ -1455,23 +4272,23 @@ bool Database::deleteEquipmentUsageForSession(int sessionId)
 
 bool Database::createRecipeTables()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Workbenches table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS workbenches (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.workbenches (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT UNIQUE NOT NULL
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create workbenches table:" << query.lastError().text();
         return false;
     }
 
     // Recipes table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS recipes (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.recipes (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             workbench_id INTEGER NOT NULL,
             output_item TEXT NOT NULL,
@@ -1479,21 +4296,21 @@ bool Database::createRecipeTables()
             notes TEXT,
             FOREIGN KEY (workbench_id) REFERENCES workbenches(id)
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create recipes table:" << query.lastError().text();
         return false;
     }
 
     // Recipe ingredients table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS recipe_ingredients (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.recipe_ingredients (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             recipe_id INTEGER NOT NULL,
             item_name TEXT NOT NULL,
             quantity INTEGER DEFAULT 1,
             FOREIGN KEY (recipe_id) REFERENCES recipes(id) ON DELETE CASCADE
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create recipe_ingredients table:" << query.lastError().text();
         return false;
     }
@@ -1507,13 +4324,14 @@ bool Database::createRecipeTables()
 
 int Database::addWorkbench(const Workbench &workbench)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Recipes);
 
-    query.prepare("INSERT INTO workbenches (name) VALUES (:name)");
+    CachedQuery statement = cachedQuery("addWorkbench",
+                                        "INSERT INTO workbenches (name) VALUES (:name)");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", workbench.name);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add workbench:" << query.lastError().text();
         return -1;
     }
@@ -1523,13 +4341,12 @@ int Database::addWorkbench(const Workbench &workbench)
 
 std::optional<Workbench> Database::getWorkbench(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM workbenches WHERE id = :id");
+    CachedQuery statement = cachedQuery("getWorkbench",
+                                        "SELECT * FROM workbenches WHERE id = :id");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -1542,13 +4359,12 @@ std::optional<Workbench> Database::getWorkbench(int id)
 
 std::optional<Workbench> Database::getWorkbenchByName(const QString &name)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM workbenches WHERE name = :name");
+    CachedQuery statement = cachedQuery("getWorkbenchByName",
+                                        "SELECT * FROM workbenches WHERE name = :name");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", name);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -1562,10 +4378,10 @@ std::optional<Workbench> Database::getWorkbenchByName(const QString &name)
 QVector<Workbench> Database::getAllWorkbenches()
 {
     QVector<Workbench> workbenches;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM workbenches ORDER BY name")) {
+    if (!execQuery(query, "SELECT * FROM workbenches ORDER BY name")) {
         qWarning() << "Failed to get workbenches:" << query.lastError().text();
         return workbenches;
     }
@@ -1582,34 +4398,40 @@ QVector<Workbench> Database::getAllWorkbenches()
 
 bool Database::deleteWorkbench(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Recipes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM workbenches WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    invalidateRecipeGraph();
+    return execQuery(query);
 }
 
 bool Database::clearAllWorkbenches()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Recipes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Delete in order due to foreign keys
-    if (!query.exec("DELETE FROM recipe_ingredients")) {
+    if (!execQuery(query, "DELETE FROM recipe_ingredients")) {
         qWarning() << "Failed to clear recipe_ingredients:" << query.lastError().text();
         return false;
     }
-    if (!query.exec("DELETE FROM recipes")) {
+    if (!execQuery(query, "DELETE FROM recipes")) {
         qWarning() << "Failed to clear recipes:" << query.lastError().text();
         return false;
     }
-    if (!query.exec("DELETE FROM workbenches")) {
+    if (!execQuery(query, "DELETE FROM workbenches")) {
         qWarning() << "Failed to clear workbenches:" << query.lastError().text();
         return false;
     }
 
+    invalidateRecipeGraph();
     return true;
 }
 
@@ -1619,40 +4441,70 @@ bool Database::clearAllWorkbenches()
 
 int Database::addRecipe(const Recipe &recipe)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Recipes);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addRecipe", R"(
         INSERT INTO recipes (workbench_id, output_item, output_qty, notes)
         VALUES (:workbench_id, :output_item, :output_qty, :notes)
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":workbench_id", recipe.workbenchId);
     query.bindValue(":output_item", recipe.outputItem);
     query.bindValue(":output_qty", recipe.outputQty);
     query.bindValue(":notes", recipe.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add recipe:" << query.lastError().text();
         return -1;
     }
 
+    invalidateRecipeGraph();
     return query.lastInsertId().toInt();
 }
 
-std::optional<Recipe> Database::getRecipe(int id)
+int Database::addRecipes(QVector<Recipe> &recipes)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    ProfileScope scope("Database::addRecipes");
+    markDirty(DataTable::Recipes);
 
-    query.prepare(R"(
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    int added = 0;
+    for (auto &recipe : recipes) {
+        int recipeId = addRecipe(recipe);
+        if (recipeId < 0) {
+            continue;  // addRecipe() already logged the failure
+        }
+
+        recipe.id = recipeId;
+        for (auto &ingredient : recipe.ingredients) {
+            ingredient.recipeId = recipeId;
+            addRecipeIngredient(ingredient);
+        }
+        added++;
+    }
+
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    return added;
+}
+
+std::optional<Recipe> Database::getRecipe(int id)
+{
+    CachedQuery statement = cachedQuery("getRecipe", R"(
         SELECT r.*, w.name as workbench_name
         FROM recipes r
         JOIN workbenches w ON r.workbench_id = w.id
         WHERE r.id = :id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -1661,6 +4513,7 @@ std::optional<Recipe> Database::getRecipe(int id)
     recipe.workbenchId = query.value("workbench_id").toInt();
     recipe.workbenchName = query.value("workbench_name").toString();
     recipe.outputItem = query.value("output_item").toString();
+    internStrings(recipe);
     recipe.outputQty = query.value("output_qty").toInt();
     recipe.notes = query.value("notes").toString();
 
@@ -1673,10 +4526,10 @@ std::optional<Recipe> Database::getRecipe(int id)
 QVector<Recipe> Database::getAllRecipes()
 {
     QVector<Recipe> recipes;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT r.*, w.name as workbench_name
         FROM recipes r
         JOIN workbenches w ON r.workbench_id = w.id
@@ -1692,22 +4545,23 @@ QVector<Recipe> Database::getAllRecipes()
         recipe.workbenchId = query.value("workbench_id").toInt();
         recipe.workbenchName = query.value("workbench_name").toString();
         recipe.outputItem = query.value("output_item").toString();
+        internStrings(recipe);
         recipe.outputQty = query.value("output_qty").toInt();
         recipe.notes = query.value("notes").toString();
 
-        // Load ingredients
-        recipe.ingredients = getIngredientsForRecipe(recipe.id.value());
-
         recipes.append(recipe);
     }
 
+    // Load all ingredients in one pass instead of one query per recipe
+    attachIngredients(recipes, true);
+
     return recipes;
 }
 
 QVector<Recipe> Database::getRecipesByWorkbench(int workbenchId)
 {
     QVector<Recipe> recipes;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1719,7 +4573,7 @@ QVector<Recipe> Database::getRecipesByWorkbench(int workbenchId)
     )");
     query.bindValue(":workbench_id", workbenchId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get recipes by workbench:" << query.lastError().text();
         return recipes;
     }
@@ -1730,12 +4584,14 @@ QVector<Recipe> Database::getRecipesByWorkbench(int workbenchId)
         recipe.workbenchId = query.value("workbench_id").toInt();
         recipe.workbenchName = query.value("workbench_name").toString();
         recipe.outputItem = query.value("output_item").toString();
+        internStrings(recipe);
         recipe.outputQty = query.value("output_qty").toInt();
         recipe.notes = query.value("notes").toString();
-        recipe.ingredients = getIngredientsForRecipe(recipe.id.value());
         recipes.append(recipe);
     }
 
+    attachIngredients(recipes, false);
+
     return recipes;
 }
 
@@ -1751,7 +4607,7 @@ QVector<Recipe> Database::getRecipesByWorkbenchName(const QString &workbenchName
 QVector<Recipe> Database::getRecipesForOutput(const QString &outputItem)
 {
     QVector<Recipe> recipes;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -1763,7 +4619,7 @@ QVector<Recipe> Database::getRecipesForOutput(const QString &outputItem)
     )");
     query.bindValue(":output_item", outputItem);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get recipes for output:" << query.lastError().text();
         return recipes;
     }
@@ -1774,18 +4630,22 @@ QVector<Recipe> Database::getRecipesForOutput(const QString &outputItem)
         recipe.workbenchId = query.value("workbench_id").toInt();
         recipe.workbenchName = query.value("workbench_name").toString();
         recipe.outputItem = query.value("output_item").toString();
+        internStrings(recipe);
         recipe.outputQty = query.value("output_qty").toInt();
         recipe.notes = query.value("notes").toString();
-        recipe.ingredients = getIngredientsForRecipe(recipe.id.value());
         recipes.append(recipe);
     }
 
+    attachIngredients(recipes, false);
+
     return recipes;
 }
 
 bool Database::deleteRecipe(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Recipes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Delete ingredients first (cascade should handle this, but be explicit)
@@ -1794,59 +4654,72 @@ bool Database::deleteRecipe(int id)
     query.prepare("DELETE FROM recipes WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    invalidateRecipeGraph();
+    return execQuery(query);
 }
 
 bool Database::clearAllRecipes()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Recipes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("DELETE FROM recipe_ingredients")) {
+    if (!execQuery(query, "DELETE FROM recipe_ingredients")) {
         return false;
     }
-    if (!query.exec("DELETE FROM recipes")) {
+    if (!execQuery(query, "DELETE FROM recipes")) {
         return false;
     }
 
+    invalidateRecipeGraph();
     return true;
 }
 
+std::shared_ptr<const RecipeGraph> Database::recipeGraph()
+{
+    if (!m_recipeGraph) {
+        ProfileScope scope("Database::recipeGraph (build)");
+        m_recipeGraph = std::make_shared<const RecipeGraph>(getAllRecipes());
+    }
+    return m_recipeGraph;
+}
+
 // =============================================================================
 // Recipe Ingredient CRUD
 // =============================================================================
 
 bool Database::addRecipeIngredient(const RecipeIngredient &ingredient)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Recipes);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addRecipeIngredient", R"(
         INSERT INTO recipe_ingredients (recipe_id, item_name, quantity)
         VALUES (:recipe_id, :item_name, :quantity)
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":recipe_id", ingredient.recipeId);
     query.bindValue(":item_name", ingredient.itemName);
     query.bindValue(":quantity", ingredient.quantity);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add recipe ingredient:" << query.lastError().text();
         return false;
     }
 
+    invalidateRecipeGraph();
     return true;
 }
 
 QVector<RecipeIngredient> Database::getIngredientsForRecipe(int recipeId)
 {
     QVector<RecipeIngredient> ingredients;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM recipe_ingredients WHERE recipe_id = :recipe_id");
+    CachedQuery statement = cachedQuery("getIngredientsForRecipe",
+                                        "SELECT * FROM recipe_ingredients WHERE recipe_id = :recipe_id");
+    QSqlQuery &query = *statement;
     query.bindValue(":recipe_id", recipeId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get ingredients:" << query.lastError().text();
         return ingredients;
     }
@@ -1856,6 +4729,7 @@ QVector<RecipeIngredient> Database::getIngredientsForRecipe(int recipeId)
         ing.id = query.value("id").toInt();
         ing.recipeId = query.value("recipe_id").toInt();
         ing.itemName = query.value("item_name").toString();
+        internStrings(ing);
         ing.quantity = query.value("quantity").toInt();
         ingredients.append(ing);
     }
@@ -1863,15 +4737,64 @@ QVector<RecipeIngredient> Database::getIngredientsForRecipe(int recipeId)
     return ingredients;
 }
 
+void Database::attachIngredients(QVector<Recipe> &recipes, bool wholeTable)
+{
+    if (recipes.isEmpty()) {
+        return;
+    }
+
+    QHash<int, int> indexById;  // recipe id -> position in recipes
+    QStringList ids;
+    indexById.reserve(recipes.size());
+    for (int i = 0; i < recipes.size(); ++i) {
+        int id = recipes[i].id.value_or(0);
+        indexById.insert(id, i);
+        ids.append(QString::number(id));
+    }
+
+    QString sql = "SELECT * FROM recipe_ingredients";
+    if (!wholeTable) {
+        // Ids are integers from our own query, safe to inline
+        sql += " WHERE recipe_id IN (" + ids.join(',') + ")";
+    }
+    sql += " ORDER BY recipe_id, id";
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if (!execQuery(query, sql)) {
+        qWarning() << "Failed to get ingredients:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next()) {
+        RecipeIngredient ing;
+        ing.id = query.value("id").toInt();
+        ing.recipeId = query.value("recipe_id").toInt();
+        ing.itemName = query.value("item_name").toString();
+        internStrings(ing);
+        ing.quantity = query.value("quantity").toInt();
+
+        auto it = indexById.constFind(ing.recipeId);
+        if (it != indexById.constEnd()) {
+            recipes[it.value()].ingredients.append(ing);
+        }
+    }
+}
+
 bool Database::deleteIngredientsForRecipe(int recipeId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Recipes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM recipe_ingredients WHERE recipe_id = :recipe_id");
     query.bindValue(":recipe_id", recipeId);
 
-    return query.exec();
+    invalidateRecipeGraph();
+    return execQuery(query);
 }
 
 // =============================================================================
@@ -1880,13 +4803,12 @@ bool Database::deleteIngredientsForRecipe(int recipeId)
 
 std::optional<Item> Database::getItemByName(const QString &name)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM items WHERE name = :name");
+    CachedQuery statement = cachedQuery("getItemByName",
+                                        "SELECT * FROM items WHERE name = :name");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", name);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -1912,35 +4834,35 @@ std::optional<Item> Database::getItemByName(const QString &name)
 
 bool Database::createLocationTables()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Maps table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS maps (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.maps (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             abbrev TEXT NOT NULL UNIQUE,
             name TEXT NOT NULL UNIQUE
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create maps table:" << query.lastError().text();
         return false;
     }
 
     // Location types table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS location_types (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.location_types (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL UNIQUE
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create location_types table:" << query.lastError().text();
         return false;
     }
 
     // Locations table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS locations (
+    if (!execQuery(query, QString(R"(
+        CREATE TABLE IF NOT EXISTS %1.locations (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL,
             map_id INTEGER NOT NULL,
@@ -1948,7 +4870,7 @@ bool Database::createLocationTables()
             FOREIGN KEY (map_id) REFERENCES maps(id),
             FOREIGN KEY (type_id) REFERENCES location_types(id)
         )
-    )")) {
+    )").arg(referenceSchema())) {
         qWarning() << "Failed to create locations table:" << query.lastError().text();
         return false;
     }
@@ -1962,19 +4884,19 @@ bool Database::createLocationTables()
 
 int Database::addMap(const Map &map)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Locations);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addMap", R"(
         INSERT INTO maps (abbrev, name)
         VALUES (:abbrev, :name)
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":abbrev", map.abbrev);
     query.bindValue(":name", map.name);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add map:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add map:" << errorText();
         return -1;
     }
 
@@ -1983,13 +4905,13 @@ int Database::addMap(const Map &map)
 
 std::optional<Map> Database::getMap(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM maps WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2003,13 +4925,13 @@ std::optional<Map> Database::getMap(int id)
 
 std::optional<Map> Database::getMapByAbbrev(const QString &abbrev)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM maps WHERE abbrev = :abbrev");
     query.bindValue(":abbrev", abbrev);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2024,10 +4946,10 @@ std::optional<Map> Database::getMapByAbbrev(const QString &abbrev)
 QVector<Map> Database::getAllMaps()
 {
     QVector<Map> maps;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM maps ORDER BY abbrev")) {
+    if (!execQuery(query, "SELECT * FROM maps ORDER BY abbrev")) {
         qWarning() << "Failed to get maps:" << query.lastError().text();
         return maps;
     }
@@ -2043,27 +4965,57 @@ QVector<Map> Database::getAllMaps()
     return maps;
 }
 
+bool Database::updateMap(const Map &map)
+{
+    markDirty(DataTable::Locations);
+
+    if (!map.id.has_value()) {
+        errorText() = "Cannot update map without id";
+        qWarning() << errorText();
+        return false;
+    }
+
+    CachedQuery statement = cachedQuery("updateMap",
+                                        "UPDATE maps SET abbrev = :abbrev, name = :name WHERE id = :id");
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", map.id.value());
+    query.bindValue(":abbrev", map.abbrev);
+    query.bindValue(":name", map.name);
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to update map:" << errorText();
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
 bool Database::deleteMap(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM maps WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::clearAllMaps()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Clear locations first (foreign key constraint)
-    if (!query.exec("DELETE FROM locations")) {
+    if (!execQuery(query, "DELETE FROM locations")) {
         return false;
     }
-    if (!query.exec("DELETE FROM maps")) {
+    if (!execQuery(query, "DELETE FROM maps")) {
         return false;
     }
 
@@ -2076,15 +5028,16 @@ bool Database::clearAllMaps()
 
 int Database::addLocationType(const LocationType &type)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Locations);
 
-    query.prepare("INSERT INTO location_types (name) VALUES (:name)");
+    CachedQuery statement = cachedQuery("addLocationType",
+                                        "INSERT INTO location_types (name) VALUES (:name)");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", type.name);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add location type:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add location type:" << errorText();
         return -1;
     }
 
@@ -2093,13 +5046,13 @@ int Database::addLocationType(const LocationType &type)
 
 std::optional<LocationType> Database::getLocationType(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM location_types WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2112,13 +5065,13 @@ std::optional<LocationType> Database::getLocationType(int id)
 
 std::optional<LocationType> Database::getLocationTypeByName(const QString &name)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM location_types WHERE name = :name");
     query.bindValue(":name", name);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2132,10 +5085,10 @@ std::optional<LocationType> Database::getLocationTypeByName(const QString &name)
 QVector<LocationType> Database::getAllLocationTypes()
 {
     QVector<LocationType> types;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM location_types ORDER BY name")) {
+    if (!execQuery(query, "SELECT * FROM location_types ORDER BY name")) {
         qWarning() << "Failed to get location types:" << query.lastError().text();
         return types;
     }
@@ -2152,25 +5105,29 @@ QVector<LocationType> Database::getAllLocationTypes()
 
 bool Database::deleteLocationType(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM location_types WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::clearAllLocationTypes()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Clear locations first (foreign key constraint)
-    if (!query.exec("DELETE FROM locations")) {
+    if (!execQuery(query, "DELETE FROM locations")) {
         return false;
     }
-    if (!query.exec("DELETE FROM location_types")) {
+    if (!execQuery(query, "DELETE FROM location_types")) {
         return false;
     }
 
@@ -2183,41 +5140,63 @@ bool Database::clearAllLocationTypes()
 
 int Database::addLocation(const Location &location)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Locations);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addLocation", R"(
         INSERT INTO locations (name, map_id, type_id)
         VALUES (:name, :map_id, :type_id)
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", location.name);
     query.bindValue(":map_id", location.mapId);
     query.bindValue(":type_id", location.typeId);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add location:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add location:" << errorText();
         return -1;
     }
 
     return query.lastInsertId().toInt();
 }
 
-std::optional<Location> Database::getLocation(int id)
+int Database::addLocations(const QVector<Location> &locations)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Locations);
 
-    query.prepare(R"(
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    int added = 0;
+    for (const auto &location : locations) {
+        if (addLocation(location) > 0) {
+            added++;
+        } else {
+            qWarning() << "Failed to import location:" << location.name;
+        }
+    }
+
+    if (!commitTransaction()) {
+        return -1;
+    }
+
+    return added;
+}
+
+std::optional<Location> Database::getLocation(int id)
+{
+    CachedQuery statement = cachedQuery("getLocation", R"(
         SELECT l.*, m.abbrev as map_abbrev, m.name as map_name, t.name as type_name
         FROM locations l
         JOIN maps m ON l.map_id = m.id
         JOIN location_types t ON l.type_id = t.id
         WHERE l.id = :id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2229,6 +5208,7 @@ std::optional<Location> Database::getLocation(int id)
     loc.mapAbbrev = query.value("map_abbrev").toString();
     loc.mapName = query.value("map_name").toString();
     loc.typeName = query.value("type_name").toString();
+    internStrings(loc);
 
     return loc;
 }
@@ -2236,10 +5216,10 @@ std::optional<Location> Database::getLocation(int id)
 QVector<Location> Database::getAllLocations()
 {
     QVector<Location> locations;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT l.*, m.abbrev as map_abbrev, m.name as map_name, t.name as type_name
         FROM locations l
         JOIN maps m ON l.map_id = m.id
@@ -2259,6 +5239,7 @@ QVector<Location> Database::getAllLocations()
         loc.mapAbbrev = query.value("map_abbrev").toString();
         loc.mapName = query.value("map_name").toString();
         loc.typeName = query.value("type_name").toString();
+        internStrings(loc);
         locations.append(loc);
     }
 
@@ -2268,7 +5249,7 @@ QVector<Location> Database::getAllLocations()
 QVector<Location> Database::getLocationsByMap(int mapId)
 {
     QVector<Location> locations;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2281,7 +5262,7 @@ QVector<Location> Database::getLocationsByMap(int mapId)
     )");
     query.bindValue(":map_id", mapId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get locations by map:" << query.lastError().text();
         return locations;
     }
@@ -2295,6 +5276,7 @@ QVector<Location> Database::getLocationsByMap(int mapId)
         loc.mapAbbrev = query.value("map_abbrev").toString();
         loc.mapName = query.value("map_name").toString();
         loc.typeName = query.value("type_name").toString();
+        internStrings(loc);
         locations.append(loc);
     }
 
@@ -2304,7 +5286,7 @@ QVector<Location> Database::getLocationsByMap(int mapId)
 QVector<Location> Database::getLocationsByType(int typeId)
 {
     QVector<Location> locations;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2317,7 +5299,7 @@ QVector<Location> Database::getLocationsByType(int typeId)
     )");
     query.bindValue(":type_id", typeId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get locations by type:" << query.lastError().text();
         return locations;
     }
@@ -2331,6 +5313,7 @@ QVector<Location> Database::getLocationsByType(int typeId)
         loc.mapAbbrev = query.value("map_abbrev").toString();
         loc.mapName = query.value("map_name").toString();
         loc.typeName = query.value("type_name").toString();
+        internStrings(loc);
         locations.append(loc);
     }
 
@@ -2340,7 +5323,7 @@ QVector<Location> Database::getLocationsByType(int typeId)
 QVector<Location> Database::getLocationsByMapAndType(int mapId, int typeId)
 {
     QVector<Location> locations;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2354,7 +5337,7 @@ QVector<Location> Database::getLocationsByMapAndType(int mapId, int typeId)
     query.bindValue(":map_id", mapId);
     query.bindValue(":type_id", typeId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get locations by map and type:" << query.lastError().text();
         return locations;
     }
@@ -2368,29 +5351,63 @@ QVector<Location> Database::getLocationsByMapAndType(int mapId, int typeId)
         loc.mapAbbrev = query.value("map_abbrev").toString();
         loc.mapName = query.value("map_name").toString();
         loc.typeName = query.value("type_name").toString();
+        internStrings(loc);
         locations.append(loc);
     }
 
     return locations;
 }
 
+bool Database::updateLocation(const Location &location)
+{
+    markDirty(DataTable::Locations);
+
+    if (!location.id.has_value()) {
+        errorText() = "Cannot update location without id";
+        qWarning() << errorText();
+        return false;
+    }
+
+    CachedQuery statement = cachedQuery("updateLocation", R"(
+        UPDATE locations SET name = :name, map_id = :map_id, type_id = :type_id
+        WHERE id = :id
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", location.id.value());
+    query.bindValue(":name", location.name);
+    query.bindValue(":map_id", location.mapId);
+    query.bindValue(":type_id", location.typeId);
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to update location:" << errorText();
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
 bool Database::deleteLocation(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM locations WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::clearAllLocations()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Locations);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    return query.exec("DELETE FROM locations");
+    return execQuery(query, "DELETE FROM locations");
 }
 
 // =============================================================================
@@ -2399,21 +5416,21 @@ bool Database::clearAllLocations()
 
     int Database::addInventoryItem(const InventoryItem &item)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Inventory);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("addInventoryItem", R"(
         INSERT INTO inventory (item_id, quantity, location_id, last_updated)
         VALUES (:item_id, :quantity, :location_id, :last_updated)
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":item_id", item.itemId);
     query.bindValue(":quantity", item.quantity);
     query.bindValue(":location_id", item.locationId.has_value() ? item.locationId.value() : QVariant());
     query.bindValue(":last_updated", QDateTime::currentDateTime().toString(Qt::ISODate));
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add inventory item:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add inventory item:" << errorText();
         return -1;
     }
 
@@ -2422,10 +5439,7 @@ bool Database::clearAllLocations()
 
 std::optional<InventoryItem> Database::getInventoryItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("getInventoryItem", R"(
         SELECT inv.*,
                i.name as item_name, i.code as item_code, i.category, i.sell_price_internal as unit_price,
                l.name as location_name
@@ -2434,9 +5448,10 @@ std::optional<InventoryItem> Database::getInventoryItem(int id)
         LEFT JOIN locations l ON inv.location_id = l.id
         WHERE inv.id = :id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2453,16 +5468,14 @@ std::optional<InventoryItem> Database::getInventoryItem(int id)
     item.category = query.value("category").toString();
     item.unitPrice = query.value("unit_price").toDouble();
     item.locationName = query.value("location_name").toString();
+    internStrings(item);
 
     return item;
 }
 
 std::optional<InventoryItem> Database::getInventoryByItemId(int itemId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("getInventoryByItemId", R"(
         SELECT inv.*,
                i.name as item_name, i.code as item_code, i.category, i.sell_price_internal as unit_price,
                l.name as location_name
@@ -2471,9 +5484,10 @@ std::optional<InventoryItem> Database::getInventoryByItemId(int itemId)
         LEFT JOIN locations l ON inv.location_id = l.id
         WHERE inv.item_id = :item_id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":item_id", itemId);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2490,16 +5504,14 @@ std::optional<InventoryItem> Database::getInventoryByItemId(int itemId)
     item.category = query.value("category").toString();
     item.unitPrice = query.value("unit_price").toDouble();
     item.locationName = query.value("location_name").toString();
+    internStrings(item);
 
     return item;
 }
 
 std::optional<InventoryItem> Database::getInventoryByItemName(const QString &itemName)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("getInventoryByItemName", R"(
         SELECT inv.*,
                i.name as item_name, i.code as item_code, i.category, i.sell_price_internal as unit_price,
                l.name as location_name
@@ -2508,9 +5520,10 @@ std::optional<InventoryItem> Database::getInventoryByItemName(const QString &ite
         LEFT JOIN locations l ON inv.location_id = l.id
         WHERE i.name = :item_name
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":item_name", itemName);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2527,17 +5540,19 @@ std::optional<InventoryItem> Database::getInventoryByItemName(const QString &ite
     item.category = query.value("category").toString();
     item.unitPrice = query.value("unit_price").toDouble();
     item.locationName = query.value("location_name").toString();
+    internStrings(item);
 
     return item;
 }
 
 QVector<InventoryItem> Database::getAllInventory()
 {
+    ProfileScope scope("Database::getAllInventory");
     QVector<InventoryItem> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT inv.*,
                i.name as item_name, i.code as item_code, i.category, i.sell_price_internal as unit_price,
                l.name as location_name
@@ -2564,6 +5579,7 @@ QVector<InventoryItem> Database::getAllInventory()
         item.category = query.value("category").toString();
         item.unitPrice = query.value("unit_price").toDouble();
         item.locationName = query.value("location_name").toString();
+        internStrings(item);
         items.append(item);
     }
 
@@ -2573,7 +5589,7 @@ QVector<InventoryItem> Database::getAllInventory()
 QVector<InventoryItem> Database::getInventoryByCategory(const QString &category)
 {
     QVector<InventoryItem> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2588,7 +5604,7 @@ QVector<InventoryItem> Database::getInventoryByCategory(const QString &category)
     )");
     query.bindValue(":category", category);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get inventory by category:" << query.lastError().text();
         return items;
     }
@@ -2607,6 +5623,7 @@ QVector<InventoryItem> Database::getInventoryByCategory(const QString &category)
         item.category = query.value("category").toString();
         item.unitPrice = query.value("unit_price").toDouble();
         item.locationName = query.value("location_name").toString();
+        internStrings(item);
         items.append(item);
     }
 
@@ -2616,7 +5633,7 @@ QVector<InventoryItem> Database::getInventoryByCategory(const QString &category)
 QVector<InventoryItem> Database::getInventoryByLocation(int locationId)
 {
     QVector<InventoryItem> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2631,7 +5648,7 @@ QVector<InventoryItem> Database::getInventoryByLocation(int locationId)
     )");
     query.bindValue(":location_id", locationId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get inventory by location:" << query.lastError().text();
         return items;
     }
@@ -2650,6 +5667,7 @@ QVector<InventoryItem> Database::getInventoryByLocation(int locationId)
         item.category = query.value("category").toString();
         item.unitPrice = query.value("unit_price").toDouble();
         item.locationName = query.value("location_name").toString();
+        internStrings(item);
         items.append(item);
     }
 
@@ -2659,10 +5677,10 @@ QVector<InventoryItem> Database::getInventoryByLocation(int locationId)
 QVector<InventoryItem> Database::getInventoryWithStock()
 {
     QVector<InventoryItem> items;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT inv.*,
                i.name as item_name, i.code as item_code, i.category, i.sell_price_internal as unit_price,
                l.name as location_name
@@ -2690,6 +5708,7 @@ QVector<InventoryItem> Database::getInventoryWithStock()
         item.category = query.value("category").toString();
         item.unitPrice = query.value("unit_price").toDouble();
         item.locationName = query.value("location_name").toString();
+        internStrings(item);
         items.append(item);
     }
 
@@ -2698,20 +5717,20 @@ QVector<InventoryItem> Database::getInventoryWithStock()
 
 bool Database::updateInventoryQuantity(int id, int newQuantity)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Inventory);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("updateInventoryQuantity", R"(
         UPDATE inventory
         SET quantity = :quantity, last_updated = :last_updated
         WHERE id = :id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":quantity", newQuantity);
     query.bindValue(":last_updated", QDateTime::currentDateTime().toString(Qt::ISODate));
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
         return false;
     }
     return query.numRowsAffected() > 0;
@@ -2719,20 +5738,20 @@ bool Database::updateInventoryQuantity(int id, int newQuantity)
 
 bool Database::adjustInventoryQuantity(int id, int delta)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    markDirty(DataTable::Inventory);
 
-    query.prepare(R"(
+    CachedQuery statement = cachedQuery("adjustInventoryQuantity", R"(
         UPDATE inventory
         SET quantity = MAX(0, quantity + :delta), last_updated = :last_updated
         WHERE id = :id
     )");
+    QSqlQuery &query = *statement;
     query.bindValue(":delta", delta);
     query.bindValue(":last_updated", QDateTime::currentDateTime().toString(Qt::ISODate));
     query.bindValue(":id", id);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
         return false;
     }
     return query.numRowsAffected() > 0;
@@ -2740,11 +5759,13 @@ bool Database::adjustInventoryQuantity(int id, int delta)
 
 bool Database::updateInventoryItem(const InventoryItem &item)
 {
+    markDirty(DataTable::Inventory);
+
     if (!item.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2759,8 +5780,8 @@ bool Database::updateInventoryItem(const InventoryItem &item)
     query.bindValue(":last_updated", QDateTime::currentDateTime().toString(Qt::ISODate));
     query.bindValue(":id", item.id.value());
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
         return false;
     }
     return query.numRowsAffected() > 0;
@@ -2768,21 +5789,107 @@ bool Database::updateInventoryItem(const InventoryItem &item)
 
 bool Database::deleteInventoryItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Inventory);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM inventory WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::clearAllInventory()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Inventory);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    return query.exec("DELETE FROM inventory");
+    return execQuery(query, "DELETE FROM inventory");
+}
+
+// =============================================================================
+// Ledger Sync Checkpoint
+// =============================================================================
+
+int Database::getInventorySyncCheckpoint()
+{
+    CachedQuery statement = cachedQuery("getInventorySyncCheckpoint",
+        "SELECT last_transaction_id FROM inventory_sync_checkpoint WHERE id = 1");
+    QSqlQuery &query = *statement;
+    if (!execQuery(query) || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toInt();
+}
+
+bool Database::setInventorySyncCheckpoint(int transactionId)
+{
+    CachedQuery statement = cachedQuery("setInventorySyncCheckpoint", R"(
+        INSERT INTO inventory_sync_checkpoint (id, last_transaction_id, synced_at)
+        VALUES (1, :id, :synced_at)
+        ON CONFLICT(id) DO UPDATE SET last_transaction_id = excluded.last_transaction_id,
+                                      synced_at = excluded.synced_at
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", transactionId);
+    query.bindValue(":synced_at", QDateTime::currentDateTime().toString(Qt::ISODate));
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to save inventory sync checkpoint:" << errorText();
+        return false;
+    }
+    return true;
+}
+
+// Range scan on the primary key, so the cost follows the rows after afterId
+QVector<Transaction> Database::getStockTransactionsAfter(int afterId)
+{
+    ProfileScope scope("Database::getStockTransactionsAfter");
+    QVector<Transaction> transactions;
+    CachedQuery statement = cachedQuery("getStockTransactionsAfter", R"(
+        SELECT id, day, date, type, account, item_name, quantity
+        FROM transactions
+        WHERE id > :id AND type IN ('Sale', 'Purchase')
+        ORDER BY id
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", afterId);
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to read ledger for inventory sync:" << errorText();
+        return transactions;
+    }
+
+    while (query.next()) {
+        Transaction transaction;
+        transaction.id = query.value(0).toInt();
+        transaction.date = dateFromStored(query.value(1), query.value(2));
+        transaction.type = stringToTransactionType(query.value(3).toString());
+        transaction.account = stringToAccountType(query.value(4).toString());
+        transaction.item = query.value(5).toString();
+        transaction.quantity = query.value(6).toInt();
+        transaction.unitPrice = 0;
+        transaction.totalAmount = 0;
+        transactions.append(transaction);
+    }
+    return transactions;
+}
+
+int Database::countStockTransactionsAfter(int afterId)
+{
+    CachedQuery statement = cachedQuery("countStockTransactionsAfter",
+        "SELECT COUNT(*) FROM transactions WHERE id > :id AND type IN ('Sale', 'Purchase')");
+    QSqlQuery &query = *statement;
+    query.bindValue(":id", afterId);
+    if (!execQuery(query) || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toInt();
 }
 
 // =============================================================================
@@ -2792,10 +5899,10 @@ bool Database::clearAllInventory()
 OilTracking Database::getOilTracking()
 {
     OilTracking tracking;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (query.exec("SELECT * FROM oil_tracking WHERE id = 1") && query.next()) {
+    if (execQuery(query, "SELECT * FROM oil_tracking WHERE id = 1") && query.next()) {
         tracking.oilCap = query.value("oil_cap").toInt();
         tracking.totalOilSold = query.value("total_oil_sold").toInt();
         tracking.lastReset = QDateTime::fromString(query.value("last_reset").toString(), Qt::ISODate);
@@ -2806,7 +5913,9 @@ OilTracking Database::getOilTracking()
 
 bool Database::saveOilTracking(const OilTracking &tracking)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Inventory);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2817,23 +5926,27 @@ bool Database::saveOilTracking(const OilTracking &tracking)
     query.bindValue(":oil_cap", tracking.oilCap);
     query.bindValue(":total_oil_sold", tracking.totalOilSold);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::addOilSold(int quantity)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Inventory);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("UPDATE oil_tracking SET total_oil_sold = total_oil_sold + :qty WHERE id = 1");
     query.bindValue(":qty", quantity);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::resetOilTracking()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Inventory);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2843,7 +5956,7 @@ bool Database::resetOilTracking()
     )");
     query.bindValue(":last_reset", QDateTime::currentDateTime().toString(Qt::ISODate));
 
-    return query.exec();
+    return execQuery(query);
 }
 
 // =============================================================================
@@ -2852,32 +5965,37 @@ bool Database::resetOilTracking()
 
 int Database::addProductionRun(const ProductionRun &run)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    invalidateForWrite(DataTable::Production);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
-        INSERT INTO production_runs (recipe_id, quantity, timestamp, deducted_inputs, added_outputs, notes)
-        VALUES (:recipe_id, :quantity, :timestamp, :deducted_inputs, :added_outputs, :notes)
+        INSERT INTO production_runs (recipe_id, quantity, timestamp, ts, deducted_inputs, added_outputs, notes)
+        VALUES (:recipe_id, :quantity, :timestamp, :ts, :deducted_inputs, :added_outputs, :notes)
     )");
     query.bindValue(":recipe_id", run.recipeId);
     query.bindValue(":quantity", run.quantity);
     query.bindValue(":timestamp", run.timestamp.toString(Qt::ISODate));
+    query.bindValue(":ts", storedSeconds(run.timestamp));
     query.bindValue(":deducted_inputs", run.deductedInputs ? 1 : 0);
     query.bindValue(":added_outputs", run.addedOutputs ? 1 : 0);
     query.bindValue(":notes", run.notes);
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "Failed to add production run:" << m_lastError;
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to add production run:" << errorText();
         return -1;
     }
 
-    return query.lastInsertId().toInt();
+    const int id = query.lastInsertId().toInt();
+    publishRowChange(DataTable::Production, RowChange::Inserted, id);
+    return id;
 }
 
 std::optional<ProductionRun> Database::getProductionRun(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -2891,7 +6009,7 @@ std::optional<ProductionRun> Database::getProductionRun(int id)
     )");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -2899,7 +6017,7 @@ std::optional<ProductionRun> Database::getProductionRun(int id)
     run.id = query.value("id").toInt();
     run.recipeId = query.value("recipe_id").toInt();
     run.quantity = query.value("quantity").toInt();
-    run.timestamp = QDateTime::fromString(query.value("timestamp").toString(), Qt::ISODate);
+    run.timestamp = dateTimeFromStored(query.value("ts"), query.value("timestamp"));
     run.deductedInputs = query.value("deducted_inputs").toBool();
     run.addedOutputs = query.value("added_outputs").toBool();
     run.notes = query.value("notes").toString();
@@ -2912,19 +6030,20 @@ std::optional<ProductionRun> Database::getProductionRun(int id)
 
 QVector<ProductionRun> Database::getAllProductionRuns()
 {
+    ProfileScope scope("Database::getAllProductionRuns");
     QVector<ProductionRun> runs;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, QString(R"(
         SELECT pr.*,
                r.output_item as recipe_name, r.output_qty,
                w.name as workbench_name
-        FROM production_runs pr
+        FROM %1 pr
         JOIN recipes r ON pr.recipe_id = r.id
         JOIN workbenches w ON r.workbench_id = w.id
         ORDER BY pr.timestamp DESC
-    )")) {
+    )").arg(archiveSource("production_runs")))) {
         qWarning() << "Failed to get production runs:" << query.lastError().text();
         return runs;
     }
@@ -2934,7 +6053,7 @@ QVector<ProductionRun> Database::getAllProductionRuns()
         run.id = query.value("id").toInt();
         run.recipeId = query.value("recipe_id").toInt();
         run.quantity = query.value("quantity").toInt();
-        run.timestamp = QDateTime::fromString(query.value("timestamp").toString(), Qt::ISODate);
+        run.timestamp = dateTimeFromStored(query.value("ts"), query.value("timestamp"));
         run.deductedInputs = query.value("deducted_inputs").toBool();
         run.addedOutputs = query.value("added_outputs").toBool();
         run.notes = query.value("notes").toString();
@@ -2947,26 +6066,89 @@ QVector<ProductionRun> Database::getAllProductionRuns()
     return runs;
 }
 
+QVector<ProductionRun> Database::getProductionHistory()
+{
+    ProfileScope scope("Database::getProductionHistory");
+    QVector<ProductionRun> runs = getAllProductionRuns();
+    priceProductionRuns(runs);
+    return runs;
+}
+
+std::optional<ProductionRun> Database::getProductionHistoryRun(int id)
+{
+    std::optional<ProductionRun> run = getProductionRun(id);
+    if (!run) {
+        return std::nullopt;
+    }
+
+    QVector<ProductionRun> runs{*run};
+    priceProductionRuns(runs);
+    return runs.first();
+}
+
+void Database::priceProductionRuns(QVector<ProductionRun> &runs)
+{
+    auto graph = recipeGraph();
+    const ItemCatalog &catalog = itemCatalog();
+
+    struct RecipeValue {
+        double inputCost = 0.0;
+        double outputValue = 0.0;
+    };
+    QHash<int, RecipeValue> byRecipe;
+
+    for (auto &run : runs) {
+        auto it = byRecipe.constFind(run.recipeId);
+        if (it == byRecipe.constEnd()) {
+            RecipeValue value;
+            if (const Recipe *recipe = graph->recipeById(run.recipeId)) {
+                for (const auto &ing : recipe->ingredients) {
+                    if (const Item *item = catalog.findByName(ing.itemName)) {
+                        value.inputCost += item->buyPriceInternal * ing.quantity;
+                    }
+                }
+                if (const Item *item = catalog.findByName(recipe->outputItem)) {
+                    value.outputValue = item->sellPriceInternal * recipe->outputQty;
+                }
+            }
+            it = byRecipe.insert(run.recipeId, value);
+        }
+        run.inputCost = it->inputCost;
+        run.outputValue = it->outputValue;
+    }
+}
+
 QVector<ProductionRun> Database::getProductionRunsByDateRange(const QDateTime &from, const QDateTime &to)
 {
+    // The join reads recipe and workbench names
+    const bool cache = m_memoizes && isOwnerThread();
+    const QString key = QString("getProductionRunsByDateRange:%1:%2")
+                            .arg(from.toString(Qt::ISODateWithMs), to.toString(Qt::ISODateWithMs));
+    const quint64 stamp = m_resultCache.stamp(DataTable::Production | DataTable::Recipes);
+    if (cache) {
+        if (auto hit = m_resultCache.find<QVector<ProductionRun>>(key, stamp)) {
+            return *hit;
+        }
+    }
+
     QVector<ProductionRun> runs;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare(R"(
+    query.prepare(QString(R"(
         SELECT pr.*,
                r.output_item as recipe_name, r.output_qty,
                w.name as workbench_name
-        FROM production_runs pr
+        FROM %1 pr
         JOIN recipes r ON pr.recipe_id = r.id
         JOIN workbenches w ON r.workbench_id = w.id
-        WHERE pr.timestamp BETWEEN :from AND :to
-        ORDER BY pr.timestamp DESC
-    )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+        WHERE pr.ts BETWEEN :from AND :to
+        ORDER BY pr.ts DESC
+    )").arg(archiveSource("production_runs", from.date(), to.date())));
+    query.bindValue(":from", storedSeconds(from));
+    query.bindValue(":to", storedSeconds(to));
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get production runs by date:" << query.lastError().text();
         return runs;
     }
@@ -2976,7 +6158,7 @@ QVector<ProductionRun> Database::getProductionRunsByDateRange(const QDateTime &f
         run.id = query.value("id").toInt();
         run.recipeId = query.value("recipe_id").toInt();
         run.quantity = query.value("quantity").toInt();
-        run.timestamp = QDateTime::fromString(query.value("timestamp").toString(), Qt::ISODate);
+        run.timestamp = dateTimeFromStored(query.value("ts"), query.value("timestamp"));
         run.deductedInputs = query.value("deducted_inputs").toBool();
         run.addedOutputs = query.value("added_outputs").toBool();
         run.notes = query.value("notes").toString();
@@ -2986,28 +6168,31 @@ QVector<ProductionRun> Database::getProductionRunsByDateRange(const QDateTime &f
         runs.append(run);
     }
 
+    if (cache) {
+        m_resultCache.insert(key, stamp, runs, runs.size());
+    }
     return runs;
 }
 
 QVector<ProductionRun> Database::getProductionRunsByRecipe(int recipeId)
 {
     QVector<ProductionRun> runs;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare(R"(
+    query.prepare(QString(R"(
         SELECT pr.*,
                r.output_item as recipe_name, r.output_qty,
                w.name as workbench_name
-        FROM production_runs pr
+        FROM %1 pr
         JOIN recipes r ON pr.recipe_id = r.id
         JOIN workbenches w ON r.workbench_id = w.id
         WHERE pr.recipe_id = :recipe_id
         ORDER BY pr.timestamp DESC
-    )");
+    )").arg(archiveSource("production_runs")));
     query.bindValue(":recipe_id", recipeId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get production runs by recipe:" << query.lastError().text();
         return runs;
     }
@@ -3017,7 +6202,7 @@ QVector<ProductionRun> Database::getProductionRunsByRecipe(int recipeId)
         run.id = query.value("id").toInt();
         run.recipeId = query.value("recipe_id").toInt();
         run.quantity = query.value("quantity").toInt();
-        run.timestamp = QDateTime::fromString(query.value("timestamp").toString(), Qt::ISODate);
+        run.timestamp = dateTimeFromStored(query.value("ts"), query.value("timestamp"));
         run.deductedInputs = query.value("deducted_inputs").toBool();
         run.addedOutputs = query.value("added_outputs").toBool();
         run.notes = query.value("notes").toString();
@@ -3032,59 +6217,75 @@ QVector<ProductionRun> Database::getProductionRunsByRecipe(int recipeId)
 
 bool Database::updateProductionRun(const ProductionRun &run)
 {
+    invalidateForWrite(DataTable::Production);
+
     if (!run.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
         UPDATE production_runs
-        SET recipe_id = :recipe_id, quantity = :quantity, timestamp = :timestamp,
+        SET recipe_id = :recipe_id, quantity = :quantity, timestamp = :timestamp, ts = :ts,
             deducted_inputs = :deducted_inputs, added_outputs = :added_outputs, notes = :notes
         WHERE id = :id
     )");
     query.bindValue(":recipe_id", run.recipeId);
     query.bindValue(":quantity", run.quantity);
     query.bindValue(":timestamp", run.timestamp.toString(Qt::ISODate));
+    query.bindValue(":ts", storedSeconds(run.timestamp));
     query.bindValue(":deducted_inputs", run.deductedInputs ? 1 : 0);
     query.bindValue(":added_outputs", run.addedOutputs ? 1 : 0);
     query.bindValue(":notes", run.notes);
     query.bindValue(":id", run.id.value());
 
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
         return false;
     }
-    return query.numRowsAffected() > 0;
+    if (query.numRowsAffected() <= 0) {
+        return false;
+    }
+    publishRowChange(DataTable::Production, RowChange::Updated, run.id.value());
+    return true;
 }
 
 bool Database::deleteProductionRun(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    invalidateForWrite(DataTable::Production);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM production_runs WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    if (!execQuery(query)) {
+        return false;
+    }
+    publishRowChange(DataTable::Production, RowChange::Deleted, id);
+    return true;
 }
 
 bool Database::clearAllProductionRuns()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Production);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    return query.exec("DELETE FROM production_runs");
+    return execQuery(query, "DELETE FROM production_runs");
 }
 
 int Database::getTotalProductionRuns()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (query.exec("SELECT COALESCE(SUM(quantity), 0) FROM production_runs") && query.next()) {
+    if (execQuery(query, "SELECT COALESCE(SUM(quantity), 0) FROM " + archiveSource("production_runs"))
+        && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -3100,72 +6301,80 @@ double Database::getTotalValueCreated()
 // Add to database.cpp - Shifts CRUD
 // =============================================================================
 
+static Shift readShift(const QSqlQuery &query)
+{
+    Shift shift;
+    shift.id = query.value("id").toInt();
+    shift.startTime = dateTimeFromStored(query.value("start_ts"), query.value("start_time"));
+    shift.endTime = dateTimeFromStored(query.value("end_ts"), query.value("end_time"));
+    shift.weather = query.value("weather").toString();
+    shift.activities = query.value("activities").toString();
+    shift.notes = query.value("notes").toString();
+    return shift;
+}
+
+// Whole minutes of a completed shift, truncated per shift like
+// Shift::durationMinutes(); NULL while the shift is ongoing
+static const char *const ShiftMinutesSql =
+    "CASE WHEN end_ts IS NOT NULL THEN (end_ts - start_ts) / 60 END";
+
 int Database::addShift(const Shift &shift)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    invalidateForWrite(DataTable::Shifts);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
-        INSERT INTO shifts (start_time, end_time, weather, activities, notes)
-        VALUES (:start_time, :end_time, :weather, :activities, :notes)
+        INSERT INTO shifts (start_time, end_time, start_ts, end_ts, weather, activities, notes)
+        VALUES (:start_time, :end_time, :start_ts, :end_ts, :weather, :activities, :notes)
     )");
     query.bindValue(":start_time", shift.startTime.toString(Qt::ISODate));
     query.bindValue(":end_time", shift.endTime.isValid() ? shift.endTime.toString(Qt::ISODate) : QVariant());
+    query.bindValue(":start_ts", storedSeconds(shift.startTime));
+    query.bindValue(":end_ts", storedSeconds(shift.endTime));
     query.bindValue(":weather", shift.weather);
     query.bindValue(":activities", shift.activities);
     query.bindValue(":notes", shift.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add shift:" << query.lastError().text();
         return -1;
     }
 
-    return query.lastInsertId().toInt();
+    const int id = query.lastInsertId().toInt();
+    publishRowChange(DataTable::Shifts, RowChange::Inserted, id);
+    return id;
 }
 
 std::optional<Shift> Database::getShift(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM shifts WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
-    Shift shift;
-    shift.id = query.value("id").toInt();
-    shift.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
-    shift.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
-    shift.weather = query.value("weather").toString();
-    shift.activities = query.value("activities").toString();
-    shift.notes = query.value("notes").toString();
-
-    return shift;
+    return readShift(query);
 }
 
 QVector<Shift> Database::getAllShifts()
 {
     QVector<Shift> shifts;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM shifts ORDER BY start_time DESC")) {
+    if (!execQuery(query, "SELECT * FROM shifts ORDER BY start_ts DESC")) {
         qWarning() << "Failed to get shifts:" << query.lastError().text();
         return shifts;
     }
 
     while (query.next()) {
-        Shift shift;
-        shift.id = query.value("id").toInt();
-        shift.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
-        shift.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
-        shift.weather = query.value("weather").toString();
-        shift.activities = query.value("activities").toString();
-        shift.notes = query.value("notes").toString();
-        shifts.append(shift);
+        shifts.append(readShift(query));
     }
 
     return shifts;
@@ -3173,32 +6382,78 @@ QVector<Shift> Database::getAllShifts()
 
 QVector<Shift> Database::getShiftsByDateRange(const QDate &from, const QDate &to)
 {
+    const bool cache = m_memoizes && isOwnerThread();
+    const QString key = QString("getShiftsByDateRange:%1:%2").arg(from.toJulianDay()).arg(to.toJulianDay());
+    const quint64 stamp = m_resultCache.stamp(DataTable::Shifts);
+    if (cache) {
+        if (auto hit = m_resultCache.find<QVector<Shift>>(key, stamp)) {
+            return *hit;
+        }
+    }
+
     QVector<Shift> shifts;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
         SELECT * FROM shifts
-        WHERE date(start_time) BETWEEN :from AND :to
-        ORDER BY start_time DESC
+        WHERE start_ts >= :from AND start_ts < :to
+        ORDER BY start_ts DESC
     )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    query.bindValue(":from", storedSeconds(QDateTime(from, QTime(0, 0))));
+    query.bindValue(":to", storedSeconds(QDateTime(to.addDays(1), QTime(0, 0))));
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get shifts by date:" << query.lastError().text();
         return shifts;
     }
 
     while (query.next()) {
-        Shift shift;
-        shift.id = query.value("id").toInt();
-        shift.startTime = QDateTime::fromString(query.value("start_time").toString(), Qt::ISODate);
-        shift.endTime = QDateTime::fromString(query.value("end_time").toString(), Qt::ISODate);
-        shift.weather = query.value("weather").toString();
-        shift.activities = query.value("activities").toString();
-        shift.notes = query.value("notes").toString();
-        shifts.append(shift);
+        shifts.append(readShift(query));
+    }
+
+    if (cache) {
+        m_resultCache.insert(key, stamp, shifts, shifts.size());
+    }
+    return shifts;
+}
+
+QVector<Shift> Database::queryShifts(const ShiftQuery &filter)
+{
+    ProfileScope scope("Database::queryShifts");
+    QVector<Shift> shifts;
+
+    QString orderBy;
+    switch (filter.orderBy) {
+    case ShiftQuery::OrderBy::StartTime:      orderBy = "start_ts"; break;
+    case ShiftQuery::OrderBy::StartTimeOfDay: orderBy = "start_ts % 86400"; break;
+    case ShiftQuery::OrderBy::EndTime:        orderBy = "end_ts"; break;
+    case ShiftQuery::OrderBy::Duration:       orderBy = ShiftMinutesSql; break;
+    case ShiftQuery::OrderBy::Weather:        orderBy = "weather"; break;
+    case ShiftQuery::OrderBy::Activities:     orderBy = "activities"; break;
+    }
+    const QString direction = filter.descending ? " DESC" : " ASC";
+
+    // id breaks ties so pages never overlap or skip rows
+    QString sql = "SELECT * FROM shifts ORDER BY " + orderBy + direction + ", id" + direction;
+    if (filter.limit >= 0) {
+        sql += " LIMIT :limit OFFSET :offset";
+    }
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    if (filter.limit >= 0) {
+        query.bindValue(":limit", filter.limit);
+        query.bindValue(":offset", qMax(0, filter.offset));
+    }
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to query shifts:" << query.lastError().text();
+        return shifts;
+    }
+
+    while (query.next()) {
+        shifts.append(readShift(query));
     }
 
     return shifts;
@@ -3206,58 +6461,75 @@ QVector<Shift> Database::getShiftsByDateRange(const QDate &from, const QDate &to
 
 bool Database::updateShift(const Shift &shift)
 {
+    invalidateForWrite(DataTable::Shifts);
+
     if (!shift.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
         UPDATE shifts
-        SET start_time = :start_time, end_time = :end_time, weather = :weather,
+        SET start_time = :start_time, end_time = :end_time,
+            start_ts = :start_ts, end_ts = :end_ts, weather = :weather,
             activities = :activities, notes = :notes
         WHERE id = :id
     )");
     query.bindValue(":start_time", shift.startTime.toString(Qt::ISODate));
     query.bindValue(":end_time", shift.endTime.isValid() ? shift.endTime.toString(Qt::ISODate) : QVariant());
+    query.bindValue(":start_ts", storedSeconds(shift.startTime));
+    query.bindValue(":end_ts", storedSeconds(shift.endTime));
     query.bindValue(":weather", shift.weather);
     query.bindValue(":activities", shift.activities);
     query.bindValue(":notes", shift.notes);
     query.bindValue(":id", shift.id.value());
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update shift:" << query.lastError().text();
         return false;
     }
-    return query.numRowsAffected() > 0;
+    if (query.numRowsAffected() <= 0) {
+        return false;
+    }
+    publishRowChange(DataTable::Shifts, RowChange::Updated, shift.id.value());
+    return true;
 }
 
 bool Database::deleteShift(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    invalidateForWrite(DataTable::Shifts);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM shifts WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    if (!execQuery(query)) {
+        return false;
+    }
+    publishRowChange(DataTable::Shifts, RowChange::Deleted, id);
+    return true;
 }
 
 bool Database::clearAllShifts()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Shifts);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    return query.exec("DELETE FROM shifts");
+    return execQuery(query, "DELETE FROM shifts");
 }
 
 int Database::getTotalShiftCount()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (query.exec("SELECT COUNT(*) FROM shifts") && query.next()) {
+    if (execQuery(query, "SELECT COUNT(*) FROM shifts") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -3265,27 +6537,104 @@ int Database::getTotalShiftCount()
 
 int Database::getTotalShiftMinutes()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Calculate total minutes from all shifts with valid end times
-    if (query.exec(R"(
-        SELECT SUM(
-            (julianday(end_time) - julianday(start_time)) * 24 * 60
-        ) FROM shifts WHERE end_time IS NOT NULL
+    if (execQuery(query, R"(
+        SELECT SUM((end_ts - start_ts) / 60.0)
+        FROM shifts WHERE end_ts IS NOT NULL
     )") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
 }
 
+static ShiftTotals readShiftTotals(const QSqlQuery &query)
+{
+    ShiftTotals totals;
+    totals.shiftCount = query.value("shift_count").toInt();
+    totals.completedCount = query.value("completed_count").toInt();
+    totals.totalMinutes = query.value("total_minutes").toInt();
+    totals.longestMinutes = query.value("longest_minutes").toInt();
+    return totals;
+}
+
+ShiftTotals Database::getShiftTotals()
+{
+    CachedQuery statement = cachedQuery("shiftTotals", QString(R"(
+        SELECT COUNT(*) AS shift_count,
+               COUNT(end_time) AS completed_count,
+               COALESCE(SUM(minutes), 0) AS total_minutes,
+               COALESCE(MAX(minutes), 0) AS longest_minutes
+        FROM (SELECT end_time, %1 AS minutes FROM shifts)
+    )").arg(ShiftMinutesSql));
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to get shift totals:" << query.lastError().text();
+        return ShiftTotals();
+    }
+    return readShiftTotals(query);
+}
+
+QVector<ShiftTotals> Database::getShiftAnalytics(ShiftPeriod period, const QDate &from, const QDate &to)
+{
+    ProfileScope scope("Database::getShiftAnalytics");
+    QVector<ShiftTotals> buckets;
+
+    QString bucket;
+    switch (period) {
+    case ShiftPeriod::Day:   bucket = "date(start_time)"; break;
+    case ShiftPeriod::Week:  bucket = "date(start_time, '-6 days', 'weekday 1')"; break;
+    case ShiftPeriod::Month: bucket = "date(start_time, 'start of month')"; break;
+    }
+
+    // [from, to] is [from 00:00, to + 1 day 00:00) in stored seconds
+    QStringList conditions;
+    if (from.isValid()) conditions << "start_ts >= :from";
+    if (to.isValid()) conditions << "start_ts < :to";
+    const QString where = conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ");
+
+    const QString sql = QString(R"(
+        SELECT %1 AS period_start,
+               COUNT(*) AS shift_count,
+               COUNT(end_time) AS completed_count,
+               COALESCE(SUM(minutes), 0) AS total_minutes,
+               COALESCE(MAX(minutes), 0) AS longest_minutes
+        FROM (SELECT start_time, end_time, %2 AS minutes FROM shifts%3)
+        GROUP BY period_start
+        ORDER BY period_start DESC
+    )").arg(bucket, ShiftMinutesSql, where);
+
+    CachedQuery statement = cachedQuery(sql, sql);
+    QSqlQuery &query = *statement;
+    if (from.isValid()) query.bindValue(":from", storedSeconds(QDateTime(from, QTime(0, 0))));
+    if (to.isValid()) query.bindValue(":to", storedSeconds(QDateTime(to.addDays(1), QTime(0, 0))));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get shift analytics:" << query.lastError().text();
+        return buckets;
+    }
+
+    while (query.next()) {
+        ShiftTotals totals = readShiftTotals(query);
+        totals.periodStart = QDate::fromString(query.value("period_start").toString(), Qt::ISODate);
+        buckets.append(totals);
+    }
+
+    return buckets;
+}
+
 // =============================================================================
 // Add to database.cpp - Cycle Profiles CRUD
 // =============================================================================
 
 int Database::addCycleProfile(const CycleProfile &profile)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CycleTimes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3298,7 +6647,7 @@ int Database::addCycleProfile(const CycleProfile &profile)
     query.bindValue(":vehicle_id", profile.vehicleId > 0 ? profile.vehicleId : QVariant());
     query.bindValue(":notes", profile.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add cycle profile:" << query.lastError().text();
         return -1;
     }
@@ -3308,7 +6657,7 @@ int Database::addCycleProfile(const CycleProfile &profile)
 
 std::optional<CycleProfile> Database::getCycleProfile(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3324,7 +6673,7 @@ std::optional<CycleProfile> Database::getCycleProfile(int id)
     )");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -3345,10 +6694,10 @@ std::optional<CycleProfile> Database::getCycleProfile(int id)
 QVector<CycleProfile> Database::getAllCycleProfiles()
 {
     QVector<CycleProfile> profiles;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT cp.*,
                sl.name as source_name,
                dl.name as dest_name,
@@ -3382,27 +6731,91 @@ QVector<CycleProfile> Database::getAllCycleProfiles()
 
 QVector<CycleProfile> Database::getCycleProfilesWithStats()
 {
+    ProfileScope scope("Database::getCycleProfilesWithStats");
     QVector<CycleProfile> profiles = getAllCycleProfiles();
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-
-    for (auto &profile : profiles) {
-        QSqlQuery statsQuery(db);
-        statsQuery.prepare(R"(
-            SELECT
-                COUNT(*) as count,
-                COALESCE(AVG(total_seconds), 0) as avg_total,
-                COALESCE(MIN(total_seconds), 0) as best_total,
-                COALESCE(MAX(total_seconds), 0) as worst_total
-            FROM cycle_records
-            WHERE profile_id = :profile_id
-        )");
-        statsQuery.bindValue(":profile_id", profile.id.value_or(0));
+    QHash<int, int> indexById;
+    for (int i = 0; i < profiles.size(); ++i) {
+        indexById.insert(profiles[i].id.value_or(0), i);
+    }
+
+    // === Aggregates, one row per profile ===
+    CachedQuery aggregatesStatement = cachedQuery("getCycleProfilesWithStats:aggregates", R"(
+        SELECT profile_id,
+               COUNT(*) as count,
+               AVG(total_seconds) as avg_total,
+               MIN(total_seconds) as best_total,
+               MAX(total_seconds) as worst_total,
+               AVG(load_seconds) as avg_load,
+               AVG(haul_seconds) as avg_haul,
+               AVG(dump_seconds) as avg_dump,
+               AVG(return_seconds) as avg_return
+        FROM cycle_records
+        GROUP BY profile_id
+    )");
+    QSqlQuery &aggregates = *aggregatesStatement;
+
+    if (!execQuery(aggregates)) {
+        qWarning() << "Failed to get cycle statistics:" << aggregates.lastError().text();
+        return profiles;
+    }
+
+    while (aggregates.next()) {
+        auto it = indexById.constFind(aggregates.value("profile_id").toInt());
+        if (it == indexById.constEnd()) {
+            continue;
+        }
+        CycleProfile &profile = profiles[it.value()];
+        profile.recordCount = aggregates.value("count").toInt();
+        profile.avgTotalSeconds = aggregates.value("avg_total").toInt();
+        profile.bestTotalSeconds = aggregates.value("best_total").toInt();
+        profile.worstTotalSeconds = aggregates.value("worst_total").toInt();
+        profile.avgLoadSeconds = aggregates.value("avg_load").toInt();
+        profile.avgHaulSeconds = aggregates.value("avg_haul").toInt();
+        profile.avgDumpSeconds = aggregates.value("avg_dump").toInt();
+        profile.avgReturnSeconds = aggregates.value("avg_return").toInt();
+    }
+
+    // === Percentiles: one pass over totals in (profile, total) order ===
+    // Counts are known from above, so each percentile is picked out at its
+    // rank as the rows stream past; idx_cycle_records_profile_total covers it
+    CachedQuery totalsStatement = cachedQuery("getCycleProfilesWithStats:totals", R"(
+        SELECT profile_id, total_seconds
+        FROM cycle_records
+        ORDER BY profile_id, total_seconds
+    )");
+    QSqlQuery &totals = *totalsStatement;
+
+    if (!execQuery(totals)) {
+        qWarning() << "Failed to get cycle percentiles:" << totals.lastError().text();
+        return profiles;
+    }
 
-        if (statsQuery.exec() && statsQuery.next()) {
-            profile.recordCount = statsQuery.value("count").toInt();
-            profile.avgTotalSeconds = statsQuery.value("avg_total").toInt();
-            profile.bestTotalSeconds = statsQuery.value("best_total").toInt();
-            profile.worstTotalSeconds = statsQuery.value("worst_total").toInt();
+    int currentId = -1;
+    int position = 0;
+    CycleProfile *profile = nullptr;
+    int p50Rank = 0;
+    int p90Rank = 0;
+    while (totals.next()) {
+        int profileId = totals.value(0).toInt();
+        if (profileId != currentId) {
+            currentId = profileId;
+            position = 0;
+            auto it = indexById.constFind(profileId);
+            profile = it != indexById.constEnd() ? &profiles[it.value()] : nullptr;
+            if (profile) {
+                p50Rank = CycleStats::percentileRank(0.5, profile->recordCount);
+                p90Rank = CycleStats::percentileRank(0.9, profile->recordCount);
+            }
+        }
+        ++position;
+        if (!profile) {
+            continue;
+        }
+        if (position == p50Rank) {
+            profile->p50TotalSeconds = totals.value(1).toInt();
+        }
+        if (position == p90Rank) {
+            profile->p90TotalSeconds = totals.value(1).toInt();
         }
     }
 
@@ -3411,11 +6824,13 @@ QVector<CycleProfile> Database::getCycleProfilesWithStats()
 
 bool Database::updateCycleProfile(const CycleProfile &profile)
 {
+    markDirty(DataTable::CycleTimes);
+
     if (!profile.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3431,7 +6846,7 @@ bool Database::updateCycleProfile(const CycleProfile &profile)
     query.bindValue(":notes", profile.notes);
     query.bindValue(":id", profile.id.value());
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update cycle profile:" << query.lastError().text();
         return false;
     }
@@ -3440,18 +6855,20 @@ bool Database::updateCycleProfile(const CycleProfile &profile)
 
 bool Database::deleteCycleProfile(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CycleTimes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     // Delete records first (if ON DELETE CASCADE doesn't work)
     query.prepare("DELETE FROM cycle_records WHERE profile_id = :id");
     query.bindValue(":id", id);
-    query.exec();
+    execQuery(query);
 
     query.prepare("DELETE FROM cycle_profiles WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 // =============================================================================
@@ -3460,7 +6877,9 @@ bool Database::deleteCycleProfile(int id)
 
 int Database::addCycleRecord(const CycleRecord &record)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    invalidateForWrite(DataTable::CycleTimes);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     int total = record.loadSeconds + record.haulSeconds + record.dumpSeconds + record.returnSeconds;
@@ -3480,17 +6899,19 @@ int Database::addCycleRecord(const CycleRecord &record)
     query.bindValue(":timestamp", record.timestamp.toString(Qt::ISODate));
     query.bindValue(":notes", record.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add cycle record:" << query.lastError().text();
         return -1;
     }
 
-    return query.lastInsertId().toInt();
+    const int id = query.lastInsertId().toInt();
+    publishRowChange(DataTable::CycleTimes, RowChange::Inserted, id);
+    return id;
 }
 
 std::optional<CycleRecord> Database::getCycleRecord(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3501,7 +6922,7 @@ std::optional<CycleRecord> Database::getCycleRecord(int id)
     )");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -3523,10 +6944,10 @@ std::optional<CycleRecord> Database::getCycleRecord(int id)
 QVector<CycleRecord> Database::getAllCycleRecords()
 {
     QVector<CycleRecord> records;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec(R"(
+    if (!execQuery(query, R"(
         SELECT cr.*, cp.name as profile_name
         FROM cycle_records cr
         JOIN cycle_profiles cp ON cr.profile_id = cp.id
@@ -3557,7 +6978,7 @@ QVector<CycleRecord> Database::getAllCycleRecords()
 QVector<CycleRecord> Database::getCycleRecordsByProfile(int profileId)
 {
     QVector<CycleRecord> records;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3569,7 +6990,7 @@ QVector<CycleRecord> Database::getCycleRecordsByProfile(int profileId)
     )");
     query.bindValue(":profile_id", profileId);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get cycle records by profile:" << query.lastError().text();
         return records;
     }
@@ -3594,11 +7015,13 @@ QVector<CycleRecord> Database::getCycleRecordsByProfile(int profileId)
 
 bool Database::updateCycleRecord(const CycleRecord &record)
 {
+    invalidateForWrite(DataTable::CycleTimes);
+
     if (!record.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     int total = record.loadSeconds + record.haulSeconds + record.dumpSeconds + record.returnSeconds;
@@ -3620,227 +7043,718 @@ bool Database::updateCycleRecord(const CycleRecord &record)
     query.bindValue(":notes", record.notes);
     query.bindValue(":id", record.id.value());
 
-    if (!query.exec()) {
-        qWarning() << "Failed to update cycle record:" << query.lastError().text();
+    if (!execQuery(query)) {
+        qWarning() << "Failed to update cycle record:" << query.lastError().text();
+        return false;
+    }
+    if (query.numRowsAffected() <= 0) {
+        return false;
+    }
+    publishRowChange(DataTable::CycleTimes, RowChange::Updated, record.id.value());
+    return true;
+}
+
+bool Database::deleteCycleRecord(int id)
+{
+    invalidateForWrite(DataTable::CycleTimes);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    query.prepare("DELETE FROM cycle_records WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!execQuery(query)) {
+        return false;
+    }
+    publishRowChange(DataTable::CycleTimes, RowChange::Deleted, id);
+    return true;
+}
+
+bool Database::clearCycleRecordsByProfile(int profileId)
+{
+    markDirty(DataTable::CycleTimes);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    query.prepare("DELETE FROM cycle_records WHERE profile_id = :profile_id");
+    query.bindValue(":profile_id", profileId);
+
+    return execQuery(query);
+}
+
+// =============================================================================
+// Budgets Table
+// =============================================================================
+
+bool Database::createBudgetsTable()
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    if (!execQuery(query, R"(
+        CREATE TABLE IF NOT EXISTS budgets (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            category TEXT NOT NULL,
+            monthly_amount REAL DEFAULT 0,
+            year INTEGER NOT NULL,
+            month INTEGER NOT NULL,
+            notes TEXT,
+            UNIQUE(category, year, month)
+        )
+    )")) {
+        qWarning() << "Failed to create budgets table:" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+// =============================================================================
+// Add to database.cpp - Finance Calculations
+// =============================================================================
+
+// Both balance queries read the snapshot tables kept current by the
+// trg_transactions_balance_* triggers (schema migration 2) instead of
+// summing the whole ledger.
+AccountBalance Database::calculateBalances()
+{
+    ProfileScope scope("Database::calculateBalances");
+    AccountBalance balance;
+    CachedQuery statement = cachedQuery("calculateBalances",
+                                        "SELECT account, balance FROM account_balances");
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to read account balances:" << query.lastError().text();
+        return balance;
+    }
+
+    while (query.next()) {
+        QString account = query.value(0).toString();
+        if (account == "Company") {
+            balance.companyBalance = query.value(1).toDouble();
+        } else if (account == "Personal") {
+            balance.personalBalance = query.value(1).toDouble();
+        }
+    }
+
+    return balance;
+}
+
+AccountBalance Database::calculateBalancesAsOf(const QDate &date)
+{
+    AccountBalance balance;
+    // Naming the accounts lets each be a range on the (account, date) key;
+    // date alone cannot use it, account being the leading column
+    CachedQuery statement = cachedQuery("calculateBalancesAsOf", R"(
+        SELECT account, COALESCE(SUM(delta), 0)
+        FROM account_daily_balances
+        WHERE account IN (:company, :personal) AND date <= :date
+        GROUP BY account
+    )");
+    QSqlQuery &query = *statement;
+    query.bindValue(":company", accountTypeToString(AccountType::Company));
+    query.bindValue(":personal", accountTypeToString(AccountType::Personal));
+    query.bindValue(":date", date.toString(Qt::ISODate));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to read account balances:" << query.lastError().text();
+        return balance;
+    }
+
+    while (query.next()) {
+        QString account = query.value(0).toString();
+        if (account == "Company") {
+            balance.companyBalance = query.value(1).toDouble();
+        } else if (account == "Personal") {
+            balance.personalBalance = query.value(1).toDouble();
+        }
+    }
+
+    return balance;
+}
+
+// Adds one (category, income, expenses) row of a grouped summary scan.
+// A NULL sum means the category had no rows of that kind in the range.
+static void addSummaryRow(FinanceSummary &summary, const QSqlQuery &query)
+{
+    QString cat = query.value("category").toString();
+    if (cat.isEmpty()) cat = "Uncategorized";
+
+    if (!query.isNull("income")) {
+        double income = query.value("income").toDouble();
+        summary.incomeByCategory[cat] += income;
+        summary.totalIncome += income;
+    }
+    if (!query.isNull("expenses")) {
+        double expenses = query.value("expenses").toDouble();
+        summary.expensesByCategory[cat] += expenses;
+        summary.totalExpenses += expenses;
+    }
+}
+
+FinanceSummary Database::getFinanceSummary(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("Database::getFinanceSummary");
+    FinanceSummary summary;
+
+    // One grouped scan yields both totals and both category breakdowns
+    const QString source = archiveSource("transactions", from, to);
+    CachedQuery statement = cachedQuery("getFinanceSummary:" + source, QString(R"(
+        SELECT category,
+               SUM(CASE WHEN type IN ('Sale', 'Opening') THEN total_amount END) as income,
+               SUM(CASE WHEN type IN ('Purchase', 'Fuel') THEN total_amount END) as expenses
+        FROM %1
+        WHERE type IN ('Sale', 'Opening', 'Purchase', 'Fuel')
+          AND day BETWEEN :from AND :to
+        GROUP BY category
+    )").arg(source));
+    QSqlQuery &query = *statement;
+    query.bindValue(":from", storedDay(from));
+    query.bindValue(":to", storedDay(to));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get finance summary:" << query.lastError().text();
+        return summary;
+    }
+
+    while (query.next()) {
+        addSummaryRow(summary, query);
+    }
+
+    summary.netProfit = summary.totalIncome - summary.totalExpenses;
+    return summary;
+}
+
+QMap<QDate, FinanceSummary> Database::getFinanceSummariesByMonth(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("Database::getFinanceSummariesByMonth");
+    QMap<QDate, FinanceSummary> summaries;
+
+    // Every month in the range gets an entry, even if it had no activity
+    for (QDate month(from.year(), from.month(), 1); month <= to; month = month.addMonths(1)) {
+        summaries.insert(month, FinanceSummary());
+    }
+
+    const QString source = archiveSource("transactions", from, to);
+    CachedQuery statement = cachedQuery("getFinanceSummariesByMonth:" + source, QString(R"(
+        SELECT strftime('%Y-%m', day) as month, category,
+               SUM(CASE WHEN type IN ('Sale', 'Opening') THEN total_amount END) as income,
+               SUM(CASE WHEN type IN ('Purchase', 'Fuel') THEN total_amount END) as expenses
+        FROM %1
+        WHERE type IN ('Sale', 'Opening', 'Purchase', 'Fuel')
+          AND day BETWEEN :from AND :to
+        GROUP BY month, category
+    )").arg(source));
+    QSqlQuery &query = *statement;
+    query.bindValue(":from", storedDay(from));
+    query.bindValue(":to", storedDay(to));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get monthly finance summaries:" << query.lastError().text();
+        return summaries;
+    }
+
+    while (query.next()) {
+        QDate month = QDate::fromString(query.value("month").toString() + "-01", Qt::ISODate);
+        if (month.isValid()) {
+            addSummaryRow(summaries[month], query);
+        }
+    }
+
+    for (auto &summary : summaries) {
+        summary.netProfit = summary.totalIncome - summary.totalExpenses;
+    }
+
+    return summaries;
+}
+
+// =============================================================================
+// Year Archives
+// =============================================================================
+
+QString Database::archiveSchema(int year)
+{
+    return QString("archive_%1").arg(year);
+}
+
+QString Database::archivePath(int year) const
+{
+    const QFileInfo info(databasePath());
+    if (info.fileName().isEmpty()) {
+        return QString();
+    }
+    return info.dir().filePath(QString("%1.%2.db").arg(info.completeBaseName()).arg(year));
+}
+
+QVector<int> Database::archivedYearList()
+{
+    const bool owner = isOwnerThread();
+    if (owner && m_archiveYears) {
+        return *m_archiveYears;
+    }
+
+    QVector<int> years;
+    CachedQuery statement = cachedQuery("archivedYearList", "SELECT year FROM archived_years ORDER BY year");
+    QSqlQuery &query = *statement;
+    if (execQuery(query)) {
+        while (query.next()) {
+            years.append(query.value(0).toInt());
+        }
+        // A statement left open would keep the ATTACH that may follow from running
+        query.finish();
+    }
+
+    if (owner) {
+        m_archiveYears = years;
+    }
+    return years;
+}
+
+QVector<ArchivedYear> Database::archivedYears()
+{
+    QVector<ArchivedYear> years;
+    CachedQuery statement = cachedQuery("archivedYears", "SELECT * FROM archived_years ORDER BY year");
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to read archived years:" << query.lastError().text();
+        return years;
+    }
+
+    while (query.next()) {
+        ArchivedYear year;
+        year.year = query.value("year").toInt();
+        year.transactions = query.value("transactions").toInt();
+        year.fuelEntries = query.value("fuel_entries").toInt();
+        year.productionRuns = query.value("production_runs").toInt();
+        year.carriedForward.companyBalance = query.value("company_balance").toDouble();
+        year.carriedForward.personalBalance = query.value("personal_balance").toDouble();
+        year.archivedAt = QDateTime::fromString(query.value("archived_at").toString(), Qt::ISODate);
+        years.append(year);
+    }
+
+    return years;
+}
+
+bool Database::attachArchive(int year)
+{
+    QSet<int> &attached = attachedArchives();
+    if (attached.contains(year)) {
+        return true;
+    }
+
+    const QString path = archivePath(year);
+    if (transactionDepth() > 0) {
+        qWarning() << "Archive" << year << "cannot be attached inside a transaction; reading live rows only";
+        return false;
+    }
+    // ATTACH would create an empty file in its place
+    if (!QFileInfo::exists(path)) {
+        qWarning() << "Archive" << path << "is missing; reading live rows only";
+        return false;
+    }
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare(QString("ATTACH DATABASE :path AS %1").arg(archiveSchema(year)));
+    query.bindValue(":path", path);
+    if (!execQuery(query)) {
+        qWarning() << "Failed to attach archive" << path << ":" << query.lastError().text();
         return false;
     }
-    return query.numRowsAffected() > 0;
+    if (!upgradeArchive(archiveSchema(year))) {
+        execQuery(query, QString("DETACH DATABASE %1").arg(archiveSchema(year)));
+        return false;
+    }
+
+    attached.insert(year);
+    return true;
 }
 
-bool Database::deleteCycleRecord(int id)
+bool Database::upgradeArchive(const QString &schema)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    query.prepare("DELETE FROM cycle_records WHERE id = :id");
-    query.bindValue(":id", id);
+    QVector<const StoredDateColumn *> missing;
+    for (const StoredDateColumn &column : StoredDateColumns) {
+        if (!column.archived) {
+            continue;
+        }
+        if (!execQuery(query, QString("PRAGMA %1.table_info(%2)").arg(schema, column.table))) {
+            qWarning() << "Failed to read archive" << schema << ":" << query.lastError().text();
+            return false;
+        }
+        bool found = false;
+        while (query.next()) {
+            found = found || query.value("name").toString() == column.column;
+        }
+        if (!found) {
+            missing.append(&column);
+        }
+    }
+    if (missing.isEmpty()) {
+        return true;
+    }
 
-    return query.exec();
+    // All or nothing, so a half-upgraded file never lines up with main
+    // column for column while its integers are still empty
+    if (!db.transaction()) {
+        qWarning() << "Failed to upgrade archive" << schema << ":" << db.lastError().text();
+        return false;
+    }
+    for (const StoredDateColumn *column : missing) {
+        const QStringList statements = {
+            QString("ALTER TABLE %1.%2 ADD COLUMN %3 INTEGER").arg(schema, column->table, column->column),
+            QString("UPDATE %1.%2 SET %3 = %4").arg(schema, column->table, column->column, column->expression),
+            QString("CREATE INDEX IF NOT EXISTS %1.idx_%2_%3 ON %2(%3)").arg(schema, column->table, column->column),
+        };
+        for (const QString &sql : statements) {
+            if (!execQuery(query, sql)) {
+                qWarning() << "Failed to upgrade archive" << schema << ":" << query.lastError().text();
+                db.rollback();
+                return false;
+            }
+        }
+    }
+    if (!db.commit()) {
+        qWarning() << "Failed to upgrade archive" << schema << ":" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    qInfo() << "Added integer date columns to archive" << schema;
+    return true;
 }
 
-bool Database::clearCycleRecordsByProfile(int profileId)
+QString Database::archiveSource(const QString &table, const QDate &from, const QDate &to)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    const QVector<int> years = archivedYearList();
+    if (years.isEmpty()) {
+        return table;
+    }
 
-    query.prepare("DELETE FROM cycle_records WHERE profile_id = :profile_id");
-    query.bindValue(":profile_id", profileId);
+    QStringList parts;
+    for (int year : years) {
+        if ((from.isValid() && year < from.year()) || (to.isValid() && year > to.year())) {
+            continue;
+        }
+        if (attachArchive(year)) {
+            parts << QString("SELECT * FROM %1.%2").arg(archiveSchema(year), table);
+        }
+    }
+    if (parts.isEmpty()) {
+        return table;
+    }
 
-    return query.exec();
+    parts.prepend("SELECT * FROM main." + table);
+    return "(" + parts.join(" UNION ALL ") + ")";
 }
 
-// =============================================================================
-// Budgets Table
-// =============================================================================
-
-bool Database::createBudgetsTable()
+bool Database::archiveYear(int year)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    ProfileScope scope("Database::archiveYear");
 
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS budgets (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            category TEXT NOT NULL,
-            monthly_amount REAL DEFAULT 0,
-            year INTEGER NOT NULL,
-            month INTEGER NOT NULL,
-            notes TEXT,
-            UNIQUE(category, year, month)
-        )
-    )")) {
-        qWarning() << "Failed to create budgets table:" << query.lastError().text();
+    if (!isOwnerThread()) {
+        errorText() = "Years are archived on the database's own thread";
+        qWarning() << errorText();
+        return false;
+    }
+    if (year >= QDate::currentDate().year()) {
+        m_lastError = QString("%1 is not a closed year").arg(year);
+        qWarning() << "Failed to archive year:" << m_lastError;
+        return false;
+    }
+    if (archivedYearList().contains(year)) {
+        m_lastError = QString("%1 is already archived").arg(year);
+        qWarning() << "Failed to archive year:" << m_lastError;
         return false;
     }
 
-    return true;
-}
-
-// =============================================================================
-// Add to database.cpp - Finance Calculations
-// =============================================================================
-
-AccountBalance Database::calculateBalances()
-{
-    AccountBalance balance;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    // Calculate Company balance
-    if (query.exec(R"(
-        SELECT COALESCE(SUM(
-            CASE
-                WHEN type IN ('Sale', 'Opening') THEN total_amount
-                WHEN type IN ('Purchase', 'Fuel') THEN -total_amount
-                WHEN type = 'Transfer' THEN
-                    CASE WHEN total_amount > 0 THEN total_amount ELSE total_amount END
-                ELSE 0
-            END
-        ), 0) as balance
-        FROM transactions
-        WHERE account = 'Company'
-    )") && query.next()) {
-        balance.companyBalance = query.value("balance").toDouble();
-    }
-
-    // Calculate Personal balance
-    if (query.exec(R"(
-        SELECT COALESCE(SUM(
-            CASE
-                WHEN type IN ('Sale', 'Opening') THEN total_amount
-                WHEN type IN ('Purchase', 'Fuel') THEN -total_amount
-                WHEN type = 'Transfer' THEN
-                    CASE WHEN total_amount > 0 THEN total_amount ELSE total_amount END
-                ELSE 0
-            END
-        ), 0) as balance
-        FROM transactions
-        WHERE account = 'Personal'
-    )") && query.next()) {
-        balance.personalBalance = query.value("balance").toDouble();
+    // Queued edits may be to rows of the year, and ATTACH cannot run
+    // inside a transaction
+    if (!flushPendingWrites()) {
+        return false;
+    }
+    if (inTransaction()) {
+        m_lastError = "A year cannot be archived inside a transaction";
+        qWarning() << "Failed to archive year:" << m_lastError;
+        return false;
     }
 
-    return balance;
-}
+    const QString path = archivePath(year);
+    if (path.isEmpty() || QFileInfo::exists(path)) {
+        m_lastError = path.isEmpty() ? QString("Database is not open")
+                                     : QString("%1 already exists").arg(path);
+        qWarning() << "Failed to archive year:" << m_lastError;
+        return false;
+    }
 
-AccountBalance Database::calculateBalancesAsOf(const QDate &date)
-{
-    AccountBalance balance;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    const QString schema = archiveSchema(year);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
+    query.prepare(QString("ATTACH DATABASE :path AS %1").arg(schema));
+    query.bindValue(":path", path);
+    if (!execQuery(query)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "Failed to create archive" << path << ":" << m_lastError;
+        return false;
+    }
 
-    query.prepare(R"(
-        SELECT COALESCE(SUM(
-            CASE
-                WHEN type IN ('Sale', 'Opening') THEN total_amount
-                WHEN type IN ('Purchase', 'Fuel') THEN -total_amount
-                WHEN type = 'Transfer' THEN total_amount
-                ELSE 0
-            END
-        ), 0) as balance
-        FROM transactions
-        WHERE account = 'Company' AND date <= :date
-    )");
-    query.bindValue(":date", date.toString(Qt::ISODate));
+    auto abandon = [&](const QString &error) {
+        m_lastError = error;
+        qWarning() << "Failed to archive year" << year << ":" << error;
+        rollbackTransaction();
+        QSqlQuery detach(db);
+        execQuery(detach, QString("DETACH DATABASE %1").arg(schema));
+        QFile::remove(path);
+        return false;
+    };
 
-    if (query.exec() && query.next()) {
-        balance.companyBalance = query.value("balance").toDouble();
+    if (!beginTransaction()) {
+        m_lastError = errorText();
+        QSqlQuery detach(db);
+        execQuery(detach, QString("DETACH DATABASE %1").arg(schema));
+        QFile::remove(path);
+        return false;
     }
 
-    query.prepare(R"(
-        SELECT COALESCE(SUM(
-            CASE
-                WHEN type IN ('Sale', 'Opening') THEN total_amount
-                WHEN type IN ('Purchase', 'Fuel') THEN -total_amount
-                WHEN type = 'Transfer' THEN total_amount
-                ELSE 0
-            END
-        ), 0) as balance
-        FROM transactions
-        WHERE account = 'Personal' AND date <= :date
-    )");
-    query.bindValue(":date", date.toString(Qt::ISODate));
+    // Dates (and the date part of date-times) are ISO text, so the year is
+    // [from, next) as a string range
+    const QString from = QDate(year, 1, 1).toString(Qt::ISODate);
+    const QString next = QDate(year + 1, 1, 1).toString(Qt::ISODate);
+
+    struct Moved {
+        const char *table;
+        const char *column;
+    };
+    static const Moved moved[] = {
+        {"transactions", "date"},
+        {"fuel_log", "date_time"},
+        {"production_runs", "timestamp"},
+        {"account_daily_balances", "date"},
+        {"fuel_daily_rollup", "date"},
+    };
+
+    // Copy the year, rollups included: the deletes below run the rollup
+    // triggers, and the rollup rows are put back from the copies
+    for (const Moved &m : moved) {
+        if (!execQuery(query, QString("CREATE TABLE %1.%2 AS SELECT * FROM main.%2 WHERE 0")
+                                  .arg(schema, m.table))) {
+            return abandon(query.lastError().text());
+        }
+        query.prepare(QString("INSERT INTO %1.%2 SELECT * FROM main.%2 WHERE %3 >= :from AND %3 < :next")
+                          .arg(schema, m.table, m.column));
+        query.bindValue(":from", from);
+        query.bindValue(":next", next);
+        if (!execQuery(query)) {
+            return abandon(query.lastError().text());
+        }
+    }
 
-    if (query.exec() && query.next()) {
-        balance.personalBalance = query.value("balance").toDouble();
+    const QStringList archiveIndexes = {
+        QString("CREATE INDEX %1.idx_transactions_date ON transactions(date, id)").arg(schema),
+        QString("CREATE INDEX %1.idx_fuel_log_date_time ON fuel_log(date_time, equipment_id)").arg(schema),
+        QString("CREATE INDEX %1.idx_production_runs_timestamp ON production_runs(timestamp)").arg(schema),
+        QString("CREATE INDEX %1.idx_transactions_day ON transactions(day, id)").arg(schema),
+        QString("CREATE INDEX %1.idx_transactions_type_day ON transactions(type, day, category, total_amount)").arg(schema),
+        QString("CREATE INDEX %1.idx_fuel_log_ts ON fuel_log(ts, equipment_id)").arg(schema),
+        QString("CREATE INDEX %1.idx_production_runs_ts ON production_runs(ts)").arg(schema),
+    };
+    for (const QString &sql : archiveIndexes) {
+        if (!execQuery(query, sql)) {
+            return abandon(query.lastError().text());
+        }
     }
 
-    return balance;
-}
+    // Current balances are unchanged by moving rows out; read them before
+    // the delete triggers subtract the year
+    QHash<QString, double> balances;
+    if (!execQuery(query, "SELECT account, balance FROM main.account_balances")) {
+        return abandon(query.lastError().text());
+    }
+    while (query.next()) {
+        balances.insert(query.value(0).toString(), query.value(1).toDouble());
+    }
 
-FinanceSummary Database::getFinanceSummary(const QDate &from, const QDate &to)
-{
-    FinanceSummary summary;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
+    int counts[3] = {0, 0, 0};
+    for (int i = 0; i < 3; ++i) {
+        query.prepare(QString("DELETE FROM main.%1 WHERE %2 >= :from AND %2 < :next")
+                          .arg(moved[i].table, moved[i].column));
+        query.bindValue(":from", from);
+        query.bindValue(":next", next);
+        if (!execQuery(query)) {
+            return abandon(query.lastError().text());
+        }
+        counts[i] = query.numRowsAffected();
+    }
+
+    const QStringList restore = {
+        QString("INSERT OR REPLACE INTO main.account_daily_balances SELECT * FROM %1.account_daily_balances")
+            .arg(schema),
+        QString("INSERT OR REPLACE INTO main.fuel_daily_rollup SELECT * FROM %1.fuel_daily_rollup").arg(schema),
+    };
+    for (const QString &sql : restore) {
+        if (!execQuery(query, sql)) {
+            return abandon(query.lastError().text());
+        }
+    }
+    for (auto it = balances.constBegin(); it != balances.constEnd(); ++it) {
+        query.prepare("UPDATE main.account_balances SET balance = :balance WHERE account = :account");
+        query.bindValue(":balance", it.value());
+        query.bindValue(":account", it.key());
+        if (!execQuery(query)) {
+            return abandon(query.lastError().text());
+        }
+    }
 
-    // Total Income (Sales + Opening)
+    const AccountBalance carried = calculateBalancesAsOf(QDate(year, 12, 31));
     query.prepare(R"(
-        SELECT COALESCE(SUM(total_amount), 0) as total
-        FROM transactions
-        WHERE type IN ('Sale', 'Opening') AND date BETWEEN :from AND :to
+        INSERT INTO archived_years (year, transactions, fuel_entries, production_runs,
+                                    company_balance, personal_balance, archived_at)
+        VALUES (:year, :transactions, :fuel_entries, :production_runs,
+                :company_balance, :personal_balance, :archived_at)
     )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    query.bindValue(":year", year);
+    query.bindValue(":transactions", counts[0]);
+    query.bindValue(":fuel_entries", counts[1]);
+    query.bindValue(":production_runs", counts[2]);
+    query.bindValue(":company_balance", carried.companyBalance);
+    query.bindValue(":personal_balance", carried.personalBalance);
+    query.bindValue(":archived_at", QDateTime::currentDateTime().toString(Qt::ISODate));
+    if (!execQuery(query)) {
+        return abandon(query.lastError().text());
+    }
 
-    if (query.exec() && query.next()) {
-        summary.totalIncome = query.value("total").toDouble();
+    if (!commitTransaction()) {
+        return abandon(errorText());
     }
 
-    // Total Expenses (Purchases + Fuel)
-    query.prepare(R"(
-        SELECT COALESCE(SUM(total_amount), 0) as total
-        FROM transactions
-        WHERE type IN ('Purchase', 'Fuel') AND date BETWEEN :from AND :to
-    )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    m_attachedArchives.insert(year);
+    m_archiveYears.reset();
+    // Its commands name rows that are no longer in the live tables
+    if (m_journal) {
+        m_journal->clear();
+    }
+    markDirty(DataTable::Transactions | DataTable::FuelLog | DataTable::Production);
+
+    qDebug() << "Archived" << year << "to" << path << ":" << counts[0] << "transactions,"
+             << counts[1] << "fuel entries," << counts[2] << "production runs";
+    return true;
+}
 
-    if (query.exec() && query.next()) {
-        summary.totalExpenses = query.value("total").toDouble();
+// =============================================================================
+// Streaming Reads
+// =============================================================================
+
+// Table and date column of the logged tables streamRows() reads; false
+// for anything else, so callers never put their own text into the SQL
+static bool streamedTable(DataTable table, QString *name, QString *dateColumn)
+{
+    switch (table) {
+    case DataTable::Transactions: *name = "transactions";    *dateColumn = "date";       return true;
+    case DataTable::FuelLog:      *name = "fuel_log";        *dateColumn = "date_time";  return true;
+    case DataTable::Production:   *name = "production_runs"; *dateColumn = "timestamp";  return true;
+    case DataTable::Shifts:       *name = "shifts";          *dateColumn = "start_time"; return true;
+    case DataTable::CycleTimes:   *name = "cycle_records";   *dateColumn = "timestamp";  return true;
+    default:
+        return false;
     }
+}
 
-    summary.netProfit = summary.totalIncome - summary.totalExpenses;
+// Dates and date-times are ISO text, so [from, to] is [from, to + 1 day)
+// as a string range
+static QString rangeClause(const QString &dateColumn, const QDate &from, const QDate &to)
+{
+    QStringList conditions;
+    if (from.isValid()) conditions << dateColumn + " >= :from";
+    if (to.isValid()) conditions << dateColumn + " < :next";
+    return conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ");
+}
 
-    // Income by category
-    query.prepare(R"(
-        SELECT category, COALESCE(SUM(total_amount), 0) as total
-        FROM transactions
-        WHERE type IN ('Sale', 'Opening') AND date BETWEEN :from AND :to
-        GROUP BY category
-        ORDER BY total DESC
-    )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+static void bindRange(QSqlQuery &query, const QDate &from, const QDate &to)
+{
+    if (from.isValid()) query.bindValue(":from", from.toString(Qt::ISODate));
+    if (to.isValid()) query.bindValue(":next", to.addDays(1).toString(Qt::ISODate));
+}
+
+bool Database::streamRows(DataTable table, const QDate &from, const QDate &to,
+                          const std::function<bool(const QSqlRecord &)> &row)
+{
+    ProfileScope scope("Database::streamRows");
+    QString name;
+    QString dateColumn;
+    if (!streamedTable(table, &name, &dateColumn)) {
+        errorText() = "Table cannot be streamed";
+        return false;
+    }
 
-    if (query.exec()) {
+    // Archives hold only transactions, fuel log and production runs
+    const QString source = (table == DataTable::Shifts || table == DataTable::CycleTimes)
+                               ? name : archiveSource(name, from, to);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    // Rows are read once, front to back; the driver need not keep them
+    query.setForwardOnly(true);
+    // The integer date twins are a storage detail; exports keep the
+    // columns they had before them
+    QStringList columns;
+    if (execQuery(query, QString("PRAGMA main.table_info(%1)").arg(name))) {
         while (query.next()) {
-            QString cat = query.value("category").toString();
-            if (cat.isEmpty()) cat = "Uncategorized";
-            summary.incomeByCategory[cat] = query.value("total").toDouble();
+            const QString column = query.value("name").toString();
+            if (!isStoredDateColumn(name, column)) {
+                columns.append(column);
+            }
         }
     }
+    const QString selected = columns.isEmpty() ? QString("*") : columns.join(", ");
 
-    // Expenses by category
-    query.prepare(R"(
-        SELECT category, COALESCE(SUM(total_amount), 0) as total
-        FROM transactions
-        WHERE type IN ('Purchase', 'Fuel') AND date BETWEEN :from AND :to
-        GROUP BY category
-        ORDER BY total DESC
-    )");
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
+    query.prepare("SELECT " + selected + " FROM " + source + rangeClause(dateColumn, from, to)
+                  + " ORDER BY " + dateColumn + ", id");
+    bindRange(query, from, to);
 
-    if (query.exec()) {
-        while (query.next()) {
-            QString cat = query.value("category").toString();
-            if (cat.isEmpty()) cat = "Uncategorized";
-            summary.expensesByCategory[cat] = query.value("total").toDouble();
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to stream" << name << ":" << errorText();
+        return false;
+    }
+
+    while (query.next()) {
+        if (!row(query.record())) {
+            break;
         }
     }
+    if (query.lastError().isValid()) {
+        errorText() = query.lastError().text();
+        return false;
+    }
+    return true;
+}
 
-    return summary;
+qint64 Database::countRowsInRange(DataTable table, const QDate &from, const QDate &to)
+{
+    QString name;
+    QString dateColumn;
+    if (!streamedTable(table, &name, &dateColumn)) {
+        return 0;
+    }
+
+    const QString source = (table == DataTable::Shifts || table == DataTable::CycleTimes)
+                               ? name : archiveSource(name, from, to);
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM " + source + rangeClause(dateColumn, from, to));
+    bindRange(query, from, to);
+
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to count" << name << ":" << query.lastError().text();
+        return 0;
+    }
+    return query.value(0).toLongLong();
 }
 
 // =============================================================================
@@ -3849,7 +7763,9 @@ FinanceSummary Database::getFinanceSummary(const QDate &from, const QDate &to)
 
 int Database::addBudget(const Budget &budget)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Budgets);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3862,7 +7778,7 @@ int Database::addBudget(const Budget &budget)
     query.bindValue(":month", budget.month);
     query.bindValue(":notes", budget.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add budget:" << query.lastError().text();
         return -1;
     }
@@ -3870,15 +7786,46 @@ int Database::addBudget(const Budget &budget)
     return query.lastInsertId().toInt();
 }
 
+bool Database::restoreBudget(const Budget &budget)
+{
+    markDirty(DataTable::Budgets);
+
+    if (!budget.id.has_value()) {
+        qWarning() << "Cannot restore budget without id";
+        return false;
+    }
+
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+
+    query.prepare(R"(
+        INSERT INTO budgets (id, category, monthly_amount, year, month, notes)
+        VALUES (:id, :category, :monthly_amount, :year, :month, :notes)
+    )");
+    query.bindValue(":id", budget.id.value());
+    query.bindValue(":category", budget.category);
+    query.bindValue(":monthly_amount", budget.monthlyAmount);
+    query.bindValue(":year", budget.year);
+    query.bindValue(":month", budget.month);
+    query.bindValue(":notes", budget.notes);
+
+    if (!execQuery(query)) {
+        errorText() = query.lastError().text();
+        qWarning() << "Failed to restore budget:" << errorText();
+        return false;
+    }
+    return true;
+}
+
 std::optional<Budget> Database::getBudget(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM budgets WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -3896,7 +7843,7 @@ std::optional<Budget> Database::getBudget(int id)
 QVector<Budget> Database::getBudgetsForMonth(int year, int month)
 {
     QVector<Budget> budgets;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3907,7 +7854,7 @@ QVector<Budget> Database::getBudgetsForMonth(int year, int month)
     query.bindValue(":year", year);
     query.bindValue(":month", month);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get budgets:" << query.lastError().text();
         return budgets;
     }
@@ -3929,10 +7876,10 @@ QVector<Budget> Database::getBudgetsForMonth(int year, int month)
 QVector<Budget> Database::getAllBudgets()
 {
     QVector<Budget> budgets;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM budgets ORDER BY year DESC, month DESC, category")) {
+    if (!execQuery(query, "SELECT * FROM budgets ORDER BY year DESC, month DESC, category")) {
         qWarning() << "Failed to get all budgets:" << query.lastError().text();
         return budgets;
     }
@@ -3951,13 +7898,99 @@ QVector<Budget> Database::getAllBudgets()
     return budgets;
 }
 
+BudgetMatrix Database::getBudgetMatrix(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("Database::getBudgetMatrix");
+    BudgetMatrix matrix;
+    if (!from.isValid() || !to.isValid() || from > to) {
+        return matrix;
+    }
+
+    QHash<QString, int> monthIndex;
+    for (QDate month(from.year(), from.month(), 1); month <= to; month = month.addMonths(1)) {
+        monthIndex.insert(month.toString("yyyy-MM"), matrix.months.size());
+        matrix.months.append(month);
+    }
+
+    // Budgets and expenses meet on (category, month); SQLite has no FULL
+    // JOIN, so both sides go through one UNION ALL and one GROUP BY
+    const QString source = archiveSource("transactions", from, to);
+    CachedQuery statement = cachedQuery("getBudgetMatrix:" + source, QString(R"(
+        SELECT category, month,
+               SUM(budgeted) AS budgeted,
+               SUM(actual) AS actual,
+               SUM(budgeted) - SUM(actual) AS variance
+        FROM (
+            SELECT category, year || '-' || substr('0' || month, -2) AS month,
+                   monthly_amount AS budgeted, 0 AS actual
+            FROM budgets
+            WHERE year * 100 + month BETWEEN :fromMonth AND :toMonth
+            UNION ALL
+            SELECT category, strftime('%Y-%m', day), 0, total_amount
+            FROM %1
+            WHERE type IN ('Purchase', 'Fuel')
+              AND day BETWEEN :from AND :to
+        )
+        GROUP BY category, month
+        ORDER BY category
+    )").arg(source));
+    QSqlQuery &query = *statement;
+    query.bindValue(":fromMonth", from.year() * 100 + from.month());
+    query.bindValue(":toMonth", to.year() * 100 + to.month());
+    query.bindValue(":from", storedDay(from));
+    query.bindValue(":to", storedDay(to));
+
+    if (!execQuery(query)) {
+        qWarning() << "Failed to get budget matrix:" << query.lastError().text();
+        return matrix;
+    }
+
+    const int monthCount = matrix.months.size();
+    matrix.monthTotals.resize(monthCount);
+    auto accumulate = [](BudgetCell &into, const BudgetCell &cell) {
+        into.budgeted += cell.budgeted;
+        into.actual += cell.actual;
+        into.variance += cell.variance;
+    };
+
+    while (query.next()) {
+        const int month = monthIndex.value(query.value("month").toString(), -1);
+        if (month < 0) {
+            continue;
+        }
+
+        // Rows arrive grouped by category, so a new name starts a new row
+        const QString category = query.value("category").toString();
+        if (matrix.categories.isEmpty() || matrix.categories.last() != category) {
+            matrix.categories.append(category);
+            matrix.cells.resize(matrix.cells.size() + monthCount);
+            matrix.categoryTotals.append(BudgetCell());
+        }
+
+        BudgetCell cell;
+        cell.budgeted = query.value("budgeted").toDouble();
+        cell.actual = query.value("actual").toDouble();
+        cell.variance = query.value("variance").toDouble();
+
+        const int row = matrix.categories.size() - 1;
+        matrix.cells[row * monthCount + month] = cell;
+        accumulate(matrix.categoryTotals[row], cell);
+        accumulate(matrix.monthTotals[month], cell);
+        accumulate(matrix.total, cell);
+    }
+
+    return matrix;
+}
+
 bool Database::updateBudget(const Budget &budget)
 {
+    markDirty(DataTable::Budgets);
+
     if (!budget.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -3973,7 +8006,7 @@ bool Database::updateBudget(const Budget &budget)
     query.bindValue(":notes", budget.notes);
     query.bindValue(":id", budget.id.value());
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update budget:" << query.lastError().text();
         return false;
     }
@@ -3982,18 +8015,22 @@ bool Database::updateBudget(const Budget &budget)
 
 bool Database::deleteBudget(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::Budgets);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM budgets WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 int Database::addFactoryBuilding(const FactoryBuilding &building)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::FactoryBuildings);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4012,7 +8049,7 @@ int Database::addFactoryBuilding(const FactoryBuilding &building)
     query.bindValue(":price", building.price);
     query.bindValue(":notes", building.notes);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add factory building:" << query.lastError().text();
         return -1;
     }
@@ -4022,13 +8059,12 @@ int Database::addFactoryBuilding(const FactoryBuilding &building)
 
 std::optional<FactoryBuilding> Database::getFactoryBuilding(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM factory_buildings WHERE id = :id");
+    CachedQuery statement = cachedQuery("getFactoryBuilding",
+                                        "SELECT * FROM factory_buildings WHERE id = :id");
+    QSqlQuery &query = *statement;
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4050,13 +8086,12 @@ std::optional<FactoryBuilding> Database::getFactoryBuilding(int id)
 
 std::optional<FactoryBuilding> Database::getFactoryBuildingByName(const QString &name)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
-    QSqlQuery query(db);
-
-    query.prepare("SELECT * FROM factory_buildings WHERE name = :name");
+    CachedQuery statement = cachedQuery("getFactoryBuildingByName",
+                                        "SELECT * FROM factory_buildings WHERE name = :name");
+    QSqlQuery &query = *statement;
     query.bindValue(":name", name);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4079,10 +8114,10 @@ std::optional<FactoryBuilding> Database::getFactoryBuildingByName(const QString
 QVector<FactoryBuilding> Database::getAllFactoryBuildings()
 {
     QVector<FactoryBuilding> buildings;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM factory_buildings ORDER BY category, name")) {
+    if (!execQuery(query, "SELECT * FROM factory_buildings ORDER BY category, name")) {
         qWarning() << "Failed to get factory buildings:" << query.lastError().text();
         return buildings;
     }
@@ -4109,13 +8144,13 @@ QVector<FactoryBuilding> Database::getAllFactoryBuildings()
 QVector<FactoryBuilding> Database::getFactoryBuildingsByCategory(const QString &category)
 {
     QVector<FactoryBuilding> buildings;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM factory_buildings WHERE category = :category ORDER BY name");
     query.bindValue(":category", category);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to get factory buildings by category:" << query.lastError().text();
         return buildings;
     }
@@ -4141,11 +8176,13 @@ QVector<FactoryBuilding> Database::getFactoryBuildingsByCategory(const QString &
 
 bool Database::updateFactoryBuilding(const FactoryBuilding &building)
 {
+    markDirty(DataTable::FactoryBuildings);
+
     if (!building.id.has_value()) {
         return false;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4167,7 +8204,7 @@ bool Database::updateFactoryBuilding(const FactoryBuilding &building)
     query.bindValue(":notes", building.notes);
     query.bindValue(":id", building.id.value());
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to update factory building:" << query.lastError().text();
         return false;
     }
@@ -4176,13 +8213,15 @@ bool Database::updateFactoryBuilding(const FactoryBuilding &building)
 
 bool Database::deleteFactoryBuilding(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::FactoryBuildings);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM factory_buildings WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 // Convenience getters
@@ -4209,10 +8248,10 @@ QVector<FactoryBuilding> Database::getProductionBuildings()
 QVector<FactoryBuilding> Database::getGenerators()
 {
     QVector<FactoryBuilding> generators;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM factory_buildings WHERE generated_kw > 0 ORDER BY generated_kw DESC")) {
+    if (!execQuery(query, "SELECT * FROM factory_buildings WHERE generated_kw > 0 ORDER BY generated_kw DESC")) {
         return generators;
     }
 
@@ -4237,7 +8276,9 @@ QVector<FactoryBuilding> Database::getGenerators()
 
 int Database::addEquipmentPlanItem(const EquipmentPlanItem &item)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4252,7 +8293,7 @@ int Database::addEquipmentPlanItem(const EquipmentPlanItem &item)
     query.bindValue(":unit_price", item.unitPrice);
     query.bindValue(":total_cost", item.totalCost);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add equipment plan item:" << query.lastError().text();
         return -1;
     }
@@ -4261,13 +8302,13 @@ int Database::addEquipmentPlanItem(const EquipmentPlanItem &item)
 
 std::optional<EquipmentPlanItem> Database::getEquipmentPlanItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM equipment_plan WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4284,13 +8325,13 @@ std::optional<EquipmentPlanItem> Database::getEquipmentPlanItem(int id)
 
 std::optional<EquipmentPlanItem> Database::getEquipmentPlanItemByItemId(int itemId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM equipment_plan WHERE item_id = :item_id");
     query.bindValue(":item_id", itemId);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4308,10 +8349,10 @@ std::optional<EquipmentPlanItem> Database::getEquipmentPlanItemByItemId(int item
 QVector<EquipmentPlanItem> Database::getEquipmentPlan()
 {
     QVector<EquipmentPlanItem> plan;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM equipment_plan ORDER BY item_name")) {
+    if (!execQuery(query, "SELECT * FROM equipment_plan ORDER BY item_name")) {
         return plan;
     }
 
@@ -4329,11 +8370,32 @@ QVector<EquipmentPlanItem> Database::getEquipmentPlan()
     return plan;
 }
 
+PlanTotals Database::getEquipmentPlanTotals()
+{
+    PlanTotals totals;
+    CachedQuery statement = cachedQuery("equipmentPlanTotals", R"(
+        SELECT COUNT(*), COALESCE(SUM(quantity), 0), COALESCE(SUM(unit_price * quantity), 0)
+        FROM equipment_plan
+    )");
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to get equipment plan totals:" << query.lastError().text();
+        return totals;
+    }
+    totals.lineCount = query.value(0).toInt();
+    totals.unitCount = query.value(1).toInt();
+    totals.cost = query.value(2).toDouble();
+    return totals;
+}
+
 bool Database::updateEquipmentPlanItem(const EquipmentPlanItem &item)
 {
+    markDirty(DataTable::CapitalPlan);
+
     if (!item.id.has_value()) return false;
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4345,30 +8407,36 @@ bool Database::updateEquipmentPlanItem(const EquipmentPlanItem &item)
     query.bindValue(":total_cost", item.totalCost);
     query.bindValue(":id", item.id.value());
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::deleteEquipmentPlanItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM equipment_plan WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 void Database::clearEquipmentPlan()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
-    query.exec("DELETE FROM equipment_plan");
+    execQuery(query, "DELETE FROM equipment_plan");
 }
 
 int Database::addFacilityPlanItem(const FacilityPlanItem &item)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4389,7 +8457,7 @@ int Database::addFacilityPlanItem(const FacilityPlanItem &item)
     query.bindValue(":total_power_kw", item.totalPowerKw);
     query.bindValue(":total_generated_kw", item.totalGeneratedKw);
 
-    if (!query.exec()) {
+    if (!execQuery(query)) {
         qWarning() << "Failed to add facility plan item:" << query.lastError().text();
         return -1;
     }
@@ -4398,13 +8466,13 @@ int Database::addFacilityPlanItem(const FacilityPlanItem &item)
 
 std::optional<FacilityPlanItem> Database::getFacilityPlanItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM facility_plan WHERE id = :id");
     query.bindValue(":id", id);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4425,13 +8493,13 @@ std::optional<FacilityPlanItem> Database::getFacilityPlanItem(int id)
 
 std::optional<FacilityPlanItem> Database::getFacilityPlanItemByBuildingId(int buildingId)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("SELECT * FROM facility_plan WHERE building_id = :building_id");
     query.bindValue(":building_id", buildingId);
 
-    if (!query.exec() || !query.next()) {
+    if (!execQuery(query) || !query.next()) {
         return std::nullopt;
     }
 
@@ -4453,10 +8521,10 @@ std::optional<FacilityPlanItem> Database::getFacilityPlanItemByBuildingId(int bu
 QVector<FacilityPlanItem> Database::getFacilityPlan()
 {
     QVector<FacilityPlanItem> plan;
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
-    if (!query.exec("SELECT * FROM facility_plan ORDER BY category, building_name")) {
+    if (!execQuery(query, "SELECT * FROM facility_plan ORDER BY category, building_name")) {
         return plan;
     }
 
@@ -4478,11 +8546,37 @@ QVector<FacilityPlanItem> Database::getFacilityPlan()
     return plan;
 }
 
+PlanTotals Database::getFacilityPlanTotals()
+{
+    PlanTotals totals;
+    CachedQuery statement = cachedQuery("facilityPlanTotals", R"(
+        SELECT COUNT(*), COALESCE(SUM(quantity), 0),
+               COALESCE(SUM(unit_price * quantity), 0),
+               COALESCE(SUM(unit_power_kw * quantity), 0),
+               COALESCE(SUM(unit_generated_kw * quantity), 0)
+        FROM facility_plan
+    )");
+    QSqlQuery &query = *statement;
+
+    if (!execQuery(query) || !query.next()) {
+        qWarning() << "Failed to get facility plan totals:" << query.lastError().text();
+        return totals;
+    }
+    totals.lineCount = query.value(0).toInt();
+    totals.unitCount = query.value(1).toInt();
+    totals.cost = query.value(2).toDouble();
+    totals.powerKw = query.value(3).toDouble();
+    totals.generatedKw = query.value(4).toDouble();
+    return totals;
+}
+
 bool Database::updateFacilityPlanItem(const FacilityPlanItem &item)
 {
+    markDirty(DataTable::CapitalPlan);
+
     if (!item.id.has_value()) return false;
 
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare(R"(
@@ -4497,25 +8591,29 @@ bool Database::updateFacilityPlanItem(const FacilityPlanItem &item)
     query.bindValue(":total_generated_kw", item.totalGeneratedKw);
     query.bindValue(":id", item.id.value());
 
-    return query.exec();
+    return execQuery(query);
 }
 
 bool Database::deleteFacilityPlanItem(int id)
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
 
     query.prepare("DELETE FROM facility_plan WHERE id = :id");
     query.bindValue(":id", id);
 
-    return query.exec();
+    return execQuery(query);
 }
 
 void Database::clearFacilityPlan()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    markDirty(DataTable::CapitalPlan);
+
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
-    query.exec("DELETE FROM facility_plan");
+    execQuery(query, "DELETE FROM facility_plan");
 }
 
 
@@ -4596,4 +8694,41 @@ AccountType stringToAccountType(const QString &str)
     return AccountType::Company;
 }
 
+QString storageProfileToString(StorageProfile profile)
+{
+    switch (profile) {
+    case StorageProfile::Safe:
+        return "Safe";
+    case StorageProfile::Fast:
+        return "Fast";
+    case StorageProfile::Balanced:
+    default:
+        return "Balanced";
+    }
+}
+
+StorageProfile stringToStorageProfile(const QString &str)
+{
+    if (str == "Safe") return StorageProfile::Safe;
+    if (str == "Fast") return StorageProfile::Fast;
+    return StorageProfile::Balanced;
+}
+
+QString movementEventKindToString(MovementEventKind kind)
+{
+    switch (kind) {
+    case MovementEventKind::Dump:
+        return "Dump";
+    case MovementEventKind::Bucket:
+    default:
+        return "Bucket";
+    }
+}
+
+MovementEventKind stringToMovementEventKind(const QString &str)
+{
+    if (str == "Dump") return MovementEventKind::Dump;
+    return MovementEventKind::Bucket;
+}
+
 } // namespace Frontier
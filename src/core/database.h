@@ -9,15 +9,72 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QMap>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
+#include <QThreadStorage>
+#include <QAtomicInt>
 #include <optional>
+#include <memory>
+#include <functional>
 
 #include "types.h"
+#include "datachangebus.h"
+#include "querytrace.h"
+#include "resultcache.h"
+
+class QTimer;
 
 namespace Frontier {
 
+class ItemCatalog;
+class ReferenceSnapshot;
+class RecipeGraph;
+class DatabaseWorker;
+class ReadPool;
+class CapitalPlanService;
+class TransactionStore;
+class FuelEfficiencyTracker;
+class CommandJournal;
+
+// One match of Database::search()
+struct SearchHit {
+    DataTable table = DataTable::None;  // Items, Transactions, Shifts or Production
+    int id = 0;
+    QString title;                      // Item name, transaction item, shift date or recipe output
+    QString detail;                     // Code, or the date and a notes excerpt
+    double rank = 0;                    // bm25; lower is a better match
+};
+
+// A statement from Database::cachedQuery(), finished when it goes out of
+// scope. A reader that stops after one row would otherwise leave it active,
+// and the connection would hold its read lock (or pin its WAL snapshot)
+// until the same statement next came up.
+class CachedQuery
+{
+public:
+    explicit CachedQuery(QSqlQuery &query) : m_query(&query) {}
+    CachedQuery(CachedQuery &&other) noexcept : m_query(other.m_query) { other.m_query = nullptr; }
+    CachedQuery(const CachedQuery &) = delete;
+    CachedQuery &operator=(const CachedQuery &) = delete;
+    ~CachedQuery()
+    {
+        if (m_query) {
+            m_query->finish();
+        }
+    }
+
+    QSqlQuery &operator*() const { return *m_query; }
+    QSqlQuery *operator->() const { return m_query; }
+
+private:
+    QSqlQuery *m_query;
+};
+
 class Database : public QObject
 {
     Q_OBJECT
@@ -27,45 +84,254 @@ public:
     ~Database();
 
     bool initialize(const QString &dbPath);
+    // Opens another connection to a file initialize() has already set up;
+    // applies the storage profile but skips table creation and migrations.
+    // readOnly sets PRAGMA query_only so stray writes fail.
+    bool openExisting(const QString &dbPath, bool readOnly = false);
     void close();
+    // Closes this file and initializes dbPath in its place, for switching
+    // profiles without a restart. Every view reloads through the change bus;
+    // with a shared catalog the item catalog and recipe graph stay loaded,
+    // since the reference tables did not change. The worker then reads the
+    // new ledger once in the background so the first views open on warm
+    // pages. On failure the previous file is reopened and false returned.
+    bool switchTo(const QString &dbPath);
     bool isOpen() const;
     QString lastError() const;
+    QString databasePath() const;
+
+    // Background reader on its own connection (see databaseworker.h).
+    // Created on first use; requires an open database.
+    DatabaseWorker &worker();
+
+    // Read-only connections for concurrent report queries (see readpool.h).
+    // Created on first use; writes stay on this connection.
+    ReadPool &readPool();
+
+    // Cached plan totals and affordability (see capitalplanservice.h)
+    CapitalPlanService &capitalPlan();
+
+    // Column-wise ledger copy for report aggregates (see transactionstore.h)
+    TransactionStore &transactionStore();
+
+    // Undo/redo of UI edits (see commandjournal.h); emptied by close()
+    CommandJournal &journal();
+
+    // === Threads ===
+    // The Database belongs to the thread that created it (the owner,
+    // normally the GUI thread), but any thread may call it. Each other
+    // thread gets its own connection to the file, opened on first use and
+    // closed when the thread exits, with its own prepared statements,
+    // transaction depth and lastError(). From those threads:
+    //  - SQL reads and writes are safe, and begin/commit/rollback apply to
+    //    that thread's connection only. SQLite serialises writers, so a
+    //    write waits (up to the driver's busy timeout) for another's commit.
+    //  - A write's cache invalidation and change-bus publish are posted to
+    //    the owner and happen on its next event loop pass; the write-behind
+    //    queue is not flushed first.
+    //  - Cached vocabulary and row counts are bypassed, not filled.
+    //  - Owner only: itemCatalog(), recipeGraph() and methods built on them
+    //    (getProductionHistory(), analyses), transactionStore(),
+    //    capitalPlan(), journal(), the write-behind queue, queryTracer()
+    //    (other threads' statements are not traced), applyStorageProfile(),
+    //    worker(), readPool() and close().
+    // close() must not run while another thread is inside a call; a thread
+    // that keeps going after close() reconnects to whatever is open next.
+    bool isOwnerThread() const;
+
+    // Schema version stored in PRAGMA user_version (see migrateSchema)
+    int schemaVersion() const;
+
+    // Per-statement SQL log for this connection, off by default (see querytrace.h)
+    QueryTracer &queryTracer() { return m_queryTracer; }
+
+    // === Storage Profile ===
+    // PRAGMA set (journal, sync, cache, mmap) applied at open. initialize()
+    // uses the profile saved under Database/storageProfile in QSettings.
+    StorageProfile storageProfile() const { return m_storageProfile; }
+    bool applyStorageProfile(StorageProfile profile);
+    static StorageProfile savedStorageProfile();
+    static void saveStorageProfile(StorageProfile profile);
+
+    // === Shared Catalog ===
+    // With a catalog path set before initialize() or openExisting(), the
+    // reference tables (items, workbenches, recipes and their ingredients,
+    // maps, location types, locations and factory buildings) live in that
+    // file, attached as "catalog" on every connection, so several profile
+    // files share one copy. SQL names them unqualified as before; the file
+    // itself keeps the ledger, fleet, logs, plans and other tables of its
+    // own. initialize() moves the reference rows of a file that still has
+    // them into the catalog, unless the catalog already has rows of that
+    // table, and drops the file's copies. The reference snapshot sits
+    // beside the catalog. The catalog counts against SQLite's ten attached
+    // files per connection. Empty (the default) keeps one self-contained file.
+    void setCatalogPath(const QString &path) { m_catalogPath = path; }
+    QString catalogPath() const { return m_catalogPath; }
+
+    // === Transactions ===
+    // Nestable: only the outermost begin/commit pair touches SQLite.
+    // A rollback at any depth abandons the whole transaction: a nested one
+    // marks it rollback-only, every later commit then fails, and SQLite's
+    // transaction is rolled back when the outermost level ends.
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+    bool inTransaction() const;
+
+    // === Write-Behind Queue ===
+    // For edits that arrive many times a second (spin boxes, quantity
+    // steppers). The write runs later, in one transaction with every other
+    // queued write; queueing under the key of a write still waiting
+    // replaces it, so holding an arrow key on one row costs one UPDATE.
+    // The queue flushes WriteBehindDelayMs after the first write is queued,
+    // before any direct write or outermost transaction (so writes keep
+    // their order), on flushPendingWrites() and on close(). The write
+    // publishes its tables when it runs; origin, if given, is then
+    // acknowledged on the change bus because it already shows the edit.
+    // A batch that fails to begin or commit goes back on the queue, behind
+    // nothing and under any newer write for its key, and is retried. A
+    // single write that fails is dropped and its tables are published,
+    // origin unacknowledged, so the view reloads what was stored. Flushed
+    // inside a transaction, the writes join it: they are not retried if it
+    // fails, and roll back with it.
+    static constexpr int WriteBehindDelayMs = 300;
+    void queueWrite(const QString &key, DataTables tables,
+                    std::function<bool(Database &)> write, QObject *origin = nullptr);
+    bool flushPendingWrites();
+    bool hasPendingWrites() const { return !m_pendingWrites.isEmpty(); }
 
     // === Item CRUD ===
     bool addItem(const Item &item);
+    int addItems(const QVector<Item> &items);  // Single transaction, returns count added
     std::optional<Item> getItem(int id);
     std::optional<Item> getItemByCode(const QString &code);
     std::optional<Item> getItemByName(const QString &name);
     QVector<Item> getAllItems();
-    QVector<QString> getAllCategories();
+    QVector<QString> getAllCategories();        // Cached; see Vocabulary below
     QVector<Item> getItemsByCategory(const QString &category);
     bool updateItem(const Item &item);
+    // Recomputes the stored sell prices of every item in the group from its
+    // buy price in one UPDATE; sellRatio < 0 uses calculateSellPrice()'s rule.
+    // Returns rows changed or -1. The catalog is invalidated once.
+    int repriceItems(PricingGroup group, double sellRatio = -1);
     bool deleteItem(int id);
+    bool clearAllItems();
+
+    // Shared in-memory view of the items table (see itemcatalog.h)
+    ItemCatalog &itemCatalog();
+
+    // === Reference Snapshot ===
+    // Mapped binary copy of the items table beside the database file, or
+    // beside the shared catalog when there is one (see
+    // referencesnapshot.h). Null when there is none or it no longer matches
+    // the items table; any item write deletes it until the next import.
+    const ReferenceSnapshot *referenceSnapshot();
+    QString referenceSnapshotPath() const;
+    // Rewrites it from the items table; sourceChecksum is the SHA-1 of the
+    // items JSON just imported, or empty when unknown
+    bool writeReferenceSnapshot(const QByteArray &sourceChecksum = QByteArray());
+
+    // === Reference Sources ===
+    // Checksum of the built-in reference data set ("items", "vehicles",
+    // "factory_buildings") this file was seeded from, kept until an import
+    // of that set replaces it (see embeddedcatalog.h). Empty when there is
+    // none; setting an empty checksum forgets it.
+    QByteArray referenceSource(const QString &dataSet);
+    bool setReferenceSource(const QString &dataSet, const QByteArray &checksum);
+
+    // === Full-Text Search ===
+    // Item names, codes and categories, transaction items and notes, and
+    // shift and production run notes, through FTS5 indexes the tables'
+    // triggers keep current. Every word of text matches as a word prefix,
+    // so "iro o" finds "Iron Ore"; hits come best first by bm25 across the
+    // tables asked for, at most limit of them (-1 for all). Archived years
+    // are not searched. Without FTS5 in SQLite the same call falls back to
+    // substring scans, unranked.
+    QVector<SearchHit> search(const QString &text, DataTables tables = DataTable::All, int limit = 50);
+    bool hasSearchIndex() const { return m_hasSearchIndex; }
+
+    // === Year Archives ===
+    // A closed year's transactions, fuel log and production runs can be
+    // moved to <file>.<year>.db beside the database file. The balance and
+    // fuel rollups keep the archived days, so balances, balancesAsOf and
+    // getFuelDailyTotals() never open an archive; the balance at each
+    // year end is recorded as its carried-forward checkpoint.
+    // Range reads (getTransactionsByDateRange(), queryTransactions() and
+    // totals, finance summaries, getFuelLog(), fuel sums, production
+    // runs) ATTACH the archives their range overlaps, once per connection,
+    // and read them with the live table; an open-ended range or a getAll
+    // reads every archive. An archive cannot be attached inside a
+    // transaction, and SQLite attaches at most ten per connection; past
+    // either (nine with a shared catalog), the read warns and sees the
+    // live rows only. Archived rows
+    // are read-only: lookups by id and the row writers see live rows.
+    // archiveYear() is owner only.
+    bool archiveYear(int year);
+    QVector<ArchivedYear> archivedYears();
+    QString archivePath(int year) const;
+
+    // === Streaming Reads ===
+    // For exports: hands each row of a logged table (Transactions,
+    // FuelLog, Production, Shifts or CycleTimes' records) dated in
+    // [from, to], archives included, to row in date and id order. Rows
+    // come off a forward-only cursor one at a time and are never
+    // collected; row returns false to stop early. An invalid end is open.
+    bool streamRows(DataTable table, const QDate &from, const QDate &to,
+                    const std::function<bool(const QSqlRecord &)> &row);
+    qint64 countRowsInRange(DataTable table, const QDate &from, const QDate &to);
+
+    // Write methods publish the tables they touch here (see datachangebus.h)
+    DataChangeBus &changeBus() { return *m_changeBus; }
 
     // === Transaction CRUD ===
-    bool addTransaction(const Transaction &transaction);
+    // insertedId, if given, receives the new row's id
+    bool addTransaction(const Transaction &transaction, int *insertedId = nullptr);
+    // Re-inserts a deleted row under its old id (undo of a delete)
+    bool restoreTransaction(const Transaction &transaction);
     std::optional<Transaction> getTransaction(int id);
     QVector<Transaction> getAllTransactions();
+    // Memoized on the owner thread until the ledger is next written; see ResultCache
     QVector<Transaction> getTransactionsByDateRange(const QDate &from, const QDate &to);
+    // Filtered, paged ledger: Opening first, then newest first
+    QVector<Transaction> queryTransactions(const TransactionQuery &filter);
+    TransactionTotals getTransactionTotals(const TransactionQuery &filter);
+    // Newest rows by (date, id) with the combined balance after each one;
+    // reads only `limit` rows however long the ledger is
+    QVector<RecentTransaction> getRecentTransactions(int limit);
+    QVector<QString> getTransactionCategories();    // Cached; see Vocabulary below
     bool updateTransaction(const Transaction &transaction);
     bool deleteTransaction(int id);
 
     // === Vehicle CRUD ===
     bool addVehicle(const Vehicle &vehicle);
+    int upsertVehicles(const QVector<Vehicle> &vehicles);  // Insert or update by id
     std::optional<Vehicle> getVehicle(const QString &id);
     QVector<Vehicle> getAllVehicles(bool activeOnly = false);
     bool updateVehicle(const Vehicle &vehicle);
     bool deleteVehicle(const QString &id);
+    bool clearAllVehicles();
 
     // === Operations Tables ===
     bool createOperationsTables();
 
     // === Fuel Log CRUD ===
     bool addFuelLogEntry(const FuelLogEntry &entry);
+    // Inserts all entries in one transaction; returns rows written or -1
+    int addFuelLogEntries(const QVector<FuelLogEntry> &entries);
+    // Memoized like getTransactionsByDateRange()
     QVector<FuelLogEntry> getFuelLog(const QDateTime &from, const QDateTime &to,
                                      const QString &equipmentId = QString());
     double getTotalFuelInRange(const QDateTime &from, const QDateTime &to);
     double getTotalFuelCostInRange(const QDateTime &from, const QDateTime &to);
+    // Read from the trigger-maintained daily rollup
+    QVector<FuelDailyTotal> getFuelDailyTotals(const QDate &from, const QDate &to,
+                                               const QString &equipmentId = QString());
+    QVector<FuelDailyTotal> getFuelTotalsByEquipment(const QDate &from, const QDate &to);
+    // Per equipment over the entries with hours logged (meter_or_hours > 0),
+    // archives included; perDay splits the sums by day. An invalid end is open.
+    QVector<FuelHours> getFuelHours(const QDate &from, const QDate &to, bool perDay);
+    // Rolling L/hr against spec per equipment (see fuelefficiency.h)
+    FuelEfficiencyTracker &fuelEfficiency();
 
     // === Movement Session CRUD ===
     int addMovementSession(const MovementSession &session);
@@ -73,13 +339,25 @@ public:
     QVector<MovementSession> getAllMovementSessions();
     bool updateMovementSession(const MovementSession &session);
     bool deleteMovementSession(int id);
+    // Sessions with usage totals, one page at a time; one query, any page size
+    QVector<MovementSessionSummary> queryMovementSessions(const MovementSessionQuery &filter);
+    std::optional<MovementSessionSummary> getMovementSessionSummary(int sessionId);
 
     // === Movement Equipment Usage CRUD ===
     bool addOrUpdateEquipmentUsage(const MovementEquipmentUsage &usage);
+    // Upserts a whole session in one transaction; returns rows written or -1
+    int saveEquipmentUsages(int sessionId, const QVector<MovementEquipmentUsage> &usages);
     QVector<MovementEquipmentUsage> getEquipmentUsageForSession(int sessionId);
     bool deleteEquipmentUsage(int id);
     bool deleteEquipmentUsageForSession(int sessionId);
 
+    // === Movement Events ===
+    // Appends captured events in one transaction; returns rows written or -1.
+    // Nothing is published: the usage they are tallied into is saved beside
+    // them and reports the change.
+    int addMovementEvents(const QVector<MovementEvent> &events);
+    QVector<MovementEvent> getMovementEvents(int sessionId);
+
     // === Workbench CRUD ===
     int addWorkbench(const Workbench &workbench);
     std::optional<Workbench> getWorkbench(int id);
@@ -90,6 +368,7 @@ public:
 
     // === Recipe CRUD ===
     int addRecipe(const Recipe &recipe);
+    int addRecipes(QVector<Recipe> &recipes);  // Adds ingredients too; assigns ids
     std::optional<Recipe> getRecipe(int id);
     QVector<Recipe> getAllRecipes();
     QVector<Recipe> getRecipesByWorkbench(int workbenchId);
@@ -98,11 +377,23 @@ public:
     bool deleteRecipe(int id);
     bool clearAllRecipes();
 
+    // Shared compiled snapshot of every recipe (see recipegraph.h). Rebuilt
+    // on the next call after recipes, ingredients or workbenches change.
+    std::shared_ptr<const RecipeGraph> recipeGraph();
+
     // === Recipe Ingredient CRUD ===
     bool addRecipeIngredient(const RecipeIngredient &ingredient);
     QVector<RecipeIngredient> getIngredientsForRecipe(int recipeId);
     bool deleteIngredientsForRecipe(int recipeId);
 
+    // === Vocabulary ===
+    // Distinct categories and row counts for combo boxes and counters.
+    // Each is read once and cached until a write to its table (markDirty).
+    int getItemCount();
+    int getMapCount();
+    int getLocationTypeCount();
+    int getLocationCount();
+
     // === Location Tables ===
     bool createLocationTables();
 
@@ -111,6 +402,7 @@ public:
     std::optional<Map> getMap(int id);
     std::optional<Map> getMapByAbbrev(const QString &abbrev);
     QVector<Map> getAllMaps();
+    bool updateMap(const Map &map);
     bool deleteMap(int id);
     bool clearAllMaps();
 
@@ -124,11 +416,13 @@ public:
 
     // === Location CRUD ===
     int addLocation(const Location &location);
+    int addLocations(const QVector<Location> &locations);
     std::optional<Location> getLocation(int id);
     QVector<Location> getAllLocations();
     QVector<Location> getLocationsByMap(int mapId);
     QVector<Location> getLocationsByType(int typeId);
     QVector<Location> getLocationsByMapAndType(int mapId, int typeId);
+    bool updateLocation(const Location &location);
     bool deleteLocation(int id);
     bool clearAllLocations();
 
@@ -150,6 +444,15 @@ public:
     bool deleteInventoryItem(int id);
     bool clearAllInventory();
 
+    // === Ledger Sync Checkpoint ===
+    // Id of the last transaction replayed into inventory (see inventoryledgersync.h)
+    int getInventorySyncCheckpoint();
+    bool setInventorySyncCheckpoint(int transactionId);
+    // Sale and Purchase rows with id > afterId, oldest first; only the
+    // columns the replay needs are filled
+    QVector<Transaction> getStockTransactionsAfter(int afterId);
+    int countStockTransactionsAfter(int afterId);
+
     // === Oil Tracking ===
     OilTracking getOilTracking();
     bool saveOilTracking(const OilTracking &tracking);
@@ -163,6 +466,12 @@ public:
     int addProductionRun(const ProductionRun &run);
     std::optional<ProductionRun> getProductionRun(int id);
     QVector<ProductionRun> getAllProductionRuns();
+    // All runs with inputCost/outputValue filled in at today's catalog
+    // prices; each distinct recipe is priced once
+    QVector<ProductionRun> getProductionHistory();
+    // One history entry, priced the same way
+    std::optional<ProductionRun> getProductionHistoryRun(int id);
+    // Memoized until production runs or recipes are written
     QVector<ProductionRun> getProductionRunsByDateRange(const QDateTime &from, const QDateTime &to);
     QVector<ProductionRun> getProductionRunsByRecipe(int recipeId);
     bool updateProductionRun(const ProductionRun &run);
@@ -180,14 +489,23 @@ public:
     int addShift(const Shift &shift);
     std::optional<Shift> getShift(int id);
     QVector<Shift> getAllShifts();
+    // Memoized like getTransactionsByDateRange()
     QVector<Shift> getShiftsByDateRange(const QDate &from, const QDate &to);
     bool updateShift(const Shift &shift);
     bool deleteShift(int id);
     bool clearAllShifts();
 
+    QVector<Shift> queryShifts(const ShiftQuery &filter);
+
     // === Shift Statistics ===
     int getTotalShiftCount();
     int getTotalShiftMinutes();
+    ShiftTotals getShiftTotals();
+    // One row per day, week (starting Monday) or month with shifts in
+    // [from, to], newest first; invalid dates leave that end open
+    QVector<ShiftTotals> getShiftAnalytics(ShiftPeriod period,
+                                           const QDate &from = QDate(),
+                                           const QDate &to = QDate());
 
     // === Cycle Time Tables ===
     bool createCycleProfilesTable();
@@ -214,14 +532,20 @@ public:
     AccountBalance calculateBalances();
     AccountBalance calculateBalancesAsOf(const QDate &date);
     FinanceSummary getFinanceSummary(const QDate &from, const QDate &to);
+    // Keyed by the first day of each month in [from, to]; one scan for the range
+    QMap<QDate, FinanceSummary> getFinanceSummariesByMonth(const QDate &from, const QDate &to);
     FinanceSummary getFinanceSummaryByAccount(const QDate &from, const QDate &to, AccountType account);
 
     // === Budget Table ===
     bool createBudgetsTable();
     int addBudget(const Budget &budget);
+    bool restoreBudget(const Budget &budget);   // Under its old id, as restoreTransaction()
     std::optional<Budget> getBudget(int id);
     QVector<Budget> getBudgetsForMonth(int year, int month);
     QVector<Budget> getAllBudgets();
+    // Every month of [from, to] against every budgeted or spent category,
+    // from one grouped scan of budgets and the ledger
+    BudgetMatrix getBudgetMatrix(const QDate &from, const QDate &to);
     bool updateBudget(const Budget &budget);
     bool deleteBudget(int id);
 
@@ -252,6 +576,7 @@ public:
     std::optional<EquipmentPlanItem> getEquipmentPlanItem(int id);
     std::optional<EquipmentPlanItem> getEquipmentPlanItemByItemId(int itemId);
     QVector<EquipmentPlanItem> getEquipmentPlan();
+    PlanTotals getEquipmentPlanTotals();
     bool updateEquipmentPlanItem(const EquipmentPlanItem &item);
     bool deleteEquipmentPlanItem(int id);
     void clearEquipmentPlan();
@@ -262,18 +587,140 @@ public:
     std::optional<FacilityPlanItem> getFacilityPlanItem(int id);
     std::optional<FacilityPlanItem> getFacilityPlanItemByBuildingId(int buildingId);
     QVector<FacilityPlanItem> getFacilityPlan();
+    PlanTotals getFacilityPlanTotals();
     bool updateFacilityPlanItem(const FacilityPlanItem &item);
     bool deleteFacilityPlanItem(int id);
     void clearFacilityPlan();
 
+signals:
+    // Emitted after a successful vehicle write so spec caches can reload
+    void vehiclesChanged();
+
 private:
     bool createTables();
+    bool migrateSchema();
+
+    // === Shared Catalog ===
+    // "catalog" when a catalog path is set, else "main"
+    QString referenceSchema() const;
+    bool attachCatalog(const QSqlDatabase &db, QString *error) const;
+    bool createCatalogIndexes();
+    bool moveReferenceTables();
+    // Builds any missing FTS5 index and its triggers; true with
+    // m_hasSearchIndex left false when SQLite lacks FTS5
+    bool createSearchIndex();
+    bool searchesByIndex(const QString &source, const TransactionQuery &filter) const;
     bool createVehiclesTable();
     bool createRecipeTables();
-
+    bool upsertEquipmentUsage(const MovementEquipmentUsage &usage);
+    bool insertFuelLogEntry(const FuelLogEntry &entry);
+    bool insertTransaction(const Transaction &transaction, bool keepId, int *insertedId);
+    // Sums a fuel_log column over whole days from the rollup plus raw edge rows
+    double sumFuelInRange(const QString &column, const QDateTime &from, const QDateTime &to);
+
+    // Fill Recipe::ingredients for a batch of recipes with a single query.
+    // wholeTable skips the id filter when the batch is every recipe.
+    void attachIngredients(QVector<Recipe> &recipes, bool wholeTable);
+    void invalidateRecipeGraph() { m_recipeGraph.reset(); }
+    void markDirty(DataTables tables);
+    // markDirty() without the table-level publish, for single-row writers
+    // that publish a RowChange once the write succeeds
+    void invalidateForWrite(DataTables tables);
+    void publishRowChange(DataTable table, RowChange::Kind kind, int id);
+    void priceProductionRuns(QVector<ProductionRun> &runs);
+    void forgetRolledBackWrites();
+    void invalidateItemCatalog();
+
+    // === Archive Routing ===
+    // table on its own, or a UNION ALL of it and the archives whose years
+    // [from, to] overlaps (an invalid end is open), attached on demand
+    QString archiveSource(const QString &table, const QDate &from = QDate(),
+                          const QDate &to = QDate());
+    QVector<int> archivedYearList();       // Cached on the owner thread
+    bool attachArchive(int year);
+    // Adds the integer date columns to an archive written before they existed
+    bool upgradeArchive(const QString &schema);
+    QSet<int> &attachedArchives();         // This thread's connection's
+    static QString archiveSchema(int year);
+
+    // === Per-Thread Connections ===
+    struct ThreadConnection;
+    // This thread's connection: the owner's own, or one opened for the
+    // calling thread; invalid when the database is not open
+    QSqlDatabase connection() const;
+    ThreadConnection &threadState() const;
+    QString &errorText();                // This thread's lastError()
+    int &transactionDepth();             // This thread's nesting depth
+    bool &rollbackOnly();                // This thread's; set by a nested rollback
+    // Rolls back SQLite's transaction and drops what was cached inside it
+    void abandonTransaction();
+    // Queues work on the owner thread; false (nothing queued) when
+    // already on it
+    bool postToOwner(std::function<void()> work);
+
+    struct PendingWrite {
+        QString key;
+        DataTables tables;                  // Published if the write fails
+        std::function<bool(Database &)> write;
+        QPointer<QObject> origin;
+    };
+    void requeueWrites(const QVector<PendingWrite> &writes);
+
+    // === Vocabulary Cache ===
+    struct VocabularyCache {
+        std::optional<QVector<QString>> itemCategories;
+        std::optional<QVector<QString>> transactionCategories;
+        QHash<QString, int> rowCounts;          // Table name -> COUNT(*)
+    };
+    int countRows(const QString &table);
+    void invalidateVocabulary(DataTables tables);
+
+    // === Prepared Statement Cache ===
+    // Returns a statement prepared once per connection and reused across calls.
+    // The key identifies the call site; the statement is finished before reuse
+    // and again when the returned guard goes out of scope.
+    CachedQuery cachedQuery(const QString &key, const QString &sql);
+    void clearStatementCache();
+
+    // === Statement Execution ===
+    // Every exec() goes through these so the query tracer sees it
+    bool execQuery(QSqlQuery &query) const;
+    bool execQuery(QSqlQuery &query, const QString &sql) const;
+    void traceQuery(const QSqlQuery &query, qint64 ns, bool ok) const;
 
     QString m_connectionName;
-    QString m_lastError;
+    QString m_catalogPath;
+    QString m_lastError;                 // Owner thread's
+    int m_transactionDepth = 0;          // Owner thread's
+    bool m_rollbackOnly = false;         // Owner thread's
+    mutable QThreadStorage<ThreadConnection *> m_threads;
+    QAtomicInt m_generation;             // Bumped by close()
+    bool m_reportsMemory = false;        // Registered with the Profiler
+    StorageProfile m_storageProfile = StorageProfile::Safe;
+    ItemCatalog *m_itemCatalog;
+    std::unique_ptr<ReferenceSnapshot> m_snapshot;
+    bool m_snapshotChecked = false;      // Open attempted since the last item write
+    bool m_usesSnapshot = false;         // Primary connection only; see initialize()
+    bool m_hasSearchIndex = false;       // FTS5 tables present; see search()
+    DataChangeBus *m_changeBus;
+    QVector<PendingWrite> m_pendingWrites;   // First-queued order
+    QHash<QString, int> m_pendingWriteIndex; // Key -> slot in m_pendingWrites
+    QTimer *m_writeBehindTimer;
+    bool m_flushingWrites = false;
+    std::shared_ptr<const RecipeGraph> m_recipeGraph;
+    QHash<QString, QSqlQuery*> m_statementCache;
+    mutable QueryTracer m_queryTracer;
+    VocabularyCache m_vocabulary;
+    ResultCache m_resultCache;           // Owner thread's range query results
+    bool m_memoizes = false;             // initialize()'s instance only; see ResultCache
+    std::optional<QVector<int>> m_archiveYears;   // Owner thread's
+    QSet<int> m_attachedArchives;              // Owner connection's
+    std::unique_ptr<DatabaseWorker> m_worker;
+    std::unique_ptr<ReadPool> m_readPool;
+    std::unique_ptr<CapitalPlanService> m_capitalPlan;
+    std::unique_ptr<TransactionStore> m_transactionStore;
+    std::unique_ptr<FuelEfficiencyTracker> m_fuelEfficiency;
+    std::unique_ptr<CommandJournal> m_journal;
 };
 
 // Helper functions for enum conversion
@@ -283,6 +730,10 @@ QString transactionTypeToString(TransactionType type);
 TransactionType stringToTransactionType(const QString &str);
 QString accountTypeToString(AccountType type);
 AccountType stringToAccountType(const QString &str);
+QString storageProfileToString(StorageProfile profile);
+StorageProfile stringToStorageProfile(const QString &str);
+QString movementEventKindToString(MovementEventKind kind);
+MovementEventKind stringToMovementEventKind(const QString &str);
 
 } // namespace Frontier
 
@@ -0,0 +1,98 @@
+/**
+ * @file databaseworker.cpp
+ * @brief Background database worker implementation
+ */
+
+#include "databaseworker.h"
+#include "database.h"
+
+#include <QThread>
+#include <QDebug>
+
+namespace Frontier {
+
+DatabaseWorker::DatabaseWorker(const QString &dbPath, const QString &catalogPath, QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_context(new QObject)
+{
+    m_thread->setObjectName("DatabaseWorker");
+    m_context->moveToThread(m_thread);
+    m_thread->start();
+
+    // The connection has to be created on the thread that will use it
+    post([this, dbPath, catalogPath]() {
+        m_database = new Database;
+        m_database->setCatalogPath(catalogPath);
+        if (!m_database->openExisting(dbPath)) {
+            qWarning() << "Database worker failed to open" << dbPath << ":" << m_database->lastError();
+            delete m_database;
+            m_database = nullptr;
+        }
+    });
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    // Queued tasks run first, then the connection is closed on its own thread
+    QMetaObject::invokeMethod(m_context, [this]() {
+        delete m_database;
+        m_database = nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+    delete m_context;
+}
+
+void DatabaseWorker::post(std::function<void()> task)
+{
+    QMetaObject::invokeMethod(m_context, std::move(task), Qt::QueuedConnection);
+}
+
+// =============================================================================
+// Heavy Reads
+// =============================================================================
+
+QFuture<QVector<Transaction>> DatabaseWorker::getAllTransactions()
+{
+    return run([](Database &db) { return db.getAllTransactions(); });
+}
+
+QFuture<QVector<Transaction>> DatabaseWorker::queryTransactions(const TransactionQuery &filter)
+{
+    return run([filter](Database &db) { return db.queryTransactions(filter); });
+}
+
+QFuture<TransactionTotals> DatabaseWorker::getTransactionTotals(const TransactionQuery &filter)
+{
+    return run([filter](Database &db) { return db.getTransactionTotals(filter); });
+}
+
+QFuture<AccountBalance> DatabaseWorker::calculateBalances()
+{
+    return run([](Database &db) { return db.calculateBalances(); });
+}
+
+QFuture<FinanceSummary> DatabaseWorker::getFinanceSummary(const QDate &from, const QDate &to)
+{
+    return run([from, to](Database &db) { return db.getFinanceSummary(from, to); });
+}
+
+QFuture<QMap<QDate, FinanceSummary>> DatabaseWorker::getFinanceSummariesByMonth(const QDate &from,
+                                                                                const QDate &to)
+{
+    return run([from, to](Database &db) { return db.getFinanceSummariesByMonth(from, to); });
+}
+
+QFuture<QVector<InventoryItem>> DatabaseWorker::getAllInventory()
+{
+    return run([](Database &db) { return db.getAllInventory(); });
+}
+
+QFuture<QVector<ProductionRun>> DatabaseWorker::getAllProductionRuns()
+{
+    return run([](Database &db) { return db.getAllProductionRuns(); });
+}
+
+} // namespace Frontier
@@ -0,0 +1,97 @@
+/**
+ * @file databaseworker.h
+ * @brief Runs read queries on a background thread with its own connection
+ */
+
+#ifndef DATABASEWORKER_H
+#define DATABASEWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QFuture>
+#include <QPromise>
+#include <QMap>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "types.h"
+
+class QThread;
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Asynchronous read facade over a second connection to the same file
+ *
+ * The worker thread owns its own Database opened with openExisting(), so
+ * its connection and prepared statements never cross threads. A catalog
+ * path attaches the shared reference tables as on the primary (see
+ * Database::setCatalogPath). Calls are
+ * queued and run in order; each returns a QFuture that finishes on the
+ * worker thread, so continue on the GUI thread with
+ * future.then(this, ...).
+ *
+ * Only SQL reads belong here. The worker's ItemCatalog and RecipeGraph
+ * are not invalidated by writes through the primary Database, and writes
+ * stay on the primary connection.
+ */
+class DatabaseWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseWorker(const QString &dbPath, const QString &catalogPath = QString(),
+                            QObject *parent = nullptr);
+    ~DatabaseWorker();
+
+    // Runs fn(Database &) on the worker thread
+    template <typename Fn>
+    auto run(Fn fn) -> QFuture<std::invoke_result_t<Fn, Database &>>;
+
+    // === Heavy Reads ===
+    QFuture<QVector<Transaction>> getAllTransactions();
+    QFuture<QVector<Transaction>> queryTransactions(const TransactionQuery &filter);
+    QFuture<TransactionTotals> getTransactionTotals(const TransactionQuery &filter);
+    QFuture<AccountBalance> calculateBalances();
+    QFuture<FinanceSummary> getFinanceSummary(const QDate &from, const QDate &to);
+    QFuture<QMap<QDate, FinanceSummary>> getFinanceSummariesByMonth(const QDate &from, const QDate &to);
+    QFuture<QVector<InventoryItem>> getAllInventory();
+    QFuture<QVector<ProductionRun>> getAllProductionRuns();
+
+private:
+    void post(std::function<void()> task);
+
+    QThread *m_thread;
+    QObject *m_context;              // Lives on m_thread; tasks are queued to it
+    Database *m_database = nullptr;  // Created, used and destroyed on m_thread
+};
+
+template <typename Fn>
+auto DatabaseWorker::run(Fn fn) -> QFuture<std::invoke_result_t<Fn, Database &>>
+{
+    using Result = std::invoke_result_t<Fn, Database &>;
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    post([this, promise, fn = std::move(fn)]() mutable {
+        if (!m_database) {
+            promise->future().cancel();      // Never opened
+        } else if constexpr (std::is_void_v<Result>) {
+            fn(*m_database);
+        } else {
+            promise->addResult(fn(*m_database));
+        }
+        promise->finish();
+    });
+
+    return future;
+}
+
+} // namespace Frontier
+
+#endif // DATABASEWORKER_H
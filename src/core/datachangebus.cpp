@@ -0,0 +1,204 @@
+/**
+ * @file datachangebus.cpp
+ * @brief Data change bus implementation
+ */
+
+#include "datachangebus.h"
+
+#include <QEvent>
+#include <QVariant>
+#include <QMetaObject>
+#include <utility>
+
+#include "profiler.h"
+
+namespace Frontier {
+
+namespace {
+
+// QWidget's visible property; anything without one is always shown
+bool isShown(const QObject *view)
+{
+    const QVariant visible = view->property("visible");
+    return !visible.isValid() || visible.toBool();
+}
+
+// Copies the callback first: a refresh may replace its own subscription
+void runRefresh(QObject *view, std::function<void()> refresh)
+{
+    const QString name = QStringLiteral("Refresh: %1").arg(QString::fromLatin1(view->metaObject()->className()));
+    FRONTIER_TRACE_SCOPE_DETAIL("DataChangeBus refresh", view->metaObject()->className());
+
+    QElapsedTimer timer;
+    timer.start();
+    refresh();
+    Profiler::instance().record(name, timer.nsecsElapsed());
+}
+
+} // namespace
+
+DataChangeBus::DataChangeBus(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void DataChangeBus::publish(DataTables tables)
+{
+    if (!tables) {
+        return;
+    }
+
+    m_pending |= tables;
+    m_coarse |= tables;
+    if (!m_flushQueued) {
+        m_flushQueued = true;
+        QMetaObject::invokeMethod(this, &DataChangeBus::flush, Qt::QueuedConnection);
+    }
+}
+
+void DataChangeBus::publishRow(const RowChange &change)
+{
+    if (change.table == DataTable::None) {
+        return;
+    }
+
+    m_pending |= change.table;
+    if (!(m_coarse & change.table)) {
+        m_pendingRows.append(change);
+    }
+    if (!m_flushQueued) {
+        m_flushQueued = true;
+        QMetaObject::invokeMethod(this, &DataChangeBus::flush, Qt::QueuedConnection);
+    }
+}
+
+void DataChangeBus::demoteRows(DataTables tables)
+{
+    m_coarse |= m_pending & tables;
+}
+
+void DataChangeBus::subscribe(QObject *view, DataTables tables, std::function<void()> refresh,
+                              bool loadWhenShown)
+{
+    if (!view) {
+        return;
+    }
+
+    if (!m_subscribers.contains(view)) {
+        view->installEventFilter(this);
+        connect(view, &QObject::destroyed, this, [this](QObject *object) {
+            m_subscribers.remove(object);
+        });
+    }
+
+    Subscriber &subscriber = m_subscribers[view];
+    subscriber.view = view;
+    subscriber.tables = tables;
+    subscriber.refresh = std::move(refresh);
+    subscriber.acknowledged = DataTable::None;
+    subscriber.dirty = loadWhenShown;
+}
+
+void DataChangeBus::unsubscribe(QObject *view)
+{
+    if (m_subscribers.remove(view) > 0) {
+        view->removeEventFilter(this);
+        disconnect(view, &QObject::destroyed, this, nullptr);
+    }
+}
+
+void DataChangeBus::setRowPatcher(QObject *view,
+                                  std::function<bool(const QVector<RowChange> &)> patch)
+{
+    auto it = m_subscribers.find(view);
+    if (it != m_subscribers.end()) {
+        it->patch = std::move(patch);
+    }
+}
+
+void DataChangeBus::acknowledge(QObject *view)
+{
+    auto it = m_subscribers.find(view);
+    if (it != m_subscribers.end()) {
+        it->acknowledged |= m_pending;
+    }
+}
+
+void DataChangeBus::flush()
+{
+    m_flushQueued = false;
+    const DataTables changed = m_pending;
+    const DataTables coarse = m_coarse;
+    m_pending = DataTable::None;
+    m_coarse = DataTable::None;
+    QVector<RowChange> rows;
+    for (const RowChange &change : std::exchange(m_pendingRows, {})) {
+        if (!(coarse & change.table)) {
+            rows.append(change);
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    emit tablesChanged(changed);
+    if (!rows.isEmpty()) {
+        emit rowsChanged(rows);
+    }
+
+    // A refresh may subscribe or publish; walk a snapshot of the views
+    const QList<QObject *> views = m_subscribers.keys();
+    for (QObject *key : views) {
+        auto it = m_subscribers.find(key);
+        if (it == m_subscribers.end() || !it->view) {
+            continue;
+        }
+
+        const DataTables unseen = changed & ~it->acknowledged;
+        it->acknowledged = DataTable::None;
+        const DataTables relevant = it->tables & unseen;
+        if (!relevant) {
+            continue;
+        }
+
+        // Row-level only: patch in place, visible or not, unless the view
+        // is already waiting for a full refresh
+        if (it->patch && !(relevant & coarse) && !it->dirty) {
+            QVector<RowChange> mine;
+            for (const RowChange &change : rows) {
+                if (relevant & change.table) {
+                    mine.append(change);
+                }
+            }
+            const auto patch = it->patch;
+            if (patch(mine)) {
+                continue;
+            }
+            it = m_subscribers.find(key);
+            if (it == m_subscribers.end() || !it->view) {
+                continue;
+            }
+        }
+
+        if (isShown(it->view)) {
+            it->dirty = false;
+            runRefresh(it->view, it->refresh);
+        } else {
+            it->dirty = true;
+        }
+    }
+}
+
+bool DataChangeBus::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show) {
+        auto it = m_subscribers.find(watched);
+        if (it != m_subscribers.end() && it->dirty) {
+            it->dirty = false;
+            runRefresh(it->view, it->refresh);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+} // namespace Frontier
@@ -0,0 +1,139 @@
+/**
+ * @file datachangebus.h
+ * @brief Coalesces table-level change notices and refreshes views once per turn
+ */
+
+#ifndef DATACHANGEBUS_H
+#define DATACHANGEBUS_H
+
+#include <QObject>
+#include <QFlags>
+#include <QHash>
+#include <QPointer>
+#include <QVector>
+#include <functional>
+
+namespace Frontier {
+
+enum class DataTable {
+    None             = 0,
+    Items            = 1 << 0,
+    Transactions     = 1 << 1,
+    Vehicles         = 1 << 2,
+    FuelLog          = 1 << 3,
+    Movement         = 1 << 4,      // Sessions and equipment usage
+    Recipes          = 1 << 5,      // Workbenches, recipes and ingredients
+    Locations        = 1 << 6,      // Maps, location types and locations
+    Inventory        = 1 << 7,      // Inventory and oil tracking
+    Production       = 1 << 8,
+    Shifts           = 1 << 9,
+    CycleTimes       = 1 << 10,
+    Budgets          = 1 << 11,
+    Settings         = 1 << 12,
+    FactoryBuildings = 1 << 13,
+    CapitalPlan      = 1 << 14,     // Equipment and facility plans
+    All              = (1 << 15) - 1
+};
+Q_DECLARE_FLAGS(DataTables, DataTable)
+Q_DECLARE_OPERATORS_FOR_FLAGS(DataTables)
+
+/**
+ * @brief One row a write added, changed or removed, by id
+ */
+struct RowChange {
+    enum Kind { Inserted, Updated, Deleted };
+
+    DataTable table = DataTable::None;
+    Kind kind = Updated;
+    int id = 0;
+};
+
+/**
+ * @brief Central dirty-flag bus between database writes and views
+ *
+ * Database write methods publish the tables they touch. Publishes are
+ * accumulated and flushed once when control returns to the event loop, so
+ * an import or a multi-row edit produces one notice. At the flush every
+ * subscribed view whose tables overlap refreshes once if it is visible;
+ * a hidden view (for example on another tab) is only marked dirty and
+ * refreshes when it is next shown.
+ *
+ * Single-row writes publish a RowChange as well. A view that registers a
+ * row patcher is handed the changes for its tables instead of being
+ * refreshed, as long as every write to those tables since the last flush
+ * was a row change; a table-level publish, or a patcher returning false,
+ * falls back to the full refresh. Row changes reach hidden views too,
+ * so they stay current without a reload when next shown.
+ *
+ * Views are usually widgets, but the bus only needs a QObject: it reads
+ * the "visible" property (a view without one counts as visible) and
+ * watches for its Show event, so core does not link Qt Widgets.
+ *
+ * Subscriptions and flushes belong to the Database's thread; writes made
+ * on other threads are posted there before they publish.
+ */
+class DataChangeBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataChangeBus(QObject *parent = nullptr);
+
+    void publish(DataTables tables);
+    void publishRow(const RowChange &change);
+    DataTables pending() const { return m_pending; }
+
+    // Pending row changes for these tables no longer describe the data (a
+    // rolled-back transaction); subscribers get a full refresh instead
+    void demoteRows(DataTables tables);
+
+    // One subscription per view; subscribing again replaces it. Ends when
+    // the view is destroyed. loadWhenShown starts the view dirty, so its
+    // first load waits until it is first shown.
+    void subscribe(QObject *view, DataTables tables, std::function<void()> refresh,
+                   bool loadWhenShown = false);
+    void unsubscribe(QObject *view);
+
+    // Patches the view from row changes to its subscribed tables; returns
+    // false to have it refreshed instead. Kept when the view resubscribes.
+    void setRowPatcher(QObject *view, std::function<bool(const QVector<RowChange> &)> patch);
+
+    // For a view that already patched itself after its own write: skips
+    // its refresh for what is pending now, unless other tables change too
+    void acknowledge(QObject *view);
+
+signals:
+    // Emitted at each flush with everything published since the last one
+    void tablesChanged(Frontier::DataTables tables);
+    // Row changes in the flush, for tables with no table-level publish
+    void rowsChanged(const QVector<Frontier::RowChange> &changes);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void flush();
+
+private:
+    struct Subscriber {
+        QPointer<QObject> view;
+        DataTables tables;
+        std::function<void()> refresh;
+        std::function<bool(const QVector<RowChange> &)> patch;
+        DataTables acknowledged;
+        bool dirty = false;
+    };
+
+    QHash<QObject *, Subscriber> m_subscribers;
+    DataTables m_pending;
+    DataTables m_coarse;             // Pending tables with a table-level publish
+    QVector<RowChange> m_pendingRows;
+    bool m_flushQueued = false;
+};
+
+} // namespace Frontier
+
+Q_DECLARE_METATYPE(Frontier::DataTables)
+Q_DECLARE_METATYPE(Frontier::RowChange)
+
+#endif // DATACHANGEBUS_H
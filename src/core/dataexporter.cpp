@@ -0,0 +1,236 @@
+/**
+ * @file dataexporter.cpp
+ * @brief Streaming table export implementation
+ */
+
+#include "dataexporter.h"
+#include "database.h"
+#include "profiler.h"
+
+#include <QSaveFile>
+#include <QPointer>
+#include <QSqlField>
+#include <QSqlRecord>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace Frontier {
+
+namespace {
+
+QByteArray csvField(const QVariant &value)
+{
+    if (value.isNull()) {
+        return QByteArray();
+    }
+    QByteArray text = value.toString().toUtf8();
+    if (text.contains(',') || text.contains('"') || text.contains('\n') || text.contains('\r')) {
+        text.replace("\"", "\"\"");
+        text = '"' + text + '"';
+    }
+    return text;
+}
+
+/**
+ * @brief Formats rows into a buffer and writes it to the file in chunks
+ */
+class ChunkWriter
+{
+public:
+    ChunkWriter(QSaveFile &file, qint64 bufferBytes)
+        : m_file(file)
+        , m_bufferBytes(bufferBytes)
+    {
+        m_buffer.reserve(bufferBytes + 4096);
+    }
+
+    QByteArray &buffer() { return m_buffer; }
+
+    // Writes the buffer once it is full (or always, with force)
+    bool flush(bool force = false)
+    {
+        if (m_buffer.isEmpty() || (!force && m_buffer.size() < m_bufferBytes)) {
+            return true;
+        }
+        const bool ok = m_file.write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+        return ok;
+    }
+
+private:
+    QSaveFile &m_file;
+    QByteArray m_buffer;
+    qint64 m_bufferBytes;
+};
+
+} // namespace
+
+DataExporter::DataExporter(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+{
+    qRegisterMetaType<Frontier::ExportResult>();
+    connect(&m_watcher, &QFutureWatcher<ExportResult>::finished, this, &DataExporter::onFinished);
+}
+
+DataExporter::~DataExporter()
+{
+    // The export posts progress to this object; stop it before it goes
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+QString DataExporter::tableLabel(DataTable table)
+{
+    switch (table) {
+    case DataTable::Transactions: return "Transactions";
+    case DataTable::FuelLog:      return "Fuel Log";
+    case DataTable::Production:   return "Production Runs";
+    case DataTable::Shifts:       return "Shifts";
+    case DataTable::CycleTimes:   return "Cycle Records";
+    default:                      return QString();
+    }
+}
+
+bool DataExporter::start(const ExportRequest &request)
+{
+    if (isRunning()) {
+        qWarning() << "Export already running";
+        return false;
+    }
+
+    m_cancelled = std::make_shared<std::atomic_bool>(false);
+    Database *database = m_database;
+    const auto cancelled = m_cancelled;
+    QPointer<DataExporter> self(this);
+
+    m_watcher.setFuture(QtConcurrent::run([database, request, cancelled, self]() {
+        return exportTo(*database, request, *cancelled, [self](qint64 rows, qint64 total) {
+            QMetaObject::invokeMethod(self, [self, rows, total]() {
+                if (self) {
+                    emit self->progress(rows, total);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }));
+    return true;
+}
+
+void DataExporter::cancel()
+{
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+void DataExporter::onFinished()
+{
+    emit finished(m_watcher.result());
+}
+
+// =============================================================================
+// Export
+// =============================================================================
+
+ExportResult DataExporter::exportTo(Database &database, const ExportRequest &request,
+                                    const std::atomic_bool &cancelled,
+                                    const std::function<void(qint64, qint64)> &progress)
+{
+    ProfileScope scope("DataExporter::exportTo");
+    ExportResult result;
+    result.path = request.path;
+
+    QSaveFile file(request.path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    const qint64 total = progress ? database.countRowsInRange(request.table, request.from, request.to) : 0;
+    const bool json = request.format == ExportFormat::Json;
+    ChunkWriter writer(file, BufferBytes);
+    QByteArray &out = writer.buffer();
+    QStringList columns;
+    bool writeFailed = false;
+
+    if (json) {
+        out += "[";
+    }
+
+    const bool streamed = database.streamRows(request.table, request.from, request.to,
+                                              [&](const QSqlRecord &record) {
+        if (cancelled.load()) {
+            return false;
+        }
+
+        if (result.rows == 0) {
+            for (int i = 0; i < record.count(); ++i) {
+                columns.append(record.fieldName(i));
+            }
+            if (!json) {
+                out += columns.join(',').toUtf8();
+                out += '\n';
+            }
+        }
+
+        if (json) {
+            QJsonObject object;
+            for (int i = 0; i < columns.size(); ++i) {
+                object.insert(columns[i], QJsonValue::fromVariant(record.value(i)));
+            }
+            out += result.rows == 0 ? "\n  " : ",\n  ";
+            out += QJsonDocument(object).toJson(QJsonDocument::Compact);
+        } else {
+            for (int i = 0; i < columns.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                out += csvField(record.value(i));
+            }
+            out += '\n';
+        }
+
+        ++result.rows;
+        if (!writer.flush()) {
+            writeFailed = true;
+            return false;
+        }
+        if (progress && result.rows % ProgressRows == 0) {
+            progress(result.rows, qMax(total, result.rows));
+        }
+        return true;
+    });
+
+    if (json) {
+        out += result.rows == 0 ? "]\n" : "\n]\n";
+    }
+
+    if (cancelled.load()) {
+        file.cancelWriting();
+        result.cancelled = true;
+        result.error = "Cancelled";
+        return result;
+    }
+    if (!streamed || writeFailed || !writer.flush(true)) {
+        result.error = streamed && writeFailed ? file.errorString() : database.lastError();
+        if (result.error.isEmpty()) {
+            result.error = file.errorString();
+        }
+        file.cancelWriting();
+        return result;
+    }
+    if (!file.commit()) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    if (progress) {
+        progress(result.rows, result.rows);
+    }
+    result.ok = true;
+    return result;
+}
+
+} // namespace Frontier
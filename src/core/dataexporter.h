@@ -0,0 +1,98 @@
+/**
+ * @file dataexporter.h
+ * @brief Streams ledger and log tables to CSV or JSON files in the background
+ */
+
+#ifndef DATAEXPORTER_H
+#define DATAEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QDate>
+#include <QFutureWatcher>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "datachangebus.h"
+
+namespace Frontier {
+
+class Database;
+
+enum class ExportFormat {
+    Csv,
+    Json
+};
+
+struct ExportRequest {
+    DataTable table = DataTable::Transactions;  // See Database::streamRows()
+    QDate from;                                 // Invalid for no lower bound
+    QDate to;                                   // Invalid for no upper bound
+    QString path;
+    ExportFormat format = ExportFormat::Csv;
+};
+
+struct ExportResult {
+    bool ok = false;
+    bool cancelled = false;
+    QString path;
+    QString error;
+    qint64 rows = 0;
+};
+
+/**
+ * @brief Writes one table's rows to a file without loading them
+ *
+ * Rows come from Database::streamRows() and are formatted into a buffer
+ * that is written out every BufferBytes, so memory stays flat however
+ * many years are exported. CSV gets a header of column names; JSON is
+ * an array of one object per row, written as it goes. Columns are the
+ * table's own, with values as stored.
+ *
+ * start() runs the export on the global thread pool, which reaches the
+ * database through that thread's own connection, and reports progress
+ * every ProgressRows rows. exportTo() is the same on the calling thread.
+ * The file is replaced only when the export completes.
+ */
+class DataExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataExporter(Database *database, QObject *parent = nullptr);
+    ~DataExporter();
+
+    // False when an export is already running
+    bool start(const ExportRequest &request);
+    void cancel();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    // progress(rows, total) is called from the exporting thread
+    static ExportResult exportTo(Database &database, const ExportRequest &request,
+                                 const std::atomic_bool &cancelled,
+                                 const std::function<void(qint64, qint64)> &progress = {});
+
+    static QString tableLabel(DataTable table);
+
+signals:
+    void progress(qint64 rows, qint64 total);
+    void finished(const Frontier::ExportResult &result);
+
+private slots:
+    void onFinished();
+
+private:
+    Database *m_database;
+    QFutureWatcher<ExportResult> m_watcher;
+    std::shared_ptr<std::atomic_bool> m_cancelled;
+
+    static constexpr qint64 BufferBytes = 256 * 1024;
+    static constexpr qint64 ProgressRows = 2000;
+};
+
+} // namespace Frontier
+
+Q_DECLARE_METATYPE(Frontier::ExportResult)
+
+#endif // DATAEXPORTER_H
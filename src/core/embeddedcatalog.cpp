@@ -0,0 +1,175 @@
+/**
+ * @file embeddedcatalog.cpp
+ * @brief Seeding from the compiled-in reference tables
+ */
+
+#include "embeddedcatalog.h"
+#include "database.h"
+#include "itemimporter.h"
+#include "vehicleimporter.h"
+#include "factorybuildingimporter.h"
+#include "profiler.h"
+
+#include <QDebug>
+#include <utility>
+
+namespace Frontier {
+
+namespace {
+
+// Keys of Database::referenceSource(), named after the tables
+const char *const ItemsSet = "items";
+const char *const VehiclesSet = "vehicles";
+const char *const BuildingsSet = "factory_buildings";
+
+QString text(const char *utf8)
+{
+    return QString::fromUtf8(utf8);
+}
+
+} // namespace
+
+// =============================================================================
+// Tables
+// =============================================================================
+
+QVector<Item> EmbeddedCatalog::items(const EmbeddedCatalogData &data)
+{
+    QVector<Item> items;
+    items.reserve(data.itemCount);
+    for (int i = 0; i < data.itemCount; ++i) {
+        const EmbeddedItem &row = data.items[i];
+        Item item;
+        item.code = text(row.code);
+        item.name = text(row.name);
+        item.categoryMain = text(row.categoryMain);
+        item.categorySub = text(row.categorySub);
+        item.buyPriceInternal = row.buyPriceInternal;
+        item.buyPriceDisplay = row.buyPriceDisplay;
+        item.sellPriceInternal = row.sellPriceInternal;
+        item.sellPriceDisplay = row.sellPriceDisplay;
+        item.weight = row.weight;
+        item.pricingGroup = row.pricingGroup;
+        item.isPurchasable = row.isPurchasable;
+        item.isSellable = row.isSellable;
+        item.isCraftable = row.isCraftable;
+        item.notes = text(row.notes);
+        items.append(item);
+    }
+    return items;
+}
+
+QVector<Vehicle> EmbeddedCatalog::vehicles(const EmbeddedCatalogData &data)
+{
+    QVector<Vehicle> vehicles;
+    vehicles.reserve(data.vehicleCount);
+    for (int i = 0; i < data.vehicleCount; ++i) {
+        const EmbeddedVehicle &row = data.vehicles[i];
+        Vehicle vehicle;
+        vehicle.id = text(row.id);
+        vehicle.name = text(row.name);
+        vehicle.categoryMain = text(row.categoryMain);
+        vehicle.categorySub = text(row.categorySub);
+        vehicle.bucketCapacityM3 = row.bucketCapacityM3;
+        vehicle.truckCapacityM3 = row.truckCapacityM3;
+        vehicle.tankCapacityL = row.tankCapacityL;
+        vehicle.fuelUseLPerHour = row.fuelUseLPerHour;
+        vehicle.purchasePrice = row.purchasePrice;
+        vehicle.active = row.active;
+        vehicle.notes = text(row.notes);
+        vehicles.append(vehicle);
+    }
+    return vehicles;
+}
+
+QVector<FactoryBuilding> EmbeddedCatalog::buildings(const EmbeddedCatalogData &data)
+{
+    QVector<FactoryBuilding> buildings;
+    buildings.reserve(data.buildingCount);
+    for (int i = 0; i < data.buildingCount; ++i) {
+        const EmbeddedBuilding &row = data.buildings[i];
+        FactoryBuilding building;
+        building.name = text(row.name);
+        building.category = text(row.category);
+        building.dimensions = text(row.dimensions);
+        building.speed = text(row.speed);
+        building.powerKw = row.powerKw;
+        building.generatedKw = row.generatedKw;
+        building.capacity = row.capacity;
+        building.connections = row.connections;
+        building.price = row.price;
+        building.notes = text(row.notes);
+        buildings.append(building);
+    }
+    return buildings;
+}
+
+// =============================================================================
+// Seeding
+// =============================================================================
+
+std::optional<EmbeddedCatalog::SeedResult> EmbeddedCatalog::seedEmpty(const EmbeddedCatalogData &data,
+                                                                      Database *database)
+{
+    ProfileScope scope("EmbeddedCatalog::seedEmpty");
+    SeedResult result;
+    const bool seedItems = data.itemCount > 0 && database->getItemCount() == 0;
+    const bool seedVehicles = data.vehicleCount > 0 && VehicleImporter::getVehicleCount(database) == 0;
+    const bool seedBuildings = data.buildingCount > 0 && database->getAllFactoryBuildings().isEmpty();
+    if (!seedItems && !seedVehicles && !seedBuildings) {
+        return result;
+    }
+
+    if (!database->beginTransaction()) {
+        return std::nullopt;
+    }
+
+    bool ok = true;
+    if (seedItems) {
+        result.items = ItemImporter::importItems(items(data), database);
+        ok = result.items >= 0
+             && database->setReferenceSource(ItemsSet, QByteArray::fromHex(data.itemsChecksum));
+    }
+    if (ok && seedVehicles) {
+        result.vehicles = VehicleImporter::importVehicles(vehicles(data), database, false);
+        ok = result.vehicles >= 0
+             && database->setReferenceSource(VehiclesSet, QByteArray::fromHex(data.vehiclesChecksum));
+    }
+    if (ok && seedBuildings) {
+        result.buildings = FactoryBuildingImporter::upsertBuildings(buildings(data), database);
+        ok = result.buildings >= 0
+             && database->setReferenceSource(BuildingsSet, QByteArray::fromHex(data.buildingsChecksum));
+    }
+
+    if (!ok || !database->commitTransaction()) {
+        qWarning() << "Failed to seed the built-in reference data:" << database->lastError();
+        database->rollbackTransaction();
+        return std::nullopt;
+    }
+
+    // As after an import: the next start maps the items, and an import of
+    // the same items file is recognised as unchanged
+    if (seedItems) {
+        database->writeReferenceSnapshot(QByteArray::fromHex(data.itemsChecksum));
+    }
+    return result;
+}
+
+QStringList EmbeddedCatalog::drift(const EmbeddedCatalogData &data, Database *database)
+{
+    QStringList drifted;
+    const std::pair<const char *, const char *> sets[] = {
+        {ItemsSet, data.itemsChecksum},
+        {VehiclesSet, data.vehiclesChecksum},
+        {BuildingsSet, data.buildingsChecksum},
+    };
+    for (const auto &[set, checksum] : sets) {
+        const QByteArray recorded = database->referenceSource(set);
+        if (!recorded.isEmpty() && recorded != QByteArray::fromHex(checksum)) {
+            drifted << set;
+        }
+    }
+    return drifted;
+}
+
+} // namespace Frontier
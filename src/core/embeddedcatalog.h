@@ -0,0 +1,121 @@
+/**
+ * @file embeddedcatalog.h
+ * @brief Default reference data compiled into the application
+ */
+
+#ifndef EMBEDDEDCATALOG_H
+#define EMBEDDEDCATALOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <optional>
+
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+// === Generated Tables ===
+// Plain aggregates of literals, so the generated source is constant data
+// with no initialisation code. Strings are UTF-8; checksums are the hex
+// SHA-1 of the JSON file each table was generated from.
+
+struct EmbeddedItem {
+    const char *code;               // Empty: generated on insert, as by an import
+    const char *name;
+    const char *categoryMain;
+    const char *categorySub;
+    double buyPriceInternal;
+    double buyPriceDisplay;
+    double sellPriceInternal;
+    double sellPriceDisplay;
+    double weight;
+    PricingGroup pricingGroup;
+    bool isPurchasable;
+    bool isSellable;
+    bool isCraftable;
+    const char *notes;
+};
+
+struct EmbeddedVehicle {
+    const char *id;
+    const char *name;
+    const char *categoryMain;
+    const char *categorySub;
+    double bucketCapacityM3;
+    double truckCapacityM3;
+    double tankCapacityL;
+    double fuelUseLPerHour;
+    double purchasePrice;
+    bool active;
+    const char *notes;
+};
+
+struct EmbeddedBuilding {
+    const char *name;
+    const char *category;
+    const char *dimensions;
+    const char *speed;
+    double powerKw;
+    double generatedKw;
+    double capacity;
+    int connections;
+    double price;
+    const char *notes;
+};
+
+struct EmbeddedCatalogData {
+    const EmbeddedItem *items;
+    int itemCount;
+    const char *itemsChecksum;
+    const EmbeddedVehicle *vehicles;
+    int vehicleCount;
+    const char *vehiclesChecksum;
+    const EmbeddedBuilding *buildings;
+    int buildingCount;
+    const char *buildingsChecksum;
+};
+
+// The tables generated from data/ at build time (tools/catalogen); only
+// defined in targets built with FRONTIER_EMBEDDED_CATALOG
+const EmbeddedCatalogData &defaultCatalogData();
+
+/**
+ * @brief Seeds a new database from compiled-in reference data
+ *
+ * A fresh install has items, vehicles and factory buildings from the
+ * first start instead of after three imports. The rows go through the
+ * importers' write paths, so a seeded table matches one imported from the
+ * same files; nothing is parsed. Each data set seeded records its
+ * checksum in the file (Database::setReferenceSource), and an import of
+ * that set forgets it, so drift() can tell a later build's different data
+ * apart from the user's own imports.
+ */
+class EmbeddedCatalog
+{
+public:
+    struct SeedResult {
+        int items = 0;              // Rows written; 0 when the table had rows
+        int vehicles = 0;
+        int buildings = 0;
+        bool seededAnything() const { return items > 0 || vehicles > 0 || buildings > 0; }
+    };
+
+    // Fills whichever of items, vehicles and factory_buildings are empty,
+    // in one transaction; nullopt with Database::lastError() on failure
+    static std::optional<SeedResult> seedEmpty(const EmbeddedCatalogData &data, Database *database);
+
+    // Data sets seeded from built-in data other than data's ("items",
+    // "vehicles", "factory_buildings"); empty when nothing has drifted
+    static QStringList drift(const EmbeddedCatalogData &data, Database *database);
+
+    static QVector<Item> items(const EmbeddedCatalogData &data);
+    static QVector<Vehicle> vehicles(const EmbeddedCatalogData &data);
+    static QVector<FactoryBuilding> buildings(const EmbeddedCatalogData &data);
+};
+
+} // namespace Frontier
+
+#endif // EMBEDDEDCATALOG_H
@@ -0,0 +1,218 @@
+/**
+ * @file facilitysimulator.cpp
+ * @brief Facility plan simulation implementation
+ */
+
+#include "facilitysimulator.h"
+
+#include <QRegularExpression>
+#include <limits>
+
+namespace Frontier {
+
+// =============================================================================
+// Compile
+// =============================================================================
+
+double FacilitySimulator::parseSpeed(const QString &speed)
+{
+    static const QRegularExpression number(R"(^\s*(\d+(?:\.\d+)?))");
+    const QRegularExpressionMatch match = number.match(speed);
+    return match.hasMatch() ? match.captured(1).toDouble() : 0.0;
+}
+
+void FacilitySimulator::compile(const QVector<FactoryBuilding> &buildings, const QVector<Recipe> &recipes)
+{
+    m_slotById.clear();
+    m_names.clear();
+    m_kinds.clear();
+    m_powerKw.clear();
+    m_generatedKw.clear();
+    m_capacityKw.clear();
+    m_speed.clear();
+    m_recipeOffsets.clear();
+    m_recipes.clear();
+
+    // Recipes grouped by the workbench that makes them
+    QHash<QString, QVector<CompiledRecipe>> byWorkbench;
+    for (const Recipe &recipe : recipes) {
+        CompiledRecipe compiled;
+        compiled.id = recipe.id.value_or(0);
+        compiled.outputItem = recipe.outputItem;
+        compiled.outputQty = qMax(1, recipe.outputQty);
+        for (const RecipeIngredient &ingredient : recipe.ingredients) {
+            compiled.inputQty += ingredient.quantity;
+        }
+        byWorkbench[recipe.workbenchName.toLower()].append(compiled);
+    }
+
+    const int count = buildings.size();
+    m_names.reserve(count);
+    m_kinds.reserve(count);
+    m_powerKw.reserve(count);
+    m_generatedKw.reserve(count);
+    m_capacityKw.reserve(count);
+    m_speed.reserve(count);
+    m_recipeOffsets.reserve(count + 1);
+    m_recipeOffsets.append(0);
+
+    for (const FactoryBuilding &building : buildings) {
+        Kind kind = Kind::Other;
+        if (building.category.endsWith("Conveyors")) {
+            kind = Kind::Conveyor;
+        } else if (building.category.endsWith("Pipeline")) {
+            kind = Kind::Pipeline;
+        } else if (building.category.endsWith("Power")) {
+            kind = Kind::Power;
+        } else if (building.category.endsWith("Production")) {
+            kind = Kind::Production;
+        }
+
+        m_slotById.insert(building.id.value_or(0), m_names.size());
+        m_names.append(building.name);
+        m_kinds.append(kind);
+        m_powerKw.append(building.powerKw);
+        m_generatedKw.append(building.generatedKw);
+        m_capacityKw.append(kind == Kind::Power ? building.capacity : 0.0);
+        m_speed.append(parseSpeed(building.speed));
+
+        if (kind == Kind::Production) {
+            m_recipes += byWorkbench.value(building.name.toLower());
+        }
+        m_recipeOffsets.append(m_recipes.size());
+    }
+}
+
+const FacilitySimulator::CompiledRecipe *FacilitySimulator::recipeFor(int slot, int buildingId,
+                                                                     const SimulationOptions &options) const
+{
+    const int begin = m_recipeOffsets[slot];
+    const int end = m_recipeOffsets[slot + 1];
+    if (begin == end) {
+        return nullptr;
+    }
+
+    auto chosen = options.recipeForBuilding.constFind(buildingId);
+    if (chosen != options.recipeForBuilding.constEnd()) {
+        for (int r = begin; r < end; ++r) {
+            if (m_recipes[r].id == chosen.value()) {
+                return &m_recipes[r];
+            }
+        }
+    }
+    return &m_recipes[begin];
+}
+
+// =============================================================================
+// Simulate
+// =============================================================================
+
+FacilitySimulation FacilitySimulator::simulate(const QVector<FacilityPlanItem> &plan,
+                                               const SimulationOptions &options) const
+{
+    FacilitySimulation sim;
+
+    constexpr double NoSegment = std::numeric_limits<double>::max();
+    const double spacing = options.itemSpacingM > 0 ? options.itemSpacingM : 1.0;
+    double slowestConveyor = NoSegment;
+    double slowestPipeline = NoSegment;
+
+    struct Producer {
+        int line;
+        const CompiledRecipe *recipe;
+        bool piped;
+    };
+    QVector<Producer> producers;
+
+    // === Power and transport capacity ===
+    for (int i = 0; i < plan.size(); ++i) {
+        const FacilityPlanItem &line = plan[i];
+        const int slot = slotOf(line.buildingId);
+        if (slot < 0) {
+            sim.demandKw += line.unitPowerKw * line.quantity;
+            sim.generatedKw += line.unitGeneratedKw * line.quantity;
+            continue;
+        }
+
+        sim.demandKw += m_powerKw[slot] * line.quantity;
+        sim.generatedKw += m_generatedKw[slot] * line.quantity;
+
+        switch (m_kinds[slot]) {
+        case Kind::Conveyor:
+        case Kind::Pipeline: {
+            if (m_speed[slot] <= 0) {
+                break;
+            }
+            const double perHour = m_speed[slot] / spacing * 3600.0;
+            const bool pipe = m_kinds[slot] == Kind::Pipeline;
+            double &slowest = pipe ? slowestPipeline : slowestConveyor;
+            if (perHour < slowest) {
+                slowest = perHour;
+                (pipe ? sim.pipelines : sim.conveyors).slowestSegment = m_names[slot];
+            }
+            break;
+        }
+        case Kind::Power:
+            sim.transmissionKw += m_capacityKw[slot] * line.quantity;
+            break;
+        case Kind::Production:
+            producers.append({i, recipeFor(slot, line.buildingId, options),
+                              options.pipedBuildings.contains(line.buildingId)});
+            break;
+        case Kind::Other:
+            break;
+        }
+    }
+
+    sim.conveyors.capacityPerHour = slowestConveyor == NoSegment ? 0.0 : slowestConveyor;
+    sim.pipelines.capacityPerHour = slowestPipeline == NoSegment ? 0.0 : slowestPipeline;
+
+    double supplyKw = sim.generatedKw;
+    if (sim.transmissionKw > 0) {
+        supplyKw = qMin(supplyKw, sim.transmissionKw);
+    }
+    if (sim.demandKw > 0) {
+        sim.powerFactor = qMin(1.0, supplyKw / sim.demandKw);
+    }
+
+    // === Flow at full power ===
+    const double fullCyclesPerHour = options.cycleSeconds > 0 ? 3600.0 / options.cycleSeconds : 0.0;
+    for (const Producer &producer : producers) {
+        if (!producer.recipe) {
+            continue;
+        }
+        const double flow = plan[producer.line].quantity * fullCyclesPerHour
+                            * (producer.recipe->inputQty + producer.recipe->outputQty);
+        (producer.piped ? sim.pipelines : sim.conveyors).demandPerHour += flow;
+    }
+
+    // === Output under the tightest limit ===
+    sim.runFactor = sim.powerFactor;
+    sim.production.reserve(producers.size());
+    for (const Producer &producer : producers) {
+        const FacilityPlanItem &line = plan[producer.line];
+
+        ProductionRate rate;
+        rate.buildingId = line.buildingId;
+        rate.buildingName = line.buildingName;
+        rate.buildings = line.quantity;
+
+        if (producer.recipe) {
+            const ThroughputLimit &network = producer.piped ? sim.pipelines : sim.conveyors;
+            const double factor = qMin(sim.powerFactor, network.factor());
+            sim.runFactor = qMin(sim.runFactor, factor);
+
+            rate.recipeId = producer.recipe->id;
+            rate.outputItem = producer.recipe->outputItem;
+            rate.cyclesPerHour = fullCyclesPerHour * factor;
+            rate.inputPerHour = rate.cyclesPerHour * line.quantity * producer.recipe->inputQty;
+            rate.outputPerHour = rate.cyclesPerHour * line.quantity * producer.recipe->outputQty;
+            sim.outputPerHour[rate.outputItem] += rate.outputPerHour;
+        }
+        sim.production.append(rate);
+    }
+
+    return sim;
+}
+
+} // namespace Frontier
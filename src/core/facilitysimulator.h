@@ -0,0 +1,125 @@
+/**
+ * @file facilitysimulator.h
+ * @brief Steady-state power and throughput model of a facility plan
+ */
+
+#ifndef FACILITYSIMULATOR_H
+#define FACILITYSIMULATOR_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QMap>
+
+#include "types.h"
+
+namespace Frontier {
+
+struct SimulationOptions {
+    double itemSpacingM = 1.0;      // Gap between items on a belt or pipe
+    double cycleSeconds = 60.0;     // One recipe cycle on a production building
+    QHash<int, int> recipeForBuilding;  // Building id -> recipe id; default is the first recipe of its workbench
+    QSet<int> pipedBuildings;       // Production buildings whose flow goes through pipelines
+};
+
+/**
+ * @brief Capacity of one transport network against the flow it must carry
+ *
+ * Segments are assumed to run in series, so the slowest planned segment
+ * type bounds the whole network.
+ */
+struct ThroughputLimit {
+    QString slowestSegment;         // Empty when no segments are planned
+    double capacityPerHour = 0.0;   // Items per hour; 0 when no segments are planned
+    double demandPerHour = 0.0;     // Flow at full power
+
+    bool isBottleneck() const { return capacityPerHour > 0 && demandPerHour > capacityPerHour; }
+    double factor() const {
+        return isBottleneck() ? capacityPerHour / demandPerHour : 1.0;
+    }
+};
+
+struct ProductionRate {
+    int buildingId = 0;
+    QString buildingName;
+    int buildings = 0;
+    int recipeId = 0;               // 0 when the building has no recipe
+    QString outputItem;
+    double cyclesPerHour = 0.0;     // Per building, after power and transport limits
+    double inputPerHour = 0.0;
+    double outputPerHour = 0.0;
+};
+
+struct FacilitySimulation {
+    double demandKw = 0.0;
+    double generatedKw = 0.0;
+    double transmissionKw = 0.0;    // Pylon capacity; 0 when no pylons are planned
+    double powerFactor = 1.0;       // Share of demand that can be delivered
+
+    ThroughputLimit conveyors;
+    ThroughputLimit pipelines;
+    double runFactor = 1.0;         // Speed production runs at: min of power and transport
+
+    QVector<ProductionRate> production;
+    QMap<QString, double> outputPerHour;    // Item -> units per hour over the layout
+
+    double powerBalanceKw() const { return generatedKw - demandKw; }
+    bool transmissionLimited() const { return transmissionKw > 0 && transmissionKw < qMin(demandKw, generatedKw); }
+};
+
+/**
+ * @brief Runs a facility plan against precompiled building and recipe arrays
+ *
+ * compile() flattens the building catalog into parallel arrays indexed by
+ * a dense building slot, and links each production building to the
+ * recipes of the workbench with the same name. simulate() then only walks
+ * the plan lines, so it is cheap enough to run on every plan edit.
+ *
+ * The model is steady state: supply short of demand slows every consumer
+ * by the same factor, transport networks cap the item flow, and
+ * production runs at the tightest of those limits. Plan lines whose
+ * building is not in the compiled catalog still count toward power using
+ * the unit values on the line.
+ */
+class FacilitySimulator
+{
+public:
+    void compile(const QVector<FactoryBuilding> &buildings, const QVector<Recipe> &recipes);
+    bool isCompiled() const { return !m_names.isEmpty(); }
+
+    FacilitySimulation simulate(const QVector<FacilityPlanItem> &plan,
+                                const SimulationOptions &options = SimulationOptions()) const;
+
+    // Leading number of a speed string such as "30 M/s"; 0 if none
+    static double parseSpeed(const QString &speed);
+
+private:
+    enum class Kind : quint8 { Other, Conveyor, Pipeline, Power, Production };
+
+    struct CompiledRecipe {
+        int id = 0;
+        QString outputItem;
+        int outputQty = 1;
+        int inputQty = 0;           // Sum over ingredients
+    };
+
+    int slotOf(int buildingId) const { return m_slotById.value(buildingId, -1); }
+    const CompiledRecipe *recipeFor(int slot, int buildingId, const SimulationOptions &options) const;
+
+    QHash<int, int> m_slotById;
+    QVector<QString> m_names;
+    QVector<Kind> m_kinds;
+    QVector<double> m_powerKw;
+    QVector<double> m_generatedKw;
+    QVector<double> m_capacityKw;
+    QVector<double> m_speed;        // Metres per second
+
+    // Recipes of slot s are m_recipes[m_recipeOffsets[s] .. m_recipeOffsets[s + 1])
+    QVector<int> m_recipeOffsets;
+    QVector<CompiledRecipe> m_recipes;
+};
+
+} // namespace Frontier
+
+#endif // FACILITYSIMULATOR_H
@@ -0,0 +1,97 @@
+/**
+ * @file factorybuildingimporter.cpp
+ * @brief Factory building import utility implementation
+ */
+
+#include "factorybuildingimporter.h"
+#include "database.h"
+#include "jsonstreamreader.h"
+#include "tracing.h"
+
+#include <QJsonObject>
+#include <QHash>
+#include <QDebug>
+
+namespace Frontier {
+
+QVector<FactoryBuilding> FactoryBuildingImporter::loadFromJson(const QString &jsonPath,
+                                                               QString *error, int *skipped)
+{
+    FRONTIER_TRACE_SCOPE("FactoryBuildingImporter::loadFromJson");
+    QVector<FactoryBuilding> buildings;
+
+    JsonStreamReader reader(jsonPath);
+    bool ok = reader.readArray([&](const QJsonObject &obj) {
+        FactoryBuilding building;
+        building.name = obj["name"].toString();
+        building.category = obj["category"].toString();
+        building.dimensions = obj["dimensions"].toString();
+        building.speed = obj["speed"].toString();
+
+        // Null values read as 0
+        building.powerKw = obj["power_kw"].toDouble();
+        building.generatedKw = obj["generated_kw"].toDouble();
+        building.capacity = obj["capacity"].toDouble();
+        building.connections = obj["connections"].toInt();
+        building.price = obj["price"].toDouble();
+
+        if (building.name.isEmpty()) {
+            if (skipped) {
+                ++*skipped;
+            }
+        } else {
+            buildings.append(building);
+        }
+        return true;
+    });
+
+    if (!ok) {
+        if (error) {
+            *error = reader.errorString();
+        }
+        return {};
+    }
+
+    return buildings;
+}
+
+int FactoryBuildingImporter::upsertBuildings(const QVector<FactoryBuilding> &buildings,
+                                             Database *database)
+{
+    FRONTIER_TRACE_SCOPE("FactoryBuildingImporter::upsertBuildings");
+    QHash<QString, int> existing;
+    for (const auto &building : database->getAllFactoryBuildings()) {
+        existing.insert(building.name, building.id.value_or(-1));
+    }
+
+    if (!database->beginTransaction()) {
+        return -1;
+    }
+
+    int written = 0;
+    for (FactoryBuilding building : buildings) {
+        auto it = existing.constFind(building.name);
+        bool ok;
+        if (it != existing.constEnd()) {
+            building.id = it.value();
+            ok = database->updateFactoryBuilding(building);
+        } else {
+            ok = database->addFactoryBuilding(building) > 0;
+        }
+
+        if (ok) {
+            ++written;
+        } else {
+            qWarning() << "Failed to import factory building:" << building.name;
+        }
+    }
+
+    if (!database->commitTransaction()) {
+        database->rollbackTransaction();
+        return -1;
+    }
+
+    return written;
+}
+
+} // namespace Frontier
@@ -0,0 +1,40 @@
+/**
+ * @file factorybuildingimporter.h
+ * @brief Factory building import utility for JSON files
+ */
+
+#ifndef FACTORYBUILDINGIMPORTER_H
+#define FACTORYBUILDINGIMPORTER_H
+
+#include <QString>
+#include <QVector>
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+class FactoryBuildingImporter
+{
+public:
+    /**
+     * @brief Load buildings from a JSON array without touching the database
+     * @param jsonPath Path to factory_buildings.json
+     * @param error Set when the file cannot be read
+     * @param skipped Incremented for each record without a name
+     * @return Loaded buildings; empty on error
+     */
+    static QVector<FactoryBuilding> loadFromJson(const QString &jsonPath,
+                                                 QString *error = nullptr,
+                                                 int *skipped = nullptr);
+
+    /**
+     * @brief Insert new buildings and update existing ones by name, in one transaction
+     * @return Number of buildings written, or -1 on error
+     */
+    static int upsertBuildings(const QVector<FactoryBuilding> &buildings, Database *database);
+};
+
+} // namespace Frontier
+
+#endif // FACTORYBUILDINGIMPORTER_H
@@ -0,0 +1,208 @@
+/**
+ * @file fleetsizer.cpp
+ * @brief Fleet sizing implementation
+ */
+
+#include "fleetsizer.h"
+
+#include <cmath>
+
+namespace Frontier {
+
+// =============================================================================
+// Compile
+// =============================================================================
+
+void FleetSizer::compile(const QVector<CycleProfile> &profiles, const QVector<Vehicle> &vehicles)
+{
+    m_routeIds.clear();
+    m_routeNames.clear();
+    m_avgSeconds.clear();
+    m_p50Seconds.clear();
+    m_p90Seconds.clear();
+    m_loadPhaseSeconds.clear();
+    m_routeTruck.clear();
+    m_loaderIds.clear();
+    m_loaderNames.clear();
+    m_bucketM3.clear();
+    m_loaderFuelLPerHour.clear();
+    m_loaderSlotById.clear();
+    m_truckIds.clear();
+    m_truckNames.clear();
+    m_truckM3.clear();
+    m_truckFuelLPerHour.clear();
+
+    // A machine with both capacities (a tool carrier) can fill either role
+    QHash<QString, int> truckSlotByName;
+    for (const Vehicle &vehicle : vehicles) {
+        if (!vehicle.active) {
+            continue;
+        }
+        if (vehicle.bucketCapacityM3 > 0) {
+            m_loaderSlotById.insert(vehicle.id, m_loaderIds.size());
+            m_loaderIds.append(vehicle.id);
+            m_loaderNames.append(vehicle.name);
+            m_bucketM3.append(vehicle.bucketCapacityM3);
+            m_loaderFuelLPerHour.append(vehicle.fuelUseLPerHour);
+        }
+        if (vehicle.truckCapacityM3 > 0) {
+            truckSlotByName.insert(vehicle.name.toLower(), m_truckIds.size());
+            m_truckIds.append(vehicle.id);
+            m_truckNames.append(vehicle.name);
+            m_truckM3.append(vehicle.truckCapacityM3);
+            m_truckFuelLPerHour.append(vehicle.fuelUseLPerHour);
+        }
+    }
+
+    const int count = profiles.size();
+    m_routeIds.reserve(count);
+    m_routeNames.reserve(count);
+    m_avgSeconds.reserve(count);
+    m_p50Seconds.reserve(count);
+    m_p90Seconds.reserve(count);
+    m_loadPhaseSeconds.reserve(count);
+    m_routeTruck.reserve(count);
+
+    for (const CycleProfile &profile : profiles) {
+        const bool timed = profile.recordCount > 0;
+        m_routeIds.append(profile.id.value_or(0));
+        m_routeNames.append(profile.name);
+        m_avgSeconds.append(timed ? profile.avgTotalSeconds : 0);
+        m_p50Seconds.append(timed ? profile.p50TotalSeconds : 0);
+        m_p90Seconds.append(timed ? profile.p90TotalSeconds : 0);
+        m_loadPhaseSeconds.append(timed ? profile.avgLoadSeconds : 0);
+        m_routeTruck.append(truckSlotByName.value(profile.vehicleName.toLower(), -1));
+    }
+}
+
+// =============================================================================
+// Sizing
+// =============================================================================
+
+double FleetSizer::basisSeconds(int route, CycleBasis basis) const
+{
+    switch (basis) {
+    case CycleBasis::Median: return m_p50Seconds[route];
+    case CycleBasis::P90:    return m_p90Seconds[route];
+    case CycleBasis::Average:
+    default:                 return m_avgSeconds[route];
+    }
+}
+
+bool FleetSizer::prepare(int route, int loader, int truck, const FleetOptions &options, Cost *cost) const
+{
+    if (route < 0 || route >= m_routeNames.size() || loader < 0 || loader >= m_loaderIds.size()
+        || truck < 0 || truck >= m_truckIds.size()) {
+        return false;
+    }
+
+    cost->payload = m_truckM3[truck] * options.fillFactor;
+    if (cost->payload <= 0 || options.loaderPassSeconds <= 0) {
+        return false;
+    }
+    cost->passes = std::ceil(cost->payload / m_bucketM3[loader] - 1e-9);
+    cost->loadSeconds = qMax(1.0, cost->passes) * options.loaderPassSeconds;
+
+    // The timed cycle was loaded by whatever loader was there; only its
+    // haul, dump and return carry over to another loader
+    const double timed = basisSeconds(route, options.basis);
+    const double travel = timed > 0 ? timed - m_loadPhaseSeconds[route]
+                                    : options.truckCycleSeconds - cost->loadSeconds;
+    cost->cycleSeconds = cost->loadSeconds + qMax(0.0, travel);
+
+    if (options.fuelPricePerLiter > 0) {
+        cost->loaderCost = m_loaderFuelLPerHour[loader] * options.fuelPricePerLiter;
+        cost->truckCost = m_truckFuelLPerHour[truck] * options.fuelPricePerLiter;
+    } else {
+        cost->loaderCost = 1.0;
+        cost->truckCost = 1.0;
+    }
+    return true;
+}
+
+FleetPlan FleetSizer::evaluate(int route, int loader, int truck, int trucks, const FleetOptions &options) const
+{
+    FleetPlan plan;
+    Cost cost;
+    if (!prepare(route, loader, truck, options, &cost) || trucks <= 0) {
+        return plan;
+    }
+
+    plan.profileId = m_routeIds[route];
+    plan.routeName = m_routeNames[route];
+    plan.loaderId = m_loaderIds[loader];
+    plan.loaderName = m_loaderNames[loader];
+    plan.truckId = m_truckIds[truck];
+    plan.truckName = m_truckNames[truck];
+
+    plan.trucks = trucks;
+    plan.passes = int(cost.passes);
+    plan.saturatingTrucks = int(std::ceil(cost.cycleSeconds / cost.loadSeconds - 1e-9));
+    plan.payloadM3 = cost.payload;
+    plan.loadSeconds = cost.loadSeconds;
+    plan.cycleSeconds = cost.cycleSeconds;
+    plan.matchFactor = trucks * cost.loadSeconds / cost.cycleSeconds;
+    plan.m3PerHour = qMin(trucks * cost.payload * 3600.0 / cost.cycleSeconds,
+                          cost.payload * 3600.0 / cost.loadSeconds);
+    plan.costPerHour = cost.loaderCost + trucks * cost.truckCost;
+    plan.costPerM3 = plan.m3PerHour > 0 ? plan.costPerHour / plan.m3PerHour : 0.0;
+    return plan;
+}
+
+QVector<FleetPlan> FleetSizer::optimize(const FleetOptions &options) const
+{
+    QVector<FleetPlan> plans;
+    const int maxTrucks = qMax(1, options.maxTrucks);
+
+    int firstLoader = 0;
+    int lastLoader = m_loaderIds.size();
+    if (!options.loaderId.isEmpty()) {
+        firstLoader = m_loaderSlotById.value(options.loaderId, -1);
+        if (firstLoader < 0) {
+            return plans;
+        }
+        lastLoader = firstLoader + 1;
+    }
+
+    plans.reserve(m_routeNames.size() * (lastLoader - firstLoader));
+    for (int route = 0; route < m_routeNames.size(); ++route) {
+        const int firstTruck = m_routeTruck[route] >= 0 ? m_routeTruck[route] : 0;
+        const int lastTruck = m_routeTruck[route] >= 0 ? firstTruck + 1 : m_truckIds.size();
+
+        for (int loader = firstLoader; loader < lastLoader; ++loader) {
+            int bestTruck = -1;
+            int bestCount = 0;
+            double bestCostPerM3 = 0;
+            double bestRate = 0;
+
+            for (int truck = firstTruck; truck < lastTruck; ++truck) {
+                Cost cost;
+                if (!prepare(route, loader, truck, options, &cost)) {
+                    continue;
+                }
+                const double perTruck = cost.payload * 3600.0 / cost.cycleSeconds;
+                const double loaderLimit = cost.payload * 3600.0 / cost.loadSeconds;
+
+                for (int n = 1; n <= maxTrucks; ++n) {
+                    const double rate = qMin(n * perTruck, loaderLimit);
+                    const double costPerM3 = (cost.loaderCost + n * cost.truckCost) / rate;
+                    // Cheaper per m³ wins, then more output; fewer trucks on a full tie
+                    if (bestTruck < 0 || costPerM3 < bestCostPerM3 - 1e-12
+                        || (costPerM3 <= bestCostPerM3 + 1e-12 && rate > bestRate + 1e-9)) {
+                        bestTruck = truck;
+                        bestCount = n;
+                        bestCostPerM3 = costPerM3;
+                        bestRate = rate;
+                    }
+                }
+            }
+
+            if (bestTruck >= 0) {
+                plans.append(evaluate(route, loader, bestTruck, bestCount, options));
+            }
+        }
+    }
+    return plans;
+}
+
+} // namespace Frontier
@@ -0,0 +1,131 @@
+/**
+ * @file fleetsizer.h
+ * @brief Truck count per loader and haul rate for each cycle profile
+ */
+
+#ifndef FLEETSIZER_H
+#define FLEETSIZER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "types.h"
+
+namespace Frontier {
+
+// Which of a profile's cycle statistics stands for one truck cycle
+enum class CycleBasis {
+    Average,
+    Median,
+    P90                             // Plans for the slow cycles
+};
+
+struct FleetOptions {
+    CycleBasis basis = CycleBasis::Average;
+    int maxTrucks = 12;             // Per loader
+    double loaderPassSeconds = 90;  // One bucket: dig, swing, dump (OperationsManager loader cycle)
+    double truckCycleSeconds = 360; // For profiles with no timed cycles (OperationsManager truck cycle)
+    double fillFactor = 1.0;        // Share of the truck's rated volume actually carried
+    double fuelPricePerLiter = 0;   // 0 ranks fleets by vehicle count instead of fuel cost
+    QString loaderId;               // Empty sweeps every loader
+};
+
+/**
+ * @brief One loader working one route with a number of identical trucks
+ */
+struct FleetPlan {
+    int profileId = 0;
+    QString routeName;
+    QString loaderId;
+    QString loaderName;
+    QString truckId;
+    QString truckName;
+
+    int trucks = 0;
+    int passes = 0;                 // Buckets per truck load
+    int saturatingTrucks = 0;       // Fewest trucks that keep the loader busy
+    double payloadM3 = 0;
+    double loadSeconds = 0;         // Loader time per truck
+    double cycleSeconds = 0;        // One truck's full cycle
+    double m3PerHour = 0;
+    double matchFactor = 0;         // Truck arrivals against loader capacity; 1 is balanced
+    double costPerHour = 0;         // Fuel, or vehicle count without a fuel price
+    double costPerM3 = 0;
+
+    double loaderUtilisation() const { return qMin(1.0, matchFactor); }
+    double truckUtilisation() const { return matchFactor > 0 ? qMin(1.0, 1.0 / matchFactor) : 0.0; }
+};
+
+/**
+ * @brief Sizes truck fleets against precompiled route and vehicle arrays
+ *
+ * compile() flattens the cycle profiles and the loaders (bucket capacity)
+ * and trucks (truck capacity) among the vehicles into parallel arrays,
+ * so evaluate() and optimize() are plain arithmetic and never touch the
+ * database; a planner can re-run them on every option change.
+ *
+ * The model is the deterministic match factor: a truck takes
+ * ceil(payload / bucket) passes to load, then spends the profile's cycle
+ * less its measured load phase on haul, dump and return. Output is the
+ * lesser of what the trucks can carry and what the loader can fill. A
+ * profile tied to a truck (by vehicle name) is only sized with that truck;
+ * others are tried with every truck type. optimize() sweeps 1..maxTrucks
+ * for each route, loader and truck and keeps the fleet with the lowest
+ * cost per m³, preferring more output on a tie.
+ */
+class FleetSizer
+{
+public:
+    void compile(const QVector<CycleProfile> &profiles, const QVector<Vehicle> &vehicles);
+    bool isCompiled() const { return !m_routeNames.isEmpty(); }
+
+    int routeCount() const { return m_routeNames.size(); }
+    int loaderCount() const { return m_loaderIds.size(); }
+    int truckCount() const { return m_truckIds.size(); }
+
+    // Indices are into the compiled arrays; see routeCount() and friends
+    FleetPlan evaluate(int route, int loader, int truck, int trucks, const FleetOptions &options) const;
+
+    // Best fleet per route and loader, in route then loader order
+    QVector<FleetPlan> optimize(const FleetOptions &options) const;
+
+private:
+    struct Cost {
+        double passes = 0;
+        double payload = 0;
+        double loadSeconds = 0;
+        double cycleSeconds = 0;
+        double loaderCost = 0;
+        double truckCost = 0;
+    };
+
+    bool prepare(int route, int loader, int truck, const FleetOptions &options, Cost *cost) const;
+    double basisSeconds(int route, CycleBasis basis) const;
+
+    // Routes
+    QVector<int> m_routeIds;
+    QVector<QString> m_routeNames;
+    QVector<double> m_avgSeconds;           // 0 when the profile has no records
+    QVector<double> m_p50Seconds;
+    QVector<double> m_p90Seconds;
+    QVector<double> m_loadPhaseSeconds;     // Measured load phase; 0 when not split
+    QVector<int> m_routeTruck;              // Truck slot the profile names, or -1
+
+    // Loaders
+    QVector<QString> m_loaderIds;
+    QVector<QString> m_loaderNames;
+    QVector<double> m_bucketM3;
+    QVector<double> m_loaderFuelLPerHour;
+    QHash<QString, int> m_loaderSlotById;
+
+    // Trucks
+    QVector<QString> m_truckIds;
+    QVector<QString> m_truckNames;
+    QVector<double> m_truckM3;
+    QVector<double> m_truckFuelLPerHour;
+};
+
+} // namespace Frontier
+
+#endif // FLEETSIZER_H
@@ -0,0 +1,202 @@
+/**
+ * @file fuelefficiency.cpp
+ * @brief Per-equipment fuel efficiency tracker implementation
+ */
+
+#include "fuelefficiency.h"
+#include "database.h"
+#include "profiler.h"
+
+#include <QDate>
+
+namespace Frontier {
+
+namespace {
+
+void addTo(FuelWindow &window, const FuelWindow &sums)
+{
+    window.liters += sums.liters;
+    window.hours += sums.hours;
+    window.entries += sums.entries;
+}
+
+void subtractFrom(FuelWindow &window, const FuelWindow &sums)
+{
+    window.entries -= sums.entries;
+    if (window.entries <= 0) {
+        // Exactly zero again, rather than what the subtractions leave
+        window = FuelWindow();
+        return;
+    }
+    window.liters -= sums.liters;
+    window.hours -= sums.hours;
+}
+
+// Windows are 7 and 30 days including their end day
+constexpr qint64 WeekDays = 7;
+constexpr qint64 MonthDays = 30;
+
+} // namespace
+
+// =============================================================================
+// EquipmentEfficiency
+// =============================================================================
+
+double EquipmentEfficiency::deviationPercent() const
+{
+    if (specLPerHour <= 0 || last30.hours <= 0) {
+        return 0;
+    }
+    return (last30.litersPerHour() / specLPerHour - 1.0) * 100.0;
+}
+
+QString EquipmentEfficiency::anomalyText() const
+{
+    QStringList parts;
+    if (anomalies & FuelAnomaly::AboveSpec) parts << "above spec";
+    if (anomalies & FuelAnomaly::BelowSpec) parts << "below spec";
+    if (anomalies & FuelAnomaly::Rising) parts << "rising";
+    QString text = parts.join(", ");
+    if (!text.isEmpty()) {
+        text[0] = text[0].toUpper();
+    }
+    return text;
+}
+
+// =============================================================================
+// FuelEfficiencyTracker
+// =============================================================================
+
+FuelEfficiencyTracker::FuelEfficiencyTracker(Database *database)
+    : m_database(database)
+{
+}
+
+EquipmentEfficiency FuelEfficiencyTracker::efficiency(const QString &equipmentId, double specLPerHour)
+{
+    ensureLoaded();
+    advanceTo(QDate::currentDate().toJulianDay());
+
+    EquipmentEfficiency result;
+    result.equipmentId = equipmentId;
+    result.specLPerHour = specLPerHour;
+
+    auto it = m_tracks.constFind(equipmentId);
+    if (it == m_tracks.constEnd()) {
+        return result;
+    }
+    result.last7 = it->last7;
+    result.last30 = it->last30;
+    result.lifetime = it->lifetime;
+
+    if (specLPerHour > 0 && result.last30.hours >= MinimumHours) {
+        const double ratio = result.last30.litersPerHour() / specLPerHour;
+        if (ratio > 1.0 + Tolerance) {
+            result.anomalies |= FuelAnomaly::AboveSpec;
+        } else if (ratio < 1.0 - Tolerance) {
+            result.anomalies |= FuelAnomaly::BelowSpec;
+        }
+    }
+
+    // Against the rest of the month, so the week is not compared with itself
+    FuelWindow before = result.last30;
+    before.liters -= result.last7.liters;
+    before.hours -= result.last7.hours;
+    if (result.last7.hours >= MinimumHours && before.hours >= MinimumHours
+        && result.last7.litersPerHour() > before.litersPerHour() * (1.0 + Tolerance)) {
+        result.anomalies |= FuelAnomaly::Rising;
+    }
+    return result;
+}
+
+QStringList FuelEfficiencyTracker::equipmentIds()
+{
+    ensureLoaded();
+    return m_tracks.keys();
+}
+
+void FuelEfficiencyTracker::add(const FuelLogEntry &entry)
+{
+    if (entry.equipmentId.isEmpty() || entry.meterOrHours <= 0 || !entry.dateTime.isValid()) {
+        m_loaded = true;
+        return;
+    }
+
+    const qint64 day = entry.dateTime.date().toJulianDay();
+    advanceTo(qMax<qint64>(day, QDate::currentDate().toJulianDay()));
+
+    const FuelWindow sums{entry.liters, entry.meterOrHours, 1};
+    Track &track = m_tracks[entry.equipmentId];
+    addTo(track.lifetime, sums);
+    addDay(track, day, sums);
+    m_loaded = true;
+}
+
+void FuelEfficiencyTracker::invalidate(DataTables tables)
+{
+    if (tables & DataTable::FuelLog) {
+        m_loaded = false;
+    }
+}
+
+void FuelEfficiencyTracker::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+
+    ProfileScope scope("FuelEfficiencyTracker::load");
+    m_tracks.clear();
+
+    for (const FuelHours &total : m_database->getFuelHours(QDate(), QDate(), false)) {
+        m_tracks[total.equipmentId].lifetime = FuelWindow{total.liters, total.hours, total.entries};
+    }
+
+    // The end is only known once the newest day is seen
+    const QDate today = QDate::currentDate();
+    const QVector<FuelHours> days = m_database->getFuelHours(today.addDays(1 - MonthDays), QDate(), true);
+    m_end = today.toJulianDay();
+    for (const FuelHours &day : days) {
+        m_end = qMax(m_end, day.date.toJulianDay());
+    }
+    for (const FuelHours &day : days) {
+        addDay(m_tracks[day.equipmentId], day.date.toJulianDay(),
+               FuelWindow{day.liters, day.hours, day.entries});
+    }
+    m_loaded = true;
+}
+
+void FuelEfficiencyTracker::advanceTo(qint64 day)
+{
+    if (day <= m_end) {
+        return;
+    }
+
+    for (Track &track : m_tracks) {
+        // Days in (old end - 7, new end - 7] leave the week; the month's
+        // leavers are the oldest buckets, dropped as they go
+        for (auto it = track.days.upperBound(m_end - WeekDays);
+             it != track.days.end() && it.key() <= day - WeekDays; ++it) {
+            subtractFrom(track.last7, it.value());
+        }
+        while (!track.days.isEmpty() && track.days.firstKey() <= day - MonthDays) {
+            subtractFrom(track.last30, track.days.first());
+            track.days.erase(track.days.begin());
+        }
+    }
+    m_end = day;
+}
+
+void FuelEfficiencyTracker::addDay(Track &track, qint64 day, const FuelWindow &sums)
+{
+    if (day <= m_end - MonthDays) {
+        return;
+    }
+    addTo(track.days[day], sums);
+    addTo(track.last30, sums);
+    if (day > m_end - WeekDays) {
+        addTo(track.last7, sums);
+    }
+}
+
+} // namespace Frontier
@@ -0,0 +1,118 @@
+/**
+ * @file fuelefficiency.h
+ * @brief Per-equipment fuel burn against spec over rolling windows
+ */
+
+#ifndef FUELEFFICIENCY_H
+#define FUELEFFICIENCY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+
+#include "types.h"
+#include "datachangebus.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Fuel burned and hours run over one span
+ */
+struct FuelWindow {
+    double liters = 0;
+    double hours = 0;
+    int entries = 0;
+
+    double litersPerHour() const { return hours > 0 ? liters / hours : 0; }
+};
+
+enum class FuelAnomaly {
+    None      = 0,
+    AboveSpec = 1 << 0,     // The last 30 days burn more than spec allows
+    BelowSpec = 1 << 1,     // Less than spec: usually fuel that was never logged
+    Rising    = 1 << 2,     // The last 7 days burn more than the 23 before them
+};
+Q_DECLARE_FLAGS(FuelAnomalies, FuelAnomaly)
+Q_DECLARE_OPERATORS_FOR_FLAGS(FuelAnomalies)
+
+/**
+ * @brief One machine's actual consumption next to its rated L/hr
+ */
+struct EquipmentEfficiency {
+    QString equipmentId;
+    double specLPerHour = 0;
+    FuelWindow last7;
+    FuelWindow last30;
+    FuelWindow lifetime;
+    FuelAnomalies anomalies;
+
+    // The last 30 days against spec: +12.5 is 12.5% over. 0 without a
+    // spec or hours in the window.
+    double deviationPercent() const;
+    // "Above spec, rising", or empty when nothing is flagged
+    QString anomalyText() const;
+};
+
+/**
+ * @brief Running L/hr per equipment, patched as fuel entries arrive
+ *
+ * Only entries that logged their hours (meter_or_hours > 0, as
+ * OperationsManager::generateFuelLogFromSession() writes them) count:
+ * their liters and hours go to the equipment's lifetime sums and, when
+ * recent, to a per-day bucket. The 7- and 30-day windows end today, or on
+ * the newest entry when that is later, and are kept as running sums: a
+ * new entry adds to them, and moving the end forward subtracts only the
+ * buckets that fall out, so a day later costs one eviction per machine
+ * rather than a rescan. Buckets older than 30 days are dropped.
+ *
+ * Loaded on first use with two grouped queries. Single-entry and batch
+ * adds patch a loaded tracker; any other fuel log write invalidates it
+ * through Database::markDirty() and the next read reloads. Owned by
+ * Database and used on its thread.
+ */
+class FuelEfficiencyTracker
+{
+public:
+    // Share off spec (or off the previous weeks) that raises a flag
+    static constexpr double Tolerance = 0.20;
+    // Fewer hours than this in a window are too few to flag
+    static constexpr double MinimumHours = 2.0;
+
+    explicit FuelEfficiencyTracker(Database *database);
+
+    EquipmentEfficiency efficiency(const QString &equipmentId, double specLPerHour);
+    // Equipment with hours logged, in no particular order
+    QStringList equipmentIds();
+
+    // === Maintenance ===
+    // Mirror an added entry. Only for a tracker that was loaded before the
+    // write's markDirty(): patched, it counts as loaded again.
+    void add(const FuelLogEntry &entry);
+    void invalidate(DataTables tables);
+    bool isLoaded() const { return m_loaded; }
+
+private:
+    struct Track {
+        QMap<qint64, FuelWindow> days;  // Julian day -> that day's sums, last 30 days
+        FuelWindow last7;
+        FuelWindow last30;
+        FuelWindow lifetime;
+    };
+
+    void ensureLoaded();
+    // Moves the windows' end to day, evicting the buckets that leave them
+    void advanceTo(qint64 day);
+    void addDay(Track &track, qint64 day, const FuelWindow &sums);
+
+    Database *m_database;
+    bool m_loaded = false;
+    qint64 m_end = 0;                   // Julian day the windows end on
+    QHash<QString, Track> m_tracks;
+};
+
+} // namespace Frontier
+
+#endif // FUELEFFICIENCY_H
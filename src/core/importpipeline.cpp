@@ -0,0 +1,433 @@
+/**
+ * @file importpipeline.cpp
+ * @brief Background reference-data import implementation
+ */
+
+#include "importpipeline.h"
+#include "database.h"
+#include "itemimporter.h"
+#include "vehicleimporter.h"
+#include "recipeimporter.h"
+#include "locationimporter.h"
+#include "factorybuildingimporter.h"
+#include "referencesnapshot.h"
+#include "tracing.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace Frontier {
+
+namespace {
+
+QString describe(const ImportDiff &diff)
+{
+    return QString("%1 added, %2 updated, %3 removed, %4 unchanged")
+        .arg(diff.inserted).arg(diff.updated).arg(diff.deleted).arg(diff.unchanged);
+}
+
+} // namespace
+
+QString referenceDataToString(ReferenceData data)
+{
+    switch (data) {
+    case ReferenceData::Items: return "Items";
+    case ReferenceData::Vehicles: return "Vehicles";
+    case ReferenceData::Recipes: return "Recipes";
+    case ReferenceData::Locations: return "Locations";
+    case ReferenceData::FactoryBuildings: return "Factory buildings";
+    }
+    return "Unknown";
+}
+
+// =============================================================================
+// ReferenceSources
+// =============================================================================
+
+bool ReferenceSources::isEmpty() const
+{
+    return itemsJson.isEmpty() && vehiclesJson.isEmpty() && recipesJson.isEmpty()
+           && locationsDir.isEmpty() && buildingsJson.isEmpty();
+}
+
+void ReferenceSources::merge(const ReferenceSources &other)
+{
+    if (!other.itemsJson.isEmpty()) {
+        itemsJson = other.itemsJson;
+        syncItems = other.syncItems;
+    }
+    if (!other.vehiclesJson.isEmpty()) {
+        vehiclesJson = other.vehiclesJson;
+        replaceVehicles = other.replaceVehicles;
+    }
+    if (!other.recipesJson.isEmpty()) recipesJson = other.recipesJson;
+    if (!other.locationsDir.isEmpty()) locationsDir = other.locationsDir;
+    if (!other.buildingsJson.isEmpty()) buildingsJson = other.buildingsJson;
+}
+
+ReferenceSources ReferenceSources::fromDirectory(const QString &directory)
+{
+    ReferenceSources sources;
+    QDir dir(directory);
+
+    auto find = [&dir](std::initializer_list<const char *> names) {
+        for (const char *name : names) {
+            if (dir.exists(name)) {
+                return dir.filePath(name);
+            }
+        }
+        return QString();
+    };
+
+    sources.itemsJson = find({"items.json"});
+    sources.vehiclesJson = find({"vehicles.json"});
+    sources.recipesJson = find({"workbenches.json", "recipes.json"});
+    sources.buildingsJson = find({"factory_buildings.json"});
+    if (dir.exists("maps.json") && dir.exists("location_types.json") && dir.exists("locations.json")) {
+        sources.locationsDir = dir.absolutePath();
+    }
+    return sources;
+}
+
+// =============================================================================
+// ImportPipeline
+// =============================================================================
+
+// What the loaders produced for one file; merged per data set on the
+// pipeline's thread
+struct ImportPipeline::Parsed {
+    ReferenceData data = ReferenceData::Items;
+    QString error;
+
+    QVector<Item> items;
+    QVector<Vehicle> vehicles;
+    QVector<WorkbenchRecipes> recipes;
+    QVector<Map> maps;
+    QVector<LocationType> types;
+    QVector<Location> locations;
+    QVector<FactoryBuilding> buildings;
+    int skipped = 0;
+
+    QByteArray sourceChecksum;           // Items: SHA-1 of the file
+    bool unchanged = false;              // Items: same file the snapshot was built from
+};
+
+ImportPipeline::ImportPipeline(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+{
+}
+
+ImportPipeline::~ImportPipeline()
+{
+    // Parses still running see the flag and skip their work; their
+    // continuations are dropped with this object
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+bool ImportPipeline::start(const ReferenceSources &sources)
+{
+    if (m_running || sources.isEmpty()) {
+        return false;
+    }
+
+    m_sources = sources;
+    m_running = true;
+    m_writeScheduled = false;
+    m_cancelled = std::make_shared<std::atomic_bool>(false);
+    ++m_generation;
+    m_pendingFiles.clear();
+    m_parsed.clear();
+    m_writeQueue.clear();
+    m_results.clear();
+    m_stepsDone = 0;
+    m_stepsTotal = 0;
+    m_stagesLeft = 0;
+    m_itemsChecksum.clear();
+    m_referenceWritten = false;
+
+    // Count everything before the first parse can report back
+    auto plan = [this](ReferenceData data, int files) {
+        m_pendingFiles.insert(static_cast<int>(data), files);
+        m_stepsTotal += files + 1;
+        ++m_stagesLeft;
+    };
+    if (!sources.itemsJson.isEmpty()) plan(ReferenceData::Items, 1);
+    if (!sources.vehiclesJson.isEmpty()) plan(ReferenceData::Vehicles, 1);
+    if (!sources.recipesJson.isEmpty()) plan(ReferenceData::Recipes, 1);
+    if (!sources.locationsDir.isEmpty()) plan(ReferenceData::Locations, 3);
+    if (!sources.buildingsJson.isEmpty()) plan(ReferenceData::FactoryBuildings, 1);
+
+    emit progress(0, m_stepsTotal, tr("Reading reference files..."));
+
+    if (!sources.itemsJson.isEmpty()) {
+        const QString path = sources.itemsJson;
+        // A sync from the file the current snapshot came from changes nothing
+        const ReferenceSnapshot *snapshot = m_database->referenceSnapshot();
+        const QByteArray known = sources.syncItems && snapshot ? snapshot->sourceChecksum() : QByteArray();
+        parseAsync(ReferenceData::Items, QFileInfo(path).fileName(), [path, known](Parsed &out) {
+            out.sourceChecksum = ReferenceSnapshot::checksumFile(path);
+            if (!known.isEmpty() && out.sourceChecksum == known) {
+                out.unchanged = true;
+                return;
+            }
+            out.items = ItemImporter::loadFromJson(path);
+            if (out.items.isEmpty()) {
+                out.error = QString("No items could be read from %1").arg(path);
+            }
+        });
+    }
+
+    if (!sources.vehiclesJson.isEmpty()) {
+        const QString path = sources.vehiclesJson;
+        parseAsync(ReferenceData::Vehicles, QFileInfo(path).fileName(), [path](Parsed &out) {
+            out.vehicles = VehicleImporter::loadFromJson(path);
+            if (out.vehicles.isEmpty()) {
+                out.error = QString("No vehicles could be read from %1").arg(path);
+            }
+        });
+    }
+
+    if (!sources.recipesJson.isEmpty()) {
+        const QString path = sources.recipesJson;
+        parseAsync(ReferenceData::Recipes, QFileInfo(path).fileName(), [path](Parsed &out) {
+            out.recipes = RecipeImporter::loadFromJson(path, &out.error);
+        });
+    }
+
+    if (!sources.locationsDir.isEmpty()) {
+        // The three location files parse side by side
+        const QDir dir(sources.locationsDir);
+        const QString mapsPath = dir.filePath("maps.json");
+        const QString typesPath = dir.filePath("location_types.json");
+        const QString locationsPath = dir.filePath("locations.json");
+        parseAsync(ReferenceData::Locations, "maps.json", [mapsPath](Parsed &out) {
+            out.maps = LocationImporter::loadMapsFromJson(mapsPath, &out.error);
+        });
+        parseAsync(ReferenceData::Locations, "location_types.json", [typesPath](Parsed &out) {
+            out.types = LocationImporter::loadTypesFromJson(typesPath, &out.error);
+        });
+        parseAsync(ReferenceData::Locations, "locations.json", [locationsPath](Parsed &out) {
+            out.locations = LocationImporter::loadLocationsFromJson(locationsPath, &out.error);
+        });
+    }
+
+    if (!sources.buildingsJson.isEmpty()) {
+        const QString path = sources.buildingsJson;
+        parseAsync(ReferenceData::FactoryBuildings, QFileInfo(path).fileName(), [path](Parsed &out) {
+            out.buildings = FactoryBuildingImporter::loadFromJson(path, &out.error, &out.skipped);
+        });
+    }
+
+    return true;
+}
+
+void ImportPipeline::cancel()
+{
+    if (!m_running || isCancelled()) {
+        return;
+    }
+    m_cancelled->store(true);
+    scheduleWrite();                     // The writer notices and finishes
+}
+
+void ImportPipeline::parseAsync(ReferenceData data, const QString &label,
+                                std::function<void(Parsed &)> parse)
+{
+    const auto cancelled = m_cancelled;
+    const int generation = m_generation;
+
+    QtConcurrent::run([data, parse = std::move(parse), cancelled]() {
+        auto parsed = std::make_shared<Parsed>();
+        parsed->data = data;
+        if (!cancelled->load()) {
+            parse(*parsed);
+        }
+        return parsed;
+    }).then(this, [this, label, generation](const std::shared_ptr<Parsed> &parsed) {
+        if (generation != m_generation || !m_running) {
+            return;
+        }
+        step(tr("Parsed %1").arg(label));
+        onParsed(parsed);
+    });
+}
+
+void ImportPipeline::onParsed(const std::shared_ptr<Parsed> &parsed)
+{
+    const int key = static_cast<int>(parsed->data);
+
+    auto it = m_parsed.find(key);
+    if (it == m_parsed.end()) {
+        m_parsed.insert(key, parsed);
+    } else {
+        // Second or third location file
+        Parsed &merged = *it.value();
+        if (!parsed->maps.isEmpty()) merged.maps = std::move(parsed->maps);
+        if (!parsed->types.isEmpty()) merged.types = std::move(parsed->types);
+        if (!parsed->locations.isEmpty()) merged.locations = std::move(parsed->locations);
+        if (merged.error.isEmpty()) merged.error = parsed->error;
+    }
+
+    if (--m_pendingFiles[key] == 0) {
+        m_writeQueue.append(parsed->data);
+        scheduleWrite();
+    }
+}
+
+void ImportPipeline::scheduleWrite()
+{
+    if (m_writeScheduled) {
+        return;
+    }
+    m_writeScheduled = true;
+    // One data set per event loop turn keeps the window responsive
+    QTimer::singleShot(0, this, &ImportPipeline::writeNext);
+}
+
+void ImportPipeline::writeNext()
+{
+    m_writeScheduled = false;
+    if (!m_running) {
+        return;
+    }
+
+    if (isCancelled()) {
+        finish();
+        return;
+    }
+    if (m_writeQueue.isEmpty()) {
+        return;                          // Waiting on parses
+    }
+
+    const ReferenceData data = m_writeQueue.takeFirst();
+    const std::shared_ptr<Parsed> parsed = m_parsed.take(static_cast<int>(data));
+
+    ImportStageResult result = write(*parsed);
+    m_referenceWritten = m_referenceWritten || result.ok;
+    m_results.append(result);
+    step(tr("Wrote %1").arg(referenceDataToString(data).toLower()));
+    emit stageFinished(result);
+
+    if (--m_stagesLeft == 0) {
+        finish();
+    } else if (!m_writeQueue.isEmpty()) {
+        scheduleWrite();
+    }
+}
+
+ImportStageResult ImportPipeline::write(const Parsed &parsed)
+{
+    FRONTIER_TRACE_SCOPE("ImportPipeline::write");
+    ImportStageResult result;
+    result.data = parsed.data;
+
+    if (!parsed.error.isEmpty()) {
+        result.summary = parsed.error;
+        return result;
+    }
+
+    switch (parsed.data) {
+    case ReferenceData::Items:
+        if (parsed.unchanged) {
+            result.ok = true;
+            result.summary = QString("unchanged since the last import");
+        } else if (m_sources.syncItems) {
+            std::optional<ImportDiff> diff = ItemImporter::syncItems(parsed.items, m_database);
+            result.ok = diff.has_value();
+            result.summary = diff ? describe(*diff) : m_database->lastError();
+        } else {
+            int count = ItemImporter::importItems(parsed.items, m_database);
+            result.ok = count >= 0;
+            result.summary = result.ok ? QString("%1 imported").arg(count) : m_database->lastError();
+        }
+        if (result.ok && m_sources.syncItems && !parsed.unchanged) {
+            m_itemsChecksum = parsed.sourceChecksum;
+        }
+        break;
+
+    case ReferenceData::Vehicles: {
+        int count = VehicleImporter::importVehicles(parsed.vehicles, m_database,
+                                                    m_sources.replaceVehicles);
+        result.ok = count >= 0;
+        result.summary = result.ok ? QString("%1 imported").arg(count) : m_database->lastError();
+        break;
+    }
+
+    case ReferenceData::Recipes: {
+        RecipeImporter importer(m_database);
+        result.ok = importer.importWorkbenches(parsed.recipes);
+        result.summary = result.ok ? QString("%1 workbenches, %2 recipes")
+                                         .arg(importer.workbenchesImported())
+                                         .arg(importer.recipesImported())
+                                   : importer.lastError();
+        break;
+    }
+
+    case ReferenceData::Locations:
+        result.ok = LocationImporter::syncLocations(parsed.maps, parsed.types,
+                                                    parsed.locations, m_database);
+        result.summary = result.ok
+            ? QString("maps %1; types %2; locations %3")
+                  .arg(describe(LocationImporter::mapsDiff()),
+                       describe(LocationImporter::typesDiff()),
+                       describe(LocationImporter::locationsDiff()))
+            : LocationImporter::lastError();
+        break;
+
+    case ReferenceData::FactoryBuildings: {
+        int count = FactoryBuildingImporter::upsertBuildings(parsed.buildings, m_database);
+        result.ok = count >= 0;
+        result.summary = result.ok ? QString("%1 imported, %2 skipped").arg(count).arg(parsed.skipped)
+                                   : m_database->lastError();
+        break;
+    }
+    }
+
+    // The set now comes from the user's file, not the built-in data it may
+    // have been seeded from (see embeddedcatalog.h)
+    if (result.ok && !parsed.unchanged) {
+        switch (parsed.data) {
+        case ReferenceData::Items:
+            m_database->setReferenceSource("items", QByteArray());
+            break;
+        case ReferenceData::Vehicles:
+            m_database->setReferenceSource("vehicles", QByteArray());
+            break;
+        case ReferenceData::FactoryBuildings:
+            m_database->setReferenceSource("factory_buildings", QByteArray());
+            break;
+        default:
+            break;
+        }
+    }
+
+    return result;
+}
+
+void ImportPipeline::step(const QString &label)
+{
+    ++m_stepsDone;
+    emit progress(m_stepsDone, m_stepsTotal, label);
+}
+
+void ImportPipeline::finish()
+{
+    // Items written this run (or a missing snapshot) mean the file on disk
+    // no longer matches; rebuild it so the next start maps it directly
+    if (m_referenceWritten
+        && (!m_itemsChecksum.isEmpty() || !m_database->referenceSnapshot())) {
+        m_database->writeReferenceSnapshot(m_itemsChecksum);
+    }
+
+    m_running = false;
+    m_writeQueue.clear();
+    m_parsed.clear();
+    emit finished();
+}
+
+} // namespace Frontier
@@ -0,0 +1,131 @@
+/**
+ * @file importpipeline.h
+ * @brief Background reference-data import: parallel parsing, one writer
+ */
+
+#ifndef IMPORTPIPELINE_H
+#define IMPORTPIPELINE_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+enum class ReferenceData { Items, Vehicles, Recipes, Locations, FactoryBuildings };
+
+QString referenceDataToString(ReferenceData data);
+
+/**
+ * @brief Files to import; an empty path skips that data set
+ */
+struct ReferenceSources {
+    QString itemsJson;
+    bool syncItems = true;           // Differential sync; false adds to the existing items
+    QString vehiclesJson;
+    bool replaceVehicles = false;    // Clear first; otherwise upsert by id
+    QString recipesJson;             // Always replaces the recipe book
+    QString locationsDir;            // maps.json, location_types.json, locations.json
+    QString buildingsJson;           // Upserted by name
+
+    bool isEmpty() const;
+    // Takes over every data set the other names, with its options
+    void merge(const ReferenceSources &other);
+
+    // Picks up the usual file names (items.json, vehicles.json,
+    // workbenches.json or recipes.json, the location files and
+    // factory_buildings.json) from one folder
+    static ReferenceSources fromDirectory(const QString &directory);
+};
+
+struct ImportStageResult {
+    ReferenceData data = ReferenceData::Items;
+    bool ok = false;
+    QString summary;                 // One line for the user, e.g. counts
+};
+
+/**
+ * @brief Imports several reference files without blocking the GUI thread
+ *
+ * Every file is parsed on the global thread pool at the same time, using
+ * the importers' database-free loaders. Parsed data sets are written by a
+ * single writer on the pipeline's (GUI) thread, one data set per event
+ * loop turn and each in its own transaction, so the window keeps
+ * repainting and every data set is applied whole or not at all.
+ *
+ * cancel() stops before the next write; data sets already written stay,
+ * and parses still running finish in the background and are discarded.
+ *
+ * When the run wrote items, finish() rebuilds the database's reference
+ * snapshot; an items file whose checksum matches the snapshot's source is
+ * reported unchanged and not parsed at all.
+ */
+class ImportPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImportPipeline(Database *database, QObject *parent = nullptr);
+    ~ImportPipeline();
+
+    // False if a run is already in progress or there is nothing to import
+    bool start(const ReferenceSources &sources);
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+    bool isCancelled() const { return m_cancelled && m_cancelled->load(); }
+    QVector<ImportStageResult> results() const { return m_results; }
+    ReferenceSources sources() const { return m_sources; }
+
+signals:
+    // Steps are file parses plus data set writes
+    void progress(int done, int total, const QString &label);
+    void stageFinished(const Frontier::ImportStageResult &result);
+    void finished();
+
+private:
+    struct Parsed;
+
+    void parseAsync(ReferenceData data, const QString &label, std::function<void(Parsed &)> parse);
+    void onParsed(const std::shared_ptr<Parsed> &parsed);
+    void scheduleWrite();
+    void writeNext();
+    ImportStageResult write(const Parsed &parsed);
+    void step(const QString &label);
+    void finish();
+
+    Database *m_database;
+    ReferenceSources m_sources;
+
+    bool m_running = false;
+    bool m_writeScheduled = false;
+    std::shared_ptr<std::atomic_bool> m_cancelled;
+
+    // Files still being parsed per data set (locations has three)
+    QHash<int, int> m_pendingFiles;
+    QHash<int, std::shared_ptr<Parsed>> m_parsed;
+    QVector<ReferenceData> m_writeQueue;
+    int m_stagesLeft = 0;
+
+    int m_generation = 0;            // Ignores parses left over from an earlier run
+    int m_stepsDone = 0;
+    int m_stepsTotal = 0;
+    QVector<ImportStageResult> m_results;
+
+    // Reference snapshot rebuilt in finish() (see referencesnapshot.h)
+    QByteArray m_itemsChecksum;          // Source of the items written this run
+    bool m_referenceWritten = false;
+};
+
+} // namespace Frontier
+
+#endif // IMPORTPIPELINE_H
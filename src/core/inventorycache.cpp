@@ -0,0 +1,182 @@
+/**
+ * @file inventorycache.cpp
+ * @brief Indexed inventory cache implementation
+ */
+
+#include "inventorycache.h"
+#include "database.h"
+#include "profiler.h"
+#include "symboltable.h"
+#include "commandjournal.h"
+
+namespace Frontier {
+
+InventoryCache::InventoryCache(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+{
+    Profiler::instance().setMemoryReporter("Inventory cache", [this]() { return estimatedBytes(); });
+}
+
+InventoryCache::~InventoryCache()
+{
+    Profiler::instance().removeMemoryReporter("Inventory cache");
+}
+
+qint64 InventoryCache::estimatedBytes() const
+{
+    qint64 bytes = estimateBytes(m_items) + estimateBytes(m_rowByItemId) + estimateBytes(m_rowByItemSymbol);
+    for (const InventoryItem &item : m_items) {
+        bytes += estimateBytes(item.itemName) + estimateBytes(item.itemCode)
+                 + estimateBytes(item.category) + estimateBytes(item.locationName);
+    }
+    return bytes;
+}
+
+void InventoryCache::reload()
+{
+    // Queued quantity edits must be in the table before it is read back
+    m_database->flushPendingWrites();
+    m_items = m_database->getAllInventory();
+
+    m_rowByItemId.clear();
+    m_rowByItemSymbol.clear();
+    m_rowByItemId.reserve(m_items.size());
+    m_rowByItemSymbol.reserve(m_items.size());
+    for (int row = 0; row < m_items.size(); ++row) {
+        indexRow(row);
+    }
+
+    emit reloaded();
+}
+
+void InventoryCache::indexRow(int row)
+{
+    const InventoryItem &item = m_items[row];
+    if (!m_rowByItemId.contains(item.itemId)) {
+        m_rowByItemId.insert(item.itemId, row);
+    }
+    if (!m_rowByItemSymbol.contains(item.itemSymbol)) {
+        m_rowByItemSymbol.insert(item.itemSymbol, row);
+    }
+}
+
+int InventoryCache::rowForItemName(const QString &itemName) const
+{
+    return m_rowByItemSymbol.value(SymbolTable::instance().find(itemName), -1);
+}
+
+int InventoryCache::rowForId(int inventoryId) const
+{
+    for (int row = 0; row < m_items.size(); ++row) {
+        if (m_items[row].id == inventoryId) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+const InventoryItem *InventoryCache::findByItemId(int itemId) const
+{
+    int row = rowForItemId(itemId);
+    return row >= 0 ? &m_items[row] : nullptr;
+}
+
+const InventoryItem *InventoryCache::findByItemName(const QString &itemName) const
+{
+    int row = rowForItemName(itemName);
+    return row >= 0 ? &m_items[row] : nullptr;
+}
+
+int InventoryCache::quantityOf(const QString &itemName) const
+{
+    const InventoryItem *item = findByItemName(itemName);
+    return item ? item->quantity : 0;
+}
+
+// =============================================================================
+// Write-Through Updates
+// =============================================================================
+
+bool InventoryCache::setQuantity(int row, int newQuantity)
+{
+    if (row < 0 || row >= m_items.size()) {
+        return false;
+    }
+
+    // Queued: consuming a recipe's ingredients or stepping a quantity
+    // writes the same rows repeatedly. The owning view is acknowledged
+    // when the write lands, having already patched itself at rowChanged().
+    InventoryItem &item = m_items[row];
+    const int id = item.id.value_or(0);
+    m_database->journal().record(JournalCommand::setInventoryQuantity(item, item.quantity, newQuantity));
+    m_database->queueWrite(QStringLiteral("inventory:%1").arg(id), DataTable::Inventory,
+                           [id, newQuantity](Database &db) {
+                               return db.updateInventoryQuantity(id, newQuantity);
+                           },
+                           parent());
+
+    item.quantity = newQuantity;
+    item.lastUpdated = QDateTime::currentDateTime();
+    emit rowChanged(row);
+    return true;
+}
+
+bool InventoryCache::refreshRow(int inventoryId)
+{
+    const int row = rowForId(inventoryId);
+    if (row < 0) {
+        return false;
+    }
+
+    auto stored = m_database->getInventoryItem(inventoryId);
+    if (!stored.has_value()) {
+        return false;
+    }
+
+    // Item and location are unchanged, so the indexes still hold
+    m_items[row] = *stored;
+    emit rowChanged(row);
+    return true;
+}
+
+bool InventoryCache::adjustQuantity(const QString &itemName, int delta)
+{
+    int row = rowForItemName(itemName);
+    if (row < 0) {
+        return false;
+    }
+    return setQuantity(row, qMax(0, m_items[row].quantity + delta));
+}
+
+bool InventoryCache::addQuantity(int itemId, int quantity, std::optional<int> locationId)
+{
+    int row = rowForItemId(itemId);
+    if (row >= 0) {
+        return setQuantity(row, m_items[row].quantity + quantity);
+    }
+
+    InventoryItem item;
+    item.itemId = itemId;
+    item.quantity = quantity;
+    item.locationId = locationId;
+    int id = m_database->addInventoryItem(item);
+    if (id <= 0) {
+        return false;
+    }
+
+    // Fetch the row back for the joined item and location columns
+    auto inserted = m_database->getInventoryItem(id);
+    if (!inserted.has_value()) {
+        reload();
+        return true;
+    }
+
+    m_items.append(*inserted);
+    row = m_items.size() - 1;
+    indexRow(row);
+    emit rowInserted(row);
+    return true;
+}
+
+} // namespace Frontier
@@ -0,0 +1,83 @@
+/**
+ * @file inventorycache.h
+ * @brief Indexed in-memory copy of the inventory table
+ */
+
+#ifndef INVENTORYCACHE_H
+#define INVENTORYCACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <optional>
+
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Inventory rows indexed by item id and item name
+ *
+ * reload() reads the whole table once. The single-row writers go to the
+ * database and then patch the cached row in place, emitting rowChanged()
+ * or rowInserted() rather than reloaded(), so views can refresh just the
+ * affected row. Quantity changes go through Database::queueWrite() and
+ * reach the table when the write-behind queue flushes.
+ *
+ * When an item is stored in several rows (e.g. at different locations),
+ * lookups by id or name return the first row, matching
+ * Database::getInventoryByItemId().
+ */
+class InventoryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InventoryCache(Database *database, QObject *parent = nullptr);
+    ~InventoryCache();
+
+    void reload();
+
+    const QVector<InventoryItem> &items() const { return m_items; }
+    int size() const { return m_items.size(); }
+    qint64 estimatedBytes() const;
+
+    // Row index into items(), or -1
+    int rowForItemId(int itemId) const { return m_rowByItemId.value(itemId, -1); }
+    int rowForItemName(const QString &itemName) const;
+    int rowForId(int inventoryId) const;     // Linear scan
+
+    const InventoryItem *findByItemId(int itemId) const;
+    const InventoryItem *findByItemName(const QString &itemName) const;
+    int quantityOf(const QString &itemName) const;
+
+    // Re-reads one row after a write made elsewhere (an undo), emitting
+    // rowChanged(); false if it is not cached or no longer exists
+    bool refreshRow(int inventoryId);
+
+    // Single-row updates; setQuantity() is written behind and journaled
+    bool setQuantity(int row, int newQuantity);
+    bool adjustQuantity(const QString &itemName, int delta);
+    bool addQuantity(int itemId, int quantity, std::optional<int> locationId = std::nullopt);
+
+signals:
+    void reloaded();
+    void rowChanged(int row);
+    void rowInserted(int row);
+
+private:
+    void indexRow(int row);
+
+    Database *m_database;
+
+    QVector<InventoryItem> m_items;
+    QHash<int, int> m_rowByItemId;
+    QHash<Symbol, int> m_rowByItemSymbol;   // See symboltable.h
+};
+
+} // namespace Frontier
+
+#endif // INVENTORYCACHE_H
@@ -0,0 +1,121 @@
+/**
+ * @file inventoryledgersync.cpp
+ * @brief Incremental ledger-to-inventory replay implementation
+ */
+
+#include "inventoryledgersync.h"
+#include "database.h"
+#include "itemcatalog.h"
+#include "profiler.h"
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+namespace Frontier {
+
+InventoryLedgerSync::InventoryLedgerSync(Database *database)
+    : m_database(database)
+{
+}
+
+int InventoryLedgerSync::pendingCount() const
+{
+    return m_database->countStockTransactionsAfter(m_database->getInventorySyncCheckpoint());
+}
+
+std::optional<InventorySyncResult> InventoryLedgerSync::sync()
+{
+    ProfileScope scope("InventoryLedgerSync::sync");
+    m_lastError.clear();
+
+    InventorySyncResult result;
+    result.checkpoint = m_database->getInventorySyncCheckpoint();
+
+    const QVector<Transaction> entries = m_database->getStockTransactionsAfter(result.checkpoint);
+    if (entries.isEmpty()) {
+        return result;
+    }
+
+    // === Replay in ledger order, in memory ===
+    struct Stock {
+        std::optional<InventoryItem> row;    // Missing until a purchase creates it
+        int start = 0;
+        int quantity = 0;
+    };
+    QHash<int, Stock> stock;
+    QVector<int> touched;                    // Item ids in first-seen order
+    QSet<QString> unknown;
+
+    const ItemCatalog &catalog = m_database->itemCatalog();
+    for (const Transaction &entry : entries) {
+        ++result.transactionsApplied;
+        result.checkpoint = entry.id.value_or(result.checkpoint);
+
+        const Item *item = catalog.findByName(entry.item);
+        if (!item || !item->id.has_value()) {
+            if (!entry.item.isEmpty() && !unknown.contains(entry.item)) {
+                unknown.insert(entry.item);
+                result.unknownItems.append(entry.item);
+            }
+            continue;
+        }
+
+        const int itemId = item->id.value();
+        auto it = stock.find(itemId);
+        if (it == stock.end()) {
+            Stock current;
+            current.row = m_database->getInventoryByItemId(itemId);
+            current.start = current.row ? current.row->quantity : 0;
+            current.quantity = current.start;
+            it = stock.insert(itemId, current);
+            touched.append(itemId);
+        }
+
+        const int delta = entry.type == TransactionType::Purchase ? entry.quantity : -entry.quantity;
+        it->quantity = qMax(0, it->quantity + delta);
+    }
+
+    // === One write per item, one transaction for the batch ===
+    if (!m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
+        return std::nullopt;
+    }
+
+    for (int itemId : touched) {
+        const Stock &item = stock[itemId];
+        const int delta = item.quantity - item.start;
+        if (item.row) {
+            if (delta == 0) {
+                continue;
+            }
+            if (!m_database->adjustInventoryQuantity(item.row->id.value_or(0), delta)) {
+                m_lastError = m_database->lastError();
+                m_database->rollbackTransaction();
+                return std::nullopt;
+            }
+            ++result.itemsAdjusted;
+        } else if (item.quantity > 0) {
+            InventoryItem row;
+            row.itemId = itemId;
+            row.quantity = item.quantity;
+            if (m_database->addInventoryItem(row) <= 0) {
+                m_lastError = m_database->lastError();
+                m_database->rollbackTransaction();
+                return std::nullopt;
+            }
+            ++result.rowsCreated;
+        }
+    }
+
+    if (!m_database->setInventorySyncCheckpoint(result.checkpoint)
+        || !m_database->commitTransaction()) {
+        m_lastError = m_database->lastError();
+        m_database->rollbackTransaction();
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+} // namespace Frontier
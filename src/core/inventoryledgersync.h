@@ -0,0 +1,62 @@
+/**
+ * @file inventoryledgersync.h
+ * @brief Incremental replay of ledger sales and purchases into inventory
+ */
+
+#ifndef INVENTORYLEDGERSYNC_H
+#define INVENTORYLEDGERSYNC_H
+
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+namespace Frontier {
+
+class Database;
+
+struct InventorySyncResult {
+    int transactionsApplied = 0;
+    int itemsAdjusted = 0;           // Existing inventory rows changed
+    int rowsCreated = 0;             // Purchases of items not yet in inventory
+    QStringList unknownItems;        // Ledger names with no matching item
+    int checkpoint = 0;              // Last transaction id now applied
+
+    bool isEmpty() const { return transactionsApplied == 0; }
+};
+
+/**
+ * @brief Applies new ledger entries to inventory from a stored checkpoint
+ *
+ * The checkpoint is the id of the last transaction already replayed. A
+ * sync reads only Sale and Purchase rows with a larger id (a primary key
+ * range scan), so its cost follows the entries added since the last sync
+ * rather than the length of the ledger. Purchases add their quantity and
+ * sales remove it, clamped at zero in ledger order as single adjustments
+ * would be; each item then gets one adjustInventoryQuantity() call with
+ * its net change. All writes and the new checkpoint go in one database
+ * transaction, so an interrupted sync applies nothing.
+ *
+ * Ledger names are matched to items through the ItemCatalog. A purchase
+ * of an item with no inventory row creates one; sales of such items and
+ * entries naming no known item are skipped and listed in the result.
+ * Editing or deleting transactions behind the checkpoint is not replayed.
+ */
+class InventoryLedgerSync
+{
+public:
+    explicit InventoryLedgerSync(Database *database);
+
+    // Entries a sync would apply now
+    int pendingCount() const;
+
+    std::optional<InventorySyncResult> sync();
+    QString lastError() const { return m_lastError; }
+
+private:
+    Database *m_database;
+    QString m_lastError;
+};
+
+} // namespace Frontier
+
+#endif // INVENTORYLEDGERSYNC_H
@@ -0,0 +1,143 @@
+/**
+ * @file itemcatalog.cpp
+ * @brief In-memory item catalog implementation
+ */
+
+#include "itemcatalog.h"
+#include "database.h"
+#include "referencesnapshot.h"
+#include "profiler.h"
+
+namespace Frontier {
+
+ItemCatalog::ItemCatalog(Database *database)
+    : m_database(database)
+{
+}
+
+const Item *ItemCatalog::findByName(const QString &name) const
+{
+    ensureLoaded();
+    auto it = m_indexByName.constFind(name);
+    return it != m_indexByName.constEnd() ? &m_items[it.value()] : nullptr;
+}
+
+const Item *ItemCatalog::findByCode(const QString &code) const
+{
+    ensureLoaded();
+    auto it = m_indexByCode.constFind(code);
+    return it != m_indexByCode.constEnd() ? &m_items[it.value()] : nullptr;
+}
+
+const Item *ItemCatalog::findById(int id) const
+{
+    ensureLoaded();
+    auto it = m_indexById.constFind(id);
+    return it != m_indexById.constEnd() ? &m_items[it.value()] : nullptr;
+}
+
+const QVector<Item> &ItemCatalog::items() const
+{
+    ensureLoaded();
+    return m_items;
+}
+
+int ItemCatalog::size() const
+{
+    ensureLoaded();
+    return m_items.size();
+}
+
+const QStringList &ItemCatalog::categories() const
+{
+    ensureLoaded();
+    return m_categories;
+}
+
+const QStringList &ItemCatalog::subCategories() const
+{
+    ensureLoaded();
+    return m_subCategories;
+}
+
+const QVector<int> &ItemCatalog::rowsInCategory(const QString &category) const
+{
+    static const QVector<int> none;
+    ensureLoaded();
+    auto it = m_rowsByCategory.constFind(category);
+    return it != m_rowsByCategory.constEnd() ? it.value() : none;
+}
+
+qint64 ItemCatalog::estimatedBytes() const
+{
+    if (!m_loaded) {
+        return 0;
+    }
+
+    qint64 bytes = estimateBytes(m_items) + estimateBytes(m_indexByName)
+                   + estimateBytes(m_indexByCode) + estimateBytes(m_indexById)
+                   + estimateBytes(m_rowsByCategory);
+    for (const QVector<int> &rows : m_rowsByCategory) {
+        bytes += estimateBytes(rows);
+    }
+    for (const Item &item : m_items) {
+        bytes += estimateBytes(item.code) + estimateBytes(item.name) + estimateBytes(item.categoryMain)
+                 + estimateBytes(item.categorySub) + estimateBytes(item.notes);
+    }
+    return bytes;
+}
+
+void ItemCatalog::invalidate()
+{
+    m_loaded = false;
+}
+
+void ItemCatalog::ensureLoaded() const
+{
+    if (m_loaded) {
+        return;
+    }
+
+    // The snapshot holds the same rows in the same order without a query
+    if (const ReferenceSnapshot *snapshot = m_database->referenceSnapshot()) {
+        m_items = snapshot->toItems();
+    } else {
+        m_items = m_database->getAllItems();
+    }
+
+    m_indexByName.clear();
+    m_indexByCode.clear();
+    m_indexById.clear();
+    m_rowsByCategory.clear();
+    m_categories.clear();
+    m_subCategories.clear();
+    m_indexByName.reserve(m_items.size());
+    m_indexByCode.reserve(m_items.size());
+    m_indexById.reserve(m_items.size());
+
+    for (int i = 0; i < m_items.size(); ++i) {
+        const Item &item = m_items[i];
+        // Names are not unique in the schema; keep the first match
+        if (!m_indexByName.contains(item.name)) {
+            m_indexByName.insert(item.name, i);
+        }
+        m_indexByCode.insert(item.code, i);
+        if (item.id.has_value()) {
+            m_indexById.insert(item.id.value(), i);
+        }
+        if (!item.categoryMain.isEmpty()) {
+            m_rowsByCategory[item.categoryMain].append(i);
+        }
+        if (!item.categorySub.isEmpty() && !m_subCategories.contains(item.categorySub)) {
+            m_subCategories.append(item.categorySub);
+        }
+    }
+
+    m_categories = m_rowsByCategory.keys();
+    m_categories.sort();
+    m_subCategories.sort();
+
+    m_loaded = true;
+}
+
+} // namespace Frontier
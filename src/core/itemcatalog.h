@@ -0,0 +1,77 @@
+/**
+ * @file itemcatalog.h
+ * @brief In-memory item catalog with constant-time lookups
+ */
+
+#ifndef ITEMCATALOG_H
+#define ITEMCATALOG_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Read-through cache of the items table
+ *
+ * Loads every item once into a contiguous array and indexes it by name,
+ * code and id. Owned by Database, which invalidates it whenever an item
+ * is added, updated or deleted; the next lookup reloads it.
+ *
+ * Returned pointers stay valid until the catalog is invalidated, so use
+ * them immediately rather than storing them.
+ *
+ * Rows are also grouped by main category as the catalog loads, so views
+ * can switch category filters without scanning every item or querying.
+ *
+ * When the database has a current reference snapshot (see
+ * referencesnapshot.h) the rows come from the mapped file instead of SQL.
+ */
+class ItemCatalog
+{
+public:
+    explicit ItemCatalog(Database *database);
+
+    const Item *findByName(const QString &name) const;
+    const Item *findByCode(const QString &code) const;
+    const Item *findById(int id) const;
+
+    const QVector<Item> &items() const;
+    int size() const;
+
+    // === Category Index ===
+    // Distinct main and sub categories, sorted; empty names are skipped
+    const QStringList &categories() const;
+    const QStringList &subCategories() const;
+    // Rows of items() in a main category, in catalog order
+    const QVector<int> &rowsInCategory(const QString &category) const;
+
+    void invalidate();
+    bool isLoaded() const { return m_loaded; }
+
+    // Approximate heap use; 0 until loaded
+    qint64 estimatedBytes() const;
+
+private:
+    void ensureLoaded() const;
+
+    Database *m_database;
+
+    mutable QVector<Item> m_items;
+    mutable QHash<QString, int> m_indexByName;
+    mutable QHash<QString, int> m_indexByCode;
+    mutable QHash<int, int> m_indexById;
+    mutable QHash<QString, QVector<int>> m_rowsByCategory;
+    mutable QStringList m_categories;
+    mutable QStringList m_subCategories;
+    mutable bool m_loaded = false;
+};
+
+} // namespace Frontier
+
+#endif // ITEMCATALOG_H
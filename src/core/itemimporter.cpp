@@ -5,16 +5,20 @@
 
 #include "itemimporter.h"
 #include "database.h"
+#include "jsonstreamreader.h"
+#include "tracing.h"
 
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonArray>
 #include <QJsonObject>
+#include <QHash>
+#include <QSet>
 #include <QDebug>
 #include <cmath>
 
 namespace Frontier {
 
+// Items handed to Database::addItems per call during a streamed import
+static constexpr int ImportBatchSize = 500;
+
 // Helper function to generate a unique code from name and notes
 static QString generateItemCode(const QString &name, const QString &notes, int index)
 {
@@ -64,191 +68,329 @@ static QString generateItemCode(const QString &name, const QString &notes, int i
     }
 }
 
+// Maps one record, accepting both the old and new field names
+static Item itemFromJson(const QJsonObject &obj)
+{
+    Item item;
+
+    // Basic fields
+    item.code = obj["code"].toString();
+    item.name = obj["name"].toString();
+
+    // Categories - handle both old and new field names
+    item.categoryMain = obj["category_main"].toString();
+    if (item.categoryMain.isEmpty()) {
+        item.categoryMain = obj["categoryMain"].toString();
+    }
+    if (item.categoryMain.isEmpty()) {
+        item.categoryMain = obj["category"].toString();
+    }
+
+    item.categorySub = obj["category_sub"].toString();
+    if (item.categorySub.isEmpty()) {
+        item.categorySub = obj["categorySub"].toString();
+    }
+
+    // Prices - handle both old and new field names
+    if (obj.contains("buy_price_internal")) {
+        item.buyPriceInternal = obj["buy_price_internal"].toDouble();
+    } else if (obj.contains("buyPriceInternal")) {
+        item.buyPriceInternal = obj["buyPriceInternal"].toDouble();
+    } else if (obj.contains("buyPrice")) {
+        item.buyPriceInternal = obj["buyPrice"].toDouble();
+    } else if (obj.contains("buy_price")) {
+        item.buyPriceInternal = obj["buy_price"].toDouble();
+    }
+
+    if (obj.contains("buy_price_display")) {
+        item.buyPriceDisplay = obj["buy_price_display"].toDouble();
+    } else if (obj.contains("buyPriceDisplay")) {
+        item.buyPriceDisplay = obj["buyPriceDisplay"].toDouble();
+    } else {
+        item.buyPriceDisplay = std::round(item.buyPriceInternal);
+    }
+
+    if (obj.contains("sell_price_internal")) {
+        item.sellPriceInternal = obj["sell_price_internal"].toDouble();
+    } else if (obj.contains("sellPriceInternal")) {
+        item.sellPriceInternal = obj["sellPriceInternal"].toDouble();
+    } else {
+        // Calculate from buy price (70% sell rate)
+        item.sellPriceInternal = item.buyPriceInternal * 0.70;
+    }
+
+    if (obj.contains("sell_price_display")) {
+        item.sellPriceDisplay = obj["sell_price_display"].toDouble();
+    } else if (obj.contains("sellPriceDisplay")) {
+        item.sellPriceDisplay = obj["sellPriceDisplay"].toDouble();
+    } else {
+        item.sellPriceDisplay = std::round(item.sellPriceInternal);
+    }
+
+    // Weight
+    item.weight = obj["weight"].toDouble(0.0);
+
+    // Boolean flags
+    if (obj.contains("is_purchasable")) {
+        item.isPurchasable = obj["is_purchasable"].toBool(true);
+    } else if (obj.contains("isPurchasable")) {
+        item.isPurchasable = obj["isPurchasable"].toBool(true);
+    } else {
+        item.isPurchasable = true;
+    }
+
+    if (obj.contains("is_sellable")) {
+        item.isSellable = obj["is_sellable"].toBool(true);
+    } else if (obj.contains("isSellable")) {
+        item.isSellable = obj["isSellable"].toBool(true);
+    } else {
+        item.isSellable = true;
+    }
+
+    if (obj.contains("is_craftable")) {
+        item.isCraftable = obj["is_craftable"].toBool(false);
+    } else if (obj.contains("isCraftable")) {
+        item.isCraftable = obj["isCraftable"].toBool(false);
+    } else {
+        item.isCraftable = false;
+    }
+
+    // Pricing group
+    QString pricingGroupStr = obj["pricing_group"].toString();
+    if (pricingGroupStr.isEmpty()) {
+        pricingGroupStr = obj["pricingGroup"].toString("Base70");
+    }
+    item.pricingGroup = stringToPricingGroup(pricingGroupStr);
+
+    // Notes
+    item.notes = obj["notes"].toString();
+
+    return item;
+}
+
+// Hash of the columns the items table stores, so a stored row and an
+// incoming record compare equal exactly when an update would be a no-op
+static size_t storedFingerprint(const Item &item)
+{
+    return qHashMulti(0, item.code, item.name, item.displayCategory(),
+                      item.buyPriceInternal, item.sellPriceInternal, item.sellPriceDisplay,
+                      item.weight, pricingGroupToString(item.pricingGroup), item.notes);
+}
+
 int ItemImporter::importFromJson(const QString &jsonPath, Database *database, bool clearExisting)
 {
-    QVector<Item> items = loadFromJson(jsonPath);
+    FRONTIER_TRACE_SCOPE("ItemImporter::importFromJson");
+    JsonStreamReader reader(jsonPath);
+    if (!reader.isOpen()) {
+        qWarning() << "Could not open file:" << jsonPath << reader.errorString();
+        return -1;
+    }
 
-    if (items.isEmpty()) {
+    // Clear and import inside one transaction so a re-import is atomic
+    if (!database->beginTransaction()) {
         return -1;
     }
 
-    // Clear existing items if requested
-    if (clearExisting) {
-        // Get all items and delete them
-        auto existingItems = database->getAllItems();
-        for (const auto &item : existingItems) {
-            if (item.id.has_value()) {
-                database->deleteItem(item.id.value());
-            }
-        }
+    if (clearExisting && !database->clearAllItems()) {
+        database->rollbackTransaction();
+        return -1;
     }
 
-    // Generate unique codes for items that don't have one
+    // Records go to the database in batches as they are read, so the
+    // whole catalog is never held in memory at once
+    QVector<Item> batch;
+    batch.reserve(ImportBatchSize);
+    int importedCount = 0;
     int codeIndex = 1;
-    for (auto &item : items) {
+    bool written = true;
+
+    auto flush = [&]() {
+        int added = database->addItems(batch);
+        batch.clear();
+        if (added < 0) {
+            written = false;             // Stops the reader
+            return false;
+        }
+        importedCount += added;
+        return true;
+    };
+
+    bool ok = reader.readArray([&](const QJsonObject &record) {
+        Item item = itemFromJson(record);
         if (item.code.isEmpty()) {
+            // Generate unique codes for items that don't have one
             item.code = generateItemCode(item.name, item.notes, codeIndex);
         }
         codeIndex++;
+
+        batch.append(item);
+        return batch.size() < ImportBatchSize || flush();
+    }, "items");
+
+    if (ok && written && !batch.isEmpty()) {
+        flush();
     }
 
-    // Import items
-    int importedCount = 0;
-    for (const auto &item : items) {
-        if (database->addItem(item)) {
-            importedCount++;
-        } else {
-            qWarning() << "Failed to import item:" << item.name << "code:" << item.code;
+    if (!ok || !written || reader.recordCount() == 0 || !database->commitTransaction()) {
+        if (!reader.errorString().isEmpty()) {
+            qWarning() << "Item import failed:" << reader.errorString();
         }
+        database->rollbackTransaction();
+        return -1;
     }
 
     return importedCount;
 }
 
-QVector<Item> ItemImporter::loadFromJson(const QString &jsonPath)
+int ItemImporter::importItems(QVector<Item> items, Database *database, bool clearExisting)
 {
-    QVector<Item> items;
-
-    QFile file(jsonPath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open file:" << jsonPath;
-        return items;
+    FRONTIER_TRACE_SCOPE("ItemImporter::importItems");
+    if (items.isEmpty()) {
+        return -1;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    // Generate unique codes for items that don't have one
+    int codeIndex = 1;
+    for (auto &item : items) {
+        if (item.code.isEmpty()) {
+            item.code = generateItemCode(item.name, item.notes, codeIndex);
+        }
+        codeIndex++;
+    }
 
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (!database->beginTransaction()) {
+        return -1;
+    }
 
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parse error:" << parseError.errorString();
-        return items;
+    if (clearExisting && !database->clearAllItems()) {
+        database->rollbackTransaction();
+        return -1;
     }
 
-    // Handle both formats:
-    // 1. Plain array: [ {...}, {...} ]
-    // 2. Wrapped object: { "items": [ {...}, {...} ] }
-    QJsonArray array;
+    int importedCount = database->addItems(items);
 
-    if (doc.isArray()) {
-        // Plain array format
-        array = doc.array();
-    } else if (doc.isObject()) {
-        // Wrapped object format - look for "items" key
-        QJsonObject root = doc.object();
-        if (root.contains("items") && root["items"].isArray()) {
-            array = root["items"].toArray();
-            qDebug() << "Loading from wrapped format, version:" << root["version"].toString();
-        } else {
-            qWarning() << "JSON object does not contain 'items' array";
-            return items;
-        }
-    } else {
-        qWarning() << "JSON root is neither array nor object";
-        return items;
+    if (importedCount < 0 || !database->commitTransaction()) {
+        database->rollbackTransaction();
+        return -1;
     }
 
-    for (const QJsonValue &value : array) {
-        if (!value.isObject()) continue;
+    return importedCount;
+}
 
-        QJsonObject obj = value.toObject();
+std::optional<ImportDiff> ItemImporter::syncFromJson(const QString &jsonPath, Database *database)
+{
+    return syncItems(loadFromJson(jsonPath), database);
+}
 
-        Item item;
+std::optional<ImportDiff> ItemImporter::syncItems(QVector<Item> items, Database *database)
+{
+    FRONTIER_TRACE_SCOPE("ItemImporter::syncItems");
+    if (items.isEmpty()) {
+        return std::nullopt;
+    }
 
-        // Basic fields
-        item.code = obj["code"].toString();
-        item.name = obj["name"].toString();
+    const QVector<Item> stored = database->getAllItems();
+    QHash<QString, int> storedByCode;
+    QHash<QString, int> storedByName;
+    QSet<QString> usedCodes;
+    storedByCode.reserve(stored.size());
+    storedByName.reserve(stored.size());
+    for (int i = 0; i < stored.size(); ++i) {
+        storedByCode.insert(stored[i].code, i);
+        storedByName.insert(stored[i].name, i);
+        usedCodes.insert(stored[i].code);
+    }
 
-        // Categories - handle both old and new field names
-        item.categoryMain = obj["category_main"].toString();
-        if (item.categoryMain.isEmpty()) {
-            item.categoryMain = obj["categoryMain"].toString();
-        }
-        if (item.categoryMain.isEmpty()) {
-            item.categoryMain = obj["category"].toString();
+    ImportDiff diff;
+    QVector<bool> matched(stored.size(), false);
+    QVector<Item> inserts;
+
+    if (!database->beginTransaction()) {
+        return std::nullopt;
+    }
+
+    int codeIndex = 1;
+    for (auto &item : items) {
+        const bool hasCode = !item.code.isEmpty();
+        int row = hasCode ? storedByCode.value(item.code, -1) : -1;
+        if (row < 0) {
+            row = storedByName.value(item.name, -1);
         }
 
-        item.categorySub = obj["category_sub"].toString();
-        if (item.categorySub.isEmpty()) {
-            item.categorySub = obj["categorySub"].toString();
+        if (row < 0) {
+            // Generated codes depend on file position, so skip past any
+            // already taken
+            while (!hasCode && (item.code.isEmpty() || usedCodes.contains(item.code))) {
+                item.code = generateItemCode(item.name, item.notes, codeIndex++);
+            }
+            usedCodes.insert(item.code);
+            inserts.append(item);
+            continue;
         }
 
-        // Prices - handle both old and new field names
-        if (obj.contains("buy_price_internal")) {
-            item.buyPriceInternal = obj["buy_price_internal"].toDouble();
-        } else if (obj.contains("buyPriceInternal")) {
-            item.buyPriceInternal = obj["buyPriceInternal"].toDouble();
-        } else if (obj.contains("buyPrice")) {
-            item.buyPriceInternal = obj["buyPrice"].toDouble();
-        } else if (obj.contains("buy_price")) {
-            item.buyPriceInternal = obj["buy_price"].toDouble();
+        if (matched[row]) {
+            qWarning() << "Skipping duplicate item in import:" << item.name;
+            continue;
         }
+        matched[row] = true;
 
-        if (obj.contains("buy_price_display")) {
-            item.buyPriceDisplay = obj["buy_price_display"].toDouble();
-        } else if (obj.contains("buyPriceDisplay")) {
-            item.buyPriceDisplay = obj["buyPriceDisplay"].toDouble();
-        } else {
-            item.buyPriceDisplay = std::round(item.buyPriceInternal);
+        const Item &current = stored[row];
+        item.id = current.id;
+        if (!hasCode) {
+            item.code = current.code;
         }
 
-        if (obj.contains("sell_price_internal")) {
-            item.sellPriceInternal = obj["sell_price_internal"].toDouble();
-        } else if (obj.contains("sellPriceInternal")) {
-            item.sellPriceInternal = obj["sellPriceInternal"].toDouble();
+        if (storedFingerprint(item) == storedFingerprint(current)) {
+            ++diff.unchanged;
+        } else if (database->updateItem(item)) {
+            ++diff.updated;
         } else {
-            // Calculate from buy price (70% sell rate)
-            item.sellPriceInternal = item.buyPriceInternal * 0.70;
+            database->rollbackTransaction();
+            return std::nullopt;
         }
+    }
 
-        if (obj.contains("sell_price_display")) {
-            item.sellPriceDisplay = obj["sell_price_display"].toDouble();
-        } else if (obj.contains("sellPriceDisplay")) {
-            item.sellPriceDisplay = obj["sellPriceDisplay"].toDouble();
-        } else {
-            item.sellPriceDisplay = std::round(item.sellPriceInternal);
+    for (int i = 0; i < stored.size(); ++i) {
+        if (matched[i]) {
+            continue;
+        }
+        if (!database->deleteItem(stored[i].id.value_or(-1))) {
+            database->rollbackTransaction();
+            return std::nullopt;
         }
+        ++diff.deleted;
+    }
 
-        // Weight
-        item.weight = obj["weight"].toDouble(0.0);
+    if (!inserts.isEmpty()) {
+        diff.inserted = database->addItems(inserts);
+    }
 
-        // Boolean flags
-        if (obj.contains("is_purchasable")) {
-            item.isPurchasable = obj["is_purchasable"].toBool(true);
-        } else if (obj.contains("isPurchasable")) {
-            item.isPurchasable = obj["isPurchasable"].toBool(true);
-        } else {
-            item.isPurchasable = true;
-        }
+    if (diff.inserted < 0 || !database->commitTransaction()) {
+        database->rollbackTransaction();
+        return std::nullopt;
+    }
 
-        if (obj.contains("is_sellable")) {
-            item.isSellable = obj["is_sellable"].toBool(true);
-        } else if (obj.contains("isSellable")) {
-            item.isSellable = obj["isSellable"].toBool(true);
-        } else {
-            item.isSellable = true;
-        }
+    qDebug() << "Item sync complete:" << diff.inserted << "added," << diff.updated << "updated,"
+             << diff.deleted << "removed," << diff.unchanged << "unchanged";
 
-        if (obj.contains("is_craftable")) {
-            item.isCraftable = obj["is_craftable"].toBool(false);
-        } else if (obj.contains("isCraftable")) {
-            item.isCraftable = obj["isCraftable"].toBool(false);
-        } else {
-            item.isCraftable = false;
-        }
+    return diff;
+}
 
-        // Pricing group
-        QString pricingGroupStr = obj["pricing_group"].toString();
-        if (pricingGroupStr.isEmpty()) {
-            pricingGroupStr = obj["pricingGroup"].toString("Base70");
-        }
-        item.pricingGroup = stringToPricingGroup(pricingGroupStr);
+QVector<Item> ItemImporter::loadFromJson(const QString &jsonPath)
+{
+    FRONTIER_TRACE_SCOPE("ItemImporter::loadFromJson");
+    QVector<Item> items;
 
-        // Notes
-        item.notes = obj["notes"].toString();
+    // Handles both a plain array and the wrapped { "items": [...] } format
+    JsonStreamReader reader(jsonPath);
+    bool ok = reader.readArray([&items](const QJsonObject &record) {
+        items.append(itemFromJson(record));
+        return true;
+    }, "items");
 
-        items.append(item);
+    if (!ok) {
+        qWarning() << "Could not load items from" << jsonPath << ":" << reader.errorString();
+        items.clear();
     }
 
     return items;
@@ -256,7 +398,7 @@ QVector<Item> ItemImporter::loadFromJson(const QString &jsonPath)
 
 int ItemImporter::getItemCount(Database *database)
 {
-    return database->getAllItems().size();
+    return database->getItemCount();
 }
 
 } // namespace Frontier
@@ -8,6 +8,7 @@
 
 #include <QString>
 #include <QVector>
+#include <optional>
 #include "types.h"
 
 namespace Frontier {
@@ -26,6 +27,26 @@ public:
      */
     static int importFromJson(const QString &jsonPath, Database *database, bool clearExisting = false);
 
+    /**
+     * @brief Bring the items table in line with a JSON file, touching only what changed
+     *
+     * Incoming items are matched to stored ones by code, falling back to
+     * name, and compared through a fingerprint of the
+     * stored columns. Matched items keep their id and code; new items are
+     * inserted, changed ones updated and items missing from the file
+     * deleted, all in one transaction.
+     *
+     * @param jsonPath Path to JSON file
+     * @param database Database instance
+     * @return Per-row counts, or std::nullopt on error (nothing is written)
+     */
+    static std::optional<ImportDiff> syncFromJson(const QString &jsonPath, Database *database);
+
+    // The write halves of importFromJson and syncFromJson, for items that
+    // were already loaded (e.g. on a worker thread by ImportPipeline)
+    static int importItems(QVector<Item> items, Database *database, bool clearExisting = false);
+    static std::optional<ImportDiff> syncItems(QVector<Item> items, Database *database);
+
     /**
      * @brief Load items from JSON without database import
      * @param jsonPath Path to JSON file
@@ -0,0 +1,349 @@
+/**
+ * @file jsonstreamreader.cpp
+ * @brief Record-at-a-time JSON reader implementation
+ */
+
+#include "jsonstreamreader.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonParseError>
+#include <QVarLengthArray>
+
+namespace Frontier {
+
+namespace {
+
+/**
+ * @brief Forward-only tokenizer over the mapped bytes
+ *
+ * Knows just enough JSON to find where a value ends: strings with their
+ * escapes, and balanced brackets. Values handed out as records are
+ * validated by QJsonDocument when they are parsed.
+ */
+class Cursor
+{
+public:
+    Cursor(const char *data, qint64 size) : m_data(data), m_size(size)
+    {
+        // Editors on Windows like to prepend a UTF-8 byte order mark
+        if (size >= 3 && qstrncmp(data, "\xEF\xBB\xBF", 3) == 0) {
+            m_pos = 3;
+        }
+    }
+
+    qint64 pos() const { return m_pos; }
+    QString error() const { return m_error; }
+
+    void skipSpace()
+    {
+        while (m_pos < m_size) {
+            const char c = m_data[m_pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                break;
+            }
+            ++m_pos;
+        }
+    }
+
+    char peek()
+    {
+        skipSpace();
+        return m_pos < m_size ? m_data[m_pos] : '\0';
+    }
+
+    bool consume(char c)
+    {
+        if (peek() != c) {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    bool expect(char c)
+    {
+        if (consume(c)) {
+            return true;
+        }
+        return fail(QString("expected '%1'").arg(QChar(c)));
+    }
+
+    bool fail(const QString &what)
+    {
+        if (m_error.isEmpty()) {
+            m_error = QString("JSON parse error at offset %1: %2").arg(m_pos).arg(what);
+        }
+        return false;
+    }
+
+    // Reads an object key, which must be the next token
+    bool readKey(QString *key)
+    {
+        if (peek() != '"') {
+            return fail("expected a member name");
+        }
+        const qint64 start = m_pos;
+        if (!skipString()) {
+            return false;
+        }
+
+        const QByteArray raw = QByteArray::fromRawData(m_data + start + 1, m_pos - start - 2);
+        if (!raw.contains('\\')) {
+            *key = QString::fromUtf8(raw);
+            return true;
+        }
+
+        // Rare: let QJsonDocument decode the escapes
+        const QByteArray wrapped = '[' + QByteArray(m_data + start, m_pos - start) + ']';
+        const QJsonArray decoded = QJsonDocument::fromJson(wrapped).array();
+        *key = decoded.isEmpty() ? QString() : decoded.first().toString();
+        return true;
+    }
+
+    // Advances past the next value without interpreting it
+    bool skipValue()
+    {
+        const char first = peek();
+        if (first == '\0') {
+            return fail("unexpected end of file");
+        }
+        if (first == '"') {
+            return skipString();
+        }
+        if (first != '{' && first != '[') {
+            while (m_pos < m_size && !isDelimiter(m_data[m_pos])) {
+                ++m_pos;
+            }
+            return true;
+        }
+
+        QVarLengthArray<char, 32> closers;
+        while (m_pos < m_size) {
+            const char c = m_data[m_pos];
+            if (c == '"') {
+                if (!skipString()) {
+                    return false;
+                }
+                continue;
+            }
+            ++m_pos;
+            if (c == '{') {
+                closers.append('}');
+            } else if (c == '[') {
+                closers.append(']');
+            } else if (c == '}' || c == ']') {
+                if (closers.isEmpty() || closers.last() != c) {
+                    --m_pos;
+                    return fail("mismatched bracket");
+                }
+                closers.removeLast();
+                if (closers.isEmpty()) {
+                    return true;
+                }
+            }
+        }
+        return fail("unexpected end of file");
+    }
+
+    QByteArray slice(qint64 start, qint64 end) const
+    {
+        return QByteArray::fromRawData(m_data + start, end - start);
+    }
+
+private:
+    static bool isDelimiter(char c)
+    {
+        return c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool skipString()
+    {
+        ++m_pos;                         // Opening quote
+        while (m_pos < m_size) {
+            const char c = m_data[m_pos++];
+            if (c == '\\') {
+                ++m_pos;
+            } else if (c == '"') {
+                return true;
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    const char *m_data;
+    qint64 m_size;
+    qint64 m_pos = 0;
+    QString m_error;
+};
+
+enum class ReadState { Done, Stopped, Failed };
+
+// Reads the elements of an array whose '[' was just consumed
+ReadState readElements(Cursor &cursor, const JsonStreamReader::RecordHandler &onRecord,
+                       int *records, QString *error)
+{
+    if (cursor.consume(']')) {
+        return ReadState::Done;
+    }
+
+    while (true) {
+        const bool isObject = cursor.peek() == '{';
+        const qint64 start = cursor.pos();
+        if (!cursor.skipValue()) {
+            *error = cursor.error();
+            return ReadState::Failed;
+        }
+
+        if (isObject) {
+            QJsonParseError parseError;
+            const QJsonDocument doc = QJsonDocument::fromJson(cursor.slice(start, cursor.pos()), &parseError);
+            if (parseError.error != QJsonParseError::NoError) {
+                *error = QString("JSON parse error at offset %1: %2")
+                             .arg(start + parseError.offset)
+                             .arg(parseError.errorString());
+                return ReadState::Failed;
+            }
+            ++*records;
+            if (!onRecord(doc.object())) {
+                return ReadState::Stopped;
+            }
+        }
+
+        if (cursor.consume(',')) {
+            continue;
+        }
+        if (cursor.consume(']')) {
+            return ReadState::Done;
+        }
+        cursor.fail("expected ',' or ']'");
+        *error = cursor.error();
+        return ReadState::Failed;
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// JsonStreamReader
+// =============================================================================
+
+JsonStreamReader::JsonStreamReader(const QString &filePath)
+    : m_file(filePath)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = QString("Could not open file: %1").arg(m_file.errorString());
+        return;
+    }
+
+    m_size = m_file.size();
+    if (m_size == 0) {
+        m_error = "File is empty";
+        return;
+    }
+
+    m_mapped = m_file.map(0, m_size);
+    if (m_mapped) {
+        m_data = reinterpret_cast<const char *>(m_mapped);
+        return;
+    }
+
+    // Mapping can fail on some filesystems; fall back to one read
+    m_buffer = m_file.readAll();
+    m_data = m_buffer.constData();
+    m_size = m_buffer.size();
+}
+
+JsonStreamReader::~JsonStreamReader()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+    }
+}
+
+bool JsonStreamReader::readArray(const RecordHandler &onRecord, const QString &wrapperKey)
+{
+    m_records = 0;
+    if (!isOpen()) {
+        return false;
+    }
+    m_error.clear();
+
+    Cursor cursor(m_data, m_size);
+    if (cursor.consume('[')) {
+        return readElements(cursor, onRecord, &m_records, &m_error) != ReadState::Failed;
+    }
+
+    if (wrapperKey.isEmpty() || !cursor.consume('{')) {
+        m_error = wrapperKey.isEmpty() ? "JSON root is not an array"
+                                       : "JSON root is neither array nor object";
+        return false;
+    }
+
+    if (!cursor.consume('}')) {
+        do {
+            QString key;
+            if (!cursor.readKey(&key) || !cursor.expect(':')) {
+                m_error = cursor.error();
+                return false;
+            }
+            if (key == wrapperKey && cursor.consume('[')) {
+                return readElements(cursor, onRecord, &m_records, &m_error) != ReadState::Failed;
+            }
+            if (!cursor.skipValue()) {
+                m_error = cursor.error();
+                return false;
+            }
+        } while (cursor.consume(','));
+    }
+
+    m_error = QString("JSON object does not contain '%1' array").arg(wrapperKey);
+    return false;
+}
+
+bool JsonStreamReader::readGroups(const GroupHandler &onGroup, const RecordHandler &onRecord)
+{
+    m_records = 0;
+    if (!isOpen()) {
+        return false;
+    }
+    m_error.clear();
+
+    Cursor cursor(m_data, m_size);
+    if (!cursor.consume('{')) {
+        m_error = "JSON root is not an object";
+        return false;
+    }
+    if (cursor.consume('}')) {
+        return true;
+    }
+
+    do {
+        QString group;
+        if (!cursor.readKey(&group) || !cursor.expect(':')) {
+            m_error = cursor.error();
+            return false;
+        }
+        if (!onGroup(group)) {
+            return true;
+        }
+
+        if (cursor.consume('[')) {
+            ReadState state = readElements(cursor, onRecord, &m_records, &m_error);
+            if (state != ReadState::Done) {
+                return state == ReadState::Stopped;
+            }
+        } else if (!cursor.skipValue()) {
+            m_error = cursor.error();
+            return false;
+        }
+    } while (cursor.consume(','));
+
+    if (!cursor.expect('}')) {
+        m_error = cursor.error();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Frontier
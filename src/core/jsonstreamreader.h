@@ -0,0 +1,70 @@
+/**
+ * @file jsonstreamreader.h
+ * @brief Record-at-a-time reader for large JSON reference files
+ */
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QJsonObject>
+#include <functional>
+
+namespace Frontier {
+
+/**
+ * @brief Walks a JSON file's record array without building a document
+ *
+ * The file is memory-mapped and tokenized in one forward pass; only the
+ * outer structure (the record array, or the object that wraps it) is
+ * scanned in place. Each element of the array is parsed on its own into
+ * a QJsonObject and handed to the caller, so peak memory is one record
+ * rather than a DOM of the whole file. Elements that are not objects are
+ * skipped, as the DOM loaders did.
+ *
+ * Supported layouts:
+ *   [ {...}, ... ]                      readArray()
+ *   { "items": [ {...}, ... ], ... }    readArray("items")
+ *   { "group": [ {...}, ... ], ... }    readGroups()
+ */
+class JsonStreamReader
+{
+public:
+    // Return false to stop reading early
+    using RecordHandler = std::function<bool(const QJsonObject &record)>;
+    using GroupHandler = std::function<bool(const QString &group)>;
+
+    explicit JsonStreamReader(const QString &filePath);
+    ~JsonStreamReader();
+
+    JsonStreamReader(const JsonStreamReader &) = delete;
+    JsonStreamReader &operator=(const JsonStreamReader &) = delete;
+
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_error; }
+    int recordCount() const { return m_records; }
+
+    // Top-level array, or with wrapperKey also the array under that key
+    // of a top-level object
+    bool readArray(const RecordHandler &onRecord, const QString &wrapperKey = QString());
+
+    // Top-level object whose members are record arrays; onGroup is called
+    // with each member name before that member's records
+    bool readGroups(const GroupHandler &onGroup, const RecordHandler &onRecord);
+
+private:
+    QFile m_file;
+    uchar *m_mapped = nullptr;
+    QByteArray m_buffer;             // Used when the file cannot be mapped
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+
+    QString m_error;
+    int m_records = 0;
+};
+
+} // namespace Frontier
+
+#endif // JSONSTREAMREADER_H
@@ -5,12 +5,13 @@
 
 #include "locationimporter.h"
 #include "database.h"
+#include "jsonstreamreader.h"
+#include "tracing.h"
 
 #include <QFile>
 #include <QDir>
-#include <QJsonDocument>
-#include <QJsonArray>
 #include <QJsonObject>
+#include <QHash>
 #include <QDebug>
 
 namespace Frontier {
@@ -20,6 +21,9 @@ int LocationImporter::s_mapsImported = 0;
 int LocationImporter::s_typesImported = 0;
 int LocationImporter::s_locationsImported = 0;
 QString LocationImporter::s_lastError;
+ImportDiff LocationImporter::s_mapsDiff;
+ImportDiff LocationImporter::s_typesDiff;
+ImportDiff LocationImporter::s_locationsDiff;
 
 bool LocationImporter::importFromJson(const QString &mapsPath,
                                       const QString &typesPath,
@@ -27,27 +31,35 @@ bool LocationImporter::importFromJson(const QString &mapsPath,
                                       Database *database,
                                       bool clearExisting)
 {
+    FRONTIER_TRACE_SCOPE("LocationImporter::importFromJson");
     s_mapsImported = 0;
     s_typesImported = 0;
     s_locationsImported = 0;
     s_lastError.clear();
 
     // Load all data first (validate before modifying database)
-    QVector<Map> maps = loadMapsFromJson(mapsPath);
+    QVector<Map> maps = loadMapsFromJson(mapsPath, &s_lastError);
     if (maps.isEmpty() && !s_lastError.isEmpty()) {
         return false;
     }
 
-    QVector<LocationType> types = loadTypesFromJson(typesPath);
+    QVector<LocationType> types = loadTypesFromJson(typesPath, &s_lastError);
     if (types.isEmpty() && !s_lastError.isEmpty()) {
         return false;
     }
 
-    QVector<Location> locations = loadLocationsFromJson(locationsPath);
+    QVector<Location> locations = loadLocationsFromJson(locationsPath, &s_lastError);
     if (locations.isEmpty() && !s_lastError.isEmpty()) {
         return false;
     }
 
+    // Write everything inside one transaction so a failed import leaves
+    // the previous data intact
+    if (!database->beginTransaction()) {
+        s_lastError = database->lastError();
+        return false;
+    }
+
     // Clear existing data if requested (order matters due to foreign keys)
     if (clearExisting) {
         database->clearAllLocations();
@@ -81,20 +93,23 @@ bool LocationImporter::importFromJson(const QString &mapsPath,
         }
     }
 
-    // Import locations with remapped IDs
+    // Remap foreign keys to new IDs, then import locations in one batch
     for (auto &loc : locations) {
-        // Remap foreign keys to new IDs
         loc.mapId = mapIdMapping.value(loc.mapId, loc.mapId);
         loc.typeId = typeIdMapping.value(loc.typeId, loc.typeId);
+    }
 
-        int newId = database->addLocation(loc);
-        if (newId > 0) {
-            s_locationsImported++;
-        } else {
-            qWarning() << "Failed to import location:" << loc.name;
-        }
+    int added = database->addLocations(locations);
+    if (added < 0 || !database->commitTransaction()) {
+        s_lastError = QString("Failed to write locations: %1").arg(database->lastError());
+        database->rollbackTransaction();
+        s_mapsImported = 0;
+        s_typesImported = 0;
+        return false;
     }
 
+    s_locationsImported = added;
+
     qDebug() << "Location import complete:"
              << s_mapsImported << "maps,"
              << s_typesImported << "types,"
@@ -107,59 +122,237 @@ bool LocationImporter::importFromDirectory(const QString &directoryPath,
                                            Database *database,
                                            bool clearExisting)
 {
+    if (!checkFilesExist(directoryPath)) {
+        return false;
+    }
+
     QDir dir(directoryPath);
+    return importFromJson(dir.filePath("maps.json"), dir.filePath("location_types.json"),
+                          dir.filePath("locations.json"), database, clearExisting);
+}
+
+bool LocationImporter::checkFilesExist(const QString &directoryPath)
+{
+    QDir dir(directoryPath);
+    for (const char *name : {"maps.json", "location_types.json", "locations.json"}) {
+        if (!QFile::exists(dir.filePath(name))) {
+            s_lastError = QString("%1 not found in %2").arg(name, directoryPath);
+            return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Differential Sync
+// =============================================================================
+
+bool LocationImporter::syncFromJson(const QString &mapsPath,
+                                    const QString &typesPath,
+                                    const QString &locationsPath,
+                                    Database *database)
+{
+    s_lastError.clear();
+
+    // Load all data first (validate before modifying database)
+    QVector<Map> maps = loadMapsFromJson(mapsPath, &s_lastError);
+    if (maps.isEmpty() && !s_lastError.isEmpty()) {
+        return false;
+    }
 
-    QString mapsPath = dir.filePath("maps.json");
-    QString typesPath = dir.filePath("location_types.json");
-    QString locationsPath = dir.filePath("locations.json");
+    QVector<LocationType> types = loadTypesFromJson(typesPath, &s_lastError);
+    if (types.isEmpty() && !s_lastError.isEmpty()) {
+        return false;
+    }
 
-    // Check all files exist
-    if (!QFile::exists(mapsPath)) {
-        s_lastError = QString("maps.json not found in %1").arg(directoryPath);
+    QVector<Location> locations = loadLocationsFromJson(locationsPath, &s_lastError);
+    if (locations.isEmpty() && !s_lastError.isEmpty()) {
         return false;
     }
-    if (!QFile::exists(typesPath)) {
-        s_lastError = QString("location_types.json not found in %1").arg(directoryPath);
+
+    return syncLocations(maps, types, locations, database);
+}
+
+bool LocationImporter::syncLocations(const QVector<Map> &maps,
+                                     const QVector<LocationType> &types,
+                                     const QVector<Location> &locations,
+                                     Database *database)
+{
+    FRONTIER_TRACE_SCOPE("LocationImporter::syncLocations");
+    s_mapsImported = 0;
+    s_typesImported = 0;
+    s_locationsImported = 0;
+    s_mapsDiff = ImportDiff();
+    s_typesDiff = ImportDiff();
+    s_locationsDiff = ImportDiff();
+    s_lastError.clear();
+
+    if (!database->beginTransaction()) {
+        s_lastError = database->lastError();
         return false;
     }
-    if (!QFile::exists(locationsPath)) {
-        s_lastError = QString("locations.json not found in %1").arg(directoryPath);
+
+    if (!syncTables(maps, types, locations, database) || !database->commitTransaction()) {
+        if (s_lastError.isEmpty()) {
+            s_lastError = QString("Failed to sync locations: %1").arg(database->lastError());
+        }
+        database->rollbackTransaction();
+        s_mapsDiff = ImportDiff();
+        s_typesDiff = ImportDiff();
+        s_locationsDiff = ImportDiff();
         return false;
     }
 
-    return importFromJson(mapsPath, typesPath, locationsPath, database, clearExisting);
+    s_mapsImported = s_mapsDiff.inserted + s_mapsDiff.updated;
+    s_typesImported = s_typesDiff.inserted;
+    s_locationsImported = s_locationsDiff.inserted + s_locationsDiff.updated;
+
+    qDebug() << "Location sync complete:"
+             << s_mapsDiff.changed() << "map,"
+             << s_typesDiff.changed() << "type and"
+             << s_locationsDiff.changed() << "location rows changed";
+
+    return true;
 }
 
-QVector<Map> LocationImporter::loadMapsFromJson(const QString &path)
+bool LocationImporter::syncFromDirectory(const QString &directoryPath, Database *database)
 {
-    QVector<Map> maps;
+    if (!checkFilesExist(directoryPath)) {
+        return false;
+    }
+
+    QDir dir(directoryPath);
+    return syncFromJson(dir.filePath("maps.json"), dir.filePath("location_types.json"),
+                        dir.filePath("locations.json"), database);
+}
+
+bool LocationImporter::syncTables(const QVector<Map> &maps,
+                                  const QVector<LocationType> &types,
+                                  QVector<Location> locations,
+                                  Database *database)
+{
+    FRONTIER_TRACE_SCOPE("LocationImporter::syncTables");
+    // === Maps, by abbreviation ===
+    QHash<QString, Map> storedMaps;
+    for (const auto &map : database->getAllMaps()) {
+        storedMaps.insert(map.abbrev, map);
+    }
 
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        s_lastError = QString("Cannot open maps file: %1").arg(file.errorString());
-        return maps;
+    QHash<int, int> mapIdMapping;    // file id -> database id
+    for (const auto &map : maps) {
+        auto it = storedMaps.find(map.abbrev);
+        int id = -1;
+        if (it == storedMaps.end()) {
+            id = database->addMap(map);
+            if (id < 0) {
+                return false;
+            }
+            ++s_mapsDiff.inserted;
+        } else {
+            Map current = it.value();
+            storedMaps.erase(it);
+            id = current.id.value_or(-1);
+            if (current.name == map.name) {
+                ++s_mapsDiff.unchanged;
+            } else {
+                current.name = map.name;
+                if (!database->updateMap(current)) {
+                    return false;
+                }
+                ++s_mapsDiff.updated;
+            }
+        }
+        mapIdMapping.insert(map.id.value_or(0), id);
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    // === Types, by name ===
+    QHash<QString, int> storedTypes;
+    for (const auto &type : database->getAllLocationTypes()) {
+        storedTypes.insert(type.name, type.id.value_or(-1));
+    }
 
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    QHash<int, int> typeIdMapping;   // file id -> database id
+    for (const auto &type : types) {
+        int id = storedTypes.take(type.name);
+        if (id > 0) {
+            ++s_typesDiff.unchanged;
+        } else {
+            id = database->addLocationType(type);
+            if (id < 0) {
+                return false;
+            }
+            ++s_typesDiff.inserted;
+        }
+        typeIdMapping.insert(type.id.value_or(0), id);
+    }
 
-    if (parseError.error != QJsonParseError::NoError) {
-        s_lastError = QString("JSON parse error in maps: %1").arg(parseError.errorString());
-        return maps;
+    // === Locations, by map and name ===
+    QHash<QPair<int, QString>, Location> storedLocations;
+    for (const auto &loc : database->getAllLocations()) {
+        storedLocations.insert({loc.mapId, loc.name}, loc);
     }
 
-    if (!doc.isArray()) {
-        s_lastError = "maps.json root is not an array";
-        return maps;
+    QVector<Location> inserts;
+    for (auto &loc : locations) {
+        loc.mapId = mapIdMapping.value(loc.mapId, loc.mapId);
+        loc.typeId = typeIdMapping.value(loc.typeId, loc.typeId);
+
+        auto it = storedLocations.find({loc.mapId, loc.name});
+        if (it == storedLocations.end()) {
+            inserts.append(loc);
+            continue;
+        }
+
+        Location current = it.value();
+        storedLocations.erase(it);
+        if (current.typeId == loc.typeId) {
+            ++s_locationsDiff.unchanged;
+        } else {
+            current.typeId = loc.typeId;
+            if (!database->updateLocation(current)) {
+                return false;
+            }
+            ++s_locationsDiff.updated;
+        }
+    }
+
+    if (!inserts.isEmpty()) {
+        s_locationsDiff.inserted = database->addLocations(inserts);
+        if (s_locationsDiff.inserted < 0) {
+            return false;
+        }
+    }
+
+    // === Remove rows the files no longer list (locations first, for the foreign keys) ===
+    for (const auto &loc : std::as_const(storedLocations)) {
+        if (!database->deleteLocation(loc.id.value_or(-1))) {
+            return false;
+        }
+        ++s_locationsDiff.deleted;
+    }
+    for (int id : std::as_const(storedTypes)) {
+        if (!database->deleteLocationType(id)) {
+            return false;
+        }
+        ++s_typesDiff.deleted;
+    }
+    for (const auto &map : std::as_const(storedMaps)) {
+        if (!database->deleteMap(map.id.value_or(-1))) {
+            return false;
+        }
+        ++s_mapsDiff.deleted;
     }
 
-    QJsonArray arr = doc.array();
-    for (const QJsonValue &val : arr) {
-        QJsonObject obj = val.toObject();
+    return true;
+}
 
+QVector<Map> LocationImporter::loadMapsFromJson(const QString &path, QString *error)
+{
+    FRONTIER_TRACE_SCOPE("LocationImporter::loadMapsFromJson");
+    QVector<Map> maps;
+
+    JsonStreamReader reader(path);
+    bool ok = reader.readArray([&maps](const QJsonObject &obj) {
         Map map;
         map.id = obj["id"].toInt();
         map.abbrev = obj["abbrev"].toString();
@@ -168,41 +361,24 @@ QVector<Map> LocationImporter::loadMapsFromJson(const QString &path)
         if (!map.abbrev.isEmpty() && !map.name.isEmpty()) {
             maps.append(map);
         }
+        return true;
+    });
+
+    if (!ok) {
+        *error = QString("Cannot read maps file: %1").arg(reader.errorString());
+        return {};
     }
 
     return maps;
 }
 
-QVector<LocationType> LocationImporter::loadTypesFromJson(const QString &path)
+QVector<LocationType> LocationImporter::loadTypesFromJson(const QString &path, QString *error)
 {
+    FRONTIER_TRACE_SCOPE("LocationImporter::loadTypesFromJson");
     QVector<LocationType> types;
 
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        s_lastError = QString("Cannot open location_types file: %1").arg(file.errorString());
-        return types;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        s_lastError = QString("JSON parse error in location_types: %1").arg(parseError.errorString());
-        return types;
-    }
-
-    if (!doc.isArray()) {
-        s_lastError = "location_types.json root is not an array";
-        return types;
-    }
-
-    QJsonArray arr = doc.array();
-    for (const QJsonValue &val : arr) {
-        QJsonObject obj = val.toObject();
-
+    JsonStreamReader reader(path);
+    bool ok = reader.readArray([&types](const QJsonObject &obj) {
         LocationType type;
         type.id = obj["id"].toInt();
         type.name = obj["name"].toString();
@@ -210,41 +386,24 @@ QVector<LocationType> LocationImporter::loadTypesFromJson(const QString &path)
         if (!type.name.isEmpty()) {
             types.append(type);
         }
+        return true;
+    });
+
+    if (!ok) {
+        *error = QString("Cannot read location_types file: %1").arg(reader.errorString());
+        return {};
     }
 
     return types;
 }
 
-QVector<Location> LocationImporter::loadLocationsFromJson(const QString &path)
+QVector<Location> LocationImporter::loadLocationsFromJson(const QString &path, QString *error)
 {
+    FRONTIER_TRACE_SCOPE("LocationImporter::loadLocationsFromJson");
     QVector<Location> locations;
 
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        s_lastError = QString("Cannot open locations file: %1").arg(file.errorString());
-        return locations;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        s_lastError = QString("JSON parse error in locations: %1").arg(parseError.errorString());
-        return locations;
-    }
-
-    if (!doc.isArray()) {
-        s_lastError = "locations.json root is not an array";
-        return locations;
-    }
-
-    QJsonArray arr = doc.array();
-    for (const QJsonValue &val : arr) {
-        QJsonObject obj = val.toObject();
-
+    JsonStreamReader reader(path);
+    bool ok = reader.readArray([&locations](const QJsonObject &obj) {
         Location loc;
         loc.id = obj["id"].toInt();
         loc.name = obj["name"].toString();
@@ -254,6 +413,12 @@ QVector<Location> LocationImporter::loadLocationsFromJson(const QString &path)
         if (!loc.name.isEmpty() && loc.mapId > 0 && loc.typeId > 0) {
             locations.append(loc);
         }
+        return true;
+    });
+
+    if (!ok) {
+        *error = QString("Cannot read locations file: %1").arg(reader.errorString());
+        return {};
     }
 
     return locations;
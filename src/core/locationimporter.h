@@ -43,21 +43,59 @@ public:
                                     Database *database,
                                     bool clearExisting = true);
 
+    /**
+     * @brief Bring the location tables in line with JSON files, touching only what changed
+     *
+     * Maps are matched by abbreviation, types by name and locations by map
+     * and name. Matched rows keep their ids, so inventory and other rows
+     * that reference a location stay valid; new rows are inserted, changed
+     * ones updated and rows missing from the files deleted, all in one
+     * transaction. Counts are available from mapsDiff(), typesDiff() and
+     * locationsDiff() afterwards.
+     * @return true on success
+     */
+    static bool syncFromJson(const QString &mapsPath,
+                             const QString &typesPath,
+                             const QString &locationsPath,
+                             Database *database);
+
+    static bool syncFromDirectory(const QString &directoryPath, Database *database);
+
+    // Write half of syncFromJson, for tables that were already loaded
+    static bool syncLocations(const QVector<Map> &maps,
+                              const QVector<LocationType> &types,
+                              const QVector<Location> &locations,
+                              Database *database);
+
+    // File readers; they touch no shared state, so they may run on any
+    // thread. An empty result with *error set means the file was unusable
+    static QVector<Map> loadMapsFromJson(const QString &path, QString *error);
+    static QVector<LocationType> loadTypesFromJson(const QString &path, QString *error);
+    static QVector<Location> loadLocationsFromJson(const QString &path, QString *error);
+
     // Accessors for import results
     static int mapsImported() { return s_mapsImported; }
     static int typesImported() { return s_typesImported; }
     static int locationsImported() { return s_locationsImported; }
     static QString lastError() { return s_lastError; }
+    static ImportDiff mapsDiff() { return s_mapsDiff; }
+    static ImportDiff typesDiff() { return s_typesDiff; }
+    static ImportDiff locationsDiff() { return s_locationsDiff; }
 
 private:
-    static QVector<Map> loadMapsFromJson(const QString &path);
-    static QVector<LocationType> loadTypesFromJson(const QString &path);
-    static QVector<Location> loadLocationsFromJson(const QString &path);
+    static bool checkFilesExist(const QString &directoryPath);
+    static bool syncTables(const QVector<Map> &maps,
+                           const QVector<LocationType> &types,
+                           QVector<Location> locations,
+                           Database *database);
 
     static int s_mapsImported;
     static int s_typesImported;
     static int s_locationsImported;
     static QString s_lastError;
+    static ImportDiff s_mapsDiff;
+    static ImportDiff s_typesDiff;
+    static ImportDiff s_locationsDiff;
 };
 
 } // namespace Frontier
@@ -0,0 +1,201 @@
+/**
+ * @file movementcapture.cpp
+ * @brief Live movement event capture implementation
+ */
+
+#include "movementcapture.h"
+#include "database.h"
+#include "profiler.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTimer>
+
+namespace Frontier {
+
+// =============================================================================
+// MovementEventRing
+// =============================================================================
+
+MovementEventRing::MovementEventRing()
+    : m_cells(new Cell[Capacity])
+{
+    for (std::size_t i = 0; i < Capacity; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool MovementEventRing::push(const Item &item)
+{
+    std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;) {
+        cell = &m_cells[pos & (Capacity - 1)];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+        if (diff == 0) {
+            // The cell is free for this lap; claim it
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Still holds an item from the previous lap
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->item = item;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool MovementEventRing::pop(Item &item)
+{
+    std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;) {
+        cell = &m_cells[pos & (Capacity - 1)];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos + 1);
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Not yet published
+            return false;
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    item = std::move(cell->item);
+    cell->item = Item();
+    // Free for the producers' next lap
+    cell->sequence.store(pos + Capacity, std::memory_order_release);
+    return true;
+}
+
+// =============================================================================
+// MovementCapture
+// =============================================================================
+
+MovementCapture::MovementCapture(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+    , m_drainTimer(new QTimer(this))
+{
+    m_drainTimer->setInterval(DrainIntervalMs);
+    connect(m_drainTimer, &QTimer::timeout, this, &MovementCapture::onDrainTimer);
+}
+
+MovementCapture::~MovementCapture()
+{
+    stop();
+}
+
+void MovementCapture::start()
+{
+    m_running.store(true, std::memory_order_release);
+    m_drainTimer->start();
+}
+
+void MovementCapture::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    m_drainTimer->stop();
+    flush();
+}
+
+bool MovementCapture::record(int sessionId, const QString &equipmentId, MovementEventKind kind)
+{
+    if (!isRunning()) {
+        return false;
+    }
+
+    MovementEventRing::Item item;
+    item.sessionId = sessionId;
+    item.kind = kind;
+    item.msecs = QDateTime::currentMSecsSinceEpoch();
+    item.equipmentId = equipmentId;
+
+    if (!m_ring.push(item)) {
+        m_dropped.fetchAndAddRelaxed(1);
+        return false;
+    }
+    return true;
+}
+
+bool MovementCapture::flush()
+{
+    drain();
+    return writePending();
+}
+
+void MovementCapture::onDrainTimer()
+{
+    drain();
+    if (m_pending.size() >= BatchSize
+        || (!m_pending.isEmpty() && m_oldestPending.elapsed() >= FlushIntervalMs)) {
+        writePending();
+    }
+}
+
+void MovementCapture::drain()
+{
+    QVector<MovementEvent> events;
+    MovementEventRing::Item item;
+    while (m_ring.pop(item)) {
+        MovementEvent event;
+        event.sessionId = item.sessionId;
+        event.equipmentId = item.equipmentId;
+        event.kind = item.kind;
+        event.time = QDateTime::fromMSecsSinceEpoch(item.msecs);
+        events.append(event);
+    }
+    if (events.isEmpty()) {
+        return;
+    }
+
+    if (m_pending.isEmpty()) {
+        m_oldestPending.start();
+    }
+    m_pending += events;
+
+    // Only reached while writes fail; the newest are the ones worth keeping
+    if (m_pending.size() > MaxPending) {
+        const int excess = m_pending.size() - MaxPending;
+        m_pending.remove(0, excess);
+        m_dropped.fetchAndAddRelaxed(quint64(excess));
+        qWarning() << "Dropped" << excess << "unwritten movement events";
+    }
+    emit captured(events);
+}
+
+bool MovementCapture::writePending()
+{
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+
+    ProfileScope scope("MovementCapture::write");
+    const int rows = m_database->addMovementEvents(m_pending);
+    if (rows < 0) {
+        // Kept, and retried once another interval has passed
+        m_lastError = m_database->lastError();
+        qWarning() << "Failed to write" << m_pending.size() << "movement events; will retry:" << m_lastError;
+        m_oldestPending.start();
+        emit writeFailed(m_lastError);
+        return false;
+    }
+
+    m_pending.clear();
+    m_oldestPending.invalidate();
+    m_lastError.clear();
+    emit written(rows);
+    return true;
+}
+
+} // namespace Frontier
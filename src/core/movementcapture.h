@@ -0,0 +1,144 @@
+/**
+ * @file movementcapture.h
+ * @brief Live bucket and dump capture through a lock-free ring buffer
+ */
+
+#ifndef MOVEMENTCAPTURE_H
+#define MOVEMENTCAPTURE_H
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "types.h"
+
+class QTimer;
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Bounded multi-producer queue of captured events, free of locks
+ *
+ * A fixed array of cells, each with a sequence number saying whose turn it
+ * is: a producer claims the next enqueue position with one compare-and-swap
+ * and publishes the cell by advancing its sequence, and the consumer takes
+ * cells in order the same way. Neither side ever waits for the other, and
+ * a full ring refuses the push instead of blocking. The time is kept as
+ * milliseconds since the epoch so stamping an event is a clock read.
+ */
+class MovementEventRing
+{
+public:
+    struct Item {
+        int sessionId = 0;
+        MovementEventKind kind = MovementEventKind::Bucket;
+        qint64 msecs = 0;
+        QString equipmentId;
+    };
+
+    static constexpr std::size_t Capacity = 4096;   // A power of two
+    static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+    MovementEventRing();
+
+    // Any thread; false when full
+    bool push(const Item &item);
+    // One consumer at a time; false when empty
+    bool pop(Item &item);
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        Item item;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    // Apart, so producers and the consumer do not share a cache line
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+/**
+ * @brief Records movement events without waiting on SQLite
+ *
+ * record() only stamps the event and pushes it onto the ring, so a hotkey
+ * or overlay client on any thread returns at once however busy the
+ * database is. While running, a short timer on the owner thread drains the
+ * ring and emits captured() for live tallies, then holds the events until
+ * BatchSize are pending or the oldest has waited FlushIntervalMs, and
+ * writes them with Database::addMovementEvents() in one transaction. A
+ * batch that fails to write is kept and retried an interval later, and
+ * writeFailed() reports it. While writes keep failing at most MaxPending
+ * events are held: the oldest beyond that are dropped and counted with
+ * the ring's, so an unwritable database cannot grow memory without bound.
+ * The live tallies already have them; only the event log loses them.
+ *
+ * Belongs to the Database's thread.
+ */
+class MovementCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DrainIntervalMs = 100;
+    static constexpr int FlushIntervalMs = 2000;
+    static constexpr int BatchSize = 64;
+    static constexpr int MaxPending = int(MovementEventRing::Capacity);
+
+    explicit MovementCapture(Database *database, QObject *parent = nullptr);
+    ~MovementCapture();
+
+    void start();
+    // Drains and writes whatever is left
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Safe from any thread. False when stopped or when the ring is full;
+    // a full ring counts the event in droppedCount().
+    bool record(int sessionId, const QString &equipmentId, MovementEventKind kind);
+
+    // Drains the ring and writes everything pending now; false if the write failed
+    bool flush();
+
+    int pendingCount() const { return m_pending.size(); }
+    // Refused by a full ring or dropped from the pending batch
+    quint64 droppedCount() const { return m_dropped.loadRelaxed(); }
+    // The last write's error; empty once a write succeeds
+    QString lastError() const { return m_lastError; }
+
+signals:
+    // Each drain's events, in capture order, before they are written
+    void captured(const QVector<Frontier::MovementEvent> &events);
+    void written(int rows);
+    // A batch could not be written; it is kept (up to MaxPending) for a retry
+    void writeFailed(const QString &error);
+
+private slots:
+    void onDrainTimer();
+
+private:
+    void drain();
+    bool writePending();
+
+    Database *m_database;
+    MovementEventRing m_ring;
+    QTimer *m_drainTimer;
+    std::atomic<bool> m_running{false};
+    QAtomicInteger<quint64> m_dropped;
+
+    // Drained, not yet written; m_oldestPending runs while any are
+    QVector<MovementEvent> m_pending;
+    QElapsedTimer m_oldestPending;
+    QString m_lastError;
+};
+
+} // namespace Frontier
+
+#endif // MOVEMENTCAPTURE_H
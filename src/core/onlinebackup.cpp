@@ -0,0 +1,321 @@
+/**
+ * @file onlinebackup.cpp
+ * @brief Online database backup implementation
+ */
+
+#include "onlinebackup.h"
+#include "profiler.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QUuid>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+
+#ifdef FRONTIER_HAVE_SQLITE3
+#include <sqlite3.h>
+#else
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#endif
+
+namespace Frontier {
+
+namespace {
+
+const QByteArray SnapshotMagic("FMSNAP1\n");
+const QString CompressedSuffix(".db.fmz");
+
+// A copy restarted this many times by other writers finishes in one step
+constexpr int MaxRestarts = 3;
+
+QString snapshotBase(const QString &databasePath)
+{
+    return QFileInfo(databasePath).completeBaseName();
+}
+
+} // namespace
+
+OnlineBackup::OnlineBackup(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<Frontier::BackupResult>();
+    connect(&m_watcher, &QFutureWatcher<BackupResult>::finished, this, &OnlineBackup::onFinished);
+}
+
+OnlineBackup::~OnlineBackup()
+{
+    // The copy posts progress to this object; stop it before it goes
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool OnlineBackup::start(const QString &databasePath, const BackupOptions &options)
+{
+    if (isRunning()) {
+        qWarning() << "Backup already running";
+        return false;
+    }
+    if (!QFileInfo::exists(databasePath)) {
+        qWarning() << "Cannot back up" << databasePath << ": no such file";
+        return false;
+    }
+
+    m_cancelled = std::make_shared<std::atomic_bool>(false);
+    m_watcher.setFuture(QtConcurrent::run(&OnlineBackup::run, databasePath, options, this, m_cancelled));
+    return true;
+}
+
+void OnlineBackup::cancel()
+{
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+void OnlineBackup::onFinished()
+{
+    emit finished(m_watcher.result());
+}
+
+QStringList OnlineBackup::snapshots(const QString &databasePath, const QString &directory)
+{
+    const QString base = snapshotBase(databasePath);
+    // Timestamped names sort by age
+    QStringList names = QDir(directory).entryList({base + "-*.db", base + "-*" + CompressedSuffix},
+                                                  QDir::Files, QDir::Name | QDir::Reversed);
+    for (QString &name : names) {
+        name = QDir(directory).filePath(name);
+    }
+    return names;
+}
+
+// =============================================================================
+// Background Run
+// =============================================================================
+
+BackupResult OnlineBackup::run(QString source, BackupOptions options, OnlineBackup *self,
+                               std::shared_ptr<std::atomic_bool> cancelled)
+{
+    ProfileScope scope("OnlineBackup::run");
+    BackupResult result;
+
+    const QString directory = options.directory.isEmpty() ? QFileInfo(source).absolutePath()
+                                                          : options.directory;
+    if (!QDir().mkpath(directory)) {
+        result.error = QString("Cannot create %1").arg(directory);
+        return result;
+    }
+
+    const QString stem = QDir(directory).filePath(
+        snapshotBase(source) + "-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+    const QString finalPath = stem + (options.compress ? CompressedSuffix : QString(".db"));
+    const QString partPath = stem + ".db.part";
+    QFile::remove(partPath);
+
+    if (!copy(source, partPath, options, self, *cancelled, &result.error)) {
+        QFile::remove(partPath);
+        result.cancelled = cancelled->load();
+        return result;
+    }
+
+    if (options.compress) {
+        const bool compressed = compressFile(partPath, finalPath + ".part", &result.error);
+        QFile::remove(partPath);
+        if (!compressed || !QFile::rename(finalPath + ".part", finalPath)) {
+            QFile::remove(finalPath + ".part");
+            if (result.error.isEmpty()) {
+                result.error = QString("Cannot write %1").arg(finalPath);
+            }
+            return result;
+        }
+    } else if (!QFile::rename(partPath, finalPath)) {
+        QFile::remove(partPath);
+        result.error = QString("Cannot write %1").arg(finalPath);
+        return result;
+    }
+
+    result.ok = true;
+    result.path = finalPath;
+    result.bytes = QFileInfo(finalPath).size();
+
+    if (options.keep > 0) {
+        const QStringList existing = snapshots(source, directory);
+        for (int i = options.keep; i < existing.size(); ++i) {
+            if (QFile::remove(existing[i])) {
+                result.removed.append(existing[i]);
+            }
+        }
+    }
+    return result;
+}
+
+bool OnlineBackup::copy(const QString &source, const QString &dest, const BackupOptions &options,
+                        OnlineBackup *self, const std::atomic_bool &cancelled, QString *error)
+{
+    auto report = [self](int done, int total) {
+        QMetaObject::invokeMethod(self, [self, done, total]() {
+            emit self->progress(done, total);
+        }, Qt::QueuedConnection);
+    };
+
+#ifdef FRONTIER_HAVE_SQLITE3
+    // Both ends are opened here, so the handles come from the SQLite this
+    // file links rather than from the Qt driver's copy
+    sqlite3 *src = nullptr;
+    sqlite3 *dst = nullptr;
+    auto closeBoth = [&]() {
+        sqlite3_close(src);
+        sqlite3_close(dst);
+    };
+
+    if (sqlite3_open_v2(source.toUtf8().constData(), &src, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK
+        || sqlite3_open_v2(dest.toUtf8().constData(), &dst,
+                           SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        *error = QString::fromUtf8(sqlite3_errmsg(dst ? dst : src));
+        closeBoth();
+        return false;
+    }
+    sqlite3_busy_timeout(src, 5000);
+
+    sqlite3_backup *backup = sqlite3_backup_init(dst, "main", src, "main");
+    if (!backup) {
+        *error = QString::fromUtf8(sqlite3_errmsg(dst));
+        closeBoth();
+        return false;
+    }
+
+    int rc = SQLITE_OK;
+    int restarts = 0;
+    int lastRemaining = -1;
+    while (!cancelled.load()) {
+        // A copy that keeps being restarted is finished in one step; in
+        // WAL mode that still lets writers through
+        const int pages = restarts >= MaxRestarts ? -1 : qMax(1, options.pagesPerStep);
+        rc = sqlite3_backup_step(backup, pages);
+
+        const int total = sqlite3_backup_pagecount(backup);
+        const int remaining = sqlite3_backup_remaining(backup);
+        if (lastRemaining >= 0 && remaining > lastRemaining) {
+            ++restarts;
+        }
+        lastRemaining = remaining;
+        report(total - remaining, total);
+
+        if (rc == SQLITE_DONE) {
+            break;
+        }
+        if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED) {
+            break;
+        }
+        sqlite3_sleep(rc == SQLITE_OK ? options.pauseMs : qMax(options.pauseMs, 50));
+    }
+
+    sqlite3_backup_finish(backup);
+    const bool ok = rc == SQLITE_DONE && !cancelled.load();
+    if (!ok) {
+        *error = cancelled.load() ? QString("Cancelled") : QString::fromUtf8(sqlite3_errstr(rc));
+    }
+    closeBoth();
+    return ok;
+#else
+    Q_UNUSED(options);
+    if (cancelled.load()) {
+        *error = "Cancelled";
+        return false;
+    }
+
+    const QString name = "backup-" + QUuid::createUuid().toString();
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+        db.setDatabaseName(source);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+        if (!db.open()) {
+            *error = db.lastError().text();
+        } else {
+            report(0, 1);
+            QString target = dest;
+            target.replace("'", "''");
+            QSqlQuery query(db);
+            ok = query.exec(QString("VACUUM INTO '%1'").arg(target));
+            if (!ok) {
+                *error = query.lastError().text();
+            }
+            report(1, 1);
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return ok;
+#endif
+}
+
+// =============================================================================
+// Compression
+// =============================================================================
+
+bool OnlineBackup::compressFile(const QString &source, const QString &dest, QString *error)
+{
+    QFile in(source);
+    QFile out(dest);
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = in.isOpen() ? out.errorString() : in.errorString();
+        return false;
+    }
+
+    // Framed chunks keep memory bounded whatever the file size
+    out.write(SnapshotMagic);
+    QDataStream stream(&out);
+    while (!in.atEnd()) {
+        const QByteArray chunk = in.read(ChunkBytes);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        stream << qCompress(chunk);
+    }
+
+    if (stream.status() != QDataStream::Ok || in.error() != QFile::NoError) {
+        *error = out.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool OnlineBackup::decompress(const QString &snapshotPath, const QString &databasePath, QString *error)
+{
+    QFile in(snapshotPath);
+    QFile out(databasePath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        if (error) *error = in.errorString();
+        return false;
+    }
+    if (in.read(SnapshotMagic.size()) != SnapshotMagic) {
+        if (error) *error = QString("%1 is not a compressed snapshot").arg(snapshotPath);
+        return false;
+    }
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = out.errorString();
+        return false;
+    }
+
+    QDataStream stream(&in);
+    while (!stream.atEnd()) {
+        QByteArray frame;
+        stream >> frame;
+        const QByteArray chunk = qUncompress(frame);
+        if (stream.status() != QDataStream::Ok || (chunk.isEmpty() && !frame.isEmpty())
+            || out.write(chunk) != chunk.size()) {
+            if (error) *error = QString("%1 is damaged").arg(snapshotPath);
+            out.remove();
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Frontier
@@ -0,0 +1,103 @@
+/**
+ * @file onlinebackup.h
+ * @brief Copies the open database file on a background thread
+ */
+
+#ifndef ONLINEBACKUP_H
+#define ONLINEBACKUP_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
+
+namespace Frontier {
+
+/**
+ * @brief Where and how OnlineBackup writes a snapshot
+ */
+struct BackupOptions {
+    QString directory;          // Snapshots go here as <base>-yyyyMMdd-hhmmss.db
+    int keep = 5;               // Older snapshots of the same base are deleted; 0 keeps all
+    bool compress = false;      // Writes .db.fmz (see OnlineBackup::decompress)
+    int pagesPerStep = 256;     // Copied per backup step before the lock is released
+    int pauseMs = 5;            // Between steps, so writers get in
+};
+
+/**
+ * @brief Result of one backup run
+ */
+struct BackupResult {
+    bool ok = false;
+    bool cancelled = false;
+    QString path;               // The snapshot written
+    QString error;
+    qint64 bytes = 0;
+    QStringList removed;        // Rotated out
+};
+
+/**
+ * @brief Snapshots a live database without blocking its users
+ *
+ * The copy runs on the global thread pool through SQLite's online backup
+ * API on connections of its own: pagesPerStep pages at a time, releasing
+ * the source's read lock between steps, so the tracker keeps reading and
+ * writing. A write from another connection restarts the copy, so the
+ * result is always one consistent state of the file. Builds without the
+ * SQLite headers (FRONTIER_HAVE_SQLITE3 unset) fall back to VACUUM INTO
+ * on the same thread, which holds the read lock for the whole copy.
+ *
+ * The snapshot is written to a .part file and renamed when complete, so a
+ * cancelled or failed run never leaves a partial snapshot behind.
+ * Compressed snapshots are framed qCompress() chunks; decompress() turns
+ * one back into a database file. Year archives (Database::archiveYear)
+ * never change once written and are not part of the snapshot; neither is
+ * a shared reference catalog (Database::setCatalogPath), which start()
+ * copies only when given its own path.
+ */
+class OnlineBackup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OnlineBackup(QObject *parent = nullptr);
+    ~OnlineBackup();
+
+    // False when a backup is already running or the source is missing
+    bool start(const QString &databasePath, const BackupOptions &options);
+    void cancel();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    // Snapshots of this database in options.directory, newest first
+    static QStringList snapshots(const QString &databasePath, const QString &directory);
+    static bool decompress(const QString &snapshotPath, const QString &databasePath,
+                           QString *error = nullptr);
+
+signals:
+    // Pages copied of the file's current page count
+    void progress(int done, int total);
+    void finished(const Frontier::BackupResult &result);
+
+private slots:
+    void onFinished();
+
+private:
+    static BackupResult run(QString source, BackupOptions options, OnlineBackup *self,
+                            std::shared_ptr<std::atomic_bool> cancelled);
+    static bool copy(const QString &source, const QString &dest, const BackupOptions &options,
+                     OnlineBackup *self, const std::atomic_bool &cancelled, QString *error);
+    static bool compressFile(const QString &source, const QString &dest, QString *error);
+
+    QFutureWatcher<BackupResult> m_watcher;
+    std::shared_ptr<std::atomic_bool> m_cancelled;
+
+    static constexpr qint64 ChunkBytes = 4 * 1024 * 1024;
+};
+
+} // namespace Frontier
+
+Q_DECLARE_METATYPE(Frontier::BackupResult)
+
+#endif // ONLINEBACKUP_H
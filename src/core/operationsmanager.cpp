@@ -4,6 +4,10 @@
  */
 
 #include "operationsmanager.h"
+#include "profiler.h"
+
+#include <QDebug>
+#include <algorithm>
 
 namespace Frontier {
 
@@ -14,6 +18,7 @@ OperationsManager::OperationsManager(Database *database, QObject *parent)
     , m_loaderCycleTimeMinutes(1.5)
     , m_truckCycleTimeMinutes(6.0)
     , m_fuelPricePerLiter(0.32)
+    , m_capture(new MovementCapture(database, this))
 {
     // Load preferences
     QSettings settings("FrontierMining", "Tracker");
@@ -29,10 +34,27 @@ OperationsManager::OperationsManager(Database *database, QObject *parent)
 
     // Fuel price
     m_fuelPricePerLiter = settings.value("Operations/fuelPricePerLiter", 0.32).toDouble();
+
+    // Covers VehicleImporter and the Vehicle Specs tab, which write through the database
+    connect(m_database, &Database::vehiclesChanged, this, &OperationsManager::invalidateVehicleCache);
+
+    connect(m_capture, &MovementCapture::captured, this, &OperationsManager::applyCapturedEvents);
+    connect(m_capture, &MovementCapture::written, this, &OperationsManager::saveLiveUsage);
+
+    Profiler::instance().setMemoryReporter("Vehicle specs", [this]() {
+        qint64 bytes = estimateBytes(m_vehicles) + estimateBytes(m_vehicleIndexById);
+        for (const Vehicle &vehicle : m_vehicles) {
+            bytes += estimateBytes(vehicle.id) + estimateBytes(vehicle.name) + estimateBytes(vehicle.notes);
+        }
+        return bytes;
+    });
 }
 
 OperationsManager::~OperationsManager()
 {
+    // While this is still whole to take the last tallies
+    setLiveCaptureEnabled(false);
+    Profiler::instance().removeMemoryReporter("Vehicle specs");
 }
 
 // === Unit System ===
@@ -110,19 +132,66 @@ void OperationsManager::setFuelPricePerLiter(double price)
 
 // === Vehicle Specs ===
 
+void OperationsManager::ensureVehiclesLoaded() const
+{
+    if (m_vehiclesLoaded) {
+        return;
+    }
+
+    m_vehicles = m_database->getAllVehicles(false);
+    m_vehicleIndexById.clear();
+    m_vehicleIndexById.reserve(m_vehicles.size());
+    for (int i = 0; i < m_vehicles.size(); ++i) {
+        m_vehicleIndexById.insert(m_vehicles[i].id, i);
+    }
+    m_vehiclesLoaded = true;
+}
+
+void OperationsManager::invalidateVehicleCache()
+{
+    m_vehiclesLoaded = false;
+    m_vehicles.clear();
+    m_vehicleIndexById.clear();
+}
+
 QVector<Vehicle> OperationsManager::getActiveVehicles() const
 {
-    return m_database->getAllVehicles(true);
+    ensureVehiclesLoaded();
+
+    QVector<Vehicle> active;
+    active.reserve(m_vehicles.size());
+    for (const auto &vehicle : m_vehicles) {
+        if (vehicle.active) {
+            active.append(vehicle);
+        }
+    }
+    return active;
 }
 
 QVector<Vehicle> OperationsManager::getAllVehicles() const
 {
-    return m_database->getAllVehicles(false);
+    ensureVehiclesLoaded();
+    return m_vehicles;
 }
 
 std::optional<Vehicle> OperationsManager::getVehicle(const QString &id) const
 {
-    return m_database->getVehicle(id);
+    const Vehicle *vehicle = findVehicle(id);
+    if (!vehicle) {
+        return std::nullopt;
+    }
+    return *vehicle;
+}
+
+const Vehicle *OperationsManager::findVehicle(const QString &id) const
+{
+    ensureVehiclesLoaded();
+
+    auto it = m_vehicleIndexById.constFind(id);
+    if (it == m_vehicleIndexById.constEnd()) {
+        return nullptr;
+    }
+    return &m_vehicles[it.value()];
 }
 
 QString OperationsManager::determineRoleFromCategory(const QString &category) const
@@ -173,6 +242,12 @@ int OperationsManager::startSession(const QString &mapName, const QString &notes
 
 void OperationsManager::endSession(int sessionId)
 {
+    // Take in the events still queued, then recalculate from the saved counts
+    if (m_capture->isRunning()) {
+        m_capture->flush();
+    }
+    resetLiveUsage();
+
     // First, auto-calculate hours for all equipment in the session
     autoCalculateSessionHours(sessionId);
 
@@ -205,6 +280,16 @@ QVector<MovementSession> OperationsManager::getAllSessions() const
     return m_database->getAllMovementSessions();
 }
 
+QVector<MovementSessionSummary> OperationsManager::querySessions(const MovementSessionQuery &filter) const
+{
+    return m_database->queryMovementSessions(filter);
+}
+
+std::optional<MovementSessionSummary> OperationsManager::getSessionSummary(int sessionId) const
+{
+    return m_database->getMovementSessionSummary(sessionId);
+}
+
 bool OperationsManager::updateSession(const MovementSession &session)
 {
     bool success = m_database->updateMovementSession(session);
@@ -216,6 +301,13 @@ bool OperationsManager::updateSession(const MovementSession &session)
 
 bool OperationsManager::deleteSession(int sessionId)
 {
+    if (m_capture->isRunning()) {
+        m_capture->flush();
+    }
+    if (sessionId == m_liveSessionId) {
+        m_liveDirty.clear();
+        resetLiveUsage();
+    }
     return m_database->deleteMovementSession(sessionId);
 }
 
@@ -223,6 +315,9 @@ bool OperationsManager::deleteSession(int sessionId)
 
 void OperationsManager::addOrUpdateEquipmentUsage(const MovementEquipmentUsage &usage)
 {
+    // Live tallies go first, so this edit is the one that stays
+    resetLiveUsage();
+
     // Calculate hours from activity and estimated fuel before saving
     MovementEquipmentUsage updated = usage;
 
@@ -247,6 +342,25 @@ QVector<MovementEquipmentUsage> OperationsManager::getEquipmentUsageForSession(i
 {
     QVector<MovementEquipmentUsage> usages = m_database->getEquipmentUsageForSession(sessionId);
 
+    // Live counts replace the saved ones; machines first seen live follow
+    if (sessionId == m_liveSessionId && !m_liveUsage.isEmpty()) {
+        QSet<QString> listed;
+        for (auto &usage : usages) {
+            auto live = m_liveUsage.constFind(usage.equipmentId);
+            if (live != m_liveUsage.constEnd() && live->role == usage.role) {
+                const std::optional<int> id = usage.id;
+                usage = live.value();
+                usage.id = id;
+                listed.insert(usage.equipmentId);
+            }
+        }
+        for (const auto &live : m_liveUsage) {
+            if (!listed.contains(live.equipmentId)) {
+                usages.append(live);
+            }
+        }
+    }
+
     // Calculate derived values
     for (auto &usage : usages) {
         usage.volumeM3 = calculateVolume(usage);
@@ -257,6 +371,7 @@ QVector<MovementEquipmentUsage> OperationsManager::getEquipmentUsageForSession(i
 
 bool OperationsManager::deleteEquipmentUsage(int usageId)
 {
+    resetLiveUsage();
     return m_database->deleteEquipmentUsage(usageId);
 }
 
@@ -269,6 +384,27 @@ void OperationsManager::addFuelLogEntry(const FuelLogEntry &entry)
 
     if (m_database->addFuelLogEntry(updated)) {
         emit fuelLogUpdated(updated);
+        emit fuelLogChanged(updated.dateTime, updated.dateTime);
+    }
+}
+
+void OperationsManager::addFuelLogEntries(const QVector<FuelLogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    QVector<FuelLogEntry> updated = entries;
+    QDateTime from = updated.first().dateTime;
+    QDateTime to = from;
+    for (auto &entry : updated) {
+        entry.totalCost = entry.liters * entry.unitPrice;
+        from = qMin(from, entry.dateTime);
+        to = qMax(to, entry.dateTime);
+    }
+
+    if (m_database->addFuelLogEntries(updated) > 0) {
+        emit fuelLogChanged(from, to);
     }
 }
 
@@ -289,6 +425,40 @@ double OperationsManager::getTotalFuelCostInRange(const QDateTime &from, const Q
     return m_database->getTotalFuelCostInRange(from, to);
 }
 
+QVector<FuelDailyTotal> OperationsManager::getFuelDailyTotals(const QDate &from, const QDate &to,
+                                                              const QString &equipmentId) const
+{
+    return m_database->getFuelDailyTotals(from, to, equipmentId);
+}
+
+QVector<FuelDailyTotal> OperationsManager::getFuelTotalsByEquipment(const QDate &from, const QDate &to) const
+{
+    return m_database->getFuelTotalsByEquipment(from, to);
+}
+
+EquipmentEfficiency OperationsManager::getFuelEfficiency(const QString &equipmentId) const
+{
+    const Vehicle *spec = findVehicle(equipmentId);
+    return m_database->fuelEfficiency().efficiency(equipmentId, spec ? spec->fuelUseLPerHour : 0);
+}
+
+QVector<EquipmentEfficiency> OperationsManager::getFleetFuelEfficiency() const
+{
+    QVector<EquipmentEfficiency> fleet;
+    for (const QString &id : m_database->fuelEfficiency().equipmentIds()) {
+        fleet.append(getFuelEfficiency(id));
+    }
+    std::sort(fleet.begin(), fleet.end(), [](const EquipmentEfficiency &a, const EquipmentEfficiency &b) {
+        const bool aFlagged = a.anomalies.toInt() != 0;
+        const bool bFlagged = b.anomalies.toInt() != 0;
+        if (aFlagged != bFlagged) {
+            return aFlagged;
+        }
+        return qAbs(a.deviationPercent()) > qAbs(b.deviationPercent());
+    });
+    return fleet;
+}
+
 void OperationsManager::generateFuelLogFromSession(int sessionId)
 {
     auto usages = getEquipmentUsageForSession(sessionId);
@@ -296,6 +466,7 @@ void OperationsManager::generateFuelLogFromSession(int sessionId)
 
     if (!session.has_value()) return;
 
+    QVector<FuelLogEntry> entries;
     for (const auto &usage : usages) {
         if (usage.estimatedFuelL > 0) {
             FuelLogEntry entry;
@@ -308,17 +479,19 @@ void OperationsManager::generateFuelLogFromSession(int sessionId)
             entry.source = QString("Session #%1").arg(sessionId);
             entry.notes = QString("Auto-generated from movement session");
 
-            addFuelLogEntry(entry);
+            entries.append(entry);
         }
     }
+
+    addFuelLogEntries(entries);
 }
 
 // === Calculations ===
 
 double OperationsManager::calculateVolume(const MovementEquipmentUsage &usage) const
 {
-    auto spec = getVehicle(usage.equipmentId);
-    if (!spec.has_value()) return 0;
+    const Vehicle *spec = findVehicle(usage.equipmentId);
+    if (!spec) return 0;
 
     // For loaders/excavators: buckets × bucket capacity
     if (usage.buckets > 0 && spec->bucketCapacityM3 > 0) {
@@ -340,8 +513,8 @@ double OperationsManager::calculateVolume(const MovementEquipmentUsage &usage) c
 
 double OperationsManager::calculateEstimatedFuel(const MovementEquipmentUsage &usage) const
 {
-    auto spec = getVehicle(usage.equipmentId);
-    if (!spec.has_value()) return 0;
+    const Vehicle *spec = findVehicle(usage.equipmentId);
+    if (!spec) return 0;
 
     return usage.hoursUsed * spec->fuelUseLPerHour;
 }
@@ -365,6 +538,10 @@ double OperationsManager::calculateHoursFromActivity(const QString &role, int co
 
 void OperationsManager::autoCalculateSessionHours(int sessionId)
 {
+    if (sessionId == m_liveSessionId) {
+        resetLiveUsage();
+    }
+
     auto usages = m_database->getEquipmentUsageForSession(sessionId);
 
     for (auto &usage : usages) {
@@ -381,12 +558,134 @@ void OperationsManager::autoCalculateSessionHours(int sessionId)
 
         // Recalculate fuel
         usage.estimatedFuelL = calculateEstimatedFuel(usage);
+    }
 
-        // Update in database
-        m_database->addOrUpdateEquipmentUsage(usage);
+    // Write the whole session back in one transaction
+    if (!usages.isEmpty() && m_database->saveEquipmentUsages(sessionId, usages) < 0) {
+        qWarning() << "Failed to save equipment hours for session" << sessionId;
+        return;
     }
 
     emit equipmentUsageUpdated(sessionId);
 }
 
+// === Live Capture ===
+
+void OperationsManager::setLiveCaptureEnabled(bool enabled)
+{
+    if (enabled == m_capture->isRunning()) {
+        return;
+    }
+    if (enabled) {
+        m_capture->start();
+        return;
+    }
+
+    // Writes what is queued, which saves the tallies through written()
+    m_capture->stop();
+    saveLiveUsage();
+}
+
+bool OperationsManager::isLiveCaptureEnabled() const
+{
+    return m_capture->isRunning();
+}
+
+bool OperationsManager::recordMovementEvent(const QString &equipmentId)
+{
+    if (!m_activeSessionId.has_value() || equipmentId.isEmpty()) {
+        return false;
+    }
+
+    QString role;
+    auto live = m_liveUsage.constFind(equipmentId);
+    if (m_liveSessionId == m_activeSessionId.value() && live != m_liveUsage.constEnd()) {
+        role = live->role;
+    } else if (const Vehicle *spec = findVehicle(equipmentId)) {
+        role = determineRoleFromCategory(spec->categoryMain);
+    } else {
+        return false;
+    }
+
+    const MovementEventKind kind = role == "HaulTruck" ? MovementEventKind::Dump : MovementEventKind::Bucket;
+    return m_capture->record(m_activeSessionId.value(), equipmentId, kind);
+}
+
+void OperationsManager::applyCapturedEvents(const QVector<MovementEvent> &events)
+{
+    for (const MovementEvent &event : events) {
+        if (event.sessionId != m_liveSessionId) {
+            if (m_liveSessionId != 0) {
+                emit movementEventsCaptured(m_liveSessionId);
+            }
+            saveLiveUsage();
+            m_liveUsage.clear();
+            m_liveSessionId = event.sessionId;
+            // The first row per machine is the one tallied
+            for (const auto &usage : m_database->getEquipmentUsageForSession(event.sessionId)) {
+                if (!m_liveUsage.contains(usage.equipmentId)) {
+                    m_liveUsage.insert(usage.equipmentId, usage);
+                }
+            }
+        }
+
+        auto it = m_liveUsage.find(event.equipmentId);
+        if (it == m_liveUsage.end()) {
+            MovementEquipmentUsage usage;
+            usage.sessionId = event.sessionId;
+            usage.equipmentId = event.equipmentId;
+            const Vehicle *spec = findVehicle(event.equipmentId);
+            usage.role = spec ? determineRoleFromCategory(spec->categoryMain)
+                              : event.kind == MovementEventKind::Dump ? QStringLiteral("HaulTruck") : QStringLiteral("Loader");
+            it = m_liveUsage.insert(event.equipmentId, usage);
+        }
+
+        // Same derivation as addOrUpdateEquipmentUsage(), one event at a time
+        MovementEquipmentUsage &usage = it.value();
+        if (event.kind == MovementEventKind::Dump) {
+            usage.dumps++;
+        } else {
+            usage.buckets++;
+        }
+        usage.hoursUsed = calculateHoursFromActivity(usage.role,
+                                                     usage.role == "HaulTruck" ? usage.dumps : usage.buckets);
+        usage.estimatedFuelL = calculateEstimatedFuel(usage);
+        usage.volumeM3 = calculateVolume(usage);
+        m_liveDirty.insert(event.equipmentId);
+    }
+
+    if (m_liveSessionId != 0) {
+        emit movementEventsCaptured(m_liveSessionId);
+    }
+}
+
+void OperationsManager::saveLiveUsage()
+{
+    if (m_liveDirty.isEmpty()) {
+        return;
+    }
+
+    QVector<MovementEquipmentUsage> usages;
+    for (const QString &equipmentId : m_liveDirty) {
+        usages.append(m_liveUsage.value(equipmentId));
+    }
+
+    // Kept dirty on failure, for the next batch to retry
+    if (m_database->saveEquipmentUsages(m_liveSessionId, usages) < 0) {
+        qWarning() << "Failed to save live equipment usage for session" << m_liveSessionId;
+        return;
+    }
+
+    m_liveDirty.clear();
+    emit equipmentUsageUpdated(m_liveSessionId);
+}
+
+void OperationsManager::resetLiveUsage()
+{
+    saveLiveUsage();
+    m_liveUsage.clear();
+    m_liveDirty.clear();
+    m_liveSessionId = 0;
+}
+
 } // namespace Frontier
@@ -9,8 +9,12 @@
 #include <QObject>
 #include <QDateTime>
 #include <QSettings>
+#include <QHash>
+#include <QSet>
 #include "types.h"
 #include "database.h"
+#include "fuelefficiency.h"
+#include "movementcapture.h"
 
 namespace Frontier {
 
@@ -37,9 +41,14 @@ public:
     void setFuelPricePerLiter(double price);
 
     // Vehicle Specs
+    // Served from a cache indexed by id, loaded on first use and dropped
+    // whenever the database reports a vehicle write
     QVector<Vehicle> getActiveVehicles() const;
     QVector<Vehicle> getAllVehicles() const;
     std::optional<Vehicle> getVehicle(const QString &id) const;
+    // Pointer into the cache, valid until the next vehicle write; nullptr if unknown
+    const Vehicle *findVehicle(const QString &id) const;
+    void invalidateVehicleCache();
 
     // Determine equipment role from category
     QString determineRoleFromCategory(const QString &category) const;
@@ -50,20 +59,34 @@ public:
     std::optional<MovementSession> getSession(int sessionId) const;
     std::optional<int> activeSessionId() const;
     QVector<MovementSession> getAllSessions() const;
+    QVector<MovementSessionSummary> querySessions(const MovementSessionQuery &filter) const;
+    std::optional<MovementSessionSummary> getSessionSummary(int sessionId) const;
     bool updateSession(const MovementSession &session);
     bool deleteSession(int sessionId);
 
     // Equipment Usage
     void addOrUpdateEquipmentUsage(const MovementEquipmentUsage &usage);
+    // Includes live capture tallies not yet saved
     QVector<MovementEquipmentUsage> getEquipmentUsageForSession(int sessionId) const;
     bool deleteEquipmentUsage(int usageId);
 
     // Fuel Log
     void addFuelLogEntry(const FuelLogEntry &entry);
+    // Writes all entries in one transaction and emits a single fuelLogChanged()
+    void addFuelLogEntries(const QVector<FuelLogEntry> &entries);
     QVector<FuelLogEntry> getFuelLog(const QDateTime &from, const QDateTime &to,
                                      const QString &equipmentId = QString()) const;
     double getTotalFuelInRange(const QDateTime &from, const QDateTime &to) const;
     double getTotalFuelCostInRange(const QDateTime &from, const QDateTime &to) const;
+    QVector<FuelDailyTotal> getFuelDailyTotals(const QDate &from, const QDate &to,
+                                               const QString &equipmentId = QString()) const;
+    // Liters, cost and active days per equipment, for burn rates
+    QVector<FuelDailyTotal> getFuelTotalsByEquipment(const QDate &from, const QDate &to) const;
+    // Logged L/hr against the vehicle's rated fuel use over the last 7 and
+    // 30 days, kept current as entries are added (see fuelefficiency.h)
+    EquipmentEfficiency getFuelEfficiency(const QString &equipmentId) const;
+    // Every machine with hours logged, flagged ones first
+    QVector<EquipmentEfficiency> getFleetFuelEfficiency() const;
 
     // Generate fuel log entries from session equipment usage
     void generateFuelLogFromSession(int sessionId);
@@ -76,19 +99,40 @@ public:
     // Auto-calculate hours for all equipment in a session
     void autoCalculateSessionHours(int sessionId);
 
+    // Live Capture
+    // Bucket and dump events for the active session, tallied into its
+    // equipment usage as they are drained and saved with each event batch
+    // (see movementcapture.h)
+    void setLiveCaptureEnabled(bool enabled);
+    bool isLiveCaptureEnabled() const;
+    // A bucket for loaders, a dump for haul trucks. Never waits on the
+    // database; false without an active session or with capture off.
+    bool recordMovementEvent(const QString &equipmentId);
+    const MovementCapture *movementCapture() const { return m_capture; }
+
     // Database access (for tabs that need direct DB access)
     Database* database() const { return m_database; }
 
 signals:
     void unitSystemChanged(UnitSystem system);
     void fuelLogUpdated(const FuelLogEntry &entry);
+    // Coalesced change notice covering every entry written, single or batch
+    void fuelLogChanged(const QDateTime &from, const QDateTime &to);
     void movementSessionStarted(int sessionId);
     void movementSessionEnded(int sessionId);
     void movementSessionUpdated(int sessionId);
     void equipmentUsageUpdated(int sessionId);
+    // Live tallies changed; getEquipmentUsageForSession() returns them
+    void movementEventsCaptured(int sessionId);
     void cycleTimesChanged();
 
 private:
+    void ensureVehiclesLoaded() const;
+    void applyCapturedEvents(const QVector<MovementEvent> &events);
+    void saveLiveUsage();
+    // Saves, then reloads from the database on the next event
+    void resetLiveUsage();
+
     Database *m_database;
     UnitSystem m_unitSystem;
     std::optional<int> m_activeSessionId;
@@ -99,6 +143,18 @@ private:
 
     // Fuel price (per liter)
     double m_fuelPricePerLiter;
+
+    // Vehicle spec cache, in getAllVehicles() order
+    mutable QVector<Vehicle> m_vehicles;
+    mutable QHash<QString, int> m_vehicleIndexById;
+    mutable bool m_vehiclesLoaded = false;
+
+    // Live capture: usage of m_liveSessionId by equipment, and the
+    // equipment changed since the last save
+    MovementCapture *m_capture;
+    int m_liveSessionId = 0;
+    QHash<QString, MovementEquipmentUsage> m_liveUsage;
+    QSet<QString> m_liveDirty;
 };
 
 } // namespace Frontier
@@ -0,0 +1,321 @@
+/**
+ * @file overlayserver.cpp
+ * @brief Overlay endpoint implementation
+ */
+
+#include "overlayserver.h"
+#include "database.h"
+#include "operationsmanager.h"
+#include "profiler.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+namespace Frontier {
+
+namespace {
+
+QByteArray compact(const QJsonObject &object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+QByteArray compact(const QJsonArray &array)
+{
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+OverlayServer::OverlayServer(Database *database, OperationsManager *operations, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+    , m_operations(operations)
+    , m_server(new QLocalServer(this))
+{
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &OverlayServer::onNewConnection);
+
+    connect(&m_database->changeBus(), &DataChangeBus::tablesChanged,
+            this, &OverlayServer::onTablesChanged);
+    if (m_operations) {
+        connect(m_operations, &OperationsManager::movementSessionStarted,
+                this, &OverlayServer::onSessionChanged);
+        connect(m_operations, &OperationsManager::movementSessionEnded,
+                this, &OverlayServer::onSessionChanged);
+        connect(m_operations, &OperationsManager::movementSessionUpdated,
+                this, &OverlayServer::onSessionChanged);
+    }
+}
+
+OverlayServer::~OverlayServer()
+{
+    close();
+}
+
+// =============================================================================
+// Server
+// =============================================================================
+
+bool OverlayServer::listen(const QString &name)
+{
+    close();
+
+    // A socket file left by a crashed instance would make listen() fail
+    QLocalServer::removeServer(name);
+    if (!m_server->listen(name)) {
+        m_lastError = m_server->errorString();
+        qWarning() << "Overlay server could not listen on" << name << ":" << m_lastError;
+        return false;
+    }
+
+    m_lastError.clear();
+    rebuild(AllSections);
+    return true;
+}
+
+void OverlayServer::close()
+{
+    const QList<QLocalSocket *> clients = m_clients.keys();
+    m_clients.clear();
+    for (QLocalSocket *socket : clients) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+}
+
+bool OverlayServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QString OverlayServer::serverName() const
+{
+    return m_server->fullServerName();
+}
+
+void OverlayServer::setLowStockThreshold(int quantity)
+{
+    if (quantity == m_lowStockThreshold) {
+        return;
+    }
+    m_lowStockThreshold = quantity;
+    if (isListening()) {
+        rebuild(Shortfalls);
+        push(Shortfalls);
+    }
+}
+
+void OverlayServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, false);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_clients.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+// =============================================================================
+// Snapshot
+// =============================================================================
+
+void OverlayServer::onTablesChanged(DataTables tables)
+{
+    if (!isListening()) {
+        return;
+    }
+
+    int sections = 0;
+    if (tables & DataTable::Transactions) {
+        sections |= Balances;
+    }
+    if (tables & (DataTable::Inventory | DataTable::Items)) {
+        sections |= Shortfalls;
+    }
+    if (tables & DataTable::Movement) {
+        sections |= Session;
+    }
+    if (sections) {
+        rebuild(sections);
+        push(sections);
+    }
+}
+
+void OverlayServer::onSessionChanged()
+{
+    // The active session id lives in the manager, not the table, so
+    // starting or ending one may not reach the bus in the same flush
+    if (isListening()) {
+        rebuild(Session);
+        push(Session);
+    }
+}
+
+void OverlayServer::rebuild(int sections)
+{
+    ProfileScope scope("OverlayServer::rebuild");
+
+    if (sections & Balances) {
+        const AccountBalance balance = m_database->calculateBalances();
+        QJsonObject object;
+        object.insert("company", balance.companyBalance);
+        object.insert("personal", balance.personalBalance);
+        object.insert("total", balance.total());
+        m_balances = compact(object);
+    }
+
+    if (sections & Shortfalls) {
+        // Queued quantity edits must be in the table before it is read
+        m_database->flushPendingWrites();
+        QJsonArray items;
+        for (const InventoryItem &item : m_database->getAllInventory()) {
+            if (item.quantity > m_lowStockThreshold) {
+                continue;
+            }
+            QJsonObject object;
+            object.insert("item", item.itemName);
+            object.insert("code", item.itemCode);
+            object.insert("location", item.locationName);
+            object.insert("quantity", item.quantity);
+            items.append(object);
+        }
+        m_shortfalls = compact(items);
+    }
+
+    if (sections & Session) {
+        QJsonObject object;
+        const std::optional<int> activeId = m_operations ? m_operations->activeSessionId() : std::nullopt;
+        const std::optional<MovementSession> session =
+            activeId ? m_operations->getSession(*activeId) : std::nullopt;
+        object.insert("active", session.has_value());
+        if (session) {
+            object.insert("id", *activeId);
+            object.insert("map", session->mapName);
+            object.insert("start", session->startTime.toString(Qt::ISODate));
+            object.insert("notes", session->notes);
+        }
+        m_session = compact(object);
+    }
+
+    ++m_version;
+}
+
+QByteArray OverlayServer::sectionsObject(int sections) const
+{
+    QByteArray out("{");
+    auto add = [&out](const char *key, const QByteArray &value) {
+        if (out.size() > 1) {
+            out += ',';
+        }
+        out += '"';
+        out += key;
+        out += "\":";
+        out += value;
+    };
+    if (sections & Balances) {
+        add("balances", m_balances);
+    }
+    if (sections & Shortfalls) {
+        add("shortfalls", m_shortfalls);
+    }
+    if (sections & Session) {
+        add("session", m_session);
+    }
+    out += '}';
+    return out;
+}
+
+QByteArray OverlayServer::envelope(const char *type, const QByteArray &data) const
+{
+    QByteArray out;
+    out.reserve(data.size() + 48);
+    out += "{\"type\":\"";
+    out += type;
+    out += "\",\"version\":";
+    out += QByteArray::number(m_version);
+    out += ",\"data\":";
+    out += data;
+    out += "}\n";
+    return out;
+}
+
+void OverlayServer::push(int sections)
+{
+    QByteArray message;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (!it.value()) {
+            continue;
+        }
+        if (message.isEmpty()) {
+            message = envelope("changed", sectionsObject(sections));
+        }
+        it.key()->write(message);
+    }
+}
+
+// =============================================================================
+// Requests
+// =============================================================================
+
+void OverlayServer::readRequests(QLocalSocket *socket)
+{
+    while (socket->canReadLine()) {
+        const QByteArray request = socket->readLine().trimmed();
+        if (!request.isEmpty()) {
+            socket->write(reply(request, socket));
+        }
+    }
+
+    if (socket->bytesAvailable() > MaxRequestBytes) {
+        qWarning() << "Overlay server dropped a client sending an over-long request";
+        socket->abort();
+    }
+}
+
+QByteArray OverlayServer::reply(const QByteArray &request, QLocalSocket *socket)
+{
+    if (request == "balances") {
+        return envelope("balances", m_balances);
+    }
+    if (request == "shortfalls") {
+        return envelope("shortfalls", m_shortfalls);
+    }
+    if (request == "session") {
+        return envelope("session", m_session);
+    }
+    if (request == "snapshot") {
+        return envelope("snapshot", sectionsObject(AllSections));
+    }
+    if (request == "subscribe" || request == "unsubscribe") {
+        m_clients[socket] = request == "subscribe";
+        return QByteArrayLiteral("{\"type\":\"ok\"}\n");
+    }
+    if (request.startsWith("event ")) {
+        // Lets an overlay with the game's focus act as the capture hotkey
+        if (!m_operations) {
+            return QByteArrayLiteral("{\"type\":\"error\",\"message\":\"no live capture\"}\n");
+        }
+        const QString equipmentId = QString::fromUtf8(request.mid(6).trimmed());
+        if (m_operations->recordMovementEvent(equipmentId)) {
+            return QByteArrayLiteral("{\"type\":\"ok\"}\n");
+        }
+        return QByteArrayLiteral("{\"type\":\"error\",\"message\":\"not capturing\"}\n");
+    }
+    if (request == "ping") {
+        return QByteArrayLiteral("{\"type\":\"pong\"}\n");
+    }
+    return QByteArrayLiteral("{\"type\":\"error\",\"message\":\"unknown request\"}\n");
+}
+
+} // namespace Frontier
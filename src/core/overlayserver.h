@@ -0,0 +1,119 @@
+/**
+ * @file overlayserver.h
+ * @brief Local socket endpoint serving cached state to in-game overlays
+ */
+
+#ifndef OVERLAYSERVER_H
+#define OVERLAYSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include "datachangebus.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace Frontier {
+
+class Database;
+class OperationsManager;
+
+/**
+ * @brief Answers overlay queries from a snapshot kept current by the change bus
+ *
+ * Listens on a QLocalServer (a named pipe on Windows, a Unix socket
+ * elsewhere). A client writes one request per line and gets one line of
+ * compact JSON back:
+ *
+ *   balances      {"type":"balances","version":N,"data":{"company":..,"personal":..,"total":..}}
+ *   shortfalls    {"type":"shortfalls","version":N,"data":[{"item":..,"code":..,"location":..,"quantity":..}]}
+ *   session       {"type":"session","version":N,"data":{"active":false} or the active session}
+ *   snapshot      all three under "data"
+ *   subscribe     {"type":"ok"}; the client is then pushed
+ *                 {"type":"changed","version":N,"data":{<changed sections>}}
+ *                 after every change-bus flush that touches them
+ *   unsubscribe   {"type":"ok"}
+ *   event <id>    {"type":"ok"} once a bucket or dump for that machine is
+ *                 queued on the live capture (see movementcapture.h), or
+ *                 {"type":"error","message":..} when capture is off
+ *   ping          {"type":"pong"}
+ *
+ * Requests never reach SQLite. Each section is read and serialized once
+ * when the tables behind it change (Transactions for balances, Inventory
+ * and Items for shortfalls, Movement for the session), and a request is
+ * answered by concatenating the stored bytes; a captured event is written
+ * later, in a batch. While the server is not listening nothing is rebuilt.
+ *
+ * Belongs to the Database's thread, like the change bus it listens to.
+ */
+class OverlayServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OverlayServer(Database *database, OperationsManager *operations,
+                           QObject *parent = nullptr);
+    ~OverlayServer();
+
+    static constexpr const char *DefaultName = "frontier-overlay";
+
+    // Replaces a stale socket left by a crashed instance; false (see
+    // lastError()) when the name is taken or cannot be created
+    bool listen(const QString &name = QString::fromLatin1(DefaultName));
+    void close();
+    bool isListening() const;
+    QString serverName() const;
+    QString lastError() const { return m_lastError; }
+
+    int clientCount() const { return m_clients.size(); }
+
+    // Items at or below this quantity are reported as shortfalls
+    void setLowStockThreshold(int quantity);
+    int lowStockThreshold() const { return m_lowStockThreshold; }
+
+private slots:
+    void onNewConnection();
+    void onTablesChanged(Frontier::DataTables tables);
+    void onSessionChanged();
+
+private:
+    enum Section {
+        Balances   = 1 << 0,
+        Shortfalls = 1 << 1,
+        Session    = 1 << 2,
+        AllSections = Balances | Shortfalls | Session
+    };
+
+    void rebuild(int sections);
+    void readRequests(QLocalSocket *socket);
+    QByteArray reply(const QByteArray &request, QLocalSocket *socket);
+    QByteArray sectionsObject(int sections) const;
+    QByteArray envelope(const char *type, const QByteArray &data) const;
+    void push(int sections);
+
+    Database *m_database;
+    OperationsManager *m_operations;
+    QLocalServer *m_server;
+    QString m_lastError;
+
+    // Client -> subscribed to pushes
+    QHash<QLocalSocket *, bool> m_clients;
+
+    // Serialized sections, current as of m_version
+    QByteArray m_balances;
+    QByteArray m_shortfalls;
+    QByteArray m_session;
+    quint64 m_version = 0;
+
+    int m_lowStockThreshold = 10;
+
+    // A client that sends this much without a newline is dropped
+    static constexpr qint64 MaxRequestBytes = 1024;
+};
+
+} // namespace Frontier
+
+#endif // OVERLAYSERVER_H
@@ -0,0 +1,44 @@
+/**
+ * @file planmodel.cpp
+ * @brief Plan line totals
+ */
+
+#include "planmodel.h"
+
+namespace Frontier {
+
+PlanTotals planLineTotals(const EquipmentPlanItem &line)
+{
+    PlanTotals totals;
+    totals.lineCount = 1;
+    totals.unitCount = line.quantity;
+    totals.cost = line.unitPrice * line.quantity;
+    return totals;
+}
+
+PlanTotals planLineTotals(const FacilityPlanItem &line)
+{
+    PlanTotals totals;
+    totals.lineCount = 1;
+    totals.unitCount = line.quantity;
+    totals.cost = line.unitPrice * line.quantity;
+    totals.powerKw = line.unitPowerKw * line.quantity;
+    totals.generatedKw = line.unitGeneratedKw * line.quantity;
+    return totals;
+}
+
+void setPlanLineQuantity(EquipmentPlanItem &line, int quantity)
+{
+    line.quantity = quantity;
+    line.totalCost = line.unitPrice * quantity;
+}
+
+void setPlanLineQuantity(FacilityPlanItem &line, int quantity)
+{
+    line.quantity = quantity;
+    line.totalCost = line.unitPrice * quantity;
+    line.totalPowerKw = line.unitPowerKw * quantity;
+    line.totalGeneratedKw = line.unitGeneratedKw * quantity;
+}
+
+} // namespace Frontier
@@ -0,0 +1,87 @@
+/**
+ * @file planmodel.h
+ * @brief In-memory capital plan with incrementally maintained totals
+ */
+
+#ifndef PLANMODEL_H
+#define PLANMODEL_H
+
+#include <QVector>
+
+#include "types.h"
+
+namespace Frontier {
+
+// One line's share of the totals, from its unit values and quantity
+PlanTotals planLineTotals(const EquipmentPlanItem &line);
+PlanTotals planLineTotals(const FacilityPlanItem &line);
+
+// Sets the quantity and recomputes the line totals from the unit values
+void setPlanLineQuantity(EquipmentPlanItem &line, int quantity);
+void setPlanLineQuantity(FacilityPlanItem &line, int quantity);
+
+/**
+ * @brief Plan lines in display order plus their running totals
+ *
+ * Editing a line subtracts its old contribution and adds the new one, so
+ * a quantity change costs the same however long the plan is. reset()
+ * sums from scratch, which also clears any floating-point drift. The
+ * model holds no database handle; callers persist the changed line.
+ */
+template <typename Line>
+class PlanModel
+{
+public:
+    void reset(QVector<Line> lines)
+    {
+        m_lines = std::move(lines);
+        m_totals = PlanTotals();
+        for (const Line &line : m_lines) {
+            m_totals += planLineTotals(line);
+        }
+    }
+
+    const QVector<Line> &lines() const { return m_lines; }
+    const Line &at(int row) const { return m_lines[row]; }
+    int size() const { return m_lines.size(); }
+    bool isEmpty() const { return m_lines.isEmpty(); }
+    const PlanTotals &totals() const { return m_totals; }
+
+    // Returns the updated line, or nullptr when row is out of range
+    const Line *setQuantity(int row, int quantity)
+    {
+        if (row < 0 || row >= m_lines.size()) {
+            return nullptr;
+        }
+        Line &line = m_lines[row];
+        m_totals -= planLineTotals(line);
+        setPlanLineQuantity(line, quantity);
+        m_totals += planLineTotals(line);
+        return &line;
+    }
+
+    void append(const Line &line)
+    {
+        m_lines.append(line);
+        m_totals += planLineTotals(line);
+    }
+
+    void removeAt(int row)
+    {
+        if (row >= 0 && row < m_lines.size()) {
+            m_totals -= planLineTotals(m_lines[row]);
+            m_lines.removeAt(row);
+        }
+    }
+
+private:
+    QVector<Line> m_lines;
+    PlanTotals m_totals;
+};
+
+using EquipmentPlanModel = PlanModel<EquipmentPlanItem>;
+using FacilityPlanModel = PlanModel<FacilityPlanItem>;
+
+} // namespace Frontier
+
+#endif // PLANMODEL_H
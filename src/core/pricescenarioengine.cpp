@@ -0,0 +1,222 @@
+/**
+ * @file pricescenarioengine.cpp
+ * @brief Price scenario engine implementation
+ */
+
+#include "pricescenarioengine.h"
+#include "itemcatalog.h"
+#include "profiler.h"
+
+#include <QSet>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <numeric>
+
+namespace Frontier {
+
+// =============================================================================
+// Compile
+// =============================================================================
+
+void PriceScenarioEngine::compile(std::shared_ptr<const RecipeGraph> graph, const ItemCatalog &catalog)
+{
+    m_graph = std::move(graph);
+    m_buy.clear();
+    m_sell.clear();
+    m_mainCategory.clear();
+    m_displayCategory.clear();
+    m_offsets.clear();
+    m_ingredientItem.clear();
+    m_ingredientQty.clear();
+    m_output.clear();
+    m_outputQty.clear();
+    m_baseProfit.clear();
+    if (!m_graph) {
+        return;
+    }
+
+    const RecipeGraph &g = *m_graph;
+    m_buy.fill(0.0, g.itemCount());
+    m_sell.fill(0.0, g.itemCount());
+    m_mainCategory.resize(g.itemCount());
+    m_displayCategory.resize(g.itemCount());
+    for (int item = 0; item < g.itemCount(); ++item) {
+        if (const Item *info = catalog.findByName(g.itemName(item))) {
+            m_buy[item] = info->buyPriceInternal;
+            m_sell[item] = info->sellPriceInternal;
+            m_mainCategory[item] = info->categoryMain;
+            m_displayCategory[item] = info->displayCategory();
+        }
+    }
+
+    m_offsets.reserve(g.recipeCount() + 1);
+    m_output.reserve(g.recipeCount());
+    m_outputQty.reserve(g.recipeCount());
+    m_baseProfit.reserve(g.recipeCount());
+    m_offsets.append(0);
+    for (int r = 0; r < g.recipeCount(); ++r) {
+        double cost = 0;
+        for (auto *edge = g.ingredientsBegin(r); edge != g.ingredientsEnd(r); ++edge) {
+            m_ingredientItem.append(edge->item);
+            m_ingredientQty.append(edge->quantity);
+            cost += m_buy[edge->item] * edge->quantity;
+        }
+        m_offsets.append(m_ingredientItem.size());
+        m_output.append(g.outputOf(r));
+        m_outputQty.append(g.outputQtyOf(r));
+        m_baseProfit.append(m_sell[g.outputOf(r)] * g.outputQtyOf(r) - cost);
+    }
+}
+
+QStringList PriceScenarioEngine::categories() const
+{
+    QSet<QString> seen;
+    QStringList names;
+    for (const QString &category : m_mainCategory) {
+        if (!category.isEmpty() && !seen.contains(category)) {
+            seen.insert(category);
+            names.append(category);
+        }
+    }
+    names.sort(Qt::CaseInsensitive);
+    return names;
+}
+
+// =============================================================================
+// Scenarios
+// =============================================================================
+
+bool PriceScenarioEngine::matches(const PriceAdjustment &adjustment, int item) const
+{
+    if (adjustment.category.isEmpty()) {
+        return true;
+    }
+    return m_mainCategory[item].compare(adjustment.category, Qt::CaseInsensitive) == 0
+           || m_displayCategory[item].compare(adjustment.category, Qt::CaseInsensitive) == 0;
+}
+
+void PriceScenarioEngine::applyScenario(const PriceScenario &scenario, double *buy, double *sell, int stride) const
+{
+    const int itemCount = m_buy.size();
+    for (const PriceAdjustment &adjustment : scenario.adjustments) {
+        auto apply = [&](int item) {
+            double &b = buy[item * stride];
+            double &s = sell[item * stride];
+            if (adjustment.buyPrice >= 0) b = adjustment.buyPrice;
+            if (adjustment.sellPrice >= 0) s = adjustment.sellPrice;
+            b *= 1.0 + adjustment.buyPercent / 100.0;
+            s *= 1.0 + adjustment.sellPercent / 100.0;
+            if (adjustment.sellRatio > 0) s = b * adjustment.sellRatio;
+        };
+
+        if (!adjustment.itemName.isEmpty()) {
+            const int item = m_graph->itemId(adjustment.itemName);
+            if (item >= 0) {
+                apply(item);
+            }
+            continue;
+        }
+        for (int item = 0; item < itemCount; ++item) {
+            if (matches(adjustment, item)) {
+                apply(item);
+            }
+        }
+    }
+}
+
+QVector<ScenarioResult> PriceScenarioEngine::run(const QVector<PriceScenario> &scenarios) const
+{
+    ProfileScope scope("PriceScenarioEngine::run");
+    QVector<ScenarioResult> results;
+    if (!m_graph || scenarios.isEmpty()) {
+        return results;
+    }
+
+    // Column 0 is the catalog; scenario i is column i + 1
+    const int stride = scenarios.size() + 1;
+    const int itemCount = m_buy.size();
+    const int recipeCount = m_output.size();
+
+    QVector<double> buy(itemCount * stride);
+    QVector<double> sell(itemCount * stride);
+    for (int item = 0; item < itemCount; ++item) {
+        std::fill_n(buy.data() + item * stride, stride, m_buy[item]);
+        std::fill_n(sell.data() + item * stride, stride, m_sell[item]);
+    }
+    for (int s = 1; s < stride; ++s) {
+        applyScenario(scenarios[s - 1], buy.data() + s, sell.data() + s, stride);
+    }
+
+    // Input cost and output value of every recipe in every column
+    QVector<double> input(recipeCount * stride, 0.0);
+    QVector<double> output(recipeCount * stride);
+    const double *buyPrices = buy.constData();
+    const double *sellPrices = sell.constData();
+    auto evaluate = [&, stride](int r) {
+        double *in = input.data() + r * stride;
+        for (int e = m_offsets[r]; e < m_offsets[r + 1]; ++e) {
+            const double qty = m_ingredientQty[e];
+            const double *price = buyPrices + m_ingredientItem[e] * stride;
+            for (int s = 0; s < stride; ++s) {
+                in[s] += qty * price[s];
+            }
+        }
+        double *out = output.data() + r * stride;
+        const double *price = sellPrices + m_output[r] * stride;
+        const double qty = m_outputQty[r];
+        for (int s = 0; s < stride; ++s) {
+            out[s] = qty * price[s];
+        }
+    };
+
+    // Each recipe writes only its own rows, so recipes split freely; below
+    // the threshold a pass is cheaper than waking the thread pool
+    constexpr qint64 ParallelThreshold = 1 << 16;
+    if (qint64(m_ingredientItem.size()) * stride >= ParallelThreshold) {
+        constexpr int ChunkRecipes = 256;
+        QVector<int> chunks;
+        for (int first = 0; first < recipeCount; first += ChunkRecipes) {
+            chunks.append(first);
+        }
+        QtConcurrent::blockingMap(chunks, [&](int first) {
+            const int last = qMin(first + ChunkRecipes, recipeCount);
+            for (int r = first; r < last; ++r) {
+                evaluate(r);
+            }
+        });
+    } else {
+        for (int r = 0; r < recipeCount; ++r) {
+            evaluate(r);
+        }
+    }
+
+    results.resize(scenarios.size());
+    for (int s = 1; s < stride; ++s) {
+        ScenarioResult &result = results[s - 1];
+        result.name = scenarios[s - 1].name;
+        result.profit.resize(recipeCount);
+        result.marginPercent.resize(recipeCount);
+        for (int r = 0; r < recipeCount; ++r) {
+            const double cost = input[r * stride + s];
+            const double profit = output[r * stride + s] - cost;
+            const double base = output[r * stride] - input[r * stride];
+            result.profit[r] = profit;
+            result.marginPercent[r] = cost > 0 ? profit / cost * 100.0 : 0.0;
+            result.profitDelta += profit - base;
+            if (base > 0 && profit <= 0) {
+                result.turnedLoss.append(r);
+            } else if (base <= 0 && profit > 0) {
+                result.turnedProfit.append(r);
+            }
+        }
+
+        result.ranking.resize(recipeCount);
+        std::iota(result.ranking.begin(), result.ranking.end(), 0);
+        const QVector<double> &profit = result.profit;
+        std::stable_sort(result.ranking.begin(), result.ranking.end(),
+                         [&profit](int a, int b) { return profit[a] > profit[b]; });
+    }
+    return results;
+}
+
+} // namespace Frontier
@@ -0,0 +1,107 @@
+/**
+ * @file pricescenarioengine.h
+ * @brief Re-ranks every recipe under many what-if price sets at once
+ */
+
+#ifndef PRICESCENARIOENGINE_H
+#define PRICESCENARIOENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "types.h"
+#include "recipegraph.h"
+
+namespace Frontier {
+
+class ItemCatalog;
+
+/**
+ * @brief One price change within a scenario
+ *
+ * Matches one item by name, or every item of a category (main category,
+ * or "Main - Sub" as Item::displayCategory() writes it), or every item
+ * when both are empty. Absolute prices, as a patch note gives them, are
+ * applied before the percentage shifts.
+ */
+struct PriceAdjustment {
+    QString itemName;
+    QString category;
+    double buyPercent = 0;          // +10 raises the buy price by 10%
+    double sellPercent = 0;
+    double buyPrice = -1;           // New buy price; negative leaves it
+    double sellPrice = -1;
+    double sellRatio = 0;           // > 0 reprices sell as buy x ratio, as a custom PricingGroup
+};
+
+struct PriceScenario {
+    QString name;
+    QVector<PriceAdjustment> adjustments;   // Applied in order
+};
+
+/**
+ * @brief Every recipe under one scenario, against catalog prices
+ */
+struct ScenarioResult {
+    QString name;
+    QVector<double> profit;         // Per run, indexed like the graph's recipes
+    QVector<double> marginPercent;
+    QVector<int> ranking;           // Recipe indices, most profitable first
+    QVector<int> turnedLoss;        // Profitable at catalog prices, not here
+    QVector<int> turnedProfit;      // The other way round
+    double profitDelta = 0;         // Sum over recipes of profit change per run
+};
+
+/**
+ * @brief Evaluates price scenarios over precompiled recipe arrays
+ *
+ * compile() resolves catalog prices and categories once per graph item
+ * and copies the recipe book into flat ingredient arrays. run() lays the
+ * scenarios out as price matrices with one contiguous row of scenario
+ * prices per item, so each ingredient edge updates every scenario in one
+ * inner loop: the recipe book times the price matrix in a single pass,
+ * with catalog prices as column 0 to find the recipes that flip sign.
+ * Large batches are split over the global thread pool by recipe.
+ */
+class PriceScenarioEngine
+{
+public:
+    void compile(std::shared_ptr<const RecipeGraph> graph, const ItemCatalog &catalog);
+    bool isCompiled() const { return m_graph != nullptr; }
+    const std::shared_ptr<const RecipeGraph> &graph() const { return m_graph; }
+
+    // Profit per run at catalog prices, indexed like the graph's recipes
+    const QVector<double> &baseProfit() const { return m_baseProfit; }
+
+    // Main categories present among the graph's items, sorted
+    QStringList categories() const;
+
+    QVector<ScenarioResult> run(const QVector<PriceScenario> &scenarios) const;
+
+private:
+    bool matches(const PriceAdjustment &adjustment, int item) const;
+    void applyScenario(const PriceScenario &scenario, double *buy, double *sell, int stride) const;
+
+    std::shared_ptr<const RecipeGraph> m_graph;
+
+    // Per item
+    QVector<double> m_buy;
+    QVector<double> m_sell;
+    QVector<QString> m_mainCategory;
+    QVector<QString> m_displayCategory;
+
+    // Per recipe; ingredients of r are [m_offsets[r], m_offsets[r + 1])
+    QVector<int> m_offsets;
+    QVector<int> m_ingredientItem;
+    QVector<double> m_ingredientQty;
+    QVector<int> m_output;
+    QVector<double> m_outputQty;
+
+    QVector<double> m_baseProfit;
+};
+
+} // namespace Frontier
+
+#endif // PRICESCENARIOENGINE_H
@@ -0,0 +1,353 @@
+/**
+ * @file productionsolver.cpp
+ * @brief Production chain solver implementation
+ */
+
+#include "productionsolver.h"
+#include "itemcatalog.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <limits>
+
+namespace Frontier {
+
+ProductionSolver::ProductionSolver(std::shared_ptr<const RecipeGraph> graph)
+    : m_graph(std::move(graph))
+{
+}
+
+// =============================================================================
+// Solving
+// =============================================================================
+
+ProductionPlan ProductionSolver::solve(int recipeIndex, int runs, bool expandChain,
+                                       const ItemCatalog &catalog,
+                                       const StockLookup &stockOf) const
+{
+    ProductionPlan plan;
+    if (!m_graph || recipeIndex < 0 || recipeIndex >= m_graph->recipeCount() || runs <= 0) {
+        return plan;
+    }
+
+    const RecipeGraph &graph = *m_graph;
+    const int rootOutput = graph.outputOf(recipeIndex);
+    QVector<qint64> craftDemand(graph.itemCount(), 0);
+    QVector<qint64> rawDemand(graph.itemCount(), 0);
+
+    auto addIngredients = [&](int recipe, qint64 recipeRuns) {
+        for (auto *edge = graph.ingredientsBegin(recipe); edge != graph.ingredientsEnd(recipe); ++edge) {
+            qint64 qty = static_cast<qint64>(edge->quantity) * recipeRuns;
+
+            // The ordered item itself is never crafted as its own input
+            bool craft = expandChain && !edge->cutsCycle
+                         && graph.producer(edge->item) >= 0 && edge->item != rootOutput;
+            (craft ? craftDemand : rawDemand)[edge->item] += qty;
+        }
+    };
+
+    addIngredients(recipeIndex, runs);
+
+    // Every consumer of an item precedes it in the topological order, so its
+    // demand is final by the time we reach it and it is expanded exactly once
+    if (expandChain) {
+        for (int item : graph.topologicalOrder()) {
+            qint64 demand = craftDemand[item];
+            if (demand <= 0) {
+                continue;
+            }
+
+            int recipe = graph.producer(item);
+            int outputQty = graph.outputQtyOf(recipe);
+            qint64 recipeRuns = (demand + outputQty - 1) / outputQty;  // Ceiling division
+            plan.craftRuns[graph.itemName(item)] = static_cast<int>(recipeRuns);
+            addIngredients(recipe, recipeRuns);
+        }
+    }
+
+    for (int item = 0; item < rawDemand.size(); ++item) {
+        if (rawDemand[item] <= 0) {
+            continue;
+        }
+
+        const QString &name = graph.itemName(item);
+        int qty = static_cast<int>(qMin<qint64>(rawDemand[item], std::numeric_limits<int>::max()));
+        plan.rawMaterials[name] = qty;
+        plan.totalMaterialUnits += qty;
+
+        if (const Item *itemInfo = catalog.findByName(name)) {
+            plan.inputCost += itemInfo->buyPriceInternal * qty;
+        }
+
+        int inStock = stockOf ? stockOf(name) : 0;
+        if (qty > inStock) {
+            plan.shortfalls[name] = qty - inStock;
+        }
+    }
+    plan.totalMaterialTypes = plan.rawMaterials.size();
+
+    if (const Item *output = catalog.findByName(graph.itemName(rootOutput))) {
+        plan.outputValue = output->sellPriceInternal * graph.outputQtyOf(recipeIndex) * runs;
+    }
+
+    plan.profit = plan.outputValue - plan.inputCost;
+    if (plan.inputCost > 0) {
+        plan.marginPercent = (plan.profit / plan.inputCost) * 100.0;
+    }
+
+    return plan;
+}
+
+ProductionTree ProductionSolver::buildTree(int recipeIndex, int runs, bool expandChain,
+                                           const ItemCatalog &catalog,
+                                           const StockLookup &stockOf) const
+{
+    ProductionTree tree;
+    if (!m_graph || recipeIndex < 0 || recipeIndex >= m_graph->recipeCount() || runs <= 0) {
+        return tree;
+    }
+
+    const RecipeGraph &graph = *m_graph;
+    const int rootOutput = graph.outputOf(recipeIndex);
+    QVector<ProductionNode> &nodes = tree.m_nodes;
+
+    // Stock is looked up once per item, not once per occurrence
+    QVector<int> stock(graph.itemCount(), -1);
+    auto stockFor = [&](int item) {
+        if (stock[item] < 0) {
+            stock[item] = stockOf ? stockOf(graph.itemName(item)) : 0;
+        }
+        return stock[item];
+    };
+
+    // An expanded subtree depends only on (item, quantity), so repeated
+    // occurrences of the same intermediate reuse its child range
+    QHash<quint64, std::pair<int, int>> memo;
+    std::function<void(int, int, qint64)> expandInto;
+
+    // Appends a node's children as one block, then expands each in turn.
+    // Indices only: expanding a child grows the array and moves it.
+    expandInto = [&](int parent, int recipe, qint64 recipeRuns) {
+        const int first = nodes.size();
+        const int count = int(graph.ingredientsEnd(recipe) - graph.ingredientsBegin(recipe));
+        nodes.resize(first + count);
+        nodes[parent].firstChild = first;
+        nodes[parent].childCount = count;
+
+        int index = first;
+        for (auto *edge = graph.ingredientsBegin(recipe); edge != graph.ingredientsEnd(recipe);
+             ++edge, ++index) {
+            const int qty = static_cast<int>(edge->quantity * recipeRuns);
+            const bool craft = expandChain && !edge->cutsCycle
+                               && graph.producer(edge->item) >= 0 && edge->item != rootOutput;
+
+            ProductionNode &node = nodes[index];
+            node.itemName = graph.itemName(edge->item);
+            node.quantityNeeded = qty;
+            node.quantityInInventory = stockFor(edge->item);
+            node.isCraftable = graph.producer(edge->item) >= 0;
+            if (!craft) {
+                node.isRawMaterial = true;
+                if (const Item *itemInfo = catalog.findByName(node.itemName)) {
+                    node.unitCost = itemInfo->buyPriceInternal;
+                }
+                continue;
+            }
+
+            const quint64 key = (static_cast<quint64>(edge->item) << 32) | static_cast<quint32>(qty);
+            auto it = memo.constFind(key);
+            if (it != memo.constEnd()) {
+                node.firstChild = it->first;
+                node.childCount = it->second;
+                continue;
+            }
+
+            const int producer = graph.producer(edge->item);
+            const int outputQty = graph.outputQtyOf(producer);
+            const qint64 childRuns = (qty + outputQty - 1) / outputQty;  // Ceiling division
+            expandInto(index, producer, childRuns);
+            memo.insert(key, {nodes[index].firstChild, nodes[index].childCount});
+        }
+    };
+
+    ProductionNode root;
+    root.itemName = graph.itemName(rootOutput);
+    root.quantityNeeded = graph.outputQtyOf(recipeIndex) * runs;
+    root.quantityInInventory = stockFor(rootOutput);
+    root.isCraftable = true;
+    nodes.append(std::move(root));
+    expandInto(ProductionTree::RootIndex, recipeIndex, runs);
+
+    nodes.squeeze();
+    return tree;
+}
+
+qint64 ProductionTree::occurrenceCount() const
+{
+    if (m_nodes.isEmpty()) {
+        return 0;
+    }
+
+    // Subtree sizes, each stored node counted once; a shared range may
+    // sit before or after a later parent, so this recurses rather than sweeps
+    QVector<qint64> subtree(m_nodes.size(), 0);
+    std::function<qint64(int)> sizeOf = [&](int index) -> qint64 {
+        if (subtree[index] == 0) {
+            const ProductionNode &node = m_nodes[index];
+            qint64 total = 1;
+            for (int c = 0; c < node.childCount; ++c) {
+                total += sizeOf(node.firstChild + c);
+            }
+            subtree[index] = total;
+        }
+        return subtree[index];
+    };
+    return sizeOf(RootIndex);
+}
+
+// =============================================================================
+// Craft From Stock
+// =============================================================================
+
+CraftPlan ProductionSolver::planFromStock(const ItemCatalog &catalog,
+                                          const StockLookup &stockOf) const
+{
+    CraftPlan plan;
+    if (isEmpty()) {
+        return plan;
+    }
+
+    const RecipeGraph &graph = *m_graph;
+    const int itemCount = graph.itemCount();
+
+    // Dense per-item stock and prices, gathered once
+    QVector<qint64> stock(itemCount, 0);
+    for (int item = 0; item < itemCount; ++item) {
+        stock[item] = stockOf ? qMax(0, stockOf(graph.itemName(item))) : 0;
+    }
+    QVector<double> buyPrice;
+    QVector<double> sellPrice;
+    gatherPrices(catalog, buyPrice, sellPrice);
+
+    auto runsFrom = [&](int recipe, const QVector<qint64> &available) {
+        qint64 runs = std::numeric_limits<int>::max();
+        bool hasInputs = false;
+        for (auto *edge = graph.ingredientsBegin(recipe); edge != graph.ingredientsEnd(recipe); ++edge) {
+            if (edge->quantity <= 0) {
+                continue;
+            }
+            hasInputs = true;
+            runs = qMin(runs, available[edge->item] / edge->quantity);
+        }
+        return hasInputs ? static_cast<int>(runs) : 0;
+    };
+
+    for (int r = 0; r < graph.recipeCount(); ++r) {
+        int maxRuns = runsFrom(r, stock);
+        if (maxRuns <= 0) {
+            continue;
+        }
+
+        CraftOption option;
+        option.recipeIndex = r;
+        option.maxRuns = maxRuns;
+        option.profitPerRun = sellPrice[graph.outputOf(r)] * graph.outputQtyOf(r);
+        for (auto *edge = graph.ingredientsBegin(r); edge != graph.ingredientsEnd(r); ++edge) {
+            option.profitPerRun -= buyPrice[edge->item] * edge->quantity;
+        }
+        plan.options.append(option);
+    }
+
+    // Greedy allotment: most profitable recipes draw on the shared stock first
+    std::stable_sort(plan.options.begin(), plan.options.end(),
+                     [](const CraftOption &a, const CraftOption &b) {
+                         return a.profitPerRun > b.profitPerRun;
+                     });
+
+    QVector<qint64> remaining = stock;
+    for (auto &option : plan.options) {
+        if (option.profitPerRun <= 0) {
+            break;
+        }
+
+        int runs = runsFrom(option.recipeIndex, remaining);
+        if (runs <= 0) {
+            continue;
+        }
+
+        option.plannedRuns = runs;
+        for (auto *edge = graph.ingredientsBegin(option.recipeIndex);
+             edge != graph.ingredientsEnd(option.recipeIndex); ++edge) {
+            qint64 used = static_cast<qint64>(edge->quantity) * runs;
+            remaining[edge->item] -= used;
+            plan.totalInputCost += buyPrice[edge->item] * used;
+        }
+        plan.totalOutputValue += sellPrice[graph.outputOf(option.recipeIndex)]
+                                 * graph.outputQtyOf(option.recipeIndex) * runs;
+    }
+
+    plan.totalProfit = plan.totalOutputValue - plan.totalInputCost;
+    return plan;
+}
+
+// =============================================================================
+// Recipe Economics
+// =============================================================================
+
+void ProductionSolver::gatherPrices(const ItemCatalog &catalog,
+                                    QVector<double> &buyPrice, QVector<double> &sellPrice) const
+{
+    const RecipeGraph &graph = *m_graph;
+    buyPrice.fill(0.0, graph.itemCount());
+    sellPrice.fill(0.0, graph.itemCount());
+    for (int item = 0; item < graph.itemCount(); ++item) {
+        if (const Item *itemInfo = catalog.findByName(graph.itemName(item))) {
+            buyPrice[item] = itemInfo->buyPriceInternal;
+            sellPrice[item] = itemInfo->sellPriceInternal;
+        }
+    }
+}
+
+QVector<RecipeEconomics> ProductionSolver::evaluateRecipes(const ItemCatalog &catalog) const
+{
+    QVector<RecipeEconomics> results;
+    if (isEmpty()) {
+        return results;
+    }
+
+    const RecipeGraph &graph = *m_graph;
+    QVector<double> buyPrice;
+    QVector<double> sellPrice;
+    gatherPrices(catalog, buyPrice, sellPrice);
+
+    results.resize(graph.recipeCount());
+    for (int r = 0; r < results.size(); ++r) {
+        results[r].recipeIndex = r;
+    }
+
+    // Each recipe reads only the shared price arrays and its own ingredient
+    // slice and writes only its own result, so recipes evaluate independently
+    auto evaluate = [&](RecipeEconomics &econ) {
+        const int r = econ.recipeIndex;
+        for (auto *edge = graph.ingredientsBegin(r); edge != graph.ingredientsEnd(r); ++edge) {
+            econ.inputCost += buyPrice[edge->item] * edge->quantity;
+        }
+        econ.outputValue = sellPrice[graph.outputOf(r)] * graph.recipe(r).outputQty;
+        econ.profit = econ.outputValue - econ.inputCost;
+        if (econ.inputCost > 0) {
+            econ.marginPercent = (econ.profit / econ.inputCost) * 100.0;
+        }
+    };
+
+    // Below this a pass is cheaper than waking the thread pool
+    constexpr int ParallelThreshold = 2048;
+    if (results.size() >= ParallelThreshold) {
+        QtConcurrent::blockingMap(results, evaluate);
+    } else {
+        std::for_each(results.begin(), results.end(), evaluate);
+    }
+
+    return results;
+}
+
+} // namespace Frontier
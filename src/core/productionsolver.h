@@ -0,0 +1,177 @@
+/**
+ * @file productionsolver.h
+ * @brief Production chain solver over a compiled recipe DAG
+ */
+
+#ifndef PRODUCTIONSOLVER_H
+#define PRODUCTIONSOLVER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <functional>
+#include <memory>
+
+#include "types.h"
+#include "recipegraph.h"
+
+namespace Frontier {
+
+class ItemCatalog;
+
+/**
+ * @brief A node in a displayed production chain tree
+ */
+struct ProductionNode {
+    QString itemName;
+    int quantityNeeded = 0;
+    int quantityInInventory = 0;
+    bool isCraftable = false;
+    bool isRawMaterial = false;  // Leaf node (no recipe or not expanding)
+    double unitCost = 0.0;       // Buy price for raw materials
+    int firstChild = 0;          // Children are ProductionTree nodes
+    int childCount = 0;          // [firstChild, firstChild + childCount)
+
+    int shortfall() const {
+        return qMax(0, quantityNeeded - quantityInInventory);
+    }
+
+    bool hasShortfall() const {
+        return quantityNeeded > quantityInInventory;
+    }
+};
+
+/**
+ * @brief A production chain as one flat node array
+ *
+ * The root is node 0 and each node's children sit in one contiguous index
+ * range, so the whole tree is a single allocation walked by index. Nodes
+ * are written in place as the solver expands them; nothing is copied.
+ * A sub-assembly needed in the same quantity at several places is
+ * expanded once and every occurrence points at the same child range, so
+ * storage follows distinct sub-assemblies while a walk from the root
+ * still sees every occurrence. Move-only: a tree can be large.
+ */
+class ProductionTree
+{
+public:
+    static constexpr int RootIndex = 0;
+
+    ProductionTree() = default;
+    ProductionTree(ProductionTree &&) = default;
+    ProductionTree &operator=(ProductionTree &&) = default;
+    ProductionTree(const ProductionTree &) = delete;
+    ProductionTree &operator=(const ProductionTree &) = delete;
+
+    bool isEmpty() const { return m_nodes.isEmpty(); }
+    int size() const { return m_nodes.size(); }     // Stored nodes
+    const ProductionNode &root() const { return m_nodes[RootIndex]; }
+    const ProductionNode &node(int index) const { return m_nodes[index]; }
+
+    // Index of a node's i-th child
+    int child(const ProductionNode &parent, int i) const { return parent.firstChild + i; }
+
+    // Nodes a full walk from the root visits, each shared range at every
+    // occurrence; what a per-occurrence tree would have allocated
+    qint64 occurrenceCount() const;
+
+private:
+    friend class ProductionSolver;
+
+    QVector<ProductionNode> m_nodes;
+};
+
+/**
+ * @brief Aggregated requirements for one production order
+ */
+struct ProductionPlan {
+    int totalMaterialTypes = 0;      // Unique raw materials
+    int totalMaterialUnits = 0;      // Total raw material units
+    double inputCost = 0.0;          // Cost to buy all raw materials
+    double outputValue = 0.0;        // Value of output
+    double profit = 0.0;
+    double marginPercent = 0.0;
+    QMap<QString, int> rawMaterials; // item name -> quantity needed
+    QMap<QString, int> shortfalls;   // item name -> shortfall quantity
+    QMap<QString, int> craftRuns;    // intermediate item -> recipe runs
+};
+
+/**
+ * @brief One recipe evaluated against current stock
+ */
+struct CraftOption {
+    int recipeIndex = -1;            // RecipeGraph recipe index
+    int maxRuns = 0;                 // Runs possible from stock if crafted alone
+    double profitPerRun = 0.0;       // Output sell value minus input buy cost
+    int plannedRuns = 0;             // Runs allotted in the combined plan
+};
+
+/**
+ * @brief Every craftable recipe plus a combined plan sharing one stockpile
+ */
+struct CraftPlan {
+    QVector<CraftOption> options;    // Recipes with maxRuns > 0
+    double totalProfit = 0.0;
+    double totalOutputValue = 0.0;
+    double totalInputCost = 0.0;
+};
+
+/**
+ * @brief Per-run economics of one recipe at catalog prices
+ */
+struct RecipeEconomics {
+    int recipeIndex = -1;            // RecipeGraph recipe index
+    double inputCost = 0.0;          // Ingredients at buy price
+    double outputValue = 0.0;        // Output at sell price
+    double profit = 0.0;
+    double marginPercent = 0.0;
+};
+
+/**
+ * @brief Solves production chains over a shared RecipeGraph
+ *
+ * solve() accumulates demand in the graph's topological order, so each
+ * intermediate is expanded exactly once no matter how many recipes use it.
+ * Ingredient edges the graph cut to break a cycle are bought, not crafted.
+ */
+class ProductionSolver
+{
+public:
+    using StockLookup = std::function<int(const QString &itemName)>;
+
+    ProductionSolver() = default;
+    explicit ProductionSolver(std::shared_ptr<const RecipeGraph> graph);
+
+    void setGraph(std::shared_ptr<const RecipeGraph> graph) { m_graph = std::move(graph); }
+    const std::shared_ptr<const RecipeGraph> &graph() const { return m_graph; }
+    bool isEmpty() const { return !m_graph || m_graph->recipeCount() == 0; }
+
+    // recipeIndex is the graph's dense recipe index
+    ProductionPlan solve(int recipeIndex, int runs, bool expandChain,
+                         const ItemCatalog &catalog, const StockLookup &stockOf) const;
+
+    // Tree for display; identical subtrees are built once and shared
+    ProductionTree buildTree(int recipeIndex, int runs, bool expandChain,
+                             const ItemCatalog &catalog, const StockLookup &stockOf) const;
+
+    // Evaluates every recipe against stock in one pass over the graph, then
+    // allots stock to recipes greedily by profit per run. Only direct
+    // crafting is considered; outputs are not fed back in as inputs.
+    CraftPlan planFromStock(const ItemCatalog &catalog, const StockLookup &stockOf) const;
+
+    // Economics of every recipe, indexed like the graph's recipes. Prices
+    // are resolved once per item, and large books are split across the
+    // global thread pool.
+    QVector<RecipeEconomics> evaluateRecipes(const ItemCatalog &catalog) const;
+
+private:
+    void gatherPrices(const ItemCatalog &catalog,
+                      QVector<double> &buyPrice, QVector<double> &sellPrice) const;
+
+    std::shared_ptr<const RecipeGraph> m_graph;
+};
+
+} // namespace Frontier
+
+#endif // PRODUCTIONSOLVER_H
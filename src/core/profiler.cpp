@@ -0,0 +1,142 @@
+/**
+ * @file profiler.cpp
+ * @brief Profiler registry implementation
+ */
+
+#include "profiler.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#endif
+
+namespace Frontier {
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::record(const QString &name, qint64 ns, const QString &detail)
+{
+    QMutexLocker lock(&m_mutex);
+
+    ProfileStat &stat = m_stats[name];
+    if (stat.calls == 0) {
+        stat.name = name;
+    }
+    stat.calls++;
+    stat.totalNs += ns;
+    stat.maxNs = qMax(stat.maxNs, ns);
+
+    if (ns < SlowCallNs) {
+        return;
+    }
+
+    SlowCall call{name, detail, ns, QDateTime::currentDateTime()};
+    if (m_slowCalls.size() < SlowCallCapacity) {
+        m_slowCalls.append(call);
+    } else {
+        m_slowCalls[m_slowNext] = call;
+    }
+    m_slowNext = (m_slowNext + 1) % SlowCallCapacity;
+}
+
+QVector<ProfileStat> Profiler::stats() const
+{
+    QMutexLocker lock(&m_mutex);
+    QVector<ProfileStat> stats(m_stats.cbegin(), m_stats.cend());
+    lock.unlock();
+
+    std::sort(stats.begin(), stats.end(), [](const ProfileStat &a, const ProfileStat &b) {
+        return a.totalNs > b.totalNs;
+    });
+    return stats;
+}
+
+QVector<SlowCall> Profiler::slowCalls() const
+{
+    QMutexLocker lock(&m_mutex);
+    QVector<SlowCall> calls = m_slowCalls;
+    lock.unlock();
+
+    std::sort(calls.begin(), calls.end(), [](const SlowCall &a, const SlowCall &b) {
+        return a.ns > b.ns;
+    });
+    return calls;
+}
+
+void Profiler::reset()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats.clear();
+    m_slowCalls.clear();
+    m_slowNext = 0;
+}
+
+// =============================================================================
+// Memory
+// =============================================================================
+
+void Profiler::setMemoryReporter(const QString &name, std::function<qint64()> reporter)
+{
+    QMutexLocker lock(&m_mutex);
+    m_memoryReporters[name] = std::move(reporter);
+}
+
+void Profiler::removeMemoryReporter(const QString &name)
+{
+    QMutexLocker lock(&m_mutex);
+    m_memoryReporters.remove(name);
+}
+
+QVector<MemoryReport> Profiler::memoryReports() const
+{
+    QMutexLocker lock(&m_mutex);
+    const auto reporters = m_memoryReporters;
+    lock.unlock();
+
+    // Called unlocked: a reporter may load its cache and record timings
+    QVector<MemoryReport> reports;
+    reports.reserve(reporters.size());
+    for (auto it = reporters.cbegin(); it != reporters.cend(); ++it) {
+        reports.append({it.key(), it.value()()});
+    }
+    return reports;
+}
+
+qint64 Profiler::residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    // Second field of statm is resident pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+} // namespace Frontier
@@ -0,0 +1,161 @@
+/**
+ * @file profiler.h
+ * @brief Lightweight scoped timers, slow-call log and cache memory reporting
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <functional>
+#include <type_traits>
+
+#include "tracing.h"
+
+namespace Frontier {
+
+struct ProfileStat {
+    QString name;
+    int calls = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+
+    double totalMs() const { return totalNs / 1e6; }
+    double averageMs() const { return calls > 0 ? totalNs / 1e6 / calls : 0; }
+    double maxMs() const { return maxNs / 1e6; }
+};
+
+struct SlowCall {
+    QString name;
+    QString detail;                  // SQL or other context, may be empty
+    qint64 ns = 0;
+    QDateTime at;
+};
+
+struct MemoryReport {
+    QString name;
+    qint64 bytes = 0;
+};
+
+/**
+ * @brief Process-wide timing and memory registry behind the Diagnostics page
+ *
+ * Timings are aggregated per scope name ("Database::initialize",
+ * "Refresh: LedgerTab", "Startup: Finance tab"). Calls slower than
+ * SlowCallNs are also kept in a ring buffer of the most recent
+ * SlowCallCapacity entries. Recording takes a mutex, so it is safe from
+ * the worker and pool threads, but it is meant for coarse scopes (whole
+ * queries), not inner loops.
+ *
+ * Caches register a memory reporter under a unique name and remove it on
+ * destruction; reporters are called on the thread asking for the report,
+ * so they must only read state owned by that thread (the GUI thread).
+ */
+class Profiler
+{
+public:
+    static Profiler &instance();
+
+    void record(const QString &name, qint64 ns, const QString &detail = QString());
+
+    QVector<ProfileStat> stats() const;          // Sorted by total time
+    QVector<SlowCall> slowCalls() const;         // Slowest first
+    void reset();
+
+    void setMemoryReporter(const QString &name, std::function<qint64()> reporter);
+    void removeMemoryReporter(const QString &name);
+    QVector<MemoryReport> memoryReports() const;
+
+    // Resident set size of the process, or -1 where unsupported
+    static qint64 residentBytes();
+
+    static constexpr qint64 SlowCallNs = 2'000'000;     // 2 ms
+    static constexpr int SlowCallCapacity = 64;
+
+private:
+    Profiler() = default;
+
+    mutable QMutex m_mutex;
+    QHash<QString, ProfileStat> m_stats;
+    QVector<SlowCall> m_slowCalls;               // Ring buffer
+    int m_slowNext = 0;
+    QMap<QString, std::function<qint64()>> m_memoryReporters;
+};
+
+/**
+ * @brief Records the time from construction to destruction under a name
+ *
+ * Also a trace zone of the same name when tracing is compiled in.
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name)
+        : m_name(name)
+#ifdef FRONTIER_TRACING
+        , m_zone(name)
+#endif
+    {
+        m_timer.start();
+    }
+    ~ProfileScope()
+    {
+        Profiler::instance().record(QString::fromLatin1(m_name), m_timer.nsecsElapsed(), m_detail);
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+    void setDetail(const QString &detail) { m_detail = detail; }
+
+private:
+    const char *m_name;
+#ifdef FRONTIER_TRACING
+    Trace::Zone m_zone;
+#endif
+    QString m_detail;
+    QElapsedTimer m_timer;
+};
+
+// === Memory Estimates ===
+// Approximate heap use of common containers: element storage by capacity
+// plus string payloads. Hash node overhead is a rough two pointers.
+
+inline qint64 estimateBytes(const QString &str)
+{
+    return str.capacity() * qint64(sizeof(QChar));
+}
+
+template <typename T>
+qint64 estimateBytes(const QVector<T> &vec)
+{
+    qint64 bytes = vec.capacity() * qint64(sizeof(T));
+    if constexpr (std::is_same_v<T, QString>) {
+        for (const QString &str : vec) {
+            bytes += estimateBytes(str);
+        }
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+qint64 estimateBytes(const QHash<K, V> &hash)
+{
+    qint64 bytes = hash.size() * qint64(sizeof(K) + sizeof(V) + 2 * sizeof(void *));
+    if constexpr (std::is_same_v<K, QString>) {
+        for (auto it = hash.keyBegin(); it != hash.keyEnd(); ++it) {
+            bytes += estimateBytes(*it);
+        }
+    }
+    return bytes;
+}
+
+} // namespace Frontier
+
+#endif // PROFILER_H
@@ -0,0 +1,140 @@
+/**
+ * @file profileregistry.cpp
+ * @brief Profile list persistence
+ */
+
+#include "profileregistry.h"
+
+#include <QSettings>
+#include <QVariantMap>
+#include <QFileInfo>
+#include <QDir>
+#include <algorithm>
+
+namespace Frontier {
+
+namespace {
+
+const char *const DefaultDatabase = "frontier_mining.db";
+const char *const CatalogDatabase = "catalog.db";
+const char *const ProfileDirectory = "profiles";
+
+// Profile name -> database path, the default excluded
+QVariantMap savedProfiles()
+{
+    return QSettings("FrontierMining", "Tracker").value("Profiles/files").toMap();
+}
+
+// A file name the profile's name can be recognised in
+QString fileStem(const QString &name)
+{
+    QString stem;
+    for (QChar c : name) {
+        stem += c.isLetterOrNumber() || c == QLatin1Char('-') ? c : QLatin1Char('_');
+    }
+    return stem;
+}
+
+} // namespace
+
+const QString ProfileRegistry::DefaultName = QStringLiteral("Default");
+
+QVector<TrackerProfile> ProfileRegistry::profiles()
+{
+    QVector<TrackerProfile> list;
+    const QVariantMap saved = savedProfiles();
+    for (auto it = saved.constBegin(); it != saved.constEnd(); ++it) {
+        list.append({it.key(), it.value().toString()});
+    }
+    std::sort(list.begin(), list.end(), [](const TrackerProfile &a, const TrackerProfile &b) {
+        return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+    });
+    list.prepend({DefaultName, DefaultDatabase});
+    return list;
+}
+
+std::optional<TrackerProfile> ProfileRegistry::find(const QString &name)
+{
+    for (const TrackerProfile &profile : profiles()) {
+        if (profile.name.compare(name, Qt::CaseInsensitive) == 0) {
+            return profile;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<TrackerProfile> ProfileRegistry::add(const QString &name, QString *error)
+{
+    const QString trimmed = name.trimmed();
+    QString problem;
+    if (trimmed.isEmpty()) {
+        problem = "A profile needs a name";
+    } else if (trimmed.contains(QLatin1Char('/')) || trimmed.contains(QLatin1Char('\\'))) {
+        problem = "Profile names cannot contain / or \\";
+    } else if (find(trimmed)) {
+        problem = QString("There is already a profile named %1").arg(trimmed);
+    }
+    if (!problem.isEmpty()) {
+        if (error) {
+            *error = problem;
+        }
+        return std::nullopt;
+    }
+
+    // Two names can share a stem ("A B" and "A_B"); the later one is numbered
+    const QDir dir(ProfileDirectory);
+    const QString stem = fileStem(trimmed);
+    QString path = dir.filePath(stem + ".db");
+    for (int n = 2; QFileInfo::exists(path); ++n) {
+        path = dir.filePath(QString("%1-%2.db").arg(stem).arg(n));
+    }
+    if (!QDir().mkpath(ProfileDirectory)) {
+        if (error) {
+            *error = QString("Cannot create the %1 folder").arg(ProfileDirectory);
+        }
+        return std::nullopt;
+    }
+
+    QVariantMap saved = savedProfiles();
+    saved.insert(trimmed, path);
+    QSettings("FrontierMining", "Tracker").setValue("Profiles/files", saved);
+    return TrackerProfile{trimmed, path};
+}
+
+bool ProfileRegistry::remove(const QString &name)
+{
+    QVariantMap saved = savedProfiles();
+    const std::optional<TrackerProfile> profile = find(name);
+    if (!profile || profile->name == DefaultName) {
+        return false;
+    }
+
+    saved.remove(profile->name);
+    QSettings settings("FrontierMining", "Tracker");
+    settings.setValue("Profiles/files", saved);
+    if (settings.value("Profiles/current").toString() == profile->name) {
+        settings.remove("Profiles/current");
+    }
+    return true;
+}
+
+TrackerProfile ProfileRegistry::current()
+{
+    const QString name = QSettings("FrontierMining", "Tracker").value("Profiles/current").toString();
+    if (const std::optional<TrackerProfile> profile = find(name)) {
+        return *profile;
+    }
+    return {DefaultName, DefaultDatabase};
+}
+
+void ProfileRegistry::setCurrent(const QString &name)
+{
+    QSettings("FrontierMining", "Tracker").setValue("Profiles/current", name);
+}
+
+QString ProfileRegistry::catalogPath()
+{
+    return CatalogDatabase;
+}
+
+} // namespace Frontier
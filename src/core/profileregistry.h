@@ -0,0 +1,61 @@
+/**
+ * @file profileregistry.h
+ * @brief Named tracker profiles, each with its own database file
+ */
+
+#ifndef PROFILEREGISTRY_H
+#define PROFILEREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <optional>
+
+namespace Frontier {
+
+/**
+ * @brief One map or playthrough and the file that holds it
+ */
+struct TrackerProfile {
+    QString name;
+    QString databasePath;
+};
+
+/**
+ * @brief The profiles saved under Profiles/ in QSettings
+ *
+ * Each profile keeps its ledger, fleet, logs and plans in a file of its
+ * own and shares the reference data in catalogPath() with every other
+ * profile (see Database::setCatalogPath). The default profile always
+ * exists and keeps frontier_mining.db, the file used before profiles, so
+ * an existing install opens as it did; its reference rows move to the
+ * catalog the first time. New profiles get profiles/<name>.db.
+ * Relative paths resolve against the working directory, as they always
+ * have for the database file.
+ */
+class ProfileRegistry
+{
+public:
+    static const QString DefaultName;
+
+    // The default profile first, then the rest by name
+    static QVector<TrackerProfile> profiles();
+    static std::optional<TrackerProfile> find(const QString &name);
+
+    // A new profile with a new, not yet created, file; nullopt with error
+    // set when the name is empty, has a path separator or is taken
+    // (names compare case-insensitively)
+    static std::optional<TrackerProfile> add(const QString &name, QString *error = nullptr);
+    // Forgets the profile; its file stays on disk. The default profile
+    // cannot be removed, and removing the current one makes the default current.
+    static bool remove(const QString &name);
+
+    // The profile opened at startup: the one last switched to, or the default
+    static TrackerProfile current();
+    static void setCurrent(const QString &name);
+
+    static QString catalogPath();
+};
+
+} // namespace Frontier
+
+#endif // PROFILEREGISTRY_H
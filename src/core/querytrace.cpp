@@ -0,0 +1,89 @@
+/**
+ * @file querytrace.cpp
+ * @brief Query trace log and CSV export
+ */
+
+#include "querytrace.h"
+
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace Frontier {
+
+namespace {
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))
+        && !value.contains(QLatin1Char('\n'))) {
+        return value;
+    }
+    QString escaped = value;
+    escaped.replace(QLatin1String("\""), QLatin1String("\"\""));
+    return QLatin1Char('"') + escaped + QLatin1Char('"');
+}
+
+} // namespace
+
+void QueryTracer::record(const QueryTraceEntry &entry)
+{
+    if (!entry.plan.isEmpty()) {
+        m_plans.insert(entry.sql, entry.plan);
+    }
+
+    if (m_entries.size() < Capacity) {
+        m_entries.append(entry);
+    } else {
+        m_entries[m_next] = entry;
+    }
+    m_next = (m_next + 1) % Capacity;
+}
+
+QVector<QueryTraceEntry> QueryTracer::entries() const
+{
+    if (m_entries.size() < Capacity) {
+        return m_entries;
+    }
+    QVector<QueryTraceEntry> ordered;
+    ordered.reserve(m_entries.size());
+    ordered.append(m_entries.mid(m_next));
+    ordered.append(m_entries.mid(0, m_next));
+    return ordered;
+}
+
+void QueryTracer::clear()
+{
+    m_entries.clear();
+    m_next = 0;
+    m_plans.clear();
+}
+
+bool QueryTracer::exportCsv(const QString &filePath) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_lastError = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "time,ms,binds,rows,ok,sql,plan\n";
+    for (const auto &entry : entries()) {
+        out << entry.at.toString(Qt::ISODateWithMs) << ','
+            << QString::number(entry.ms(), 'f', 3) << ','
+            << entry.binds << ','
+            << entry.rows << ','
+            << (entry.ok ? 1 : 0) << ','
+            << csvField(entry.sql.simplified()) << ','
+            << csvField(entry.plan) << '\n';
+    }
+    out.flush();
+
+    if (!file.commit()) {
+        m_lastError = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Frontier
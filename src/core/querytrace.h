@@ -0,0 +1,76 @@
+/**
+ * @file querytrace.h
+ * @brief Opt-in per-statement SQL log with query plans for slow statements
+ */
+
+#ifndef QUERYTRACE_H
+#define QUERYTRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+
+namespace Frontier {
+
+struct QueryTraceEntry {
+    QString sql;
+    int binds = 0;
+    int rows = -1;                   // Rows returned or changed; -1 if unknown
+    qint64 ns = 0;                   // exec() only, not result iteration
+    bool ok = true;
+    QDateTime at;
+    QString plan;                    // EXPLAIN QUERY PLAN, for slow statements
+
+    double ms() const { return ns / 1e6; }
+};
+
+/**
+ * @brief Statement log kept by one Database connection while tracing is on
+ *
+ * Database routes every exec() through execQuery(), which hands the
+ * statement here when tracing is enabled. The log keeps the most recent
+ * Capacity statements. Statements slower than the plan threshold get
+ * their EXPLAIN QUERY PLAN attached; plans are cached per SQL text, so a
+ * hot statement is only explained once.
+ *
+ * Counting the rows of a SELECT runs it a second time wrapped in
+ * COUNT(*), and explaining runs one more statement, so tracing is a
+ * diagnostic mode and off by default. The extra statements are not
+ * included in the recorded time.
+ */
+class QueryTracer
+{
+public:
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    qint64 planThresholdNs() const { return m_planThresholdNs; }
+    void setPlanThresholdMs(double ms) { m_planThresholdNs = qint64(ms * 1e6); }
+
+    void record(const QueryTraceEntry &entry);
+    QVector<QueryTraceEntry> entries() const;    // Oldest first
+    void clear();
+
+    // Cached plan for an SQL text, if it has been explained already
+    QString cachedPlan(const QString &sql) const { return m_plans.value(sql); }
+    bool hasPlan(const QString &sql) const { return m_plans.contains(sql); }
+
+    bool exportCsv(const QString &filePath) const;
+    QString lastError() const { return m_lastError; }
+
+    static constexpr int Capacity = 20000;
+    static constexpr double DefaultPlanThresholdMs = 5.0;
+
+private:
+    bool m_enabled = false;
+    qint64 m_planThresholdNs = qint64(DefaultPlanThresholdMs * 1e6);
+    QVector<QueryTraceEntry> m_entries;          // Ring buffer
+    int m_next = 0;
+    QHash<QString, QString> m_plans;
+    mutable QString m_lastError;
+};
+
+} // namespace Frontier
+
+#endif // QUERYTRACE_H
@@ -0,0 +1,42 @@
+/**
+ * @file readpool.cpp
+ * @brief Read connection pool implementation
+ */
+
+#include "readpool.h"
+#include "database.h"
+
+#include <QDebug>
+
+namespace Frontier {
+
+ReadPool::ReadPool(const QString &dbPath, const QString &catalogPath, int maxConnections)
+    : m_path(dbPath)
+    , m_catalogPath(catalogPath)
+{
+    m_pool.setMaxThreadCount(qMax(1, maxConnections));
+    // Idle threads are kept so their connections are not reopened per query
+    m_pool.setExpiryTimeout(-1);
+}
+
+ReadPool::~ReadPool()
+{
+    // Each thread's connection is closed by QThreadStorage as it exits
+    m_pool.waitForDone();
+}
+
+Database &ReadPool::connection()
+{
+    if (!m_connections.hasLocalData()) {
+        auto *db = new Database;
+        db->setCatalogPath(m_catalogPath);
+        if (!db->openExisting(m_path, true)) {
+            // Queries on a closed connection fail and return empty results
+            qWarning() << "Read pool failed to open" << m_path << ":" << db->lastError();
+        }
+        m_connections.setLocalData(db);
+    }
+    return *m_connections.localData();
+}
+
+} // namespace Frontier
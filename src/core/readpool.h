@@ -0,0 +1,68 @@
+/**
+ * @file readpool.h
+ * @brief Thread pool with one read-only database connection per thread
+ */
+
+#ifndef READPOOL_H
+#define READPOOL_H
+
+#include <QString>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+#include <type_traits>
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Runs independent read queries concurrently
+ *
+ * Each pool thread lazily opens its own read-only Database on the file
+ * and keeps it for the thread's lifetime, so connections and prepared
+ * statements are never shared between threads. With WAL journaling the
+ * readers run alongside each other and alongside writes on the primary
+ * connection; under the Safe profile's rollback journal they still work
+ * but wait on writers.
+ *
+ * As with DatabaseWorker, keep to SQL reads: the pooled instances'
+ * in-memory caches are not invalidated by writes on the primary.
+ */
+class ReadPool
+{
+public:
+    // catalogPath, if set, is attached as on the primary (see Database::setCatalogPath)
+    explicit ReadPool(const QString &dbPath, const QString &catalogPath = QString(),
+                      int maxConnections = DefaultConnections);
+    ~ReadPool();
+
+    ReadPool(const ReadPool &) = delete;
+    ReadPool &operator=(const ReadPool &) = delete;
+
+    // Runs fn(Database &) on a pool thread
+    template <typename Fn>
+    auto run(Fn fn) -> QFuture<std::invoke_result_t<Fn, Database &>>
+    {
+        return QtConcurrent::run(&m_pool, [this, fn = std::move(fn)]() mutable {
+            return fn(connection());
+        });
+    }
+
+    int maxConnections() const { return m_pool.maxThreadCount(); }
+
+    static constexpr int DefaultConnections = 4;
+
+private:
+    Database &connection();
+
+    QString m_path;
+    QString m_catalogPath;
+    QThreadStorage<Database *> m_connections;    // Must outlive m_pool's threads
+    QThreadPool m_pool;
+};
+
+} // namespace Frontier
+
+#endif // READPOOL_H
@@ -0,0 +1,147 @@
+/**
+ * @file recipegraph.cpp
+ * @brief Compiled recipe graph implementation
+ */
+
+#include "recipegraph.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Frontier {
+
+RecipeGraph::RecipeGraph(QVector<Recipe> recipes)
+    : m_recipes(std::move(recipes))
+{
+    const int recipeCount = m_recipes.size();
+    m_outputs.reserve(recipeCount);
+    m_outputQtys.reserve(recipeCount);
+    m_ingredientOffsets.reserve(recipeCount + 1);
+
+    for (int r = 0; r < recipeCount; ++r) {
+        const Recipe &recipe = m_recipes[r];
+        if (recipe.id) {
+            m_indexByRecipeId.insert(*recipe.id, r);
+        }
+
+        m_outputs.append(internItem(recipe.outputItem));
+        m_outputQtys.append(qMax(1, recipe.outputQty));
+        m_ingredientOffsets.append(m_ingredients.size());
+
+        for (const auto &ing : recipe.ingredients) {
+            Ingredient edge;
+            edge.item = internItem(ing.itemName);
+            edge.quantity = ing.quantity;
+            m_ingredients.append(edge);
+        }
+    }
+    m_ingredientOffsets.append(m_ingredients.size());
+
+    const int itemCount = m_itemNames.size();
+
+    // First recipe for an output wins, matching the calculator's lookup
+    m_producer.fill(-1, itemCount);
+    for (int r = 0; r < recipeCount; ++r) {
+        if (m_producer[m_outputs[r]] < 0) {
+            m_producer[m_outputs[r]] = r;
+        }
+    }
+
+    // Consumer lists via counting sort over ingredient edges
+    m_consumerOffsets.fill(0, itemCount + 1);
+    for (const auto &edge : m_ingredients) {
+        m_consumerOffsets[edge.item + 1]++;
+    }
+    for (int i = 0; i < itemCount; ++i) {
+        m_consumerOffsets[i + 1] += m_consumerOffsets[i];
+    }
+    m_consumers.resize(m_ingredients.size());
+    QVector<int> fill = m_consumerOffsets;
+    for (int r = 0; r < recipeCount; ++r) {
+        for (int e = m_ingredientOffsets[r]; e < m_ingredientOffsets[r + 1]; ++e) {
+            m_consumers[fill[m_ingredients[e].item]++] = r;
+        }
+    }
+
+    orderItems();
+}
+
+int RecipeGraph::internItem(const QString &name)
+{
+    auto it = m_itemIds.constFind(name);
+    if (it != m_itemIds.constEnd()) {
+        return it.value();
+    }
+
+    int id = m_itemNames.size();
+    m_itemNames.append(name);
+    m_itemIds.insert(name, id);
+    return id;
+}
+
+void RecipeGraph::orderItems()
+{
+    // Depth-first post-order over producer edges, reversed, so consumers
+    // precede ingredients. An edge back into the current path is a cycle;
+    // it is cut so that demand along it is bought rather than crafted.
+    enum : char { Unvisited, OnPath, Done };
+    QVector<char> state(m_itemNames.size(), Unvisited);
+    m_order.reserve(m_itemNames.size());
+
+    std::function<void(int)> visit = [&](int item) {
+        state[item] = OnPath;
+
+        int producer = m_producer[item];
+        if (producer >= 0) {
+            for (int e = m_ingredientOffsets[producer]; e < m_ingredientOffsets[producer + 1]; ++e) {
+                Ingredient &edge = m_ingredients[e];
+                if (state[edge.item] == OnPath) {
+                    edge.cutsCycle = true;
+                } else if (state[edge.item] == Unvisited) {
+                    visit(edge.item);
+                }
+            }
+        }
+
+        state[item] = Done;
+        m_order.append(item);
+    };
+
+    for (int item = 0; item < m_itemNames.size(); ++item) {
+        if (state[item] == Unvisited) {
+            visit(item);
+        }
+    }
+
+    std::reverse(m_order.begin(), m_order.end());
+}
+
+const Recipe *RecipeGraph::recipeById(int recipeId) const
+{
+    int index = recipeIndexForId(recipeId);
+    return index >= 0 ? &m_recipes[index] : nullptr;
+}
+
+bool RecipeGraph::isCraftable(const QString &itemName) const
+{
+    int id = itemId(itemName);
+    return id >= 0 && m_producer[id] >= 0;
+}
+
+qint64 RecipeGraph::estimatedBytes() const
+{
+    qint64 bytes = estimateBytes(m_recipes) + estimateBytes(m_indexByRecipeId)
+                   + estimateBytes(m_outputs) + estimateBytes(m_outputQtys)
+                   + estimateBytes(m_ingredientOffsets) + estimateBytes(m_ingredients)
+                   + estimateBytes(m_itemNames) + estimateBytes(m_itemIds)
+                   + estimateBytes(m_producer) + estimateBytes(m_consumerOffsets)
+                   + estimateBytes(m_consumers) + estimateBytes(m_order);
+    for (const Recipe &recipe : m_recipes) {
+        bytes += estimateBytes(recipe.workbenchName) + estimateBytes(recipe.outputItem)
+                 + estimateBytes(recipe.notes) + estimateBytes(recipe.ingredients);
+    }
+    return bytes;
+}
+
+} // namespace Frontier
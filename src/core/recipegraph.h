@@ -0,0 +1,93 @@
+/**
+ * @file recipegraph.h
+ * @brief Immutable, shareable compiled view of the recipe book
+ */
+
+#ifndef RECIPEGRAPH_H
+#define RECIPEGRAPH_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "types.h"
+
+namespace Frontier {
+
+/**
+ * @brief The recipe book compiled into dense ids and adjacency arrays
+ *
+ * Recipes are numbered 0..recipeCount()-1 in the order they were loaded and
+ * every item that appears as an output or ingredient gets an id in
+ * 0..itemCount()-1. Ingredients of a recipe and recipes consuming an item
+ * are stored as offset-indexed slices of flat arrays.
+ *
+ * producer(item) is the first recipe making that item, and topologicalOrder()
+ * lists items with every consumer ahead of its ingredients; ingredient
+ * edges that would close a cycle are flagged with cutsCycle.
+ *
+ * Database::recipeGraph() hands out one shared snapshot and builds a new
+ * one after recipes change; holders of the old snapshot are unaffected.
+ */
+class RecipeGraph
+{
+public:
+    struct Ingredient {
+        int item = -1;
+        int quantity = 0;
+        bool cutsCycle = false;      // Edge dropped to keep the graph acyclic
+    };
+
+    explicit RecipeGraph(QVector<Recipe> recipes);
+
+    // === Recipes ===
+    int recipeCount() const { return m_recipes.size(); }
+    const QVector<Recipe> &recipes() const { return m_recipes; }
+    const Recipe &recipe(int index) const { return m_recipes[index]; }
+    int recipeIndexForId(int recipeId) const { return m_indexByRecipeId.value(recipeId, -1); }
+    const Recipe *recipeById(int recipeId) const;
+
+    int outputOf(int index) const { return m_outputs[index]; }
+    int outputQtyOf(int index) const { return m_outputQtys[index]; }
+    const Ingredient *ingredientsBegin(int index) const { return m_ingredients.constData() + m_ingredientOffsets[index]; }
+    const Ingredient *ingredientsEnd(int index) const { return m_ingredients.constData() + m_ingredientOffsets[index + 1]; }
+
+    // === Items ===
+    int itemCount() const { return m_itemNames.size(); }
+    int itemId(const QString &itemName) const { return m_itemIds.value(itemName, -1); }
+    const QString &itemName(int item) const { return m_itemNames[item]; }
+    int producer(int item) const { return m_producer[item]; }
+    bool isCraftable(const QString &itemName) const;
+
+    // Recipe indices that use the item as an ingredient
+    const int *consumersBegin(int item) const { return m_consumers.constData() + m_consumerOffsets[item]; }
+    const int *consumersEnd(int item) const { return m_consumers.constData() + m_consumerOffsets[item + 1]; }
+
+    const QVector<int> &topologicalOrder() const { return m_order; }
+
+    // Approximate heap use of the graph and its recipe copies
+    qint64 estimatedBytes() const;
+
+private:
+    int internItem(const QString &name);
+    void orderItems();
+
+    QVector<Recipe> m_recipes;
+    QHash<int, int> m_indexByRecipeId;
+
+    QVector<int> m_outputs;
+    QVector<int> m_outputQtys;
+    QVector<int> m_ingredientOffsets;    // recipeCount() + 1 entries
+    QVector<Ingredient> m_ingredients;
+
+    QVector<QString> m_itemNames;
+    QHash<QString, int> m_itemIds;
+    QVector<int> m_producer;             // item -> recipe index, or -1
+    QVector<int> m_consumerOffsets;      // itemCount() + 1 entries
+    QVector<int> m_consumers;
+    QVector<int> m_order;
+};
+
+} // namespace Frontier
+
+#endif // RECIPEGRAPH_H
@@ -5,13 +5,36 @@
 
 #include "recipeimporter.h"
 #include "database.h"
+#include "jsonstreamreader.h"
+#include "tracing.h"
 
-#include <QFile>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
 
+// Recipes handed to Database::addRecipes per call
+static constexpr int RecipeBatchSize = 500;
+
+static Frontier::Recipe recipeFromJson(const QJsonObject &recipeObj)
+{
+    Frontier::Recipe recipe;
+    recipe.outputItem = recipeObj["output"].toString();
+    recipe.outputQty = recipeObj["output_qty"].toInt(1);
+    recipe.notes = recipeObj["notes"].toString();
+
+    QJsonArray inputsArray = recipeObj["inputs"].toArray();
+    for (const QJsonValue &inputVal : inputsArray) {
+        QJsonObject inputObj = inputVal.toObject();
+
+        Frontier::RecipeIngredient ingredient;
+        ingredient.itemName = inputObj["item"].toString();
+        ingredient.quantity = inputObj["qty"].toInt(1);
+        recipe.ingredients.append(ingredient);
+    }
+
+    return recipe;
+}
+
 RecipeImporter::RecipeImporter(Frontier::Database *database)
     : m_database(database)
 {
@@ -23,89 +46,151 @@ bool RecipeImporter::importFromJson(const QString &filePath)
     m_recipesImported = 0;
     m_lastError.clear();
 
-    // Open and read file
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        m_lastError = QString("Cannot open file: %1").arg(file.errorString());
-        return false;
-    }
-
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    // Parse JSON
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        m_lastError = QString("JSON parse error: %1").arg(parseError.errorString());
+    Frontier::JsonStreamReader reader(filePath);
+    if (!reader.isOpen()) {
+        m_lastError = reader.errorString();
         return false;
     }
 
-    if (!doc.isObject()) {
-        m_lastError = "Expected JSON object with workbench names as keys";
+    // Replace the whole recipe book in a single transaction
+    if (!m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
         return false;
     }
 
-    QJsonObject root = doc.object();
-
     // Clear existing recipes before import
     m_database->clearAllWorkbenches();
 
-    // Iterate over workbenches
-    for (auto it = root.begin(); it != root.end(); ++it) {
-        QString workbenchName = it.key();
-        QJsonArray recipesArray = it.value().toArray();
+    // The file is read one workbench and recipe at a time; recipes reach
+    // the database in batches instead of after the whole file is parsed
+    QVector<Frontier::Recipe> recipes;
+    int workbenchId = -1;
+    int added = 0;
+
+    auto flush = [&]() {
+        int count = m_database->addRecipes(recipes);
+        recipes.clear();
+        if (count < 0) {
+            added = -1;                  // Stops the reader
+            return false;
+        }
+        added += count;
+        return true;
+    };
 
-        // Add workbench
+    // Object with workbench names as keys, each holding a recipe array
+    auto onWorkbench = [&](const QString &workbenchName) {
         Frontier::Workbench workbench;
         workbench.name = workbenchName;
-        int workbenchId = m_database->addWorkbench(workbench);
+        workbenchId = m_database->addWorkbench(workbench);
 
         if (workbenchId < 0) {
             qWarning() << "Failed to add workbench:" << workbenchName;
-            continue;
+        } else {
+            m_workbenchesImported++;
         }
+        return true;
+    };
 
-        m_workbenchesImported++;
+    auto onRecipe = [&](const QJsonObject &recipeObj) {
+        if (workbenchId < 0) {
+            return true;
+        }
 
-        // Add recipes for this workbench
-        for (const QJsonValue &recipeVal : recipesArray) {
-            QJsonObject recipeObj = recipeVal.toObject();
+        Frontier::Recipe recipe = recipeFromJson(recipeObj);
+        recipe.workbenchId = workbenchId;
+        recipes.append(recipe);
+        return recipes.size() < RecipeBatchSize || flush();
+    };
 
-            Frontier::Recipe recipe;
-            recipe.workbenchId = workbenchId;
-            recipe.outputItem = recipeObj["output"].toString();
-            recipe.outputQty = recipeObj["output_qty"].toInt(1);
-            recipe.notes = recipeObj["notes"].toString();
+    bool ok = reader.readGroups(onWorkbench, onRecipe);
+    if (ok && added >= 0 && !recipes.isEmpty()) {
+        flush();
+    }
+
+    if (!ok || added < 0 || !m_database->commitTransaction()) {
+        m_lastError = ok ? QString("Failed to write recipes: %1").arg(m_database->lastError())
+                         : reader.errorString();
+        m_database->rollbackTransaction();
+        m_workbenchesImported = 0;
+        return false;
+    }
+
+    m_recipesImported = added;
+
+    qDebug() << "Recipe import complete:"
+             << m_workbenchesImported << "workbenches,"
+             << m_recipesImported << "recipes";
 
-            int recipeId = m_database->addRecipe(recipe);
+    return true;
+}
+
+QVector<WorkbenchRecipes> RecipeImporter::loadFromJson(const QString &filePath, QString *error)
+{
+    FRONTIER_TRACE_SCOPE("RecipeImporter::loadFromJson");
+    QVector<WorkbenchRecipes> book;
+
+    Frontier::JsonStreamReader reader(filePath);
+    bool ok = reader.readGroups(
+        [&book](const QString &workbenchName) {
+            book.append({workbenchName, {}});
+            return true;
+        },
+        [&book](const QJsonObject &recipeObj) {
+            book.last().recipes.append(recipeFromJson(recipeObj));
+            return true;
+        });
+
+    if (!ok) {
+        if (error) {
+            *error = reader.errorString();
+        }
+        return {};
+    }
+
+    return book;
+}
 
-            if (recipeId < 0) {
-                qWarning() << "Failed to add recipe:" << recipe.outputItem;
-                continue;
-            }
+bool RecipeImporter::importWorkbenches(const QVector<WorkbenchRecipes> &book)
+{
+    FRONTIER_TRACE_SCOPE("RecipeImporter::importWorkbenches");
+    m_workbenchesImported = 0;
+    m_recipesImported = 0;
+    m_lastError.clear();
+
+    if (!m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
 
-            // Add ingredients
-            QJsonArray inputsArray = recipeObj["inputs"].toArray();
-            for (const QJsonValue &inputVal : inputsArray) {
-                QJsonObject inputObj = inputVal.toObject();
+    m_database->clearAllWorkbenches();
 
-                Frontier::RecipeIngredient ingredient;
-                ingredient.recipeId = recipeId;
-                ingredient.itemName = inputObj["item"].toString();
-                ingredient.quantity = inputObj["qty"].toInt(1);
+    QVector<Frontier::Recipe> recipes;
+    for (const auto &entry : book) {
+        Frontier::Workbench workbench;
+        workbench.name = entry.workbench;
+        int workbenchId = m_database->addWorkbench(workbench);
 
-                m_database->addRecipeIngredient(ingredient);
-            }
+        if (workbenchId < 0) {
+            qWarning() << "Failed to add workbench:" << entry.workbench;
+            continue;
+        }
 
-            m_recipesImported++;
+        m_workbenchesImported++;
+        for (Frontier::Recipe recipe : entry.recipes) {
+            recipe.workbenchId = workbenchId;
+            recipes.append(recipe);
         }
     }
 
-    qDebug() << "Recipe import complete:"
-             << m_workbenchesImported << "workbenches,"
-             << m_recipesImported << "recipes";
+    int added = m_database->addRecipes(recipes);
+    if (added < 0 || !m_database->commitTransaction()) {
+        m_lastError = QString("Failed to write recipes: %1").arg(m_database->lastError());
+        m_database->rollbackTransaction();
+        m_workbenchesImported = 0;
+        return false;
+    }
 
+    m_recipesImported = added;
     return true;
 }
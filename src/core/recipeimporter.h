@@ -7,11 +7,20 @@
 #define RECIPEIMPORTER_H
 
 #include <QString>
+#include <QVector>
+
+#include "types.h"
 
 namespace Frontier {
 class Database;
 }
 
+// One workbench and its recipes as read from the file
+struct WorkbenchRecipes {
+    QString workbench;
+    QVector<Frontier::Recipe> recipes;   // workbenchId is assigned on import
+};
+
 class RecipeImporter
 {
 public:
@@ -19,6 +28,12 @@ public:
 
     bool importFromJson(const QString &filePath);
 
+    // Reads the file without touching the database; safe on any thread
+    static QVector<WorkbenchRecipes> loadFromJson(const QString &filePath, QString *error = nullptr);
+
+    // Replaces the recipe book with already loaded workbenches
+    bool importWorkbenches(const QVector<WorkbenchRecipes> &book);
+
     int workbenchesImported() const { return m_workbenchesImported; }
     int recipesImported() const { return m_recipesImported; }
     QString lastError() const { return m_lastError; }
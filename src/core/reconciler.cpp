@@ -0,0 +1,313 @@
+/**
+ * @file reconciler.cpp
+ * @brief Save/ledger reconciliation implementation
+ */
+
+#include "reconciler.h"
+#include "itemcatalog.h"
+
+#include <QHash>
+#include <limits>
+
+namespace Frontier {
+
+namespace {
+
+constexpr qint64 NoBucket = std::numeric_limits<qint64>::min();
+constexpr qint64 AnyAmount = std::numeric_limits<qint64>::min();
+
+struct Key {
+    QString item;
+    QString category;                // Empty when the pass ignores category
+    qint64 amount = AnyAmount;
+    qint64 bucket = NoBucket;
+
+    bool operator==(const Key &other) const {
+        return amount == other.amount && bucket == other.bucket
+               && item == other.item && category == other.category;
+    }
+};
+
+size_t qHash(const Key &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.item, key.category, key.amount, key.bucket);
+}
+
+struct Entry {
+    QString item;
+    QString category;
+    qint64 amount = 0;
+    qint64 bucket = NoBucket;        // NoBucket when the entry has no time
+};
+
+enum class Pass { Exact, IgnoreCategory, AnyAmount };
+
+Key keyFor(const Entry &entry, Pass pass, qint64 bucket)
+{
+    Key key;
+    key.item = entry.item;
+    key.bucket = bucket;
+    if (pass == Pass::Exact) {
+        key.category = entry.category;
+    }
+    if (pass != Pass::AnyAmount) {
+        key.amount = entry.amount;
+    }
+    return key;
+}
+
+/**
+ * @brief Unused ledger rows by key, consumed as save entries claim them
+ *
+ * A row claimed in one pass stays listed in the other passes' tables and
+ * is skipped there when reached, which keeps each pass linear.
+ */
+class LedgerIndex
+{
+public:
+    LedgerIndex(const QVector<Entry> &ledger, const QVector<int> &rows,
+                QVector<bool> &used, Pass pass)
+        : m_used(used)
+    {
+        m_rows.reserve(rows.size() * 2);
+        for (int i : rows) {
+            const Entry &entry = ledger[i];
+            m_rows[keyFor(entry, pass, entry.bucket)].append(i);
+            // Lets save entries without a timestamp match on item alone
+            m_rows[keyFor(entry, pass, NoBucket)].append(i);
+        }
+    }
+
+    // Claims an unused row in the entry's bucket or a neighbouring one
+    int claim(const Entry &entry, Pass pass)
+    {
+        if (entry.bucket == NoBucket) {
+            return take(keyFor(entry, pass, NoBucket));
+        }
+        for (qint64 delta : {0, -1, 1}) {
+            int row = take(keyFor(entry, pass, entry.bucket + delta));
+            if (row >= 0) {
+                return row;
+            }
+        }
+        return -1;
+    }
+
+private:
+    int take(const Key &key)
+    {
+        auto it = m_rows.find(key);
+        if (it == m_rows.end()) {
+            return -1;
+        }
+        QVector<int> &rows = it.value();
+        while (!rows.isEmpty()) {
+            int row = rows.takeLast();
+            if (!m_used[row]) {
+                m_used[row] = true;
+                return row;
+            }
+        }
+        return -1;
+    }
+
+    QHash<Key, QVector<int>> m_rows;
+    QVector<bool> &m_used;
+};
+
+} // namespace
+
+// =============================================================================
+// Report
+// =============================================================================
+
+int ReconcileReport::count(ReconcileIssue::Kind kind) const
+{
+    int n = 0;
+    for (const auto &issue : issues) {
+        if (issue.kind == kind) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+QString reconcileIssueKindToString(ReconcileIssue::Kind kind)
+{
+    switch (kind) {
+    case ReconcileIssue::Kind::MissingFromLedger: return "Missing from ledger";
+    case ReconcileIssue::Kind::MissingFromSave: return "Missing from save";
+    case ReconcileIssue::Kind::Duplicate: return "Duplicate";
+    case ReconcileIssue::Kind::AmountMismatch: return "Amount mismatch";
+    }
+    return "Unknown";
+}
+
+// =============================================================================
+// Reconciler
+// =============================================================================
+
+Reconciler::Reconciler(const ItemCatalog &catalog)
+    : m_catalog(catalog)
+{
+}
+
+qint64 Reconciler::ledgerAmount(const Transaction &trans)
+{
+    qint64 amount = qRound64(qAbs(trans.totalAmount));
+    return trans.isIncome() ? amount : -amount;
+}
+
+ReconcileReport Reconciler::reconcile(const QVector<SaveTransaction> &save,
+                                      const QVector<Transaction> &ledger,
+                                      const ReconcileOptions &options) const
+{
+    ReconcileReport report;
+    const int bucketDays = qMax(1, options.bucketDays);
+
+    // === Normalize both sides ===
+    QVector<Entry> saveEntries;
+    saveEntries.reserve(save.size());
+    for (const auto &tx : save) {
+        Entry entry;
+        entry.item = tx.itemCode;
+        entry.category = tx.category.toLower();
+        entry.amount = tx.amount;
+        if (tx.time.isValid()) {
+            entry.bucket = tx.time.toLocalTime().date().toJulianDay() / bucketDays;
+        }
+        saveEntries.append(entry);
+    }
+
+    QVector<Entry> ledgerEntries(ledger.size());
+    QVector<int> ledgerRows;
+    ledgerRows.reserve(ledger.size());
+    for (int i = 0; i < ledger.size(); ++i) {
+        const Transaction &trans = ledger[i];
+        if (trans.type == TransactionType::Opening || trans.type == TransactionType::Transfer) {
+            continue;
+        }
+
+        Entry &entry = ledgerEntries[i];
+        const Item *item = m_catalog.findByName(trans.item);
+        entry.item = item ? item->code : trans.item;
+        entry.category = trans.category.toLower();
+        entry.amount = ledgerAmount(trans);
+        entry.bucket = trans.date.toJulianDay() / bucketDays;
+        ledgerRows.append(i);
+    }
+
+    // === Pair in passes of decreasing strictness ===
+    QVector<bool> ledgerUsed(ledger.size(), false);
+    QVector<int> pairedWith(save.size(), -1);
+
+    LedgerIndex exact(ledgerEntries, ledgerRows, ledgerUsed, Pass::Exact);
+    LedgerIndex ignoreCategory(ledgerEntries, ledgerRows, ledgerUsed, Pass::IgnoreCategory);
+    LedgerIndex anyAmount(ledgerEntries, ledgerRows, ledgerUsed, Pass::AnyAmount);
+
+    for (int s = 0; s < saveEntries.size(); ++s) {
+        pairedWith[s] = exact.claim(saveEntries[s], Pass::Exact);
+        if (pairedWith[s] >= 0) {
+            ++report.matched;
+        }
+    }
+
+    for (int s = 0; s < saveEntries.size(); ++s) {
+        if (pairedWith[s] < 0) {
+            pairedWith[s] = ignoreCategory.claim(saveEntries[s], Pass::IgnoreCategory);
+            if (pairedWith[s] >= 0) {
+                ++report.matched;
+                ++report.matchedIgnoringCategory;
+            }
+        }
+    }
+
+    // === Classify what is left ===
+    // A leftover that is not the first occurrence of its exact key on its
+    // own side is an extra copy rather than a missing entry
+    QHash<Key, int> saveSeen;
+    for (int s = 0; s < saveEntries.size(); ++s) {
+        const Entry &entry = saveEntries[s];
+        const bool repeat = saveSeen[keyFor(entry, Pass::Exact, entry.bucket)]++ > 0;
+        if (pairedWith[s] >= 0) {
+            continue;
+        }
+
+        ReconcileIssue issue;
+        issue.saveIndex = s;
+        if (repeat) {
+            issue.kind = ReconcileIssue::Kind::Duplicate;
+        } else {
+            issue.ledgerIndex = anyAmount.claim(entry, Pass::AnyAmount);
+            issue.kind = issue.ledgerIndex >= 0 ? ReconcileIssue::Kind::AmountMismatch
+                                                : ReconcileIssue::Kind::MissingFromLedger;
+        }
+        report.issues.append(issue);
+    }
+
+    if (options.reportUnmatchedLedger) {
+        QHash<Key, int> ledgerSeen;
+        for (int i : ledgerRows) {
+            const Entry &entry = ledgerEntries[i];
+            const bool repeat = ledgerSeen[keyFor(entry, Pass::Exact, entry.bucket)]++ > 0;
+            if (ledgerUsed[i]) {
+                continue;
+            }
+
+            ReconcileIssue issue;
+            issue.ledgerIndex = i;
+            issue.kind = repeat ? ReconcileIssue::Kind::Duplicate
+                                : ReconcileIssue::Kind::MissingFromSave;
+            report.issues.append(issue);
+        }
+    }
+
+    return report;
+}
+
+// =============================================================================
+// Ingestion
+// =============================================================================
+
+QVector<Transaction> Reconciler::missingAsLedger(const ReconcileReport &report,
+                                                 const QVector<SaveTransaction> &save,
+                                                 AccountType account,
+                                                 int *skipped) const
+{
+    QVector<Transaction> rows;
+    int noTime = 0;
+    for (const auto &issue : report.issues) {
+        if (issue.kind != ReconcileIssue::Kind::MissingFromLedger || issue.saveIndex < 0) {
+            continue;
+        }
+        const SaveTransaction &tx = save[issue.saveIndex];
+        if (!tx.time.isValid()) {
+            ++noTime;
+            continue;
+        }
+
+        // Named so reconcile() maps the row back to the same code: the
+        // catalog name when the code is known, the code itself otherwise
+        const Item *item = m_catalog.findByCode(tx.itemCode);
+
+        Transaction trans;
+        trans.date = tx.time.toLocalTime().date();
+        trans.type = tx.isSale() ? TransactionType::Sale : TransactionType::Purchase;
+        trans.account = account;
+        trans.item = item ? item->name : tx.itemCode;
+        trans.category = tx.category;
+        trans.quantity = 1;
+        trans.unitPrice = qAbs(qint64(tx.amount));
+        trans.totalAmount = trans.unitPrice;
+        trans.notes = item ? QStringLiteral("Imported from save")
+                           : QStringLiteral("Imported from save (unknown item code)");
+        rows.append(trans);
+    }
+
+    if (skipped) {
+        *skipped = noTime;
+    }
+    return rows;
+}
+
+} // namespace Frontier
@@ -0,0 +1,87 @@
+/**
+ * @file reconciler.h
+ * @brief Matches save-file transaction history against ledger rows
+ */
+
+#ifndef RECONCILER_H
+#define RECONCILER_H
+
+#include <QString>
+#include <QVector>
+
+#include "types.h"
+#include "saveparser.h"
+
+namespace Frontier {
+
+class ItemCatalog;
+
+/**
+ * @brief One entry that could not be paired cleanly
+ */
+struct ReconcileIssue {
+    enum class Kind {
+        MissingFromLedger,           // Save entry with no ledger row
+        MissingFromSave,             // Ledger row with no save entry
+        Duplicate,                   // Extra copy of an entry already seen on the same side
+        AmountMismatch               // Same item and time bucket, different amount
+    };
+
+    Kind kind = Kind::MissingFromLedger;
+    int saveIndex = -1;              // Index into the save transactions, or -1
+    int ledgerIndex = -1;            // Index into the ledger rows, or -1
+};
+
+struct ReconcileReport {
+    int matched = 0;
+    int matchedIgnoringCategory = 0; // Included in matched
+    QVector<ReconcileIssue> issues;
+
+    int count(ReconcileIssue::Kind kind) const;
+};
+
+struct ReconcileOptions {
+    int bucketDays = 1;              // Width of a time bucket; neighbours also match
+    bool reportUnmatchedLedger = true;   // Off when checking a slice of the save
+};
+
+/**
+ * @brief Hash-based reconciliation of save history and ledger
+ *
+ * Both sides are reduced to (item code, category, signed amount, time
+ * bucket) keys and paired through hash lookups in a few linear passes:
+ * exact keys first, then keys ignoring category, then same item and
+ * bucket with a different amount. Whatever is left over is reported as
+ * missing, or as a duplicate when its exact key occurs more than once on
+ * its own side. Ledger items are mapped to codes through the catalog;
+ * Opening and Transfer rows never appear in a save and are ignored.
+ */
+class Reconciler
+{
+public:
+    explicit Reconciler(const ItemCatalog &catalog);
+
+    ReconcileReport reconcile(const QVector<SaveTransaction> &save,
+                              const QVector<Transaction> &ledger,
+                              const ReconcileOptions &options = ReconcileOptions()) const;
+
+    // Signed whole-currency amount as the save records it
+    static qint64 ledgerAmount(const Transaction &trans);
+
+    // Ledger rows for the report's MissingFromLedger entries, ready to insert.
+    // Items are named through the catalog; entries with no time are left out
+    // (they have no date to book) and counted in skipped, if given.
+    QVector<Transaction> missingAsLedger(const ReconcileReport &report,
+                                         const QVector<SaveTransaction> &save,
+                                         AccountType account,
+                                         int *skipped = nullptr) const;
+
+private:
+    const ItemCatalog &m_catalog;
+};
+
+QString reconcileIssueKindToString(ReconcileIssue::Kind kind);
+
+} // namespace Frontier
+
+#endif // RECONCILER_H
@@ -0,0 +1,376 @@
+/**
+ * @file referencesnapshot.cpp
+ * @brief Reference snapshot file format, writer and views
+ */
+
+#include "referencesnapshot.h"
+#include "profiler.h"
+
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Frontier {
+
+namespace {
+
+constexpr char Magic[8] = {'F', 'M', 'T', 'R', 'E', 'F', 'S', '\0'};
+constexpr quint32 ByteOrderMark = 0x01020304;
+constexpr int Sha1Size = 20;
+
+QByteArray sha1(const char *data, qint64 size)
+{
+    return QCryptographicHash::hash(QByteArrayView(data, size), QCryptographicHash::Sha1);
+}
+
+} // namespace
+
+// =============================================================================
+// File layout
+// =============================================================================
+// [Header][ItemRecord x itemCount][quint32 byName x itemCount]
+// [quint32 byCode x itemCount][char16_t strings x stringsLength]
+
+struct ReferenceSnapshot::StringRef {
+    quint32 offset;                      // In UTF-16 units from the pool start
+    quint32 length;
+};
+
+struct ReferenceSnapshot::ItemRecord {
+    qint32 id;
+    quint32 pricingGroup;
+    StringRef code;
+    StringRef name;
+    StringRef category;
+    StringRef notes;
+    double buyPrice;
+    double sellPriceInternal;
+    double sellPriceDisplay;
+    double weight;
+};
+
+struct ReferenceSnapshot::Header {
+    char magic[8];
+    quint32 byteOrder;
+    quint32 version;
+    quint32 fileSize;
+    quint32 itemCount;
+    qint32 maxItemId;
+    quint32 itemsOffset;
+    quint32 byNameOffset;
+    quint32 byCodeOffset;
+    quint32 stringsOffset;
+    quint32 stringsLength;
+    char payloadChecksum[Sha1Size];      // SHA-1 of everything after the header
+    char sourceChecksum[Sha1Size];       // All zero when there was no source file
+    qint64 createdMsecs;
+};
+
+// =============================================================================
+// Open
+// =============================================================================
+
+ReferenceSnapshot::~ReferenceSnapshot()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+    }
+}
+
+std::unique_ptr<ReferenceSnapshot> ReferenceSnapshot::open(const QString &path, QString *error)
+{
+    ProfileScope scope("ReferenceSnapshot::open");
+    std::unique_ptr<ReferenceSnapshot> snapshot(new ReferenceSnapshot);
+    snapshot->m_file.setFileName(path);
+
+    if (!snapshot->m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("Could not open snapshot: %1").arg(snapshot->m_file.errorString());
+        return nullptr;
+    }
+
+    snapshot->m_size = snapshot->m_file.size();
+    snapshot->m_mapped = snapshot->m_size > 0 ? snapshot->m_file.map(0, snapshot->m_size) : nullptr;
+    if (snapshot->m_mapped) {
+        snapshot->m_data = reinterpret_cast<const char *>(snapshot->m_mapped);
+    } else {
+        // Mapping can fail on some filesystems; fall back to one read
+        snapshot->m_buffer = snapshot->m_file.readAll();
+        snapshot->m_data = snapshot->m_buffer.constData();
+        snapshot->m_size = snapshot->m_buffer.size();
+    }
+
+    if (!snapshot->attach(error)) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+bool ReferenceSnapshot::attach(QString *error)
+{
+    static_assert(sizeof(StringRef) == 8, "snapshot layout changed");
+    static_assert(sizeof(ItemRecord) == 72, "snapshot layout changed");
+    static_assert(sizeof(Header) == 96, "snapshot layout changed");
+
+    auto fail = [error](const QString &what) {
+        if (error) *error = QString("Invalid snapshot: %1").arg(what);
+        return false;
+    };
+
+    if (m_size < qint64(sizeof(Header))) {
+        return fail("file too small");
+    }
+    const Header &h = header();
+    if (std::memcmp(h.magic, Magic, sizeof(Magic)) != 0) {
+        return fail("not a snapshot file");
+    }
+    if (h.byteOrder != ByteOrderMark) {
+        return fail("written on a platform with another byte order");
+    }
+    if (h.version != FormatVersion) {
+        return fail(QString("format version %1, expected %2").arg(h.version).arg(FormatVersion));
+    }
+    if (h.fileSize != m_size) {
+        return fail("truncated");
+    }
+
+    // Sections must lie inside the file before anything reads them
+    const quint64 n = h.itemCount;
+    if (h.itemsOffset != sizeof(Header)
+        || h.byNameOffset != h.itemsOffset + n * sizeof(ItemRecord)
+        || h.byCodeOffset != h.byNameOffset + n * sizeof(quint32)
+        || h.stringsOffset != h.byCodeOffset + n * sizeof(quint32)
+        || quint64(h.stringsOffset) + quint64(h.stringsLength) * sizeof(char16_t) != quint64(m_size)) {
+        return fail("bad section offsets");
+    }
+
+    if (sha1(m_data + sizeof(Header), m_size - qint64(sizeof(Header)))
+        != QByteArray::fromRawData(h.payloadChecksum, Sha1Size)) {
+        return fail("checksum mismatch");
+    }
+
+    // The checksum proves the bytes are what the writer produced; bounds are
+    // still checked once here so the views never need to
+    auto inPool = [&h](const StringRef &ref) {
+        return quint64(ref.offset) + ref.length <= h.stringsLength;
+    };
+    const auto *byName = reinterpret_cast<const quint32 *>(m_data + h.byNameOffset);
+    const auto *byCode = reinterpret_cast<const quint32 *>(m_data + h.byCodeOffset);
+    for (quint32 i = 0; i < h.itemCount; ++i) {
+        const ItemRecord &r = record(int(i));
+        if (!inPool(r.code) || !inPool(r.name) || !inPool(r.category) || !inPool(r.notes)
+            || byName[i] >= h.itemCount || byCode[i] >= h.itemCount) {
+            return fail("record out of range");
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Write
+// =============================================================================
+
+bool ReferenceSnapshot::write(const QString &path, const QVector<Item> &items,
+                              const QByteArray &sourceChecksum, QString *error)
+{
+    ProfileScope scope("ReferenceSnapshot::write");
+
+    QString pool;
+    auto intern = [&pool](const QString &s) {
+        StringRef ref{quint32(pool.size()), quint32(s.size())};
+        pool.append(s);
+        return ref;
+    };
+
+    const quint32 n = quint32(items.size());
+    QVector<ItemRecord> records;
+    records.reserve(items.size());
+    qint32 maxId = 0;
+    for (const Item &item : items) {
+        ItemRecord r;
+        r.id = item.id.value_or(0);
+        r.pricingGroup = quint32(item.pricingGroup);
+        r.code = intern(item.code);
+        r.name = intern(item.name);
+        r.category = intern(item.categoryMain);
+        r.notes = intern(item.notes);
+        r.buyPrice = item.buyPriceInternal;
+        r.sellPriceInternal = item.sellPriceInternal;
+        r.sellPriceDisplay = item.sellPriceDisplay;
+        r.weight = item.weight;
+        records.append(r);
+        maxId = qMax(maxId, r.id);
+    }
+
+    // Stable, so equal names keep catalog order and lookups find the first
+    auto sortedBy = [&items](QString Item::*field) {
+        QVector<quint32> rows(items.size());
+        for (int i = 0; i < rows.size(); ++i) {
+            rows[i] = quint32(i);
+        }
+        std::stable_sort(rows.begin(), rows.end(), [&items, field](quint32 a, quint32 b) {
+            return QStringView(items[a].*field).compare(QStringView(items[b].*field)) < 0;
+        });
+        return rows;
+    };
+    const QVector<quint32> byName = sortedBy(&Item::name);
+    const QVector<quint32> byCode = sortedBy(&Item::code);
+
+    Header h{};
+    std::memcpy(h.magic, Magic, sizeof(Magic));
+    h.byteOrder = ByteOrderMark;
+    h.version = FormatVersion;
+    h.itemCount = n;
+    h.maxItemId = maxId;
+    h.itemsOffset = sizeof(Header);
+    h.byNameOffset = h.itemsOffset + n * sizeof(ItemRecord);
+    h.byCodeOffset = h.byNameOffset + n * sizeof(quint32);
+    h.stringsOffset = h.byCodeOffset + n * sizeof(quint32);
+    h.stringsLength = quint32(pool.size());
+    h.fileSize = h.stringsOffset + h.stringsLength * sizeof(char16_t);
+    h.createdMsecs = QDateTime::currentMSecsSinceEpoch();
+    if (sourceChecksum.size() == Sha1Size) {
+        std::memcpy(h.sourceChecksum, sourceChecksum.constData(), Sha1Size);
+    }
+
+    QByteArray bytes(qsizetype(h.fileSize), Qt::Uninitialized);
+    char *out = bytes.data();
+    std::memcpy(out + h.itemsOffset, records.constData(), n * sizeof(ItemRecord));
+    std::memcpy(out + h.byNameOffset, byName.constData(), n * sizeof(quint32));
+    std::memcpy(out + h.byCodeOffset, byCode.constData(), n * sizeof(quint32));
+    std::memcpy(out + h.stringsOffset, pool.constData(), h.stringsLength * sizeof(char16_t));
+
+    const QByteArray checksum = sha1(out + sizeof(Header), bytes.size() - qsizetype(sizeof(Header)));
+    std::memcpy(h.payloadChecksum, checksum.constData(), Sha1Size);
+    std::memcpy(out, &h, sizeof(Header));
+
+    // Readers see the old file or the new one, never half of either
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        if (error) *error = QString("Could not write snapshot: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QByteArray ReferenceSnapshot::checksumFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+// =============================================================================
+// Accessors
+// =============================================================================
+
+const ReferenceSnapshot::Header &ReferenceSnapshot::header() const
+{
+    return *reinterpret_cast<const Header *>(m_data);
+}
+
+const ReferenceSnapshot::ItemRecord &ReferenceSnapshot::record(int row) const
+{
+    return reinterpret_cast<const ItemRecord *>(m_data + header().itemsOffset)[row];
+}
+
+QStringView ReferenceSnapshot::string(const StringRef &ref) const
+{
+    const auto *pool = reinterpret_cast<const char16_t *>(m_data + header().stringsOffset);
+    return QStringView(pool + ref.offset, qsizetype(ref.length));
+}
+
+int ReferenceSnapshot::itemCount() const { return int(header().itemCount); }
+int ReferenceSnapshot::maxItemId() const { return header().maxItemId; }
+
+QByteArray ReferenceSnapshot::sourceChecksum() const
+{
+    const QByteArray checksum(header().sourceChecksum, Sha1Size);
+    return checksum.count('\0') == Sha1Size ? QByteArray() : checksum;
+}
+
+QDateTime ReferenceSnapshot::createdAt() const
+{
+    return QDateTime::fromMSecsSinceEpoch(header().createdMsecs);
+}
+
+std::optional<ReferenceSnapshot::ItemView> ReferenceSnapshot::findByName(QStringView name) const
+{
+    return search(header().byNameOffset, name, &ItemView::name);
+}
+
+std::optional<ReferenceSnapshot::ItemView> ReferenceSnapshot::findByCode(QStringView code) const
+{
+    return search(header().byCodeOffset, code, &ItemView::code);
+}
+
+std::optional<ReferenceSnapshot::ItemView> ReferenceSnapshot::search(
+    quint32 indexOffset, QStringView key, QStringView (ItemView::*field)() const) const
+{
+    const auto *begin = reinterpret_cast<const quint32 *>(m_data + indexOffset);
+    const auto *end = begin + itemCount();
+    const auto *it = std::lower_bound(begin, end, key, [this, field](quint32 row, QStringView k) {
+        return (item(int(row)).*field)().compare(k) < 0;
+    });
+    if (it == end || (item(int(*it)).*field)() != key) {
+        return std::nullopt;
+    }
+    return item(int(*it));
+}
+
+QVector<Item> ReferenceSnapshot::toItems() const
+{
+    ProfileScope scope("ReferenceSnapshot::toItems");
+    QVector<Item> items;
+    items.reserve(itemCount());
+    for (int i = 0; i < itemCount(); ++i) {
+        items.append(item(i).toItem());
+    }
+    return items;
+}
+
+// =============================================================================
+// ItemView
+// =============================================================================
+
+int ReferenceSnapshot::ItemView::id() const { return m_snapshot->record(m_row).id; }
+QStringView ReferenceSnapshot::ItemView::code() const { return m_snapshot->string(m_snapshot->record(m_row).code); }
+QStringView ReferenceSnapshot::ItemView::name() const { return m_snapshot->string(m_snapshot->record(m_row).name); }
+QStringView ReferenceSnapshot::ItemView::category() const { return m_snapshot->string(m_snapshot->record(m_row).category); }
+QStringView ReferenceSnapshot::ItemView::notes() const { return m_snapshot->string(m_snapshot->record(m_row).notes); }
+double ReferenceSnapshot::ItemView::buyPrice() const { return m_snapshot->record(m_row).buyPrice; }
+double ReferenceSnapshot::ItemView::sellPriceInternal() const { return m_snapshot->record(m_row).sellPriceInternal; }
+double ReferenceSnapshot::ItemView::sellPriceDisplay() const { return m_snapshot->record(m_row).sellPriceDisplay; }
+double ReferenceSnapshot::ItemView::weight() const { return m_snapshot->record(m_row).weight; }
+
+PricingGroup ReferenceSnapshot::ItemView::pricingGroup() const
+{
+    return static_cast<PricingGroup>(m_snapshot->record(m_row).pricingGroup);
+}
+
+Item ReferenceSnapshot::ItemView::toItem() const
+{
+    const ItemRecord &r = m_snapshot->record(m_row);
+    Item item;
+    item.id = r.id;
+    item.code = code().toString();
+    item.name = name().toString();
+    item.categoryMain = category().toString();
+    item.buyPriceInternal = r.buyPrice;
+    item.buyPriceDisplay = std::round(r.buyPrice);
+    item.sellPriceInternal = r.sellPriceInternal;
+    item.sellPriceDisplay = r.sellPriceDisplay;
+    item.weight = r.weight;
+    item.pricingGroup = static_cast<PricingGroup>(r.pricingGroup);
+    item.notes = notes().toString();
+    return item;
+}
+
+} // namespace Frontier
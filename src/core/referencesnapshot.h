@@ -0,0 +1,124 @@
+/**
+ * @file referencesnapshot.h
+ * @brief Memory-mapped binary copy of the item catalog for fast startup
+ */
+
+#ifndef REFERENCESNAPSHOT_H
+#define REFERENCESNAPSHOT_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QVector>
+#include <memory>
+#include <optional>
+
+#include "types.h"
+
+namespace Frontier {
+
+/**
+ * @brief Read-only view of the items table written after each import
+ *
+ * The file holds fixed-size item records, two row indexes sorted by name
+ * and by code, and one UTF-16 string pool the records point into. Opening
+ * it maps the file and checks the header and payload checksum; nothing is
+ * parsed or copied, so lookups through the views cost the same for ten
+ * items as for ten thousand. Values are stored in native byte order and a
+ * file from another platform simply fails to open.
+ *
+ * The header also records the SHA-1 of the items JSON the data came from,
+ * so an import can tell an unchanged source file apart from a new one.
+ *
+ * Database owns the open snapshot (see Database::referenceSnapshot()) and
+ * deletes the file whenever the items table is written; views and string
+ * views stay valid only until then.
+ */
+class ReferenceSnapshot
+{
+public:
+    static constexpr quint32 FormatVersion = 1;
+
+    ~ReferenceSnapshot();
+
+    ReferenceSnapshot(const ReferenceSnapshot &) = delete;
+    ReferenceSnapshot &operator=(const ReferenceSnapshot &) = delete;
+
+    /**
+     * @brief One item record; string accessors point into the mapped file
+     */
+    class ItemView
+    {
+    public:
+        int id() const;
+        QStringView code() const;
+        QStringView name() const;
+        QStringView category() const;    // As stored: displayCategory()
+        QStringView notes() const;
+        double buyPrice() const;
+        double sellPriceInternal() const;
+        double sellPriceDisplay() const;
+        double weight() const;
+        PricingGroup pricingGroup() const;
+
+        // Same fields Database::getAllItems() fills
+        Item toItem() const;
+
+    private:
+        friend class ReferenceSnapshot;
+        ItemView(const ReferenceSnapshot *snapshot, int row) : m_snapshot(snapshot), m_row(row) {}
+
+        const ReferenceSnapshot *m_snapshot;
+        int m_row;
+    };
+
+    // Null with *error set when the file is missing, damaged or from
+    // another format version
+    static std::unique_ptr<ReferenceSnapshot> open(const QString &path, QString *error = nullptr);
+
+    // Writes items in the order given (callers pass getAllItems() order)
+    static bool write(const QString &path, const QVector<Item> &items,
+                      const QByteArray &sourceChecksum, QString *error = nullptr);
+
+    // SHA-1 of a source file's bytes; empty if it cannot be read
+    static QByteArray checksumFile(const QString &path);
+
+    int itemCount() const;
+    int maxItemId() const;               // 0 when empty
+    QByteArray sourceChecksum() const;   // Empty when written without a source file
+    QDateTime createdAt() const;
+    qint64 fileSize() const { return m_size; }
+
+    ItemView item(int row) const { return ItemView(this, row); }
+    // Binary search; duplicate names resolve to the first row, as in ItemCatalog
+    std::optional<ItemView> findByName(QStringView name) const;
+    std::optional<ItemView> findByCode(QStringView code) const;
+
+    QVector<Item> toItems() const;
+
+private:
+    struct Header;
+    struct StringRef;
+    struct ItemRecord;
+
+    ReferenceSnapshot() = default;
+
+    bool attach(QString *error);
+    const Header &header() const;
+    const ItemRecord &record(int row) const;
+    QStringView string(const StringRef &ref) const;
+    std::optional<ItemView> search(quint32 indexOffset, QStringView key,
+                                   QStringView (ItemView::*field)() const) const;
+
+    QFile m_file;
+    uchar *m_mapped = nullptr;
+    QByteArray m_buffer;                 // Used when the file cannot be mapped
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+};
+
+} // namespace Frontier
+
+#endif // REFERENCESNAPSHOT_H
@@ -0,0 +1,188 @@
+/**
+ * @file referencewatcher.cpp
+ * @brief Reference file watcher implementation
+ */
+
+#include "referencewatcher.h"
+
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+
+namespace Frontier {
+
+ReferenceWatcher::ReferenceWatcher(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_settleTimer(new QTimer(this))
+{
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SettleMs);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ReferenceWatcher::onPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ReferenceWatcher::onPathChanged);
+    connect(m_settleTimer, &QTimer::timeout, this, &ReferenceWatcher::onSettled);
+}
+
+void ReferenceWatcher::setSources(const ReferenceSources &sources)
+{
+    m_sources = sources;
+    m_seen.clear();
+    for (const QString &file : watchedFiles()) {
+        m_seen.insert(file, stateOf(file));
+    }
+    rewatch();
+}
+
+void ReferenceWatcher::mergeSources(const ReferenceSources &sources)
+{
+    ReferenceSources merged = m_sources;
+    merged.merge(sources);
+    setSources(merged);
+}
+
+void ReferenceWatcher::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    if (!m_enabled) {
+        m_settleTimer->stop();
+        rewatch();
+        return;
+    }
+    // Edits made while disabled are not replayed
+    setSources(m_sources);
+}
+
+QStringList ReferenceWatcher::watchedFiles() const
+{
+    QStringList files;
+    for (const QString &file : {m_sources.itemsJson, m_sources.vehiclesJson,
+                                m_sources.recipesJson, m_sources.buildingsJson}) {
+        if (!file.isEmpty()) {
+            files.append(QFileInfo(file).absoluteFilePath());
+        }
+    }
+    files += locationFiles(m_sources.locationsDir);
+    return files;
+}
+
+QStringList ReferenceWatcher::locationFiles(const QString &dir)
+{
+    if (dir.isEmpty()) {
+        return {};
+    }
+    const QDir locations(dir);
+    return {locations.absoluteFilePath("maps.json"),
+            locations.absoluteFilePath("location_types.json"),
+            locations.absoluteFilePath("locations.json")};
+}
+
+ReferenceWatcher::FileState ReferenceWatcher::stateOf(const QString &path)
+{
+    FileState state;
+    const QFileInfo info(path);
+    if (info.exists()) {
+        state.modified = info.lastModified();
+        state.size = info.size();
+    }
+    return state;
+}
+
+void ReferenceWatcher::rewatch()
+{
+    const QStringList watched = m_watcher->directories() + m_watcher->files();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+    if (!m_enabled) {
+        return;
+    }
+
+    QStringList paths;
+    QSet<QString> dirs;
+    for (const QString &file : watchedFiles()) {
+        if (QFileInfo::exists(file)) {
+            paths.append(file);
+        }
+        const QString dir = QFileInfo(file).absolutePath();
+        if (!dirs.contains(dir) && QFileInfo(dir).isDir()) {
+            dirs.insert(dir);
+            paths.append(dir);
+        }
+    }
+    if (!paths.isEmpty()) {
+        m_watcher->addPaths(paths);
+    }
+}
+
+// =============================================================================
+// Change Handling
+// =============================================================================
+
+void ReferenceWatcher::onPathChanged()
+{
+    if (m_enabled) {
+        m_settleTimer->start();          // Restart: wait for writes to stop
+    }
+}
+
+bool ReferenceWatcher::takeChange(const QStringList &files)
+{
+    bool changed = false;
+    for (const QString &file : files) {
+        const FileState state = stateOf(file);
+        if (state != m_seen.value(file)) {
+            m_seen.insert(file, state);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void ReferenceWatcher::onSettled()
+{
+    // A replaced file drops out of the watch list; add it back
+    rewatch();
+
+    ReferenceSources changedSources;
+    auto file = [](const QString &path) {
+        return path.isEmpty() ? QStringList() : QStringList{QFileInfo(path).absoluteFilePath()};
+    };
+
+    // A deleted file is noted but not imported: nothing would be read
+    if (takeChange(file(m_sources.itemsJson)) && QFileInfo::exists(m_sources.itemsJson)) {
+        changedSources.itemsJson = m_sources.itemsJson;
+        changedSources.syncItems = true;
+    }
+    if (takeChange(file(m_sources.vehiclesJson)) && QFileInfo::exists(m_sources.vehiclesJson)) {
+        changedSources.vehiclesJson = m_sources.vehiclesJson;
+        changedSources.replaceVehicles = false;
+    }
+    if (takeChange(file(m_sources.recipesJson)) && QFileInfo::exists(m_sources.recipesJson)) {
+        changedSources.recipesJson = m_sources.recipesJson;
+    }
+    if (takeChange(file(m_sources.buildingsJson)) && QFileInfo::exists(m_sources.buildingsJson)) {
+        changedSources.buildingsJson = m_sources.buildingsJson;
+    }
+    const QStringList locations = locationFiles(m_sources.locationsDir);
+    if (takeChange(locations)) {
+        bool complete = true;
+        for (const QString &path : locations) {
+            complete = complete && QFileInfo::exists(path);
+        }
+        if (complete) {
+            changedSources.locationsDir = m_sources.locationsDir;
+        }
+    }
+
+    if (!changedSources.isEmpty()) {
+        emit changed(changedSources);
+    }
+}
+
+} // namespace Frontier
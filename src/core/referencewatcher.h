@@ -0,0 +1,88 @@
+/**
+ * @file referencewatcher.h
+ * @brief Watches the reference JSON files and reports which data sets changed
+ */
+
+#ifndef REFERENCEWATCHER_H
+#define REFERENCEWATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QHash>
+
+#include "importpipeline.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace Frontier {
+
+/**
+ * @brief Turns edits of the reference files into differential imports
+ *
+ * Watches every file named by the sources, and their folders, since most
+ * editors save by replacing the file. Change notifications are debounced;
+ * once they settle each file's size and modification time are compared
+ * with what was last seen, and changed() names only the data sets whose
+ * files actually differ. The sources it emits are set up for a background
+ * refresh: items sync differentially, vehicles and buildings upsert, and
+ * locations sync, so ids that the ledger and inventory refer to survive.
+ * The recipe book is always replaced as a whole.
+ */
+class ReferenceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReferenceWatcher(QObject *parent = nullptr);
+
+    // Files to watch; the current state of each is the baseline
+    void setSources(const ReferenceSources &sources);
+    ReferenceSources sources() const { return m_sources; }
+    // Adds the data sets a finished import used, keeping the others
+    void mergeSources(const ReferenceSources &sources);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    QStringList watchedFiles() const;
+
+signals:
+    void changed(const Frontier::ReferenceSources &changed);
+
+private slots:
+    void onPathChanged();
+    void onSettled();
+
+private:
+    struct FileState {
+        QDateTime modified;
+        qint64 size = -1;           // -1 while the file does not exist
+
+        bool operator==(const FileState &other) const {
+            return size == other.size && modified == other.modified;
+        }
+        bool operator!=(const FileState &other) const { return !(*this == other); }
+    };
+
+    static FileState stateOf(const QString &path);
+    static QStringList locationFiles(const QString &dir);
+    void rewatch();
+    // True when any of the files differs from the last state seen; takes the new state
+    bool takeChange(const QStringList &files);
+
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_settleTimer;
+
+    ReferenceSources m_sources;
+    bool m_enabled = false;
+    QHash<QString, FileState> m_seen;
+
+    static constexpr int SettleMs = 1500;
+};
+
+} // namespace Frontier
+
+#endif // REFERENCEWATCHER_H
@@ -0,0 +1,35 @@
+/**
+ * @file resultcache.cpp
+ * @brief Write-generation stamped result cache implementation
+ */
+
+#include "resultcache.h"
+
+namespace Frontier {
+
+ResultCache::ResultCache()
+    : m_entries(MaxRows)
+{
+}
+
+quint64 ResultCache::stamp(DataTables tables) const
+{
+    quint64 sum = 0;
+    for (int i = 0; i < TableCount; ++i) {
+        if ((tables.toInt() & (1 << i)) != 0) {
+            sum += m_generations[i].loadAcquire();
+        }
+    }
+    return sum;
+}
+
+void ResultCache::bump(DataTables tables)
+{
+    for (int i = 0; i < TableCount; ++i) {
+        if ((tables.toInt() & (1 << i)) != 0) {
+            m_generations[i].fetchAndAddRelease(1);
+        }
+    }
+}
+
+} // namespace Frontier
@@ -0,0 +1,97 @@
+/**
+ * @file resultcache.h
+ * @brief Recent read results, stamped with per-table write generations
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QAtomicInteger>
+#include <QCache>
+#include <QString>
+#include <any>
+#include <optional>
+
+#include "datachangebus.h"
+
+namespace Frontier {
+
+/**
+ * @brief Memoizes range query results until a table they read is written
+ *
+ * Every table has a write generation, bumped by Database::invalidateForWrite()
+ * as each write starts (on the writing thread, and again when a write made
+ * on another thread reaches the owner) and for every table after a
+ * rollback. An entry is stamped with the sum of the generations of the
+ * tables it was read from, taken before the query ran. Generations only
+ * grow, so the entry is current exactly while that sum is unchanged: a
+ * write costs one atomic add per table, and a lookup that finds its entry
+ * stale drops it.
+ *
+ * Entries are keyed by method and parameters and hold the result by
+ * value, so a hit hands out a shared copy of the implicitly shared vector.
+ * Up to MaxRows rows are kept in all, least recently used evicted first.
+ * Lookups and inserts belong to the Database's thread; callers on other
+ * threads query directly. bump() and stamp() are safe from any thread.
+ * Only the Database that initialize() opened memoizes: the worker's and
+ * read pool's copies (openExisting()) are never told of its writes, so
+ * they always query.
+ */
+class ResultCache
+{
+public:
+    static constexpr int MaxRows = 50000;
+
+    ResultCache();
+
+    // Sum of the write generations of tables; take it before the query
+    quint64 stamp(DataTables tables) const;
+    void bump(DataTables tables);
+
+    template <typename T>
+    std::optional<T> find(const QString &key, quint64 stamp);
+    // rows is the entry's cost against MaxRows
+    template <typename T>
+    void insert(const QString &key, quint64 stamp, const T &value, int rows);
+
+    void clear() { m_entries.clear(); }
+
+private:
+    // One generation per DataTable bit
+    static constexpr int TableCount = 15;
+    static_assert(int(DataTable::All) == (1 << TableCount) - 1, "a DataTable without a generation");
+
+    struct Entry {
+        quint64 stamp;
+        std::any value;
+    };
+
+    QAtomicInteger<quint32> m_generations[TableCount];
+    QCache<QString, Entry> m_entries;
+};
+
+template <typename T>
+std::optional<T> ResultCache::find(const QString &key, quint64 stamp)
+{
+    Entry *entry = m_entries.object(key);
+    if (!entry) {
+        return std::nullopt;
+    }
+    const T *value = std::any_cast<T>(&entry->value);
+    if (entry->stamp != stamp || !value) {
+        m_entries.remove(key);
+        return std::nullopt;
+    }
+    return *value;
+}
+
+template <typename T>
+void ResultCache::insert(const QString &key, quint64 stamp, const T &value, int rows)
+{
+    // An empty result still costs its entry
+    m_entries.insert(key, new Entry{stamp, value}, qMax(1, rows));
+}
+
+} // namespace Frontier
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,299 @@
+/**
+ * @file routematrix.cpp
+ * @brief Route matrix implementation
+ */
+
+#include "routematrix.h"
+#include "database.h"
+#include "profiler.h"
+
+#include <QMap>
+#include <algorithm>
+
+namespace Frontier {
+
+RouteMatrix::RouteMatrix(Database *database, QObject *parent)
+    : QObject(parent)
+    , m_database(database)
+{
+    connect(&m_database->changeBus(), &DataChangeBus::tablesChanged,
+            this, &RouteMatrix::onTablesChanged);
+    connect(&m_database->changeBus(), &DataChangeBus::rowsChanged,
+            this, &RouteMatrix::onRowsChanged);
+}
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+void RouteMatrix::reload()
+{
+    ProfileScope scope("RouteMatrix::reload");
+    m_cells.clear();
+    m_cellByKey.clear();
+    m_cellsBySource.clear();
+    m_profiles.clear();
+    m_records.clear();
+
+    QHash<int, Location> locations;
+    for (const Location &location : m_database->getAllLocations()) {
+        locations.insert(location.id.value_or(0), location);
+    }
+    QHash<QString, double> truckM3ByName;
+    for (const Vehicle &vehicle : m_database->getAllVehicles()) {
+        if (vehicle.truckCapacityM3 > 0) {
+            truckM3ByName.insert(vehicle.name.toLower(), vehicle.truckCapacityM3);
+        }
+    }
+
+    for (const CycleProfile &profile : m_database->getAllCycleProfiles()) {
+        ProfileRoute route;
+        route.payloadM3 = truckM3ByName.value(profile.vehicleName.toLower(), 0.0);
+
+        if (profile.sourceLocationId > 0 && profile.destLocationId > 0) {
+            const quint64 cellKey = key(profile.sourceLocationId, profile.destLocationId);
+            auto it = m_cellByKey.constFind(cellKey);
+            if (it == m_cellByKey.constEnd()) {
+                RouteCell cell;
+                cell.sourceLocationId = profile.sourceLocationId;
+                cell.destLocationId = profile.destLocationId;
+                const Location source = locations.value(profile.sourceLocationId);
+                const Location dest = locations.value(profile.destLocationId);
+                cell.sourceName = source.name.isEmpty() ? profile.sourceLocationName : source.name;
+                cell.destName = dest.name.isEmpty() ? profile.destLocationName : dest.name;
+                cell.mapId = source.mapId;
+                cell.destTypeId = dest.typeId;
+
+                it = m_cellByKey.insert(cellKey, m_cells.size());
+                m_cellsBySource[cell.sourceLocationId].append(m_cells.size());
+                m_cells.append(cell);
+            }
+            route.cell = it.value();
+            ++m_cells[route.cell].profiles;
+        }
+        m_profiles.insert(profile.id.value_or(0), route);
+    }
+
+    const QVector<CycleRecord> records = m_database->getAllCycleRecords();
+    m_records.reserve(records.size());
+    for (const CycleRecord &record : records) {
+        addRecord(record.id.value_or(0), record);
+    }
+
+    m_loaded = true;
+    m_reloadPending = false;
+    m_cyclesPending = false;
+    emit changed();
+}
+
+bool RouteMatrix::addRecord(int id, const CycleRecord &record)
+{
+    auto profile = m_profiles.constFind(record.profileId);
+    if (profile == m_profiles.constEnd()) {
+        return false;
+    }
+
+    TrackedRecord tracked;
+    tracked.profileId = record.profileId;
+    tracked.values.loadSeconds = record.loadSeconds;
+    tracked.values.haulSeconds = record.haulSeconds;
+    tracked.values.dumpSeconds = record.dumpSeconds;
+    tracked.values.returnSeconds = record.returnSeconds;
+    tracked.values.totalSeconds = record.totalSeconds;
+
+    if (profile->cell >= 0) {
+        RouteCell &cell = m_cells[profile->cell];
+        cell.stats.add(tracked.values);
+        if (profile->payloadM3 > 0) {
+            cell.payloadM3 += profile->payloadM3;
+            cell.payloadSeconds += record.totalSeconds;
+        }
+    }
+    m_records.insert(id, tracked);
+    return true;
+}
+
+void RouteMatrix::removeRecord(int id)
+{
+    auto it = m_records.find(id);
+    if (it == m_records.end()) {
+        return;
+    }
+
+    const ProfileRoute profile = m_profiles.value(it->profileId);
+    if (profile.cell >= 0) {
+        RouteCell &cell = m_cells[profile.cell];
+        cell.stats.remove(it->values);
+        if (profile.payloadM3 > 0) {
+            cell.payloadM3 -= profile.payloadM3;
+            cell.payloadSeconds -= it->values.totalSeconds;
+        }
+    }
+    m_records.erase(it);
+}
+
+// =============================================================================
+// Change Tracking
+// =============================================================================
+
+void RouteMatrix::onTablesChanged(DataTables tables)
+{
+    if (!m_loaded) {
+        return;
+    }
+    if (tables & (DataTable::Locations | DataTable::Vehicles)) {
+        m_reloadPending = true;
+    }
+    if (tables & DataTable::CycleTimes) {
+        m_cyclesPending = true;
+    }
+
+    // Row changes for the same flush follow this signal; settle after both
+    if ((m_reloadPending || m_cyclesPending) && !m_settleQueued) {
+        m_settleQueued = true;
+        QMetaObject::invokeMethod(this, &RouteMatrix::settle, Qt::QueuedConnection);
+    }
+}
+
+void RouteMatrix::onRowsChanged(const QVector<RowChange> &changes)
+{
+    if (!m_loaded || m_reloadPending) {
+        return;
+    }
+
+    QVector<RowChange> cycles;
+    for (const RowChange &change : changes) {
+        if (change.table == DataTable::CycleTimes) {
+            cycles.append(change);
+        }
+    }
+    // Rows only come for a table with no table-level publish in the flush,
+    // so patching them covers everything that changed
+    if (!cycles.isEmpty() && patch(cycles)) {
+        m_cyclesPending = false;
+        emit changed();
+    }
+}
+
+bool RouteMatrix::patch(const QVector<RowChange> &changes)
+{
+    ProfileScope scope("RouteMatrix::patch");
+    for (const RowChange &change : changes) {
+        removeRecord(change.id);
+        if (change.kind == RowChange::Deleted) {
+            continue;
+        }
+        const std::optional<CycleRecord> record = m_database->getCycleRecord(change.id);
+        if (record && !addRecord(change.id, *record)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RouteMatrix::settle()
+{
+    m_settleQueued = false;
+    if (m_reloadPending || m_cyclesPending) {
+        reload();
+    }
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+const RouteCell *RouteMatrix::route(int sourceLocationId, int destLocationId) const
+{
+    auto it = m_cellByKey.constFind(key(sourceLocationId, destLocationId));
+    return it == m_cellByKey.constEnd() ? nullptr : &m_cells[it.value()];
+}
+
+QVector<const RouteCell *> RouteMatrix::routesFrom(int sourceLocationId) const
+{
+    QVector<const RouteCell *> routes;
+    for (int index : m_cellsBySource.value(sourceLocationId)) {
+        if (m_cells[index].stats.count > 0) {
+            routes.append(&m_cells[index]);
+        }
+    }
+    std::sort(routes.begin(), routes.end(), [](const RouteCell *a, const RouteCell *b) {
+        return a->avgSeconds() < b->avgSeconds();
+    });
+    return routes;
+}
+
+const RouteCell *RouteMatrix::fastestFrom(int sourceLocationId, int destTypeId) const
+{
+    const RouteCell *fastest = nullptr;
+    for (int index : m_cellsBySource.value(sourceLocationId)) {
+        const RouteCell &cell = m_cells[index];
+        if (cell.stats.count == 0 || (destTypeId > 0 && cell.destTypeId != destTypeId)) {
+            continue;
+        }
+        if (!fastest || cell.avgSeconds() < fastest->avgSeconds()) {
+            fastest = &cell;
+        }
+    }
+    return fastest;
+}
+
+RouteHeatmap RouteMatrix::heatmap(int mapId, RouteMetric metric) const
+{
+    RouteHeatmap map;
+
+    // Rows and columns in name order, over the timed routes of the map
+    QMap<QString, int> sources;
+    QMap<QString, int> dests;
+    QVector<const RouteCell *> cells;
+    for (const RouteCell &cell : m_cells) {
+        if (cell.mapId != mapId || cell.stats.count == 0) {
+            continue;
+        }
+        // The id keeps two locations of the same name apart
+        sources.insert(cell.sourceName.toLower() + QChar(0) + QString::number(cell.sourceLocationId),
+                       cell.sourceLocationId);
+        dests.insert(cell.destName.toLower() + QChar(0) + QString::number(cell.destLocationId),
+                     cell.destLocationId);
+        cells.append(&cell);
+    }
+
+    QHash<int, int> rowOf;
+    QHash<int, int> columnOf;
+    for (int id : sources) {
+        rowOf.insert(id, map.sourceIds.size());
+        map.sourceIds.append(id);
+    }
+    for (int id : dests) {
+        columnOf.insert(id, map.destIds.size());
+        map.destIds.append(id);
+    }
+    map.sourceNames.resize(map.sourceIds.size());
+    map.destNames.resize(map.destIds.size());
+    map.values.fill(0.0, map.sourceIds.size() * map.destIds.size());
+
+    bool first = true;
+    for (const RouteCell *cell : cells) {
+        const int row = rowOf.value(cell->sourceLocationId);
+        const int column = columnOf.value(cell->destLocationId);
+        map.sourceNames[row] = cell->sourceName;
+        map.destNames[column] = cell->destName;
+
+        double value = 0;
+        switch (metric) {
+        case RouteMetric::AvgSeconds:     value = cell->avgSeconds(); break;
+        case RouteMetric::P90Seconds:     value = cell->p90Seconds(); break;
+        case RouteMetric::M3PerTruckHour: value = cell->m3PerTruckHour(); break;
+        case RouteMetric::Records:        value = cell->stats.count; break;
+        }
+        map.values[row * map.destIds.size() + column] = value;
+        if (value > 0) {
+            map.minValue = first ? value : qMin(map.minValue, value);
+            map.maxValue = first ? value : qMax(map.maxValue, value);
+            first = false;
+        }
+    }
+    return map;
+}
+
+} // namespace Frontier
@@ -0,0 +1,148 @@
+/**
+ * @file routematrix.h
+ * @brief Measured cycle times and haul rates between every pair of locations
+ */
+
+#ifndef ROUTEMATRIX_H
+#define ROUTEMATRIX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+#include "types.h"
+#include "datachangebus.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief Every timed cycle from one location to another
+ *
+ * Profiles with the same source and destination share a cell, whatever
+ * the vehicle. Payload only counts records whose profile names a truck
+ * with a capacity, so the haul rate is per truck of the trucks used.
+ */
+struct RouteCell {
+    int sourceLocationId = 0;
+    int destLocationId = 0;
+    QString sourceName;
+    QString destName;
+    int mapId = 0;                  // The source's
+    int destTypeId = 0;
+    int profiles = 0;
+
+    CycleStats stats;
+    double payloadM3 = 0;           // Carried over the records with a known truck
+    qint64 payloadSeconds = 0;      // Those records' cycle time
+
+    int avgSeconds() const { return stats.count > 0 ? int(stats.totalSum / stats.count) : 0; }
+    int bestSeconds() const { return stats.count > 0 ? stats.sortedTotals.first() : 0; }
+    int p50Seconds() const { return stats.percentile(0.5); }
+    int p90Seconds() const { return stats.percentile(0.9); }
+    double m3PerTruckHour() const { return payloadSeconds > 0 ? payloadM3 * 3600.0 / payloadSeconds : 0.0; }
+};
+
+enum class RouteMetric {
+    AvgSeconds,
+    P90Seconds,
+    M3PerTruckHour,
+    Records
+};
+
+/**
+ * @brief One map's routes as a source x destination grid
+ */
+struct RouteHeatmap {
+    QVector<int> sourceIds;         // Rows
+    QVector<int> destIds;           // Columns
+    QStringList sourceNames;
+    QStringList destNames;
+    QVector<double> values;         // Row-major; 0 where no cycle was timed
+    double minValue = 0;            // Over the timed cells
+    double maxValue = 0;
+
+    double value(int row, int column) const { return values[row * destIds.size() + column]; }
+};
+
+/**
+ * @brief Route aggregates kept current from cycle record writes
+ *
+ * reload() reads the profiles, locations, vehicles and every cycle record
+ * once. Single-record inserts, updates and deletes then arrive as row
+ * changes on the change bus and only touch their route's cell: the
+ * record's values are kept by id so a delete or an update can take its
+ * old contribution back out. Profile, location or vehicle edits, and
+ * bulk record writes, publish the whole table and lead to a reload.
+ *
+ * Lookups are hash probes on the matrix; fastestFrom() only walks the
+ * destinations of one source and heatmap() only the cells of one map.
+ */
+class RouteMatrix : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RouteMatrix(Database *database, QObject *parent = nullptr);
+
+    void reload();
+    bool isLoaded() const { return m_loaded; }
+
+    // nullptr when no profile runs from source to dest
+    const RouteCell *route(int sourceLocationId, int destLocationId) const;
+    // Timed routes out of source, fastest average first
+    QVector<const RouteCell *> routesFrom(int sourceLocationId) const;
+    // Fastest timed destination, optionally of one location type (a dump site)
+    const RouteCell *fastestFrom(int sourceLocationId, int destTypeId = 0) const;
+
+    RouteHeatmap heatmap(int mapId, RouteMetric metric = RouteMetric::AvgSeconds) const;
+
+    int cellCount() const { return m_cells.size(); }
+    int recordCount() const { return m_records.size(); }
+
+signals:
+    // After a reload or a patch
+    void changed();
+
+private slots:
+    void onTablesChanged(Frontier::DataTables tables);
+    void onRowsChanged(const QVector<Frontier::RowChange> &changes);
+
+private:
+    struct TrackedRecord {
+        int profileId = 0;
+        CycleRecord values;         // Phase and total seconds only
+    };
+
+    struct ProfileRoute {
+        int cell = -1;
+        double payloadM3 = 0;       // 0 when its truck is unknown
+    };
+
+    static quint64 key(int source, int dest) { return (quint64(quint32(source)) << 32) | quint32(dest); }
+
+    // False when the record's profile is not known yet
+    bool addRecord(int id, const CycleRecord &record);
+    void removeRecord(int id);
+    bool patch(const QVector<RowChange> &changes);
+    void settle();
+
+    Database *m_database;
+    bool m_loaded = false;
+    bool m_reloadPending = false;   // Locations or vehicles changed
+    bool m_cyclesPending = false;   // Profiles or records changed and were not patched
+    bool m_settleQueued = false;
+
+    QVector<RouteCell> m_cells;
+    QHash<quint64, int> m_cellByKey;
+    QHash<int, QVector<int>> m_cellsBySource;
+    QHash<int, ProfileRoute> m_profiles;
+    QHash<int, TrackedRecord> m_records;
+};
+
+} // namespace Frontier
+
+#endif // ROUTEMATRIX_H
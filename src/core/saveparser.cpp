@@ -0,0 +1,479 @@
+/**
+ * @file saveparser.cpp
+ * @brief GVAS save-file reader implementation
+ */
+
+#include "saveparser.h"
+#include "tracing.h"
+
+#include <QFile>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QTimeZone>
+#include <QtEndian>
+#include <cstring>
+
+namespace Frontier {
+
+namespace {
+
+constexpr int MaxDepth = 64;
+
+// .NET-style ticks (100 ns since 0001-01-01) at the Unix epoch
+constexpr qint64 UnixEpochTicks = 621355968000000000LL;
+
+// Map identifiers in priority order; the first one found wins
+const char *const KnownMaps[] = {
+    "FOREST_QUARRY", "DESERT_MINE", "ARCTIC_MINE", "VOLCANO_MINE",
+    "GRASS_FLAT", "FOREST_FLAT", "FOREST_HILLS", "MINE_TOWN",
+    "QUARRY", "SCANDINAVIA", "COAL_PLANT", "IRON_MOUNTAIN", "ARCTIC_WINTER"
+};
+
+// Structs serialized as raw bytes rather than as property lists
+const char *const NativeStructs[] = {
+    "Vector", "Vector2D", "Vector4", "IntPoint", "IntVector", "Rotator",
+    "Quat", "LinearColor", "Color", "Guid", "DateTime", "Timespan",
+    "Box", "Box2D"
+};
+
+bool equals(QByteArrayView a, const char *b)
+{
+    const qsizetype len = static_cast<qsizetype>(std::strlen(b));
+    return a.size() == len && std::memcmp(a.data(), b, len) == 0;
+}
+
+bool isNativeStruct(QByteArrayView structName)
+{
+    for (const char *name : NativeStructs) {
+        if (equals(structName, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool looksLikeItemCode(QByteArrayView value)
+{
+    if (value.size() != 6 || value[0] < '1' || value[0] > '4') {
+        return false;
+    }
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief FString as a view into the save bytes
+ */
+struct GvasString {
+    QByteArrayView bytes;            // Without the terminator
+    bool utf16 = false;
+
+    QString toString() const
+    {
+        if (!utf16) {
+            return QString::fromLatin1(bytes.data(), bytes.size());
+        }
+        // Copy out first; the source need not be 2-byte aligned
+        QString result(bytes.size() / 2, Qt::Uninitialized);
+        std::memcpy(result.data(), bytes.data(), result.size() * sizeof(QChar));
+        return result;
+    }
+};
+
+/**
+ * @brief Bounds-checked little-endian cursor over a byte range
+ *
+ * Any out-of-range read clears ok() and further reads return zero, so
+ * callers check once after a group of reads.
+ */
+class GvasReader
+{
+public:
+    GvasReader(const char *data, qint64 size) : m_data(data), m_size(size) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos >= m_size; }
+    qint64 pos() const { return m_pos; }
+
+    template <typename T>
+    T read()
+    {
+        if (!require(sizeof(T))) {
+            return T{};
+        }
+        T value = qFromLittleEndian<T>(m_data + m_pos);
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    void skip(qint64 count)
+    {
+        if (require(count)) {
+            m_pos += count;
+        }
+    }
+
+    void skipGuid()
+    {
+        if (read<quint8>()) {
+            skip(16);
+        }
+    }
+
+    GvasString readString()
+    {
+        GvasString str;
+        qint32 length = read<qint32>();
+        if (length == 0) {
+            return str;
+        }
+
+        str.utf16 = length < 0;
+        qint64 byteCount = str.utf16 ? -static_cast<qint64>(length) * 2 : length;
+        if (!require(byteCount)) {
+            return str;
+        }
+
+        // Drop the null terminator
+        qint64 terminator = str.utf16 ? 2 : 1;
+        str.bytes = QByteArrayView(m_data + m_pos, byteCount - terminator);
+        m_pos += byteCount;
+        return str;
+    }
+
+    // Cursor over the next count bytes; this cursor moves past them
+    GvasReader slice(qint64 count)
+    {
+        if (!require(count)) {
+            return GvasReader(m_data, 0);
+        }
+        GvasReader sub(m_data + m_pos, count);
+        m_pos += count;
+        return sub;
+    }
+
+private:
+    bool require(qint64 count)
+    {
+        if (!m_ok || count < 0 || count > m_size - m_pos) {
+            m_ok = false;
+        }
+        return m_ok;
+    }
+
+    const char *m_data;
+    qint64 m_size;
+    qint64 m_pos = 0;
+    bool m_ok = true;
+};
+
+/**
+ * @brief Walks the property tree and records the values the auditor uses
+ */
+class SaveWalker
+{
+public:
+    explicit SaveWalker(SaveGameData &out) : m_out(out) {}
+
+    // Reads properties up to the terminating "None"
+    bool readProperties(GvasReader &r, int depth, SaveTransaction *entry)
+    {
+        if (depth > MaxDepth) {
+            return false;
+        }
+
+        while (r.ok() && !r.atEnd()) {
+            QByteArrayView name = r.readString().bytes;
+            if (!r.ok()) {
+                return false;
+            }
+            if (equals(name, "None")) {
+                return true;
+            }
+
+            QByteArrayView type = r.readString().bytes;
+            qint64 size = r.read<qint64>();
+            if (!r.ok()) {
+                return false;
+            }
+
+            readValue(r, name, type, size, depth, entry);
+            if (!r.ok()) {
+                return false;
+            }
+        }
+
+        // A value slice may simply run out instead of ending in "None"
+        return r.ok();
+    }
+
+private:
+    void readValue(GvasReader &r, QByteArrayView name, QByteArrayView type,
+                   qint64 size, int depth, SaveTransaction *entry)
+    {
+        if (equals(type, "BoolProperty")) {
+            r.read<quint8>();
+            r.skipGuid();
+            return;
+        }
+
+        if (equals(type, "StructProperty")) {
+            QByteArrayView structName = r.readString().bytes;
+            r.skip(16);
+            r.skipGuid();
+            GvasReader value = r.slice(size);
+            readStruct(value, structName, depth, entry);
+            return;
+        }
+
+        if (equals(type, "ArrayProperty")) {
+            QByteArrayView innerType = r.readString().bytes;
+            r.skipGuid();
+            GvasReader value = r.slice(size);
+            readArray(value, name, innerType, depth);
+            return;
+        }
+
+        if (equals(type, "ByteProperty") || equals(type, "EnumProperty")
+            || equals(type, "SetProperty")) {
+            r.readString();
+            r.skipGuid();
+            r.skip(size);
+            return;
+        }
+
+        if (equals(type, "MapProperty")) {
+            r.readString();
+            r.readString();
+            r.skipGuid();
+            r.skip(size);
+            return;
+        }
+
+        r.skipGuid();
+        GvasReader value = r.slice(size);
+        if (equals(type, "IntProperty") && size == 4) {
+            noteInt(name, value.read<qint32>(), entry);
+        } else if (equals(type, "NameProperty") || equals(type, "StrProperty")) {
+            noteString(name, value.readString(), entry);
+        }
+    }
+
+    void readStruct(GvasReader &value, QByteArrayView structName, int depth,
+                    SaveTransaction *entry)
+    {
+        if (equals(structName, "DateTime")) {
+            qint64 ticks = value.read<qint64>();
+            if (value.ok() && entry && !entry->time.isValid()) {
+                entry->time = QDateTime::fromMSecsSinceEpoch(
+                    (ticks - UnixEpochTicks) / 10000, QTimeZone::utc());
+            }
+            return;
+        }
+
+        if (!isNativeStruct(structName)) {
+            readProperties(value, depth + 1, entry);
+        }
+    }
+
+    void readArray(GvasReader &value, QByteArrayView name, QByteArrayView innerType, int depth)
+    {
+        qint32 count = value.read<qint32>();
+        if (!value.ok() || count <= 0 || !equals(innerType, "StructProperty")) {
+            return;
+        }
+
+        // Struct arrays repeat the property header once for all elements
+        value.readString();
+        value.readString();
+        qint64 elementsSize = value.read<qint64>();
+        QByteArrayView structName = value.readString().bytes;
+        value.skip(16);
+        value.skipGuid();
+        GvasReader elements = value.slice(elementsSize);
+        if (!value.ok() || isNativeStruct(structName)) {
+            return;
+        }
+
+        const bool history = equals(name, "TransactionsHistory");
+        if (history) {
+            m_out.hasTransactionHistory = true;
+            if (m_out.transactions.isEmpty()) {
+                m_out.transactions.reserve(count);
+            }
+        }
+
+        for (qint32 i = 0; i < count && elements.ok() && !elements.atEnd(); ++i) {
+            SaveTransaction tx;
+            if (!readProperties(elements, depth + 1, history ? &tx : nullptr)) {
+                break;
+            }
+            if (history) {
+                m_out.transactions.append(tx);
+            }
+        }
+    }
+
+    void noteInt(QByteArrayView name, qint32 value, SaveTransaction *entry)
+    {
+        if (entry && equals(name, "Amount")) {
+            entry->amount = value;
+        } else if (!m_out.money && equals(name, "NewMoney")) {
+            m_out.money = value;
+        }
+    }
+
+    void noteString(QByteArrayView name, const GvasString &value, SaveTransaction *entry)
+    {
+        if (entry) {
+            if (entry->category.isEmpty() && equals(name, "Category")) {
+                entry->category = value.toString();
+            } else if (entry->itemCode.isEmpty() && !value.utf16 && looksLikeItemCode(value.bytes)) {
+                entry->itemCode = value.toString();
+            }
+        }
+
+        if (m_out.map.isEmpty() && !value.utf16 && !value.bytes.isEmpty()) {
+            const QByteArray raw = QByteArray::fromRawData(value.bytes.data(), value.bytes.size());
+            for (const char *map : KnownMaps) {
+                if (raw.contains(map)) {
+                    m_out.map = QString::fromLatin1(map);
+                    break;
+                }
+            }
+        }
+    }
+
+    SaveGameData &m_out;
+};
+
+} // namespace
+
+// =============================================================================
+// SaveGameData
+// =============================================================================
+
+double SaveGameData::totalSales() const
+{
+    double total = 0;
+    for (const auto &tx : transactions) {
+        if (tx.amount > 0) {
+            total += tx.amount;
+        }
+    }
+    return total;
+}
+
+double SaveGameData::totalPurchases() const
+{
+    double total = 0;
+    for (const auto &tx : transactions) {
+        if (tx.amount < 0) {
+            total -= tx.amount;
+        }
+    }
+    return total;
+}
+
+// =============================================================================
+// SaveParser
+// =============================================================================
+
+SaveGameData SaveParser::parseFile(const QString &filePath)
+{
+    FRONTIER_TRACE_SCOPE("SaveParser::parseFile");
+    SaveGameData result;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = QString("Could not open file: %1").arg(file.errorString());
+        return result;
+    }
+
+    const qint64 size = file.size();
+    if (uchar *mapped = file.map(0, size)) {
+        result = parse(reinterpret_cast<const char *>(mapped), size);
+        file.unmap(mapped);
+        return result;
+    }
+
+    // Mapping can fail on some filesystems; fall back to one read
+    const QByteArray data = file.readAll();
+    return parse(data.constData(), data.size());
+}
+
+SaveGameData SaveParser::parse(const char *data, qint64 size)
+{
+    FRONTIER_TRACE_SCOPE("SaveParser::parse");
+    SaveGameData result;
+    result.fileSize = size;
+
+    if (size < 4 || std::memcmp(data, "GVAS", 4) != 0) {
+        result.error = "Not a valid GVAS save file.";
+        return result;
+    }
+
+    GvasReader r(data, size);
+    r.skip(4);
+
+    result.saveGameVersion = r.read<qint32>();
+    result.packageVersion = r.read<qint32>();
+    if (result.saveGameVersion >= 3) {
+        r.read<qint32>();                    // UE5 package version
+    }
+
+    quint16 major = r.read<quint16>();
+    quint16 minor = r.read<quint16>();
+    quint16 patch = r.read<quint16>();
+    r.read<quint32>();                       // Changelist
+    GvasString branch = r.readString();
+    result.engineVersion = QString("%1.%2.%3 (%4)")
+                               .arg(major).arg(minor).arg(patch).arg(branch.toString());
+
+    r.read<qint32>();                        // Custom version format
+    qint32 customVersions = r.read<qint32>();
+    r.skip(static_cast<qint64>(customVersions) * 20);   // GUID + version each
+
+    result.saveGameClass = r.readString().toString();
+
+    if (!r.ok()) {
+        result.error = "Truncated GVAS header.";
+        return result;
+    }
+    result.valid = true;
+
+    SaveWalker walker(result);
+    if (!walker.readProperties(r, 0, nullptr)) {
+        result.error = QString("Property tree ended unexpectedly near offset %1.").arg(r.pos());
+    }
+
+    return result;
+}
+
+QVector<SaveTransaction> SaveParser::newTransactions(const QVector<SaveTransaction> &before,
+                                                     const QVector<SaveTransaction> &after)
+{
+    FRONTIER_TRACE_SCOPE("SaveParser::newTransactions");
+    QHash<SaveTransaction, int> seen;
+    seen.reserve(before.size());
+    for (const auto &tx : before) {
+        seen[tx]++;
+    }
+
+    QVector<SaveTransaction> added;
+    for (const auto &tx : after) {
+        auto it = seen.find(tx);
+        if (it != seen.end() && it.value() > 0) {
+            --it.value();
+        } else {
+            added.append(tx);
+        }
+    }
+    return added;
+}
+
+} // namespace Frontier
@@ -0,0 +1,85 @@
+/**
+ * @file saveparser.h
+ * @brief GVAS (Unreal Engine 4) save-file reader
+ */
+
+#ifndef SAVEPARSER_H
+#define SAVEPARSER_H
+
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+#include <QHash>
+#include <optional>
+
+namespace Frontier {
+
+/**
+ * @brief One entry of the save's TransactionsHistory array
+ */
+struct SaveTransaction {
+    QString itemCode;                // 6-digit item code
+    QString category;
+    qint32 amount = 0;               // Positive for sales, negative for purchases
+    QDateTime time;                  // Invalid if the entry carries no DateTime
+
+    bool isSale() const { return amount >= 0; }
+
+    bool operator==(const SaveTransaction &other) const {
+        return amount == other.amount && itemCode == other.itemCode
+               && category == other.category && time == other.time;
+    }
+};
+
+inline size_t qHash(const SaveTransaction &tx, size_t seed = 0)
+{
+    return qHashMulti(seed, tx.itemCode, tx.category, tx.amount,
+                      tx.time.isValid() ? tx.time.toMSecsSinceEpoch() : 0);
+}
+
+/**
+ * @brief Everything the auditor reads from a save file
+ */
+struct SaveGameData {
+    bool valid = false;              // GVAS header read successfully
+    QString error;                   // Set when invalid or the property tree was cut short
+
+    qint64 fileSize = 0;
+    int saveGameVersion = 0;
+    int packageVersion = 0;
+    QString engineVersion;
+    QString saveGameClass;
+
+    std::optional<qint32> money;     // NewMoney
+    QString map;
+    bool hasTransactionHistory = false;
+    QVector<SaveTransaction> transactions;
+
+    double totalSales() const;
+    double totalPurchases() const;
+};
+
+/**
+ * @brief Reads a GVAS save as a property tree in one forward pass
+ *
+ * The file is memory-mapped and walked in place: property names and
+ * string values are views into the mapped bytes and only the values the
+ * auditor keeps are copied out. Each struct and array value is read
+ * through a cursor bounded by its declared size, so an unrecognised or
+ * damaged value is skipped without losing the rest of the tree.
+ */
+class SaveParser
+{
+public:
+    static SaveGameData parseFile(const QString &filePath);
+    static SaveGameData parse(const char *data, qint64 size);
+
+    // Entries of after that are not in before, counting repeats, so a
+    // history that drops its oldest entries still yields only new ones
+    static QVector<SaveTransaction> newTransactions(const QVector<SaveTransaction> &before,
+                                                    const QVector<SaveTransaction> &after);
+};
+
+} // namespace Frontier
+
+#endif // SAVEPARSER_H
@@ -0,0 +1,109 @@
+/**
+ * @file savetimeline.cpp
+ * @brief Save timeline implementation
+ */
+
+#include "savetimeline.h"
+#include "itemcatalog.h"
+#include "profiler.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace Frontier {
+
+SaveSnapshot SaveTimelineBuilder::parse(const QString &filePath)
+{
+    SaveSnapshot snapshot;
+    snapshot.filePath = filePath;
+    snapshot.modified = QFileInfo(filePath).lastModified();
+    snapshot.data = SaveParser::parseFile(filePath);
+    return snapshot;
+}
+
+QStringList SaveTimelineBuilder::findSaves(const QString &dir)
+{
+    QStringList saves;
+    if (dir.isEmpty() || !QFileInfo(dir).isDir()) {
+        return saves;
+    }
+
+    QStringList folders{dir};
+    for (const QFileInfo &sub : QDir(dir).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        folders.append(sub.absoluteFilePath());
+    }
+    for (const QString &folder : folders) {
+        for (const QFileInfo &save : QDir(folder).entryInfoList({"*.sav"}, QDir::Files)) {
+            saves.append(save.absoluteFilePath());
+        }
+    }
+    return saves;
+}
+
+SaveTimeline SaveTimelineBuilder::build(QVector<SaveSnapshot> snapshots,
+                                        const QVector<Transaction> &ledger,
+                                        const ItemCatalog &catalog)
+{
+    ProfileScope scope("SaveTimelineBuilder::build");
+    SaveTimeline timeline;
+
+    std::stable_sort(snapshots.begin(), snapshots.end(),
+                     [](const SaveSnapshot &a, const SaveSnapshot &b) {
+                         if (a.modified != b.modified) {
+                             return a.modified < b.modified;
+                         }
+                         return a.filePath < b.filePath;
+                     });
+
+    // === Deltas between consecutive valid saves ===
+    const SaveSnapshot *previous = nullptr;
+    timeline.entries.reserve(snapshots.size());
+    for (const SaveSnapshot &snapshot : snapshots) {
+        SaveTimelineEntry entry;
+        entry.filePath = snapshot.filePath;
+        entry.modified = snapshot.modified;
+        entry.valid = snapshot.data.valid;
+        entry.error = snapshot.data.error;
+        entry.map = snapshot.data.map;
+        entry.money = snapshot.data.money;
+        entry.historySize = snapshot.data.transactions.size();
+
+        if (!entry.valid) {
+            ++timeline.failed;
+            timeline.entries.append(entry);
+            continue;
+        }
+
+        if (previous) {
+            entry.hasPrevious = true;
+            entry.moneyDelta = qint64(snapshot.data.money.value_or(0)) - previous->data.money.value_or(0);
+            entry.added = SaveParser::newTransactions(previous->data.transactions, snapshot.data.transactions);
+            for (const SaveTransaction &tx : entry.added) {
+                (tx.isSale() ? entry.addedSales : entry.addedPurchases) += tx.amount;
+                timeline.added.append(tx);
+                timeline.addedEntry.append(timeline.entries.size());
+            }
+            entry.unexplainedMoney = entry.moneyDelta - entry.addedNet();
+        }
+        previous = &snapshot;
+        timeline.entries.append(entry);
+    }
+
+    // === One reconciliation for every step ===
+    ReconcileOptions options;
+    options.reportUnmatchedLedger = false;
+    timeline.report = Reconciler(catalog).reconcile(timeline.added, ledger, options);
+
+    for (const ReconcileIssue &issue : timeline.report.issues) {
+        if (issue.saveIndex >= 0) {
+            ++timeline.entries[timeline.addedEntry[issue.saveIndex]].issues;
+        }
+    }
+    for (SaveTimelineEntry &entry : timeline.entries) {
+        entry.matched = qMax(0, int(entry.added.size()) - entry.issues);
+    }
+    return timeline;
+}
+
+} // namespace Frontier
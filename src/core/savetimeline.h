@@ -0,0 +1,96 @@
+/**
+ * @file savetimeline.h
+ * @brief Money and transaction deltas across a series of save files
+ */
+
+#ifndef SAVETIMELINE_H
+#define SAVETIMELINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <optional>
+
+#include "types.h"
+#include "saveparser.h"
+#include "reconciler.h"
+
+namespace Frontier {
+
+class ItemCatalog;
+
+/**
+ * @brief One parsed save of a batch
+ */
+struct SaveSnapshot {
+    QString filePath;
+    QDateTime modified;
+    SaveGameData data;
+};
+
+/**
+ * @brief One save against the save before it
+ *
+ * The first valid save is the baseline and carries no deltas. The money
+ * left unexplained is the change in money the new history entries do not
+ * account for: income or spending the history dropped or never recorded.
+ */
+struct SaveTimelineEntry {
+    QString filePath;
+    QDateTime modified;
+    bool valid = false;
+    QString error;
+    QString map;
+    std::optional<qint32> money;
+    int historySize = 0;
+
+    bool hasPrevious = false;
+    qint64 moneyDelta = 0;
+    QVector<SaveTransaction> added;     // Entries new since the previous save
+    qint64 addedSales = 0;
+    qint64 addedPurchases = 0;          // Negative, as the save records it
+    qint64 unexplainedMoney = 0;        // moneyDelta - (addedSales + addedPurchases)
+
+    // Reconciliation of the added entries against the ledger
+    int matched = 0;
+    int issues = 0;
+
+    qint64 addedNet() const { return addedSales + addedPurchases; }
+};
+
+struct SaveTimeline {
+    QVector<SaveTimelineEntry> entries;     // Oldest save first
+    ReconcileReport report;                 // Over every added entry of the batch
+    QVector<SaveTransaction> added;         // The report's save side, entry by entry
+    QVector<int> addedEntry;                // Timeline entry of each added[i]
+    int failed = 0;                         // Saves that did not parse
+};
+
+/**
+ * @brief Builds a timeline from saves parsed in parallel
+ *
+ * parse() is the per-file step, safe to run on any thread, so a caller
+ * can map it over the files with QtConcurrent. build() then orders the
+ * snapshots by modification time, diffs each against the previous valid
+ * one with SaveParser::newTransactions(), and reconciles the new entries
+ * of every step against the ledger in a single Reconciler pass, so the
+ * hash tables over the ledger are built once for the whole batch.
+ */
+class SaveTimelineBuilder
+{
+public:
+    static SaveSnapshot parse(const QString &filePath);
+
+    // *.sav files in dir and its immediate subfolders (one per save slot)
+    static QStringList findSaves(const QString &dir);
+
+    // Owner thread: reads the item catalog
+    static SaveTimeline build(QVector<SaveSnapshot> snapshots,
+                              const QVector<Transaction> &ledger,
+                              const ItemCatalog &catalog);
+};
+
+} // namespace Frontier
+
+#endif // SAVETIMELINE_H
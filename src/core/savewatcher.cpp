@@ -0,0 +1,156 @@
+/**
+ * @file savewatcher.cpp
+ * @brief Save folder watcher implementation
+ */
+
+#include "savewatcher.h"
+
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace Frontier {
+
+SaveWatcher::SaveWatcher(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_settleTimer(new QTimer(this))
+{
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SettleMs);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &SaveWatcher::onPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &SaveWatcher::onPathChanged);
+    connect(m_settleTimer, &QTimer::timeout, this, &SaveWatcher::onSettled);
+    connect(&m_parse, &QFutureWatcher<SaveParseResult>::finished, this, &SaveWatcher::onParseFinished);
+}
+
+SaveWatcher::~SaveWatcher()
+{
+    // The parse task only touches its own copies, but finish it before
+    // the future watcher goes away
+    m_parse.waitForFinished();
+}
+
+void SaveWatcher::setDirectory(const QString &path)
+{
+    if (path == m_directory) {
+        return;
+    }
+    m_directory = path;
+    rewatch();
+}
+
+void SaveWatcher::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    if (!m_enabled) {
+        m_settleTimer->stop();
+    }
+    rewatch();
+}
+
+void SaveWatcher::setBaseline(const SaveGameData &data)
+{
+    m_baseline = data;
+}
+
+void SaveWatcher::rewatch()
+{
+    const QStringList watched = m_watcher->directories() + m_watcher->files();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+
+    if (!m_enabled || m_directory.isEmpty() || !QFileInfo(m_directory).isDir()) {
+        return;
+    }
+
+    QStringList paths{m_directory};
+    QDir dir(m_directory);
+    for (const QFileInfo &sub : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        paths.append(sub.absoluteFilePath());
+    }
+    m_watcher->addPaths(paths);
+}
+
+QString SaveWatcher::newestSave() const
+{
+    QFileInfo newest;
+    for (const QString &path : m_watcher->directories()) {
+        const QFileInfoList saves = QDir(path).entryInfoList({"*.sav"}, QDir::Files, QDir::Time);
+        if (!saves.isEmpty() && (!newest.exists() || saves.first().lastModified() > newest.lastModified())) {
+            newest = saves.first();
+        }
+    }
+    return newest.exists() ? newest.absoluteFilePath() : QString();
+}
+
+// =============================================================================
+// Change Handling
+// =============================================================================
+
+void SaveWatcher::onPathChanged()
+{
+    if (m_enabled) {
+        m_settleTimer->start();          // Restart: wait for writes to stop
+    }
+}
+
+void SaveWatcher::onSettled()
+{
+    if (m_parse.isRunning()) {
+        m_reparseQueued = true;
+        return;
+    }
+
+    // A new slot folder may have appeared
+    rewatch();
+
+    const QString path = newestSave();
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const QDateTime modified = QFileInfo(path).lastModified();
+    if (path == m_lastFile && modified == m_lastModified) {
+        return;                          // Touched, but not rewritten
+    }
+    m_lastFile = path;
+    m_lastModified = modified;
+
+    const QVector<SaveTransaction> before = m_baseline.transactions;
+    m_parse.setFuture(QtConcurrent::run([path, before]() {
+        SaveParseResult result;
+        result.filePath = path;
+        result.data = SaveParser::parseFile(path);
+        if (result.data.valid) {
+            result.newTransactions = SaveParser::newTransactions(before, result.data.transactions);
+        }
+        return result;
+    }));
+}
+
+void SaveWatcher::onParseFinished()
+{
+    const SaveParseResult result = m_parse.result();
+
+    if (result.data.valid) {
+        m_baseline = result.data;
+        emit saveParsed(result);
+    } else {
+        emit parseFailed(result.filePath, result.data.error);
+    }
+
+    if (m_reparseQueued) {
+        m_reparseQueued = false;
+        onSettled();
+    }
+}
+
+} // namespace Frontier
@@ -0,0 +1,86 @@
+/**
+ * @file savewatcher.h
+ * @brief Watches the game's save folder and reparses saves in the background
+ */
+
+#ifndef SAVEWATCHER_H
+#define SAVEWATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QFutureWatcher>
+
+#include "saveparser.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace Frontier {
+
+/**
+ * @brief Result of one background reparse
+ */
+struct SaveParseResult {
+    QString filePath;
+    SaveGameData data;
+    QVector<SaveTransaction> newTransactions;    // Relative to the baseline
+};
+
+/**
+ * @brief Reparses the newest save whenever the game writes one
+ *
+ * Watches a save folder and its immediate subfolders (one per save slot).
+ * Change notifications are debounced so a save written in several steps
+ * is parsed once, after it settles. Parsing and the diff against the
+ * previous snapshot run on the global thread pool; saveParsed() is emitted
+ * on the watcher's thread with only the entries added since the baseline.
+ */
+class SaveWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SaveWatcher(QObject *parent = nullptr);
+    ~SaveWatcher();
+
+    void setDirectory(const QString &path);
+    QString directory() const { return m_directory; }
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // Snapshot that the next reparse is diffed against
+    void setBaseline(const SaveGameData &data);
+
+signals:
+    void saveParsed(const Frontier::SaveParseResult &result);
+    void parseFailed(const QString &filePath, const QString &error);
+
+private slots:
+    void onPathChanged();
+    void onSettled();
+    void onParseFinished();
+
+private:
+    void rewatch();
+    QString newestSave() const;
+
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_settleTimer;
+    QFutureWatcher<SaveParseResult> m_parse;
+
+    QString m_directory;
+    bool m_enabled = false;
+    bool m_reparseQueued = false;
+
+    SaveGameData m_baseline;
+    QString m_lastFile;
+    QDateTime m_lastModified;
+
+    static constexpr int SettleMs = 1500;
+};
+
+} // namespace Frontier
+
+#endif // SAVEWATCHER_H
@@ -0,0 +1,127 @@
+/**
+ * @file symboltable.cpp
+ * @brief Interned string pool implementation
+ */
+
+#include "symboltable.h"
+#include "profiler.h"
+
+namespace Frontier {
+
+SymbolTable &SymbolTable::instance()
+{
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::SymbolTable()
+{
+    m_strings.append(QString());
+}
+
+Symbol SymbolTable::intern(QString &text)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_ids.constFind(text);
+        if (it != m_ids.constEnd()) {
+            text = m_strings[it.value()];
+            return it.value();
+        }
+    }
+    return insert(text, &text);
+}
+
+Symbol SymbolTable::intern(const QString &text)
+{
+    QString copy = text;
+    return intern(copy);
+}
+
+Symbol SymbolTable::insert(const QString &text, QString *pooled)
+{
+    QWriteLocker locker(&m_lock);
+    // Another thread may have added it between the two locks
+    auto it = m_ids.constFind(text);
+    if (it == m_ids.constEnd()) {
+        const Symbol symbol = Symbol(m_strings.size());
+        // Own a tight copy so the pool does not keep a row's spare capacity
+        m_strings.append(QString(text.constData(), text.size()));
+        it = m_ids.insert(m_strings.last(), symbol);
+    }
+    *pooled = m_strings[it.value()];
+    return it.value();
+}
+
+Symbol SymbolTable::find(const QString &text) const
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+    QReadLocker locker(&m_lock);
+    return m_ids.value(text, Unknown);
+}
+
+QString SymbolTable::text(Symbol symbol) const
+{
+    QReadLocker locker(&m_lock);
+    return symbol < Symbol(m_strings.size()) ? m_strings[symbol] : QString();
+}
+
+int SymbolTable::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.size() - 1;
+}
+
+qint64 SymbolTable::estimatedBytes() const
+{
+    QReadLocker locker(&m_lock);
+    // Hash keys share the pooled strings' buffers, so count those once
+    return estimateBytes(m_strings)
+           + m_ids.size() * qint64(sizeof(QString) + sizeof(Symbol) + 2 * sizeof(void *));
+}
+
+// =============================================================================
+// Row helpers
+// =============================================================================
+
+void internStrings(Transaction &transaction)
+{
+    SymbolTable &symbols = SymbolTable::instance();
+    transaction.itemSymbol = symbols.intern(transaction.item);
+    transaction.categorySymbol = symbols.intern(transaction.category);
+}
+
+void internStrings(InventoryItem &item)
+{
+    SymbolTable &symbols = SymbolTable::instance();
+    item.itemSymbol = symbols.intern(item.itemName);
+    item.categorySymbol = symbols.intern(item.category);
+    item.locationSymbol = symbols.intern(item.locationName);
+}
+
+void internStrings(Recipe &recipe)
+{
+    SymbolTable &symbols = SymbolTable::instance();
+    recipe.workbenchSymbol = symbols.intern(recipe.workbenchName);
+    recipe.outputSymbol = symbols.intern(recipe.outputItem);
+}
+
+void internStrings(RecipeIngredient &ingredient)
+{
+    ingredient.itemSymbol = SymbolTable::instance().intern(ingredient.itemName);
+}
+
+void internStrings(Location &location)
+{
+    SymbolTable &symbols = SymbolTable::instance();
+    location.mapSymbol = symbols.intern(location.mapName);
+    location.typeSymbol = symbols.intern(location.typeName);
+}
+
+} // namespace Frontier
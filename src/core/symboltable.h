@@ -0,0 +1,70 @@
+/**
+ * @file symboltable.h
+ * @brief Process-wide pool of interned names and categories
+ */
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+#include "types.h"
+
+namespace Frontier {
+
+/**
+ * @brief Maps repeated strings to small integer ids and one shared copy
+ *
+ * Ledger, inventory, recipe and location rows repeat a few hundred item,
+ * category, map and type names many thousands of times. Loaders pass each
+ * such field through intern(), which swaps the row's QString for the
+ * pooled one (so every row shares a single buffer) and returns its id.
+ * Filters then resolve the filter text once with find() and compare ids.
+ *
+ * Ids are stable for the life of the process and are never reused; the
+ * pool only grows. Symbol 0 is the empty string. Safe to call from the
+ * worker and pool threads.
+ */
+class SymbolTable
+{
+public:
+    static SymbolTable &instance();
+
+    // Returned by find() for text no row has; equal to no row's symbol
+    static constexpr Symbol Unknown = 0xFFFFFFFFu;
+
+    // Replaces text with the pooled copy and returns its id; the const
+    // overload only returns the id
+    Symbol intern(QString &text);
+    Symbol intern(const QString &text);
+
+    // Id of text if it was ever interned, 0 for the empty string, else Unknown
+    Symbol find(const QString &text) const;
+    QString text(Symbol symbol) const;
+
+    int size() const;
+    qint64 estimatedBytes() const;
+
+private:
+    SymbolTable();
+
+    Symbol insert(const QString &text, QString *pooled);
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Symbol> m_ids;
+    QVector<QString> m_strings;          // Indexed by Symbol
+};
+
+// Interns the repeated name fields of a loaded row and fills its symbols
+void internStrings(Transaction &transaction);
+void internStrings(InventoryItem &item);
+void internStrings(Recipe &recipe);      // Not the ingredients; see below
+void internStrings(RecipeIngredient &ingredient);
+void internStrings(Location &location);
+
+} // namespace Frontier
+
+#endif // SYMBOLTABLE_H
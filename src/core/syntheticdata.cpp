@@ -0,0 +1,408 @@
+/**
+ * @file syntheticdata.cpp
+ * @brief Synthetic dataset generator implementation
+ */
+
+#include "syntheticdata.h"
+#include "database.h"
+#include "itemimporter.h"
+#include "vehicleimporter.h"
+#include "recipeimporter.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+namespace Frontier {
+
+namespace {
+
+const QStringList Weathers = {"Clear", "Clear", "Clear", "Cloudy", "Rain", "Fog", "Storm"};
+const QStringList Activities = {"Hauling ore to the crusher", "Stripping overburden",
+                                "Blasting and loading", "Factory maintenance",
+                                "Selling stockpile", "Road building"};
+const QStringList Maps = {"Quarry", "Highlands", "Lakeside"};
+
+int importBuildings(Database *database, const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open factory buildings file:" << path;
+        return -1;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isArray()) {
+        qWarning() << "Factory buildings JSON must be an array:" << path;
+        return -1;
+    }
+
+    int imported = 0;
+    for (const auto &val : doc.array()) {
+        const QJsonObject obj = val.toObject();
+        FactoryBuilding building;
+        building.name = obj["name"].toString();
+        building.category = obj["category"].toString();
+        building.dimensions = obj["dimensions"].toString();
+        building.speed = obj["speed"].toString();
+        building.powerKw = obj["power_kw"].toDouble();
+        building.generatedKw = obj["generated_kw"].toDouble();
+        building.capacity = obj["capacity"].toDouble();
+        building.connections = obj["connections"].toInt();
+        building.price = obj["price"].toDouble();
+        if (!building.name.isEmpty() && database->addFactoryBuilding(building) > 0) {
+            ++imported;
+        }
+    }
+    return imported;
+}
+
+QVector<Vehicle> syntheticFleet()
+{
+    QVector<Vehicle> fleet;
+    for (int i = 0; i < 4; ++i) {
+        Vehicle loader;
+        loader.id = QString("SYN_LOADER_%1").arg(i + 1);
+        loader.name = QString("Synthetic Loader %1").arg(i + 1);
+        loader.categoryMain = "Vehicles - Loaders";
+        loader.bucketCapacityM3 = 3.0 + i;
+        loader.tankCapacityL = 300;
+        loader.fuelUseLPerHour = 18 + 2 * i;
+        loader.purchasePrice = 150000 + 25000 * i;
+        fleet.append(loader);
+    }
+    for (int i = 0; i < 8; ++i) {
+        Vehicle truck;
+        truck.id = QString("SYN_TRUCK_%1").arg(i + 1);
+        truck.name = QString("Synthetic Rock Truck %1").arg(i + 1);
+        truck.categoryMain = "Vehicles - Rock Trucks";
+        truck.truckCapacityM3 = 15.0 + 4 * (i % 3);
+        truck.tankCapacityL = 200;
+        truck.fuelUseLPerHour = 10 + i % 3;
+        truck.purchasePrice = 120000 + 20000 * (i % 3);
+        fleet.append(truck);
+    }
+    return fleet;
+}
+
+bool isHaulTruck(const Vehicle &vehicle)
+{
+    return vehicle.truckCapacityM3 > 0 || vehicle.categoryMain.contains("Truck", Qt::CaseInsensitive);
+}
+
+} // namespace
+
+SyntheticDataGenerator::SyntheticDataGenerator(Database *database)
+    : m_database(database)
+{
+}
+
+QVector<Item> SyntheticDataGenerator::syntheticItems(int count)
+{
+    QVector<Item> items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Item item;
+        item.code = QString::number(100000 + i);
+        item.name = QString("Synthetic Item %1").arg(i, 6, 10, QChar('0'));
+        item.categoryMain = QString("Category %1").arg(i % 12);
+        item.categorySub = QString("Sub %1").arg(i % 5);
+        item.buyPriceInternal = 50 + (i * 37) % 5000;
+        item.buyPriceDisplay = qRound(item.buyPriceInternal);
+        item.sellPriceInternal = item.buyPriceInternal * 0.7;
+        item.sellPriceDisplay = qRound(item.sellPriceInternal);
+        item.weight = (i % 40) * 0.5;
+        item.isCraftable = i >= count / 2;
+        items.append(item);
+    }
+    return items;
+}
+
+bool SyntheticDataGenerator::generate(const SyntheticDataOptions &options)
+{
+    m_stats = SyntheticDataStats();
+    m_lastError.clear();
+    m_rng.seed(options.seed);
+
+    if (!m_database || !m_database->isOpen()) {
+        m_lastError = "Database is not open";
+        return false;
+    }
+
+    if (!m_database->beginTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
+
+    if (!loadCatalog(options)) {
+        m_database->rollbackTransaction();
+        return false;
+    }
+    generateInventory();
+
+    QVector<int> profileIds;
+    for (int i = 0; i < 6; ++i) {
+        CycleProfile profile;
+        profile.name = QString("Pit %1 to Crusher %2").arg(i + 1).arg(QChar('A' + i % 2));
+        int id = m_database->addCycleProfile(profile);
+        if (id > 0) {
+            profileIds.append(id);
+        }
+    }
+
+    const QDate end = options.endDate.isValid() ? options.endDate : QDate::currentDate();
+    const QDate start = end.addYears(-qMax(1, options.years));
+
+    // Opening balances large enough to fund the first weeks of purchases
+    for (AccountType account : {AccountType::Company, AccountType::Personal}) {
+        Transaction opening;
+        opening.date = start;
+        opening.type = TransactionType::Opening;
+        opening.account = account;
+        opening.category = "Opening";
+        opening.quantity = 1;
+        opening.unitPrice = account == AccountType::Company ? 500000 : 50000;
+        opening.totalAmount = opening.unitPrice;
+        if (m_database->addTransaction(opening)) {
+            ++m_stats.transactions;
+        }
+    }
+
+    for (QDate date = start; date <= end; date = date.addDays(1)) {
+        const bool workDay = date.dayOfWeek() <= options.shiftsPerWeek;
+        generateDay(date, workDay, options, profileIds);
+    }
+
+    if (!m_database->commitTransaction()) {
+        m_lastError = m_database->lastError();
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Catalog
+// =============================================================================
+
+bool SyntheticDataGenerator::loadCatalog(const SyntheticDataOptions &options)
+{
+    // Items
+    if (!options.itemsJson.isEmpty()) {
+        if (ItemImporter::importFromJson(options.itemsJson, m_database) < 0) {
+            m_lastError = "Could not import items from " + options.itemsJson;
+            return false;
+        }
+    } else {
+        m_database->addItems(syntheticItems(options.syntheticItems));
+    }
+    m_items = m_database->getAllItems();
+    m_stats.items = m_items.size();
+    if (m_items.isEmpty()) {
+        m_lastError = "The item catalog is empty";
+        return false;
+    }
+
+    // Vehicles
+    if (!options.vehiclesJson.isEmpty()) {
+        if (VehicleImporter::importFromJson(options.vehiclesJson, m_database) < 0) {
+            m_lastError = "Could not import vehicles from " + options.vehiclesJson;
+            return false;
+        }
+    } else {
+        m_database->upsertVehicles(syntheticFleet());
+    }
+    m_vehicles = m_database->getAllVehicles(true);
+    m_stats.vehicles = m_vehicles.size();
+
+    // Factory buildings are catalog only; nothing below refers to them
+    if (!options.buildingsJson.isEmpty()) {
+        m_stats.buildings = qMax(0, importBuildings(m_database, options.buildingsJson));
+    }
+
+    // Recipes
+    if (!options.recipesJson.isEmpty()) {
+        RecipeImporter importer(m_database);
+        if (!importer.importFromJson(options.recipesJson)) {
+            m_lastError = importer.lastError();
+            return false;
+        }
+    } else {
+        // Upper-half items are made from lower-numbered ones, so recipe
+        // chains several levels deep form when a tree is expanded
+        Workbench bench;
+        bench.name = "Synthetic Workbench";
+        const int workbenchId = m_database->addWorkbench(bench);
+        const int half = m_items.size() / 2;
+        QVector<Recipe> recipes;
+        for (int r = 0; r < options.syntheticRecipes && half + r < m_items.size(); ++r) {
+            const int output = half + r;
+            Recipe recipe;
+            recipe.workbenchId = workbenchId;
+            recipe.outputItem = m_items[output].name;
+            recipe.outputQty = 1 + r % 3;
+            for (int k = 0; k < 3; ++k) {
+                RecipeIngredient ingredient;
+                ingredient.itemName = m_items[m_rng.bounded(output)].name;
+                ingredient.quantity = 1 + m_rng.bounded(5);
+                recipe.ingredients.append(ingredient);
+            }
+            recipes.append(recipe);
+        }
+        m_database->addRecipes(recipes);
+    }
+    m_recipes = m_database->getAllRecipes();
+    m_stats.recipes = m_recipes.size();
+
+    return true;
+}
+
+void SyntheticDataGenerator::generateInventory()
+{
+    for (int i = 0; i < m_items.size(); i += 2) {
+        InventoryItem inv;
+        inv.itemId = m_items[i].id.value_or(0);
+        inv.quantity = m_rng.bounded(500);
+        if (m_database->addInventoryItem(inv) > 0) {
+            ++m_stats.inventoryRows;
+        }
+    }
+}
+
+// =============================================================================
+// Daily Activity
+// =============================================================================
+
+void SyntheticDataGenerator::generateDay(const QDate &date, bool workDay,
+                                         const SyntheticDataOptions &options,
+                                         const QVector<int> &profileIds)
+{
+    // === Ledger ===
+    const int perDay = qMax(0, options.transactionsPerDay);
+    const int count = perDay > 0 ? perDay / 2 + m_rng.bounded(perDay + 1) : 0;
+    for (int t = 0; t < count; ++t) {
+        const Item &item = m_items[m_rng.bounded(int(m_items.size()))];
+        const int roll = m_rng.bounded(100);
+
+        Transaction trans;
+        trans.date = date;
+        trans.account = roll % 4 == 0 ? AccountType::Personal : AccountType::Company;
+        trans.item = item.name;
+        if (roll < 50) {
+            trans.type = TransactionType::Sale;
+            trans.category = item.categoryMain;
+            trans.quantity = 5 + m_rng.bounded(60);
+            trans.unitPrice = item.sellPriceInternal > 0 ? item.sellPriceInternal : 100;
+        } else if (roll < 92) {
+            trans.type = TransactionType::Purchase;
+            trans.category = item.categoryMain;
+            trans.quantity = 1 + m_rng.bounded(20);
+            trans.unitPrice = item.buyPriceInternal > 0 ? item.buyPriceInternal : 100;
+        } else {
+            trans.type = TransactionType::Fuel;
+            trans.item = "Diesel";
+            trans.category = "Fuel";
+            trans.quantity = 50 + m_rng.bounded(400);
+            trans.unitPrice = 1.6;
+        }
+        trans.totalAmount = trans.quantity * trans.unitPrice;
+        if (m_database->addTransaction(trans)) {
+            ++m_stats.transactions;
+        }
+    }
+
+    if (!workDay) {
+        return;
+    }
+
+    // === Shift and movement session ===
+    const QDateTime shiftStart(date, QTime(7, 0).addSecs(60 * m_rng.bounded(180)));
+    const QDateTime shiftEnd = shiftStart.addSecs(60 * (180 + m_rng.bounded(300)));
+    const double hours = shiftStart.secsTo(shiftEnd) / 3600.0;
+
+    Shift shift;
+    shift.startTime = shiftStart;
+    shift.endTime = shiftEnd;
+    shift.weather = Weathers[m_rng.bounded(int(Weathers.size()))];
+    shift.activities = Activities[m_rng.bounded(int(Activities.size()))];
+    if (m_database->addShift(shift) > 0) {
+        ++m_stats.shifts;
+    }
+
+    MovementSession session;
+    session.startTime = shiftStart;
+    session.endTime = shiftEnd;
+    session.mapName = Maps[m_rng.bounded(int(Maps.size()))];
+    const int sessionId = m_database->addMovementSession(session);
+    if (sessionId > 0) {
+        ++m_stats.movementSessions;
+
+        QVector<MovementEquipmentUsage> usages;
+        for (const Vehicle &vehicle : m_vehicles) {
+            if (m_rng.bounded(3) != 0) {
+                continue;                    // Roughly a third of the fleet works each shift
+            }
+            MovementEquipmentUsage usage;
+            usage.sessionId = sessionId;
+            usage.equipmentId = vehicle.id;
+            usage.hoursUsed = hours * (0.6 + m_rng.bounded(40) / 100.0);
+            usage.estimatedFuelL = usage.hoursUsed * vehicle.fuelUseLPerHour;
+            if (isHaulTruck(vehicle)) {
+                usage.role = "HaulTruck";
+                usage.loads = int(usage.hoursUsed * (3 + m_rng.bounded(4)));
+                usage.dumps = usage.loads;
+            } else {
+                usage.role = vehicle.categoryMain.contains("Excavator", Qt::CaseInsensitive)
+                                 ? "Excavator" : "Loader";
+                usage.buckets = int(usage.hoursUsed * (20 + m_rng.bounded(20)));
+            }
+            usages.append(usage);
+        }
+        m_database->saveEquipmentUsages(sessionId, usages);
+    }
+
+    // === Production ===
+    for (int r = 0; r < options.productionRunsPerShift && !m_recipes.isEmpty(); ++r) {
+        ProductionRun run;
+        run.recipeId = m_recipes[m_rng.bounded(int(m_recipes.size()))].id.value_or(0);
+        run.quantity = 1 + m_rng.bounded(10);
+        run.timestamp = shiftStart.addSecs(m_rng.bounded(int(shiftStart.secsTo(shiftEnd))));
+        if (m_database->addProductionRun(run) > 0) {
+            ++m_stats.productionRuns;
+        }
+    }
+
+    // === Haul cycles ===
+    for (int c = 0; c < options.cycleRecordsPerShift && !profileIds.isEmpty(); ++c) {
+        CycleRecord record;
+        record.profileId = profileIds[m_rng.bounded(int(profileIds.size()))];
+        record.loadSeconds = 45 + m_rng.bounded(60);
+        record.haulSeconds = 120 + m_rng.bounded(240);
+        record.dumpSeconds = 20 + m_rng.bounded(30);
+        record.returnSeconds = 90 + m_rng.bounded(180);
+        record.totalSeconds = record.computeTotal();
+        record.timestamp = shiftStart.addSecs(qint64(c) * record.totalSeconds);
+        if (m_database->addCycleRecord(record) > 0) {
+            ++m_stats.cycleRecords;
+        }
+    }
+
+    // === Fuel ===
+    QVector<FuelLogEntry> fuel;
+    for (int f = 0; f < options.fuelEntriesPerShift && !m_vehicles.isEmpty(); ++f) {
+        const Vehicle &vehicle = m_vehicles[m_rng.bounded(int(m_vehicles.size()))];
+        FuelLogEntry entry;
+        entry.dateTime = shiftStart.addSecs(m_rng.bounded(int(shiftStart.secsTo(shiftEnd))));
+        entry.equipmentId = vehicle.id;
+        entry.liters = qMax(20.0, vehicle.tankCapacityL * (0.3 + m_rng.bounded(60) / 100.0));
+        entry.unitPrice = 1.6;
+        entry.totalCost = entry.liters * entry.unitPrice;
+        entry.source = f % 2 == 0 ? "On-site tank" : "Gas Station";
+        fuel.append(entry);
+    }
+    if (!fuel.isEmpty()) {
+        m_stats.fuelEntries += qMax(0, m_database->addFuelLogEntries(fuel));
+    }
+}
+
+} // namespace Frontier
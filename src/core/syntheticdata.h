@@ -0,0 +1,98 @@
+/**
+ * @file syntheticdata.h
+ * @brief Generates large, realistic datasets for load and scaling tests
+ */
+
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+#include <QDate>
+#include <QRandomGenerator>
+
+#include "types.h"
+
+namespace Frontier {
+
+class Database;
+
+struct SyntheticDataOptions {
+    // Catalog sources; an empty path synthesizes that part instead
+    QString itemsJson;               // data/items.json
+    QString vehiclesJson;            // data/vehicles.json
+    QString buildingsJson;           // data/factory_buildings.json
+    QString recipesJson;             // tools/workbenches.json
+    int syntheticItems = 500;        // Used when itemsJson is empty
+    int syntheticRecipes = 120;      // Used when recipesJson is empty
+
+    // Volume
+    QDate endDate;                   // Defaults to today
+    int years = 3;
+    int transactionsPerDay = 20;
+    int shiftsPerWeek = 5;           // Each shift also gets a movement session
+    int productionRunsPerShift = 6;
+    int cycleRecordsPerShift = 30;
+    int fuelEntriesPerShift = 3;
+    quint32 seed = 1;                // Same seed and options give the same data
+};
+
+struct SyntheticDataStats {
+    int items = 0;
+    int vehicles = 0;
+    int buildings = 0;
+    int recipes = 0;
+    int inventoryRows = 0;
+    int transactions = 0;
+    int shifts = 0;
+    int movementSessions = 0;
+    int productionRuns = 0;
+    int cycleRecords = 0;
+    int fuelEntries = 0;
+};
+
+/**
+ * @brief Fills a freshly initialized database with years of activity
+ *
+ * Loads the catalog from the given JSON files through the regular
+ * importers, then walks the date range day by day. Each day gets sales
+ * and purchases of catalog items, and work days get a shift with a
+ * matching movement session and equipment usage, production runs of known
+ * recipes, haul cycle records and fuel entries for the fleet. Sales
+ * outweigh purchases so balances stay positive, as in a real save.
+ *
+ * Everything is written in one transaction. Generation is deterministic
+ * for a given seed so benchmark runs compare like with like.
+ */
+class SyntheticDataGenerator
+{
+public:
+    explicit SyntheticDataGenerator(Database *database);
+
+    bool generate(const SyntheticDataOptions &options);
+
+    const SyntheticDataStats &stats() const { return m_stats; }
+    QString lastError() const { return m_lastError; }
+
+    // Catalog of count items with varied categories and prices; the upper
+    // half is marked craftable
+    static QVector<Item> syntheticItems(int count);
+
+private:
+    bool loadCatalog(const SyntheticDataOptions &options);
+    void generateInventory();
+    void generateDay(const QDate &date, bool workDay, const SyntheticDataOptions &options,
+                     const QVector<int> &profileIds);
+
+    Database *m_database;
+    QRandomGenerator m_rng;
+    SyntheticDataStats m_stats;
+    QString m_lastError;
+
+    QVector<Item> m_items;
+    QVector<Vehicle> m_vehicles;
+    QVector<Recipe> m_recipes;
+};
+
+} // namespace Frontier
+
+#endif // SYNTHETICDATA_H
@@ -0,0 +1,224 @@
+/**
+ * @file tracing.cpp
+ * @brief Trace zone buffers and Chrome trace-event export
+ */
+
+#include "tracing.h"
+
+#ifdef FRONTIER_TRACING
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace Frontier {
+namespace Trace {
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *detail;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+struct ThreadBuffer {
+    QMutex mutex;                    // Only contended while a trace is written
+    int tid = 0;
+    QString threadName;
+    std::vector<Event> events;
+    qint64 dropped = 0;
+};
+
+/**
+ * @brief Every thread's buffer, kept after the thread ends so its zones
+ * still make it into the trace
+ */
+class Registry
+{
+public:
+    static Registry &instance()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    qint64 nowNs() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - m_epoch).count();
+    }
+
+    ThreadBuffer *add()
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        QThread *thread = QThread::currentThread();
+        QMutexLocker lock(&m_mutex);
+        buffer->tid = int(m_buffers.size()) + 1;
+        buffer->threadName = thread->objectName();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            buffer->threadName = QStringLiteral("GUI");
+        } else if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QStringLiteral("Thread %1").arg(buffer->tid);
+        }
+        buffer->events.reserve(4096);
+        m_buffers.push_back(std::move(buffer));
+        return m_buffers.back().get();
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn)
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const auto &buffer : m_buffers) {
+            QMutexLocker bufferLock(&buffer->mutex);
+            fn(*buffer);
+        }
+    }
+
+private:
+    Registry() : m_epoch(std::chrono::steady_clock::now()) {}
+
+    const std::chrono::steady_clock::time_point m_epoch;
+    QMutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local ThreadBuffer *buffer = Registry::instance().add();
+    return buffer;
+}
+
+QString jsonString(const char *text)
+{
+    QString out;
+    const QString str = QString::fromUtf8(text);
+    out.reserve(str.size() + 2);
+    out += QLatin1Char('"');
+    for (QChar c : str) {
+        if (c == QLatin1Char('"') || c == QLatin1Char('\\')) {
+            out += QLatin1Char('\\');
+            out += c;
+        } else if (c.unicode() < 0x20) {
+            out += QStringLiteral("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+        } else {
+            out += c;
+        }
+    }
+    out += QLatin1Char('"');
+    return out;
+}
+
+QString micros(qint64 ns)
+{
+    return QString::number(ns / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+// =============================================================================
+// Zone
+// =============================================================================
+
+Zone::Zone(const char *name, const char *detail) noexcept
+    : m_name(name)
+    , m_detail(detail)
+    , m_startNs(Registry::instance().nowNs())
+{
+}
+
+Zone::~Zone()
+{
+    const qint64 endNs = Registry::instance().nowNs();
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker lock(&buffer->mutex);
+    if (buffer->events.size() >= size_t(MaxEventsPerThread)) {
+        ++buffer->dropped;
+        return;
+    }
+    buffer->events.push_back({m_name, m_detail, m_startNs, endNs - m_startNs});
+}
+
+// =============================================================================
+// Export
+// =============================================================================
+
+bool writeChromeTrace(const QString &filePath, QString *error)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    qint64 dropped = 0;
+    Registry::instance().forEach([&](const ThreadBuffer &buffer) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.tid
+            << ",\"args\":{\"name\":" << jsonString(buffer.threadName.toUtf8().constData()) << "}}";
+        for (const Event &event : buffer.events) {
+            separator();
+            out << "{\"name\":" << jsonString(event.name)
+                << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.tid
+                << ",\"ts\":" << micros(event.startNs)
+                << ",\"dur\":" << micros(event.durationNs);
+            if (event.detail) {
+                out << ",\"args\":{\"detail\":" << jsonString(event.detail) << '}';
+            }
+            out << '}';
+        }
+        dropped += buffer.dropped;
+    });
+    out << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+    out.flush();
+
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void clear()
+{
+    Registry::instance().forEach([](ThreadBuffer &buffer) {
+        buffer.events.clear();
+        buffer.dropped = 0;
+    });
+}
+
+qint64 eventCount()
+{
+    qint64 count = 0;
+    Registry::instance().forEach([&count](const ThreadBuffer &buffer) {
+        count += qint64(buffer.events.size());
+    });
+    return count;
+}
+
+} // namespace Trace
+} // namespace Frontier
+
+#endif // FRONTIER_TRACING
@@ -0,0 +1,83 @@
+/**
+ * @file tracing.h
+ * @brief Compile-time optional trace zones, written as a Perfetto-readable timeline
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * Trace zones mark nested scopes on a per-thread timeline:
+ *
+ *     void LedgerTab::refreshData()
+ *     {
+ *         FRONTIER_TRACE_SCOPE("LedgerTab::refreshData");
+ *
+ * Zones are only compiled in with -DFRONTIER_TRACING=ON; otherwise the
+ * macros expand to nothing and cost nothing. Every ProfileScope is a zone
+ * too, so the Database methods and other timed core paths appear without
+ * a second marker. Names must be string literals (or other static text):
+ * a zone only stores the pointer.
+ *
+ * The recorded zones are written as Chrome trace-event JSON, which
+ * ui.perfetto.dev and chrome://tracing open directly.
+ */
+
+#define FRONTIER_TRACE_CONCAT_(a, b) a##b
+#define FRONTIER_TRACE_CONCAT(a, b) FRONTIER_TRACE_CONCAT_(a, b)
+
+#ifdef FRONTIER_TRACING
+
+#define FRONTIER_TRACE_SCOPE(name) \
+    ::Frontier::Trace::Zone FRONTIER_TRACE_CONCAT(frontierTraceZone, __LINE__)(name)
+// A zone with a second static string shown as its "detail" argument
+#define FRONTIER_TRACE_SCOPE_DETAIL(name, detail) \
+    ::Frontier::Trace::Zone FRONTIER_TRACE_CONCAT(frontierTraceZone, __LINE__)(name, detail)
+
+namespace Frontier {
+namespace Trace {
+
+/**
+ * @brief Records one complete event from construction to destruction
+ *
+ * Events go to a buffer owned by the recording thread, so a zone takes no
+ * shared lock; each thread keeps at most MaxEventsPerThread and counts the
+ * rest as dropped.
+ */
+class Zone
+{
+public:
+    explicit Zone(const char *name, const char *detail = nullptr) noexcept;
+    ~Zone();
+
+    Zone(const Zone &) = delete;
+    Zone &operator=(const Zone &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_detail;
+    qint64 m_startNs;
+};
+
+constexpr int MaxEventsPerThread = 1 << 20;
+
+// Every zone recorded so far, as trace-event JSON; false with error set on failure
+bool writeChromeTrace(const QString &filePath, QString *error = nullptr);
+// Drops the recorded zones of every thread
+void clear();
+qint64 eventCount();
+
+} // namespace Trace
+} // namespace Frontier
+
+#else
+
+#define FRONTIER_TRACE_SCOPE(name) static_cast<void>(0)
+#define FRONTIER_TRACE_SCOPE_DETAIL(name, detail) static_cast<void>(0)
+
+#endif // FRONTIER_TRACING
+
+#endif // TRACING_H
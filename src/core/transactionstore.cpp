@@ -0,0 +1,331 @@
+/**
+ * @file transactionstore.cpp
+ * @brief Column-wise ledger store implementation
+ */
+
+#include "transactionstore.h"
+#include "database.h"
+#include "profiler.h"
+#include "symboltable.h"
+
+#include <algorithm>
+
+namespace Frontier {
+
+namespace {
+
+// Four independent partial sums; without them the loop is one dependent
+// chain of adds that cannot be vectorized under strict IEEE rules
+double sumRange(const double *values, int begin, int end)
+{
+    double lanes[4] = {0, 0, 0, 0};
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        lanes[0] += values[i];
+        lanes[1] += values[i + 1];
+        lanes[2] += values[i + 2];
+        lanes[3] += values[i + 3];
+    }
+    double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < end; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+bool isIncomeType(TransactionType type)
+{
+    return type == TransactionType::Sale || type == TransactionType::Opening;
+}
+
+bool isExpenseType(TransactionType type)
+{
+    return type == TransactionType::Purchase || type == TransactionType::Fuel;
+}
+
+} // namespace
+
+TransactionStore::TransactionStore(Database *database)
+    : m_database(database)
+{
+}
+
+int TransactionStore::size()
+{
+    ensureLoaded();
+    return m_days.size();
+}
+
+// =============================================================================
+// Aggregates
+// =============================================================================
+
+FinanceSummary TransactionStore::summary(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("TransactionStore::summary");
+    ensureLoaded();
+
+    FinanceSummary summary;
+    int begin = 0;
+    int end = 0;
+    window(from, to, &begin, &end);
+    addSummary(summary, begin, end);
+    summary.netProfit = summary.totalIncome - summary.totalExpenses;
+    return summary;
+}
+
+QMap<QDate, FinanceSummary> TransactionStore::monthlySummaries(const QDate &from, const QDate &to)
+{
+    ProfileScope scope("TransactionStore::monthlySummaries");
+    ensureLoaded();
+
+    QMap<QDate, FinanceSummary> summaries;
+    for (QDate month(from.year(), from.month(), 1); month <= to; month = month.addMonths(1)) {
+        // Clip the first and last months to the requested range
+        const QDate monthEnd(month.year(), month.month(), month.daysInMonth());
+        int begin = 0;
+        int end = 0;
+        window(qMax(month, from), qMin(monthEnd, to), &begin, &end);
+
+        FinanceSummary &summary = summaries[month];
+        addSummary(summary, begin, end);
+        summary.netProfit = summary.totalIncome - summary.totalExpenses;
+    }
+    return summaries;
+}
+
+AccountBalance TransactionStore::balances()
+{
+    ensureLoaded();
+    return balancesOver(m_days.size());
+}
+
+AccountBalance TransactionStore::balancesAsOf(const QDate &date)
+{
+    ensureLoaded();
+    const qint32 day = qint32(date.toJulianDay());
+    const int end = int(std::upper_bound(m_days.cbegin(), m_days.cend(), day) - m_days.cbegin());
+    return balancesOver(end);
+}
+
+void TransactionStore::window(const QDate &from, const QDate &to, int *begin, int *end) const
+{
+    const qint32 first = qint32(from.toJulianDay());
+    const qint32 last = qint32(to.toJulianDay());
+    *begin = int(std::lower_bound(m_days.cbegin(), m_days.cend(), first) - m_days.cbegin());
+    *end = int(std::upper_bound(m_days.cbegin() + *begin, m_days.cend(), last) - m_days.cbegin());
+    *end = qMax(*begin, *end);
+}
+
+void TransactionStore::addSummary(FinanceSummary &summary, int begin, int end) const
+{
+    if (begin >= end) {
+        return;
+    }
+
+    summary.totalIncome += sumRange(m_income.constData(), begin, end);
+    summary.totalExpenses += sumRange(m_expenses.constData(), begin, end);
+
+    // Breakdowns accumulate into slot-indexed arrays; a category appears in
+    // a map only if it had rows of that kind, like the SQL's NULL sums
+    const int slots = m_categoryNames.size();
+    QVector<double> income(slots, 0.0);
+    QVector<double> expenses(slots, 0.0);
+    QVector<quint8> seen(slots, 0);          // Bit 0 income, bit 1 expenses
+    for (int i = begin; i < end; ++i) {
+        const int slot = m_categories[i];
+        const auto type = static_cast<TransactionType>(m_types[i]);
+        income[slot] += m_income[i];
+        expenses[slot] += m_expenses[i];
+        seen[slot] |= quint8((isIncomeType(type) ? 1 : 0) | (isExpenseType(type) ? 2 : 0));
+    }
+
+    for (int slot = 0; slot < slots; ++slot) {
+        if (seen[slot] & 1) {
+            summary.incomeByCategory[m_categoryNames[slot]] += income[slot];
+        }
+        if (seen[slot] & 2) {
+            summary.expensesByCategory[m_categoryNames[slot]] += expenses[slot];
+        }
+    }
+}
+
+AccountBalance TransactionStore::balancesOver(int end) const
+{
+    // Indexed by AccountType
+    double totals[2] = {0, 0};
+    for (int i = 0; i < end; ++i) {
+        totals[m_accounts[i]] += m_balanceDeltas[i];
+    }
+
+    AccountBalance balance;
+    balance.companyBalance = totals[int(AccountType::Company)];
+    balance.personalBalance = totals[int(AccountType::Personal)];
+    return balance;
+}
+
+// =============================================================================
+// Maintenance
+// =============================================================================
+
+void TransactionStore::insert(const Transaction &transaction)
+{
+    // After every row of an earlier day or a smaller id on the same day;
+    // a new row has the largest id, so this is normally the day's end
+    const qint32 day = qint32(transaction.date.toJulianDay());
+    const qint32 id = transaction.id.value_or(0);
+    int row = int(std::upper_bound(m_days.cbegin(), m_days.cend(), day) - m_days.cbegin());
+    while (row > 0 && m_days[row - 1] == day && m_ids[row - 1] > id) {
+        --row;
+    }
+
+    // An edited row can carry the symbol of the category it had before
+    Transaction fresh = transaction;
+    fresh.categorySymbol = SymbolTable::instance().intern(transaction.category);
+    insertRow(row, fresh);
+    m_loaded = true;
+}
+
+void TransactionStore::update(const Transaction &transaction)
+{
+    // The date may have changed, so the row moves to its new place
+    const int row = rowOf(transaction.id.value_or(0));
+    if (row >= 0) {
+        removeRow(row);
+    }
+    insert(transaction);
+}
+
+void TransactionStore::remove(int id)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        removeRow(row);
+    }
+    m_loaded = true;
+}
+
+void TransactionStore::invalidate(DataTables tables)
+{
+    if (tables & DataTable::Transactions) {
+        m_loaded = false;
+    }
+}
+
+qint64 TransactionStore::estimatedBytes() const
+{
+    if (!m_loaded) {
+        return 0;
+    }
+    return estimateBytes(m_days) + estimateBytes(m_ids) + estimateBytes(m_types)
+           + estimateBytes(m_accounts) + estimateBytes(m_categories) + estimateBytes(m_quantities)
+           + estimateBytes(m_income) + estimateBytes(m_expenses) + estimateBytes(m_balanceDeltas)
+           + estimateBytes(m_slotBySymbol) + estimateBytes(m_categoryNames);
+}
+
+void TransactionStore::clear()
+{
+    m_days.clear();
+    m_ids.clear();
+    m_types.clear();
+    m_accounts.clear();
+    m_categories.clear();
+    m_quantities.clear();
+    m_income.clear();
+    m_expenses.clear();
+    m_balanceDeltas.clear();
+    m_slotBySymbol.clear();
+    m_categoryNames.clear();
+}
+
+void TransactionStore::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+
+    ProfileScope scope("TransactionStore::load");
+    clear();
+
+    QVector<Transaction> transactions = m_database->getAllTransactions();
+    std::sort(transactions.begin(), transactions.end(), [](const Transaction &a, const Transaction &b) {
+        if (a.date != b.date) {
+            return a.date < b.date;
+        }
+        return a.id.value_or(0) < b.id.value_or(0);
+    });
+
+    const int count = transactions.size();
+    m_days.reserve(count);
+    m_ids.reserve(count);
+    m_types.reserve(count);
+    m_accounts.reserve(count);
+    m_categories.reserve(count);
+    m_quantities.reserve(count);
+    m_income.reserve(count);
+    m_expenses.reserve(count);
+    m_balanceDeltas.reserve(count);
+    for (const Transaction &transaction : transactions) {
+        insertRow(m_days.size(), transaction);
+    }
+
+    m_loaded = true;
+}
+
+int TransactionStore::categorySlot(Symbol category, const QString &name)
+{
+    auto it = m_slotBySymbol.constFind(category);
+    if (it != m_slotBySymbol.constEnd()) {
+        return it.value();
+    }
+    const int slot = m_categoryNames.size();
+    m_categoryNames.append(name.isEmpty() ? QStringLiteral("Uncategorized") : name);
+    m_slotBySymbol.insert(category, slot);
+    return slot;
+}
+
+void TransactionStore::insertRow(int row, const Transaction &transaction)
+{
+    // Rows read back from SQL are already interned; fresh ones may not be
+    const Symbol category = transaction.categorySymbol != 0 || transaction.category.isEmpty()
+        ? transaction.categorySymbol
+        : SymbolTable::instance().intern(transaction.category);
+    const double amount = transaction.totalAmount;
+
+    double delta = 0;
+    if (isIncomeType(transaction.type) || transaction.type == TransactionType::Transfer) {
+        delta = amount;
+    } else if (isExpenseType(transaction.type)) {
+        delta = -amount;
+    }
+
+    m_days.insert(row, qint32(transaction.date.toJulianDay()));
+    m_ids.insert(row, transaction.id.value_or(0));
+    m_types.insert(row, quint8(transaction.type));
+    m_accounts.insert(row, quint8(transaction.account));
+    m_categories.insert(row, categorySlot(category, transaction.category));
+    m_quantities.insert(row, transaction.quantity);
+    m_income.insert(row, isIncomeType(transaction.type) ? amount : 0.0);
+    m_expenses.insert(row, isExpenseType(transaction.type) ? amount : 0.0);
+    m_balanceDeltas.insert(row, delta);
+}
+
+void TransactionStore::removeRow(int row)
+{
+    m_days.remove(row);
+    m_ids.remove(row);
+    m_types.remove(row);
+    m_accounts.remove(row);
+    m_categories.remove(row);
+    m_quantities.remove(row);
+    m_income.remove(row);
+    m_expenses.remove(row);
+    m_balanceDeltas.remove(row);
+}
+
+int TransactionStore::rowOf(int id) const
+{
+    return int(m_ids.indexOf(qint32(id)));
+}
+
+} // namespace Frontier
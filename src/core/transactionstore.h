@@ -0,0 +1,100 @@
+/**
+ * @file transactionstore.h
+ * @brief Column-wise in-memory copy of the ledger for report aggregates
+ */
+
+#ifndef TRANSACTIONSTORE_H
+#define TRANSACTIONSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDate>
+
+#include "types.h"
+#include "datachangebus.h"
+
+namespace Frontier {
+
+class Database;
+
+/**
+ * @brief The transactions table as parallel arrays, sorted by date
+ *
+ * Each column (day number, type, account, category, quantity, amount)
+ * is its own contiguous array, so an aggregate touches only the columns
+ * it needs. A date window is found by binary search on the day column,
+ * and sums run over plain double arrays with independent accumulators
+ * the compiler can vectorize. Income and expense amounts are split into
+ * their own columns at load, so totals need no per-row type test.
+ *
+ * Loaded on first use. Single-row adds, updates and deletes patch a
+ * loaded store in place; any other write to the ledger invalidates it
+ * through Database::markDirty() and the next aggregate reloads it.
+ *
+ * Figures match Database::getFinanceSummary() and calculateBalances():
+ * income is Sale and Opening, expenses are Purchase and Fuel, transfers
+ * count toward balances only. Owned by Database and used on its thread.
+ */
+class TransactionStore
+{
+public:
+    explicit TransactionStore(Database *database);
+
+    int size();
+
+    // === Aggregates ===
+    FinanceSummary summary(const QDate &from, const QDate &to);
+    // Every month in the range gets an entry, as in getFinanceSummariesByMonth()
+    QMap<QDate, FinanceSummary> monthlySummaries(const QDate &from, const QDate &to);
+    AccountBalance balances();
+    AccountBalance balancesAsOf(const QDate &date);
+
+    // === Maintenance ===
+    // Mirror a single-row write, with its id. Only for a store that was
+    // loaded before the write's markDirty(): patched, it matches the table
+    // again and counts as loaded.
+    void insert(const Transaction &transaction);
+    void update(const Transaction &transaction);
+    void remove(int id);
+    void invalidate(DataTables tables);
+    bool isLoaded() const { return m_loaded; }
+
+    // Approximate heap use; 0 until loaded
+    qint64 estimatedBytes() const;
+
+private:
+    void ensureLoaded();
+    void clear();
+    int categorySlot(Symbol category, const QString &name);
+    void insertRow(int row, const Transaction &transaction);
+    void removeRow(int row);
+    int rowOf(int id) const;             // Linear; -1 when absent
+    // Rows [begin, end) whose day falls in [from, to]
+    void window(const QDate &from, const QDate &to, int *begin, int *end) const;
+    void addSummary(FinanceSummary &summary, int begin, int end) const;
+    AccountBalance balancesOver(int end) const;
+
+    Database *m_database;
+    bool m_loaded = false;
+
+    // One entry per transaction, ordered by (day, id)
+    QVector<qint32> m_days;              // QDate::toJulianDay()
+    QVector<qint32> m_ids;
+    QVector<quint8> m_types;             // TransactionType
+    QVector<quint8> m_accounts;          // AccountType
+    QVector<qint32> m_categories;        // Slot in m_categoryNames
+    QVector<qint32> m_quantities;
+    QVector<double> m_income;            // total_amount for Sale/Opening, else 0
+    QVector<double> m_expenses;          // total_amount for Purchase/Fuel, else 0
+    QVector<double> m_balanceDeltas;     // Signed effect on the account balance
+
+    // Dense category slots so breakdowns index arrays instead of hashing
+    QHash<Symbol, int> m_slotBySymbol;
+    QVector<QString> m_categoryNames;    // Empty category reads "Uncategorized"
+};
+
+} // namespace Frontier
+
+#endif // TRANSACTIONSTORE_H
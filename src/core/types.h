@@ -10,6 +10,8 @@
 #include <QDateTime>
 #include <QVector>
 #include <optional>
+#include <algorithm>
+#include <cmath>
 
 namespace Frontier {
 
@@ -40,6 +42,17 @@ enum class UnitSystem {
     Imperial    // yd³, gallons, miles
 };
 
+enum class StorageProfile {
+    Safe,       // Rollback journal, full sync - SQLite defaults
+    Balanced,   // WAL, normal sync, larger cache and mmap
+    Fast        // WAL, no sync - fastest, may lose recent writes on power loss
+};
+
+enum class MovementEventKind {
+    Bucket,     // A loader or excavator bucket into a truck
+    Dump        // A haul truck dump at the hopper
+};
+
 // === Helper Functions ===
 
 inline double calculateSellPrice(double buyPrice, PricingGroup group) {
@@ -54,6 +67,10 @@ inline double calculateSellPrice(double buyPrice, PricingGroup group) {
 
 // === Data Structures ===
 
+// Id of an interned name or category (see symboltable.h); 0 is the empty
+// string. Loaders fill the *Symbol fields alongside the strings.
+using Symbol = quint32;
+
 struct Item {
     std::optional<int> id;
     QString code;           // "100001"
@@ -97,6 +114,8 @@ struct Transaction {
     double unitPrice;
     double totalAmount;
     QString notes;
+    Symbol itemSymbol = 0;
+    Symbol categorySymbol = 0;
 
     // Helper to check if this is income (Sale) vs expense (Purchase/Fuel)
     bool isIncome() const {
@@ -104,6 +123,36 @@ struct Transaction {
     }
 };
 
+// Filter for Database::queryTransactions. Empty/unset fields don't filter.
+struct TransactionQuery {
+    QDate from;
+    QDate to;
+    std::optional<TransactionType> type;
+    std::optional<AccountType> account;
+    QString category;
+    QString search;             // Item name words by prefix (substring without the search index)
+    int limit = -1;             // -1 = no limit
+    int offset = 0;
+};
+
+// Aggregates over every row matching a TransactionQuery (ignores paging)
+struct TransactionTotals {
+    int count = 0;
+    double companyIncome = 0.0;
+    double personalIncome = 0.0;
+    double companyExpenses = 0.0;
+    double personalExpenses = 0.0;
+
+    double totalIncome() const { return companyIncome + personalIncome; }
+    double totalExpenses() const { return companyExpenses + personalExpenses; }
+};
+
+// One row of Database::getRecentTransactions
+struct RecentTransaction {
+    Transaction transaction;
+    double balanceAfter = 0.0;      // Combined balance once this row is applied
+};
+
 struct Vehicle {
     QString id;                     // Primary key, e.g. "ARVIK_L9"
     QString name;                   // Display name, e.g. "Arvik L9"
@@ -144,6 +193,27 @@ struct FuelLogEntry {
     QString notes;
 };
 
+// One (day, equipment) row of the fuel_daily_rollup table
+struct FuelDailyTotal {
+    QDate date;                     // Invalid when summed over several days
+    QString equipmentId;            // Empty for entries without equipment
+    double liters = 0;
+    double totalCost = 0;
+    int entries = 0;
+    int days = 0;                   // Days with fuel entries in the sum
+
+    double litersPerDay() const { return days > 0 ? liters / days : 0; }
+};
+
+// Liters against hours run, over the fuel_log entries that logged hours
+struct FuelHours {
+    QString equipmentId;
+    QDate date;                     // Invalid when summed over every day
+    double liters = 0;
+    double hours = 0;
+    int entries = 0;
+};
+
 struct MovementSession {
     std::optional<int> id;
     QDateTime startTime;
@@ -167,6 +237,35 @@ struct MovementEquipmentUsage {
     double volumeM3 = 0;
 };
 
+// One bucket or dump captured live during a session (see movementcapture.h)
+struct MovementEvent {
+    std::optional<int> id;
+    int sessionId = 0;              // FK to MovementSession.id
+    QString equipmentId;            // FK to Vehicle.id
+    MovementEventKind kind = MovementEventKind::Bucket;
+    QDateTime time;
+};
+
+// Filter for Database::queryMovementSessions. Newest first.
+struct MovementSessionQuery {
+    QString search;             // Substring of map name or notes, or "#id"
+    int limit = -1;             // -1 = no limit
+    int offset = 0;
+};
+
+// A session with its equipment usage totalled in SQL; volume comes from
+// the vehicles' bucket and truck capacities as calculateVolume() does
+struct MovementSessionSummary {
+    MovementSession session;
+    int usageCount = 0;
+    double loaderVolumeM3 = 0;      // Loaders and excavators
+    double truckVolumeM3 = 0;       // Haul trucks
+    double fuelL = 0;
+    double hours = 0;
+
+    double totalVolumeM3() const { return loaderVolumeM3 + truckVolumeM3; }
+};
+
 // === Recipe Types ===
 
 struct Workbench {
@@ -179,6 +278,7 @@ struct RecipeIngredient {
     int recipeId = 0;
     QString itemName;               // Input item name
     int quantity = 1;
+    Symbol itemSymbol = 0;
 };
 
 struct Recipe {
@@ -189,6 +289,8 @@ struct Recipe {
     int outputQty = 1;
     QString notes;                  // e.g., "Rough Concrete", "Quest item"
     QVector<RecipeIngredient> ingredients;
+    Symbol workbenchSymbol = 0;
+    Symbol outputSymbol = 0;
 
     // Computed at runtime for cost analysis
     double inputCost = 0;
@@ -220,6 +322,8 @@ struct Location {
     QString mapAbbrev;
     QString mapName;
     QString typeName;
+    Symbol mapSymbol = 0;
+    Symbol typeSymbol = 0;
 };
 
 // === Inventory Items ===
@@ -237,6 +341,9 @@ struct InventoryItem {
     QString category;
     double unitPrice = 0.0;
     QString locationName;
+    Symbol itemSymbol = 0;
+    Symbol categorySymbol = 0;
+    Symbol locationSymbol = 0;
 
     // Computed fields
     double totalValue() const { return quantity * unitPrice; }
@@ -314,6 +421,31 @@ struct Shift {
     }
 };
 
+// Filter, order and paging for shift history reads
+struct ShiftQuery {
+    enum class OrderBy { StartTime, StartTimeOfDay, EndTime, Duration, Weather, Activities };
+
+    OrderBy orderBy = OrderBy::StartTime;
+    bool descending = true;
+    int limit = -1;             // -1 = no limit
+    int offset = 0;
+};
+
+enum class ShiftPeriod { Day, Week, Month };
+
+// Aggregates over a set of shifts; ongoing shifts count but add no minutes
+struct ShiftTotals {
+    QDate periodStart;          // First day of the bucket; invalid for overall totals
+    int shiftCount = 0;
+    int completedCount = 0;
+    int totalMinutes = 0;
+    int longestMinutes = 0;
+
+    double avgMinutes() const {
+        return completedCount > 0 ? static_cast<double>(totalMinutes) / completedCount : 0.0;
+    }
+};
+
 // === Cycle Time ===
 
 struct CycleProfile {
@@ -334,6 +466,12 @@ struct CycleProfile {
     int avgTotalSeconds = 0;
     int bestTotalSeconds = 0;
     int worstTotalSeconds = 0;
+    int p50TotalSeconds = 0;    // Median cycle
+    int p90TotalSeconds = 0;    // 90% of cycles are this fast or faster
+    int avgLoadSeconds = 0;
+    int avgHaulSeconds = 0;
+    int avgDumpSeconds = 0;
+    int avgReturnSeconds = 0;
 };
 
 struct CycleRecord {
@@ -366,6 +504,74 @@ struct CycleRecord {
     }
 };
 
+// Running statistics over one profile's records. add() keeps them current
+// as records are logged; totals stay sorted so percentiles are exact.
+struct CycleStats {
+    int count = 0;
+    qint64 loadSum = 0;
+    qint64 haulSum = 0;
+    qint64 dumpSum = 0;
+    qint64 returnSum = 0;
+    qint64 totalSum = 0;
+    QVector<int> sortedTotals;  // Ascending
+
+    void add(const CycleRecord &record) {
+        ++count;
+        loadSum += record.loadSeconds;
+        haulSum += record.haulSeconds;
+        dumpSum += record.dumpSeconds;
+        returnSum += record.returnSeconds;
+        totalSum += record.totalSeconds;
+        sortedTotals.insert(std::upper_bound(sortedTotals.begin(), sortedTotals.end(),
+                                             record.totalSeconds) - sortedTotals.begin(),
+                            record.totalSeconds);
+    }
+
+    // Takes back a record passed to add() earlier
+    void remove(const CycleRecord &record) {
+        auto it = std::lower_bound(sortedTotals.begin(), sortedTotals.end(), record.totalSeconds);
+        if (it == sortedTotals.end() || *it != record.totalSeconds) {
+            return;
+        }
+        sortedTotals.erase(it);
+        --count;
+        loadSum -= record.loadSeconds;
+        haulSum -= record.haulSeconds;
+        dumpSum -= record.dumpSeconds;
+        returnSum -= record.returnSeconds;
+        totalSum -= record.totalSeconds;
+    }
+
+    // 1-based nearest rank of percentile p (0 < p <= 1) among count values
+    static int percentileRank(double p, int count) {
+        return qBound(1, static_cast<int>(std::ceil(p * count)), count);
+    }
+
+    int percentile(double p) const {
+        return count > 0 ? sortedTotals[percentileRank(p, count) - 1] : 0;
+    }
+
+    void applyTo(CycleProfile &profile) const {
+        profile.recordCount = count;
+        if (count == 0) {
+            profile.avgTotalSeconds = profile.bestTotalSeconds = profile.worstTotalSeconds = 0;
+            profile.p50TotalSeconds = profile.p90TotalSeconds = 0;
+            profile.avgLoadSeconds = profile.avgHaulSeconds = 0;
+            profile.avgDumpSeconds = profile.avgReturnSeconds = 0;
+            return;
+        }
+        profile.avgTotalSeconds = static_cast<int>(totalSum / count);
+        profile.bestTotalSeconds = sortedTotals.first();
+        profile.worstTotalSeconds = sortedTotals.last();
+        profile.p50TotalSeconds = percentile(0.5);
+        profile.p90TotalSeconds = percentile(0.9);
+        profile.avgLoadSeconds = static_cast<int>(loadSum / count);
+        profile.avgHaulSeconds = static_cast<int>(haulSum / count);
+        profile.avgDumpSeconds = static_cast<int>(dumpSum / count);
+        profile.avgReturnSeconds = static_cast<int>(returnSum / count);
+    }
+};
+
 // =============================================================================
 // Account Balance tracking
 // =============================================================================
@@ -377,6 +583,16 @@ struct AccountBalance {
     double total() const { return companyBalance + personalBalance; }
 };
 
+// One closed year moved to its own archive file (see Database::archiveYear)
+struct ArchivedYear {
+    int year = 0;
+    int transactions = 0;
+    int fuelEntries = 0;
+    int productionRuns = 0;
+    AccountBalance carriedForward;  // Balances at the end of the year
+    QDateTime archivedAt;
+};
+
 struct FinanceSummary {
     double totalIncome = 0.0;
     double totalExpenses = 0.0;
@@ -396,6 +612,28 @@ struct Budget {
     QString notes;
 };
 
+// Budgeted against actual spend (purchases and fuel) for one category and month
+struct BudgetCell {
+    double budgeted = 0.0;
+    double actual = 0.0;
+    double variance = 0.0;          // budgeted - actual; negative is overspent
+
+    int usedPercent() const { return budgeted > 0 ? static_cast<int>(actual / budgeted * 100) : 0; }
+};
+
+// Category x month grid from Database::getBudgetMatrix(). Categories with
+// spend but no budget are included, so unplanned spending shows up too.
+struct BudgetMatrix {
+    QVector<QDate> months;          // First day of each month in the range
+    QStringList categories;         // Sorted
+    QVector<BudgetCell> cells;      // Category-major: cells[category * months.size() + month]
+    QVector<BudgetCell> categoryTotals;
+    QVector<BudgetCell> monthTotals;
+    BudgetCell total;
+
+    const BudgetCell &cell(int category, int month) const { return cells[category * months.size() + month]; }
+};
+
 struct FactoryBuilding {
     std::optional<int> id;
     QString name;
@@ -435,6 +673,57 @@ struct FacilityPlanItem {
     double totalGeneratedKw = 0;
 };
 
+// Cost and power totals over capital plan lines
+struct PlanTotals {
+    int lineCount = 0;
+    int unitCount = 0;
+    double cost = 0.0;
+    double powerKw = 0.0;
+    double generatedKw = 0.0;
+
+    double powerBalanceKw() const { return generatedKw - powerKw; }
+
+    PlanTotals &operator+=(const PlanTotals &other) {
+        lineCount += other.lineCount;
+        unitCount += other.unitCount;
+        cost += other.cost;
+        powerKw += other.powerKw;
+        generatedKw += other.generatedKw;
+        return *this;
+    }
+
+    PlanTotals &operator-=(const PlanTotals &other) {
+        lineCount -= other.lineCount;
+        unitCount -= other.unitCount;
+        cost -= other.cost;
+        powerKw -= other.powerKw;
+        generatedKw -= other.generatedKw;
+        return *this;
+    }
+};
+
+// =============================================================================
+// Differential import
+// =============================================================================
+
+// Row counts from a differential re-import of one table
+struct ImportDiff {
+    int inserted = 0;
+    int updated = 0;
+    int deleted = 0;
+    int unchanged = 0;
+
+    int changed() const { return inserted + updated + deleted; }
+
+    ImportDiff &operator+=(const ImportDiff &other) {
+        inserted += other.inserted;
+        updated += other.updated;
+        deleted += other.deleted;
+        unchanged += other.unchanged;
+        return *this;
+    }
+};
+
 } // namespace Frontier
 
 #endif // TYPES_H
@@ -4,14 +4,11 @@
  */
 
 #include "vehicleimporter.h"
+#include "jsonstreamreader.h"
+#include "tracing.h"
 
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonArray>
 #include <QJsonObject>
 #include <QDebug>
-#include <QSqlQuery>
-#include <QSqlError>
 
 namespace Frontier {
 
@@ -25,78 +22,51 @@ int VehicleImporter::importFromJson(const QString &jsonPath, Database *database,
         return -1;
     }
 
+    return importVehicles(vehicles, database, clearExisting);
+}
+
+int VehicleImporter::importVehicles(const QVector<Vehicle> &vehicles, Database *database,
+                                    bool clearExisting)
+{
+    FRONTIER_TRACE_SCOPE("VehicleImporter::importVehicles");
+    if (vehicles.isEmpty()) {
+        return -1;
+    }
+
+    if (!database->beginTransaction()) {
+        return -1;
+    }
+
     // Optionally clear existing vehicles
     if (clearExisting) {
-        auto existing = database->getAllVehicles(false);
-        for (const auto &v : existing) {
-            database->deleteVehicle(v.id);
+        if (!database->clearAllVehicles()) {
+            database->rollbackTransaction();
+            return -1;
         }
-        qInfo() << "Cleared" << existing.size() << "existing vehicles";
+        qInfo() << "Cleared existing vehicles";
     }
 
-    int imported = 0;
-    int skipped = 0;
-
-    for (const auto &vehicle : vehicles) {
-        // Check if vehicle already exists
-        auto existing = database->getVehicle(vehicle.id);
-
-        if (existing.has_value()) {
-            // Update existing
-            if (database->updateVehicle(vehicle)) {
-                imported++;
-            } else {
-                qWarning() << "Failed to update vehicle:" << vehicle.id;
-                skipped++;
-            }
-        } else {
-            // Add new
-            if (database->addVehicle(vehicle)) {
-                imported++;
-            } else {
-                qWarning() << "Failed to add vehicle:" << vehicle.id;
-                skipped++;
-            }
-        }
+    // Insert new vehicles and update existing ones by id
+    int imported = database->upsertVehicles(vehicles);
+
+    if (imported < 0 || !database->commitTransaction()) {
+        database->rollbackTransaction();
+        return -1;
     }
 
+    int skipped = vehicles.size() - imported;
+
     qInfo() << "Vehicle import complete:" << imported << "imported," << skipped << "skipped";
     return imported;
 }
 
 QVector<Vehicle> VehicleImporter::loadFromJson(const QString &jsonPath)
 {
+    FRONTIER_TRACE_SCOPE("VehicleImporter::loadFromJson");
     QVector<Vehicle> vehicles;
 
-    QFile file(jsonPath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open vehicle file:" << jsonPath;
-        return vehicles;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parse error:" << error.errorString();
-        return vehicles;
-    }
-
-    if (!doc.isArray()) {
-        qWarning() << "Expected JSON array in vehicle file";
-        return vehicles;
-    }
-
-    QJsonArray array = doc.array();
-
-    for (const QJsonValue &value : array) {
-        if (!value.isObject()) continue;
-
-        QJsonObject obj = value.toObject();
-
+    JsonStreamReader reader(jsonPath);
+    bool ok = reader.readArray([&vehicles](const QJsonObject &obj) {
         Vehicle vehicle;
         vehicle.id = obj["id"].toString();
         vehicle.name = obj["name"].toString();
@@ -111,6 +81,12 @@ QVector<Vehicle> VehicleImporter::loadFromJson(const QString &jsonPath)
         vehicle.notes = obj["notes"].toString();
 
         vehicles.append(vehicle);
+        return true;
+    });
+
+    if (!ok) {
+        qWarning() << "Could not load vehicles from" << jsonPath << ":" << reader.errorString();
+        return {};
     }
 
     qInfo() << "Loaded" << vehicles.size() << "vehicles from JSON";
@@ -26,6 +26,10 @@ public:
     static int importFromJson(const QString &jsonPath, Database *database,
                               bool clearExisting = true);
 
+    // Write half of importFromJson, for vehicles that were already loaded
+    static int importVehicles(const QVector<Vehicle> &vehicles, Database *database,
+                              bool clearExisting = true);
+
     /**
      * @brief Load vehicles from JSON file (without importing to DB)
      * @param jsonPath Path to vehicles.json
@@ -1,5 +1,7 @@
 #include "ui/mainwindow.h"
 #include "core/database.h"
+#include "core/profileregistry.h"
+#include "core/tracing.h"
 
 #include <QApplication>
 #include <QDebug>
@@ -13,21 +15,49 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationName("Frontier");
     QCoreApplication::setApplicationVersion("1.0.0");
 
-    // Initialize database (this connects AND creates tables)
+    // Initialize database (this connects AND creates tables). The profile
+    // last used has its own file; reference data is shared through the catalog.
+    const Frontier::TrackerProfile profile = Frontier::ProfileRegistry::current();
     Frontier::Database db;
-    if (!db.initialize("frontier_mining.db")) {
+    db.setCatalogPath(Frontier::ProfileRegistry::catalogPath());
+    if (!db.initialize(profile.databasePath)) {
         qDebug() << "Failed to initialize database:" << db.lastError();
         return 1;
     }
 
     // Show database status
-    auto items = db.getAllItems();
+    // Count only; the item catalog loads on first use, from the reference
+    // snapshot when one is current
+    const int itemCount = db.getItemCount();
     qDebug() << "";
     qDebug() << "=== Frontier Mining Tracker ===";
-    qDebug() << "Database connected:" << items.size() << "items loaded";
+    qDebug() << "Profile:" << profile.name << "(" << profile.databasePath << ")";
+    qDebug() << "Database connected:" << itemCount << "items"
+             << (db.referenceSnapshot() ? "(reference snapshot)" : "");
     qDebug() << "================================";
     qDebug() << "";
 
+    // Queued edits are written while the windows still exist; close()
+    // flushes again as a last resort
+    QObject::connect(&a, &QCoreApplication::aboutToQuit,
+                     &db, &Frontier::Database::flushPendingWrites);
+
+#ifdef FRONTIER_TRACING
+    // The zones of the whole session, written once the windows have gone
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, []() {
+        QString path = qEnvironmentVariable("FRONTIER_TRACE_FILE");
+        if (path.isEmpty()) {
+            path = QStringLiteral("frontier-trace.json");
+        }
+        QString error;
+        if (Frontier::Trace::writeChromeTrace(path, &error)) {
+            qDebug() << "Trace written to" << path;
+        } else {
+            qWarning() << "Failed to write trace" << path << ":" << error;
+        }
+    });
+#endif
+
     // Pass database to MainWindow
     MainWindow w(&db);
     w.show();
@@ -5,6 +5,7 @@
 
 #include "accountstab.h"
 #include "core/database.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -32,7 +33,9 @@ AccountsTab::AccountsTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
-    refreshData();
+    // First load waits until the tab is first shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Transactions,
+                                      [this]() { refreshData(); }, true);
 }
 
 void AccountsTab::setupUi()
@@ -176,6 +179,8 @@ QWidget* AccountsTab::createBalanceCard(const QString &title, QLabel **valueLabe
 
 void AccountsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("AccountsTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     updateBalances();
 
     // Load recent transfers
@@ -13,27 +13,39 @@
 #include <QMessageBox>
 #include <QGroupBox>
 #include <QSplitter>
-#include <QFile>
-#include <QDataStream>
-#include <QRegularExpression>
+#include <QFileInfo>
+#include <QTime>
+#include <QSet>
+#include <QInputDialog>
+#include <QtConcurrent/QtConcurrentMap>
 
-// Scale factor for monetary values in save file
-const int MONEY_SCALE = 256;
+#include "core/itemcatalog.h"
+#include "core/commandjournal.h"
+#include "core/tracing.h"
 
 AuditorWidget::AuditorWidget(Frontier::Database *database, QWidget *parent)
     : QWidget{parent}
     , m_database(database)
     , m_transactionsModel(nullptr)
     , m_validationModel(nullptr)
-
+    , m_saveWatcher(new Frontier::SaveWatcher(this))
 {
-    m_parsedData.valid = false;  // Add this
+    connect(m_saveWatcher, &Frontier::SaveWatcher::saveParsed,
+            this, &AuditorWidget::onWatchedSaveParsed);
+    connect(m_saveWatcher, &Frontier::SaveWatcher::parseFailed,
+            this, &AuditorWidget::onWatchedSaveFailed);
+    connect(&m_timelineParse, &QFutureWatcher<Frontier::SaveSnapshot>::finished,
+            this, &AuditorWidget::onTimelineParsed);
+
     setupUi();
     loadSettings();
 }
 
 AuditorWidget::~AuditorWidget()
 {
+    // Parse tasks only read their own files, but let them finish first
+    m_timelineParse.cancel();
+    m_timelineParse.waitForFinished();
 }
 
 void AuditorWidget::setupUi()
@@ -47,6 +59,7 @@ void AuditorWidget::setupUi()
     // Add Tabs
     m_subTabs->addTab(createSaveParserTab(), "Save Parser");
     m_subTabs->addTab(createValidationTab(), "Validation");
+    m_subTabs->addTab(createTimelineTab(), "Timeline");
     m_subTabs->addTab(createSettingsTab(), "Settings");
 
     mainLayout->addWidget(m_subTabs);
@@ -157,10 +170,17 @@ QWidget* AuditorWidget::createValidationTab()
     connect(validateButton, &QPushButton::clicked,
             this, &AuditorWidget::onRunValidation);
 
+    m_ingestButton = new QPushButton("Ingest Unmatched...");
+    m_ingestButton->setToolTip("Add the save entries missing from the ledger as ledger transactions");
+    m_ingestButton->setEnabled(false);
+    connect(m_ingestButton, &QPushButton::clicked,
+            this, &AuditorWidget::onIngestUnmatched);
+
     m_validationSummaryLabel = new QLabel("Load a save file first, then run validation to compare with ledger.");
     m_validationSummaryLabel->setWordWrap(true);
 
     controlLayout->addWidget(validateButton);
+    controlLayout->addWidget(m_ingestButton);
     controlLayout->addWidget(m_validationSummaryLabel, 1);
 
     mainLayout->addWidget(controlGroup);
@@ -204,6 +224,82 @@ QWidget* AuditorWidget::createValidationTab()
     return validationTab;
 }
 
+QWidget* AuditorWidget::createTimelineTab()
+{
+    QWidget *timelineTab = new QWidget();
+    QVBoxLayout *mainLayout = new QVBoxLayout(timelineTab);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+    mainLayout->setSpacing(10);
+
+    // === Batch Selection ===
+    QGroupBox *batchGroup = new QGroupBox("Save Batch");
+    QHBoxLayout *batchLayout = new QHBoxLayout(batchGroup);
+
+    QPushButton *addFilesButton = new QPushButton("Add Saves...");
+    QPushButton *addFolderButton = new QPushButton("Add Save Folder");
+    addFolderButton->setToolTip("Every save in the default save folder and its slot folders");
+    QPushButton *clearButton = new QPushButton("Clear");
+    m_timelineRunButton = new QPushButton("Build Timeline");
+    m_timelineRunButton->setEnabled(false);
+
+    m_timelineFilesLabel = new QLabel("No saves selected.");
+
+    m_timelineProgress = new QProgressBar();
+    m_timelineProgress->setVisible(false);
+    m_timelineProgress->setMaximumWidth(200);
+
+    batchLayout->addWidget(addFilesButton);
+    batchLayout->addWidget(addFolderButton);
+    batchLayout->addWidget(clearButton);
+    batchLayout->addWidget(m_timelineFilesLabel, 1);
+    batchLayout->addWidget(m_timelineProgress);
+    batchLayout->addWidget(m_timelineRunButton);
+
+    mainLayout->addWidget(batchGroup);
+
+    // === Timeline Table ===
+    QGroupBox *resultsGroup = new QGroupBox("Money and Transactions Between Saves");
+    QVBoxLayout *resultsLayout = new QVBoxLayout(resultsGroup);
+
+    m_timelineTable = new QTableView();
+    m_timelineTable->setAlternatingRowColors(true);
+    m_timelineTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_timelineTable->horizontalHeader()->setStretchLastSection(true);
+    m_timelineTable->verticalHeader()->setVisible(false);
+
+    m_timelineModel = new QStandardItemModel(this);
+    m_timelineModel->setHorizontalHeaderLabels({
+        "Save", "Saved At", "Money", "Money Change", "New Transactions",
+        "Transaction Total", "Unexplained", "In Ledger", "Issues"
+    });
+    m_timelineTable->setModel(m_timelineModel);
+
+    resultsLayout->addWidget(m_timelineTable);
+
+    m_timelineSummaryLabel = new QLabel("Add saves of one map, then build the timeline to "
+                                        "reconcile every step against the ledger.");
+    m_timelineSummaryLabel->setWordWrap(true);
+    resultsLayout->addWidget(m_timelineSummaryLabel);
+
+    mainLayout->addWidget(resultsGroup, 1);
+
+    // === Connect Signals ===
+    connect(addFilesButton, &QPushButton::clicked, this, &AuditorWidget::onAddTimelineSaves);
+    connect(addFolderButton, &QPushButton::clicked, this, &AuditorWidget::onAddTimelineFolder);
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        m_timelineFiles.clear();
+        m_timelineFilesLabel->setText("No saves selected.");
+        m_timelineRunButton->setEnabled(false);
+    });
+    connect(m_timelineRunButton, &QPushButton::clicked, this, &AuditorWidget::onRunTimeline);
+    connect(&m_timelineParse, &QFutureWatcher<Frontier::SaveSnapshot>::progressRangeChanged,
+            m_timelineProgress, &QProgressBar::setRange);
+    connect(&m_timelineParse, &QFutureWatcher<Frontier::SaveSnapshot>::progressValueChanged,
+            m_timelineProgress, &QProgressBar::setValue);
+
+    return timelineTab;
+}
+
 QWidget* AuditorWidget::createSettingsTab()
 {
     QWidget *settingsTab = new QWidget();
@@ -245,15 +341,22 @@ QWidget* AuditorWidget::createSettingsTab()
     m_autoParseCheckbox = new QCheckBox("Auto-parse when file is selected");
     optionsLayout->addRow("", m_autoParseCheckbox);
 
+    m_watchSavesCheckbox = new QCheckBox("Watch save folder and audit new saves automatically");
+    m_watchSavesCheckbox->setToolTip("Reparses the newest save in the default folder whenever the game "
+                                     "writes one, and validates only the new transactions.");
+    optionsLayout->addRow("", m_watchSavesCheckbox);
+
     m_showRawDataCheckbox = new QCheckBox("Show raw data debug panel");
     m_showRawDataCheckbox->setChecked(true);
     optionsLayout->addRow("", m_showRawDataCheckbox);
 
     m_maxTransactionsSpin = new QSpinBox();
-    m_maxTransactionsSpin->setRange(10, 500);
+    m_maxTransactionsSpin->setRange(10, 100000);
     m_maxTransactionsSpin->setValue(50);
     m_maxTransactionsSpin->setSuffix(" transactions");
-    optionsLayout->addRow("Max transactions to parse:", m_maxTransactionsSpin);
+    m_maxTransactionsSpin->setToolTip("The whole history is always parsed and validated; "
+                                      "this only limits the rows listed.");
+    optionsLayout->addRow("Max transactions to show:", m_maxTransactionsSpin);
 
     mainLayout->addWidget(optionsGroup);
 
@@ -274,6 +377,7 @@ QWidget* AuditorWidget::createSettingsTab()
     connect(resetBtn, &QPushButton::clicked, this, [this]() {
         m_defaultSavePathEdit->clear();
         m_autoParseCheckbox->setChecked(false);
+        m_watchSavesCheckbox->setChecked(false);
         m_showRawDataCheckbox->setChecked(true);
         m_maxTransactionsSpin->setValue(50);
         saveSettings();
@@ -295,6 +399,8 @@ QWidget* AuditorWidget::createSettingsTab()
             this, &AuditorWidget::onSettingsChanged);
     connect(m_autoParseCheckbox, &QCheckBox::toggled,
             this, &AuditorWidget::onSettingsChanged);
+    connect(m_watchSavesCheckbox, &QCheckBox::toggled,
+            this, &AuditorWidget::onSettingsChanged);
     connect(m_showRawDataCheckbox, &QCheckBox::toggled,
             this, &AuditorWidget::onSettingsChanged);
     connect(m_maxTransactionsSpin, QOverload<int>::of(&QSpinBox::valueChanged),
@@ -324,6 +430,14 @@ void AuditorWidget::onSettingsChanged()
     if (m_rawDataView) {
         m_rawDataView->parentWidget()->setVisible(m_showRawDataCheckbox->isChecked());
     }
+
+    updateWatcher();
+}
+
+void AuditorWidget::updateWatcher()
+{
+    m_saveWatcher->setDirectory(m_defaultSavePathEdit->text());
+    m_saveWatcher->setEnabled(m_watchSavesCheckbox->isChecked());
 }
 
 void AuditorWidget::loadSettings()
@@ -333,6 +447,7 @@ void AuditorWidget::loadSettings()
     settings.beginGroup("Auditor");
     m_defaultSavePathEdit->setText(settings.value("defaultSavePath", "").toString());
     m_autoParseCheckbox->setChecked(settings.value("autoParse", false).toBool());
+    m_watchSavesCheckbox->setChecked(settings.value("watchSaves", false).toBool());
     m_showRawDataCheckbox->setChecked(settings.value("showRawData", true).toBool());
     m_maxTransactionsSpin->setValue(settings.value("maxTransactions", 50).toInt());
     settings.endGroup();
@@ -348,6 +463,7 @@ void AuditorWidget::saveSettings()
     settings.beginGroup("Auditor");
     settings.setValue("defaultSavePath", m_defaultSavePathEdit->text());
     settings.setValue("autoParse", m_autoParseCheckbox->isChecked());
+    settings.setValue("watchSaves", m_watchSavesCheckbox->isChecked());
     settings.setValue("showRawData", m_showRawDataCheckbox->isChecked());
     settings.setValue("maxTransactions", m_maxTransactionsSpin->value());
     settings.endGroup();
@@ -387,198 +503,344 @@ void AuditorWidget::onBrowseSaveFile()
 
 void AuditorWidget::onParseSaveFile()
 {
+    FRONTIER_TRACE_SCOPE("AuditorWidget::onParseSaveFile");
     if (m_currentSaveFilePath.isEmpty()) {
         QMessageBox::warning(this, "Error", "Please select a save file first.");
         return;
     }
 
-    QFile file(m_currentSaveFilePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::critical(this, "Error",
-                              QString("Could not open file: %1").arg(file.errorString()));
+    Frontier::SaveGameData data = Frontier::SaveParser::parseFile(m_currentSaveFilePath);
+    if (!data.valid) {
+        QMessageBox::critical(this, "Error", data.error);
         return;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    // Verify GVAS magic
-    if (!data.startsWith("GVAS")) {
-        QMessageBox::critical(this, "Error", "Not a valid GVAS save file.");
-        return;
-    }
+    // Later automatic reparses only report what changed since this one
+    m_saveWatcher->setBaseline(data);
+    showSaveData(data);
+}
 
+void AuditorWidget::showSaveData(const Frontier::SaveGameData &data)
+{
+    FRONTIER_TRACE_SCOPE("AuditorWidget::showSaveData");
     m_rawDataView->clear();
-    m_rawDataView->append(QString("File size: %1 bytes").arg(data.size()));
-    m_rawDataView->append(QString("Magic: %1").arg(QString(data.left(4))));
-
-    // === Parse NewMoney ===
-    int moneyPos = data.indexOf("NewMoney");
-    if (moneyPos != -1) {
-        qint32 money;
-        memcpy(&money, data.constData() + moneyPos + 34, sizeof(qint32));
-        m_currentMoneyLabel->setText(QString("$%L1").arg(money));
-        m_rawDataView->append(QString("Personal Money: $%L1").arg(money));
+    m_rawDataView->append(QString("File size: %1 bytes").arg(data.fileSize));
+    m_rawDataView->append(QString("Save game version: %1, package version: %2")
+                              .arg(data.saveGameVersion).arg(data.packageVersion));
+    m_rawDataView->append(QString("Engine: %1").arg(data.engineVersion));
+    m_rawDataView->append(QString("Save class: %1").arg(data.saveGameClass));
+
+    // === Money ===
+    if (data.money) {
+        m_currentMoneyLabel->setText(QString("$%L1").arg(*data.money));
+        m_rawDataView->append(QString("Personal Money: $%L1").arg(*data.money));
     } else {
         m_currentMoneyLabel->setText("Not found");
     }
 
-    // === Parse Map Name ===
-    QStringList mapPatterns = {
-        "FOREST_QUARRY", "DESERT_MINE", "ARCTIC_MINE", "VOLCANO_MINE",
-        "GRASS_FLAT", "FOREST_FLAT", "FOREST_HILLS", "MINE_TOWN",
-        "QUARRY", "SCANDINAVIA", "COAL_PLANT", "IRON_MOUNTAIN", "ARCTIC_WINTER"
-    };
-
-    m_mapNameLabel->setText("Unknown");
-    for (const QString &pattern : mapPatterns) {
-        if (data.contains(pattern.toUtf8())) {
-            m_mapNameLabel->setText(pattern);
-            m_rawDataView->append(QString("Map: %1").arg(pattern));
-            break;
-        }
+    // === Map Name ===
+    if (!data.map.isEmpty()) {
+        m_mapNameLabel->setText(data.map);
+        m_rawDataView->append(QString("Map: %1").arg(data.map));
+    } else {
+        m_mapNameLabel->setText("Unknown");
     }
 
-    // === Parse Transactions ===
+    // === Transactions ===
     m_transactionsModel->removeRows(0, m_transactionsModel->rowCount());
 
-    int transStart = data.indexOf("TransactionsHistory");
-    if (transStart == -1) {
+    if (!data.error.isEmpty()) {
+        m_rawDataView->append(QString("Warning: %1").arg(data.error));
+    }
+
+    m_parsedData = data;
+
+    if (!data.hasTransactionHistory) {
         m_transactionCountLabel->setText("Not found");
         m_rawDataView->append("TransactionsHistory not found");
         return;
     }
 
-    m_rawDataView->append(QString("TransactionsHistory at: %1").arg(transStart));
+    displayTransactions();
 
-    // Look for item codes (6 digits starting with 1-4) in the transaction area
-    // Item codes appear as: ...NameProperty\0....\x07\x00\x00\x00XXXXXX\x00...
+    m_rawDataView->append(QString("\nTransactions parsed: %1").arg(data.transactions.size()));
+    m_rawDataView->append(QString("Total Sales: $%L1").arg(data.totalSales()));
+    m_rawDataView->append(QString("Total Purchases: $%L1").arg(data.totalPurchases()));
+    m_rawDataView->append("\nParsing complete.");
+}
 
-    int transactionCount = 0;
-    double totalSales = 0;
-    double totalPurchases = 0;
+void AuditorWidget::onWatchedSaveParsed(const Frontier::SaveParseResult &result)
+{
+    m_currentSaveFilePath = result.filePath;
+    m_saveFilePathEdit->setText(result.filePath);
+    m_parseButton->setEnabled(true);
 
-    // Search for 6-digit item codes
-    QRegularExpression codePattern("[1-4]\\d{5}");
-    int searchStart = transStart + 100;
-    int searchEnd = qMin(transStart + 10000, data.size());
+    QFileInfo fileInfo(result.filePath);
+    m_fileNameLabel->setText(fileInfo.fileName());
+    m_fileSizeLabel->setText(QString("%L1 bytes").arg(result.data.fileSize));
 
-    // Convert search area to string for regex (just the relevant portion)
-    QString searchArea = QString::fromLatin1(data.mid(searchStart, searchEnd - searchStart));
+    showSaveData(result.data);
+    validateNewTransactions(result.newTransactions);
+}
 
-    QRegularExpressionMatchIterator matches = codePattern.globalMatch(searchArea);
+void AuditorWidget::onWatchedSaveFailed(const QString &filePath, const QString &error)
+{
+    m_rawDataView->append(QString("Automatic parse of %1 failed: %2")
+                              .arg(QFileInfo(filePath).fileName(), error));
+}
 
-    QSet<int> processedPositions;  // Avoid duplicates
+void AuditorWidget::validateNewTransactions(const QVector<Frontier::SaveTransaction> &added)
+{
+    m_validationModel->removeRows(0, m_validationModel->rowCount());
 
-    while (matches.hasNext()) {
-        QRegularExpressionMatch match = matches.next();
-        QString itemCode = match.captured(0);
-        int localPos = match.capturedStart();
-        int globalPos = searchStart + localPos;
+    if (added.isEmpty()) {
+        m_lastReconciledSave.clear();
+        m_ingestButton->setEnabled(false);
+        m_validationSummaryLabel->setText(
+            QString("Auto-audit %1: no new transactions.")
+                .arg(QTime::currentTime().toString("HH:mm:ss")));
+        return;
+    }
 
-        // Skip if we've processed nearby position (within 50 bytes)
-        bool skip = false;
-        for (int p : processedPositions) {
-            if (qAbs(p - globalPos) < 50) {
-                skip = true;
-                break;
-            }
-        }
-        if (skip) continue;
+    // Only the new entries are checked; older ledger rows are not reported
+    const auto ledgerTransactions = m_database->getAllTransactions();
+    Frontier::ReconcileOptions options;
+    options.reportUnmatchedLedger = false;
+    Frontier::Reconciler reconciler(m_database->itemCatalog());
+    const auto report = reconciler.reconcile(added, ledgerTransactions, options);
 
-        // Verify this is in a transaction context (has Category and Amount nearby)
-        QByteArray context = data.mid(globalPos, 300);
+    int issues = appendReconcileRows(report, added, ledgerTransactions);
+    m_validationTable->resizeColumnsToContents();
 
-        if (!context.contains("Category") || !context.contains("Amount")) {
-            continue;
-        }
+    if (issues == 0) {
+        m_validationSummaryLabel->setText(
+            QString("<span style='color: green; font-weight: bold;'>✓ Auto-audit: all %1 new transactions are in the ledger.</span>")
+                .arg(added.size()));
+    } else {
+        m_validationSummaryLabel->setText(
+            QString("<span style='color: red; font-weight: bold;'>⚠ Auto-audit: %1 of %2 new transactions need attention</span>")
+                .arg(issues).arg(added.size()));
+    }
+}
+
+int AuditorWidget::appendReconcileRows(const Frontier::ReconcileReport &report,
+                                       const QVector<Frontier::SaveTransaction> &save,
+                                       const QVector<Frontier::Transaction> &ledger)
+{
+    const auto &catalog = m_database->itemCatalog();
+
+    m_lastReconciledSave = save;
+    m_ingestButton->setEnabled(report.count(Frontier::ReconcileIssue::Kind::MissingFromLedger) > 0);
+
+    for (const auto &issue : report.issues) {
+        const Frontier::SaveTransaction *tx = issue.saveIndex >= 0 ? &save[issue.saveIndex] : nullptr;
+        const Frontier::Transaction *trans = issue.ledgerIndex >= 0 ? &ledger[issue.ledgerIndex] : nullptr;
 
-        processedPositions.insert(globalPos);
-
-        // Extract category
-        QString category = "Unknown";
-        int catPos = context.indexOf("Category");
-        if (catPos != -1) {
-            // Find NameProperty after Category
-            int catNpPos = context.indexOf("NameProperty", catPos);
-            if (catNpPos != -1 && catNpPos + 30 < context.size()) {
-                // String length is at NameProperty + 22
-                qint32 catStrLen;
-                memcpy(&catStrLen, context.constData() + catNpPos + 22, sizeof(qint32));
-
-                // String starts at NameProperty + 26
-                if (catStrLen > 0 && catStrLen < 30 && catNpPos + 26 + catStrLen <= context.size()) {
-                    category = QString::fromLatin1(context.mid(catNpPos + 26, catStrLen - 1));
-                }
+        QString itemName;
+        QDate date;
+        if (trans) {
+            itemName = trans->item;
+            date = trans->date;
+        }
+        if (tx) {
+            const Frontier::Item *item = catalog.findByCode(tx->itemCode);
+            itemName = item ? item->name : tx->itemCode;
+            if (tx->time.isValid()) {
+                date = tx->time.toLocalTime().date();
             }
         }
 
-        // Extract amount
-        qint32 amount = 0;
-        int amtPos = context.indexOf("Amount");
-        if (amtPos != -1 && amtPos + 36 < context.size()) {
-            memcpy(&amount, context.constData() + amtPos + 32, sizeof(qint32));
-        }
+        qint64 ledgerAmount = trans ? Frontier::Reconciler::ledgerAmount(*trans) : 0;
+        qint64 saveAmount = tx ? tx->amount : 0;
 
-        // Determine type
-        QString transType = (amount >= 0) ? "Sale" : "Purchase";
+        QString field = QString("%1: %2").arg(Frontier::reconcileIssueKindToString(issue.kind), itemName);
+        if (date.isValid()) {
+            field += QString(" (%1)").arg(date.toString(Qt::ISODate));
+        }
 
-        // Add to table
         QList<QStandardItem*> row;
-        row << new QStandardItem(itemCode);
-        row << new QStandardItem(category);
-        row << new QStandardItem(QString("$%L1").arg(amount));
-        row << new QStandardItem(transType);
+        row << new QStandardItem(field);
+        row << new QStandardItem(trans ? QString("$%L1").arg(ledgerAmount) : QString("-"));
+        row << new QStandardItem(tx ? QString("$%L1").arg(saveAmount) : QString("-"));
 
-        // Color code
-        if (amount < 0) {
-            row[2]->setForeground(Qt::red);
-        } else {
-            row[2]->setForeground(QColor(0, 128, 0));
+        qint64 diff = saveAmount - ledgerAmount;
+        row << new QStandardItem(diff >= 0 ? QString("+$%L1").arg(diff)
+                                           : QString("-$%L1").arg(-diff));
+
+        for (auto cell : row) {
+            cell->setForeground(Qt::red);
         }
+        m_validationModel->appendRow(row);
+    }
+
+    return report.issues.size();
+}
 
-        m_transactionsModel->appendRow(row);
+// =============================================================================
+// Timeline
+// =============================================================================
 
-        // Track totals
-        if (amount > 0) {
-            totalSales += amount;
-        } else {
-            totalPurchases += qAbs(amount);
+void AuditorWidget::onAddTimelineSaves()
+{
+    const QStringList files = QFileDialog::getOpenFileNames(
+        this,
+        "Select Save Files",
+        m_defaultSavePathEdit->text(),
+        "Save Files (*.sav);;All Files (*.*)"
+        );
+
+    for (const QString &file : files) {
+        if (!m_timelineFiles.contains(file)) {
+            m_timelineFiles.append(file);
         }
+    }
+    m_timelineFilesLabel->setText(QString("%1 save(s) selected.").arg(m_timelineFiles.size()));
+    m_timelineRunButton->setEnabled(!m_timelineFiles.isEmpty());
+}
 
-        transactionCount++;
+void AuditorWidget::onAddTimelineFolder()
+{
+    const QString dir = m_defaultSavePathEdit->text();
+    const QStringList saves = Frontier::SaveTimelineBuilder::findSaves(dir);
+    if (saves.isEmpty()) {
+        QMessageBox::information(this, "Timeline",
+                                 dir.isEmpty() ? QString("Set a default save folder in Settings first.")
+                                               : QString("No save files found in %1.").arg(dir));
+        return;
+    }
 
-        if (transactionCount >= m_maxTransactionsSpin->value()) break;  // Use setting
+    for (const QString &save : saves) {
+        if (!m_timelineFiles.contains(save)) {
+            m_timelineFiles.append(save);
+        }
     }
+    m_timelineFilesLabel->setText(QString("%1 save(s) selected.").arg(m_timelineFiles.size()));
+    m_timelineRunButton->setEnabled(true);
+}
 
-    m_transactionCountLabel->setText(QString("%1").arg(transactionCount));
+void AuditorWidget::onRunTimeline()
+{
+    if (m_timelineFiles.isEmpty() || m_timelineParse.isRunning()) {
+        return;
+    }
 
-    // Store parsed data for validation
-    m_parsedData.valid = true;
-    m_parsedData.transactionCount = transactionCount;
-    m_parsedData.totalSales = totalSales;
-    m_parsedData.totalPurchases = totalPurchases;
+    // Each save is parsed on its own pool thread; the diff and the
+    // reconciliation run once all of them are in
+    m_timelineRunButton->setEnabled(false);
+    m_timelineProgress->setVisible(true);
+    m_timelineSummaryLabel->setText(QString("Parsing %1 saves...").arg(m_timelineFiles.size()));
+    m_timelineParse.setFuture(QtConcurrent::mapped(m_timelineFiles, &Frontier::SaveTimelineBuilder::parse));
+}
 
-    // Get money value
-    if (moneyPos != -1) {
-        qint32 money;
-        memcpy(&money, data.constData() + moneyPos + 34, sizeof(qint32));
-        m_parsedData.money = money;
+void AuditorWidget::onTimelineParsed()
+{
+    FRONTIER_TRACE_SCOPE("AuditorWidget::onTimelineParsed");
+    m_timelineProgress->setVisible(false);
+    m_timelineRunButton->setEnabled(!m_timelineFiles.isEmpty());
+    if (m_timelineParse.isCanceled()) {
+        return;
     }
 
-    m_parsedData.map = m_mapNameLabel->text();
+    const QList<Frontier::SaveSnapshot> results = m_timelineParse.future().results();
+    const QVector<Frontier::SaveSnapshot> snapshots(results.begin(), results.end());
+    const QVector<Frontier::Transaction> ledger = m_database->getAllTransactions();
+    const Frontier::SaveTimeline timeline = Frontier::SaveTimelineBuilder::build(
+        snapshots, ledger, m_database->itemCatalog());
+    showTimeline(timeline, ledger);
+}
 
-    // Resize columns
-    m_transactionsTable->resizeColumnsToContents();
+void AuditorWidget::showTimeline(const Frontier::SaveTimeline &timeline,
+                                 const QVector<Frontier::Transaction> &ledger)
+{
+    m_timelineModel->removeRows(0, m_timelineModel->rowCount());
 
-    m_rawDataView->append(QString("\nTransactions parsed: %1").arg(transactionCount));
-    m_rawDataView->append(QString("Total Sales: $%L1").arg(totalSales));
-    m_rawDataView->append(QString("Total Purchases: $%L1").arg(totalPurchases));
-    m_rawDataView->append("\nParsing complete.");
+    auto money = [](qint64 amount) {
+        return amount >= 0 ? QString("$%L1").arg(amount) : QString("-$%L1").arg(-amount);
+    };
+    auto signedMoney = [](qint64 amount) {
+        return amount >= 0 ? QString("+$%L1").arg(amount) : QString("-$%L1").arg(-amount);
+    };
+
+    QSet<QString> maps;
+    qint64 unexplainedTotal = 0;
+    for (const Frontier::SaveTimelineEntry &entry : timeline.entries) {
+        QList<QStandardItem*> row;
+        auto *name = new QStandardItem(QFileInfo(entry.filePath).fileName());
+        name->setToolTip(entry.filePath);
+        row << name;
+        row << new QStandardItem(entry.modified.toString("yyyy-MM-dd hh:mm:ss"));
+
+        if (!entry.valid) {
+            row << new QStandardItem(QString("Failed: %1").arg(entry.error));
+            for (auto cell : row) {
+                cell->setForeground(Qt::red);
+            }
+            m_timelineModel->appendRow(row);
+            continue;
+        }
+        if (!entry.map.isEmpty()) {
+            maps.insert(entry.map);
+        }
+
+        row << new QStandardItem(entry.money ? money(*entry.money) : QString("-"));
+        if (!entry.hasPrevious) {
+            row << new QStandardItem("Baseline");
+            m_timelineModel->appendRow(row);
+            continue;
+        }
+
+        row << new QStandardItem(signedMoney(entry.moneyDelta));
+        row << new QStandardItem(QString::number(entry.added.size()));
+        row << new QStandardItem(signedMoney(entry.addedNet()));
+
+        auto *unexplained = new QStandardItem(entry.unexplainedMoney == 0 ? QString("-")
+                                                                          : signedMoney(entry.unexplainedMoney));
+        if (entry.unexplainedMoney != 0) {
+            unexplained->setForeground(QColor("#f57c00"));
+        }
+        row << unexplained;
+        unexplainedTotal += entry.unexplainedMoney;
+
+        row << new QStandardItem(QString("%1 / %2").arg(entry.matched).arg(entry.added.size()));
+        auto *issues = new QStandardItem(QString::number(entry.issues));
+        issues->setForeground(entry.issues > 0 ? Qt::red : QColor(0, 128, 0));
+        row << issues;
+
+        m_timelineModel->appendRow(row);
+    }
+    m_timelineTable->resizeColumnsToContents();
+
+    // The step-by-step issues go to the Validation tab as well
+    m_validationModel->removeRows(0, m_validationModel->rowCount());
+    const int issueCount = appendReconcileRows(timeline.report, timeline.added, ledger);
+    m_validationTable->resizeColumnsToContents();
+
+    QString summary = QString("%1 saves, %2 new transactions across them, %3 matched in the ledger")
+                          .arg(timeline.entries.size())
+                          .arg(timeline.added.size())
+                          .arg(timeline.report.matched);
+    if (timeline.failed > 0) {
+        summary += QString(", %1 failed to parse").arg(timeline.failed);
+    }
+    if (unexplainedTotal != 0) {
+        summary += QString(", %1 of money change not in any history").arg(signedMoney(unexplainedTotal));
+    }
+    if (maps.size() > 1) {
+        summary += QString(". <b>Saves span %1 maps</b>").arg(maps.size());
+    }
+    summary += ".";
+    if (issueCount > 0) {
+        summary = QString("<span style='color: red; font-weight: bold;'>⚠ %1 transaction issue(s)</span> %2 "
+                          "See the Validation tab.").arg(issueCount).arg(summary);
+    }
+    m_timelineSummaryLabel->setText(summary);
+    m_validationSummaryLabel->setText(QString("Timeline of %1 saves: %2 issue(s) in the transactions "
+                                              "added between them.").arg(timeline.entries.size()).arg(issueCount));
 }
 
 void AuditorWidget::onRunValidation()
 {
+    FRONTIER_TRACE_SCOPE("AuditorWidget::onRunValidation");
     // Check if save file has been parsed
     if (!m_parsedData.valid) {
         QMessageBox::warning(this, "Validation",
@@ -643,45 +905,152 @@ void AuditorWidget::onRunValidation()
         m_validationModel->appendRow(row);
     };
 
+    const qint32 saveMoney = m_parsedData.money.value_or(0);
+    const int saveCount = m_parsedData.transactions.size();
+    const double saveSales = m_parsedData.totalSales();
+    const double savePurchases = m_parsedData.totalPurchases();
+
     // Compare Personal Money / Balance
-    double moneyDiff = m_parsedData.money - ledgerBalance;
+    double moneyDiff = saveMoney - ledgerBalance;
     addRow("Personal Money",
            QString("$%L1").arg(ledgerBalance, 0, 'f', 0),
-           QString("$%L1").arg(m_parsedData.money),
+           QString("$%L1").arg(saveMoney),
            moneyDiff);
 
     // Compare Transaction Count
-    int countDiff = m_parsedData.transactionCount - ledgerTransactions.size();
+    int countDiff = saveCount - ledgerTransactions.size();
     addRow("Transaction Count",
            QString::number(ledgerTransactions.size()),
-           QString::number(m_parsedData.transactionCount),
+           QString::number(saveCount),
            countDiff);
 
     // Compare Total Sales
-    double salesDiff = m_parsedData.totalSales - ledgerSales;
+    double salesDiff = saveSales - ledgerSales;
     addRow("Total Sales",
            QString("$%L1").arg(ledgerSales, 0, 'f', 0),
-           QString("$%L1").arg(m_parsedData.totalSales, 0, 'f', 0),
+           QString("$%L1").arg(saveSales, 0, 'f', 0),
            salesDiff);
 
     // Compare Total Purchases
-    double purchasesDiff = m_parsedData.totalPurchases - ledgerPurchases;
+    double purchasesDiff = savePurchases - ledgerPurchases;
     addRow("Total Purchases",
            QString("$%L1").arg(ledgerPurchases, 0, 'f', 0),
-           QString("$%L1").arg(m_parsedData.totalPurchases, 0, 'f', 0),
+           QString("$%L1").arg(savePurchases, 0, 'f', 0),
            purchasesDiff);
 
+    // Entry-by-entry reconciliation over the whole history
+    Frontier::Reconciler reconciler(m_database->itemCatalog());
+    const auto report = reconciler.reconcile(m_parsedData.transactions, ledgerTransactions);
+    discrepancyCount += appendReconcileRows(report, m_parsedData.transactions, ledgerTransactions);
+
     // Resize columns
     m_validationTable->resizeColumnsToContents();
 
     // Update summary
+    const QString matched = QString("%L1 of %L2 save transactions matched")
+                                .arg(report.matched).arg(saveCount);
     if (discrepancyCount == 0) {
         m_validationSummaryLabel->setText(
-            "<span style='color: green; font-weight: bold;'>✓ All values match!</span>");
+            QString("<span style='color: green; font-weight: bold;'>✓ All values match!</span> %1.")
+                .arg(matched));
     } else {
         m_validationSummaryLabel->setText(
-            QString("<span style='color: red; font-weight: bold;'>⚠ Found %1 discrepanc%2</span>")
+            QString("<span style='color: red; font-weight: bold;'>⚠ Found %1 discrepanc%2</span> %3.")
                 .arg(discrepancyCount)
-                .arg(discrepancyCount == 1 ? "y" : "ies"));
+                .arg(discrepancyCount == 1 ? "y" : "ies")
+                .arg(matched));
+    }
+}
+
+void AuditorWidget::onIngestUnmatched()
+{
+    if (m_lastReconciledSave.isEmpty()) {
+        return;
+    }
+
+    // Reconcile again: the ledger may have changed since the report was shown,
+    // and anything that matches a ledger row now must not be added twice
+    const auto ledgerTransactions = m_database->getAllTransactions();
+    Frontier::ReconcileOptions options;
+    options.reportUnmatchedLedger = false;
+    Frontier::Reconciler reconciler(m_database->itemCatalog());
+    const auto report = reconciler.reconcile(m_lastReconciledSave, ledgerTransactions, options);
+
+    int noTime = 0;
+    QVector<Frontier::Transaction> rows =
+        reconciler.missingAsLedger(report, m_lastReconciledSave, Frontier::AccountType::Personal, &noTime);
+    if (rows.isEmpty()) {
+        QMessageBox::information(this, "Ingest Unmatched",
+                                 "Every save entry is already in the ledger.");
+        m_ingestButton->setEnabled(false);
+        return;
     }
+
+    double sales = 0;
+    double purchases = 0;
+    for (const auto &trans : rows) {
+        (trans.isIncome() ? sales : purchases) += trans.totalAmount;
+    }
+    QString prompt = QString("Add %L1 save transaction(s) to the ledger as one undoable step?
+"
+                             "Sales $%L2, purchases $%L3.")
+                         .arg(rows.size())
+                         .arg(sales, 0, 'f', 0)
+                         .arg(purchases, 0, 'f', 0);
+    const int repeats = report.count(Frontier::ReconcileIssue::Kind::Duplicate);
+    const int mismatches = report.count(Frontier::ReconcileIssue::Kind::AmountMismatch);
+    if (repeats + mismatches + noTime > 0) {
+        prompt += QString("
+Left for review: %1 duplicate(s), %2 amount mismatch(es), %3 without a time.")
+                      .arg(repeats).arg(mismatches).arg(noTime);
+    }
+    prompt += "
+
+Account:";
+
+    bool ok = false;
+    const QString account = QInputDialog::getItem(this, "Ingest Unmatched", prompt,
+                                                  {"Personal", "Company"}, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    if (account == "Company") {
+        for (auto &trans : rows) {
+            trans.account = Frontier::AccountType::Company;
+        }
+    }
+
+    // One transaction and one change publish for the whole batch
+    Frontier::CommandJournal &journal = m_database->journal();
+    journal.beginGroup(QString("Ingest %1 save transactions").arg(rows.size()));
+    if (!journal.inGroup()) {
+        QMessageBox::warning(this, "Ingest Unmatched",
+                             QString("Nothing was added: %1").arg(journal.lastError()));
+        return;
+    }
+    for (const auto &trans : rows) {
+        if (!journal.execute(Frontier::JournalCommand::addTransaction(trans))) {
+            const QString error = journal.lastError();
+            journal.abortGroup();
+            QMessageBox::warning(this, "Ingest Unmatched",
+                                 QString("Nothing was added: %1").arg(error));
+            return;
+        }
+    }
+    if (!journal.endGroup()) {
+        QMessageBox::warning(this, "Ingest Unmatched",
+                             QString("Nothing was added: %1").arg(journal.lastError()));
+        return;
+    }
+
+    // Show what is still open for the same save entries
+    const auto ledgerAfter = m_database->getAllTransactions();
+    const auto remaining = reconciler.reconcile(m_lastReconciledSave, ledgerAfter, options);
+    m_validationModel->removeRows(0, m_validationModel->rowCount());
+    const int issues = appendReconcileRows(remaining, m_lastReconciledSave, ledgerAfter);
+    m_validationTable->resizeColumnsToContents();
+    m_validationSummaryLabel->setText(
+        QString("Ingested %L1 transaction(s) into the %2 account; %3 issue(s) remain.")
+            .arg(rows.size()).arg(account).arg(issues));
 }
+
@@ -18,11 +18,14 @@
 #include <QCheckBox>
 #include <QSettings>
 #include <QSpinBox>
+#include <QProgressBar>
+#include <QFutureWatcher>
 
 #include "core/database.h"
-
-// Forward declarration
-class SaveParser;
+#include "core/saveparser.h"
+#include "core/savewatcher.h"
+#include "core/reconciler.h"
+#include "core/savetimeline.h"
 
 class AuditorWidget : public QWidget
 {
@@ -36,8 +39,15 @@ private slots:
     void onBrowseSaveFile();
     void onParseSaveFile();
     void onRunValidation();
+    void onIngestUnmatched();
     void onBrowseDefaultPath();
     void onSettingsChanged();
+    void onWatchedSaveParsed(const Frontier::SaveParseResult &result);
+    void onWatchedSaveFailed(const QString &filePath, const QString &error);
+    void onAddTimelineSaves();
+    void onAddTimelineFolder();
+    void onRunTimeline();
+    void onTimelineParsed();
 
 private:
     void setupUi();
@@ -48,9 +58,18 @@ private:
     QWidget* createSaveParserTab();
     QWidget* createValidationTab();
     QWidget* createSettingsTab();
+    QWidget* createTimelineTab();
 
     void updateSaveFileInfo();
+    void showSaveData(const Frontier::SaveGameData &data);
     void displayTransactions();
+    void validateNewTransactions(const QVector<Frontier::SaveTransaction> &added);
+    int appendReconcileRows(const Frontier::ReconcileReport &report,
+                            const QVector<Frontier::SaveTransaction> &save,
+                            const QVector<Frontier::Transaction> &ledger);
+    void updateWatcher();
+    void showTimeline(const Frontier::SaveTimeline &timeline,
+                      const QVector<Frontier::Transaction> &ledger);
 
     // Database reference
     Frontier::Database *m_database;
@@ -81,25 +100,34 @@ private:
     QTableView *m_validationTable;
     QStandardItemModel *m_validationModel;
     QLabel *m_validationSummaryLabel;
+    QPushButton *m_ingestButton;
+
+    // Save side of the last reconciliation shown, for ingesting what it missed
+    QVector<Frontier::SaveTransaction> m_lastReconciledSave;
 
     // Current save file path
     QString m_currentSaveFilePath;
 
     // Parsed save file data (for validation)
-    struct ParsedSaveData {
-        bool valid = false;
-        int money = 0;
-        QString map;
-        int transactionCount = 0;
-        double totalSales = 0;
-        double totalPurchases = 0;
-    };
+    Frontier::SaveGameData m_parsedData;
+
+    // Background reparse of new saves
+    Frontier::SaveWatcher *m_saveWatcher;
 
-    ParsedSaveData m_parsedData;
+    // Timeline tab widgets
+    QStringList m_timelineFiles;
+    QLabel *m_timelineFilesLabel;
+    QPushButton *m_timelineRunButton;
+    QProgressBar *m_timelineProgress;
+    QTableView *m_timelineTable;
+    QStandardItemModel *m_timelineModel;
+    QLabel *m_timelineSummaryLabel;
+    QFutureWatcher<Frontier::SaveSnapshot> m_timelineParse;
 
     // Settings tab widgets
     QLineEdit *m_defaultSavePathEdit;
     QCheckBox *m_autoParseCheckbox;
+    QCheckBox *m_watchSavesCheckbox;
     QCheckBox *m_showRawDataCheckbox;
     QSpinBox *m_maxTransactionsSpin;
 
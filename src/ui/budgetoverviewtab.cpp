@@ -5,6 +5,8 @@
 
 #include "budgetoverviewtab.h"
 #include "core/database.h"
+#include "core/capitalplanservice.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -204,44 +206,31 @@ void BudgetOverviewTab::setupUi()
 
 void BudgetOverviewTab::refreshData()
 {
-    // Get available funds from Finance
-    auto balances = m_database->calculateBalances();
-    double companyBalance = balances.companyBalance;
-    double personalBalance = balances.personalBalance;
-    double totalAvailable = balances.total();
+    FRONTIER_TRACE_SCOPE("BudgetOverviewTab::refreshData");
+    const Frontier::CapitalPlanSummary &plan = m_database->capitalPlan().summary();
+
+    // Available funds from Finance
+    double companyBalance = plan.balances.companyBalance;
+    double personalBalance = plan.balances.personalBalance;
+    double totalAvailable = plan.available();
 
     m_companyBalanceLabel->setText(formatCurrency(companyBalance));
     m_personalBalanceLabel->setText(formatCurrency(personalBalance));
     m_totalAvailableLabel->setText(formatCurrency(totalAvailable));
 
-    // Get planned costs from capital_plan tables
-    double equipmentTotal = 0;
-    double facilityTotal = 0;
-    double powerRequired = 0;
-    double powerGenerated = 0;
-
-    // Get equipment plan totals
-    auto equipmentPlan = m_database->getEquipmentPlan();
-    for (const auto &item : equipmentPlan) {
-        equipmentTotal += item.totalCost;
-    }
-
-    // Get facility plan totals
-    auto facilityPlan = m_database->getFacilityPlan();
-    for (const auto &item : facilityPlan) {
-        facilityTotal += item.totalCost;
-        powerRequired += item.totalPowerKw;
-        powerGenerated += item.totalGeneratedKw;
-    }
-
-    double grandTotal = equipmentTotal + facilityTotal;
+    // Planned costs
+    double equipmentTotal = plan.equipment.cost;
+    double facilityTotal = plan.facility.cost;
+    double powerRequired = plan.facility.powerKw;
+    double powerGenerated = plan.facility.generatedKw;
+    double grandTotal = plan.grandTotal();
 
     m_equipmentTotalLabel->setText(formatCurrency(equipmentTotal));
     m_facilityTotalLabel->setText(formatCurrency(facilityTotal));
     m_grandTotalLabel->setText(formatCurrency(grandTotal));
 
     // Affordability
-    double remaining = totalAvailable - grandTotal;
+    double remaining = plan.remaining();
     m_remainingLabel->setText(formatCurrency(remaining));
 
     if (remaining >= 0) {
@@ -251,10 +240,7 @@ void BudgetOverviewTab::refreshData()
     }
 
     // Progress bar: how much of available funds are we using?
-    int usagePercent = 0;
-    if (totalAvailable > 0) {
-        usagePercent = qBound(0, static_cast<int>((grandTotal / totalAvailable) * 100), 100);
-    }
+    int usagePercent = plan.fundsUsedPercent();
     m_affordabilityBar->setValue(usagePercent);
     m_affordabilityBar->setFormat(QString("%1% of funds allocated").arg(usagePercent));
 
@@ -277,7 +263,7 @@ void BudgetOverviewTab::refreshData()
     m_powerRequiredLabel->setText(formatPower(powerRequired));
     m_powerGeneratedLabel->setText(formatPower(powerGenerated));
 
-    double powerBalance = powerGenerated - powerRequired;
+    double powerBalance = plan.facility.powerBalanceKw();
     m_powerBalanceLabel->setText((powerBalance >= 0 ? "+" : "") + formatPower(powerBalance));
 
     if (powerBalance >= 0) {
@@ -287,12 +273,7 @@ void BudgetOverviewTab::refreshData()
     }
 
     // Power bar: coverage percentage
-    int powerPercent = 0;
-    if (powerRequired > 0) {
-        powerPercent = qBound(0, static_cast<int>((powerGenerated / powerRequired) * 100), 100);
-    } else if (powerGenerated > 0) {
-        powerPercent = 100;
-    }
+    int powerPercent = plan.powerCoveragePercent();
     m_powerBar->setValue(powerPercent);
     m_powerBar->setFormat(QString("%1% power coverage").arg(powerPercent));
 
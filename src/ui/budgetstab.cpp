@@ -5,6 +5,9 @@
 
 #include "budgetstab.h"
 #include "core/database.h"
+#include "core/transactionstore.h"
+#include "core/commandjournal.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -35,7 +38,18 @@ BudgetsTab::BudgetsTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
-    refreshData();
+    // First load waits until the tab is first shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Transactions | Frontier::DataTable::Budgets,
+                                      [this]() { refreshData(); }, true);
+
+    // One month's budgets are a handful of rows; reloading them is the patch.
+    // A hidden tab waits for the change bus instead.
+    connect(&m_database->journal(), &Frontier::CommandJournal::applied, this,
+            [this](const Frontier::JournalChange &change) {
+                if (change.table == Frontier::JournalChange::Budgets && isVisible()) {
+                    refreshData();
+                }
+            });
 }
 
 void BudgetsTab::setupUi()
@@ -196,6 +210,29 @@ void BudgetsTab::setupUi()
 
     mainLayout->addWidget(tableGroup, 1);
 
+    // Year at a glance
+    auto *yearGroup = new QGroupBox(tr("Year at a Glance"));
+    auto *yearLayout = new QVBoxLayout(yearGroup);
+
+    m_yearTable = new QTableWidget();
+    m_yearTable->setColumnCount(14);
+    QStringList yearHeaders{tr("Category")};
+    for (int month = 1; month <= 12; ++month) {
+        yearHeaders << QLocale(QLocale::English).standaloneMonthName(month, QLocale::ShortFormat);
+    }
+    yearHeaders << tr("Year");
+    m_yearTable->setHorizontalHeaderLabels(yearHeaders);
+    m_yearTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_yearTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_yearTable->verticalHeader()->setVisible(false);
+    m_yearTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    for (int column = 1; column < 14; ++column) {
+        m_yearTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
+    yearLayout->addWidget(m_yearTable);
+
+    mainLayout->addWidget(yearGroup, 1);
+
     // Forecast section
     auto *forecastGroup = new QGroupBox(tr("Forecast"));
     auto *forecastLayout = new QVBoxLayout(forecastGroup);
@@ -214,6 +251,8 @@ void BudgetsTab::setupUi()
 
 void BudgetsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("BudgetsTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     loadBudgets();
 }
 
@@ -233,7 +272,7 @@ void BudgetsTab::loadBudgets()
     // Get actual spending for comparison
     QDate from(year, month, 1);
     QDate to(year, month, QDate(year, month, 1).daysInMonth());
-    auto summary = m_database->getFinanceSummary(from, to);
+    auto summary = m_database->transactionStore().summary(from, to);
 
     double totalBudget = 0;
     double totalActual = 0;
@@ -349,6 +388,62 @@ void BudgetsTab::loadBudgets()
     }
 
     m_forecastLabel->setText(forecast);
+
+    loadYearMatrix();
+}
+
+void BudgetsTab::loadYearMatrix()
+{
+    // The whole year from one grouped query rather than a query per month
+    const int year = m_yearSpin->value();
+    const Frontier::BudgetMatrix matrix =
+        m_database->getBudgetMatrix(QDate(year, 1, 1), QDate(year, 12, 31));
+
+    auto makeItem = [](const Frontier::BudgetCell &cell) {
+        auto *item = new QTableWidgetItem(cell.actual > 0 || cell.budgeted > 0 ? formatCurrency(cell.actual) : "-");
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        if (cell.budgeted > 0) {
+            item->setToolTip(tr("Budget %1, spent %2, %3 %4")
+                                 .arg(formatCurrency(cell.budgeted), formatCurrency(cell.actual),
+                                      formatCurrency(qAbs(cell.variance)),
+                                      cell.variance < 0 ? tr("over") : tr("left")));
+            item->setForeground(cell.variance < 0 ? QColor("#c62828") : QColor("#2e7d32"));
+            if (cell.usedPercent() > 100) {
+                item->setBackground(QColor(255, 205, 210));     // Light red - over budget
+            } else if (cell.usedPercent() > 80) {
+                item->setBackground(QColor(255, 224, 178));     // Light orange - nearly spent
+            }
+        } else if (cell.actual > 0) {
+            item->setToolTip(tr("Spent %1 with no budget").arg(formatCurrency(cell.actual)));
+            item->setForeground(QColor("#666"));
+        }
+        return item;
+    };
+
+    const int monthCount = matrix.months.size();
+    m_yearTable->setRowCount(matrix.categories.size() + 1);
+    for (int row = 0; row < matrix.categories.size(); ++row) {
+        m_yearTable->setItem(row, 0, new QTableWidgetItem(matrix.categories[row]));
+        for (int month = 0; month < monthCount; ++month) {
+            m_yearTable->setItem(row, month + 1, makeItem(matrix.cell(row, month)));
+        }
+        m_yearTable->setItem(row, monthCount + 1, makeItem(matrix.categoryTotals[row]));
+    }
+
+    // Totals row
+    const int totalRow = matrix.categories.size();
+    QFont bold = m_yearTable->font();
+    bold.setBold(true);
+    m_yearTable->setItem(totalRow, 0, new QTableWidgetItem(tr("Total")));
+    for (int month = 0; month < monthCount; ++month) {
+        m_yearTable->setItem(totalRow, month + 1, makeItem(matrix.monthTotals[month]));
+    }
+    m_yearTable->setItem(totalRow, monthCount + 1, makeItem(matrix.total));
+    for (int column = 0; column < m_yearTable->columnCount(); ++column) {
+        if (QTableWidgetItem *item = m_yearTable->item(totalRow, column)) {
+            item->setFont(bold);
+        }
+    }
 }
 
 // =============================================================================
@@ -375,14 +470,7 @@ void BudgetsTab::showBudgetDialog(bool isEdit)
     categoryCombo->setEditable(true);
 
     // Populate with existing categories from transactions
-    auto allTransactions = m_database->getAllTransactions();
-    QSet<QString> categories;
-    for (const auto &t : allTransactions) {
-        if (!t.category.isEmpty()) {
-            categories.insert(t.category);
-        }
-    }
-    for (const auto &cat : categories) {
+    for (const auto &cat : m_database->getTransactionCategories()) {
         categoryCombo->addItem(cat);
     }
     layout->addRow(tr("Category:"), categoryCombo);
@@ -402,6 +490,7 @@ void BudgetsTab::showBudgetDialog(bool isEdit)
     Frontier::Budget budget;
     budget.year = m_yearSpin->value();
     budget.month = m_monthCombo->currentIndex() + 1;
+    std::optional<Frontier::Budget> before;
 
     if (isEdit) {
         auto selected = m_budgetTable->selectedItems();
@@ -411,6 +500,7 @@ void BudgetsTab::showBudgetDialog(bool isEdit)
             auto existing = m_database->getBudget(budgetId);
             if (existing.has_value()) {
                 budget = existing.value();
+                before = existing;
                 categoryCombo->setCurrentText(budget.category);
                 amountSpin->setValue(budget.monthlyAmount);
                 notesEdit->setText(budget.notes);
@@ -433,16 +523,16 @@ void BudgetsTab::showBudgetDialog(bool isEdit)
             return;
         }
 
+        // The journal's applied() reloads the month
+        Frontier::CommandJournal &journal = m_database->journal();
         bool success = false;
-        if (isEdit && budget.id.has_value()) {
-            success = m_database->updateBudget(budget);
+        if (isEdit && before && budget.id.has_value()) {
+            success = journal.execute(Frontier::JournalCommand::updateBudget(*before, budget));
         } else {
-            success = m_database->addBudget(budget) > 0;
+            success = journal.execute(Frontier::JournalCommand::addBudget(budget));
         }
 
-        if (success) {
-            loadBudgets();
-        } else {
+        if (!success) {
             QMessageBox::critical(this, tr("Error"), tr("Failed to save budget."));
         }
     }
@@ -470,8 +560,8 @@ void BudgetsTab::onDeleteBudget()
         tr("Delete this budget entry?"));
 
     if (result == QMessageBox::Yes) {
-        if (m_database->deleteBudget(budgetId)) {
-            loadBudgets();
+        if (auto budget = m_database->getBudget(budgetId)) {
+            m_database->journal().execute(Frontier::JournalCommand::deleteBudget(*budget));
         }
     }
 }
@@ -41,6 +41,7 @@ private slots:
 private:
     void setupUi();
     void loadBudgets();
+    void loadYearMatrix();
     void showBudgetDialog(bool isEdit);
 
     Frontier::Database *m_database;
@@ -63,6 +64,9 @@ private:
     QPushButton *m_editBtn;
     QPushButton *m_deleteBtn;
 
+    // Year at a glance: category x month, actual against budget
+    QTableWidget *m_yearTable;
+
     // Forecast section
     QLabel *m_forecastLabel;
 };
@@ -8,6 +8,7 @@
 #include "equipmentplannertab.h"
 #include "facilityplannertab.h"
 #include "core/database.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 
@@ -16,6 +17,10 @@ CapitalPlannerWidget::CapitalPlannerWidget(Frontier::Database *database, QWidget
     , m_database(database)
 {
     setupUi();
+    m_database->changeBus().subscribe(this,
+        Frontier::DataTable::Transactions | Frontier::DataTable::Items
+            | Frontier::DataTable::FactoryBuildings | Frontier::DataTable::Recipes,
+        [this]() { refreshData(); });
 }
 
 void CapitalPlannerWidget::setupUi()
@@ -44,6 +49,8 @@ void CapitalPlannerWidget::setupUi()
 
 void CapitalPlannerWidget::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("CapitalPlannerWidget::refreshData");
+    m_database->changeBus().acknowledge(this);
     m_overviewTab->refreshData();
     m_equipmentTab->refreshData();
     m_facilityTab->refreshData();
@@ -0,0 +1,158 @@
+/**
+ * @file columntablemodel.cpp
+ * @brief Column-descriptor table model shared by the list tabs
+ */
+
+#include "columntablemodel.h"
+#include "core/unitconverter.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QTimer>
+#include <algorithm>
+
+// =============================================================================
+// ColumnTableModelBase
+// =============================================================================
+
+ColumnTableModelBase::ColumnTableModelBase(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ColumnTableModelBase::setUnitSystem(Frontier::UnitSystem system)
+{
+    if (system == m_unitSystem) {
+        return;
+    }
+
+    m_unitSystem = system;
+    if (hasUnitColumns() && rowCount() > 0) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1),
+                         {Qt::DisplayRole});
+    }
+}
+
+void ColumnTableModelBase::markRowChanged(int row)
+{
+    m_changedRows.append(row);
+    if (!m_flushQueued) {
+        m_flushQueued = true;
+        QTimer::singleShot(0, this, &ColumnTableModelBase::flushChanges);
+    }
+}
+
+void ColumnTableModelBase::dropPendingChanges()
+{
+    m_changedRows.clear();
+}
+
+void ColumnTableModelBase::flushChanges()
+{
+    m_flushQueued = false;
+    if (m_changedRows.isEmpty()) {
+        return;
+    }
+
+    QVector<int> rows = std::exchange(m_changedRows, {});
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    const int lastColumn = columnCount() - 1;
+    int runStart = rows.first();
+    for (int i = 1; i <= rows.size(); ++i) {
+        if (i < rows.size() && rows[i] == rows[i - 1] + 1) {
+            continue;
+        }
+        emit dataChanged(index(runStart, 0), index(rows[i - 1], lastColumn));
+        if (i < rows.size()) {
+            runStart = rows[i];
+        }
+    }
+}
+
+void ColumnTableModelBase::refreshColumn(int column)
+{
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, column), index(rowCount() - 1, column));
+    }
+}
+
+bool ColumnTableModelBase::isNumeric(ColumnFormat format)
+{
+    switch (format) {
+    case ColumnFormat::Text:
+    case ColumnFormat::Date:
+    case ColumnFormat::DateTime:
+        return false;
+    default:
+        return true;
+    }
+}
+
+QString ColumnTableModelBase::formatValue(const QVariant &value, ColumnFormat format,
+                                          Frontier::UnitSystem system, int decimals)
+{
+    using Frontier::UnitConverter;
+
+    switch (format) {
+    case ColumnFormat::Text:
+        return value.toString();
+    case ColumnFormat::Integer:
+        return QString("%L1").arg(value.toLongLong());
+    case ColumnFormat::Decimal:
+        return QString("%L1").arg(value.toDouble(), 0, 'f', decimals < 0 ? 2 : decimals);
+    case ColumnFormat::Currency:
+        return QString("$%L1").arg(value.toDouble(), 0, 'f', decimals < 0 ? 2 : decimals);
+    case ColumnFormat::WholeCurrency:
+        return QString("$%L1").arg(value.toDouble(), 0, 'f', 0);
+    case ColumnFormat::Percent:
+        return QString("%1%").arg(value.toDouble(), 0, 'f', decimals < 0 ? 1 : decimals);
+    case ColumnFormat::Date:
+        return value.toDate().toString("yyyy-MM-dd");
+    case ColumnFormat::DateTime:
+        return value.toDateTime().toString("yyyy-MM-dd hh:mm");
+    case ColumnFormat::Volume:
+        return UnitConverter::formatVolume(value.toDouble(), system, decimals < 0 ? 2 : decimals);
+    case ColumnFormat::Fuel:
+        return UnitConverter::formatFuel(value.toDouble(), system, decimals < 0 ? 1 : decimals);
+    case ColumnFormat::FuelRate:
+        return UnitConverter::formatFuelRate(value.toDouble(), system, decimals < 0 ? 1 : decimals);
+    case ColumnFormat::Distance:
+        return QString("%1 %2")
+            .arg(UnitConverter::distanceToDisplay(value.toDouble(), system), 0, 'f',
+                 decimals < 0 ? 1 : decimals)
+            .arg(UnitConverter::distanceUnitLabel(system));
+    }
+    return value.toString();
+}
+
+// =============================================================================
+// ColumnSortProxy
+// =============================================================================
+
+ColumnSortProxy::ColumnSortProxy(ColumnTableModelBase *source, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_source(source)
+{
+    setSourceModel(source);
+    connect(source, &ColumnTableModelBase::filterChanged, this, [this]() { invalidateFilter(); });
+}
+
+int ColumnSortProxy::sourceRow(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid()) {
+        return -1;
+    }
+    return mapToSource(proxyIndex).row();
+}
+
+bool ColumnSortProxy::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    return m_source->lessThan(left.column(), left.row(), right.row());
+}
+
+bool ColumnSortProxy::filterAcceptsRow(int sourceRow, const QModelIndex &) const
+{
+    return m_source->acceptsRow(sourceRow);
+}
@@ -0,0 +1,358 @@
+/**
+ * @file columntablemodel.h
+ * @brief Column-descriptor table model shared by the list tabs
+ */
+
+#ifndef COLUMNTABLEMODEL_H
+#define COLUMNTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include <QVariant>
+#include <QPointer>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "core/types.h"
+#include "core/datachangebus.h"
+
+/**
+ * @brief How a column turns its raw value into display text
+ *
+ * Unit formats hold storage units (m³, litres, L/hr, km) and are shown in
+ * the model's UnitSystem through UnitConverter.
+ */
+enum class ColumnFormat {
+    Text,
+    Integer,           // Grouped digits
+    Decimal,           // Fixed decimals, default 2
+    Currency,          // $ with 2 decimals
+    WholeCurrency,     // $ with no decimals
+    Percent,           // Value already in percent, 1 decimal
+    Date,              // yyyy-MM-dd
+    DateTime,          // yyyy-MM-dd hh:mm
+    Volume,
+    Fuel,
+    FuelRate,
+    Distance
+};
+
+/**
+ * @brief Type-independent half of ColumnTableModel
+ *
+ * Holds what does not depend on the row type (formatting, unit system,
+ * change batching) and the hooks ColumnSortProxy calls, so the proxy sorts
+ * and filters on the typed rows without going through QVariant.
+ */
+class ColumnTableModelBase : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        SortRole = Qt::UserRole,     // Raw column value
+        RowIdRole                    // Whatever setRowId() returns
+    };
+
+    explicit ColumnTableModelBase(QObject *parent = nullptr);
+
+    void setUnitSystem(Frontier::UnitSystem system);
+    Frontier::UnitSystem unitSystem() const { return m_unitSystem; }
+
+    // Emits dataChanged() for rows marked since the last flush, one signal
+    // per contiguous run. Runs on its own from the event loop; call it to
+    // have a view repaint before then.
+    void flushChanges();
+
+    // For a column whose text depends on state outside the rows
+    void refreshColumn(int column);
+
+    static QString formatValue(const QVariant &value, ColumnFormat format,
+                               Frontier::UnitSystem system, int decimals = -1);
+    static bool isNumeric(ColumnFormat format);
+
+    // === Proxy hooks ===
+    virtual bool lessThan(int column, int left, int right) const = 0;
+    virtual bool acceptsRow(int row) const = 0;
+
+signals:
+    // The row filter changed; proxies re-filter
+    void filterChanged();
+
+protected:
+    void markRowChanged(int row);
+    void dropPendingChanges();
+    virtual bool hasUnitColumns() const = 0;
+
+private:
+    Frontier::UnitSystem m_unitSystem = Frontier::UnitSystem::Metric;
+    QVector<int> m_changedRows;
+    bool m_flushQueued = false;
+};
+
+/**
+ * @brief Table model declared as columns over a vector of rows
+ *
+ * A tab keeps its rows here and describes each column once: a title, a
+ * format and a getter returning the typed value. Cells are formatted only
+ * when a view asks for them, SortRole hands a proxy the raw value, and
+ * ColumnSortProxy compares getter results directly. Styles (colours,
+ * fonts, tooltips) come from optional per-cell and per-row callbacks.
+ *
+ * setRows() resets the model; appendRow(), insertRowAt(), removeRowAt()
+ * and setRow() are single-row patches, and setRow() changes are batched
+ * into one dataChanged() per run of rows.
+ */
+template<typename Row>
+class ColumnTableModel : public ColumnTableModelBase
+{
+public:
+    using ValueFn = std::function<QVariant(const Row &)>;
+    using LessFn = std::function<bool(const Row &, const Row &)>;
+    using StyleFn = std::function<QVariant(const Row &, int role)>;
+    using FilterFn = std::function<bool(const Row &)>;
+    using IdFn = std::function<int(const Row &)>;
+
+    explicit ColumnTableModel(QObject *parent = nullptr)
+        : ColumnTableModelBase(parent)
+    {
+    }
+
+    // === Columns ===
+    // The getter's return type decides the sort order and the SortRole
+    // value; returns the column index
+    template<typename Getter>
+    int addColumn(const QString &title, ColumnFormat format, Getter get, int decimals = -1)
+    {
+        Column column;
+        column.title = title;
+        column.format = format;
+        column.decimals = decimals;
+        column.value = [get](const Row &row) { return QVariant::fromValue(get(row)); };
+        column.less = [get](const Row &a, const Row &b) { return get(a) < get(b); };
+        m_columns.append(std::move(column));
+        return m_columns.size() - 1;
+    }
+
+    // Display text computed by the caller instead of the format; the
+    // column still sorts by its getter
+    void setColumnText(int column, std::function<QString(const Row &)> text)
+    {
+        m_columns[column].text = std::move(text);
+    }
+
+    void setCellStyle(int column, StyleFn style) { m_columns[column].style = std::move(style); }
+    // Applies to every cell of the row, after the cell's own style
+    void setRowStyle(StyleFn style) { m_rowStyle = std::move(style); }
+    void setRowId(IdFn id) { m_rowId = std::move(id); }
+
+    // Rows failing the filter are hidden by ColumnSortProxy
+    void setFilter(FilterFn filter)
+    {
+        m_filter = std::move(filter);
+        emit filterChanged();
+    }
+
+    // === Rows ===
+    void setRows(QVector<Row> rows)
+    {
+        beginResetModel();
+        dropPendingChanges();
+        m_rows = std::move(rows);
+        endResetModel();
+    }
+
+    const QVector<Row> &rows() const { return m_rows; }
+    const Row &rowAt(int row) const { return m_rows[row]; }
+
+    void appendRow(Row row) { insertRowAt(m_rows.size(), std::move(row)); }
+
+    void insertRowAt(int position, Row row)
+    {
+        flushChanges();
+        beginInsertRows(QModelIndex(), position, position);
+        m_rows.insert(position, std::move(row));
+        endInsertRows();
+    }
+
+    void removeRowAt(int position)
+    {
+        flushChanges();
+        beginRemoveRows(QModelIndex(), position, position);
+        m_rows.removeAt(position);
+        endRemoveRows();
+    }
+
+    void setRow(int position, Row row)
+    {
+        m_rows[position] = std::move(row);
+        markRowChanged(position);
+    }
+
+    // Applies change-bus row events by id, re-reading each row through
+    // fetch (nullopt when it is gone or does not belong in this model).
+    // New rows go in at insertAt, or at the end when it is -1. Each event
+    // is one row signal, whatever the size of the model.
+    void applyRowChanges(const QVector<Frontier::RowChange> &changes,
+                         const std::function<std::optional<Row>(int id)> &fetch,
+                         int insertAt = 0)
+    {
+        for (const Frontier::RowChange &change : changes) {
+            const int position = rowOfId(change.id);
+            std::optional<Row> row;
+            if (change.kind != Frontier::RowChange::Deleted) {
+                row = fetch(change.id);
+            }
+
+            if (!row) {
+                if (position >= 0) {
+                    removeRowAt(position);
+                }
+            } else if (position >= 0) {
+                setRow(position, std::move(*row));
+            } else {
+                insertRowAt(insertAt < 0 ? m_rows.size() : insertAt, std::move(*row));
+            }
+        }
+    }
+
+    // Linear; -1 when no row has this id
+    int rowOfId(int id) const
+    {
+        if (!m_rowId) {
+            return -1;
+        }
+        for (int i = 0; i < m_rows.size(); ++i) {
+            if (m_rowId(m_rows[i]) == id) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // === QAbstractTableModel ===
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows.size();
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_columns.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || index.row() >= m_rows.size()) {
+            return QVariant();
+        }
+
+        const Row &row = m_rows[index.row()];
+        const Column &column = m_columns[index.column()];
+
+        switch (role) {
+        case Qt::DisplayRole:
+            return column.text ? column.text(row)
+                               : formatValue(column.value(row), column.format, unitSystem(),
+                                             column.decimals);
+        case SortRole:
+            return column.value(row);
+        case RowIdRole:
+            return m_rowId ? QVariant(m_rowId(row)) : QVariant();
+        }
+
+        if (column.style) {
+            QVariant styled = column.style(row, role);
+            if (styled.isValid()) {
+                return styled;
+            }
+        }
+        if (m_rowStyle) {
+            QVariant styled = m_rowStyle(row, role);
+            if (styled.isValid()) {
+                return styled;
+            }
+        }
+        if (role == Qt::TextAlignmentRole && isNumeric(column.format)) {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override
+    {
+        if (orientation == Qt::Horizontal && role == Qt::DisplayRole
+            && section >= 0 && section < m_columns.size()) {
+            return m_columns[section].title;
+        }
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    // === Proxy hooks ===
+    bool lessThan(int column, int left, int right) const override
+    {
+        return m_columns[column].less(m_rows[left], m_rows[right]);
+    }
+
+    bool acceptsRow(int row) const override
+    {
+        return !m_filter || m_filter(m_rows[row]);
+    }
+
+protected:
+    bool hasUnitColumns() const override
+    {
+        for (const Column &column : m_columns) {
+            if (column.format >= ColumnFormat::Volume) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Column {
+        QString title;
+        ColumnFormat format = ColumnFormat::Text;
+        int decimals = -1;
+        ValueFn value;
+        LessFn less;
+        std::function<QString(const Row &)> text;
+        StyleFn style;
+    };
+
+    QVector<Column> m_columns;
+    QVector<Row> m_rows;
+    StyleFn m_rowStyle;
+    FilterFn m_filter;
+    IdFn m_rowId;
+};
+
+/**
+ * @brief Sort and filter proxy for a ColumnTableModel
+ *
+ * Sorting compares the typed getter results and filtering calls the
+ * model's row filter, so neither formats a cell or builds a QVariant.
+ */
+class ColumnSortProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ColumnSortProxy(ColumnTableModelBase *source, QObject *parent = nullptr);
+
+    // Source row behind a proxy index; -1 when invalid
+    int sourceRow(const QModelIndex &proxyIndex) const;
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QPointer<ColumnTableModelBase> m_source;
+};
+
+#endif // COLUMNTABLEMODEL_H
@@ -5,7 +5,12 @@
 
 #include "costanalysistab.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/recipegraph.h"
+#include "core/productionsolver.h"
 #include "core/types.h"
+#include "columntablemodel.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -13,6 +18,9 @@
 #include <QSplitter>
 #include <QHeaderView>
 #include <QFrame>
+#include <QDoubleSpinBox>
+#include <QSet>
+#include <QFont>
 #include <algorithm>
 
 // =============================================================================
@@ -25,6 +33,10 @@ CostAnalysisTab::CostAnalysisTab(Frontier::Database *database, QWidget *parent)
 {
     setupUi();
     refreshData();
+
+    // Prices and recipes feed every row; one reload per flush, when shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Items | Frontier::DataTable::Recipes,
+                                      [this]() { refreshData(); });
 }
 
 void CostAnalysisTab::setupUi()
@@ -39,6 +51,9 @@ void CostAnalysisTab::setupUi()
     // Filter bar
     mainLayout->addWidget(createFilterPanel());
 
+    // What-if prices
+    mainLayout->addWidget(createScenarioPanel());
+
     // Main content: splitter with table and details
     auto *splitter = new QSplitter(Qt::Horizontal);
 
@@ -47,12 +62,10 @@ void CostAnalysisTab::setupUi()
     auto *tableLayout = new QVBoxLayout(tableWidget);
     tableLayout->setContentsMargins(0, 0, 0, 0);
 
-    m_table = new QTableWidget();
-    m_table->setColumnCount(7);
-    m_table->setHorizontalHeaderLabels({
-        tr("Recipe"), tr("Building"), tr("Input Cost"),
-        tr("Output Value"), tr("Profit"), tr("Margin %"), tr("Notes")
-    });
+    setupTableModel();
+
+    m_table = new QTableView();
+    m_table->setModel(m_proxy);
     m_table->setAlternatingRowColors(true);
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_table->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -67,9 +80,10 @@ void CostAnalysisTab::setupUi()
     header->setSectionResizeMode(3, QHeaderView::ResizeToContents);  // Output Value
     header->setSectionResizeMode(4, QHeaderView::ResizeToContents);  // Profit
     header->setSectionResizeMode(5, QHeaderView::ResizeToContents);  // Margin
-    header->setSectionResizeMode(6, QHeaderView::Stretch);  // Notes
+    header->setSectionResizeMode(6, QHeaderView::ResizeToContents);  // What-If Profit
+    header->setSectionResizeMode(7, QHeaderView::Stretch);  // Notes
 
-    connect(m_table, &QTableWidget::itemSelectionChanged,
+    connect(m_table->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &CostAnalysisTab::onSelectionChanged);
 
     tableLayout->addWidget(m_table);
@@ -82,6 +96,81 @@ void CostAnalysisTab::setupUi()
     mainLayout->addWidget(splitter, 1);
 }
 
+void CostAnalysisTab::setupTableModel()
+{
+    // Green for gains, red for losses
+    auto signColor = [](double value) {
+        if (value > 0) return QVariant(QColor("#2e7d32"));
+        if (value < 0) return QVariant(QColor("#c62828"));
+        return QVariant();
+    };
+
+    m_model = new ColumnTableModel<RecipeProfitability>(this);
+    const int recipeColumn = m_model->addColumn(tr("Recipe"), ColumnFormat::Text,
+        [](const RecipeProfitability &recipe) { return recipe.outputItem; });
+    m_model->setColumnText(recipeColumn, [](const RecipeProfitability &recipe) {
+        // Recipe name (with qty if > 1)
+        if (recipe.outputQty > 1) {
+            return recipe.outputItem + QString(" (×%1)").arg(recipe.outputQty);
+        }
+        return recipe.outputItem;
+    });
+    m_model->addColumn(tr("Building"), ColumnFormat::Text,
+        [](const RecipeProfitability &recipe) { return recipe.workbenchName; });
+    m_model->addColumn(tr("Input Cost"), ColumnFormat::Currency,
+        [](const RecipeProfitability &recipe) { return recipe.inputCost; });
+    m_model->addColumn(tr("Output Value"), ColumnFormat::Currency,
+        [](const RecipeProfitability &recipe) { return recipe.outputValue; });
+    const int profitColumn = m_model->addColumn(tr("Profit"), ColumnFormat::Currency,
+        [](const RecipeProfitability &recipe) { return recipe.profit; });
+    m_model->setCellStyle(profitColumn, [signColor](const RecipeProfitability &recipe, int role) {
+        return role == Qt::ForegroundRole ? signColor(recipe.profit) : QVariant();
+    });
+    const int marginColumn = m_model->addColumn(tr("Margin %"), ColumnFormat::Percent,
+        [](const RecipeProfitability &recipe) { return recipe.marginPercent; });
+    m_model->setCellStyle(marginColumn, [signColor](const RecipeProfitability &recipe, int role) {
+        return role == Qt::ForegroundRole ? signColor(recipe.marginPercent) : QVariant();
+    });
+    const int scenarioColumn = m_model->addColumn(tr("What-If Profit"), ColumnFormat::Currency,
+        [](const RecipeProfitability &recipe) { return recipe.scenarioProfit; });
+    m_model->setCellStyle(scenarioColumn, [signColor](const RecipeProfitability &recipe, int role) {
+        if (role == Qt::ForegroundRole) {
+            return signColor(recipe.scenarioProfit);
+        }
+        if (role == Qt::FontRole && recipe.scenarioFlip != 0) {
+            QFont font;
+            font.setBold(true);
+            return QVariant(font);
+        }
+        return QVariant();
+    });
+    m_model->addColumn(tr("Notes"), ColumnFormat::Text,
+        [](const RecipeProfitability &recipe) { return recipe.notes; });
+
+    // Row color based on profitability
+    m_model->setRowStyle([](const RecipeProfitability &recipe, int role) {
+        if (role != Qt::BackgroundRole) {
+            return QVariant();
+        }
+        if (recipe.scenarioFlip < 0) {
+            return QVariant(QColor(255, 224, 178));  // Light orange - turns to a loss
+        } else if (recipe.scenarioFlip > 0) {
+            return QVariant(QColor(187, 222, 251));  // Light blue - turns to a profit
+        }
+        if (recipe.profit > 100) {
+            return QVariant(QColor(200, 230, 201));  // Light green - great profit
+        } else if (recipe.profit > 0) {
+            return QVariant(QColor(255, 249, 196));  // Light yellow - small profit
+        } else if (recipe.profit < 0) {
+            return QVariant(QColor(255, 205, 210));  // Light red - loss
+        }
+        return QVariant(QColor(Qt::white));          // Break even
+    });
+    m_model->setRowId([](const RecipeProfitability &recipe) { return recipe.recipeId; });
+
+    m_proxy = new ColumnSortProxy(m_model, this);
+}
+
 QWidget* CostAnalysisTab::createPodiumPanel()
 {
     auto *group = new QGroupBox(tr("Top Performers"));
@@ -182,6 +271,67 @@ QWidget* CostAnalysisTab::createFilterPanel()
     return group;
 }
 
+QWidget* CostAnalysisTab::createScenarioPanel()
+{
+    auto *group = new QGroupBox(tr("What-If Prices"));
+    auto *layout = new QHBoxLayout(group);
+
+    layout->addWidget(new QLabel(tr("Category:")));
+    m_scenarioCategoryCombo = new QComboBox();
+    m_scenarioCategoryCombo->addItem(tr("All Items"), QString());
+    layout->addWidget(m_scenarioCategoryCombo);
+
+    auto makePercentSpin = [this](const QString &tooltip) {
+        auto *spin = new QDoubleSpinBox();
+        spin->setRange(-100.0, 1000.0);
+        spin->setDecimals(1);
+        spin->setSingleStep(5.0);
+        spin->setSuffix("%");
+        spin->setToolTip(tooltip);
+        connect(spin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                this, &CostAnalysisTab::onScenarioChanged);
+        return spin;
+    };
+
+    layout->addWidget(new QLabel(tr("Buy:")));
+    m_scenarioBuySpin = makePercentSpin(tr("Shift buy prices of the category"));
+    layout->addWidget(m_scenarioBuySpin);
+
+    layout->addWidget(new QLabel(tr("Sell:")));
+    m_scenarioSellSpin = makePercentSpin(tr("Shift sell prices of the category"));
+    layout->addWidget(m_scenarioSellSpin);
+
+    // As a custom pricing group would: sell at a fixed share of buy
+    layout->addWidget(new QLabel(tr("Sell/Buy:")));
+    m_scenarioRatioSpin = new QDoubleSpinBox();
+    m_scenarioRatioSpin->setRange(0.0, 500.0);
+    m_scenarioRatioSpin->setDecimals(0);
+    m_scenarioRatioSpin->setSingleStep(5.0);
+    m_scenarioRatioSpin->setSuffix("%");
+    m_scenarioRatioSpin->setSpecialValueText(tr("Catalog"));
+    m_scenarioRatioSpin->setToolTip(tr("Reprice sell as this share of the (shifted) buy price"));
+    connect(m_scenarioRatioSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &CostAnalysisTab::onScenarioChanged);
+    layout->addWidget(m_scenarioRatioSpin);
+
+    connect(m_scenarioCategoryCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CostAnalysisTab::onScenarioChanged);
+
+    layout->addStretch();
+
+    auto *resultLayout = new QVBoxLayout();
+    m_scenarioSummary = new QLabel();
+    m_scenarioSummary->setAlignment(Qt::AlignRight);
+    resultLayout->addWidget(m_scenarioSummary);
+    m_scenarioSensitivity = new QLabel();
+    m_scenarioSensitivity->setAlignment(Qt::AlignRight);
+    m_scenarioSensitivity->setStyleSheet("color: #666;");
+    resultLayout->addWidget(m_scenarioSensitivity);
+    layout->addLayout(resultLayout);
+
+    return group;
+}
+
 QWidget* CostAnalysisTab::createDetailsPanel()
 {
     auto *group = new QGroupBox(tr("Recipe Details"));
@@ -277,6 +427,9 @@ QWidget* CostAnalysisTab::createDetailsPanel()
 
 void CostAnalysisTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("CostAnalysisTab::refreshData");
+    m_database->changeBus().acknowledge(this);
+
     // Populate workbench filter
     m_workbenchCombo->blockSignals(true);
     QString currentWorkbench = m_workbenchCombo->currentText();
@@ -297,175 +450,170 @@ void CostAnalysisTab::refreshData()
 
 void CostAnalysisTab::loadRecipeProfitability()
 {
-    m_allRecipes.clear();
-
-    auto recipes = m_database->getAllRecipes();
-    for (const auto &recipe : recipes) {
-        RecipeProfitability prof = calculateRecipeProfitability(recipe);
-        m_allRecipes.append(prof);
+    FRONTIER_TRACE_SCOPE("CostAnalysisTab::loadRecipeProfitability");
+    QVector<RecipeProfitability> recipes;
+
+    Frontier::ProductionSolver solver(m_database->recipeGraph());
+    const auto economics = solver.evaluateRecipes(m_database->itemCatalog());
+    recipes.reserve(economics.size());
+
+    for (const auto &econ : economics) {
+        const Frontier::Recipe &recipe = solver.graph()->recipe(econ.recipeIndex);
+
+        RecipeProfitability prof;
+        prof.recipeId = recipe.id.value_or(0);
+        prof.recipeIndex = econ.recipeIndex;
+        prof.outputItem = recipe.outputItem;
+        prof.outputQty = recipe.outputQty;
+        prof.workbenchName = recipe.workbenchName;
+        prof.notes = recipe.notes;
+        prof.inputCost = econ.inputCost;
+        prof.outputValue = econ.outputValue;
+        prof.profit = econ.profit;
+        prof.marginPercent = econ.marginPercent;
+        prof.scenarioProfit = econ.profit;
+        for (const auto &ing : recipe.ingredients) {
+            prof.ingredients.append({ing.itemName, ing.quantity});
+        }
+        recipes.append(prof);
     }
 
     // Sort by profit descending
-    std::sort(m_allRecipes.begin(), m_allRecipes.end(),
+    std::sort(recipes.begin(), recipes.end(),
               [](const RecipeProfitability &a, const RecipeProfitability &b) {
                   return a.profit > b.profit;
               });
+    m_model->setRows(std::move(recipes));
+
+    // Compiled once per load; moving the what-if controls only reruns it
+    m_scenarios.compile(solver.graph(), m_database->itemCatalog());
+    const QString currentCategory = m_scenarioCategoryCombo->currentData().toString();
+    m_scenarioCategoryCombo->blockSignals(true);
+    m_scenarioCategoryCombo->clear();
+    m_scenarioCategoryCombo->addItem(tr("All Items"), QString());
+    for (const QString &category : m_scenarios.categories()) {
+        m_scenarioCategoryCombo->addItem(category, category);
+    }
+    m_scenarioCategoryCombo->setCurrentIndex(qMax(0, m_scenarioCategoryCombo->findData(currentCategory)));
+    m_scenarioCategoryCombo->blockSignals(false);
 
     applyFilters();
     updatePodium();
+    runScenario();
 }
 
-RecipeProfitability CostAnalysisTab::calculateRecipeProfitability(const Frontier::Recipe &recipe)
+void CostAnalysisTab::runScenario()
 {
-    RecipeProfitability prof;
-    prof.recipeId = recipe.id.value_or(0);
-    prof.outputItem = recipe.outputItem;
-    prof.outputQty = recipe.outputQty;
-    prof.workbenchName = recipe.workbenchName;
-    prof.notes = recipe.notes;
-
-    // Calculate input cost from ingredients
-    prof.inputCost = 0.0;
-    for (const auto &ing : recipe.ingredients) {
-        auto item = m_database->getItemByName(ing.itemName);
-        if (item.has_value()) {
-            // Use buy price (base price) for input cost
-            prof.inputCost += item->buyPriceInternal * ing.quantity;
+    Frontier::PriceAdjustment adjustment;
+    adjustment.category = m_scenarioCategoryCombo->currentData().toString();
+    adjustment.buyPercent = m_scenarioBuySpin->value();
+    adjustment.sellPercent = m_scenarioSellSpin->value();
+    adjustment.sellRatio = m_scenarioRatioSpin->value() / 100.0;
+    const bool active = adjustment.buyPercent != 0 || adjustment.sellPercent != 0
+                        || adjustment.sellRatio > 0;
+
+    // The chosen scenario first, then the same shifts on each category alone
+    // in the same batch to find the category the book is most exposed to
+    QVector<Frontier::PriceScenario> batch;
+    if (active && m_scenarios.isCompiled()) {
+        batch.append({tr("What-If"), {adjustment}});
+        if (adjustment.category.isEmpty()) {
+            for (const QString &category : m_scenarios.categories()) {
+                Frontier::PriceAdjustment single = adjustment;
+                single.category = category;
+                batch.append({category, {single}});
+            }
         }
-        prof.ingredients.append({ing.itemName, ing.quantity});
     }
-
-    // Calculate output value
-    auto outputItem = m_database->getItemByName(recipe.outputItem);
-    if (outputItem.has_value()) {
-        // Use sell price internal for output value
-        prof.outputValue = outputItem->sellPriceInternal * recipe.outputQty;
+    const QVector<Frontier::ScenarioResult> results = m_scenarios.run(batch);
+
+    // Only rows whose what-if figures moved repaint; the model is not reset
+    const Frontier::ScenarioResult *whatIf = results.isEmpty() ? nullptr : &results.first();
+    QSet<int> turnedLoss;
+    QSet<int> turnedProfit;
+    if (whatIf) {
+        turnedLoss = QSet<int>(whatIf->turnedLoss.begin(), whatIf->turnedLoss.end());
+        turnedProfit = QSet<int>(whatIf->turnedProfit.begin(), whatIf->turnedProfit.end());
     }
-
-    // Calculate profit and margin
-    prof.profit = prof.outputValue - prof.inputCost;
-    if (prof.inputCost > 0) {
-        prof.marginPercent = (prof.profit / prof.inputCost) * 100.0;
+    const QVector<RecipeProfitability> &rows = m_model->rows();
+    for (int i = 0; i < rows.size(); ++i) {
+        RecipeProfitability row = rows[i];
+        const int index = row.recipeIndex;
+        const bool known = whatIf && index >= 0 && index < whatIf->profit.size();
+        const double profit = known ? whatIf->profit[index] : row.profit;
+        const int flip = !known ? 0 : turnedLoss.contains(index) ? -1 : turnedProfit.contains(index) ? 1 : 0;
+        if (profit != row.scenarioProfit || flip != row.scenarioFlip) {
+            row.scenarioProfit = profit;
+            row.scenarioFlip = flip;
+            m_model->setRow(i, std::move(row));
+        }
     }
+    m_model->flushChanges();
 
-    return prof;
+    if (!whatIf) {
+        m_scenarioSummary->setText(tr("Shift prices to see which recipes flip"));
+        m_scenarioSensitivity->clear();
+        return;
+    }
+    m_scenarioSummary->setText(tr("%1 turn to a loss, %2 to a profit (total %3 per run)")
+                                   .arg(whatIf->turnedLoss.size())
+                                   .arg(whatIf->turnedProfit.size())
+                                   .arg(QString("%1$%L2").arg(whatIf->profitDelta >= 0 ? "+" : "-")
+                                            .arg(qAbs(whatIf->profitDelta), 0, 'f', 2)));
+
+    const Frontier::ScenarioResult *mostExposed = nullptr;
+    for (int i = 1; i < results.size(); ++i) {
+        const int flips = results[i].turnedLoss.size() + results[i].turnedProfit.size();
+        if (flips > 0 && (!mostExposed
+                          || flips > mostExposed->turnedLoss.size() + mostExposed->turnedProfit.size())) {
+            mostExposed = &results[i];
+        }
+    }
+    if (mostExposed) {
+        m_scenarioSensitivity->setText(tr("Most sensitive category: %1 (%2 recipes flip)")
+                                           .arg(mostExposed->name)
+                                           .arg(mostExposed->turnedLoss.size() + mostExposed->turnedProfit.size()));
+    } else {
+        m_scenarioSensitivity->clear();
+    }
 }
 
 void CostAnalysisTab::applyFilters()
 {
-    QString workbenchFilter = m_workbenchCombo->currentText();
-
-    m_filteredRecipes.clear();
-
-    for (const auto &recipe : m_allRecipes) {
-        if (workbenchFilter != tr("All Buildings") && recipe.workbenchName != workbenchFilter) {
-            continue;
-        }
-        m_filteredRecipes.append(recipe);
-    }
+    const QString workbenchFilter = m_workbenchCombo->currentText();
+    const bool byWorkbench = workbenchFilter != tr("All Buildings");
 
-    populateTable();
+    m_model->setFilter([byWorkbench, workbenchFilter](const RecipeProfitability &recipe) {
+        return !byWorkbench || recipe.workbenchName == workbenchFilter;
+    });
 
     // Update summary
     auto *summaryLabel = findChild<QLabel*>("summaryLabel");
     if (summaryLabel) {
         summaryLabel->setText(tr("Showing %1 of %2 recipes")
-                                  .arg(m_filteredRecipes.size())
-                                  .arg(m_allRecipes.size()));
-    }
-}
-
-void CostAnalysisTab::populateTable()
-{
-    m_table->setSortingEnabled(false);
-    m_table->setRowCount(m_filteredRecipes.size());
-
-    for (int row = 0; row < m_filteredRecipes.size(); ++row) {
-        const auto &recipe = m_filteredRecipes[row];
-
-        // Recipe name (with qty if > 1)
-        QString recipeName = recipe.outputItem;
-        if (recipe.outputQty > 1) {
-            recipeName += QString(" (×%1)").arg(recipe.outputQty);
-        }
-        auto *nameItem = new QTableWidgetItem(recipeName);
-        nameItem->setData(Qt::UserRole, recipe.recipeId);
-        m_table->setItem(row, 0, nameItem);
-
-        // Building
-        m_table->setItem(row, 1, new QTableWidgetItem(recipe.workbenchName));
-
-        // Input Cost
-        auto *inputItem = new QTableWidgetItem(QString("$%L1").arg(recipe.inputCost, 0, 'f', 2));
-        inputItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        inputItem->setData(Qt::UserRole, recipe.inputCost);
-        m_table->setItem(row, 2, inputItem);
-
-        // Output Value
-        auto *outputItem = new QTableWidgetItem(QString("$%L1").arg(recipe.outputValue, 0, 'f', 2));
-        outputItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        outputItem->setData(Qt::UserRole, recipe.outputValue);
-        m_table->setItem(row, 3, outputItem);
-
-        // Profit
-        auto *profitItem = new QTableWidgetItem(QString("$%L1").arg(recipe.profit, 0, 'f', 2));
-        profitItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        profitItem->setData(Qt::UserRole, recipe.profit);
-        if (recipe.profit > 0) {
-            profitItem->setForeground(QColor("#2e7d32"));
-        } else if (recipe.profit < 0) {
-            profitItem->setForeground(QColor("#c62828"));
-        }
-        m_table->setItem(row, 4, profitItem);
-
-        // Margin %
-        auto *marginItem = new QTableWidgetItem(QString("%1%").arg(recipe.marginPercent, 0, 'f', 1));
-        marginItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        marginItem->setData(Qt::UserRole, recipe.marginPercent);
-        if (recipe.marginPercent > 0) {
-            marginItem->setForeground(QColor("#2e7d32"));
-        } else if (recipe.marginPercent < 0) {
-            marginItem->setForeground(QColor("#c62828"));
-        }
-        m_table->setItem(row, 5, marginItem);
-
-        // Notes
-        m_table->setItem(row, 6, new QTableWidgetItem(recipe.notes));
-
-        // Row color based on profitability
-        QColor rowColor;
-        if (recipe.profit > 100) {
-            rowColor = QColor(200, 230, 201);  // Light green - great profit
-        } else if (recipe.profit > 0) {
-            rowColor = QColor(255, 249, 196);  // Light yellow - small profit
-        } else if (recipe.profit < 0) {
-            rowColor = QColor(255, 205, 210);  // Light red - loss
-        } else {
-            rowColor = Qt::white;  // Break even
-        }
-
-        for (int col = 0; col < 7; ++col) {
-            if (auto *item = m_table->item(row, col)) {
-                item->setBackground(rowColor);
-            }
-        }
+                                  .arg(m_proxy->rowCount())
+                                  .arg(m_model->rowCount()));
     }
-
-    m_table->setSortingEnabled(true);
 }
 
 void CostAnalysisTab::updatePodium()
 {
-    // Sort all recipes by profit for podium (not filtered)
-    QVector<RecipeProfitability> sorted = m_allRecipes;
-    std::sort(sorted.begin(), sorted.end(),
-              [](const RecipeProfitability &a, const RecipeProfitability &b) {
-                  return a.profit > b.profit;
-              });
+    // Podium only needs the top three of all recipes (not filtered)
+    QVector<const RecipeProfitability *> sorted;
+    sorted.reserve(m_model->rows().size());
+    for (const auto &recipe : m_model->rows()) {
+        sorted.append(&recipe);
+    }
+    const int podiumSize = qMin<int>(3, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + podiumSize, sorted.end(),
+                      [](const RecipeProfitability *a, const RecipeProfitability *b) {
+                          return a->profit > b->profit;
+                      });
+    sorted.resize(podiumSize);
 
     // First place
     if (sorted.size() >= 1) {
-        const auto &first = sorted[0];
+        const auto &first = *sorted[0];
         m_firstPlaceName->setText(first.outputItem);
         m_firstPlaceProfit->setText(QString("$%L1").arg(first.profit, 0, 'f', 2));
         m_firstPlaceMargin->setText(QString("%1% margin").arg(first.marginPercent, 0, 'f', 1));
@@ -477,7 +625,7 @@ void CostAnalysisTab::updatePodium()
 
     // Second place
     if (sorted.size() >= 2) {
-        const auto &second = sorted[1];
+        const auto &second = *sorted[1];
         m_secondPlaceName->setText(second.outputItem);
         m_secondPlaceProfit->setText(QString("$%L1").arg(second.profit, 0, 'f', 2));
         m_secondPlaceMargin->setText(QString("%1% margin").arg(second.marginPercent, 0, 'f', 1));
@@ -489,7 +637,7 @@ void CostAnalysisTab::updatePodium()
 
     // Third place
     if (sorted.size() >= 3) {
-        const auto &third = sorted[2];
+        const auto &third = *sorted[2];
         m_thirdPlaceName->setText(third.outputItem);
         m_thirdPlaceProfit->setText(QString("$%L1").arg(third.profit, 0, 'f', 2));
         m_thirdPlaceMargin->setText(QString("%1% margin").arg(third.marginPercent, 0, 'f', 1));
@@ -502,7 +650,7 @@ void CostAnalysisTab::updatePodium()
 
 void CostAnalysisTab::updateDetails()
 {
-    auto selected = m_table->selectedItems();
+    const QModelIndexList selected = m_table->selectionModel()->selectedRows();
     if (selected.isEmpty()) {
         m_detailsTitle->setText(tr("Select a recipe to view details"));
         m_detailsWorkbench->setText("-");
@@ -515,12 +663,12 @@ void CostAnalysisTab::updateDetails()
         return;
     }
 
-    int row = selected.first()->row();
-    if (row < 0 || row >= m_filteredRecipes.size()) {
+    const int row = m_proxy->sourceRow(selected.first());
+    if (row < 0 || row >= m_model->rows().size()) {
         return;
     }
 
-    const auto &recipe = m_filteredRecipes[row];
+    const auto &recipe = m_model->rowAt(row);
 
     // Title
     QString title = recipe.outputItem;
@@ -582,3 +730,8 @@ void CostAnalysisTab::onSelectionChanged()
 {
     updateDetails();
 }
+
+void CostAnalysisTab::onScenarioChanged()
+{
+    runScenario();
+}
@@ -7,22 +7,28 @@
 #define COSTANALYSISTAB_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QComboBox>
 #include <QLabel>
 #include <QFrame>
+#include <QDoubleSpinBox>
 
 #include "core/types.h"
+#include "core/pricescenarioengine.h"
 
 namespace Frontier {
 class Database;
 }
 
+template<typename Row> class ColumnTableModel;
+class ColumnSortProxy;
+
 /**
  * @brief Struct to hold calculated recipe profitability data
  */
 struct RecipeProfitability {
     int recipeId = 0;
+    int recipeIndex = -1;       // In the recipe graph
     QString outputItem;
     int outputQty = 1;
     QString workbenchName;
@@ -32,6 +38,10 @@ struct RecipeProfitability {
     double profit = 0.0;
     double marginPercent = 0.0;
 
+    // Under the what-if prices
+    double scenarioProfit = 0.0;
+    int scenarioFlip = 0;       // -1 turns to a loss, +1 to a profit
+
     // For ingredient details
     QVector<QPair<QString, int>> ingredients;  // name, quantity
 };
@@ -49,27 +59,29 @@ public slots:
 private slots:
     void onFilterChanged();
     void onSelectionChanged();
+    void onScenarioChanged();
 
 private:
     void setupUi();
     QWidget* createPodiumPanel();
     QWidget* createFilterPanel();
+    QWidget* createScenarioPanel();
     QWidget* createDetailsPanel();
     QFrame* createPodiumCard(const QString &title, const QString &color);
 
     void loadRecipeProfitability();
+    void setupTableModel();
     void applyFilters();
-    void populateTable();
     void updatePodium();
     void updateDetails();
-
-    RecipeProfitability calculateRecipeProfitability(const Frontier::Recipe &recipe);
+    void runScenario();
 
     Frontier::Database *m_database;
 
-    // Data
-    QVector<RecipeProfitability> m_allRecipes;
-    QVector<RecipeProfitability> m_filteredRecipes;
+    // Data: every recipe, most profitable first; the proxy filters it
+    ColumnTableModel<RecipeProfitability> *m_model;
+    ColumnSortProxy *m_proxy;
+    Frontier::PriceScenarioEngine m_scenarios;
 
     // Podium labels
     QLabel *m_firstPlaceName;
@@ -87,8 +99,16 @@ private:
     // Filters
     QComboBox *m_workbenchCombo;
 
+    // What-if prices
+    QComboBox *m_scenarioCategoryCombo;
+    QDoubleSpinBox *m_scenarioBuySpin;
+    QDoubleSpinBox *m_scenarioSellSpin;
+    QDoubleSpinBox *m_scenarioRatioSpin;
+    QLabel *m_scenarioSummary;
+    QLabel *m_scenarioSensitivity;
+
     // Table
-    QTableWidget *m_table;
+    QTableView *m_table;
 
     // Details panel
     QLabel *m_detailsTitle;
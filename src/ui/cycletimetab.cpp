@@ -5,6 +5,9 @@
 
 #include "cycletimetab.h"
 #include "core/database.h"
+#include "core/routematrix.h"
+#include "columntablemodel.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -18,6 +21,7 @@
 #include <QSplitter>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QColor>
 
 
 // =============================================================================
@@ -28,12 +32,25 @@ CycleTimeTab::CycleTimeTab(Frontier::Database *database, QWidget *parent)
     : QWidget(parent)
     , m_database(database)
     , m_currentPhase(0)
+    , m_routeMatrix(new Frontier::RouteMatrix(database, this))
 {
     m_timer = new QTimer(this);
+    m_timer->setInterval(DisplayIntervalMs);
     connect(m_timer, &QTimer::timeout, this, &CycleTimeTab::onTimerTick);
 
     setupUi();
+    connect(m_routeMatrix, &Frontier::RouteMatrix::changed, this, [this]() {
+        updateHeatmap();
+        updateFastestRoute();
+    });
+    m_routeMatrix->reload();
     refreshData();
+
+    m_database->changeBus().subscribe(this, Frontier::DataTable::CycleTimes,
+                                      [this]() { loadProfiles(); });
+    m_database->changeBus().setRowPatcher(this, [this](const QVector<Frontier::RowChange> &changes) {
+        return patchRecords(changes);
+    });
 }
 
 void CycleTimeTab::setupUi()
@@ -52,8 +69,12 @@ void CycleTimeTab::setupUi()
     middleSplitter->setSizes({500, 300});
     mainLayout->addWidget(middleSplitter);
 
-    // Bottom: History
-    mainLayout->addWidget(createHistoryPanel(), 1);
+    // Bottom: History + Route matrix
+    auto *bottomSplitter = new QSplitter(Qt::Horizontal);
+    bottomSplitter->addWidget(createHistoryPanel());
+    bottomSplitter->addWidget(createRoutePanel());
+    bottomSplitter->setSizes({500, 300});
+    mainLayout->addWidget(bottomSplitter, 1);
 }
 
 QWidget* CycleTimeTab::createProfilePanel()
@@ -249,6 +270,21 @@ QWidget* CycleTimeTab::createStatsPanel()
     m_worstTimeLabel->setStyleSheet("font-size: 16px; font-weight: bold; color: #c62828;");
     formLayout->addRow(tr("Worst Cycle:"), m_worstTimeLabel);
 
+    m_p50TimeLabel = new QLabel("-");
+    formLayout->addRow(tr("Median (p50):"), m_p50TimeLabel);
+
+    m_p90TimeLabel = new QLabel("-");
+    formLayout->addRow(tr("p90:"), m_p90TimeLabel);
+
+    m_phaseAvgLabel = new QLabel("-");
+    m_phaseAvgLabel->setStyleSheet("color: #666;");
+    formLayout->addRow(tr("Phase Averages:"), m_phaseAvgLabel);
+
+    m_fastestLabel = new QLabel("-");
+    m_fastestLabel->setToolTip(tr("Fastest timed route from this profile's source to a "
+                                  "destination of the same type"));
+    formLayout->addRow(tr("Fastest From Source:"), m_fastestLabel);
+
     layout->addLayout(formLayout);
     layout->addStretch();
 
@@ -260,12 +296,10 @@ QWidget* CycleTimeTab::createHistoryPanel()
     auto *group = new QGroupBox(tr("Cycle History"));
     auto *layout = new QVBoxLayout(group);
 
-    m_historyTable = new QTableWidget();
-    m_historyTable->setColumnCount(8);
-    m_historyTable->setHorizontalHeaderLabels({
-        tr("Date/Time"), tr("Load"), tr("Haul"), tr("Dump"),
-        tr("Return"), tr("Total"), tr("vs Avg"), tr("Notes")
-    });
+    setupHistoryModel();
+
+    m_historyTable = new QTableView();
+    m_historyTable->setModel(m_historyProxy);
     m_historyTable->setAlternatingRowColors(true);
     m_historyTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_historyTable->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -283,7 +317,7 @@ QWidget* CycleTimeTab::createHistoryPanel()
     header->setSectionResizeMode(6, QHeaderView::ResizeToContents);
     header->setSectionResizeMode(7, QHeaderView::Stretch);
 
-    connect(m_historyTable, &QTableWidget::itemSelectionChanged,
+    connect(m_historyTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &CycleTimeTab::onRecordSelected);
 
     layout->addWidget(m_historyTable);
@@ -300,12 +334,116 @@ QWidget* CycleTimeTab::createHistoryPanel()
     return group;
 }
 
+QWidget* CycleTimeTab::createRoutePanel()
+{
+    auto *group = new QGroupBox(tr("Route Matrix"));
+    auto *layout = new QVBoxLayout(group);
+
+    auto *optionsLayout = new QHBoxLayout();
+    optionsLayout->addWidget(new QLabel(tr("Map:")));
+    m_heatmapMapCombo = new QComboBox();
+    for (const Frontier::Map &map : m_database->getAllMaps()) {
+        m_heatmapMapCombo->addItem(map.name, map.id.value_or(0));
+    }
+    optionsLayout->addWidget(m_heatmapMapCombo);
+
+    m_heatmapMetricCombo = new QComboBox();
+    m_heatmapMetricCombo->addItem(tr("Average Cycle"), static_cast<int>(Frontier::RouteMetric::AvgSeconds));
+    m_heatmapMetricCombo->addItem(tr("p90 Cycle"), static_cast<int>(Frontier::RouteMetric::P90Seconds));
+    m_heatmapMetricCombo->addItem(tr("m³ / Truck Hour"), static_cast<int>(Frontier::RouteMetric::M3PerTruckHour));
+    m_heatmapMetricCombo->addItem(tr("Records"), static_cast<int>(Frontier::RouteMetric::Records));
+    optionsLayout->addWidget(m_heatmapMetricCombo);
+    optionsLayout->addStretch();
+    layout->addLayout(optionsLayout);
+
+    m_heatmapTable = new QTableWidget();
+    m_heatmapTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_heatmapTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_heatmapTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_heatmapTable);
+
+    connect(m_heatmapMapCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CycleTimeTab::updateHeatmap);
+    connect(m_heatmapMetricCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CycleTimeTab::updateHeatmap);
+
+    return group;
+}
+
+void CycleTimeTab::updateHeatmap()
+{
+    const auto metric = static_cast<Frontier::RouteMetric>(m_heatmapMetricCombo->currentData().toInt());
+    const Frontier::RouteHeatmap map = m_routeMatrix->heatmap(m_heatmapMapCombo->currentData().toInt(), metric);
+
+    m_heatmapTable->clear();
+    m_heatmapTable->setRowCount(map.sourceIds.size());
+    m_heatmapTable->setColumnCount(map.destIds.size());
+    m_heatmapTable->setVerticalHeaderLabels(map.sourceNames);
+    m_heatmapTable->setHorizontalHeaderLabels(map.destNames);
+
+    // Green is the good end: short cycles, high rates
+    const bool higherIsBetter = metric == Frontier::RouteMetric::M3PerTruckHour
+                                || metric == Frontier::RouteMetric::Records;
+    const double span = map.maxValue - map.minValue;
+    for (int row = 0; row < map.sourceIds.size(); ++row) {
+        for (int column = 0; column < map.destIds.size(); ++column) {
+            const double value = map.value(row, column);
+            if (value <= 0) {
+                continue;
+            }
+            QString text;
+            switch (metric) {
+            case Frontier::RouteMetric::AvgSeconds:
+            case Frontier::RouteMetric::P90Seconds:
+                text = formatSeconds(int(value));
+                break;
+            case Frontier::RouteMetric::M3PerTruckHour:
+                text = QString::number(value, 'f', 1);
+                break;
+            case Frontier::RouteMetric::Records:
+                text = QString::number(int(value));
+                break;
+            }
+
+            double good = span > 0 ? (value - map.minValue) / span : 1.0;
+            if (!higherIsBetter) {
+                good = 1.0 - good;
+            }
+            auto *item = new QTableWidgetItem(text);
+            item->setTextAlignment(Qt::AlignCenter);
+            item->setBackground(QColor::fromHsvF(good / 3.0, 0.45, 0.95));
+            m_heatmapTable->setItem(row, column, item);
+        }
+    }
+}
+
+void CycleTimeTab::updateFastestRoute()
+{
+    const Frontier::CycleProfile *profile = currentProfile();
+    const Frontier::RouteCell *own = profile ? m_routeMatrix->route(profile->sourceLocationId,
+                                                                    profile->destLocationId)
+                                             : nullptr;
+    const Frontier::RouteCell *fastest =
+        profile ? m_routeMatrix->fastestFrom(profile->sourceLocationId, own ? own->destTypeId : 0) : nullptr;
+    if (!fastest) {
+        m_fastestLabel->setText("-");
+        return;
+    }
+
+    QString text = tr("%1 (%2)").arg(fastest->destName, formatSeconds(fastest->avgSeconds()));
+    if (own && own != fastest && own->stats.count > 0) {
+        text += tr(", %1 faster").arg(formatSeconds(own->avgSeconds() - fastest->avgSeconds()));
+    }
+    m_fastestLabel->setText(text);
+}
+
 // =============================================================================
 // Data Loading
 // =============================================================================
 
 void CycleTimeTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("CycleTimeTab::refreshData");
     loadProfiles();
 }
 
@@ -336,89 +474,149 @@ void CycleTimeTab::loadProfiles()
     onProfileSelected();
 }
 
+void CycleTimeTab::setupHistoryModel()
+{
+    using Frontier::CycleRecord;
+
+    m_historyModel = new ColumnTableModel<CycleRecord>(this);
+    m_historyModel->addColumn(tr("Date/Time"), ColumnFormat::DateTime,
+                              [](const CycleRecord &record) { return record.timestamp; });
+
+    // Phase times sort by seconds and read as m:ss
+    auto addPhase = [this](const QString &title, int CycleRecord::*seconds) {
+        const int column = m_historyModel->addColumn(title, ColumnFormat::Integer,
+            [seconds](const CycleRecord &record) { return record.*seconds; });
+        m_historyModel->setColumnText(column, [this, seconds](const CycleRecord &record) {
+            return formatSeconds(record.*seconds);
+        });
+    };
+    addPhase(tr("Load"), &CycleRecord::loadSeconds);
+    addPhase(tr("Haul"), &CycleRecord::haulSeconds);
+    addPhase(tr("Dump"), &CycleRecord::dumpSeconds);
+    addPhase(tr("Return"), &CycleRecord::returnSeconds);
+    addPhase(tr("Total"), &CycleRecord::totalSeconds);
+
+    // vs Avg: difference from the profile average, green when faster
+    m_vsAverageColumn = m_historyModel->addColumn(tr("vs Avg"), ColumnFormat::Integer,
+        [this](const CycleRecord &record) {
+            return m_avgTotalSeconds > 0 ? record.totalSeconds - m_avgTotalSeconds : 0;
+        });
+    m_historyModel->setColumnText(m_vsAverageColumn, [this](const CycleRecord &record) {
+        if (m_avgTotalSeconds <= 0) {
+            return QString("-");
+        }
+        const int diff = record.totalSeconds - m_avgTotalSeconds;
+        if (diff < 0) {
+            return QString("-%1").arg(formatSeconds(-diff));
+        } else if (diff > 0) {
+            return QString("+%1").arg(formatSeconds(diff));
+        }
+        return QString("=");
+    });
+    m_historyModel->setCellStyle(m_vsAverageColumn, [this](const CycleRecord &record, int role) {
+        if (role != Qt::ForegroundRole || m_avgTotalSeconds <= 0) {
+            return QVariant();
+        }
+        const int diff = record.totalSeconds - m_avgTotalSeconds;
+        if (diff < 0) {
+            return QVariant(QColor("#2e7d32"));  // Green - faster
+        } else if (diff > 0) {
+            return QVariant(QColor("#c62828"));  // Red - slower
+        }
+        return QVariant(QColor("#666"));
+    });
+
+    m_historyModel->addColumn(tr("Notes"), ColumnFormat::Text,
+                              [](const CycleRecord &record) { return record.notes; });
+    m_historyModel->setRowId([](const CycleRecord &record) { return record.id.value_or(0); });
+
+    m_historyProxy = new ColumnSortProxy(m_historyModel, this);
+}
+
 void CycleTimeTab::loadRecordsForProfile(int profileId)
 {
-    m_records = m_database->getCycleRecordsByProfile(profileId);
+    QVector<Frontier::CycleRecord> records = m_database->getCycleRecordsByProfile(profileId);
 
-    // Find the profile for avg calculation
-    int avgSeconds = 0;
-    for (const auto &profile : m_profiles) {
-        if (profile.id.value_or(0) == profileId) {
-            avgSeconds = profile.avgTotalSeconds;
-            break;
-        }
+    m_stats = Frontier::CycleStats();
+    for (const auto &record : records) {
+        m_stats.add(record);
     }
 
-    m_historyTable->setSortingEnabled(false);
-    m_historyTable->setRowCount(m_records.size());
-
-    for (int row = 0; row < m_records.size(); ++row) {
-        const auto &record = m_records[row];
-
-        // Date/Time
-        auto *dateItem = new QTableWidgetItem(record.timestamp.toString("yyyy-MM-dd hh:mm"));
-        dateItem->setData(Qt::UserRole, record.id.value_or(0));
-        m_historyTable->setItem(row, 0, dateItem);
-
-        // Load
-        auto *loadItem = new QTableWidgetItem(formatSeconds(record.loadSeconds));
-        loadItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 1, loadItem);
-
-        // Haul
-        auto *haulItem = new QTableWidgetItem(formatSeconds(record.haulSeconds));
-        haulItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 2, haulItem);
-
-        // Dump
-        auto *dumpItem = new QTableWidgetItem(formatSeconds(record.dumpSeconds));
-        dumpItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 3, dumpItem);
-
-        // Return
-        auto *returnItem = new QTableWidgetItem(formatSeconds(record.returnSeconds));
-        returnItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 4, returnItem);
-
-        // Total
-        auto *totalItem = new QTableWidgetItem(formatSeconds(record.totalSeconds));
-        totalItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        totalItem->setData(Qt::UserRole, record.totalSeconds);
-        m_historyTable->setItem(row, 5, totalItem);
-
-        // vs Avg
-        QString vsAvg = "-";
-        QColor vsColor;
-        if (avgSeconds > 0) {
-            int diff = record.totalSeconds - avgSeconds;
-            if (diff < 0) {
-                vsAvg = QString("-%1").arg(formatSeconds(-diff));
-                vsColor = QColor("#2e7d32");  // Green - faster
-            } else if (diff > 0) {
-                vsAvg = QString("+%1").arg(formatSeconds(diff));
-                vsColor = QColor("#c62828");  // Red - slower
-            } else {
-                vsAvg = "=";
-                vsColor = QColor("#666");
-            }
+    m_historyModel->setRows(std::move(records));
+    updateVsAverage();
+}
+
+// Records of the shown profile are patched into the history and its stats
+// recomputed from the rows; a record of any other profile changes that
+// profile's count, so it falls back to reloading the profiles
+bool CycleTimeTab::patchRecords(const QVector<Frontier::RowChange> &changes)
+{
+    const int profileId = m_profileCombo->currentData().toInt();
+    if (profileId <= 0) {
+        return false;
+    }
+
+    bool otherProfile = false;
+    for (const Frontier::RowChange &change : changes) {
+        if (change.kind == Frontier::RowChange::Deleted && m_historyModel->rowOfId(change.id) < 0) {
+            otherProfile = true;
         }
-        auto *vsItem = new QTableWidgetItem(vsAvg);
-        vsItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        if (vsColor.isValid()) {
-            vsItem->setForeground(vsColor);
+    }
+    m_historyModel->applyRowChanges(changes, [&](int id) -> std::optional<Frontier::CycleRecord> {
+        std::optional<Frontier::CycleRecord> record = m_database->getCycleRecord(id);
+        if (record && record->profileId != profileId) {
+            otherProfile = true;
+            return std::nullopt;
         }
-        m_historyTable->setItem(row, 6, vsItem);
+        return record;
+    });
+    if (otherProfile) {
+        return false;
+    }
 
-        // Notes
-        m_historyTable->setItem(row, 7, new QTableWidgetItem(record.notes));
+    m_stats = Frontier::CycleStats();
+    for (const auto &record : m_historyModel->rows()) {
+        m_stats.add(record);
+    }
+    if (Frontier::CycleProfile *profile = currentProfile()) {
+        m_stats.applyTo(*profile);
+        QString display = profile->name;
+        if (profile->recordCount > 0) {
+            display += QString(" (%1 records)").arg(profile->recordCount);
+        }
+        m_profileCombo->setItemText(m_profileCombo->currentIndex(), display);
     }
 
-    m_historyTable->setSortingEnabled(true);
+    updateVsAverage();
+    updateStats();
+    return true;
+}
+
+void CycleTimeTab::updateVsAverage()
+{
+    const Frontier::CycleProfile *profile = currentProfile();
+    int avgSeconds = profile ? profile->avgTotalSeconds : 0;
+    if (avgSeconds != m_avgTotalSeconds) {
+        m_avgTotalSeconds = avgSeconds;
+        m_historyModel->refreshColumn(m_vsAverageColumn);
+    }
+}
+
+Frontier::CycleProfile *CycleTimeTab::currentProfile()
+{
+    int profileId = m_profileCombo->currentData().toInt();
+    for (auto &profile : m_profiles) {
+        if (profile.id.value_or(0) == profileId) {
+            return &profile;
+        }
+    }
+    return nullptr;
 }
 
 void CycleTimeTab::updateStats()
 {
     int profileId = m_profileCombo->currentData().toInt();
+    updateFastestRoute();
 
     for (const auto &profile : m_profiles) {
         if (profile.id.value_or(0) == profileId) {
@@ -428,10 +626,20 @@ void CycleTimeTab::updateStats()
                 m_avgTimeLabel->setText(formatSeconds(profile.avgTotalSeconds));
                 m_bestTimeLabel->setText(formatSeconds(profile.bestTotalSeconds));
                 m_worstTimeLabel->setText(formatSeconds(profile.worstTotalSeconds));
+                m_p50TimeLabel->setText(formatSeconds(profile.p50TotalSeconds));
+                m_p90TimeLabel->setText(formatSeconds(profile.p90TotalSeconds));
+                m_phaseAvgLabel->setText(tr("Load %1 | Haul %2 | Dump %3 | Return %4")
+                                             .arg(formatSeconds(profile.avgLoadSeconds),
+                                                  formatSeconds(profile.avgHaulSeconds),
+                                                  formatSeconds(profile.avgDumpSeconds),
+                                                  formatSeconds(profile.avgReturnSeconds)));
             } else {
                 m_avgTimeLabel->setText("-");
                 m_bestTimeLabel->setText("-");
                 m_worstTimeLabel->setText("-");
+                m_p50TimeLabel->setText("-");
+                m_p90TimeLabel->setText("-");
+                m_phaseAvgLabel->setText("-");
             }
 
             // Update profile details
@@ -456,24 +664,49 @@ void CycleTimeTab::updateStats()
     m_avgTimeLabel->setText("-");
     m_bestTimeLabel->setText("-");
     m_worstTimeLabel->setText("-");
+    m_p50TimeLabel->setText("-");
+    m_p90TimeLabel->setText("-");
+    m_phaseAvgLabel->setText("-");
     m_profileDetailsLabel->clear();
 }
 
+qint64 CycleTimeTab::phaseElapsedMs(int phase) const
+{
+    qint64 ms = m_phaseMs[phase];
+    if (m_running && phase == m_currentPhase - 1) {
+        ms += m_phaseClock.elapsed();
+    }
+    return ms;
+}
+
+int CycleTimeTab::phaseSeconds(int phase) const
+{
+    return static_cast<int>((phaseElapsedMs(phase) + 500) / 1000);
+}
+
+// Moves the running clock's time into the current phase and restarts it
+void CycleTimeTab::bankCurrentPhase()
+{
+    if (m_running && m_currentPhase >= 1 && m_currentPhase <= 4) {
+        m_phaseMs[m_currentPhase - 1] += m_phaseClock.restart();
+    }
+}
+
 void CycleTimeTab::updateTimerDisplay()
 {
     int currentSeconds = 0;
     if (m_currentPhase > 0 && m_currentPhase <= 4) {
-        currentSeconds = m_phaseSeconds[m_currentPhase - 1];
+        currentSeconds = phaseSeconds(m_currentPhase - 1);
     }
 
     m_timerDisplay->setText(formatSeconds(currentSeconds));
 
-    m_loadTimeLabel->setText(formatSeconds(m_phaseSeconds[0]));
-    m_haulTimeLabel->setText(formatSeconds(m_phaseSeconds[1]));
-    m_dumpTimeLabel->setText(formatSeconds(m_phaseSeconds[2]));
-    m_returnTimeLabel->setText(formatSeconds(m_phaseSeconds[3]));
+    m_loadTimeLabel->setText(formatSeconds(phaseSeconds(0)));
+    m_haulTimeLabel->setText(formatSeconds(phaseSeconds(1)));
+    m_dumpTimeLabel->setText(formatSeconds(phaseSeconds(2)));
+    m_returnTimeLabel->setText(formatSeconds(phaseSeconds(3)));
 
-    int total = m_phaseSeconds[0] + m_phaseSeconds[1] + m_phaseSeconds[2] + m_phaseSeconds[3];
+    int total = phaseSeconds(0) + phaseSeconds(1) + phaseSeconds(2) + phaseSeconds(3);
     m_totalTimeLabel->setText(formatSeconds(total));
 
     // Update phase label
@@ -511,8 +744,7 @@ void CycleTimeTab::onProfileSelected()
     if (hasProfile) {
         loadRecordsForProfile(profileId);
     } else {
-        m_historyTable->setRowCount(0);
-        m_records.clear();
+        m_historyModel->setRows({});
     }
 
     updateStats();
@@ -637,18 +869,24 @@ void CycleTimeTab::onStartStop()
     if (m_currentPhase == 0) {
         // Start timer - begin with Load phase
         m_currentPhase = 1;
-        m_timer->start(1000);
+        m_running = true;
+        m_phaseClock.start();
+        m_timer->start();
         m_startStopBtn->setText(tr("Pause"));
         m_startStopBtn->setStyleSheet("background-color: #f57c00; color: white; font-weight: bold; padding: 10px 20px;");
         m_nextPhaseBtn->setEnabled(true);
-    } else if (m_timer->isActive()) {
+    } else if (m_running) {
         // Pause
+        bankCurrentPhase();
+        m_running = false;
         m_timer->stop();
         m_startStopBtn->setText(tr("Resume"));
         m_startStopBtn->setStyleSheet("background-color: #4caf50; color: white; font-weight: bold; padding: 10px 20px;");
     } else {
         // Resume
-        m_timer->start(1000);
+        m_running = true;
+        m_phaseClock.start();
+        m_timer->start();
         m_startStopBtn->setText(tr("Pause"));
         m_startStopBtn->setStyleSheet("background-color: #f57c00; color: white; font-weight: bold; padding: 10px 20px;");
     }
@@ -659,20 +897,27 @@ void CycleTimeTab::onStartStop()
 void CycleTimeTab::onNextPhase()
 {
     if (m_currentPhase >= 1 && m_currentPhase < 4) {
+        bankCurrentPhase();
         m_currentPhase++;
         updateTimerDisplay();
     } else if (m_currentPhase == 4) {
         // Cycle complete - stop and populate manual entry
+        bankCurrentPhase();
+        m_running = false;
         m_timer->stop();
 
-        m_loadMinSpin->setValue(m_phaseSeconds[0] / 60);
-        m_loadSecSpin->setValue(m_phaseSeconds[0] % 60);
-        m_haulMinSpin->setValue(m_phaseSeconds[1] / 60);
-        m_haulSecSpin->setValue(m_phaseSeconds[1] % 60);
-        m_dumpMinSpin->setValue(m_phaseSeconds[2] / 60);
-        m_dumpSecSpin->setValue(m_phaseSeconds[2] % 60);
-        m_returnMinSpin->setValue(m_phaseSeconds[3] / 60);
-        m_returnSecSpin->setValue(m_phaseSeconds[3] % 60);
+        const int load = phaseSeconds(0);
+        const int haul = phaseSeconds(1);
+        const int dump = phaseSeconds(2);
+        const int ret = phaseSeconds(3);
+        m_loadMinSpin->setValue(load / 60);
+        m_loadSecSpin->setValue(load % 60);
+        m_haulMinSpin->setValue(haul / 60);
+        m_haulSecSpin->setValue(haul % 60);
+        m_dumpMinSpin->setValue(dump / 60);
+        m_dumpSecSpin->setValue(dump % 60);
+        m_returnMinSpin->setValue(ret / 60);
+        m_returnSecSpin->setValue(ret % 60);
 
         m_currentPhase = 0;
         m_startStopBtn->setText(tr("Start"));
@@ -686,9 +931,10 @@ void CycleTimeTab::onNextPhase()
 void CycleTimeTab::onResetTimer()
 {
     m_timer->stop();
+    m_running = false;
     m_currentPhase = 0;
     for (int i = 0; i < 4; i++) {
-        m_phaseSeconds[i] = 0;
+        m_phaseMs[i] = 0;
     }
 
     m_startStopBtn->setText(tr("Start"));
@@ -700,8 +946,8 @@ void CycleTimeTab::onResetTimer()
 
 void CycleTimeTab::onTimerTick()
 {
+    // Repaint only; elapsed time is read from the clock, not counted here
     if (m_currentPhase >= 1 && m_currentPhase <= 4) {
-        m_phaseSeconds[m_currentPhase - 1]++;
         updateTimerDisplay();
     }
 }
@@ -746,10 +992,7 @@ void CycleTimeTab::onSaveRecord()
         m_returnSecSpin->setValue(0);
         m_recordNotesEdit->clear();
 
-        // Refresh
-        loadProfiles();  // To update stats
-        loadRecordsForProfile(profileId);
-        updateStats();
+        // The history and stats follow through the change bus
     } else {
         QMessageBox::critical(this, tr("Error"), tr("Failed to save cycle record."));
     }
@@ -757,27 +1000,21 @@ void CycleTimeTab::onSaveRecord()
 
 void CycleTimeTab::onDeleteRecord()
 {
-    auto selected = m_historyTable->selectedItems();
+    const QModelIndexList selected = m_historyTable->selectionModel()->selectedRows();
     if (selected.isEmpty()) return;
 
-    int row = selected.first()->row();
-    int recordId = m_historyTable->item(row, 0)->data(Qt::UserRole).toInt();
+    int recordId = selected.first().data(ColumnTableModelBase::RowIdRole).toInt();
 
     auto result = QMessageBox::question(this, tr("Delete Record"),
                                         tr("Delete this cycle record?"));
 
     if (result == QMessageBox::Yes) {
-        if (m_database->deleteCycleRecord(recordId)) {
-            int profileId = m_profileCombo->currentData().toInt();
-            loadProfiles();  // To update stats
-            loadRecordsForProfile(profileId);
-            updateStats();
-        }
+        m_database->deleteCycleRecord(recordId);
     }
 }
 
 void CycleTimeTab::onRecordSelected()
 {
-    bool hasSelection = !m_historyTable->selectedItems().isEmpty();
+    bool hasSelection = m_historyTable->selectionModel()->hasSelection();
     m_deleteRecordBtn->setEnabled(hasSelection);
 }
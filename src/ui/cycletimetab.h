@@ -11,16 +11,23 @@
 #include <QSpinBox>
 #include <QPushButton>
 #include <QLabel>
+#include <QTableView>
 #include <QTableWidget>
 #include <QLineEdit>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include "core/types.h"
 
 namespace Frontier {
 class Database;
+class RouteMatrix;
+struct RowChange;
 }
 
+template<typename Row> class ColumnTableModel;
+class ColumnSortProxy;
+
 class CycleTimeTab : public QWidget
 {
     Q_OBJECT
@@ -55,23 +62,41 @@ private:
     QWidget* createTimerPanel();
     QWidget* createStatsPanel();
     QWidget* createHistoryPanel();
+    QWidget* createRoutePanel();
 
     void loadProfiles();
     void loadRecordsForProfile(int profileId);
+    void setupHistoryModel();
+    bool patchRecords(const QVector<Frontier::RowChange> &changes);
+    void updateVsAverage();
+    Frontier::CycleProfile *currentProfile();
     void updateStats();
     void updateTimerDisplay();
+    void bankCurrentPhase();
+    qint64 phaseElapsedMs(int phase) const;      // 0-based phase index
+    int phaseSeconds(int phase) const;
     void showProfileDialog(bool isEdit);
 
+    // Route matrix views; both read the matrix only
+    void updateHeatmap();
+    void updateFastestRoute();
+
     QString formatSeconds(int seconds) const;
 
     Frontier::Database *m_database;
 
     // Current state
     QVector<Frontier::CycleProfile> m_profiles;
-    QVector<Frontier::CycleRecord> m_records;
+    Frontier::CycleStats m_stats;    // Over the history rows, kept current as records are saved
+    int m_avgTotalSeconds = 0;       // Current profile's, for the vs Avg column
     int m_currentPhase = 0;  // 0=stopped, 1=load, 2=haul, 3=dump, 4=return
-    int m_phaseSeconds[4] = {0, 0, 0, 0};  // load, haul, dump, return
-    QTimer *m_timer;
+    // Phase times come from a monotonic clock; the QTimer only repaints,
+    // so a busy GUI thread delays the display but never the measurement
+    qint64 m_phaseMs[4] = {0, 0, 0, 0};  // Banked time: load, haul, dump, return
+    QElapsedTimer m_phaseClock;         // Runs while the current phase is timed
+    bool m_running = false;
+    QTimer *m_timer;                    // Display refresh only
+    static constexpr int DisplayIntervalMs = 200;
 
     // Profile panel
     QComboBox *m_profileCombo;
@@ -111,10 +136,24 @@ private:
     QLabel *m_avgTimeLabel;
     QLabel *m_bestTimeLabel;
     QLabel *m_worstTimeLabel;
+    QLabel *m_p50TimeLabel;
+    QLabel *m_p90TimeLabel;
+    QLabel *m_phaseAvgLabel;
+    QLabel *m_fastestLabel;
 
     // History table
-    QTableWidget *m_historyTable;
+    QTableView *m_historyTable;
+    ColumnTableModel<Frontier::CycleRecord> *m_historyModel;   // Newest first
+    ColumnSortProxy *m_historyProxy;
+    int m_vsAverageColumn = 0;
     QPushButton *m_deleteRecordBtn;
+
+    // Route matrix: every source x destination, kept current by its own
+    // bus connection
+    Frontier::RouteMatrix *m_routeMatrix;
+    QComboBox *m_heatmapMapCombo;
+    QComboBox *m_heatmapMetricCombo;
+    QTableWidget *m_heatmapTable;
 };
 
 #endif // CYCLETIMETAB_H
@@ -5,6 +5,10 @@
 
 #include "dashboardwidget.h"
 #include "core/database.h"
+#include "core/readpool.h"
+#include "core/capitalplanservice.h"
+#include "core/transactionstore.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -16,7 +20,6 @@
 #include <QLocale>
 #include <QDate>
 #include <QSettings>
-#include <algorithm>
 
 namespace {
 QString formatCurrency(double amount)
@@ -25,6 +28,11 @@ QString formatCurrency(double amount)
     return "$" + locale.toString(static_cast<qint64>(qRound(amount)));
 }
 
+QString journalNotesKey(const QDate &date)
+{
+    return QString("journal_notes/%1").arg(date.toString("yyyy-MM-dd"));
+}
+
 QString formatPower(double kw)
 {
     QLocale locale(QLocale::English);
@@ -43,6 +51,10 @@ DashboardWidget::DashboardWidget(Frontier::Database *database, QWidget *parent)
     , m_currentJournalDate(QDate::currentDate())
 {
     setupUi();
+    m_database->changeBus().subscribe(this,
+        Frontier::DataTable::Transactions | Frontier::DataTable::Inventory | Frontier::DataTable::Budgets
+            | Frontier::DataTable::CapitalPlan | Frontier::DataTable::Production,
+        [this]() { refreshData(); });
     refreshData();
 }
 
@@ -442,6 +454,9 @@ QWidget* DashboardWidget::createRecentActivity()
 
 void DashboardWidget::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("DashboardWidget::refreshData");
+    m_database->changeBus().acknowledge(this);
+    forgetJournal();
     updateFinancialSummary();
     updateCapitalPlanSummary();
     updateDailyJournal();
@@ -450,41 +465,28 @@ void DashboardWidget::refreshData()
 
 void DashboardWidget::updateFinancialSummary()
 {
-    auto balances = m_database->calculateBalances();
-
+    // Both figures are scans of the in-memory ledger columns
+    Frontier::TransactionStore &store = m_database->transactionStore();
+    const Frontier::AccountBalance balances = store.balances();
     m_netWorthLabel->setText(formatCurrency(balances.total()));
     m_companyLabel->setText(formatCurrency(balances.companyBalance));
     m_personalLabel->setText(formatCurrency(balances.personalBalance));
-
-    // Get transaction count
-    auto transactions = m_database->getAllTransactions();
-    m_transactionCountLabel->setText(QString::number(transactions.size()));
+    m_transactionCountLabel->setText(QString::number(store.size()));
 }
 
 void DashboardWidget::updateCapitalPlanSummary()
 {
-    // Get equipment plan total
-    double equipmentTotal = 0;
-    auto equipmentPlan = m_database->getEquipmentPlan();
-    for (const auto &item : equipmentPlan) {
-        equipmentTotal += item.totalCost;
-    }
-    m_equipmentTotalLabel->setText(formatCurrency(equipmentTotal));
-
-    // Get facility plan totals
-    double facilityTotal = 0;
-    double powerRequired = 0;
-    double powerGenerated = 0;
-    auto facilityPlan = m_database->getFacilityPlan();
-    for (const auto &item : facilityPlan) {
-        facilityTotal += item.totalCost;
-        powerRequired += item.totalPowerKw;
-        powerGenerated += item.totalGeneratedKw;
-    }
-    m_facilityTotalLabel->setText(formatCurrency(facilityTotal));
+    // Cached by the service; only a stale part costs an aggregate query
+    showCapitalPlanSummary(m_database->capitalPlan().summary());
+}
+
+void DashboardWidget::showCapitalPlanSummary(const Frontier::CapitalPlanSummary &plan)
+{
+    m_equipmentTotalLabel->setText(formatCurrency(plan.equipment.cost));
+    m_facilityTotalLabel->setText(formatCurrency(plan.facility.cost));
 
     // Power balance
-    double powerBalance = powerGenerated - powerRequired;
+    double powerBalance = plan.facility.powerBalanceKw();
     m_powerBalanceLabel->setText(formatPower(powerBalance));
     if (powerBalance >= 0) {
         m_powerBalanceLabel->setStyleSheet("font-size: 20px; font-weight: bold; color: #2e7d32;");
@@ -493,21 +495,17 @@ void DashboardWidget::updateCapitalPlanSummary()
     }
 
     // Affordability
-    double grandTotal = equipmentTotal + facilityTotal;
-    auto balances = m_database->calculateBalances();
-    double totalAvailable = balances.total();
-
-    if (grandTotal == 0) {
+    if (plan.grandTotal() == 0) {
         m_affordabilityBar->setValue(0);
         m_affordabilityBar->setFormat(tr("No plan"));
         m_affordabilityLabel->setText(tr("Add items to plan"));
         m_affordabilityLabel->setStyleSheet("font-size: 12px; color: #666;");
     } else {
-        int percent = qBound(0, static_cast<int>((grandTotal / totalAvailable) * 100), 100);
+        int percent = plan.fundsUsedPercent();
         m_affordabilityBar->setValue(percent);
         m_affordabilityBar->setFormat(QString("%1%").arg(percent));
 
-        double remaining = totalAvailable - grandTotal;
+        double remaining = plan.remaining();
         if (remaining >= 0) {
             m_affordabilityLabel->setText(tr("✓ Can afford (%1 remaining)").arg(formatCurrency(remaining)));
             m_affordabilityLabel->setStyleSheet("font-size: 12px; color: #2e7d32; font-weight: bold;");
@@ -522,11 +520,91 @@ void DashboardWidget::updateCapitalPlanSummary()
 
 void DashboardWidget::updateDailyJournal()
 {
-    QDate date = m_journalDateEdit->date();
+    const QDate date = m_journalDateEdit->date();
+
+    auto it = m_journalDays.constFind(date);
+    if (it != m_journalDays.constEnd()) {
+        m_notesEdit->setText(it->notes);
+        showDailyJournal(it->transactions);
+    } else {
+        // Notes live in QSettings and can be shown right away; the day's
+        // transactions are shown when its prefetch arrives
+        loadNotesForDate(date);
+    }
+    prefetchJournal(date);
+}
+
+void DashboardWidget::prefetchJournal(const QDate &date)
+{
+    for (auto it = m_journalDays.begin(); it != m_journalDays.end();) {
+        if (qAbs(it.key().daysTo(date)) > JournalKeepDays) {
+            it = m_journalDays.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // One read covers the first to the last missing day; days cached in
+    // between are read again, which is cheaper than a second query
+    QDate from;
+    QDate to;
+    for (QDate day = date.addDays(-JournalPrefetchDays); day <= date.addDays(JournalPrefetchDays);
+         day = day.addDays(1)) {
+        if (!m_journalDays.contains(day) && !m_journalPending.contains(day)) {
+            if (!from.isValid()) {
+                from = day;
+            }
+            to = day;
+        }
+    }
+    if (!from.isValid()) {
+        return;
+    }
+    for (QDate day = from; day <= to; day = day.addDays(1)) {
+        m_journalPending.insert(day);
+    }
+
+    const int generation = m_journalGeneration;
+    m_database->readPool().run([from, to](Frontier::Database &db) {
+        QHash<QDate, JournalDay> days;
+        QSettings settings;
+        for (QDate day = from; day <= to; day = day.addDays(1)) {
+            days[day].notes = settings.value(journalNotesKey(day), "").toString();
+        }
+        // Newest first, as a single day's read returns them
+        for (const Frontier::Transaction &transaction : db.getTransactionsByDateRange(from, to)) {
+            days[transaction.date].transactions.append(transaction);
+        }
+        return days;
+    }).then(this, [this, generation](const QHash<QDate, JournalDay> &days) {
+        // The ledger changed meanwhile; the refresh has asked again
+        if (generation != m_journalGeneration) {
+            return;
+        }
+        const QDate shown = m_journalDateEdit->date();
+        for (auto it = days.constBegin(); it != days.constEnd(); ++it) {
+            // Not pending any more: its notes were saved after the read,
+            // so it is not cached, though its transactions still hold
+            if (m_journalPending.remove(it.key())) {
+                m_journalDays.insert(it.key(), it.value());
+            }
+            // Notes on screen may hold unsaved typing; only the table fills in
+            if (it.key() == shown) {
+                showDailyJournal(it->transactions);
+            }
+        }
+    });
+}
 
-    // Get transactions for this date
-    auto transactions = m_database->getTransactionsByDateRange(date, date);
+void DashboardWidget::forgetJournal()
+{
+    m_journalDays.clear();
+    m_journalPending.clear();
+    ++m_journalGeneration;
+}
 
+void DashboardWidget::showDailyJournal(const QVector<Frontier::Transaction> &transactions)
+{
     m_dayActivitiesTable->setRowCount(transactions.size());
 
     double dayIncome = 0;
@@ -574,32 +652,24 @@ void DashboardWidget::updateDailyJournal()
     } else {
         m_dayNetLabel->setStyleSheet("font-weight: bold; color: #c62828;");
     }
-
-    // Load notes for this date
-    loadNotesForDate(date);
 }
 
 void DashboardWidget::updateRecentActivity()
 {
-    // Get recent transactions (last 10)
-    auto transactions = m_database->getAllTransactions();
-
-    // Sort by date descending, then by ID descending
-    std::sort(transactions.begin(), transactions.end(),
-              [](const Frontier::Transaction &a, const Frontier::Transaction &b) {
-                  if (a.date != b.date) return a.date > b.date;
-                  return a.id.value_or(0) > b.id.value_or(0);
-              });
-
-    int maxRows = qMin(10, static_cast<int>(transactions.size()));
-    m_recentActivityTable->setRowCount(maxRows);
+    m_database->readPool().run([](Frontier::Database &db) {
+        return db.getRecentTransactions(RecentActivityRows);
+    }).then(this, [this](QVector<Frontier::RecentTransaction> recent) {
+        showRecentActivity(recent);
+    });
+}
 
-    // Calculate running balance (from most recent backwards)
-    auto balances = m_database->calculateBalances();
-    double runningBalance = balances.total();
+void DashboardWidget::showRecentActivity(const QVector<Frontier::RecentTransaction> &recent)
+{
+    // Rows arrive newest first with the balance after each one
+    m_recentActivityTable->setRowCount(recent.size());
 
-    for (int row = 0; row < maxRows; ++row) {
-        const auto &t = transactions[row];
+    for (int row = 0; row < recent.size(); ++row) {
+        const auto &t = recent[row].transaction;
 
         // Date
         m_recentActivityTable->setItem(row, 0,
@@ -626,17 +696,10 @@ void DashboardWidget::updateRecentActivity()
         m_recentActivityTable->setItem(row, 3, new QTableWidgetItem(
                                                    Frontier::accountTypeToString(t.account)));
 
-        // Balance (show current balance for first row, then we'd need historical)
-        auto *balanceItem = new QTableWidgetItem(formatCurrency(runningBalance));
+        // Balance after this transaction
+        auto *balanceItem = new QTableWidgetItem(formatCurrency(recent[row].balanceAfter));
         balanceItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
         m_recentActivityTable->setItem(row, 4, balanceItem);
-
-        // Adjust running balance for next row (going backwards)
-        if (isIncome) {
-            runningBalance -= t.totalAmount;
-        } else {
-            runningBalance += t.totalAmount;
-        }
     }
 }
 
@@ -647,15 +710,20 @@ void DashboardWidget::updateRecentActivity()
 void DashboardWidget::loadNotesForDate(const QDate &date)
 {
     QSettings settings;
-    QString key = QString("journal_notes/%1").arg(date.toString("yyyy-MM-dd"));
-    m_notesEdit->setText(settings.value(key, "").toString());
+    m_notesEdit->setText(settings.value(journalNotesKey(date), "").toString());
 }
 
 void DashboardWidget::saveNotesForDate(const QDate &date)
 {
     QSettings settings;
-    QString key = QString("journal_notes/%1").arg(date.toString("yyyy-MM-dd"));
-    settings.setValue(key, m_notesEdit->toPlainText());
+    settings.setValue(journalNotesKey(date), m_notesEdit->toPlainText());
+
+    // A prefetch already on its way read the old notes
+    m_journalPending.remove(date);
+    auto it = m_journalDays.find(date);
+    if (it != m_journalDays.end()) {
+        it->notes = m_notesEdit->toPlainText();
+    }
 }
 
 // =============================================================================
@@ -13,9 +13,14 @@
 #include <QDateEdit>
 #include <QTextEdit>
 #include <QProgressBar>
+#include <QHash>
+#include <QSet>
+
+#include "core/types.h"
 
 namespace Frontier {
 class Database;
+struct CapitalPlanSummary;
 }
 
 class DashboardWidget : public QWidget
@@ -51,13 +56,32 @@ private:
     QWidget* createDailyJournal();
     QWidget* createRecentActivity();
 
+    // Each section is fetched on the read pool and filled in on arrival,
+    // except the capital plan, which reads the cached CapitalPlanService
     void updateFinancialSummary();
     void updateCapitalPlanSummary();
     void updateDailyJournal();
     void updateRecentActivity();
+    void showCapitalPlanSummary(const Frontier::CapitalPlanSummary &plan);
+    void showDailyJournal(const QVector<Frontier::Transaction> &transactions);
+    void showRecentActivity(const QVector<Frontier::RecentTransaction> &recent);
     void loadNotesForDate(const QDate &date);
     void saveNotesForDate(const QDate &date);
 
+    // A journal day as shown: its transactions and saved notes
+    struct JournalDay {
+        QVector<Frontier::Transaction> transactions;
+        QString notes;
+    };
+    // Fetches the days around date that are neither cached nor on their
+    // way, in one range read, and drops the days far from it
+    void prefetchJournal(const QDate &date);
+    void forgetJournal();
+
+    static constexpr int RecentActivityRows = 10;
+    static constexpr int JournalPrefetchDays = 3;    // Either side of the shown day
+    static constexpr int JournalKeepDays = 7;        // Cached either side before eviction
+
     Frontier::Database *m_database;
 
     // Status Banner
@@ -99,6 +123,9 @@ private:
 
     // Current journal date
     QDate m_currentJournalDate;
+    QHash<QDate, JournalDay> m_journalDays;   // Around the shown day
+    QSet<QDate> m_journalPending;             // Requested; dropped here when stale
+    int m_journalGeneration = 0;              // Bumped when the cache is dropped
 };
 
 #endif // DASHBOARDWIDGET_H
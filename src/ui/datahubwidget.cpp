@@ -9,11 +9,20 @@
 #include "recipestab.h"
 #include "locationstab.h"
 #include "factorybuildingstab.h"
+#include "diagnosticstab.h"
+#include "itemtablemodel.h"
+#include "core/itemcatalog.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QMessageBox>
+#include <QShortcut>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QDoubleSpinBox>
 
 DataHubWidget::DataHubWidget(Frontier::Database *database, QWidget *parent)
     : QWidget(parent)
@@ -24,6 +33,10 @@ DataHubWidget::DataHubWidget(Frontier::Database *database, QWidget *parent)
     , m_recipesTab(nullptr)
 {
     setupUi();
+    m_database->changeBus().subscribe(m_tableView, Frontier::DataTable::Items, [this]() {
+        loadCategories();
+        loadItems();
+    });
     loadCategories();
     loadItems();
 }
@@ -59,9 +72,28 @@ void DataHubWidget::setupUi()
     m_locationsTab = new LocationsTab(m_database, this);
     m_subTabs->addTab(m_locationsTab, tr("Locations"));
 
+    // Diagnostics tab: profiler timings and cache sizes, kept out of sight
+    m_diagnosticsTab = new DiagnosticsTab(m_database, this);
+    int diagnosticsIndex = m_subTabs->addTab(m_diagnosticsTab, tr("Diagnostics"));
+    m_subTabs->setTabVisible(diagnosticsIndex, false);
+
+    auto *diagnosticsShortcut = new QShortcut(QKeySequence(tr("Ctrl+Shift+D")), this);
+    diagnosticsShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(diagnosticsShortcut, &QShortcut::activated, this, &DataHubWidget::onToggleDiagnostics);
+
     mainLayout->addWidget(m_subTabs);
 }
 
+void DataHubWidget::onToggleDiagnostics()
+{
+    int index = m_subTabs->indexOf(m_diagnosticsTab);
+    bool show = !m_subTabs->isTabVisible(index);
+    m_subTabs->setTabVisible(index, show);
+    if (show) {
+        m_subTabs->setCurrentIndex(index);
+    }
+}
+
 QWidget* DataHubWidget::createItemsTab()
 {
     QWidget *itemsTab = new QWidget();
@@ -101,18 +133,10 @@ QWidget* DataHubWidget::createItemsTab()
     m_tableView->horizontalHeader()->setStretchLastSection(true);
     m_tableView->verticalHeader()->setVisible(false);
 
-    // Create model
-    m_model = new QStandardItemModel(this);
-    m_model->setHorizontalHeaderLabels({
-        "Name", "Category", "Buy Price", "Sell Price", "Margin", "ROI %",
-        "Can Buy", "Can Sell", "Craftable"
-    });
-
-    // Create proxy model for filtering/sorting
-    m_proxyModel = new QSortFilterProxyModel(this);
+    // One model over the whole catalog; category and search filter in the proxy
+    m_model = new ItemTableModel(this);
+    m_proxyModel = new ItemFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_model);
-    m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    m_proxyModel->setFilterKeyColumn(-1);
 
     m_tableView->setModel(m_proxyModel);
 
@@ -125,9 +149,12 @@ QWidget* DataHubWidget::createItemsTab()
 
     m_addButton = new QPushButton("Add Item");
     m_deleteButton = new QPushButton("Delete");
+    m_repriceButton = new QPushButton("Reprice Group...");
+    m_repriceButton->setToolTip("Recompute the sell prices of every item in a pricing group");
 
     bottomLayout->addWidget(m_itemCountLabel);
     bottomLayout->addStretch();
+    bottomLayout->addWidget(m_repriceButton);
     bottomLayout->addWidget(m_addButton);
     bottomLayout->addWidget(m_deleteButton);
 
@@ -146,6 +173,9 @@ QWidget* DataHubWidget::createItemsTab()
     connect(m_deleteButton, &QPushButton::clicked,
             this, &DataHubWidget::onDeleteItemClicked);
 
+    connect(m_repriceButton, &QPushButton::clicked,
+            this, &DataHubWidget::onRepriceClicked);
+
     connect(m_tableView, &QTableView::doubleClicked,
             this, &DataHubWidget::onItemDoubleClicked);
 
@@ -154,115 +184,29 @@ QWidget* DataHubWidget::createItemsTab()
 
 void DataHubWidget::loadCategories()
 {
+    const QString selected = m_categoryFilter->currentData().toString();
+
+    QSignalBlocker blocker(m_categoryFilter);
     m_categoryFilter->clear();
     m_categoryFilter->addItem("All Categories", "");
 
-    // Get unique main categories from items
-    QSet<QString> categories;
-    auto items = m_database->getAllItems();
-
-    for (const auto &item : items) {
-        categories.insert(item.categoryMain);
-    }
-
-    // Sort and add to combo box
-    QStringList sortedCategories = categories.values();
-    sortedCategories.sort();
-
-    for (const QString &category : sortedCategories) {
+    // Distinct main categories, already sorted
+    for (const QString &category : m_database->itemCatalog().categories()) {
         m_categoryFilter->addItem(category, category);
     }
+
+    int index = m_categoryFilter->findData(selected);
+    m_categoryFilter->setCurrentIndex(index >= 0 ? index : 0);
 }
 
 void DataHubWidget::loadItems()
 {
-    // Get items from database
-    m_items = m_database->getAllItems();
-
-    // Clear existing data
-    m_model->removeRows(0, m_model->rowCount());
-
-    // Populate table
-    for (const auto &item : m_items) {
-        QList<QStandardItem*> row;
-
-        // Name
-        row.append(new QStandardItem(item.name));
-
-        // Category (display format)
-        row.append(new QStandardItem(item.displayCategory()));
-
-        // Buy Price (formatted - fixed notation for large numbers)
-        QStandardItem *buyItem = new QStandardItem();
-        buyItem->setData(QString("$%L1").arg(item.buyPriceDisplay, 0, 'f', 0), Qt::DisplayRole);
-        buyItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        row.append(buyItem);
-
-        // Sell Price (formatted - fixed notation for large numbers)
-        QStandardItem *sellItem = new QStandardItem();
-        sellItem->setData(QString("$%L1").arg(item.sellPriceDisplay, 0, 'f', 0), Qt::DisplayRole);
-        sellItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        row.append(sellItem);
-
-        // Margin (calculated)
-        double margin = item.sellPriceInternal - item.buyPriceInternal;
-        QStandardItem *marginItem = new QStandardItem();
-        marginItem->setData(QString("$%L1").arg(margin, 0, 'f', 0), Qt::DisplayRole);
-        marginItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        if (margin < 0) {
-            marginItem->setForeground(QBrush(Qt::red));
-        } else if (margin > 0) {
-            marginItem->setForeground(QBrush(Qt::darkGreen));
-        }
-        row.append(marginItem);
-
-        // ROI %
-        double roi = item.roiPercent();
-        QStandardItem *roiItem = new QStandardItem();
-        roiItem->setData(QString("%1%").arg(roi, 0, 'f', 2), Qt::DisplayRole);
-        roiItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        if (roi < 0) {
-            roiItem->setForeground(QBrush(Qt::red));
-        } else if (roi > 0) {
-            roiItem->setForeground(QBrush(Qt::darkGreen));
-        }
-        row.append(roiItem);
-
-        // Can Buy
-        QStandardItem *canBuyItem = new QStandardItem();
-        canBuyItem->setData(item.isPurchasable ? "✓" : "✗", Qt::DisplayRole);
-        canBuyItem->setTextAlignment(Qt::AlignCenter);
-        if (!item.isPurchasable) {
-            canBuyItem->setForeground(QBrush(Qt::gray));
-        }
-        row.append(canBuyItem);
-
-        // Can Sell
-        QStandardItem *canSellItem = new QStandardItem();
-        canSellItem->setData(item.isSellable ? "✓" : "✗", Qt::DisplayRole);
-        canSellItem->setTextAlignment(Qt::AlignCenter);
-        if (!item.isSellable) {
-            canSellItem->setForeground(QBrush(Qt::gray));
-        }
-        row.append(canSellItem);
-
-        // Craftable
-        QStandardItem *craftableItem = new QStandardItem();
-        craftableItem->setData(item.isCraftable ? "✓" : "✗", Qt::DisplayRole);
-        craftableItem->setTextAlignment(Qt::AlignCenter);
-        if (!item.isCraftable) {
-            craftableItem->setForeground(QBrush(Qt::gray));
-        }
-        row.append(craftableItem);
-
-        // Store item ID in first column
-        row[0]->setData(item.id.value_or(-1), Qt::UserRole);
-
-        m_model->appendRow(row);
-    }
+    m_database->changeBus().acknowledge(m_tableView);
 
-    // Update item count
-    m_itemCountLabel->setText(QString("Items: %1").arg(m_items.size()));
+    // Row numbers change on reload, so the category rows are rebuilt too
+    m_model->reload(m_database->itemCatalog());
+    applyCategoryFilter();
+    onSearchTextChanged(m_searchBox->text());   // Added or renamed items
 
     // Resize columns
     m_tableView->resizeColumnsToContents();
@@ -270,6 +214,7 @@ void DataHubWidget::loadItems()
 
 void DataHubWidget::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("DataHubWidget::refreshData");
     loadCategories();
     loadItems();
     
@@ -289,141 +234,56 @@ void DataHubWidget::refreshData()
     }
 }
 
-void DataHubWidget::applyFilters()
+void DataHubWidget::applyCategoryFilter()
 {
-    QString selectedCategory = m_categoryFilter->currentData().toString();
-    QString searchText = m_searchBox->text();
-
-    // Build filter regex
-    if (selectedCategory.isEmpty()) {
-        // Just use search text
-        m_proxyModel->setFilterRegularExpression(
-            QRegularExpression(searchText, QRegularExpression::CaseInsensitiveOption));
+    m_proxyModel->setCategory(m_categoryFilter->currentData().toString(),
+                              m_database->itemCatalog());
+    updateItemCount();
+}
+
+void DataHubWidget::updateItemCount()
+{
+    if (m_proxyModel->rowCount() == m_model->rowCount()) {
+        m_itemCountLabel->setText(QString("Items: %1").arg(m_model->rowCount()));
     } else {
-        // Filter by category first, then search
-        // This is a simplified approach - we filter by search text
-        // and let the category filter work through the visible items
-        m_proxyModel->setFilterRegularExpression(
-            QRegularExpression(searchText, QRegularExpression::CaseInsensitiveOption));
+        m_itemCountLabel->setText(QString("Items: %1 / %2")
+                                      .arg(m_proxyModel->rowCount())
+                                      .arg(m_model->rowCount()));
     }
+}
 
-    // Update visible count
-    m_itemCountLabel->setText(QString("Items: %1 / %2")
-                                  .arg(m_proxyModel->rowCount())
-                                  .arg(m_items.size()));
+int DataHubWidget::itemIdAt(const QModelIndex &proxyIndex) const
+{
+    return proxyIndex.data(ItemTableModel::ItemIdRole).toInt();
 }
 
 void DataHubWidget::onCategoryFilterChanged(int index)
 {
     Q_UNUSED(index);
 
-    QString selectedCategory = m_categoryFilter->currentData().toString();
-
-    if (selectedCategory.isEmpty()) {
-        // Show all - reload full list
-        loadItems();
-    } else {
-        // Filter by category
-        m_items = m_database->getItemsByCategory(selectedCategory);
-
-        m_model->removeRows(0, m_model->rowCount());
-
-        for (const auto &item : m_items) {
-            QList<QStandardItem*> row;
-
-            row.append(new QStandardItem(item.name));
-            row.append(new QStandardItem(item.displayCategory()));
-
-            // Fixed notation for large numbers
-            QStandardItem *buyItem = new QStandardItem();
-            buyItem->setData(QString("$%L1").arg(item.buyPriceDisplay, 0, 'f', 0), Qt::DisplayRole);
-            buyItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            row.append(buyItem);
-
-            QStandardItem *sellItem = new QStandardItem();
-            sellItem->setData(QString("$%L1").arg(item.sellPriceDisplay, 0, 'f', 0), Qt::DisplayRole);
-            sellItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            row.append(sellItem);
-
-            double margin = item.sellPriceInternal - item.buyPriceInternal;
-            QStandardItem *marginItem = new QStandardItem();
-            marginItem->setData(QString("$%L1").arg(margin, 0, 'f', 0), Qt::DisplayRole);
-            marginItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            if (margin < 0) {
-                marginItem->setForeground(QBrush(Qt::red));
-            }
-            row.append(marginItem);
-
-            double roi = item.roiPercent();
-            QStandardItem *roiItem = new QStandardItem();
-            roiItem->setData(QString("%1%").arg(roi, 0, 'f', 2), Qt::DisplayRole);
-            roiItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-            if (roi < 0) {
-                roiItem->setForeground(QBrush(Qt::red));
-            }
-            row.append(roiItem);
-
-            QStandardItem *canBuyItem = new QStandardItem();
-            canBuyItem->setData(item.isPurchasable ? "✓" : "✗", Qt::DisplayRole);
-            canBuyItem->setTextAlignment(Qt::AlignCenter);
-            if (!item.isPurchasable) {
-                canBuyItem->setForeground(QBrush(Qt::gray));
-            }
-            row.append(canBuyItem);
-
-            QStandardItem *canSellItem = new QStandardItem();
-            canSellItem->setData(item.isSellable ? "✓" : "✗", Qt::DisplayRole);
-            canSellItem->setTextAlignment(Qt::AlignCenter);
-            if (!item.isSellable) {
-                canSellItem->setForeground(QBrush(Qt::gray));
-            }
-            row.append(canSellItem);
-
-            QStandardItem *craftableItem = new QStandardItem();
-            craftableItem->setData(item.isCraftable ? "✓" : "✗", Qt::DisplayRole);
-            craftableItem->setTextAlignment(Qt::AlignCenter);
-            if (!item.isCraftable) {
-                craftableItem->setForeground(QBrush(Qt::gray));
-            }
-            row.append(craftableItem);
-
-            row[0]->setData(item.id.value_or(-1), Qt::UserRole);
-
-            m_model->appendRow(row);
-        }
-
-        m_itemCountLabel->setText(QString("Items: %1").arg(m_items.size()));
-        m_tableView->resizeColumnsToContents();
-    }
+    // Served from the catalog's category index; no query
+    applyCategoryFilter();
 }
 
 void DataHubWidget::onSearchTextChanged(const QString &text)
 {
-    m_proxyModel->setFilterRegularExpression(
-        QRegularExpression(text, QRegularExpression::CaseInsensitiveOption));
-
-    m_itemCountLabel->setText(QString("Items: %1 / %2")
-                                  .arg(m_proxyModel->rowCount())
-                                  .arg(m_model->rowCount()));
+    std::optional<QSet<int>> matches;
+    if (!text.trimmed().isEmpty()) {
+        matches.emplace();
+        for (const Frontier::SearchHit &hit : m_database->search(text, Frontier::DataTable::Items, -1)) {
+            matches->insert(hit.id);
+        }
+    }
+    m_proxyModel->setSearchMatches(matches);
+    updateItemCount();
 }
 
 void DataHubWidget::onAddItemClicked()
 {
     AddItemDialog dialog(this);
 
-    // Get unique categories for dropdowns
-    QSet<QString> mainCats, subCats;
-    for (const auto &item : m_items) {
-        mainCats.insert(item.categoryMain);
-        subCats.insert(item.categorySub);
-    }
-
-    QStringList mainList = mainCats.values();
-    QStringList subList = subCats.values();
-    mainList.sort();
-    subList.sort();
-
-    dialog.setCategories(mainList, subList);
+    const Frontier::ItemCatalog &catalog = m_database->itemCatalog();
+    dialog.setCategories(catalog.categories(), catalog.subCategories());
 
     if (dialog.exec() == QDialog::Accepted) {
         Frontier::Item newItem = dialog.getItem();
@@ -446,10 +306,9 @@ void DataHubWidget::onDeleteItemClicked()
         return;
     }
 
-    // Get the source index (in case of proxy model)
-    QModelIndex sourceIndex = m_proxyModel->mapToSource(currentIndex);
-    int itemId = m_model->item(sourceIndex.row(), 0)->data(Qt::UserRole).toInt();
-    QString itemName = m_model->item(sourceIndex.row(), 0)->text();
+    const Frontier::Item &item = m_model->itemAt(m_proxyModel->mapToSource(currentIndex).row());
+    int itemId = item.id.value_or(-1);
+    QString itemName = item.name;
 
     // Confirm deletion
     int result = QMessageBox::question(this, "Delete Item",
@@ -466,11 +325,56 @@ void DataHubWidget::onDeleteItemClicked()
     }
 }
 
+void DataHubWidget::onRepriceClicked()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Reprice Pricing Group");
+
+    auto *layout = new QFormLayout(&dialog);
+
+    auto *groupCombo = new QComboBox();
+    groupCombo->addItem("Base70", QVariant::fromValue(static_cast<int>(Frontier::PricingGroup::Base70)));
+    groupCombo->addItem("Custom", QVariant::fromValue(static_cast<int>(Frontier::PricingGroup::Custom)));
+    layout->addRow("Pricing group:", groupCombo);
+
+    auto *ratioSpin = new QDoubleSpinBox();
+    ratioSpin->setRange(0.0, 500.0);
+    ratioSpin->setDecimals(1);
+    ratioSpin->setSuffix("% of buy");
+    layout->addRow("Sell price:", ratioSpin);
+
+    // Start from the group's current rule
+    auto showRule = [groupCombo, ratioSpin]() {
+        const auto group = static_cast<Frontier::PricingGroup>(groupCombo->currentData().toInt());
+        ratioSpin->setValue(Frontier::calculateSellPrice(1.0, group) * 100.0);
+    };
+    connect(groupCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, showRule);
+    showRule();
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addRow(buttons);
+
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    // One UPDATE; the change bus then reloads the catalog and its views once
+    const auto group = static_cast<Frontier::PricingGroup>(groupCombo->currentData().toInt());
+    const int changed = m_database->repriceItems(group, ratioSpin->value() / 100.0);
+    if (changed < 0) {
+        QMessageBox::critical(this, "Error",
+                              QString("Failed to reprice items: %1").arg(m_database->lastError()));
+        return;
+    }
+    QMessageBox::information(this, "Reprice Pricing Group",
+                             QString("Updated the sell price of %1 item(s).").arg(changed));
+}
+
 void DataHubWidget::onItemDoubleClicked(const QModelIndex &index)
 {
-    // Get the source index
-    QModelIndex sourceIndex = m_proxyModel->mapToSource(index);
-    int itemId = m_model->item(sourceIndex.row(), 0)->data(Qt::UserRole).toInt();
+    int itemId = itemIdAt(index);
 
     // Find the item
     auto itemOpt = m_database->getItem(itemId);
@@ -481,19 +385,8 @@ void DataHubWidget::onItemDoubleClicked(const QModelIndex &index)
 
     AddItemDialog dialog(this);
 
-    // Get unique categories for dropdowns
-    QSet<QString> mainCats, subCats;
-    for (const auto &item : m_items) {
-        mainCats.insert(item.categoryMain);
-        subCats.insert(item.categorySub);
-    }
-
-    QStringList mainList = mainCats.values();
-    QStringList subList = subCats.values();
-    mainList.sort();
-    subList.sort();
-
-    dialog.setCategories(mainList, subList);
+    const Frontier::ItemCatalog &catalog = m_database->itemCatalog();
+    dialog.setCategories(catalog.categories(), catalog.subCategories());
     dialog.setItem(itemOpt.value());
 
     if (dialog.exec() == QDialog::Accepted) {
@@ -13,16 +13,17 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
-#include <QStandardItemModel>
-#include <QSortFilterProxyModel>
 
 #include "core/database.h"
 #include "factorybuildingstab.h"
 #include "locationstab.h"
 
 // Forward declarations
+class ItemTableModel;
+class ItemFilterProxyModel;
 class VehicleSpecsTab;
 class RecipesTab;
+class DiagnosticsTab;
 
 class DataHubWidget : public QWidget
 {
@@ -40,14 +41,18 @@ private slots:
     void onSearchTextChanged(const QString &text);
     void onAddItemClicked();
     void onDeleteItemClicked();
+    void onRepriceClicked();
     void onItemDoubleClicked(const QModelIndex &index);
+    void onToggleDiagnostics();
 
 private:
     void setupUi();
     QWidget* createItemsTab();
     void loadCategories();
     void loadItems();
-    void applyFilters();
+    void applyCategoryFilter();
+    void updateItemCount();
+    int itemIdAt(const QModelIndex &proxyIndex) const;
 
     Frontier::Database *m_database;
 
@@ -59,6 +64,7 @@ private:
     RecipesTab *m_recipesTab;
     LocationsTab *m_locationsTab;
     FactoryBuildingsTab *m_factoryBuildingsTab;
+    DiagnosticsTab *m_diagnosticsTab;            // Hidden until Ctrl+Shift+D
 
     // Items tab UI elements
     QComboBox *m_categoryFilter;
@@ -66,14 +72,12 @@ private:
     QTableView *m_tableView;
     QPushButton *m_addButton;
     QPushButton *m_deleteButton;
+    QPushButton *m_repriceButton;
     QLabel *m_itemCountLabel;
 
-    // Items model
-    QStandardItemModel *m_model;
-    QSortFilterProxyModel *m_proxyModel;
-
-    // Cached data
-    QVector<Frontier::Item> m_items;
+    // Items model over the shared ItemCatalog
+    ItemTableModel *m_model;
+    ItemFilterProxyModel *m_proxyModel;
 };
 
 #endif // DATAHUBWIDGET_H
@@ -0,0 +1,335 @@
+/**
+ * @file diagnosticstab.cpp
+ * @brief Diagnostics page implementation
+ */
+
+#include "diagnosticstab.h"
+#include "core/profiler.h"
+#include "core/database.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QLocale>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDir>
+#include <algorithm>
+
+namespace {
+
+QTableWidget *createTable(const QStringList &headers)
+{
+    auto *table = new QTableWidget();
+    table->setColumnCount(headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->setVisible(false);
+    table->setAlternatingRowColors(true);
+    table->setSortingEnabled(false);
+    return table;
+}
+
+QTableWidgetItem *numberItem(double value, int decimals = 2)
+{
+    auto *item = new QTableWidgetItem(QLocale().toString(value, 'f', decimals));
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString formatBytes(qint64 bytes)
+{
+    if (bytes < 0) {
+        return QObject::tr("n/a");
+    }
+    return QLocale().formattedDataSize(bytes);
+}
+
+} // namespace
+
+DiagnosticsTab::DiagnosticsTab(Frontier::Database *database, QWidget *parent)
+    : QWidget(parent)
+    , m_database(database)
+{
+    setupUi();
+}
+
+void DiagnosticsTab::setupUi()
+{
+    auto *mainLayout = new QVBoxLayout(this);
+
+    // --- Toolbar ---
+    auto *toolbar = new QHBoxLayout();
+    m_residentLabel = new QLabel();
+    m_refreshBtn = new QPushButton(tr("Refresh"));
+    m_resetBtn = new QPushButton(tr("Reset Timings"));
+    toolbar->addWidget(m_residentLabel);
+    toolbar->addStretch();
+    toolbar->addWidget(m_refreshBtn);
+    toolbar->addWidget(m_resetBtn);
+#ifdef FRONTIER_TRACING
+    auto *timelineBtn = new QPushButton(tr("Save Timeline..."));
+    timelineBtn->setToolTip(tr("Write the trace zones recorded so far, for ui.perfetto.dev"));
+    toolbar->addWidget(timelineBtn);
+    connect(timelineBtn, &QPushButton::clicked, this, &DiagnosticsTab::onSaveTimelineClicked);
+#endif
+    mainLayout->addLayout(toolbar);
+
+    auto *splitter = new QSplitter(Qt::Vertical, this);
+
+    // --- Startup ---
+    auto *startupGroup = new QGroupBox(tr("Startup and First Loads"));
+    auto *startupLayout = new QVBoxLayout(startupGroup);
+    m_startupTable = createTable({tr("Step"), tr("Calls"), tr("Total (ms)"), tr("Max (ms)")});
+    startupLayout->addWidget(m_startupTable);
+    splitter->addWidget(startupGroup);
+
+    // --- Method timings ---
+    auto *timingsGroup = new QGroupBox(tr("Database Methods and Refreshes"));
+    auto *timingsLayout = new QVBoxLayout(timingsGroup);
+    m_timingsTable = createTable({tr("Scope"), tr("Calls"), tr("Total (ms)"), tr("Avg (ms)"), tr("Max (ms)")});
+    timingsLayout->addWidget(m_timingsTable);
+    splitter->addWidget(timingsGroup);
+
+    // --- Slow calls ---
+    auto *slowGroup = new QGroupBox(tr("Slowest Recent Calls (over %1 ms)")
+                                        .arg(Frontier::Profiler::SlowCallNs / 1000000));
+    auto *slowLayout = new QVBoxLayout(slowGroup);
+    m_slowTable = createTable({tr("Scope"), tr("Time (ms)"), tr("At"), tr("Detail")});
+    slowLayout->addWidget(m_slowTable);
+    splitter->addWidget(slowGroup);
+
+    // --- Memory ---
+    auto *memoryGroup = new QGroupBox(tr("Cache Memory (estimated)"));
+    auto *memoryLayout = new QVBoxLayout(memoryGroup);
+    m_memoryTable = createTable({tr("Cache"), tr("Size")});
+    memoryLayout->addWidget(m_memoryTable);
+    splitter->addWidget(memoryGroup);
+
+    // --- SQL trace ---
+    auto *traceGroup = new QGroupBox(tr("SQL Trace"));
+    auto *traceLayout = new QVBoxLayout(traceGroup);
+    auto *traceToolbar = new QHBoxLayout();
+    m_traceCheck = new QCheckBox(tr("Trace statements"));
+    m_planThresholdSpin = new QDoubleSpinBox();
+    m_planThresholdSpin->setRange(0.0, 10000.0);
+    m_planThresholdSpin->setDecimals(1);
+    m_planThresholdSpin->setSuffix(tr(" ms"));
+    m_planThresholdSpin->setValue(Frontier::QueryTracer::DefaultPlanThresholdMs);
+    m_traceCountLabel = new QLabel();
+    m_exportTraceBtn = new QPushButton(tr("Export CSV..."));
+    traceToolbar->addWidget(m_traceCheck);
+    traceToolbar->addWidget(new QLabel(tr("Explain slower than:")));
+    traceToolbar->addWidget(m_planThresholdSpin);
+    traceToolbar->addWidget(m_traceCountLabel);
+    traceToolbar->addStretch();
+    traceToolbar->addWidget(m_exportTraceBtn);
+    traceLayout->addLayout(traceToolbar);
+    m_traceTable = createTable({tr("Statement"), tr("Calls"), tr("Total (ms)"), tr("Max (ms)"),
+                                tr("Rows"), tr("Plan")});
+    traceLayout->addWidget(m_traceTable);
+    splitter->addWidget(traceGroup);
+
+    mainLayout->addWidget(splitter);
+
+    connect(m_refreshBtn, &QPushButton::clicked, this, &DiagnosticsTab::refreshData);
+    connect(m_resetBtn, &QPushButton::clicked, this, &DiagnosticsTab::onResetClicked);
+    connect(m_traceCheck, &QCheckBox::toggled, this, &DiagnosticsTab::onTraceToggled);
+    connect(m_planThresholdSpin, &QDoubleSpinBox::valueChanged, this, [this](double ms) {
+        m_database->queryTracer().setPlanThresholdMs(ms);
+    });
+    connect(m_exportTraceBtn, &QPushButton::clicked, this, &DiagnosticsTab::onExportTraceClicked);
+}
+
+void DiagnosticsTab::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refreshData();
+}
+
+void DiagnosticsTab::refreshData()
+{
+    FRONTIER_TRACE_SCOPE("DiagnosticsTab::refreshData");
+    loadTimings();
+    loadSlowCalls();
+    loadMemory();
+    loadQueryTrace();
+}
+
+void DiagnosticsTab::onResetClicked()
+{
+    Frontier::Profiler::instance().reset();
+    m_database->queryTracer().clear();
+    refreshData();
+}
+
+void DiagnosticsTab::onTraceToggled(bool enabled)
+{
+    auto &tracer = m_database->queryTracer();
+    tracer.setPlanThresholdMs(m_planThresholdSpin->value());
+    tracer.setEnabled(enabled);
+    loadQueryTrace();
+}
+
+void DiagnosticsTab::onExportTraceClicked()
+{
+    QString filePath = QFileDialog::getSaveFileName(this,
+        tr("Export SQL Trace"),
+        QDir::homePath() + "/sql-trace.csv",
+        tr("CSV Files (*.csv);;All Files (*)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    auto &tracer = m_database->queryTracer();
+    if (!tracer.exportCsv(filePath)) {
+        QMessageBox::warning(this, tr("Export Failed"),
+                             tr("Could not write %1:\n%2").arg(filePath, tracer.lastError()));
+    }
+}
+
+void DiagnosticsTab::onSaveTimelineClicked()
+{
+#ifdef FRONTIER_TRACING
+    QString filePath = QFileDialog::getSaveFileName(this,
+        tr("Save Trace Timeline"),
+        QDir::homePath() + "/frontier-trace.json",
+        tr("Trace Files (*.json);;All Files (*)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!Frontier::Trace::writeChromeTrace(filePath, &error)) {
+        QMessageBox::warning(this, tr("Export Failed"),
+                             tr("Could not write %1:\n%2").arg(filePath, error));
+    }
+#endif
+}
+
+void DiagnosticsTab::loadTimings()
+{
+    const auto stats = Frontier::Profiler::instance().stats();
+
+    m_startupTable->setRowCount(0);
+    m_timingsTable->setRowCount(0);
+
+    for (const auto &stat : stats) {
+        if (stat.name.startsWith(QLatin1String("Startup: "))) {
+            int row = m_startupTable->rowCount();
+            m_startupTable->insertRow(row);
+            m_startupTable->setItem(row, 0, new QTableWidgetItem(stat.name.mid(9)));
+            m_startupTable->setItem(row, 1, numberItem(stat.calls, 0));
+            m_startupTable->setItem(row, 2, numberItem(stat.totalMs()));
+            m_startupTable->setItem(row, 3, numberItem(stat.maxMs()));
+            continue;
+        }
+
+        int row = m_timingsTable->rowCount();
+        m_timingsTable->insertRow(row);
+        m_timingsTable->setItem(row, 0, new QTableWidgetItem(stat.name));
+        m_timingsTable->setItem(row, 1, numberItem(stat.calls, 0));
+        m_timingsTable->setItem(row, 2, numberItem(stat.totalMs()));
+        m_timingsTable->setItem(row, 3, numberItem(stat.averageMs()));
+        m_timingsTable->setItem(row, 4, numberItem(stat.maxMs()));
+    }
+
+    m_startupTable->resizeColumnsToContents();
+    m_timingsTable->resizeColumnsToContents();
+}
+
+void DiagnosticsTab::loadSlowCalls()
+{
+    const auto calls = Frontier::Profiler::instance().slowCalls();
+
+    m_slowTable->setRowCount(calls.size());
+    for (int row = 0; row < calls.size(); ++row) {
+        const auto &call = calls[row];
+        m_slowTable->setItem(row, 0, new QTableWidgetItem(call.name));
+        m_slowTable->setItem(row, 1, numberItem(call.ns / 1e6));
+        m_slowTable->setItem(row, 2, new QTableWidgetItem(call.at.toString("hh:mm:ss")));
+        auto *detail = new QTableWidgetItem(call.detail.simplified());
+        detail->setToolTip(call.detail);
+        m_slowTable->setItem(row, 3, detail);
+    }
+    m_slowTable->resizeColumnsToContents();
+}
+
+void DiagnosticsTab::loadMemory()
+{
+    const auto reports = Frontier::Profiler::instance().memoryReports();
+
+    m_memoryTable->setRowCount(reports.size());
+    qint64 total = 0;
+    for (int row = 0; row < reports.size(); ++row) {
+        const auto &report = reports[row];
+        total += report.bytes;
+        m_memoryTable->setItem(row, 0, new QTableWidgetItem(report.name));
+        auto *size = new QTableWidgetItem(formatBytes(report.bytes));
+        size->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        m_memoryTable->setItem(row, 1, size);
+    }
+    m_memoryTable->resizeColumnsToContents();
+
+    m_residentLabel->setText(tr("Resident memory: %1   Caches: %2")
+                                 .arg(formatBytes(Frontier::Profiler::residentBytes()))
+                                 .arg(formatBytes(total)));
+}
+
+void DiagnosticsTab::loadQueryTrace()
+{
+    struct Row {
+        QString sql;
+        int calls = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        int rows = -1;
+        QString plan;
+    };
+
+    const auto &tracer = m_database->queryTracer();
+    const auto entries = tracer.entries();
+
+    // One row per statement text, slowest total first
+    QHash<QString, Row> bySql;
+    for (const auto &entry : entries) {
+        Row &row = bySql[entry.sql];
+        row.sql = entry.sql;
+        row.calls++;
+        row.totalNs += entry.ns;
+        row.maxNs = qMax(row.maxNs, entry.ns);
+        row.rows = qMax(row.rows, entry.rows);
+        if (!entry.plan.isEmpty()) {
+            row.plan = entry.plan;
+        }
+    }
+    QVector<Row> rows(bySql.cbegin(), bySql.cend());
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+        return a.totalNs > b.totalNs;
+    });
+
+    m_traceCheck->blockSignals(true);
+    m_traceCheck->setChecked(tracer.isEnabled());
+    m_traceCheck->blockSignals(false);
+    m_traceCountLabel->setText(tr("%n statement(s) logged", nullptr, entries.size()));
+
+    const int shown = qMin(int(rows.size()), 200);
+    m_traceTable->setRowCount(shown);
+    for (int i = 0; i < shown; ++i) {
+        const Row &row = rows[i];
+        auto *sql = new QTableWidgetItem(row.sql.simplified());
+        sql->setToolTip(row.sql);
+        m_traceTable->setItem(i, 0, sql);
+        m_traceTable->setItem(i, 1, numberItem(row.calls, 0));
+        m_traceTable->setItem(i, 2, numberItem(row.totalNs / 1e6));
+        m_traceTable->setItem(i, 3, numberItem(row.maxNs / 1e6));
+        m_traceTable->setItem(i, 4, numberItem(row.rows, 0));
+        auto *plan = new QTableWidgetItem(row.plan.simplified());
+        plan->setToolTip(row.plan);
+        m_traceTable->setItem(i, 5, plan);
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file diagnosticstab.h
+ * @brief Hidden Data Hub page showing startup, query and cache diagnostics
+ */
+
+#ifndef DIAGNOSTICSTAB_H
+#define DIAGNOSTICSTAB_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+
+namespace Frontier {
+class Database;
+}
+
+class DiagnosticsTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsTab(Frontier::Database *database, QWidget *parent = nullptr);
+
+public slots:
+    void refreshData();
+
+private slots:
+    void onResetClicked();
+    void onTraceToggled(bool enabled);
+    void onExportTraceClicked();
+    void onSaveTimelineClicked();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void setupUi();
+    void loadTimings();
+    void loadSlowCalls();
+    void loadMemory();
+    void loadQueryTrace();
+
+    Frontier::Database *m_database;
+
+    QTableWidget *m_startupTable;
+    QTableWidget *m_timingsTable;
+    QTableWidget *m_slowTable;
+    QTableWidget *m_memoryTable;
+    QTableWidget *m_traceTable;
+    QCheckBox *m_traceCheck;
+    QDoubleSpinBox *m_planThresholdSpin;
+    QPushButton *m_exportTraceBtn;
+    QLabel *m_traceCountLabel;
+    QLabel *m_residentLabel;
+    QPushButton *m_refreshBtn;
+    QPushButton *m_resetBtn;
+};
+
+#endif // DIAGNOSTICSTAB_H
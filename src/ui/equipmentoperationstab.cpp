@@ -23,6 +23,8 @@ EquipmentOperationsTab::EquipmentOperationsTab(Frontier::OperationsManager *mana
     // Listen for unit system changes
     connect(m_manager, &Frontier::OperationsManager::unitSystemChanged,
             this, &EquipmentOperationsTab::onUnitSystemChanged);
+    connect(m_manager, &Frontier::OperationsManager::fuelLogChanged,
+            this, &EquipmentOperationsTab::onFuelLogChanged);
 }
 
 EquipmentOperationsTab::~EquipmentOperationsTab()
@@ -63,6 +65,22 @@ void EquipmentOperationsTab::setupUi()
 
     mainLayout->addWidget(infoGroup);
 
+    // Fuel Efficiency
+    QGroupBox *efficiencyGroup = new QGroupBox("Fuel Efficiency (logged hours)");
+    QFormLayout *efficiencyLayout = new QFormLayout(efficiencyGroup);
+
+    m_week7Label = new QLabel("-");
+    m_month30Label = new QLabel("-");
+    m_lifetimeLabel = new QLabel("-");
+    m_efficiencyStatusLabel = new QLabel("-");
+
+    efficiencyLayout->addRow("Last 7 Days:", m_week7Label);
+    efficiencyLayout->addRow("Last 30 Days:", m_month30Label);
+    efficiencyLayout->addRow("Lifetime:", m_lifetimeLabel);
+    efficiencyLayout->addRow("Status:", m_efficiencyStatusLabel);
+
+    mainLayout->addWidget(efficiencyGroup);
+
     // Usage Entry
     QGroupBox *usageGroup = new QGroupBox("Usage Entry");
     QFormLayout *usageLayout = new QFormLayout(usageGroup);
@@ -136,6 +154,7 @@ void EquipmentOperationsTab::updateEquipmentInfo()
         m_truckCapacityLabel->setText("-");
         m_tankCapacityLabel->setText("-");
         m_fuelUseLabel->setText("-");
+        updateEfficiency();
         return;
     }
 
@@ -166,6 +185,52 @@ void EquipmentOperationsTab::updateEquipmentInfo()
     }
 
     m_fuelUseLabel->setText(UC::formatFuelRate(spec->fuelUseLPerHour, units));
+    updateEfficiency();
+}
+
+void EquipmentOperationsTab::onFuelLogChanged()
+{
+    updateEfficiency();
+}
+
+void EquipmentOperationsTab::updateEfficiency()
+{
+    QString equipmentId = m_equipmentCombo->currentData().toString();
+
+    if (equipmentId.isEmpty()) {
+        m_week7Label->setText("-");
+        m_month30Label->setText("-");
+        m_lifetimeLabel->setText("-");
+        m_efficiencyStatusLabel->setText("-");
+        m_efficiencyStatusLabel->setStyleSheet(QString());
+        return;
+    }
+
+    using UC = Frontier::UnitConverter;
+    Frontier::UnitSystem units = m_manager->unitSystem();
+
+    // Running windows, patched as entries are logged
+    const Frontier::EquipmentEfficiency efficiency = m_manager->getFuelEfficiency(equipmentId);
+    auto describe = [&](const Frontier::FuelWindow &window) {
+        if (window.hours <= 0) {
+            return QString("No hours logged");
+        }
+        return QString("%1 over %2 h").arg(UC::formatFuelRate(window.litersPerHour(), units))
+                                      .arg(window.hours, 0, 'f', 1);
+    };
+
+    m_week7Label->setText(describe(efficiency.last7));
+    QString month = describe(efficiency.last30);
+    if (efficiency.specLPerHour > 0 && efficiency.last30.hours > 0) {
+        month += QString(" (%1%2% vs rated)").arg(efficiency.deviationPercent() >= 0 ? "+" : "")
+                                              .arg(efficiency.deviationPercent(), 0, 'f', 0);
+    }
+    m_month30Label->setText(month);
+    m_lifetimeLabel->setText(describe(efficiency.lifetime));
+
+    const bool flagged = efficiency.anomalies.toInt() != 0;
+    m_efficiencyStatusLabel->setText(flagged ? efficiency.anomalyText() : "OK");
+    m_efficiencyStatusLabel->setStyleSheet(flagged ? "color: red; font-weight: bold;" : QString());
 }
 
 void EquipmentOperationsTab::onSaveUsage()
@@ -27,12 +27,14 @@ public:
 private slots:
     void onEquipmentChanged(int index);
     void onUnitSystemChanged(Frontier::UnitSystem system);
+    void onFuelLogChanged();
     void onSaveUsage();
 
 private:
     void setupUi();
     void loadEquipment();
     void updateEquipmentInfo();
+    void updateEfficiency();
 
     Frontier::OperationsManager *m_manager;
 
@@ -42,6 +44,10 @@ private:
     QLabel *m_truckCapacityLabel;
     QLabel *m_fuelUseLabel;
     QLabel *m_tankCapacityLabel;
+    QLabel *m_week7Label;
+    QLabel *m_month30Label;
+    QLabel *m_lifetimeLabel;
+    QLabel *m_efficiencyStatusLabel;
     QDoubleSpinBox *m_hoursSpinBox;
     QTextEdit *m_notesEdit;
     QPushButton *m_saveButton;
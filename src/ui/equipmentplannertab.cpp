@@ -5,6 +5,10 @@
 
 #include "equipmentplannertab.h"
 #include "core/database.h"
+#include "core/capitalplanservice.h"
+#include "core/commandjournal.h"
+#include "core/itemcatalog.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -27,6 +31,11 @@ EquipmentPlannerTab::EquipmentPlannerTab(Frontier::Database *database, QWidget *
 {
     setupUi();
     refreshData();
+    // Reloads the plan when a queued quantity edit fails to land
+    m_database->changeBus().subscribe(this, Frontier::DataTable::CapitalPlan,
+                                      [this]() { loadPlan(); });
+    connect(&m_database->journal(), &Frontier::CommandJournal::applied,
+            this, &EquipmentPlannerTab::onJournalApplied);
 }
 
 void EquipmentPlannerTab::setupUi()
@@ -139,6 +148,7 @@ void EquipmentPlannerTab::setupUi()
 
 void EquipmentPlannerTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("EquipmentPlannerTab::refreshData");
     // Populate item combo
     m_itemCombo->clear();
     auto items = m_database->getAllItems();
@@ -156,16 +166,18 @@ void EquipmentPlannerTab::loadPlan()
 {
     m_table->setRowCount(0);
 
-    auto plan = m_database->getEquipmentPlan();
+    // Queued quantity edits must be in the table before it is read back
+    m_database->flushPendingWrites();
+    m_database->changeBus().acknowledge(this);
+    m_plan.reset(m_database->getEquipmentPlan());
+    m_database->capitalPlan().setEquipmentTotals(m_plan.totals());
 
-    for (const auto &item : plan) {
+    for (const auto &item : m_plan.lines()) {
         int row = m_table->rowCount();
         m_table->insertRow(row);
 
         // Item name
-        auto *nameItem = new QTableWidgetItem(item.itemName);
-        nameItem->setData(Qt::UserRole, item.id.value_or(0));
-        m_table->setItem(row, 0, nameItem);
+        m_table->setItem(row, 0, new QTableWidgetItem(item.itemName));
 
         // Category
         m_table->setItem(row, 1, new QTableWidgetItem(item.category));
@@ -183,7 +195,6 @@ void EquipmentPlannerTab::loadPlan()
         // Unit Price
         auto *priceItem = new QTableWidgetItem(formatCurrency(item.unitPrice));
         priceItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        priceItem->setData(Qt::UserRole, item.unitPrice);
         m_table->setItem(row, 3, priceItem);
 
         // Total Cost
@@ -198,26 +209,15 @@ void EquipmentPlannerTab::loadPlan()
 
 void EquipmentPlannerTab::updateSummary()
 {
-    int itemCount = m_table->rowCount();
-    double totalCost = 0;
-
-    for (int row = 0; row < m_table->rowCount(); ++row) {
-        auto *priceItem = m_table->item(row, 3);
-        auto *qtySpin = qobject_cast<QSpinBox*>(m_table->cellWidget(row, 2));
-        if (priceItem && qtySpin) {
-            double unitPrice = priceItem->data(Qt::UserRole).toDouble();
-            totalCost += unitPrice * qtySpin->value();
-        }
-    }
-
-    m_itemCountLabel->setText(QString(tr("Items: %1")).arg(itemCount));
-    m_totalCostLabel->setText(QString(tr("Total: %1")).arg(formatCurrency(totalCost)));
+    const Frontier::PlanTotals &totals = m_plan.totals();
+    m_itemCountLabel->setText(QString(tr("Items: %1")).arg(totals.lineCount));
+    m_totalCostLabel->setText(QString(tr("Total: %1")).arg(formatCurrency(totals.cost)));
 }
 
 void EquipmentPlannerTab::onItemSelected(const QString &itemName)
 {
-    auto item = m_database->getItemByName(itemName);
-    if (item.has_value()) {
+    const Frontier::Item *item = m_database->itemCatalog().findByName(itemName);
+    if (item) {
         double unitPrice = item->buyPriceInternal;
         int qty = m_quantitySpin->value();
 
@@ -236,8 +236,8 @@ void EquipmentPlannerTab::onAddClicked()
         return;
     }
 
-    auto item = m_database->getItemByName(itemName);
-    if (!item.has_value()) {
+    const Frontier::Item *item = m_database->itemCatalog().findByName(itemName);
+    if (!item) {
         QMessageBox::warning(this, tr("Error"), tr("Item not found in database."));
         return;
     }
@@ -268,13 +268,9 @@ void EquipmentPlannerTab::onAddClicked()
 void EquipmentPlannerTab::onRemoveClicked()
 {
     int row = m_table->currentRow();
-    if (row < 0) return;
+    if (row < 0 || row >= m_plan.size()) return;
 
-    auto *nameItem = m_table->item(row, 0);
-    if (!nameItem) return;
-
-    int planId = nameItem->data(Qt::UserRole).toInt();
-    m_database->deleteEquipmentPlanItem(planId);
+    m_database->deleteEquipmentPlanItem(m_plan.at(row).id.value_or(0));
 
     loadPlan();
     emit planChanged();
@@ -282,7 +278,7 @@ void EquipmentPlannerTab::onRemoveClicked()
 
 void EquipmentPlannerTab::onClearAllClicked()
 {
-    if (m_table->rowCount() == 0) return;
+    if (m_plan.isEmpty()) return;
 
     auto result = QMessageBox::question(this, tr("Clear All"),
                                         tr("Are you sure you want to clear all items from the equipment plan?"),
@@ -297,25 +293,53 @@ void EquipmentPlannerTab::onClearAllClicked()
 
 void EquipmentPlannerTab::onQuantityChanged(int row, int newQty)
 {
-    auto *nameItem = m_table->item(row, 0);
-    auto *priceItem = m_table->item(row, 3);
-    if (!nameItem || !priceItem) return;
-
-    int planId = nameItem->data(Qt::UserRole).toInt();
-    double unitPrice = priceItem->data(Qt::UserRole).toDouble();
-    double newTotal = unitPrice * newQty;
-
-    // Update display
-    m_table->item(row, 4)->setText(formatCurrency(newTotal));
-
-    // Update database
-    auto planItem = m_database->getEquipmentPlanItem(planId);
-    if (planItem.has_value()) {
-        planItem->quantity = newQty;
-        planItem->totalCost = newTotal;
-        m_database->updateEquipmentPlanItem(*planItem);
-    }
+    if (row < 0 || row >= m_plan.size()) return;
+    const Frontier::EquipmentPlanItem before = m_plan.at(row);
+    const Frontier::EquipmentPlanItem *item = m_plan.setQuantity(row, newQty);
+
+    showLineTotals(row, *item);
+
+    // Spin-box steps arrive in bursts; queue so a burst is one UPDATE
+    const Frontier::EquipmentPlanItem updated = *item;
+    m_database->queueWrite(QStringLiteral("equipment_plan:%1").arg(updated.id.value_or(0)),
+                           Frontier::DataTable::CapitalPlan,
+                           [updated](Frontier::Database &db) {
+                               return db.updateEquipmentPlanItem(updated);
+                           },
+                           this);
+    // Successive steps on one line merge into a single undo step
+    m_database->journal().record(Frontier::JournalCommand::setPlanQuantity(before, updated));
+    m_database->capitalPlan().setEquipmentTotals(m_plan.totals());
 
     updateSummary();
     emit planChanged();
 }
+
+void EquipmentPlannerTab::showLineTotals(int row, const Frontier::EquipmentPlanItem &item)
+{
+    m_table->item(row, 4)->setText(formatCurrency(item.totalCost));
+}
+
+void EquipmentPlannerTab::onJournalApplied(const Frontier::JournalChange &change)
+{
+    if (change.table != Frontier::JournalChange::EquipmentPlan) return;
+
+    for (int row = 0; row < m_plan.size(); ++row) {
+        if (m_plan.at(row).id != change.rowId) continue;
+
+        auto stored = m_database->getEquipmentPlanItem(change.rowId);
+        if (!stored) return;
+
+        // Blocked: onQuantityChanged() would journal the undo as a new edit
+        if (auto *spin = qobject_cast<QSpinBox *>(m_table->cellWidget(row, 2))) {
+            const QSignalBlocker blocker(spin);
+            spin->setValue(stored->quantity);
+        }
+        showLineTotals(row, *m_plan.setQuantity(row, stored->quantity));
+        m_database->capitalPlan().setEquipmentTotals(m_plan.totals());
+
+        updateSummary();
+        emit planChanged();
+        return;
+    }
+}
@@ -14,9 +14,11 @@
 #include <QLabel>
 
 #include "core/types.h"
+#include "core/planmodel.h"
 
 namespace Frontier {
 class Database;
+struct JournalChange;
 }
 
 class EquipmentPlannerTab : public QWidget
@@ -37,15 +39,20 @@ private slots:
     void onRemoveClicked();
     void onClearAllClicked();
     void onQuantityChanged(int row, int newQty);
+    void onJournalApplied(const Frontier::JournalChange &change);
     void onItemSelected(const QString &itemName);
 
 private:
     void setupUi();
     void loadPlan();
     void updateSummary();
+    void showLineTotals(int row, const Frontier::EquipmentPlanItem &item);
 
     Frontier::Database *m_database;
 
+    // Rows of m_table mirror m_plan; totals are kept by the model
+    Frontier::EquipmentPlanModel m_plan;
+
     // Add item section
     QComboBox *m_itemCombo;
     QSpinBox *m_quantitySpin;
@@ -5,6 +5,10 @@
 
 #include "facilityplannertab.h"
 #include "core/database.h"
+#include "core/capitalplanservice.h"
+#include "core/commandjournal.h"
+#include "core/recipegraph.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -34,6 +38,11 @@ FacilityPlannerTab::FacilityPlannerTab(Frontier::Database *database, QWidget *pa
 {
     setupUi();
     refreshData();
+    // Reloads the plan when a queued quantity edit fails to land
+    m_database->changeBus().subscribe(this, Frontier::DataTable::CapitalPlan,
+                                      [this]() { loadPlan(); });
+    connect(&m_database->journal(), &Frontier::CommandJournal::applied,
+            this, &FacilityPlannerTab::onJournalApplied);
 }
 
 void FacilityPlannerTab::setupUi()
@@ -176,15 +185,28 @@ void FacilityPlannerTab::setupUi()
 
     planLayout->addLayout(actionLayout);
 
+    // Steady-state simulation of the whole layout
+    m_simulationLabel = new QLabel();
+    m_simulationLabel->setWordWrap(true);
+    m_simulationLabel->setStyleSheet("color: #555;");
+    planLayout->addWidget(m_simulationLabel);
+
     mainLayout->addWidget(planGroup, 1);
 }
 
 void FacilityPlannerTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("FacilityPlannerTab::refreshData");
     populateBuildingCombo();
+    compileSimulator();
     loadPlan();
 }
 
+void FacilityPlannerTab::compileSimulator()
+{
+    m_simulator.compile(m_database->getAllFactoryBuildings(), m_database->recipeGraph()->recipes());
+}
+
 void FacilityPlannerTab::populateBuildingCombo()
 {
     m_buildingCombo->clear();
@@ -207,16 +229,18 @@ void FacilityPlannerTab::loadPlan()
 {
     m_table->setRowCount(0);
 
-    auto plan = m_database->getFacilityPlan();
+    // Queued quantity edits must be in the table before it is read back
+    m_database->flushPendingWrites();
+    m_database->changeBus().acknowledge(this);
+    m_plan.reset(m_database->getFacilityPlan());
+    m_database->capitalPlan().setFacilityTotals(m_plan.totals());
 
-    for (const auto &item : plan) {
+    for (const auto &item : m_plan.lines()) {
         int row = m_table->rowCount();
         m_table->insertRow(row);
 
         // Building name
-        auto *nameItem = new QTableWidgetItem(item.buildingName);
-        nameItem->setData(Qt::UserRole, item.id.value_or(0));
-        m_table->setItem(row, 0, nameItem);
+        m_table->setItem(row, 0, new QTableWidgetItem(item.buildingName));
 
         // Category (shortened)
         QString shortCat = item.category;
@@ -236,7 +260,6 @@ void FacilityPlannerTab::loadPlan()
         // Power (kW)
         auto *powerItem = new QTableWidgetItem(formatPower(item.totalPowerKw));
         powerItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        powerItem->setData(Qt::UserRole, item.unitPowerKw);
         if (item.totalPowerKw > 0) {
             powerItem->setForeground(QColor("#c62828"));
         }
@@ -245,7 +268,6 @@ void FacilityPlannerTab::loadPlan()
         // Generated (kW)
         auto *genItem = new QTableWidgetItem(formatPower(item.totalGeneratedKw));
         genItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        genItem->setData(Qt::UserRole, item.unitGeneratedKw);
         if (item.totalGeneratedKw > 0) {
             genItem->setForeground(QColor("#2e7d32"));
         }
@@ -254,7 +276,6 @@ void FacilityPlannerTab::loadPlan()
         // Unit Price
         auto *priceItem = new QTableWidgetItem(formatCurrency(item.unitPrice));
         priceItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        priceItem->setData(Qt::UserRole, item.unitPrice);
         m_table->setItem(row, 5, priceItem);
 
         // Total Cost
@@ -269,35 +290,13 @@ void FacilityPlannerTab::loadPlan()
 
 void FacilityPlannerTab::updateSummary()
 {
-    int itemCount = m_table->rowCount();
-    double totalCost = 0;
-    double totalPower = 0;
-    double totalGenerated = 0;
-
-    for (int row = 0; row < m_table->rowCount(); ++row) {
-        auto *priceItem = m_table->item(row, 5);
-        auto *powerItem = m_table->item(row, 3);
-        auto *genItem = m_table->item(row, 4);
-        auto *qtySpin = qobject_cast<QSpinBox*>(m_table->cellWidget(row, 2));
-
-        if (priceItem && qtySpin) {
-            int qty = qtySpin->value();
-            double unitPrice = priceItem->data(Qt::UserRole).toDouble();
-            double unitPower = powerItem->data(Qt::UserRole).toDouble();
-            double unitGen = genItem->data(Qt::UserRole).toDouble();
-
-            totalCost += unitPrice * qty;
-            totalPower += unitPower * qty;
-            totalGenerated += unitGen * qty;
-        }
-    }
-
-    double powerBalance = totalGenerated - totalPower;
+    const Frontier::PlanTotals &totals = m_plan.totals();
+    const double powerBalance = totals.powerBalanceKw();
 
-    m_itemCountLabel->setText(QString(tr("Items: %1")).arg(itemCount));
-    m_totalCostLabel->setText(QString(tr("Total: %1")).arg(formatCurrency(totalCost)));
-    m_totalPowerLabel->setText(QString(tr("Power: %1")).arg(formatPower(totalPower)));
-    m_totalGeneratedLabel->setText(QString(tr("Generated: %1")).arg(formatPower(totalGenerated)));
+    m_itemCountLabel->setText(QString(tr("Items: %1")).arg(totals.lineCount));
+    m_totalCostLabel->setText(QString(tr("Total: %1")).arg(formatCurrency(totals.cost)));
+    m_totalPowerLabel->setText(QString(tr("Power: %1")).arg(formatPower(totals.powerKw)));
+    m_totalGeneratedLabel->setText(QString(tr("Generated: %1")).arg(formatPower(totals.generatedKw)));
 
     QString balanceStr = (powerBalance >= 0 ? "+" : "") + formatPower(powerBalance);
     m_powerBalanceLabel->setText(QString(tr("Balance: %1")).arg(balanceStr));
@@ -307,6 +306,48 @@ void FacilityPlannerTab::updateSummary()
     } else {
         m_powerBalanceLabel->setStyleSheet("font-weight: bold; color: #c62828;");
     }
+    updateSimulation();
+}
+
+void FacilityPlannerTab::updateSimulation()
+{
+    if (m_plan.isEmpty()) {
+        m_simulationLabel->clear();
+        return;
+    }
+
+    const Frontier::FacilitySimulation sim = m_simulator.simulate(m_plan.lines());
+    QLocale locale(QLocale::English);
+    QStringList parts;
+
+    if (sim.powerFactor < 1.0) {
+        parts << tr("Grid delivers %1% of demand").arg(qRound(sim.powerFactor * 100));
+    }
+    if (sim.transmissionLimited()) {
+        parts << tr("pylons cap transmission at %1").arg(formatPower(sim.transmissionKw));
+    }
+    if (sim.conveyors.isBottleneck()) {
+        parts << tr("%1 limits conveyors to %2/h (needs %3/h)")
+                     .arg(sim.conveyors.slowestSegment)
+                     .arg(locale.toString(qRound64(sim.conveyors.capacityPerHour)))
+                     .arg(locale.toString(qRound64(sim.conveyors.demandPerHour)));
+    }
+    if (sim.pipelines.isBottleneck()) {
+        parts << tr("%1 limits pipelines to %2/h")
+                     .arg(sim.pipelines.slowestSegment)
+                     .arg(locale.toString(qRound64(sim.pipelines.capacityPerHour)));
+    }
+
+    QStringList outputs;
+    for (auto it = sim.outputPerHour.constBegin(); it != sim.outputPerHour.constEnd(); ++it) {
+        outputs << QString("%1 %2").arg(locale.toString(it.value(), 'f', 1), it.key());
+    }
+    if (!outputs.isEmpty()) {
+        parts << tr("Output per hour: %1").arg(outputs.join(", "));
+    }
+
+    m_simulationLabel->setText(parts.isEmpty() ? tr("No power or throughput limits in this layout")
+                                               : parts.join(" | "));
 }
 
 void FacilityPlannerTab::onCategoryFilterChanged()
@@ -387,13 +428,9 @@ void FacilityPlannerTab::onAddClicked()
 void FacilityPlannerTab::onRemoveClicked()
 {
     int row = m_table->currentRow();
-    if (row < 0) return;
+    if (row < 0 || row >= m_plan.size()) return;
 
-    auto *nameItem = m_table->item(row, 0);
-    if (!nameItem) return;
-
-    int planId = nameItem->data(Qt::UserRole).toInt();
-    m_database->deleteFacilityPlanItem(planId);
+    m_database->deleteFacilityPlanItem(m_plan.at(row).id.value_or(0));
 
     loadPlan();
     emit planChanged();
@@ -401,7 +438,7 @@ void FacilityPlannerTab::onRemoveClicked()
 
 void FacilityPlannerTab::onClearAllClicked()
 {
-    if (m_table->rowCount() == 0) return;
+    if (m_plan.isEmpty()) return;
 
     auto result = QMessageBox::question(this, tr("Clear All"),
                                         tr("Are you sure you want to clear all items from the facility plan?"),
@@ -416,37 +453,55 @@ void FacilityPlannerTab::onClearAllClicked()
 
 void FacilityPlannerTab::onQuantityChanged(int row, int newQty)
 {
-    auto *nameItem = m_table->item(row, 0);
-    auto *priceItem = m_table->item(row, 5);
-    auto *powerItem = m_table->item(row, 3);
-    auto *genItem = m_table->item(row, 4);
-
-    if (!nameItem || !priceItem || !powerItem || !genItem) return;
-
-    int planId = nameItem->data(Qt::UserRole).toInt();
-    double unitPrice = priceItem->data(Qt::UserRole).toDouble();
-    double unitPower = powerItem->data(Qt::UserRole).toDouble();
-    double unitGen = genItem->data(Qt::UserRole).toDouble();
-
-    double newTotal = unitPrice * newQty;
-    double newPower = unitPower * newQty;
-    double newGen = unitGen * newQty;
-
-    // Update display
-    m_table->item(row, 3)->setText(formatPower(newPower));
-    m_table->item(row, 4)->setText(formatPower(newGen));
-    m_table->item(row, 6)->setText(formatCurrency(newTotal));
-
-    // Update database
-    auto planItem = m_database->getFacilityPlanItem(planId);
-    if (planItem.has_value()) {
-        planItem->quantity = newQty;
-        planItem->totalCost = newTotal;
-        planItem->totalPowerKw = newPower;
-        planItem->totalGeneratedKw = newGen;
-        m_database->updateFacilityPlanItem(*planItem);
-    }
+    if (row < 0 || row >= m_plan.size()) return;
+    const Frontier::FacilityPlanItem before = m_plan.at(row);
+    const Frontier::FacilityPlanItem *item = m_plan.setQuantity(row, newQty);
+
+    showLineTotals(row, *item);
+
+    // Spin-box steps arrive in bursts; queue so a burst is one UPDATE
+    const Frontier::FacilityPlanItem updated = *item;
+    m_database->queueWrite(QStringLiteral("facility_plan:%1").arg(updated.id.value_or(0)),
+                           Frontier::DataTable::CapitalPlan,
+                           [updated](Frontier::Database &db) {
+                               return db.updateFacilityPlanItem(updated);
+                           },
+                           this);
+    // Successive steps on one line merge into a single undo step
+    m_database->journal().record(Frontier::JournalCommand::setPlanQuantity(before, updated));
+    m_database->capitalPlan().setFacilityTotals(m_plan.totals());
 
     updateSummary();
     emit planChanged();
 }
+
+void FacilityPlannerTab::showLineTotals(int row, const Frontier::FacilityPlanItem &item)
+{
+    m_table->item(row, 3)->setText(formatPower(item.totalPowerKw));
+    m_table->item(row, 4)->setText(formatPower(item.totalGeneratedKw));
+    m_table->item(row, 6)->setText(formatCurrency(item.totalCost));
+}
+
+void FacilityPlannerTab::onJournalApplied(const Frontier::JournalChange &change)
+{
+    if (change.table != Frontier::JournalChange::FacilityPlan) return;
+
+    for (int row = 0; row < m_plan.size(); ++row) {
+        if (m_plan.at(row).id != change.rowId) continue;
+
+        auto stored = m_database->getFacilityPlanItem(change.rowId);
+        if (!stored) return;
+
+        // Blocked: onQuantityChanged() would journal the undo as a new edit
+        if (auto *spin = qobject_cast<QSpinBox *>(m_table->cellWidget(row, 2))) {
+            const QSignalBlocker blocker(spin);
+            spin->setValue(stored->quantity);
+        }
+        showLineTotals(row, *m_plan.setQuantity(row, stored->quantity));
+        m_database->capitalPlan().setFacilityTotals(m_plan.totals());
+
+        updateSummary();
+        emit planChanged();
+        return;
+    }
+}
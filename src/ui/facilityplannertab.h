@@ -14,9 +14,12 @@
 #include <QLabel>
 
 #include "core/types.h"
+#include "core/planmodel.h"
+#include "core/facilitysimulator.h"
 
 namespace Frontier {
 class Database;
+struct JournalChange;
 }
 
 class FacilityPlannerTab : public QWidget
@@ -37,6 +40,7 @@ private slots:
     void onRemoveClicked();
     void onClearAllClicked();
     void onQuantityChanged(int row, int newQty);
+    void onJournalApplied(const Frontier::JournalChange &change);
     void onBuildingSelected(const QString &buildingName);
     void onCategoryFilterChanged();
 
@@ -44,10 +48,17 @@ private:
     void setupUi();
     void loadPlan();
     void updateSummary();
+    void showLineTotals(int row, const Frontier::FacilityPlanItem &item);
+    void updateSimulation();
+    void compileSimulator();
     void populateBuildingCombo();
 
     Frontier::Database *m_database;
 
+    // Rows of m_table mirror m_plan; totals are kept by the model
+    Frontier::FacilityPlanModel m_plan;
+    Frontier::FacilitySimulator m_simulator;     // Recompiled in refreshData()
+
     // Add building section
     QComboBox *m_categoryFilterCombo;
     QComboBox *m_buildingCombo;
@@ -70,6 +81,7 @@ private:
     QLabel *m_totalPowerLabel;
     QLabel *m_totalGeneratedLabel;
     QLabel *m_powerBalanceLabel;
+    QLabel *m_simulationLabel;
 };
 
 #endif // FACILITYPLANNERTAB_H
@@ -5,6 +5,8 @@
 
 #include "factorybuildingstab.h"
 #include "core/database.h"
+#include "core/factorybuildingimporter.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -12,10 +14,6 @@
 #include <QHeaderView>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QFile>
 #include <QLocale>
 
 namespace {
@@ -135,6 +133,7 @@ void FactoryBuildingsTab::setupUi()
 
 void FactoryBuildingsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("FactoryBuildingsTab::refreshData");
     loadFactoryBuildings();
 }
 
@@ -259,68 +258,23 @@ void FactoryBuildingsTab::onImportClicked()
         return;
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::critical(this, tr("Error"), tr("Could not open file."));
+    QString error;
+    int skipped = 0;
+    const QVector<Frontier::FactoryBuilding> buildings =
+        Frontier::FactoryBuildingImporter::loadFromJson(filePath, &error, &skipped);
+    if (!error.isEmpty()) {
+        QMessageBox::critical(this, tr("Error"), error);
         return;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    if (error.error != QJsonParseError::NoError) {
+    // Existing buildings are updated by name
+    int imported = Frontier::FactoryBuildingImporter::upsertBuildings(buildings, m_database);
+    if (imported < 0) {
         QMessageBox::critical(this, tr("Error"),
-                              tr("JSON parse error: %1").arg(error.errorString()));
-        return;
-    }
-
-    if (!doc.isArray()) {
-        QMessageBox::critical(this, tr("Error"), tr("JSON must be an array."));
+                              tr("Could not write factory buildings: %1").arg(m_database->lastError()));
         return;
     }
 
-    QJsonArray arr = doc.array();
-    int imported = 0;
-    int skipped = 0;
-
-    for (const auto &val : arr) {
-        if (!val.isObject()) continue;
-
-        QJsonObject obj = val.toObject();
-
-        Frontier::FactoryBuilding building;
-        building.name = obj["name"].toString();
-        building.category = obj["category"].toString();
-        building.dimensions = obj["dimensions"].toString();
-        building.speed = obj["speed"].toString();
-
-        // Handle null values
-        building.powerKw = obj["power_kw"].isNull() ? 0 : obj["power_kw"].toDouble();
-        building.generatedKw = obj["generated_kw"].isNull() ? 0 : obj["generated_kw"].toDouble();
-        building.capacity = obj["capacity"].isNull() ? 0 : obj["capacity"].toDouble();
-        building.connections = obj["connections"].isNull() ? 0 : obj["connections"].toInt();
-        building.price = obj["price"].isNull() ? 0 : obj["price"].toDouble();
-
-        if (building.name.isEmpty()) {
-            skipped++;
-            continue;
-        }
-
-        // Check if already exists
-        auto existing = m_database->getFactoryBuildingByName(building.name);
-        if (existing.has_value()) {
-            // Update existing
-            building.id = existing->id;
-            m_database->updateFactoryBuilding(building);
-        } else {
-            // Add new
-            m_database->addFactoryBuilding(building);
-        }
-        imported++;
-    }
-
     refreshData();
 
     QMessageBox::information(this, tr("Import Complete"),
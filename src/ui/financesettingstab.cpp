@@ -5,6 +5,7 @@
 
 #include "financesettingstab.h"
 #include "core/database.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -140,6 +141,7 @@ void FinanceSettingsTab::setupUi()
 
 void FinanceSettingsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("FinanceSettingsTab::refreshData");
     loadSettings();
 }
 
@@ -52,12 +52,8 @@ void FinanceWidget::setupUi()
     m_settingsTab = new FinanceSettingsTab(m_database, this);
     m_subTabs->addTab(m_settingsTab, tr("Settings"));
 
-    // Connect signals for cross-tab updates
-    connect(m_ledgerTab, &LedgerTab::balancesChanged, m_accountsTab, &AccountsTab::refreshData);
-    connect(m_ledgerTab, &LedgerTab::transactionChanged, m_summaryTab, &SummaryTab::refreshData);
-    connect(m_ledgerTab, &LedgerTab::transactionChanged, m_budgetsTab, &BudgetsTab::refreshData);
-    connect(m_ledgerTab, &LedgerTab::balancesChanged, m_capitalPlannerTab, &CapitalPlannerWidget::refreshData);
-    connect(m_accountsTab, &AccountsTab::transferCompleted, m_ledgerTab, &LedgerTab::refreshData);
+    // Cross-tab updates come from the database's change bus: each subtab
+    // subscribes to the tables it shows and refreshes once when next visible
 
     mainLayout->addWidget(m_subTabs);
 }
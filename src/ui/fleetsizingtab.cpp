@@ -0,0 +1,218 @@
+/**
+ * @file fleetsizingtab.cpp
+ * @brief Fleet Sizing implementation
+ */
+
+#include "fleetsizingtab.h"
+#include "core/database.h"
+#include "core/unitconverter.h"
+#include "core/tracing.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QElapsedTimer>
+
+namespace {
+
+enum Column {
+    RouteColumn,
+    LoaderColumn,
+    TruckColumn,
+    TrucksColumn,
+    RateColumn,
+    MatchColumn,
+    LoaderUseColumn,
+    CycleColumn,
+    CostColumn,
+    ColumnCount
+};
+
+QTableWidgetItem *numberItem(const QString &text)
+{
+    auto *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+} // namespace
+
+FleetSizingTab::FleetSizingTab(Frontier::OperationsManager *manager, QWidget *parent)
+    : QWidget(parent)
+    , m_manager(manager)
+{
+    setupUi();
+
+    // Settings edits re-run the sweep; profile and vehicle edits recompile
+    connect(m_manager, &Frontier::OperationsManager::cycleTimesChanged, this, &FleetSizingTab::updatePlans);
+    connect(m_manager, &Frontier::OperationsManager::unitSystemChanged, this, &FleetSizingTab::updatePlans);
+    m_manager->database()->changeBus().subscribe(this,
+        Frontier::DataTable::CycleTimes | Frontier::DataTable::Vehicles,
+        [this]() { refreshData(); }, true);
+}
+
+void FleetSizingTab::setupUi()
+{
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+    mainLayout->setSpacing(10);
+
+    // =========================================================================
+    // Options
+    // =========================================================================
+    auto *optionsGroup = new QGroupBox(tr("Sizing Options"));
+    auto *optionsLayout = new QHBoxLayout(optionsGroup);
+
+    optionsLayout->addWidget(new QLabel(tr("Cycle:")));
+    m_basisCombo = new QComboBox();
+    m_basisCombo->addItem(tr("Average"), static_cast<int>(Frontier::CycleBasis::Average));
+    m_basisCombo->addItem(tr("Median"), static_cast<int>(Frontier::CycleBasis::Median));
+    m_basisCombo->addItem(tr("90th Percentile"), static_cast<int>(Frontier::CycleBasis::P90));
+    m_basisCombo->setToolTip(tr("Which timed cycle each route is sized for"));
+    optionsLayout->addWidget(m_basisCombo);
+
+    optionsLayout->addWidget(new QLabel(tr("Loader:")));
+    m_loaderCombo = new QComboBox();
+    m_loaderCombo->setMinimumWidth(180);
+    optionsLayout->addWidget(m_loaderCombo);
+
+    optionsLayout->addWidget(new QLabel(tr("Max Trucks:")));
+    m_maxTrucksSpin = new QSpinBox();
+    m_maxTrucksSpin->setRange(1, 100);
+    m_maxTrucksSpin->setValue(12);
+    optionsLayout->addWidget(m_maxTrucksSpin);
+
+    optionsLayout->addWidget(new QLabel(tr("Fill:")));
+    m_fillSpin = new QDoubleSpinBox();
+    m_fillSpin->setRange(10, 120);
+    m_fillSpin->setDecimals(0);
+    m_fillSpin->setValue(100);
+    m_fillSpin->setSuffix(" %");
+    m_fillSpin->setToolTip(tr("Share of each truck's rated volume actually carried"));
+    optionsLayout->addWidget(m_fillSpin);
+
+    optionsLayout->addStretch();
+    mainLayout->addWidget(optionsGroup);
+
+    connect(m_basisCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FleetSizingTab::updatePlans);
+    connect(m_loaderCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FleetSizingTab::updatePlans);
+    connect(m_maxTrucksSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &FleetSizingTab::updatePlans);
+    connect(m_fillSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &FleetSizingTab::updatePlans);
+
+    // =========================================================================
+    // Results
+    // =========================================================================
+    auto *resultsGroup = new QGroupBox(tr("Best Fleet per Route and Loader"));
+    auto *resultsLayout = new QVBoxLayout(resultsGroup);
+
+    m_table = new QTableWidget();
+    m_table->setColumnCount(ColumnCount);
+    m_table->setHorizontalHeaderLabels({
+        tr("Route"), tr("Loader"), tr("Truck"), tr("Trucks"), tr("Rate / hr"),
+        tr("Match"), tr("Loader Busy"), tr("Truck Cycle"), tr("Cost / Unit")
+    });
+    m_table->setAlternatingRowColors(true);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->horizontalHeader()->setSectionResizeMode(RouteColumn, QHeaderView::Stretch);
+    resultsLayout->addWidget(m_table);
+
+    m_summaryLabel = new QLabel();
+    m_summaryLabel->setStyleSheet("color: gray;");
+    m_summaryLabel->setWordWrap(true);
+    resultsLayout->addWidget(m_summaryLabel);
+
+    mainLayout->addWidget(resultsGroup, 1);
+}
+
+void FleetSizingTab::refreshData()
+{
+    FRONTIER_TRACE_SCOPE("FleetSizingTab::refreshData");
+    m_sizer.compile(m_manager->database()->getCycleProfilesWithStats(), m_manager->getActiveVehicles());
+
+    const QString selected = m_loaderCombo->currentData().toString();
+    m_loaderCombo->blockSignals(true);
+    m_loaderCombo->clear();
+    m_loaderCombo->addItem(tr("-- Any --"), QString());
+    for (const Frontier::Vehicle &vehicle : m_manager->getActiveVehicles()) {
+        if (vehicle.bucketCapacityM3 > 0) {
+            m_loaderCombo->addItem(vehicle.name, vehicle.id);
+        }
+    }
+    m_loaderCombo->setCurrentIndex(qMax(0, m_loaderCombo->findData(selected)));
+    m_loaderCombo->blockSignals(false);
+
+    updatePlans();
+}
+
+Frontier::FleetOptions FleetSizingTab::currentOptions() const
+{
+    Frontier::FleetOptions options;
+    options.basis = static_cast<Frontier::CycleBasis>(m_basisCombo->currentData().toInt());
+    options.maxTrucks = m_maxTrucksSpin->value();
+    options.fillFactor = m_fillSpin->value() / 100.0;
+    options.loaderPassSeconds = m_manager->loaderCycleTimeMinutes() * 60.0;
+    options.truckCycleSeconds = m_manager->truckCycleTimeMinutes() * 60.0;
+    options.fuelPricePerLiter = m_manager->fuelPricePerLiter();
+    options.loaderId = m_loaderCombo->currentData().toString();
+    return options;
+}
+
+void FleetSizingTab::updatePlans()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const Frontier::FleetOptions options = currentOptions();
+    const QVector<Frontier::FleetPlan> plans = m_sizer.optimize(options);
+    const qint64 sweepUs = timer.nsecsElapsed() / 1000;
+
+    const Frontier::UnitSystem units = m_manager->unitSystem();
+    const QString volumeUnit = Frontier::UnitConverter::volumeUnitLabel(units);
+
+    m_table->setUpdatesEnabled(false);
+    m_table->setRowCount(plans.size());
+    for (int row = 0; row < plans.size(); ++row) {
+        const Frontier::FleetPlan &plan = plans[row];
+        const double rate = Frontier::UnitConverter::volumeToDisplay(plan.m3PerHour, units);
+        const double perUnit = Frontier::UnitConverter::volumeToDisplay(1.0, units);
+
+        m_table->setItem(row, RouteColumn, new QTableWidgetItem(plan.routeName));
+        m_table->setItem(row, LoaderColumn, new QTableWidgetItem(plan.loaderName));
+        m_table->setItem(row, TruckColumn, new QTableWidgetItem(plan.truckName));
+
+        auto *trucksItem = numberItem(QString::number(plan.trucks));
+        trucksItem->setToolTip(tr("%1 passes per load; %2 trucks keep the loader busy")
+                                   .arg(plan.passes).arg(plan.saturatingTrucks));
+        m_table->setItem(row, TrucksColumn, trucksItem);
+
+        m_table->setItem(row, RateColumn, numberItem(QString("%1 %2").arg(rate, 0, 'f', 1).arg(volumeUnit)));
+        m_table->setItem(row, MatchColumn, numberItem(QString::number(plan.matchFactor, 'f', 2)));
+        m_table->setItem(row, LoaderUseColumn,
+                         numberItem(QString("%1%").arg(plan.loaderUtilisation() * 100.0, 0, 'f', 0)));
+        m_table->setItem(row, CycleColumn,
+                         numberItem(QString("%1:%2").arg(int(plan.cycleSeconds) / 60)
+                                        .arg(int(plan.cycleSeconds) % 60, 2, 10, QChar('0'))));
+        m_table->setItem(row, CostColumn, numberItem(options.fuelPricePerLiter > 0
+            ? QString("$%1").arg(plan.costPerM3 / perUnit, 0, 'f', 3)
+            : QString::number(plan.costPerM3 / perUnit, 'f', 3)));
+    }
+    m_table->setUpdatesEnabled(true);
+
+    const qint64 combinations = qint64(m_sizer.routeCount())
+                                * (options.loaderId.isEmpty() ? m_sizer.loaderCount() : 1)
+                                * m_sizer.truckCount() * options.maxTrucks;
+    if (m_sizer.routeCount() == 0 || m_sizer.loaderCount() == 0 || m_sizer.truckCount() == 0) {
+        m_summaryLabel->setText(tr("Needs at least one cycle profile, one active vehicle with a bucket "
+                                   "capacity and one with a truck capacity."));
+    } else {
+        m_summaryLabel->setText(
+            tr("Up to %L1 fleets compared in %L2 µs. Cost is %3 per %4; routes tied to a "
+               "truck in their profile are only sized with that truck.")
+                .arg(combinations).arg(sweepUs)
+                .arg(options.fuelPricePerLiter > 0 ? tr("fuel") : tr("vehicles used"))
+                .arg(volumeUnit));
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * @file fleetsizingtab.h
+ * @brief Fleet Sizing - trucks per loader and haul rate for each route
+ */
+
+#ifndef FLEETSIZINGTAB_H
+#define FLEETSIZINGTAB_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+
+#include "core/fleetsizer.h"
+#include "core/operationsmanager.h"
+
+class FleetSizingTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FleetSizingTab(Frontier::OperationsManager *manager, QWidget *parent = nullptr);
+
+public slots:
+    void refreshData();
+
+private slots:
+    void updatePlans();
+
+private:
+    void setupUi();
+    Frontier::FleetOptions currentOptions() const;
+
+    Frontier::OperationsManager *m_manager;
+
+    // Profiles and vehicles, compiled on refresh; option changes only re-sweep
+    Frontier::FleetSizer m_sizer;
+
+    // Options
+    QComboBox *m_basisCombo;
+    QComboBox *m_loaderCombo;
+    QSpinBox *m_maxTrucksSpin;
+    QDoubleSpinBox *m_fillSpin;
+
+    // Results
+    QTableWidget *m_table;
+    QLabel *m_summaryLabel;
+};
+
+#endif // FLEETSIZINGTAB_H
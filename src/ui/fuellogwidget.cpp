@@ -19,12 +19,13 @@ FuelLogWidget::FuelLogWidget(Frontier::OperationsManager *manager, QWidget *pare
     setupUi();
     loadEquipmentFilter();
     loadFuelLog();
+    loadEfficiency();
 
     // Connect to manager signals
     connect(m_manager, &Frontier::OperationsManager::unitSystemChanged,
             this, &FuelLogWidget::onUnitSystemChanged);
-    connect(m_manager, &Frontier::OperationsManager::fuelLogUpdated,
-            this, &FuelLogWidget::onFuelLogUpdated);
+    connect(m_manager, &Frontier::OperationsManager::fuelLogChanged,
+            this, &FuelLogWidget::onFuelLogChanged);
 }
 
 FuelLogWidget::~FuelLogWidget()
@@ -113,6 +114,24 @@ void FuelLogWidget::setupUi()
 
     mainLayout->addWidget(summaryGroup);
 
+    // === Efficiency ===
+    QGroupBox *efficiencyGroup = new QGroupBox("Equipment Efficiency (logged hours, vs rated)");
+    QVBoxLayout *efficiencyLayout = new QVBoxLayout(efficiencyGroup);
+
+    m_efficiencyView = new QTableView();
+    m_efficiencyView->setAlternatingRowColors(true);
+    m_efficiencyView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_efficiencyView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_efficiencyView->horizontalHeader()->setStretchLastSection(true);
+    m_efficiencyView->verticalHeader()->setVisible(false);
+    m_efficiencyView->setMaximumHeight(180);
+
+    m_efficiencyModel = new QStandardItemModel(this);
+    m_efficiencyView->setModel(m_efficiencyModel);
+    efficiencyLayout->addWidget(m_efficiencyView);
+
+    mainLayout->addWidget(efficiencyGroup);
+
     // === Connections ===
     connect(m_refreshButton, &QPushButton::clicked,
             this, &FuelLogWidget::onRefreshClicked);
@@ -177,8 +196,8 @@ void FuelLogWidget::loadFuelLog()
 
         // Equipment name (lookup)
         QString equipName = entry.equipmentId;
-        auto vehicle = m_manager->getVehicle(entry.equipmentId);
-        if (vehicle.has_value()) {
+        const Frontier::Vehicle *vehicle = m_manager->findVehicle(entry.equipmentId);
+        if (vehicle) {
             equipName = vehicle->name;
         }
         row << new QStandardItem(equipName);
@@ -251,9 +270,65 @@ void FuelLogWidget::updateSummary()
     m_totalCostLabel->setText(QString("Total Cost: $%1").arg(totalCost, 0, 'f', 0));
 }
 
+void FuelLogWidget::loadEfficiency()
+{
+    using UC = Frontier::UnitConverter;
+    Frontier::UnitSystem units = m_manager->unitSystem();
+
+    m_efficiencyModel->clear();
+    m_efficiencyModel->setHorizontalHeaderLabels({
+        "Equipment", "Rated", "Last 7 Days", "Last 30 Days", "vs Rated", "Lifetime", "Status"
+    });
+
+    // Served from the running windows; no fuel log scan
+    auto rate = [&](const Frontier::FuelWindow &window) {
+        QStandardItem *item = new QStandardItem(
+            window.hours > 0 ? UC::formatFuelRate(window.litersPerHour(), units) : "-");
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        item->setToolTip(QString("%1 h logged over %2 entries").arg(window.hours, 0, 'f', 1).arg(window.entries));
+        return item;
+    };
+
+    for (const Frontier::EquipmentEfficiency &efficiency : m_manager->getFleetFuelEfficiency()) {
+        QList<QStandardItem*> row;
+
+        const Frontier::Vehicle *vehicle = m_manager->findVehicle(efficiency.equipmentId);
+        row << new QStandardItem(vehicle ? vehicle->name : efficiency.equipmentId);
+
+        QStandardItem *ratedItem = new QStandardItem(
+            efficiency.specLPerHour > 0 ? UC::formatFuelRate(efficiency.specLPerHour, units) : "-");
+        ratedItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        row << ratedItem;
+
+        row << rate(efficiency.last7) << rate(efficiency.last30);
+
+        const bool compared = efficiency.specLPerHour > 0 && efficiency.last30.hours > 0;
+        QStandardItem *deviationItem = new QStandardItem(
+            compared ? QString("%1%2%").arg(efficiency.deviationPercent() >= 0 ? "+" : "")
+                                       .arg(efficiency.deviationPercent(), 0, 'f', 0)
+                     : "-");
+        deviationItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        row << deviationItem;
+
+        row << rate(efficiency.lifetime);
+
+        const bool flagged = efficiency.anomalies.toInt() != 0;
+        QStandardItem *statusItem = new QStandardItem(flagged ? efficiency.anomalyText() : "OK");
+        if (flagged) {
+            statusItem->setForeground(Qt::red);
+        }
+        row << statusItem;
+
+        m_efficiencyModel->appendRow(row);
+    }
+
+    m_efficiencyView->resizeColumnsToContents();
+}
+
 void FuelLogWidget::onRefreshClicked()
 {
     loadFuelLog();
+    loadEfficiency();
 }
 
 void FuelLogWidget::onFilterChanged()
@@ -265,11 +340,19 @@ void FuelLogWidget::onUnitSystemChanged(Frontier::UnitSystem system)
 {
     Q_UNUSED(system);
     loadFuelLog();
+    loadEfficiency();
 }
 
-void FuelLogWidget::onFuelLogUpdated(const Frontier::FuelLogEntry &entry)
+void FuelLogWidget::onFuelLogChanged(const QDateTime &from, const QDateTime &to)
 {
-    Q_UNUSED(entry);
-    // Reload the log when a new entry is added
+    // The windows end today whatever range is shown
+    loadEfficiency();
+
+    // Reload once per write batch, and only if it touches the visible range
+    QDateTime shownFrom(m_fromDateEdit->date(), QTime(0, 0, 0));
+    QDateTime shownTo(m_toDateEdit->date(), QTime(23, 59, 59));
+    if (to < shownFrom || from > shownTo) {
+        return;
+    }
     loadFuelLog();
 }
@@ -28,13 +28,14 @@ private slots:
     void onRefreshClicked();
     void onFilterChanged();
     void onUnitSystemChanged(Frontier::UnitSystem system);
-    void onFuelLogUpdated(const Frontier::FuelLogEntry &entry);
+    void onFuelLogChanged(const QDateTime &from, const QDateTime &to);
 
 private:
     void setupUi();
     void loadEquipmentFilter();
     void loadFuelLog();
     void updateSummary();
+    void loadEfficiency();
 
     Frontier::OperationsManager *m_manager;
 
@@ -52,6 +53,10 @@ private:
     QLabel *m_totalFuelLabel;
     QLabel *m_totalCostLabel;
     QLabel *m_entryCountLabel;
+
+    // Efficiency per equipment, independent of the filters
+    QTableView *m_efficiencyView;
+    QStandardItemModel *m_efficiencyModel;
 };
 
 #endif // FUELLOGWIDGET_H
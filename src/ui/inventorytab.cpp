@@ -5,6 +5,13 @@
 
 #include "inventorytab.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/inventorycache.h"
+#include "core/symboltable.h"
+#include "core/inventoryledgersync.h"
+#include "core/commandjournal.h"
+#include "columntablemodel.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -28,8 +35,28 @@
 InventoryTab::InventoryTab(Frontier::Database *database, QWidget *parent)
     : QWidget(parent)
     , m_database(database)
+    , m_inventory(new Frontier::InventoryCache(database, this))
 {
+    connect(m_inventory, &Frontier::InventoryCache::reloaded,
+            this, &InventoryTab::onInventoryReloaded);
+    connect(m_inventory, &Frontier::InventoryCache::rowChanged,
+            this, &InventoryTab::onInventoryRowChanged);
+    connect(m_inventory, &Frontier::InventoryCache::rowInserted,
+            this, &InventoryTab::onInventoryRowChanged);
+
+    // An undone or redone stock change patches its row, not the whole table
+    connect(&m_database->journal(), &Frontier::CommandJournal::applied, this,
+            [this](const Frontier::JournalChange &change) {
+                if (change.table == Frontier::JournalChange::Inventory
+                    && change.kind == Frontier::JournalChange::Updated) {
+                    m_inventory->refreshRow(change.rowId);
+                }
+            });
+
     setupUi();
+    m_database->changeBus().subscribe(this,
+        Frontier::DataTable::Inventory | Frontier::DataTable::Items | Frontier::DataTable::Locations,
+        [this]() { loadInventory(); });
     refreshData();
 }
 
@@ -53,12 +80,10 @@ void InventoryTab::setupUi()
     auto *tableLayout = new QVBoxLayout(tableWidget);
     tableLayout->setContentsMargins(0, 0, 0, 0);
 
-    m_table = new QTableWidget();
-    m_table->setColumnCount(7);
-    m_table->setHorizontalHeaderLabels({
-        tr("Item Name"), tr("Category"), tr("Location"),
-        tr("Quantity"), tr("Unit Price"), tr("Total Value"), tr("Status")
-    });
+    setupTableModel();
+
+    m_table = new QTableView();
+    m_table->setModel(m_proxy);
     m_table->setAlternatingRowColors(true);
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_table->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -68,11 +93,11 @@ void InventoryTab::setupUi()
 
     auto *header = m_table->horizontalHeader();
     header->setSectionResizeMode(0, QHeaderView::Stretch);
-    for (int i = 1; i < 7; ++i) {
+    for (int i = 1; i < m_model->columnCount(); ++i) {
         header->setSectionResizeMode(i, QHeaderView::ResizeToContents);
     }
 
-    connect(m_table, &QTableWidget::itemSelectionChanged,
+    connect(m_table->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &InventoryTab::onSelectionChanged);
 
     tableLayout->addWidget(m_table);
@@ -102,7 +127,7 @@ void InventoryTab::setupUi()
     btnLayout->addStretch();
 
     m_syncBtn = new QPushButton(tr("Sync from Ledger"));
-    m_syncBtn->setToolTip(tr("Scan Ledger transactions and update inventory quantities"));
+    m_syncBtn->setToolTip(tr("Apply Ledger sales and purchases recorded since the last sync"));
     m_syncBtn->setStyleSheet("background-color: #e3f2fd;");
     connect(m_syncBtn, &QPushButton::clicked, this, &InventoryTab::onSyncFromLedger);
     btnLayout->addWidget(m_syncBtn);
@@ -120,6 +145,40 @@ void InventoryTab::setupUi()
     mainLayout->addWidget(createOilTracker());
 }
 
+void InventoryTab::setupTableModel()
+{
+    using Frontier::InventoryItem;
+
+    m_model = new ColumnTableModel<InventoryItem>(this);
+    m_model->addColumn(tr("Item Name"), ColumnFormat::Text,
+                       [](const InventoryItem &item) { return item.itemName; });
+    m_model->addColumn(tr("Category"), ColumnFormat::Text,
+                       [](const InventoryItem &item) { return item.category; });
+    m_model->addColumn(tr("Location"), ColumnFormat::Text,
+                       [](const InventoryItem &item) { return item.locationName; });
+    m_model->addColumn(tr("Quantity"), ColumnFormat::Integer,
+                       [](const InventoryItem &item) { return item.quantity; });
+    m_model->addColumn(tr("Unit Price"), ColumnFormat::Currency,
+                       [](const InventoryItem &item) { return item.unitPrice; });
+    m_model->addColumn(tr("Total Value"), ColumnFormat::WholeCurrency,
+                       [](const InventoryItem &item) { return item.totalValue(); });
+    const int statusColumn = m_model->addColumn(tr("Status"), ColumnFormat::Integer,
+                       [](const InventoryItem &item) { return item.quantity; });
+    m_model->setColumnText(statusColumn, [this](const InventoryItem &item) {
+        return getStockStatus(item.quantity);
+    });
+    m_model->setCellStyle(statusColumn, [](const InventoryItem &, int role) {
+        return role == Qt::TextAlignmentRole ? QVariant(Qt::AlignCenter) : QVariant();
+    });
+    m_model->setRowStyle([this](const InventoryItem &item, int role) {
+        return role == Qt::BackgroundRole ? QVariant(getStatusColor(getStockStatus(item.quantity)))
+                                          : QVariant();
+    });
+    m_model->setRowId([](const InventoryItem &item) { return item.id.value_or(0); });
+
+    m_proxy = new ColumnSortProxy(m_model, this);
+}
+
 QWidget* InventoryTab::createSummaryPanel()
 {
     auto *group = new QGroupBox(tr("Inventory Summary"));
@@ -342,6 +401,7 @@ QWidget* InventoryTab::createOilTracker()
 
 void InventoryTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("InventoryTab::refreshData");
     // Load oil tracking first
     m_oilTracking = m_database->getOilTracking();
     m_oilCapSpin->blockSignals(true);
@@ -387,107 +447,92 @@ void InventoryTab::refreshData()
 
 void InventoryTab::loadInventory()
 {
-    m_allItems = m_database->getAllInventory();
+    m_database->changeBus().acknowledge(this);
+    m_inventory->reload();
+}
+
+void InventoryTab::onInventoryReloaded()
+{
+    m_model->setRows(m_inventory->items());
     applyFilters();
     updateSummary();
     updateOilTracker();
 }
 
+void InventoryTab::onInventoryRowChanged(int row)
+{
+    // Only this row changed, so patch it; the proxy re-filters and re-sorts it
+    m_database->changeBus().acknowledge(this);
+    const auto &item = m_inventory->items()[row];
+    if (row < m_model->rows().size()) {
+        m_model->setRow(row, item);
+    } else {
+        m_model->insertRowAt(row, item);
+    }
+    updateSummary();
+    if (item.itemName == "Oil") {
+        updateOilTracker();
+    }
+    updateDetails();
+
+    emit itemQuantityChanged(item.itemName, item.quantity);
+}
+
 void InventoryTab::applyFilters()
 {
-    QString searchText = m_searchEdit->text().toLower();
+    const QString searchText = m_searchEdit->text().trimmed();
     QString categoryFilter = m_categoryCombo->currentText();
     QString locationFilter = m_locationCombo->currentText();
     QString statusFilter = m_statusCombo->currentText();
     bool showZero = m_showZeroCheck->isChecked();
 
-    m_filteredItems.clear();
-
-    for (const auto &item : m_allItems) {
-        // Search filter
-        if (!searchText.isEmpty() && !item.itemName.toLower().contains(searchText)) {
-            continue;
+    // Resolve the combo texts once; rows are then matched by symbol
+    Frontier::SymbolTable &symbols = Frontier::SymbolTable::instance();
+    const bool byCategory = categoryFilter != tr("All Categories");
+    const bool byLocation = locationFilter != tr("All Locations");
+    const bool byStatus = statusFilter != tr("All");
+    const Frontier::Symbol categorySymbol = byCategory ? symbols.find(categoryFilter) : 0;
+    const Frontier::Symbol locationSymbol = byLocation ? symbols.find(locationFilter) : 0;
+
+    // The search resolves to item ids once, through the item index
+    const bool bySearch = !searchText.isEmpty();
+    QSet<int> searchMatches;
+    if (bySearch) {
+        for (const Frontier::SearchHit &hit : m_database->search(searchText, Frontier::DataTable::Items, -1)) {
+            searchMatches.insert(hit.id);
         }
+    }
 
-        // Category filter
-        if (categoryFilter != tr("All Categories") && item.category != categoryFilter) {
-            continue;
+    m_model->setFilter([=](const Frontier::InventoryItem &item) {
+        if (bySearch && !searchMatches.contains(item.itemId)) {
+            return false;
         }
-
-        // Location filter
-        if (locationFilter != tr("All Locations") && item.locationName != locationFilter) {
-            continue;
+        if (byCategory && item.categorySymbol != categorySymbol) {
+            return false;
         }
-
-        // Status filter
-        QString status = getStockStatus(item.quantity);
-        if (statusFilter != tr("All") && status != statusFilter) {
-            continue;
+        if (byLocation && item.locationSymbol != locationSymbol) {
+            return false;
         }
-
-        // Zero stock filter
-        if (!showZero && item.quantity == 0) {
-            continue;
+        if (byStatus && getStockStatus(item.quantity) != statusFilter) {
+            return false;
         }
-
-        m_filteredItems.append(item);
-    }
-
-    populateTable();
+        // Zero stock filter
+        return showZero || item.quantity != 0;
+    });
 }
 
-void InventoryTab::populateTable()
+const Frontier::InventoryItem *InventoryTab::selectedItem() const
 {
-    m_table->setSortingEnabled(false);
-    m_table->setRowCount(m_filteredItems.size());
-
-    for (int row = 0; row < m_filteredItems.size(); ++row) {
-        const auto &item = m_filteredItems[row];
-
-        // Item Name
-        auto *nameItem = new QTableWidgetItem(item.itemName);
-        nameItem->setData(Qt::UserRole, item.id.value_or(0));
-        m_table->setItem(row, 0, nameItem);
-
-        // Category
-        m_table->setItem(row, 1, new QTableWidgetItem(item.category));
-
-        // Location
-        m_table->setItem(row, 2, new QTableWidgetItem(item.locationName));
-
-        // Quantity
-        auto *qtyItem = new QTableWidgetItem(QString("%L1").arg(item.quantity));
-        qtyItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        qtyItem->setData(Qt::UserRole, item.quantity);
-        m_table->setItem(row, 3, qtyItem);
-
-        // Unit Price
-        auto *priceItem = new QTableWidgetItem(QString("$%L1").arg(item.unitPrice, 0, 'f', 2));
-        priceItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_table->setItem(row, 4, priceItem);
-
-        // Total Value
-        auto *totalItem = new QTableWidgetItem(QString("$%L1").arg(item.totalValue(), 0, 'f', 0));
-        totalItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        totalItem->setData(Qt::UserRole, item.totalValue());
-        m_table->setItem(row, 5, totalItem);
-
-        // Status
-        QString status = getStockStatus(item.quantity);
-        auto *statusItem = new QTableWidgetItem(status);
-        statusItem->setTextAlignment(Qt::AlignCenter);
-        m_table->setItem(row, 6, statusItem);
-
-        // Row color
-        QColor color = getStatusColor(status);
-        for (int col = 0; col < 7; ++col) {
-            if (auto *tableItem = m_table->item(row, col)) {
-                tableItem->setBackground(color);
-            }
-        }
+    const QModelIndexList selected = m_table->selectionModel()->selectedRows();
+    if (selected.isEmpty()) {
+        return nullptr;
     }
 
-    m_table->setSortingEnabled(true);
+    const int row = m_proxy->sourceRow(selected.first());
+    if (row < 0 || row >= m_model->rows().size()) {
+        return nullptr;
+    }
+    return &m_model->rowAt(row);
 }
 
 QString InventoryTab::getStockStatus(int quantity) const
@@ -514,7 +559,7 @@ void InventoryTab::updateSummary()
     QSet<QString> activeLocations;
     int lowStockCount = 0;
 
-    for (const auto &item : m_allItems) {
+    for (const auto &item : m_inventory->items()) {
         totalValue += item.totalValue();
 
         if (item.quantity > 0) {
@@ -543,14 +588,7 @@ void InventoryTab::updateSummary()
 
 void InventoryTab::updateOilTracker()
 {
-    // Find oil inventory
-    int oilInventory = 0;
-    for (const auto &item : m_allItems) {
-        if (item.itemName == "Oil") {
-            oilInventory = item.quantity;
-            break;
-        }
-    }
+    int oilInventory = m_inventory->quantityOf("Oil");
 
     int remaining = m_oilTracking.remaining();
     double pctUsed = m_oilTracking.percentUsed();
@@ -566,8 +604,8 @@ void InventoryTab::updateOilTracker()
 
     // Get oil price from items
     double oilPrice = 67.00;  // Default
-    auto oilItem = m_database->getItemByName("Oil");
-    if (oilItem.has_value()) {
+    const Frontier::Item *oilItem = m_database->itemCatalog().findByName("Oil");
+    if (oilItem) {
         oilPrice = oilItem->sellPriceDisplay;
     }
 
@@ -594,18 +632,13 @@ void InventoryTab::updateOilTracker()
 
 void InventoryTab::updateDetails()
 {
-    auto selected = m_table->selectedItems();
-    if (selected.isEmpty()) {
+    const Frontier::InventoryItem *selected = selectedItem();
+    if (!selected) {
         m_detailsText->setHtml("<p style='color: #666;'>Select an item to view details</p>");
         return;
     }
 
-    int row = selected.first()->row();
-    if (row < 0 || row >= m_filteredItems.size()) {
-        return;
-    }
-
-    const auto &item = m_filteredItems[row];
+    const Frontier::InventoryItem item = *selected;
     QString status = getStockStatus(item.quantity);
 
     double gross = item.totalValue();
@@ -686,7 +719,7 @@ void InventoryTab::onFilterChanged()
 
 void InventoryTab::onSelectionChanged()
 {
-    bool hasSelection = !m_table->selectedItems().isEmpty();
+    bool hasSelection = m_table->selectionModel()->hasSelection();
     m_editBtn->setEnabled(hasSelection);
     m_adjustBtn->setEnabled(hasSelection);
     m_deleteBtn->setEnabled(hasSelection);
@@ -697,6 +730,7 @@ void InventoryTab::onOilCapChanged(int value)
 {
     m_oilTracking.oilCap = value;
     m_database->saveOilTracking(m_oilTracking);
+    m_database->changeBus().acknowledge(this);
     updateSummary();
     updateOilTracker();
     emit dataChanged();
@@ -709,6 +743,7 @@ void InventoryTab::onResetOilCounter()
 
     if (result == QMessageBox::Yes) {
         m_database->resetOilTracking();
+        m_database->changeBus().acknowledge(this);
         m_oilTracking = m_database->getOilTracking();
         updateSummary();
         updateOilTracker();
@@ -777,13 +812,10 @@ void InventoryTab::onAddItem()
 
 void InventoryTab::onEditItem()
 {
-    auto selected = m_table->selectedItems();
-    if (selected.isEmpty()) return;
-
-    int row = selected.first()->row();
-    if (row < 0 || row >= m_filteredItems.size()) return;
+    const Frontier::InventoryItem *selected = selectedItem();
+    if (!selected) return;
 
-    auto item = m_filteredItems[row];
+    auto item = *selected;
 
     // Get locations for selection
     auto locations = m_database->getAllLocations();
@@ -821,13 +853,10 @@ void InventoryTab::onEditItem()
 
 void InventoryTab::onAdjustQuantity()
 {
-    auto selected = m_table->selectedItems();
-    if (selected.isEmpty()) return;
+    const Frontier::InventoryItem *selected = selectedItem();
+    if (!selected) return;
 
-    int row = selected.first()->row();
-    if (row < 0 || row >= m_filteredItems.size()) return;
-
-    const auto &item = m_filteredItems[row];
+    const Frontier::InventoryItem item = *selected;
 
     // Create adjustment dialog
     QDialog dialog(this);
@@ -931,22 +960,18 @@ void InventoryTab::onAdjustQuantity()
         m_oilTracking = m_database->getOilTracking();
     }
 
-    // Update quantity
-    if (m_database->updateInventoryQuantity(item.id.value_or(0), newQty)) {
-        loadInventory();
+    // Through the cache: patches the row in place and journals the change
+    if (m_inventory->setQuantity(m_inventory->rowForId(item.id.value_or(0)), newQty)) {
         emit dataChanged();
     }
 }
 
 void InventoryTab::onDeleteItem()
 {
-    auto selected = m_table->selectedItems();
-    if (selected.isEmpty()) return;
+    const Frontier::InventoryItem *selected = selectedItem();
+    if (!selected) return;
 
-    int row = selected.first()->row();
-    if (row < 0 || row >= m_filteredItems.size()) return;
-
-    const auto &item = m_filteredItems[row];
+    const Frontier::InventoryItem item = *selected;
 
     auto result = QMessageBox::question(this, tr("Delete Item"),
                                         tr("Delete '%1' from inventory?").arg(item.itemName));
@@ -961,10 +986,41 @@ void InventoryTab::onDeleteItem()
 
 void InventoryTab::onSyncFromLedger()
 {
-    QMessageBox::information(this, tr("Sync from Ledger"),
-                             tr("This feature syncs inventory from Ledger transactions.\n\n"
-                                "It will be implemented when the Ledger integration is complete."));
-    // TODO: Implement when Ledger tab is available
+    Frontier::InventoryLedgerSync sync(m_database);
+
+    const int pending = sync.pendingCount();
+    if (pending == 0) {
+        QMessageBox::information(this, tr("Sync from Ledger"),
+                                 tr("Inventory is up to date with the Ledger."));
+        return;
+    }
+
+    auto answer = QMessageBox::question(this, tr("Sync from Ledger"),
+        tr("Apply %n Ledger sale(s) and purchase(s) recorded since the last sync "
+           "to inventory quantities?", nullptr, pending));
+    if (answer != QMessageBox::Yes) {
+        return;
+    }
+
+    std::optional<Frontier::InventorySyncResult> result = sync.sync();
+    if (!result) {
+        QMessageBox::warning(this, tr("Sync from Ledger"),
+                             tr("Sync failed; inventory was not changed.\n\n%1").arg(sync.lastError()));
+        return;
+    }
+
+    m_inventory->reload();
+    m_database->changeBus().acknowledge(this);
+
+    QString message = tr("Applied %1 transaction(s): %2 item(s) adjusted, %3 added to inventory.")
+                          .arg(result->transactionsApplied)
+                          .arg(result->itemsAdjusted)
+                          .arg(result->rowsCreated);
+    if (!result->unknownItems.isEmpty()) {
+        message += "\n\n" + tr("Skipped entries for unknown items: %1")
+                                .arg(result->unknownItems.join(", "));
+    }
+    QMessageBox::information(this, tr("Sync from Ledger"), message);
 }
 
 // =============================================================================
@@ -973,53 +1029,25 @@ void InventoryTab::onSyncFromLedger()
 
 bool InventoryTab::adjustItemQuantity(const QString &itemName, int delta, bool trackOil)
 {
-    auto invItem = m_database->getInventoryByItemName(itemName);
-    if (!invItem.has_value()) {
+    if (!m_inventory->findByItemName(itemName)) {
         return false;
     }
 
-    int newQty = qMax(0, invItem->quantity + delta);
-
     // Track oil sales
     if (trackOil && itemName == "Oil" && delta < 0) {
         m_database->addOilSold(qAbs(delta));
         m_oilTracking = m_database->getOilTracking();
     }
 
-    bool success = m_database->updateInventoryQuantity(invItem->id.value_or(0), newQty);
-    if (success) {
-        loadInventory();
-    }
-    return success;
+    return m_inventory->adjustQuantity(itemName, delta);
 }
 
 bool InventoryTab::addOrUpdateItem(int itemId, int quantity, std::optional<int> locationId)
 {
-    auto existing = m_database->getInventoryByItemId(itemId);
-    if (existing.has_value()) {
-        // Update existing
-        int newQty = existing->quantity + quantity;
-        bool success = m_database->updateInventoryQuantity(existing->id.value_or(0), newQty);
-        if (success) loadInventory();
-        return success;
-    } else {
-        // Add new
-        Frontier::InventoryItem item;
-        item.itemId = itemId;
-        item.quantity = quantity;
-        item.locationId = locationId;
-        bool success = m_database->addInventoryItem(item) > 0;
-        if (success) loadInventory();
-        return success;
-    }
+    return m_inventory->addQuantity(itemId, quantity, locationId);
 }
 
 int InventoryTab::getItemQuantity(const QString &itemName) const
 {
-    for (const auto &item : m_allItems) {
-        if (item.itemName == itemName) {
-            return item.quantity;
-        }
-    }
-    return 0;
+    return m_inventory->quantityOf(itemName);
 }
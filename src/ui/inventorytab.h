@@ -7,7 +7,7 @@
 #define INVENTORYTAB_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QComboBox>
 #include <QLineEdit>
 #include <QCheckBox>
@@ -22,8 +22,12 @@
 
 namespace Frontier {
 class Database;
+class InventoryCache;
 }
 
+template<typename Row> class ColumnTableModel;
+class ColumnSortProxy;
+
 class InventoryTab : public QWidget
 {
     Q_OBJECT
@@ -41,6 +45,7 @@ public slots:
 
 signals:
     void dataChanged();
+    void itemQuantityChanged(const QString &itemName, int quantity);
 
 private slots:
     // Table actions
@@ -60,6 +65,10 @@ private slots:
     // Sync from ledger
     void onSyncFromLedger();
 
+    // Inventory cache
+    void onInventoryReloaded();
+    void onInventoryRowChanged(int row);
+
 private:
     void setupUi();
     QWidget* createSummaryPanel();
@@ -69,20 +78,22 @@ private:
     QFrame* createSeparator();
 
     void loadInventory();
+    void setupTableModel();
     void applyFilters();
-    void populateTable();
     void updateSummary();
     void updateOilTracker();
     void updateDetails();
 
+    // Selected row in the cache; nullptr when none
+    const Frontier::InventoryItem *selectedItem() const;
+
     QString getStockStatus(int quantity) const;
     QColor getStatusColor(const QString &status) const;
 
     Frontier::Database *m_database;
 
     // Data
-    QVector<Frontier::InventoryItem> m_allItems;
-    QVector<Frontier::InventoryItem> m_filteredItems;
+    Frontier::InventoryCache *m_inventory;
     Frontier::OilTracking m_oilTracking;
 
     // Summary labels
@@ -99,8 +110,10 @@ private:
     QComboBox *m_statusCombo;
     QCheckBox *m_showZeroCheck;
 
-    // Table
-    QTableWidget *m_table;
+    // Table; model rows mirror the cache's rows
+    QTableView *m_table;
+    ColumnTableModel<Frontier::InventoryItem> *m_model;
+    ColumnSortProxy *m_proxy;
 
     // Buttons
     QPushButton *m_addBtn;
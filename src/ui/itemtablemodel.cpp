@@ -0,0 +1,184 @@
+/**
+ * @file itemtablemodel.cpp
+ * @brief Table model and filter proxy for the Data Hub item browser
+ */
+
+#include "itemtablemodel.h"
+#include "core/itemcatalog.h"
+
+#include <QBrush>
+
+namespace {
+QString formatPrice(double amount)
+{
+    // Fixed notation for large numbers
+    return QString("$%L1").arg(amount, 0, 'f', 0);
+}
+
+QString formatFlag(bool set)
+{
+    return set ? QStringLiteral("✓") : QStringLiteral("✗");
+}
+
+QVariant signColor(double value)
+{
+    if (value < 0) return QBrush(Qt::red);
+    if (value > 0) return QBrush(Qt::darkGreen);
+    return QVariant();
+}
+}
+
+// =============================================================================
+// ItemTableModel
+// =============================================================================
+
+ItemTableModel::ItemTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ItemTableModel::reload(const Frontier::ItemCatalog &catalog)
+{
+    beginResetModel();
+    m_items = catalog.items();
+    endResetModel();
+}
+
+int ItemTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+int ItemTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ItemTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_items.size()) {
+        return QVariant();
+    }
+
+    const Frontier::Item &item = m_items[index.row()];
+    const double margin = item.sellPriceInternal - item.buyPriceInternal;
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case NameColumn:      return item.name;
+        case CategoryColumn:  return item.displayCategory();
+        case BuyPriceColumn:  return formatPrice(item.buyPriceDisplay);
+        case SellPriceColumn: return formatPrice(item.sellPriceDisplay);
+        case MarginColumn:    return formatPrice(margin);
+        case RoiColumn:       return QString("%1%").arg(item.roiPercent(), 0, 'f', 2);
+        case CanBuyColumn:    return formatFlag(item.isPurchasable);
+        case CanSellColumn:   return formatFlag(item.isSellable);
+        case CraftableColumn: return formatFlag(item.isCraftable);
+        }
+        break;
+
+    case SortRole:
+        switch (index.column()) {
+        case BuyPriceColumn:  return item.buyPriceDisplay;
+        case SellPriceColumn: return item.sellPriceDisplay;
+        case MarginColumn:    return margin;
+        case RoiColumn:       return item.roiPercent();
+        case CanBuyColumn:    return item.isPurchasable;
+        case CanSellColumn:   return item.isSellable;
+        case CraftableColumn: return item.isCraftable;
+        default:              return data(index, Qt::DisplayRole);
+        }
+
+    case ItemIdRole:
+        return item.id.value_or(-1);
+
+    case Qt::ForegroundRole:
+        switch (index.column()) {
+        case MarginColumn:    return signColor(margin);
+        case RoiColumn:       return signColor(item.roiPercent());
+        case CanBuyColumn:    return item.isPurchasable ? QVariant() : QBrush(Qt::gray);
+        case CanSellColumn:   return item.isSellable ? QVariant() : QBrush(Qt::gray);
+        case CraftableColumn: return item.isCraftable ? QVariant() : QBrush(Qt::gray);
+        }
+        break;
+
+    case Qt::TextAlignmentRole:
+        if (index.column() >= BuyPriceColumn && index.column() <= RoiColumn) {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        if (index.column() >= CanBuyColumn) {
+            return QVariant(Qt::AlignCenter);
+        }
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant ItemTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case NameColumn:      return tr("Name");
+    case CategoryColumn:  return tr("Category");
+    case BuyPriceColumn:  return tr("Buy Price");
+    case SellPriceColumn: return tr("Sell Price");
+    case MarginColumn:    return tr("Margin");
+    case RoiColumn:       return tr("ROI %");
+    case CanBuyColumn:    return tr("Can Buy");
+    case CanSellColumn:   return tr("Can Sell");
+    case CraftableColumn: return tr("Craftable");
+    }
+    return QVariant();
+}
+
+// =============================================================================
+// ItemFilterProxyModel
+// =============================================================================
+
+ItemFilterProxyModel::ItemFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setSortRole(ItemTableModel::SortRole);
+}
+
+void ItemFilterProxyModel::setCategory(const QString &category, const Frontier::ItemCatalog &catalog)
+{
+    m_allCategories = category.isEmpty();
+    m_inCategory.fill(false, m_allCategories ? 0 : catalog.size());
+    if (!m_allCategories) {
+        for (int row : catalog.rowsInCategory(category)) {
+            m_inCategory[row] = true;
+        }
+    }
+    invalidateFilter();
+}
+
+void ItemFilterProxyModel::setSearchMatches(const std::optional<QSet<int>> &itemIds)
+{
+    if (itemIds == m_searchMatches) {
+        return;
+    }
+    m_searchMatches = itemIds;
+    invalidateFilter();
+}
+
+bool ItemFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    if (!m_allCategories && (sourceRow >= m_inCategory.size() || !m_inCategory[sourceRow])) {
+        return false;
+    }
+    if (!m_searchMatches) {
+        return true;
+    }
+
+    const auto *model = static_cast<const ItemTableModel *>(sourceModel());
+    const Frontier::Item &item = model->itemAt(sourceRow);
+    return item.id && m_searchMatches->contains(*item.id);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file itemtablemodel.h
+ * @brief Table model and filter proxy for the Data Hub item browser
+ */
+
+#ifndef ITEMTABLEMODEL_H
+#define ITEMTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include <QSet>
+#include <optional>
+
+#include "core/types.h"
+
+namespace Frontier {
+class ItemCatalog;
+}
+
+/**
+ * @brief Read-only model over the shared ItemCatalog
+ *
+ * Holds an implicitly shared copy of the catalog's item array, so a
+ * reload is one array copy and cells are formatted only when a view asks
+ * for them. Row numbers match ItemCatalog::items(), which lets the proxy
+ * use the catalog's category index directly.
+ */
+class ItemTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        CategoryColumn,
+        BuyPriceColumn,
+        SellPriceColumn,
+        MarginColumn,
+        RoiColumn,
+        CanBuyColumn,
+        CanSellColumn,
+        CraftableColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        SortRole = Qt::UserRole,
+        ItemIdRole
+    };
+
+    explicit ItemTableModel(QObject *parent = nullptr);
+
+    void reload(const Frontier::ItemCatalog &catalog);
+    const Frontier::Item &itemAt(int row) const { return m_items[row]; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<Frontier::Item> m_items;
+};
+
+/**
+ * @brief Category and search filter over ItemTableModel
+ *
+ * The category filter is a per-row flag array filled from
+ * ItemCatalog::rowsInCategory(), so switching category touches only the
+ * rows of that category plus one filter pass. The search is resolved by
+ * Database::search() into the set of matching item ids beforehand, so a
+ * keystroke costs one index query and a set lookup per row.
+ */
+class ItemFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ItemFilterProxyModel(QObject *parent = nullptr);
+
+    // Empty category shows every row
+    void setCategory(const QString &category, const Frontier::ItemCatalog &catalog);
+    // Unset shows every row
+    void setSearchMatches(const std::optional<QSet<int>> &itemIds);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    bool m_allCategories = true;
+    QVector<bool> m_inCategory;      // Indexed by source row
+    std::optional<QSet<int>> m_searchMatches;
+};
+
+#endif // ITEMTABLEMODEL_H
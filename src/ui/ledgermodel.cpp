@@ -0,0 +1,181 @@
+/**
+ * @file ledgermodel.cpp
+ * @brief Table model for the ledger view
+ */
+
+#include "ledgermodel.h"
+#include "core/database.h"
+
+#include <QColor>
+#include <QLocale>
+
+namespace {
+// Format currency with commas, no decimals: $100,000
+QString formatCurrency(double amount)
+{
+    QLocale locale(QLocale::English);
+    return "$" + locale.toString(static_cast<qint64>(qRound(amount)));
+}
+
+// Format currency with +/- prefix
+QString formatCurrencySigned(double amount, bool positive)
+{
+    QString prefix = positive ? "+" : "-";
+    QLocale locale(QLocale::English);
+    return prefix + "$" + locale.toString(static_cast<qint64>(qRound(qAbs(amount))));
+}
+
+bool isIncomeType(Frontier::TransactionType type)
+{
+    return type == Frontier::TransactionType::Sale || type == Frontier::TransactionType::Opening;
+}
+
+bool isExpenseType(Frontier::TransactionType type)
+{
+    return type == Frontier::TransactionType::Purchase || type == Frontier::TransactionType::Fuel;
+}
+
+QColor typeColor(Frontier::TransactionType type)
+{
+    switch (type) {
+    case Frontier::TransactionType::Opening:
+        return QColor("#1565c0"); // Blue
+    case Frontier::TransactionType::Sale:
+        return QColor("#2e7d32"); // Green
+    case Frontier::TransactionType::Purchase:
+    case Frontier::TransactionType::Fuel:
+        return QColor("#c62828"); // Red
+    case Frontier::TransactionType::Transfer:
+        return QColor("#7b1fa2"); // Purple
+    }
+    return QColor();
+}
+}
+
+LedgerModel::LedgerModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void LedgerModel::setTransactions(QVector<Frontier::Transaction> transactions)
+{
+    beginResetModel();
+    m_transactions = std::move(transactions);
+    endResetModel();
+}
+
+bool LedgerModel::updateTransaction(const Frontier::Transaction &transaction)
+{
+    const int row = rowOf(transaction.id.value_or(0));
+    if (row < 0) {
+        return false;
+    }
+    m_transactions[row] = transaction;
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    return true;
+}
+
+bool LedgerModel::removeTransaction(int id)
+{
+    const int row = rowOf(id);
+    if (row < 0) {
+        return false;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    m_transactions.removeAt(row);
+    endRemoveRows();
+    return true;
+}
+
+int LedgerModel::rowOf(int id) const
+{
+    for (int row = 0; row < m_transactions.size(); ++row) {
+        if (m_transactions[row].id == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+int LedgerModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_transactions.size();
+}
+
+int LedgerModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LedgerModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_transactions.size()) {
+        return QVariant();
+    }
+
+    const Frontier::Transaction &t = m_transactions[index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case DateColumn:      return t.date.toString("yyyy-MM-dd");
+        case TypeColumn:      return Frontier::transactionTypeToString(t.type);
+        case AccountColumn:   return Frontier::accountTypeToString(t.account);
+        case ItemColumn:      return t.item;
+        case CategoryColumn:  return t.category;
+        case QuantityColumn:  return QString::number(t.quantity);
+        case UnitPriceColumn: return formatCurrency(t.unitPrice);
+        case TotalColumn:     return formatCurrencySigned(t.totalAmount, isIncomeType(t.type));
+        }
+        break;
+
+    case SortRole:
+        switch (index.column()) {
+        case DateColumn:      return t.date;
+        case QuantityColumn:  return t.quantity;
+        case UnitPriceColumn: return t.unitPrice;
+        case TotalColumn:     return t.totalAmount;
+        default:              return data(index, Qt::DisplayRole);
+        }
+
+    case TransactionIdRole:
+        return t.id.value_or(0);
+
+    case Qt::ForegroundRole:
+        if (index.column() == TypeColumn) {
+            return typeColor(t.type);
+        }
+        if (index.column() == TotalColumn) {
+            if (isIncomeType(t.type)) return QColor("#2e7d32");
+            if (isExpenseType(t.type)) return QColor("#c62828");
+        }
+        break;
+
+    case Qt::TextAlignmentRole:
+        if (index.column() >= QuantityColumn) {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant LedgerModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case DateColumn:      return tr("Date");
+    case TypeColumn:      return tr("Type");
+    case AccountColumn:   return tr("Account");
+    case ItemColumn:      return tr("Item/Description");
+    case CategoryColumn:  return tr("Category");
+    case QuantityColumn:  return tr("Qty");
+    case UnitPriceColumn: return tr("Unit Price");
+    case TotalColumn:     return tr("Total");
+    }
+    return QVariant();
+}
@@ -0,0 +1,64 @@
+/**
+ * @file ledgermodel.h
+ * @brief Table model for the ledger view
+ */
+
+#ifndef LEDGERMODEL_H
+#define LEDGERMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include "core/types.h"
+
+/**
+ * @brief Read-only model over one page of transactions
+ *
+ * Holds the transactions in a flat array and formats cells only when a
+ * view asks for them, so a refresh costs one array swap rather than a
+ * heap object per cell. SortRole exposes raw values for a proxy model.
+ */
+class LedgerModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        DateColumn,
+        TypeColumn,
+        AccountColumn,
+        ItemColumn,
+        CategoryColumn,
+        QuantityColumn,
+        UnitPriceColumn,
+        TotalColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        SortRole = Qt::UserRole,
+        TransactionIdRole
+    };
+
+    explicit LedgerModel(QObject *parent = nullptr);
+
+    void setTransactions(QVector<Frontier::Transaction> transactions);
+    const Frontier::Transaction &transactionAt(int row) const { return m_transactions[row]; }
+
+    // Patch one row in place by id; false when it is not on this page
+    bool updateTransaction(const Frontier::Transaction &transaction);
+    bool removeTransaction(int id);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    int rowOf(int id) const;
+
+    QVector<Frontier::Transaction> m_transactions;
+};
+
+#endif // LEDGERMODEL_H
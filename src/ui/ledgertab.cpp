@@ -4,12 +4,16 @@
  */
 
 #include "ledgertab.h"
+#include "ledgermodel.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/databaseworker.h"
+#include "core/commandjournal.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QLocale>
 #include <cmath>
-#include <algorithm>
 
 namespace {
 // Format currency with commas, no decimals: $100,000
@@ -46,7 +50,12 @@ LedgerTab::LedgerTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
-    refreshData();
+    // First load waits until the tab is first shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Transactions,
+                                      [this]() { refreshData(); }, true);
+    m_database->changeBus().setRowPatcher(this, [this](const QVector<Frontier::RowChange> &changes) {
+        return patchRows(changes);
+    });
 }
 
 void LedgerTab::setupUi()
@@ -69,32 +78,36 @@ void LedgerTab::setupUi()
     auto *tableLayout = new QVBoxLayout(tableWidget);
     tableLayout->setContentsMargins(0, 0, 0, 0);
 
-    m_ledgerTable = new QTableWidget();
-    m_ledgerTable->setColumnCount(8);
-    m_ledgerTable->setHorizontalHeaderLabels({
-        tr("Date"), tr("Type"), tr("Account"), tr("Item/Description"),
-        tr("Category"), tr("Qty"), tr("Unit Price"), tr("Total")
-    });
+    m_ledgerModel = new LedgerModel(this);
+    m_ledgerProxy = new QSortFilterProxyModel(this);
+    m_ledgerProxy->setSourceModel(m_ledgerModel);
+    m_ledgerProxy->setSortRole(LedgerModel::SortRole);
+
+    m_ledgerTable = new QTableView();
+    m_ledgerTable->setModel(m_ledgerProxy);
     m_ledgerTable->setAlternatingRowColors(true);
     m_ledgerTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_ledgerTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_ledgerTable->setSortingEnabled(true);
     m_ledgerTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_ledgerTable->verticalHeader()->setVisible(false);
 
     auto *header = m_ledgerTable->horizontalHeader();
-    header->setSectionResizeMode(0, QHeaderView::ResizeToContents);  // Date
-    header->setSectionResizeMode(1, QHeaderView::ResizeToContents);  // Type
-    header->setSectionResizeMode(2, QHeaderView::ResizeToContents);  // Account
-    header->setSectionResizeMode(3, QHeaderView::Stretch);           // Item
-    header->setSectionResizeMode(4, QHeaderView::ResizeToContents);  // Category
-    header->setSectionResizeMode(5, QHeaderView::ResizeToContents);  // Qty
-    header->setSectionResizeMode(6, QHeaderView::ResizeToContents);  // Unit Price
-    header->setSectionResizeMode(7, QHeaderView::ResizeToContents);  // Total
-
-    connect(m_ledgerTable, &QTableWidget::itemSelectionChanged,
+    header->setSectionResizeMode(LedgerModel::DateColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::TypeColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::AccountColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::ItemColumn, QHeaderView::Stretch);
+    header->setSectionResizeMode(LedgerModel::CategoryColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::QuantityColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::UnitPriceColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(LedgerModel::TotalColumn, QHeaderView::ResizeToContents);
+
+    // Keep the database order (Opening first, newest first) until a header is clicked
+    header->setSortIndicator(-1, Qt::AscendingOrder);
+    m_ledgerTable->setSortingEnabled(true);
+
+    connect(m_ledgerTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &LedgerTab::onSelectionChanged);
-    connect(m_ledgerTable, &QTableWidget::cellDoubleClicked,
+    connect(m_ledgerTable, &QTableView::doubleClicked,
             this, &LedgerTab::onTransactionDoubleClicked);
 
     tableLayout->addWidget(m_ledgerTable);
@@ -109,6 +122,19 @@ void LedgerTab::setupUi()
 
     btnLayout->addStretch();
 
+    m_prevPageBtn = new QPushButton(tr("< Prev"));
+    connect(m_prevPageBtn, &QPushButton::clicked, this, &LedgerTab::onPreviousPage);
+    btnLayout->addWidget(m_prevPageBtn);
+
+    m_pageLabel = new QLabel();
+    btnLayout->addWidget(m_pageLabel);
+
+    m_nextPageBtn = new QPushButton(tr("Next >"));
+    connect(m_nextPageBtn, &QPushButton::clicked, this, &LedgerTab::onNextPage);
+    btnLayout->addWidget(m_nextPageBtn);
+
+    btnLayout->addStretch();
+
     m_editBtn = new QPushButton(tr("Edit"));
     m_editBtn->setEnabled(false);
     connect(m_editBtn, &QPushButton::clicked, this, &LedgerTab::onEditTransaction);
@@ -189,7 +215,12 @@ QWidget* LedgerTab::createFilterPanel()
     m_searchEdit = new QLineEdit();
     m_searchEdit->setPlaceholderText(tr("Item name..."));
     m_searchEdit->setMaximumWidth(150);
-    connect(m_searchEdit, &QLineEdit::textChanged, this, &LedgerTab::onFilterChanged);
+    // Wait for a pause in typing rather than querying on every keystroke
+    m_searchDebounce = new QTimer(this);
+    m_searchDebounce->setSingleShot(true);
+    m_searchDebounce->setInterval(250);
+    connect(m_searchDebounce, &QTimer::timeout, this, &LedgerTab::onFilterChanged);
+    connect(m_searchEdit, &QLineEdit::textChanged, m_searchDebounce, qOverload<>(&QTimer::start));
     layout->addWidget(m_searchEdit);
 
     // Refresh
@@ -334,22 +365,20 @@ QWidget* LedgerTab::createDetailsPanel()
 
 void LedgerTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("LedgerTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     loadTransactions();
-    updateSummary();
+    loadCategories();
+}
 
+void LedgerTab::loadCategories()
+{
     // Populate category filter
-    QSet<QString> categories;
-    for (const auto &t : m_transactions) {
-        if (!t.category.isEmpty()) {
-            categories.insert(t.category);
-        }
-    }
-
     m_categoryCombo->blockSignals(true);
     QString current = m_categoryCombo->currentData().toString();
     m_categoryCombo->clear();
     m_categoryCombo->addItem(tr("All Categories"), "");
-    for (const auto &cat : categories) {
+    for (const auto &cat : m_database->getTransactionCategories()) {
         m_categoryCombo->addItem(cat, cat);
     }
     int idx = m_categoryCombo->findData(current);
@@ -357,150 +386,142 @@ void LedgerTab::refreshData()
     m_categoryCombo->blockSignals(false);
 }
 
-void LedgerTab::loadTransactions()
+Frontier::TransactionQuery LedgerTab::currentFilter() const
 {
-    QDate fromDate = m_fromDateEdit->date();
-    QDate toDate = m_toDateEdit->date();
+    Frontier::TransactionQuery filter;
+    filter.from = m_fromDateEdit->date();
+    filter.to = m_toDateEdit->date();
 
-    m_transactions = m_database->getTransactionsByDateRange(fromDate, toDate);
-
-    // Apply filters
     QString typeFilter = m_typeCombo->currentData().toString();
-    QString accountFilter = m_accountCombo->currentData().toString();
-    QString categoryFilter = m_categoryCombo->currentData().toString();
-    QString searchFilter = m_searchEdit->text().toLower();
-
-    QVector<Frontier::Transaction> filtered;
-    for (const auto &t : m_transactions) {
-        if (!typeFilter.isEmpty() && Frontier::transactionTypeToString(t.type) != typeFilter) {
-            continue;
-        }
-        if (!accountFilter.isEmpty() && Frontier::accountTypeToString(t.account) != accountFilter) {
-            continue;
-        }
-        if (!categoryFilter.isEmpty() && t.category != categoryFilter) {
-            continue;
-        }
-        if (!searchFilter.isEmpty() && !t.item.toLower().contains(searchFilter)) {
-            continue;
-        }
-        filtered.append(t);
+    if (!typeFilter.isEmpty()) {
+        filter.type = Frontier::stringToTransactionType(typeFilter);
     }
 
-    m_transactions = filtered;
-
-    // Sort: Opening transactions first, then by date descending
-    std::sort(m_transactions.begin(), m_transactions.end(),
-              [](const Frontier::Transaction &a, const Frontier::Transaction &b) {
-                  // Opening transactions come first
-                  bool aIsOpening = (a.type == Frontier::TransactionType::Opening);
-                  bool bIsOpening = (b.type == Frontier::TransactionType::Opening);
+    QString accountFilter = m_accountCombo->currentData().toString();
+    if (!accountFilter.isEmpty()) {
+        filter.account = Frontier::stringToAccountType(accountFilter);
+    }
 
-                  if (aIsOpening && !bIsOpening) return true;
-                  if (!aIsOpening && bIsOpening) return false;
+    filter.category = m_categoryCombo->currentData().toString();
+    filter.search = m_searchEdit->text().trimmed();
+    return filter;
+}
 
-                  // Then sort by date descending (newest first)
-                  if (a.date != b.date) return a.date > b.date;
+void LedgerTab::loadTransactions()
+{
+    const Frontier::TransactionQuery filter = currentFilter();
+    const int requestedPage = m_currentPage;
+    const int generation = ++m_loadGeneration;
+
+    // Totals cover the whole filtered range; rows are fetched one page at a time
+    auto fetch = [filter, requestedPage](Frontier::Database &db) {
+        LedgerPage page;
+        page.totals = db.getTransactionTotals(filter);
+
+        int pageCount = qMax(1, (page.totals.count + PageSize - 1) / PageSize);
+        page.page = qBound(0, requestedPage, pageCount - 1);
+
+        Frontier::TransactionQuery paged = filter;
+        paged.limit = PageSize;
+        paged.offset = page.page * PageSize;
+        page.rows = db.queryTransactions(paged);
+        return page;
+    };
 
-                  // Then by ID descending
-                  return a.id.value_or(0) > b.id.value_or(0);
-              });
+    m_pageLabel->setText(tr("Loading..."));
+    m_prevPageBtn->setEnabled(false);
+    m_nextPageBtn->setEnabled(false);
 
-    // Populate table
-    m_ledgerTable->setSortingEnabled(false);
-    m_ledgerTable->setRowCount(m_transactions.size());
+    m_database->worker().run(fetch)
+        .then(this, [this, generation](const LedgerPage &page) {
+            // A newer request superseded this one while it was running
+            if (generation == m_loadGeneration) {
+                showPage(page);
+            }
+        })
+        .onCanceled(this, [this, generation, fetch]() {
+            if (generation == m_loadGeneration) {
+                showPage(fetch(*m_database));
+            }
+        });
+}
 
-    for (int row = 0; row < m_transactions.size(); ++row) {
-        const auto &t = m_transactions[row];
+void LedgerTab::reloadTotals()
+{
+    m_totals = m_database->getTransactionTotals(currentFilter());
+    updatePageControls();
+    updateSummary();
+}
 
-        // Date
-        auto *dateItem = new QTableWidgetItem(t.date.toString("yyyy-MM-dd"));
-        dateItem->setData(Qt::UserRole, t.id.value_or(0));
-        m_ledgerTable->setItem(row, 0, dateItem);
+bool LedgerTab::patchRows(const QVector<Frontier::RowChange> &changes)
+{
+    // A hidden tab refreshes when next shown
+    if (!isVisible()) {
+        return false;
+    }
 
-        // Type
-        QString typeStr = Frontier::transactionTypeToString(t.type);
-        auto *typeItem = new QTableWidgetItem(typeStr);
-        QColor typeColor;
-        switch (t.type) {
-        case Frontier::TransactionType::Opening:
-            typeColor = QColor("#1565c0"); // Blue
-            break;
-        case Frontier::TransactionType::Sale:
-            typeColor = QColor("#2e7d32"); // Green
+    // Patch the page instead of refetching it; only an insert needs the
+    // page again, since its position depends on the sort and paging
+    bool inserted = false;
+    bool patched = false;
+    for (const Frontier::RowChange &change : changes) {
+        switch (change.kind) {
+        case Frontier::RowChange::Inserted:
+            inserted = true;
             break;
-        case Frontier::TransactionType::Purchase:
-        case Frontier::TransactionType::Fuel:
-            typeColor = QColor("#c62828"); // Red
+        case Frontier::RowChange::Updated:
+            if (auto row = m_database->getTransaction(change.id)) {
+                patched |= m_ledgerModel->updateTransaction(*row);
+            }
             break;
-        case Frontier::TransactionType::Transfer:
-            typeColor = QColor("#7b1fa2"); // Purple
+        case Frontier::RowChange::Deleted:
+            patched |= m_ledgerModel->removeTransaction(change.id);
             break;
         }
-        typeItem->setForeground(typeColor);
-        m_ledgerTable->setItem(row, 1, typeItem);
-
-        // Account
-        m_ledgerTable->setItem(row, 2, new QTableWidgetItem(Frontier::accountTypeToString(t.account)));
-
-        // Item
-        m_ledgerTable->setItem(row, 3, new QTableWidgetItem(t.item));
-
-        // Category
-        m_ledgerTable->setItem(row, 4, new QTableWidgetItem(t.category));
-
-        // Quantity
-        auto *qtyItem = new QTableWidgetItem(QString::number(t.quantity));
-        qtyItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_ledgerTable->setItem(row, 5, qtyItem);
-
-        // Unit Price
-        auto *priceItem = new QTableWidgetItem(formatCurrency(t.unitPrice));
-        priceItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_ledgerTable->setItem(row, 6, priceItem);
-
-        // Total
-        auto *totalItem = new QTableWidgetItem(formatAmount(t.totalAmount, t.type));
-        totalItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        totalItem->setData(Qt::UserRole, t.totalAmount);
-        if (t.type == Frontier::TransactionType::Sale || t.type == Frontier::TransactionType::Opening) {
-            totalItem->setForeground(QColor("#2e7d32"));
-        } else if (t.type == Frontier::TransactionType::Purchase || t.type == Frontier::TransactionType::Fuel) {
-            totalItem->setForeground(QColor("#c62828"));
+    }
+
+    if (inserted) {
+        loadTransactions();
+    } else {
+        reloadTotals();
+        if (patched) {
+            onSelectionChanged();
         }
-        m_ledgerTable->setItem(row, 7, totalItem);
     }
+    loadCategories();
+    return true;
+}
 
-    m_ledgerTable->setSortingEnabled(true);
+void LedgerTab::showPage(const LedgerPage &page)
+{
+    m_totals = page.totals;
+    m_currentPage = page.page;
+    m_ledgerModel->setTransactions(page.rows);
+
+    // A model reset drops the selection without emitting selectionChanged
+    m_editBtn->setEnabled(false);
+    m_deleteBtn->setEnabled(false);
     clearDetails();
+    updatePageControls();
+    updateSummary();
+}
+
+void LedgerTab::updatePageControls()
+{
+    int pageCount = qMax(1, (m_totals.count + PageSize - 1) / PageSize);
+    m_pageLabel->setText(tr("Page %1 of %2").arg(m_currentPage + 1).arg(pageCount));
+    m_prevPageBtn->setEnabled(m_currentPage > 0);
+    m_nextPageBtn->setEnabled(m_currentPage + 1 < pageCount);
 }
 
 void LedgerTab::updateSummary()
 {
-    double totalIncome = 0;
-    double personalIncome = 0;
-    double companyIncome = 0;
-    double totalExpenses = 0;
-    double personalExpenses = 0;
-    double companyExpenses = 0;
-
-    for (const auto &t : m_transactions) {
-        if (t.type == Frontier::TransactionType::Sale || t.type == Frontier::TransactionType::Opening) {
-            totalIncome += t.totalAmount;
-            if (t.account == Frontier::AccountType::Personal) {
-                personalIncome += t.totalAmount;
-            } else {
-                companyIncome += t.totalAmount;
-            }
-        } else if (t.type == Frontier::TransactionType::Purchase || t.type == Frontier::TransactionType::Fuel) {
-            totalExpenses += t.totalAmount;
-            if (t.account == Frontier::AccountType::Personal) {
-                personalExpenses += t.totalAmount;
-            } else {
-                companyExpenses += t.totalAmount;
-            }
-        }
-    }
+    double totalIncome = m_totals.totalIncome();
+    double personalIncome = m_totals.personalIncome;
+    double companyIncome = m_totals.companyIncome;
+    double totalExpenses = m_totals.totalExpenses();
+    double personalExpenses = m_totals.personalExpenses;
+    double companyExpenses = m_totals.companyExpenses;
 
     double net = totalIncome - totalExpenses;
 
@@ -518,7 +539,7 @@ void LedgerTab::updateSummary()
         m_netLabel->setStyleSheet("font-size: 14px; font-weight: bold; color: #c62828;");
     }
 
-    m_transactionCountLabel->setText(QString::number(m_transactions.size()));
+    m_transactionCountLabel->setText(QString::number(m_totals.count));
 }
 
 void LedgerTab::populateDetails(const Frontier::Transaction &t)
@@ -559,32 +580,53 @@ QString LedgerTab::formatAmount(double amount, Frontier::TransactionType type) c
 
 void LedgerTab::onFilterChanged()
 {
+    m_currentPage = 0;
     loadTransactions();
-    updateSummary();
+}
+
+void LedgerTab::onPreviousPage()
+{
+    if (m_currentPage > 0) {
+        --m_currentPage;
+        loadTransactions();
+    }
+}
+
+void LedgerTab::onNextPage()
+{
+    ++m_currentPage;  // loadTransactions clamps to the last page
+    loadTransactions();
+}
+
+std::optional<Frontier::Transaction> LedgerTab::selectedTransaction() const
+{
+    QModelIndexList rows = m_ledgerTable->selectionModel()->selectedRows();
+    if (rows.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QModelIndex source = m_ledgerProxy->mapToSource(rows.first());
+    return m_ledgerModel->transactionAt(source.row());
 }
 
 void LedgerTab::onSelectionChanged()
 {
-    auto selected = m_ledgerTable->selectedItems();
-    bool hasSelection = !selected.isEmpty();
+    auto selected = selectedTransaction();
+    bool hasSelection = selected.has_value();
 
     m_editBtn->setEnabled(hasSelection);
     m_deleteBtn->setEnabled(hasSelection);
 
     if (hasSelection) {
-        int row = selected.first()->row();
-        if (row >= 0 && row < m_transactions.size()) {
-            populateDetails(m_transactions[row]);
-        }
+        populateDetails(*selected);
     } else {
         clearDetails();
     }
 }
 
-void LedgerTab::onTransactionDoubleClicked(int row, int column)
+void LedgerTab::onTransactionDoubleClicked(const QModelIndex &index)
 {
-    Q_UNUSED(column);
-    if (row >= 0 && row < m_transactions.size()) {
+    if (index.isValid()) {
         onEditTransaction();
     }
 }
@@ -662,8 +704,8 @@ void LedgerTab::showTransactionDialog(bool isEdit)
     // Auto-fill price from item
     auto updatePriceFromItem = [=]() {
         QString text = itemCombo->currentText();
-        auto item = m_database->getItemByName(text);
-        if (item.has_value()) {
+        const Frontier::Item *item = m_database->itemCatalog().findByName(text);
+        if (item) {
             categoryEdit->setText(item->categoryMain);
             QString typeStr = typeCombo->currentData().toString();
             if (typeStr == "Purchase" || typeStr == "Fuel") {
@@ -689,11 +731,12 @@ void LedgerTab::showTransactionDialog(bool isEdit)
 
     // Populate if editing
     Frontier::Transaction transaction;
+    std::optional<Frontier::Transaction> before;
     if (isEdit) {
-        auto selected = m_ledgerTable->selectedItems();
-        if (!selected.isEmpty()) {
-            int row = selected.first()->row();
-            transaction = m_transactions[row];
+        auto selected = selectedTransaction();
+        if (selected) {
+            transaction = *selected;
+            before = *selected;
 
             dateEdit->setDate(transaction.date);
             int typeIdx = typeCombo->findData(Frontier::transactionTypeToString(transaction.type));
@@ -725,9 +768,11 @@ void LedgerTab::showTransactionDialog(bool isEdit)
         transaction.totalAmount = transaction.quantity * transaction.unitPrice;
         transaction.notes = notesEdit->text();
 
+        // Through the journal, which patches the page via onJournalApplied()
+        Frontier::CommandJournal &journal = m_database->journal();
         bool success = false;
-        if (isEdit && transaction.id.has_value()) {
-            success = m_database->updateTransaction(transaction);
+        if (isEdit && before && transaction.id.has_value()) {
+            success = journal.execute(Frontier::JournalCommand::updateTransaction(*before, transaction));
         } else {
             // Check if this qualifies for auto-split (Sale of raw ore/oil)
             bool shouldAutoSplit = false;
@@ -766,8 +811,20 @@ void LedgerTab::showTransactionDialog(bool isEdit)
                                        ? QString("10% split")
                                        : QString("%1 (10% split)").arg(transaction.notes);
 
-                success = m_database->addTransaction(companyTx) &&
-                          m_database->addTransaction(personalTx);
+                // Both halves undo as one step
+                journal.beginGroup(tr("Add split sale: %1").arg(transaction.item));
+                if (!journal.inGroup()) {
+                    // Without the group each half would commit on its own
+                    success = false;
+                } else {
+                    success = journal.execute(Frontier::JournalCommand::addTransaction(companyTx)) &&
+                              journal.execute(Frontier::JournalCommand::addTransaction(personalTx));
+                    if (success) {
+                        success = journal.endGroup();
+                    } else {
+                        journal.abortGroup();
+                    }
+                }
 
                 if (success) {
                     QMessageBox::information(this, tr("Auto-Split Applied"),
@@ -776,12 +833,11 @@ void LedgerTab::showTransactionDialog(bool isEdit)
                                                  .arg(formatCurrency(personalAmount)));
                 }
             } else {
-                success = m_database->addTransaction(transaction);
+                success = journal.execute(Frontier::JournalCommand::addTransaction(transaction));
             }
         }
 
         if (success) {
-            refreshData();
             emit transactionChanged();
             emit balancesChanged();
         } else {
@@ -802,18 +858,14 @@ void LedgerTab::onEditTransaction()
 
 void LedgerTab::onDeleteTransaction()
 {
-    auto selected = m_ledgerTable->selectedItems();
-    if (selected.isEmpty()) return;
-
-    int row = selected.first()->row();
-    int transactionId = m_ledgerTable->item(row, 0)->data(Qt::UserRole).toInt();
+    auto selected = selectedTransaction();
+    if (!selected || !selected->id) return;
 
     auto result = QMessageBox::question(this, tr("Delete Transaction"),
-                                        tr("Delete this transaction?\n\nThis cannot be undone."));
+                                        tr("Delete this transaction?\n\nEdit > Undo restores it."));
 
     if (result == QMessageBox::Yes) {
-        if (m_database->deleteTransaction(transactionId)) {
-            refreshData();
+        if (m_database->journal().execute(Frontier::JournalCommand::deleteTransaction(*selected))) {
             emit transactionChanged();
             emit balancesChanged();
         }
@@ -7,7 +7,8 @@
 #define LEDGERTAB_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
+#include <QSortFilterProxyModel>
 #include <QComboBox>
 #include <QDateEdit>
 #include <QPushButton>
@@ -17,13 +18,17 @@
 #include <QDoubleSpinBox>
 #include <QSpinBox>
 #include <QGroupBox>
+#include <QTimer>
 
 #include "core/types.h"
 
 namespace Frontier {
 class Database;
+struct RowChange;
 }
 
+class LedgerModel;
+
 class LedgerTab : public QWidget
 {
     Q_OBJECT
@@ -44,7 +49,9 @@ private slots:
     void onEditTransaction();
     void onDeleteTransaction();
     void onSelectionChanged();
-    void onTransactionDoubleClicked(int row, int column);
+    void onTransactionDoubleClicked(const QModelIndex &index);
+    void onPreviousPage();
+    void onNextPage();
 
 private:
     void setupUi();
@@ -52,9 +59,23 @@ private:
     QWidget* createSummaryPanel();
     QWidget* createDetailsPanel();
 
-    void loadTransactions();
+    // One page of the filtered ledger plus totals over every matching row
+    struct LedgerPage {
+        Frontier::TransactionTotals totals;
+        int page = 0;
+        QVector<Frontier::Transaction> rows;
+    };
+
+    Frontier::TransactionQuery currentFilter() const;
+    void loadTransactions();     // Runs on the database worker
+    void loadCategories();
+    void reloadTotals();         // Totals only, after a row was patched in place
+    bool patchRows(const QVector<Frontier::RowChange> &changes);
+    void showPage(const LedgerPage &page);
+    void updatePageControls();
     void updateSummary();
     void showTransactionDialog(bool isEdit);
+    std::optional<Frontier::Transaction> selectedTransaction() const;
     void populateDetails(const Frontier::Transaction &transaction);
     void clearDetails();
 
@@ -69,6 +90,7 @@ private:
     QComboBox *m_accountCombo;
     QComboBox *m_categoryCombo;
     QLineEdit *m_searchEdit;
+    QTimer *m_searchDebounce;
     QPushButton *m_refreshBtn;
 
     // Summary
@@ -82,10 +104,15 @@ private:
     QLabel *m_transactionCountLabel;
 
     // Table
-    QTableWidget *m_ledgerTable;
+    QTableView *m_ledgerTable;
+    LedgerModel *m_ledgerModel;
+    QSortFilterProxyModel *m_ledgerProxy;
     QPushButton *m_addBtn;
     QPushButton *m_editBtn;
     QPushButton *m_deleteBtn;
+    QPushButton *m_prevPageBtn;
+    QPushButton *m_nextPageBtn;
+    QLabel *m_pageLabel;
 
     // Details panel
     QGroupBox *m_detailsGroup;
@@ -99,8 +126,11 @@ private:
     QLabel *m_detailTotalLabel;
     QLabel *m_detailNotesLabel;
 
-    // Data
-    QVector<Frontier::Transaction> m_transactions;
+    // Data - the model holds the current page only
+    Frontier::TransactionTotals m_totals;
+    int m_currentPage = 0;
+    int m_loadGeneration = 0;    // Drops results of superseded loads
+    static constexpr int PageSize = 500;
 };
 
 #endif // LEDGERTAB_H
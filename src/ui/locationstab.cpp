@@ -5,6 +5,7 @@
 
 #include "locationstab.h"
 #include "core/database.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -19,7 +20,9 @@ LocationsTab::LocationsTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
-    refreshData();
+    // First load waits until the tab is first shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Locations,
+                                      [this]() { refreshData(); }, true);
 }
 
 void LocationsTab::setupUi()
@@ -191,6 +194,8 @@ void LocationsTab::setupUi()
 
 void LocationsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("LocationsTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     loadMaps();
     loadTypes();
     populateFilterCombos();
@@ -334,9 +339,9 @@ void LocationsTab::loadLocations()
 
 void LocationsTab::updateSummary()
 {
-    int mapCount = m_database->getAllMaps().size();
-    int typeCount = m_database->getAllLocationTypes().size();
-    int locCount = m_database->getAllLocations().size();
+    int mapCount = m_database->getMapCount();
+    int typeCount = m_database->getLocationTypeCount();
+    int locCount = m_database->getLocationCount();
     int showingCount = m_locationsTable->rowCount();
 
     QString summary = tr("Maps: %1 | Types: %2 | Locations: %3")
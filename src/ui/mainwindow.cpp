@@ -1,10 +1,15 @@
 // Own header first
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
-#include "core/itemimporter.h"
-#include "core/vehicleimporter.h"
-#include "core/recipeimporter.h"
-#include "core/locationimporter.h"
+#include "core/importpipeline.h"
+#include "core/referencewatcher.h"
+#include "core/commandjournal.h"
+#include "core/profiler.h"
+#include "core/overlayserver.h"
+#include "core/onlinebackup.h"
+#include "core/dataexporter.h"
+#include "core/profileregistry.h"
+#include "core/embeddedcatalog.h"
 
 // Project headers
 #include "ui/dashboardwidget.h"
@@ -19,20 +24,42 @@
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
+#include <QActionGroup>
 #include <QStatusBar>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QVBoxLayout>
+#include <QTimer>
+#include <QProgressDialog>
+#include <QSettings>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QFileInfo>
+#include <QDir>
+#include <QApplication>
+#include <QDebug>
+#include <utility>
 
 MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_database(database)
     , m_operationsManager(new Frontier::OperationsManager(database, this))
+    , m_dataHubWidget(nullptr)
+    , m_importPipeline(new Frontier::ImportPipeline(database, this))
+    , m_referenceWatcher(new Frontier::ReferenceWatcher(this))
+    , m_overlayServer(new Frontier::OverlayServer(database, m_operationsManager, this))
+    , m_backup(new Frontier::OnlineBackup(this))
+    , m_exporter(new Frontier::DataExporter(database, this))
 {
+    m_startupTimer.start();
     ui->setupUi(this);
 
+    // Before any view reads, so a new install opens with reference data
+    checkBuiltInCatalog();
+
     // Set window properties
-    setWindowTitle("Frontier Mining Tracker");
+    updateWindowTitle();
     setMinimumSize(1024, 700);
     resize(1280, 800);
 
@@ -40,19 +67,33 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
     m_tabWidget = new QTabWidget(this);
     setCentralWidget(m_tabWidget);
 
-    // Create tab widgets - pass database to DataHub
-    DashboardWidget *dashboardWidget = new DashboardWidget(m_database, this);
-    FinanceWidget *financeWidget = new FinanceWidget(m_database, this);
-    OperationsWidget *operationsWidget = new OperationsWidget(m_operationsManager, this);
-    m_dataHubWidget = new DataHubWidget(m_database, this);
-    AuditorWidget *auditorWidget = new AuditorWidget(m_database, this);
+    // Only the Dashboard is on screen at startup; the other tabs, and all
+    // their subtabs, are built the first time they are activated
+    QElapsedTimer dashboardTimer;
+    dashboardTimer.start();
+    m_dashboardWidget = new DashboardWidget(m_database, this);
+    m_tabWidget->addTab(m_dashboardWidget, QIcon(":/icons/icons/chart-bar.svg"), "Dashboard");
+    m_pendingTabs.append(nullptr);
+    Frontier::Profiler::instance().record("Startup: Dashboard tab", dashboardTimer.nsecsElapsed());
+
+    addLazyTab(QIcon(":/icons/icons/receipt-2.svg"), "Finance", [this]() -> QWidget * {
+        return new FinanceWidget(m_database, this);
+    });
+    addLazyTab(QIcon(":/icons/icons/building.svg"), "Operations", [this]() -> QWidget * {
+        return new OperationsWidget(m_operationsManager, this);
+    });
+    addLazyTab(QIcon(":/icons/icons/book.svg"), "Data Hub", [this]() -> QWidget * {
+        m_dataHubWidget = new DataHubWidget(m_database, this);
+        return m_dataHubWidget;
+    });
+    addLazyTab(QIcon(":/icons/icons/settings.svg"), "Auditor", [this]() -> QWidget * {
+        return new AuditorWidget(m_database, this);
+    });
 
-    // Add tabs with icons
-    m_tabWidget->addTab(dashboardWidget, QIcon(":/icons/icons/chart-bar.svg"), "Dashboard");
-    m_tabWidget->addTab(financeWidget, QIcon(":/icons/icons/receipt-2.svg"), "Finance");
-    m_tabWidget->addTab(operationsWidget, QIcon(":/icons/icons/building.svg"), "Operations");
-    m_tabWidget->addTab(m_dataHubWidget, QIcon(":/icons/icons/book.svg"), "Data Hub");
-    m_tabWidget->addTab(auditorWidget, QIcon(":/icons/icons/settings.svg"), "Auditor");
+    // Edits queued on the tab being left land before the next one reads
+    connect(m_tabWidget, &QTabWidget::currentChanged,
+            m_database, &Frontier::Database::flushPendingWrites);
+    connect(m_tabWidget, &QTabWidget::currentChanged, this, &MainWindow::ensureTabBuilt);
 
     // === Menu Bar ===
     // File Menu
@@ -72,6 +113,12 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
 
     fileMenu->addSeparator();
 
+    // Profile submenu
+    m_profileMenu = fileMenu->addMenu("&Profile");
+    rebuildProfileMenu();
+
+    fileMenu->addSeparator();
+
     // Import submenu
     QMenu *importMenu = fileMenu->addMenu("&Import");
 
@@ -99,6 +146,72 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
             this, &MainWindow::onImportLocations);
     importMenu->addAction(m_importLocationsAction);
 
+    importMenu->addSeparator();
+
+    m_refreshReferenceAction = new QAction("Refresh &All Reference Data...", this);
+    m_refreshReferenceAction->setStatusTip("Import items, vehicles, recipes, locations and "
+                                           "factory buildings from one folder");
+    connect(m_refreshReferenceAction, &QAction::triggered,
+            this, &MainWindow::onRefreshReferenceData);
+    importMenu->addAction(m_refreshReferenceAction);
+
+    connect(m_importPipeline, &Frontier::ImportPipeline::finished,
+            this, &MainWindow::onImportFinished);
+
+    // Edited reference files are reimported differentially in the background;
+    // the files are the ones last imported, or the app's data folder at first
+    QAction *watchReferenceAction = importMenu->addAction("&Watch Reference Files");
+    watchReferenceAction->setCheckable(true);
+    watchReferenceAction->setStatusTip("Reimport reference files in the background when they are edited");
+    {
+        QSettings settings("FrontierMining", "Tracker");
+        Frontier::ReferenceSources watched;
+        watched.itemsJson = settings.value("Reference/itemsJson").toString();
+        watched.vehiclesJson = settings.value("Reference/vehiclesJson").toString();
+        watched.recipesJson = settings.value("Reference/recipesJson").toString();
+        watched.locationsDir = settings.value("Reference/locationsDir").toString();
+        watched.buildingsJson = settings.value("Reference/buildingsJson").toString();
+        if (watched.isEmpty()) {
+            watched = Frontier::ReferenceSources::fromDirectory(QCoreApplication::applicationDirPath() + "/data");
+        }
+        m_referenceWatcher->setSources(watched);
+        watchReferenceAction->setChecked(settings.value("Reference/watch", true).toBool());
+        m_referenceWatcher->setEnabled(watchReferenceAction->isChecked());
+    }
+    connect(watchReferenceAction, &QAction::toggled, this, [this](bool enabled) {
+        QSettings("FrontierMining", "Tracker").setValue("Reference/watch", enabled);
+        m_referenceWatcher->setEnabled(enabled);
+    });
+    connect(m_referenceWatcher, &Frontier::ReferenceWatcher::changed,
+            this, &MainWindow::onReferenceFilesChanged);
+
+    // Export submenu
+    QMenu *exportMenu = fileMenu->addMenu("&Export");
+    const Frontier::DataTable exportTables[] = {
+        Frontier::DataTable::Transactions, Frontier::DataTable::FuelLog,
+        Frontier::DataTable::Production, Frontier::DataTable::Shifts,
+        Frontier::DataTable::CycleTimes,
+    };
+    for (Frontier::DataTable table : exportTables) {
+        QAction *action = exportMenu->addAction(Frontier::DataExporter::tableLabel(table) + "...");
+        connect(action, &QAction::triggered, this, [this, table]() { exportTable(table); });
+    }
+    connect(m_exporter, &Frontier::DataExporter::finished, this, &MainWindow::onExportFinished);
+
+    connect(m_backup, &Frontier::OnlineBackup::finished, this, &MainWindow::onBackupFinished);
+
+    QAction *backupAction = fileMenu->addAction("&Back Up Now");
+    backupAction->setStatusTip("Copy the database to a timestamped snapshot while it stays in use");
+    connect(backupAction, &QAction::triggered, this, [this]() {
+        m_afterBackup = nullptr;
+        startBackup(tr("Back Up Database"));
+    });
+
+    QAction *archiveAction = fileMenu->addAction("Archive &Closed Year...");
+    archiveAction->setStatusTip("Move a past year's transactions, fuel log and production "
+                                "runs to their own archive file");
+    connect(archiveAction, &QAction::triggered, this, &MainWindow::onArchiveYear);
+
     fileMenu->addSeparator();
 
     QAction *exitAction = fileMenu->addAction("E&xit");
@@ -108,11 +221,25 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
     // Edit Menu
     QMenu *editMenu = menuBar()->addMenu("&Edit");
 
-    QAction *undoAction = editMenu->addAction("&Undo");
-    undoAction->setShortcut(QKeySequence::Undo);
+    m_undoAction = editMenu->addAction("&Undo");
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    connect(m_undoAction, &QAction::triggered, this, [this]() {
+        if (!m_database->journal().undo()) {
+            statusBar()->showMessage("Undo failed: " + m_database->journal().lastError(), 5000);
+        }
+    });
 
-    QAction *redoAction = editMenu->addAction("&Redo");
-    redoAction->setShortcut(QKeySequence::Redo);
+    m_redoAction = editMenu->addAction("&Redo");
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    connect(m_redoAction, &QAction::triggered, this, [this]() {
+        if (!m_database->journal().redo()) {
+            statusBar()->showMessage("Redo failed: " + m_database->journal().lastError(), 5000);
+        }
+    });
+
+    connect(&m_database->journal(), &Frontier::CommandJournal::stateChanged,
+            this, &MainWindow::updateUndoActions);
+    updateUndoActions();
 
     // View Menu
     QMenu *viewMenu = menuBar()->addMenu("&View");
@@ -147,6 +274,31 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
         m_tabWidget->setCurrentIndex(4);
     });
 
+    // Local endpoint for in-game overlays; off unless turned on here
+    viewMenu->addSeparator();
+    QAction *overlayAction = viewMenu->addAction("Overlay &Endpoint");
+    overlayAction->setCheckable(true);
+    connect(overlayAction, &QAction::toggled, this, [this, overlayAction](bool enabled) {
+        QSettings settings("FrontierMining", "Tracker");
+        settings.setValue("Overlay/enabled", enabled);
+        if (!enabled) {
+            m_overlayServer->close();
+            return;
+        }
+        const QString name = settings.value("Overlay/serverName",
+                                            QString::fromLatin1(Frontier::OverlayServer::DefaultName)).toString();
+        if (!m_overlayServer->listen(name)) {
+            QMessageBox::warning(this, "Overlay Endpoint",
+                                 "Could not start the overlay endpoint:\n" + m_overlayServer->lastError());
+            settings.setValue("Overlay/enabled", false);
+            QSignalBlocker blocker(overlayAction);
+            overlayAction->setChecked(false);
+            return;
+        }
+        statusBar()->showMessage("Overlay endpoint listening on " + m_overlayServer->serverName(), 5000);
+    });
+    overlayAction->setChecked(QSettings("FrontierMining", "Tracker").value("Overlay/enabled", false).toBool());
+
     // Help Menu
     QMenu *helpMenu = menuBar()->addMenu("&Help");
     QAction *aboutAction = helpMenu->addAction("&About");
@@ -159,6 +311,45 @@ MainWindow::MainWindow(Frontier::Database *database, QWidget *parent)
 
     statusBar()->addPermanentWidget(m_dayLabel);
     statusBar()->addPermanentWidget(m_balanceLabel);
+
+    Frontier::Profiler::instance().record("Startup: main window", m_startupTimer.nsecsElapsed());
+}
+
+void MainWindow::addLazyTab(const QIcon &icon, const QString &label, std::function<QWidget *()> factory)
+{
+    QWidget *placeholder = new QWidget(this);
+    auto *layout = new QVBoxLayout(placeholder);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_tabWidget->addTab(placeholder, icon, label);
+    m_pendingTabs.append(std::move(factory));
+}
+
+void MainWindow::updateUndoActions()
+{
+    const Frontier::CommandJournal &journal = m_database->journal();
+    m_undoAction->setEnabled(journal.canUndo());
+    m_undoAction->setText(journal.canUndo() ? "&Undo " + journal.undoText() : QString("&Undo"));
+    m_redoAction->setEnabled(journal.canRedo());
+    m_redoAction->setText(journal.canRedo() ? "&Redo " + journal.redoText() : QString("&Redo"));
+}
+
+void MainWindow::ensureTabBuilt(int index)
+{
+    if (index < 0 || index >= m_pendingTabs.size() || !m_pendingTabs[index]) {
+        return;
+    }
+
+    // Clear first so a re-entrant currentChanged does not build twice
+    const auto factory = std::move(m_pendingTabs[index]);
+    m_pendingTabs[index] = nullptr;
+
+    QElapsedTimer timer;
+    timer.start();
+    QWidget *page = factory();
+    m_tabWidget->widget(index)->layout()->addWidget(page);
+    Frontier::Profiler::instance().record("Startup: " + m_tabWidget->tabText(index) + " tab",
+                                          timer.nsecsElapsed());
 }
 
 void MainWindow::onImportItems()
@@ -180,13 +371,13 @@ void MainWindow::onImportItems()
         return;  // User cancelled
     }
 
-    // Ask about clearing existing data
+    // Ask how to apply the file
     QMessageBox::StandardButton reply = QMessageBox::question(
         this,
         "Import Items",
         "Do you want to replace all existing items?\n\n"
-        "Yes = Clear existing and import new\n"
-        "No = Merge with existing (update if name exists)",
+        "Yes = Sync with the file (update changed items, remove missing ones)\n"
+        "No = Add the file's items to the existing ones",
         QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel
         );
 
@@ -194,38 +385,11 @@ void MainWindow::onImportItems()
         return;
     }
 
-    bool clearExisting = (reply == QMessageBox::Yes);
-
-    // Perform import
-    int count = Frontier::ItemImporter::importFromJson(
-        jsonPath, m_database, clearExisting
-        );
-
-    if (count > 0) {
-        QMessageBox::information(
-            this,
-            "Import Complete",
-            QString("Successfully imported %1 items.").arg(count)
-            );
-
-        // Refresh Data Hub
-        m_dataHubWidget->refreshData();
-
-        statusBar()->showMessage(QString("Imported %1 items").arg(count), 5000);
-    } else if (count == 0) {
-        QMessageBox::warning(
-            this,
-            "Import Warning",
-            "No items were imported. The file may be empty."
-            );
-    } else {
-        QMessageBox::critical(
-            this,
-            "Import Failed",
-            "Could not import items from the selected file.\n\n"
-            "Please ensure the file is a valid items JSON file."
-            );
-    }
+    // Yes is differential: only changed rows are written and item ids survive
+    Frontier::ReferenceSources sources;
+    sources.itemsJson = jsonPath;
+    sources.syncItems = (reply == QMessageBox::Yes);
+    runImport(sources, "Import Items");
 }
 
 void MainWindow::onImportVehicles()
@@ -261,38 +425,10 @@ void MainWindow::onImportVehicles()
         return;
     }
 
-    bool clearExisting = (reply == QMessageBox::Yes);
-
-    // Perform import
-    int count = Frontier::VehicleImporter::importFromJson(
-        jsonPath, m_database, clearExisting
-        );
-
-    if (count > 0) {
-        QMessageBox::information(
-            this,
-            "Import Complete",
-            QString("Successfully imported %1 vehicles.").arg(count)
-            );
-
-        // Refresh Data Hub
-        m_dataHubWidget->refreshData();
-
-        statusBar()->showMessage(QString("Imported %1 vehicles").arg(count), 5000);
-    } else if (count == 0) {
-        QMessageBox::warning(
-            this,
-            "Import Warning",
-            "No vehicles were imported. The file may be empty."
-            );
-    } else {
-        QMessageBox::critical(
-            this,
-            "Import Failed",
-            "Could not import vehicles from the selected file.\n\n"
-            "Please ensure the file is a valid vehicles JSON file."
-            );
-    }
+    Frontier::ReferenceSources sources;
+    sources.vehiclesJson = jsonPath;
+    sources.replaceVehicles = (reply == QMessageBox::Yes);
+    runImport(sources, "Import Vehicles");
 }
 
 void MainWindow::onImportRecipes()
@@ -327,38 +463,9 @@ void MainWindow::onImportRecipes()
         return;
     }
 
-    // Perform import
-    RecipeImporter importer(m_database);
-    bool success = importer.importFromJson(jsonPath);
-
-    if (success) {
-        QMessageBox::information(
-            this,
-            "Import Complete",
-            QString("Successfully imported:\n"
-                    "• %1 workbenches\n"
-                    "• %2 recipes")
-                .arg(importer.workbenchesImported())
-                .arg(importer.recipesImported())
-            );
-
-        // Refresh Data Hub to show new recipes
-        m_dataHubWidget->refreshData();
-
-        statusBar()->showMessage(
-            QString("Imported %1 recipes from %2 workbenches")
-                .arg(importer.recipesImported())
-                .arg(importer.workbenchesImported()),
-            5000
-            );
-    } else {
-        QMessageBox::critical(
-            this,
-            "Import Failed",
-            QString("Could not import recipes.\n\nError: %1")
-                .arg(importer.lastError())
-            );
-    }
+    Frontier::ReferenceSources sources;
+    sources.recipesJson = jsonPath;
+    runImport(sources, "Import Recipes");
 }
 
 void MainWindow::onImportLocations()
@@ -387,28 +494,510 @@ void MainWindow::onImportLocations()
         return;
     }
 
-    bool success = Frontier::LocationImporter::importFromDirectory(dir, m_database, true);
+    // Differential, so location ids referenced by inventory survive a refresh
+    Frontier::ReferenceSources sources;
+    sources.locationsDir = dir;
+    runImport(sources, tr("Import Locations"));
+}
+
+MainWindow::~MainWindow()
+{
+    delete ui;
+}
+
+void MainWindow::onArchiveYear()
+{
+    const int lastClosed = QDate::currentDate().year() - 1;
+    bool ok = false;
+    const int year = QInputDialog::getInt(this, tr("Archive Closed Year"),
+                                          tr("Year to move to its own archive file:"),
+                                          lastClosed, 2000, lastClosed, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    const QString path = m_database->archivePath(year);
+    if (QMessageBox::question(this, tr("Archive Closed Year"),
+                              tr("Move %1's transactions, fuel log and production runs to\n%2?\n\n"
+                                 "Reports still include them; archived rows can no longer be "
+                                 "edited or undone.").arg(year).arg(path))
+        != QMessageBox::Yes) {
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool archived = m_database->archiveYear(year);
+    QApplication::restoreOverrideCursor();
+
+    if (!archived) {
+        QMessageBox::warning(this, tr("Archive Closed Year"),
+                             tr("%1 was not archived:\n%2").arg(year).arg(m_database->lastError()));
+        return;
+    }
+    statusBar()->showMessage(tr("Archived %1 to %2").arg(year).arg(path), 5000);
+}
+
+void MainWindow::onRefreshReferenceData()
+{
+    QString startDir = QCoreApplication::applicationDirPath() + "/data";
+    if (!QDir(startDir).exists()) {
+        startDir = QDir::homePath();
+    }
+
+    QString dir = QFileDialog::getExistingDirectory(
+        this,
+        tr("Select Reference Data Directory"),
+        startDir,
+        QFileDialog::ShowDirsOnly
+        );
+
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    Frontier::ReferenceSources sources = Frontier::ReferenceSources::fromDirectory(dir);
+    if (sources.isEmpty()) {
+        QMessageBox::warning(this, tr("No Reference Data"),
+                             tr("The selected directory contains none of:\n"
+                                "- items.json\n"
+                                "- vehicles.json\n"
+                                "- workbenches.json or recipes.json\n"
+                                "- maps.json, location_types.json and locations.json\n"
+                                "- factory_buildings.json"));
+        return;
+    }
+
+    runImport(sources, tr("Refresh Reference Data"));
+}
+
+// =============================================================================
+// Background Import
+// =============================================================================
+
+void MainWindow::runImport(const Frontier::ReferenceSources &sources, const QString &title)
+{
+    if (m_importPipeline->isRunning()) {
+        QMessageBox::information(this, title, tr("An import is already running."));
+        return;
+    }
+    if (m_backup->isRunning()) {
+        QMessageBox::information(this, title, tr("A backup is running; import once it finishes."));
+        return;
+    }
+
+    // The snapshot is taken first: copying while the import writes would
+    // keep restarting it
+    if (QSettings("FrontierMining", "Tracker").value("Backup/beforeImport", true).toBool()) {
+        m_afterBackup = [this, sources, title]() { startImport(sources, title); };
+        startBackup(title);
+        return;
+    }
+    startImport(sources, title);
+}
+
+void MainWindow::startImport(const Frontier::ReferenceSources &sources, const QString &title)
+{
+    // Non-modal, so the rest of the window stays usable while files parse
+    m_importProgress = new QProgressDialog(tr("Reading reference files..."), tr("Cancel"), 0, 0, this);
+    m_importProgress->setWindowTitle(title);
+    m_importProgress->setWindowModality(Qt::NonModal);
+    m_importProgress->setMinimumDuration(0);
+    m_importProgress->setAutoClose(false);
+    m_importProgress->setAutoReset(false);
+    m_importProgress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(m_importProgress, &QProgressDialog::canceled,
+            m_importPipeline, &Frontier::ImportPipeline::cancel);
+    connect(m_importPipeline, &Frontier::ImportPipeline::progress, m_importProgress,
+            [dialog = m_importProgress](int done, int total, const QString &label) {
+                dialog->setMaximum(total);
+                dialog->setValue(done);
+                dialog->setLabelText(label);
+            });
+
+    m_importTitle = title;
+    setImportActionsEnabled(false);
+    m_importPipeline->start(sources);
+    m_importProgress->show();
+}
+
+void MainWindow::onImportFinished()
+{
+    if (m_importProgress) {
+        m_importProgress->close();       // Deletes itself
+        m_importProgress = nullptr;
+    }
+    setImportActionsEnabled(true);
+
+    QStringList lines;
+    bool allOk = true;
+    for (const Frontier::ImportStageResult &result : m_importPipeline->results()) {
+        lines.append(QString("%1 %2: %3")
+                         .arg(result.ok ? "•" : "✗")
+                         .arg(Frontier::referenceDataToString(result.data), result.summary));
+        allOk = allOk && result.ok;
+    }
+
+    if (m_backgroundImport) {
+        m_backgroundImport = false;
+        if (!allOk) {
+            qWarning() << "Reference reload failed:" << lines.join("; ");
+        }
+        statusBar()->showMessage(tr("Reference files reloaded: %1").arg(lines.join("; ")),
+                                 allOk ? 5000 : 15000);
+        if (m_pendingReload) {
+            const Frontier::ReferenceSources pending = *m_pendingReload;
+            m_pendingReload.reset();
+            startBackgroundReload(pending);
+        }
+        return;
+    }
+
+    // Files the user imported are the ones to watch from now on
+    if (!m_importPipeline->isCancelled() && allOk) {
+        m_referenceWatcher->mergeSources(m_importPipeline->sources());
+        saveWatchedSources();
+    }
+    if (m_pendingReload) {
+        const Frontier::ReferenceSources pending = *m_pendingReload;
+        m_pendingReload.reset();
+        startBackgroundReload(pending);
+    }
 
-    if (success) {
-        QMessageBox::information(this, tr("Import Complete"),
-                                 tr("Imported:\n"
-                                    "- %1 maps\n"
-                                    "- %2 location types\n"
-                                    "- %3 locations")
-                                     .arg(Frontier::LocationImporter::mapsImported())
-                                     .arg(Frontier::LocationImporter::typesImported())
-                                     .arg(Frontier::LocationImporter::locationsImported()));
+    if (m_importPipeline->isCancelled()) {
+        lines.prepend(tr("Import cancelled. Data sets already written were kept.\n"));
+    }
 
-        // Refresh the Data Hub if it's visible
-        // You may need to emit a signal or call refreshData() on the LocationsTab
+    if (allOk) {
+        QMessageBox::information(this, m_importTitle, lines.join("\n"));
     } else {
-        QMessageBox::warning(this, tr("Import Failed"),
-                             tr("Failed to import locations:\n%1")
-                                 .arg(Frontier::LocationImporter::lastError()));
+        QMessageBox::warning(this, m_importTitle, lines.join("\n"));
     }
+    statusBar()->showMessage(tr("%1 finished").arg(m_importTitle), 5000);
 }
 
-MainWindow::~MainWindow()
+void MainWindow::onReferenceFilesChanged(const Frontier::ReferenceSources &changed)
 {
-    delete ui;
+    startBackgroundReload(changed);
+}
+
+void MainWindow::startBackgroundReload(const Frontier::ReferenceSources &sources)
+{
+    // Merged so several edits during one run reload once, after it
+    if (m_importPipeline->isRunning() || m_backup->isRunning()) {
+        if (!m_pendingReload) {
+            m_pendingReload = std::make_unique<Frontier::ReferenceSources>();
+        }
+        m_pendingReload->merge(sources);
+        return;
+    }
+
+    // No backup first: the importers only write what differs, and each data
+    // set is one transaction. Each write invalidates its own cache (catalog,
+    // recipe graph, vehicles) and publishes its table, so only the views
+    // subscribed to it refresh.
+    m_backgroundImport = true;
+    m_importTitle = tr("Reload Reference Files");
+    setImportActionsEnabled(false);
+    statusBar()->showMessage(tr("Reference files changed; reloading..."));
+    if (!m_importPipeline->start(sources)) {
+        m_backgroundImport = false;
+        setImportActionsEnabled(true);
+    }
+}
+
+void MainWindow::saveWatchedSources()
+{
+    const Frontier::ReferenceSources watched = m_referenceWatcher->sources();
+    QSettings settings("FrontierMining", "Tracker");
+    settings.setValue("Reference/itemsJson", watched.itemsJson);
+    settings.setValue("Reference/vehiclesJson", watched.vehiclesJson);
+    settings.setValue("Reference/recipesJson", watched.recipesJson);
+    settings.setValue("Reference/locationsDir", watched.locationsDir);
+    settings.setValue("Reference/buildingsJson", watched.buildingsJson);
+}
+
+void MainWindow::startBackup(const QString &title)
+{
+    if (m_backup->isRunning()) {
+        return;
+    }
+
+    QSettings settings("FrontierMining", "Tracker");
+    const QString dbPath = m_database->databasePath();
+    Frontier::BackupOptions options;
+    options.directory = settings.value("Backup/directory",
+                                       QFileInfo(dbPath).dir().filePath("backups")).toString();
+    options.keep = settings.value("Backup/keep", options.keep).toInt();
+    options.compress = settings.value("Backup/compress", options.compress).toBool();
+
+    // Edits still queued belong in the snapshot
+    m_database->flushPendingWrites();
+    if (!m_backup->start(dbPath, options)) {
+        QMessageBox::warning(this, title, tr("The backup could not be started."));
+        m_afterBackup = nullptr;
+        return;
+    }
+
+    m_backupProgress = new QProgressDialog(tr("Backing up database..."), tr("Cancel"), 0, 0, this);
+    m_backupProgress->setWindowTitle(title);
+    m_backupProgress->setWindowModality(Qt::NonModal);
+    m_backupProgress->setMinimumDuration(500);
+    m_backupProgress->setAutoClose(false);
+    m_backupProgress->setAutoReset(false);
+    m_backupProgress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(m_backupProgress, &QProgressDialog::canceled, m_backup, &Frontier::OnlineBackup::cancel);
+    connect(m_backup, &Frontier::OnlineBackup::progress, m_backupProgress,
+            [dialog = m_backupProgress](int done, int total) {
+                dialog->setMaximum(total);
+                dialog->setValue(done);
+            });
+    setImportActionsEnabled(false);
+}
+
+void MainWindow::onBackupFinished(const Frontier::BackupResult &result)
+{
+    if (m_backupProgress) {
+        m_backupProgress->close();       // Deletes itself
+        m_backupProgress = nullptr;
+    }
+    setImportActionsEnabled(true);
+
+    // A reload that waited for the backup runs once the import it gated,
+    // if any, has started (and then waits for that instead)
+    if (m_pendingReload) {
+        QTimer::singleShot(0, this, [this]() {
+            if (m_pendingReload) {
+                const Frontier::ReferenceSources pending = *m_pendingReload;
+                m_pendingReload.reset();
+                startBackgroundReload(pending);
+            }
+        });
+    }
+
+    std::function<void()> next = std::exchange(m_afterBackup, nullptr);
+    if (result.ok) {
+        statusBar()->showMessage(tr("Backed up to %1").arg(result.path), 5000);
+    } else if (result.cancelled) {
+        statusBar()->showMessage(tr("Backup cancelled"), 5000);
+        return;
+    } else if (!next) {
+        QMessageBox::warning(this, tr("Back Up Database"), tr("Backup failed:\n%1").arg(result.error));
+        return;
+    } else if (QMessageBox::question(this, tr("Backup Failed"),
+                                     tr("Backup failed:\n%1\n\nContinue without a backup?")
+                                         .arg(result.error))
+               != QMessageBox::Yes) {
+        return;
+    }
+
+    if (next) {
+        next();
+    }
+}
+
+void MainWindow::rebuildProfileMenu()
+{
+    m_profileMenu->clear();
+    const QString current = Frontier::ProfileRegistry::current().name;
+    auto *group = new QActionGroup(m_profileMenu);
+    for (const Frontier::TrackerProfile &profile : Frontier::ProfileRegistry::profiles()) {
+        QAction *action = m_profileMenu->addAction(profile.name);
+        action->setCheckable(true);
+        action->setChecked(profile.name == current);
+        action->setStatusTip(QString("Switch to %1 (%2)").arg(profile.name, profile.databasePath));
+        group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, name = profile.name]() {
+            switchProfile(name);
+        });
+    }
+
+    m_profileMenu->addSeparator();
+    QAction *newAction = m_profileMenu->addAction("&New Profile...");
+    newAction->setStatusTip("Start a profile with its own ledger, fleet and logs; "
+                            "reference data is shared");
+    connect(newAction, &QAction::triggered, this, &MainWindow::onNewProfile);
+
+    QAction *removeAction = m_profileMenu->addAction("&Remove Profile...");
+    removeAction->setStatusTip("Take a profile off this list; its database file is kept");
+    removeAction->setEnabled(Frontier::ProfileRegistry::profiles().size() > 1);
+    connect(removeAction, &QAction::triggered, this, &MainWindow::onRemoveProfile);
+}
+
+void MainWindow::switchProfile(const QString &name)
+{
+    // The menu is rebuilt once its action has returned; it may be the sender
+    const std::optional<Frontier::TrackerProfile> profile = Frontier::ProfileRegistry::find(name);
+    if (!profile || profile->databasePath == m_database->databasePath()) {
+        QTimer::singleShot(0, this, &MainWindow::rebuildProfileMenu);
+        return;
+    }
+
+    // Each of these is partway through work on the open file
+    if (m_importPipeline->isRunning() || m_backup->isRunning() || m_exporter->isRunning()) {
+        QMessageBox::information(this, tr("Switch Profile"),
+                                 tr("Wait for the running import, backup or export to finish "
+                                    "before switching profiles."));
+        QTimer::singleShot(0, this, &MainWindow::rebuildProfileMenu);
+        return;
+    }
+
+    // Edits queued in the open file are written by close() before it goes
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool switched = m_database->switchTo(profile->databasePath);
+    QApplication::restoreOverrideCursor();
+    if (!switched) {
+        QMessageBox::warning(this, tr("Switch Profile"),
+                             tr("Could not open %1:\n%2").arg(profile->databasePath,
+                                                               m_database->lastError()));
+        QTimer::singleShot(0, this, &MainWindow::rebuildProfileMenu);
+        return;
+    }
+
+    Frontier::ProfileRegistry::setCurrent(profile->name);
+    QTimer::singleShot(0, this, &MainWindow::rebuildProfileMenu);
+    updateWindowTitle();
+    updateUndoActions();
+    statusBar()->showMessage(tr("Switched to profile %1").arg(profile->name), 5000);
+    checkBuiltInCatalog();
+}
+
+void MainWindow::onNewProfile()
+{
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("New Profile"),
+                                               tr("Name of the map or playthrough:"),
+                                               QLineEdit::Normal, QString(), &ok);
+    if (!ok) {
+        return;
+    }
+
+    QString error;
+    const std::optional<Frontier::TrackerProfile> profile = Frontier::ProfileRegistry::add(name, &error);
+    if (!profile) {
+        QMessageBox::warning(this, tr("New Profile"), error);
+        return;
+    }
+    switchProfile(profile->name);
+}
+
+void MainWindow::onRemoveProfile()
+{
+    const QString current = Frontier::ProfileRegistry::current().name;
+    QStringList names;
+    for (const Frontier::TrackerProfile &profile : Frontier::ProfileRegistry::profiles()) {
+        if (profile.name != Frontier::ProfileRegistry::DefaultName && profile.name != current) {
+            names << profile.name;
+        }
+    }
+    if (names.isEmpty()) {
+        QMessageBox::information(this, tr("Remove Profile"),
+                                 tr("Switch to another profile to remove this one; "
+                                    "the default profile cannot be removed."));
+        return;
+    }
+
+    bool ok = false;
+    const QString name = QInputDialog::getItem(this, tr("Remove Profile"),
+                                               tr("Profile to take off the list "
+                                                  "(its database file is kept):"),
+                                               names, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    Frontier::ProfileRegistry::remove(name);
+    QTimer::singleShot(0, this, &MainWindow::rebuildProfileMenu);
+}
+
+void MainWindow::checkBuiltInCatalog()
+{
+#ifdef FRONTIER_EMBEDDED_CATALOG
+    const Frontier::EmbeddedCatalogData &data = Frontier::defaultCatalogData();
+    const auto seeded = Frontier::EmbeddedCatalog::seedEmpty(data, m_database);
+    if (seeded && seeded->seededAnything()) {
+        qDebug() << "Seeded built-in reference data:" << seeded->items << "items,"
+                 << seeded->vehicles << "vehicles," << seeded->buildings << "buildings";
+    }
+
+    const QStringList drifted = Frontier::EmbeddedCatalog::drift(data, m_database);
+    if (!drifted.isEmpty()) {
+        statusBar()->showMessage(tr("Built-in reference data differs from what this file was "
+                                    "seeded with (%1); File > Import > Refresh All Reference "
+                                    "Data applies it").arg(drifted.join(", ")), 15000);
+    }
+#endif
+}
+
+void MainWindow::updateWindowTitle()
+{
+    const QString profile = Frontier::ProfileRegistry::current().name;
+    setWindowTitle(profile == Frontier::ProfileRegistry::DefaultName
+                       ? QString("Frontier Mining Tracker")
+                       : QString("Frontier Mining Tracker - %1").arg(profile));
+}
+
+void MainWindow::exportTable(Frontier::DataTable table)
+{
+    const QString label = Frontier::DataExporter::tableLabel(table);
+    if (m_exporter->isRunning()) {
+        QMessageBox::information(this, tr("Export %1").arg(label), tr("An export is already running."));
+        return;
+    }
+
+    QString selectedFilter;
+    const QString defaultName = QDir::home().filePath(label.toLower().replace(' ', '_') + ".csv");
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export %1").arg(label), defaultName,
+                                                      tr("CSV Files (*.csv);;JSON Files (*.json)"),
+                                                      &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    Frontier::ExportRequest request;
+    request.table = table;
+    request.path = path;
+    request.format = (path.endsWith(".json", Qt::CaseInsensitive) || selectedFilter.contains("json"))
+                         ? Frontier::ExportFormat::Json : Frontier::ExportFormat::Csv;
+
+    // Edits still queued belong in the file
+    m_database->flushPendingWrites();
+    if (!m_exporter->start(request)) {
+        return;
+    }
+
+    auto *dialog = new QProgressDialog(tr("Exporting %1...").arg(label), tr("Cancel"), 0, 0, this);
+    dialog->setWindowTitle(tr("Export %1").arg(label));
+    dialog->setWindowModality(Qt::NonModal);
+    dialog->setMinimumDuration(500);
+    dialog->setAutoClose(false);
+    dialog->setAutoReset(false);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    connect(dialog, &QProgressDialog::canceled, m_exporter, &Frontier::DataExporter::cancel);
+    // Row counts can pass int; the bar works in thousandths
+    connect(m_exporter, &Frontier::DataExporter::progress, dialog, [dialog](qint64 rows, qint64 total) {
+        dialog->setMaximum(1000);
+        dialog->setValue(total > 0 ? int(rows * 1000 / total) : 0);
+        dialog->setLabelText(tr("Exported %L1 of %L2 rows").arg(rows).arg(total));
+    });
+    connect(m_exporter, &Frontier::DataExporter::finished, dialog, &QProgressDialog::close);
+}
+
+void MainWindow::onExportFinished(const Frontier::ExportResult &result)
+{
+    if (result.ok) {
+        statusBar()->showMessage(tr("Exported %L1 rows to %2").arg(result.rows).arg(result.path), 5000);
+    } else if (!result.cancelled) {
+        QMessageBox::warning(this, tr("Export Failed"),
+                             tr("Could not export to %1:\n%2").arg(result.path, result.error));
+    }
+}
+
+void MainWindow::setImportActionsEnabled(bool enabled)
+{
+    m_importItemsAction->setEnabled(enabled);
+    m_importVehiclesAction->setEnabled(enabled);
+    m_importRecipesAction->setEnabled(enabled);
+    m_importLocationsAction->setEnabled(enabled);
+    m_refreshReferenceAction->setEnabled(enabled);
 }
@@ -4,6 +4,10 @@
 #include <QMainWindow>
 #include <QTabWidget>
 #include <QLabel>
+#include <QElapsedTimer>
+#include <QVector>
+#include <functional>
+#include <memory>
 
 #include "core/database.h"
 #include "core/operationsmanager.h"
@@ -14,6 +18,18 @@ QT_END_NAMESPACE
 
 class DataHubWidget;
 class DashboardWidget;
+class QProgressDialog;
+
+namespace Frontier {
+class ImportPipeline;
+class ReferenceWatcher;
+class OverlayServer;
+class OnlineBackup;
+struct BackupResult;
+class DataExporter;
+struct ExportResult;
+struct ReferenceSources;
+}
 
 class MainWindow : public QMainWindow
 {
@@ -28,8 +44,42 @@ private slots:
     void onImportVehicles();
     void onImportRecipes();
     void onImportLocations();
+    void onRefreshReferenceData();
+    void onArchiveYear();
+    void onImportFinished();
+    void onReferenceFilesChanged(const Frontier::ReferenceSources &changed);
 
 private:
+    // Adds a placeholder page whose widget is built on first activation
+    void addLazyTab(const QIcon &icon, const QString &label, std::function<QWidget *()> factory);
+    void ensureTabBuilt(int index);
+    void updateUndoActions();
+
+    // Runs an import on the pipeline behind a cancellable progress dialog,
+    // after a backup when Backup/beforeImport is set (the default)
+    void runImport(const Frontier::ReferenceSources &sources, const QString &title);
+    void startImport(const Frontier::ReferenceSources &sources, const QString &title);
+    void startBackup(const QString &title);
+    void onBackupFinished(const Frontier::BackupResult &result);
+    void setImportActionsEnabled(bool enabled);
+    // Reimports edited reference files with no dialog; queued behind a running import
+    void startBackgroundReload(const Frontier::ReferenceSources &sources);
+    void saveWatchedSources();
+
+    // File > Profile: one database file per map or playthrough, switched in place
+    void rebuildProfileMenu();
+    void switchProfile(const QString &name);
+    void onNewProfile();
+    void onRemoveProfile();
+    void updateWindowTitle();
+    // Seeds empty reference tables from the built-in catalog and reports
+    // data sets seeded by a build with different data
+    void checkBuiltInCatalog();
+
+    // Streams one table to a CSV or JSON file in the background
+    void exportTable(Frontier::DataTable table);
+    void onExportFinished(const Frontier::ExportResult &result);
+
     Ui::MainWindow *ui;
 
     // Dashboard
@@ -43,6 +93,8 @@ private:
 
     // Tab widget
     QTabWidget *m_tabWidget;
+    QVector<std::function<QWidget *()>> m_pendingTabs;   // Per tab index; empty once built
+    QElapsedTimer m_startupTimer;
 
     // Data Hub reference for refresh
     DataHubWidget *m_dataHubWidget;
@@ -51,11 +103,40 @@ private:
     QLabel *m_dayLabel;
     QLabel *m_balanceLabel;
 
+    // Edit actions, driven by the database's command journal
+    QAction *m_undoAction;
+    QAction *m_redoAction;
+
+    // Profile submenu; rebuilt when profiles are added or removed
+    QMenu *m_profileMenu;
+
     // Import actions
     QAction *m_importItemsAction;
     QAction *m_importVehiclesAction;
     QAction *m_importRecipesAction;
     QAction *m_importLocationsAction;
+    QAction *m_refreshReferenceAction;
+
+    // Background import
+    Frontier::ImportPipeline *m_importPipeline;
+    QProgressDialog *m_importProgress = nullptr;
+    QString m_importTitle;
+
+    // Reference files last imported, reimported when edited
+    Frontier::ReferenceWatcher *m_referenceWatcher;
+    bool m_backgroundImport = false;
+    std::unique_ptr<Frontier::ReferenceSources> m_pendingReload;
+
+    // In-game overlay endpoint (View > Overlay Endpoint)
+    Frontier::OverlayServer *m_overlayServer;
+
+    // Online backup; m_afterBackup runs when it succeeds (the import it gates)
+    Frontier::OnlineBackup *m_backup;
+    QProgressDialog *m_backupProgress = nullptr;
+    std::function<void()> m_afterBackup;
+
+    // Background table export (File > Export)
+    Frontier::DataExporter *m_exporter;
 };
 
 #endif // MAINWINDOW_H
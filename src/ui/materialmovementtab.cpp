@@ -4,6 +4,7 @@
  */
 
 #include "materialmovementtab.h"
+#include "sessionhistorymodel.h"
 #include "core/unitconverter.h"
 
 #include <QVBoxLayout>
@@ -36,6 +37,8 @@ MaterialMovementTab::MaterialMovementTab(Frontier::OperationsManager *manager,
             this, &MaterialMovementTab::onSessionEnded);
     connect(m_manager, &Frontier::OperationsManager::equipmentUsageUpdated,
             this, &MaterialMovementTab::onEquipmentUsageUpdated);
+    connect(m_manager, &Frontier::OperationsManager::movementEventsCaptured,
+            this, &MaterialMovementTab::onMovementEventsCaptured);
 }
 
 MaterialMovementTab::~MaterialMovementTab()
@@ -102,6 +105,9 @@ QWidget* MaterialMovementTab::createSessionHeaderPanel()
     QLabel *historyLabel = new QLabel("Load Session:");
     m_sessionHistoryCombo = new QComboBox();
     m_sessionHistoryCombo->setMinimumWidth(200);
+    m_sessionHistoryModel = new SessionHistoryModel(m_manager, this);
+    m_sessionHistoryModel->setUnitSystem(m_manager->unitSystem());
+    m_sessionHistoryCombo->setModel(m_sessionHistoryModel);
     QPushButton *loadButton = new QPushButton("Load");
     connect(loadButton, &QPushButton::clicked, this, &MaterialMovementTab::onLoadSessionClicked);
 
@@ -110,6 +116,18 @@ QWidget* MaterialMovementTab::createSessionHeaderPanel()
     historyLayout->addWidget(loadButton);
     layout->addLayout(historyLayout);
 
+    // Narrows the history by map name, notes or "#id"
+    m_sessionSearchEdit = new QLineEdit();
+    m_sessionSearchEdit->setPlaceholderText("Search sessions by map, notes or #id...");
+    m_sessionSearchEdit->setClearButtonEnabled(true);
+    layout->addWidget(m_sessionSearchEdit);
+
+    m_sessionSearchDebounce = new QTimer(this);
+    m_sessionSearchDebounce->setSingleShot(true);
+    m_sessionSearchDebounce->setInterval(250);
+    connect(m_sessionSearchDebounce, &QTimer::timeout, this, &MaterialMovementTab::onSessionSearchChanged);
+    connect(m_sessionSearchEdit, &QLineEdit::textChanged, m_sessionSearchDebounce, qOverload<>(&QTimer::start));
+
     // Separator
     QFrame *line = new QFrame();
     line->setFrameShape(QFrame::HLine);
@@ -252,11 +270,51 @@ QWidget* MaterialMovementTab::createEquipmentUsagePanel()
     buttonLayout->addWidget(m_deleteUsageButton);
 
     layout->addLayout(buttonLayout);
+    layout->addWidget(createLiveCapturePanel());
     layout->addStretch();
 
     return group;
 }
 
+QWidget* MaterialMovementTab::createLiveCapturePanel()
+{
+    QGroupBox *group = new QGroupBox("Live Capture");
+    QVBoxLayout *layout = new QVBoxLayout(group);
+
+    m_captureCheckBox = new QCheckBox("Record buckets and dumps from hotkeys");
+    m_captureCheckBox->setChecked(m_manager->isLiveCaptureEnabled());
+    connect(m_captureCheckBox, &QCheckBox::toggled,
+            this, &MaterialMovementTab::onCaptureToggled);
+    layout->addWidget(m_captureCheckBox);
+
+    QLabel *helpLabel = new QLabel(QString("Ctrl+1 to Ctrl+%1 record a bucket (loaders) or a dump "
+                                           "(haulers) for that row of the usage table, from any "
+                                           "window of the app. Add a machine with a count of 0 "
+                                           "to give it a key.").arg(CaptureSlots));
+    helpLabel->setWordWrap(true);
+    helpLabel->setStyleSheet("color: gray;");
+    layout->addWidget(helpLabel);
+
+    m_captureStatusLabel = new QLabel();
+    layout->addWidget(m_captureStatusLabel);
+
+    // Application-wide, so the keys work while another tab has focus
+    for (int slot = 0; slot < CaptureSlots; ++slot) {
+        QShortcut *shortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key(Qt::Key_1 + slot)), this);
+        shortcut->setContext(Qt::ApplicationShortcut);
+        shortcut->setEnabled(false);
+        connect(shortcut, &QShortcut::activated, this, [this, slot]() { onCaptureShortcut(slot); });
+        m_captureShortcuts.append(shortcut);
+    }
+
+    // A failing write gets no usage update, so it is reported on its own
+    connect(m_manager->movementCapture(), &Frontier::MovementCapture::writeFailed,
+            this, &MaterialMovementTab::updateCaptureStatus);
+
+    updateCaptureStatus();
+    return group;
+}
+
 QWidget* MaterialMovementTab::createSessionSummaryPanel()
 {
     QGroupBox *group = new QGroupBox("Session Summary");
@@ -323,23 +381,10 @@ void MaterialMovementTab::loadEquipmentCombo()
 
 void MaterialMovementTab::loadSessionHistory()
 {
-    m_sessionHistoryCombo->clear();
-    m_sessionHistoryCombo->addItem("-- Select Session --", -1);
-
-    auto sessions = m_manager->getAllSessions();
-    for (const auto &session : sessions) {
-        QString status = session.endTime.isValid() ? "Closed" : "Active";
-        QString text = QString("#%1 - %2 [%3]")
-                           .arg(session.id.value())
-                           .arg(session.startTime.toString("yyyy-MM-dd hh:mm"))
-                           .arg(status);
-
-        if (!session.mapName.isEmpty()) {
-            text += QString(" - %1").arg(session.mapName);
-        }
-
-        m_sessionHistoryCombo->addItem(text, session.id.value());
-    }
+    // One page with its totals; the popup reads further pages as it scrolls
+    const int selectedId = m_sessionHistoryCombo->currentData().toInt();
+    m_sessionHistoryModel->reload();
+    m_sessionHistoryCombo->setCurrentIndex(qMax(0, m_sessionHistoryModel->rowOfId(selectedId)));
 }
 
 void MaterialMovementTab::loadSession(int sessionId)
@@ -375,10 +420,11 @@ void MaterialMovementTab::loadEquipmentUsage()
     Frontier::UnitSystem units = m_manager->unitSystem();
 
     m_usageModel->clear();
+    m_activityTotal = 0;
 
     // Set headers
     QStringList headers;
-    headers << "Equipment" << "Role" << "Count" << "Volume" << "Hours" << "Est. Fuel";
+    headers << "Equipment" << "Role" << "Count" << "Volume" << "Hours" << "Est. Fuel" << "Hotkey";
     m_usageModel->setHorizontalHeaderLabels(headers);
 
     if (!m_currentSessionId.has_value()) {
@@ -392,12 +438,12 @@ void MaterialMovementTab::loadEquipmentUsage()
 
         // Equipment name
         QString equipName = usage.equipmentId;
-        auto vehicle = m_manager->getVehicle(usage.equipmentId);
-        if (vehicle.has_value()) {
+        const Frontier::Vehicle *vehicle = m_manager->findVehicle(usage.equipmentId);
+        if (vehicle) {
             equipName = vehicle->name;
         }
         QStandardItem *equipItem = new QStandardItem(equipName);
-        equipItem->setData(usage.id.value(), Qt::UserRole);  // Store usage ID
+        equipItem->setData(usage.id.value_or(0), Qt::UserRole);  // Store usage ID; 0 until a live tally is saved
         equipItem->setData(usage.equipmentId, Qt::UserRole + 1);  // Store equipment ID
         row << equipItem;
 
@@ -407,6 +453,7 @@ void MaterialMovementTab::loadEquipmentUsage()
 
         // Count (buckets or dumps)
         int count = (usage.role == "HaulTruck") ? usage.dumps : usage.buckets;
+        m_activityTotal += count;
         QString countLabel = (usage.role == "HaulTruck") ?
                                  QString("%1 dumps").arg(count) : QString("%1 buckets").arg(count);
         QStandardItem *countItem = new QStandardItem(countLabel);
@@ -428,6 +475,10 @@ void MaterialMovementTab::loadEquipmentUsage()
         fuelItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
         row << fuelItem;
 
+        // Live capture key for the first rows
+        const int slot = m_usageModel->rowCount();
+        row << new QStandardItem(slot < CaptureSlots ? QString("Ctrl+%1").arg(slot + 1) : QString());
+
         m_usageModel->appendRow(row);
     }
 
@@ -521,31 +572,15 @@ void MaterialMovementTab::updateSummary()
         return;
     }
 
-    auto usages = m_manager->getEquipmentUsageForSession(m_currentSessionId.value());
-
-    double totalVolumeM3 = 0;
-    double truckVolumeM3 = 0;
-    double loaderVolumeM3 = 0;
-    double totalHours = 0;
-    double totalFuelL = 0;
+    // Totalled in SQL with the vehicle capacities joined in
+    const Frontier::MovementSessionSummary summary =
+        m_manager->getSessionSummary(m_currentSessionId.value()).value_or(Frontier::MovementSessionSummary());
 
-    for (const auto &usage : usages) {
-        totalVolumeM3 += usage.volumeM3;
-        totalHours += usage.hoursUsed;
-        totalFuelL += usage.estimatedFuelL;
-
-        if (usage.role == "HaulTruck") {
-            truckVolumeM3 += usage.volumeM3;
-        } else {
-            loaderVolumeM3 += usage.volumeM3;
-        }
-    }
-
-    m_totalVolumeLabel->setText(UC::formatVolume(totalVolumeM3, units));
-    m_truckVolumeLabel->setText(UC::formatVolume(truckVolumeM3, units));
-    m_loaderVolumeLabel->setText(UC::formatVolume(loaderVolumeM3, units));
-    m_totalHoursLabel->setText(QString("%1 hrs").arg(totalHours, 0, 'f', 2));
-    m_totalFuelLabel->setText(UC::formatFuel(totalFuelL, units));
+    m_totalVolumeLabel->setText(UC::formatVolume(summary.totalVolumeM3(), units));
+    m_truckVolumeLabel->setText(UC::formatVolume(summary.truckVolumeM3, units));
+    m_loaderVolumeLabel->setText(UC::formatVolume(summary.loaderVolumeM3, units));
+    m_totalHoursLabel->setText(QString("%1 hrs").arg(summary.hours, 0, 'f', 2));
+    m_totalFuelLabel->setText(UC::formatFuel(summary.fuelL, units));
 }
 
 void MaterialMovementTab::updateSessionControls()
@@ -570,6 +605,35 @@ void MaterialMovementTab::updateSessionControls()
 
     // Fuel log generation
     m_generateFuelLogButton->setEnabled(hasSession && !sessionActive);
+
+    // Live capture records into the active session only
+    const bool capturing = sessionActive && m_captureCheckBox->isChecked()
+                           && m_manager->activeSessionId() == m_currentSessionId;
+    for (QShortcut *shortcut : m_captureShortcuts) {
+        shortcut->setEnabled(capturing);
+    }
+    updateCaptureStatus();
+}
+
+void MaterialMovementTab::updateCaptureStatus()
+{
+    if (!m_captureCheckBox->isChecked()) {
+        m_captureStatusLabel->setText("Off");
+        m_captureStatusLabel->setStyleSheet(QString());
+        return;
+    }
+
+    const Frontier::MovementCapture *capture = m_manager->movementCapture();
+    QString text = QString("%1 buckets and dumps this session, %2 waiting to be written")
+                       .arg(m_activityTotal).arg(capture->pendingCount());
+    if (capture->droppedCount() > 0) {
+        text += QString(", %1 dropped").arg(capture->droppedCount());
+    }
+    if (!capture->lastError().isEmpty()) {
+        text += QString("\nEvents are not being saved: %1").arg(capture->lastError());
+    }
+    m_captureStatusLabel->setText(text);
+    m_captureStatusLabel->setStyleSheet(capture->lastError().isEmpty() ? QString() : QString("color: #f44336;"));
 }
 
 void MaterialMovementTab::clearSession()
@@ -582,6 +646,7 @@ void MaterialMovementTab::clearSession()
     m_sessionNotesEdit->clear();
 
     m_usageModel->clear();
+    m_activityTotal = 0;
 
     updateSessionControls();
     updateSummary();
@@ -665,6 +730,11 @@ void MaterialMovementTab::onLoadSessionClicked()
     loadSession(sessionId);
 }
 
+void MaterialMovementTab::onSessionSearchChanged()
+{
+    m_sessionHistoryModel->setSearch(m_sessionSearchEdit->text());
+}
+
 void MaterialMovementTab::onEquipmentChanged(int index)
 {
     Q_UNUSED(index);
@@ -690,8 +760,9 @@ void MaterialMovementTab::onAddUpdateUsageClicked()
         return;
     }
 
+    // A zero count is allowed while capturing, to give the machine a hotkey
     int count = m_activitySpinBox->value();
-    if (count == 0) {
+    if (count == 0 && !m_captureCheckBox->isChecked()) {
         QMessageBox::warning(this, "Error", "Please enter a count greater than 0.");
         return;
     }
@@ -775,9 +846,32 @@ void MaterialMovementTab::onUsageSelectionChanged()
     }
 }
 
+void MaterialMovementTab::onCaptureToggled(bool enabled)
+{
+    m_manager->setLiveCaptureEnabled(enabled);
+    updateSessionControls();
+}
+
+void MaterialMovementTab::onCaptureShortcut(int slot)
+{
+    if (slot >= m_usageModel->rowCount()) return;
+
+    // Queued without touching the database; the table follows on the next drain
+    QString equipmentId = m_usageModel->item(slot, 0)->data(Qt::UserRole + 1).toString();
+    m_manager->recordMovementEvent(equipmentId);
+}
+
+void MaterialMovementTab::onMovementEventsCaptured(int sessionId)
+{
+    if (!m_currentSessionId.has_value() || m_currentSessionId.value() != sessionId) return;
+
+    loadEquipmentUsage();
+    updateCaptureStatus();
+}
+
 void MaterialMovementTab::onUnitSystemChanged(Frontier::UnitSystem system)
 {
-    Q_UNUSED(system);
+    m_sessionHistoryModel->setUnitSystem(system);
     loadEquipmentUsage();
     updateEquipmentInfo();
     updateSummary();
@@ -800,7 +894,11 @@ void MaterialMovementTab::onEquipmentUsageUpdated(int sessionId)
     if (m_currentSessionId.has_value() && m_currentSessionId.value() == sessionId) {
         loadEquipmentUsage();
         updateSummary();
+        updateCaptureStatus();
     }
+
+    // The history shows each session's volume
+    loadSessionHistory();
 }
 
 void MaterialMovementTab::onGenerateFuelLogClicked()
@@ -18,9 +18,15 @@
 #include <QDoubleSpinBox>
 #include <QDateTimeEdit>
 #include <QGroupBox>
+#include <QCheckBox>
+#include <QShortcut>
+#include <QTimer>
+#include <QVector>
 
 #include "core/operationsmanager.h"
 
+class SessionHistoryModel;
+
 class MaterialMovementTab : public QWidget
 {
     Q_OBJECT
@@ -36,6 +42,7 @@ private slots:
     void onEndSessionClicked();
     void onSaveSessionClicked();
     void onLoadSessionClicked();
+    void onSessionSearchChanged();
 
     // Equipment usage
     void onEquipmentChanged(int index);
@@ -44,11 +51,16 @@ private slots:
     void onDeleteUsageClicked();
     void onUsageSelectionChanged();
 
+    // Live capture
+    void onCaptureToggled(bool enabled);
+    void onCaptureShortcut(int slot);
+
     // Manager signals
     void onUnitSystemChanged(Frontier::UnitSystem system);
     void onSessionStarted(int sessionId);
     void onSessionEnded(int sessionId);
     void onEquipmentUsageUpdated(int sessionId);
+    void onMovementEventsCaptured(int sessionId);
 
     // Other
     void onGenerateFuelLogClicked();
@@ -58,6 +70,7 @@ private:
     QWidget* createSessionHeaderPanel();
     QWidget* createEquipmentUsagePanel();
     QWidget* createSessionSummaryPanel();
+    QWidget* createLiveCapturePanel();
 
     void loadEquipmentCombo();
     void loadSessionHistory();
@@ -67,6 +80,7 @@ private:
     void updateCalculatedValues();
     void updateSummary();
     void updateSessionControls();
+    void updateCaptureStatus();
     void clearSession();
     void clearUsageForm();
 
@@ -75,6 +89,9 @@ private:
 
     // Session Header widgets
     QComboBox *m_sessionHistoryCombo;
+    SessionHistoryModel *m_sessionHistoryModel;
+    QLineEdit *m_sessionSearchEdit;
+    QTimer *m_sessionSearchDebounce;
     QLabel *m_sessionIdLabel;
     QLineEdit *m_mapNameEdit;
     QDateTimeEdit *m_startTimeEdit;
@@ -100,6 +117,13 @@ private:
     // Track current role for the selected equipment
     QString m_currentRole;
 
+    // Live Capture widgets; Ctrl+1..9 record for the usage table's first rows
+    static constexpr int CaptureSlots = 9;
+    QCheckBox *m_captureCheckBox;
+    QLabel *m_captureStatusLabel;
+    QVector<QShortcut*> m_captureShortcuts;
+    int m_activityTotal = 0;       // Buckets and dumps in the usage table
+
     // Usage Table
     QTableView *m_usageTableView;
     QStandardItemModel *m_usageModel;
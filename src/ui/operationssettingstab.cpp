@@ -167,6 +167,24 @@ void OperationsSettingsTab::setupUi()
 
     mainLayout->addWidget(defaultsGroup);
 
+    // === Database Performance ===
+    QGroupBox *storageGroup = new QGroupBox("Database Performance");
+    QFormLayout *storageLayout = new QFormLayout(storageGroup);
+
+    m_storageProfileCombo = new QComboBox();
+    m_storageProfileCombo->addItem("Safe (full sync on every save)",
+                                   static_cast<int>(Frontier::StorageProfile::Safe));
+    m_storageProfileCombo->addItem("Balanced (recommended)",
+                                   static_cast<int>(Frontier::StorageProfile::Balanced));
+    m_storageProfileCombo->addItem("Fast (may lose recent changes on power loss)",
+                                   static_cast<int>(Frontier::StorageProfile::Fast));
+    m_storageProfileCombo->setToolTip("Safe: rollback journal, synchronous=FULL\n"
+                                      "Balanced: WAL journal, synchronous=NORMAL, 16 MB cache, 64 MB mmap\n"
+                                      "Fast: WAL journal, synchronous=OFF, 64 MB cache, 256 MB mmap");
+    storageLayout->addRow("Storage Profile:", m_storageProfileCombo);
+
+    mainLayout->addWidget(storageGroup);
+
     // === Buttons ===
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     buttonLayout->addStretch();
@@ -218,6 +236,13 @@ void OperationsSettingsTab::loadSettings()
 
     settings.endGroup();
 
+    // Storage profile
+    int profileIndex = m_storageProfileCombo->findData(
+        static_cast<int>(m_manager->database()->storageProfile()));
+    if (profileIndex >= 0) {
+        m_storageProfileCombo->setCurrentIndex(profileIndex);
+    }
+
     // Update preview
     onUnitSystemChanged(m_unitSystemCombo->currentIndex());
 }
@@ -265,6 +290,17 @@ void OperationsSettingsTab::onSaveSettings()
 
     settings.endGroup();
 
+    // Save and apply storage profile
+    auto profile = static_cast<Frontier::StorageProfile>(m_storageProfileCombo->currentData().toInt());
+    Frontier::Database::saveStorageProfile(profile);
+    if (profile != m_manager->database()->storageProfile()
+        && !m_manager->database()->applyStorageProfile(profile)) {
+        QMessageBox::warning(this, "Storage Profile",
+                             "The storage profile was saved but could not be applied now:\n"
+                             + m_manager->database()->lastError()
+                             + "\n\nIt will take effect the next time the application starts.");
+    }
+
     QMessageBox::information(this, "Settings Saved",
                              "Operations settings have been saved.");
 }
@@ -278,6 +314,8 @@ void OperationsSettingsTab::onResetDefaults()
     m_defaultMapEdit->clear();
     m_autoEndSessionCheckbox->setChecked(true);
     m_autoGenerateFuelLogCheckbox->setChecked(false);
+    m_storageProfileCombo->setCurrentIndex(
+        m_storageProfileCombo->findData(static_cast<int>(Frontier::StorageProfile::Balanced)));
 
     onSaveSettings();
 }
@@ -53,6 +53,9 @@ private:
     QCheckBox *m_autoEndSessionCheckbox;
     QCheckBox *m_autoGenerateFuelLogCheckbox;
 
+    // Database
+    QComboBox *m_storageProfileCombo;
+
     // Buttons
     QPushButton *m_saveButton;
     QPushButton *m_resetButton;
@@ -12,6 +12,7 @@
 #include "productiontab.h"
 #include "shiftlogtab.h"
 #include "cycletimetab.h"
+#include "fleetsizingtab.h"
 
 #include <QVBoxLayout>
 #include <QLabel>
@@ -59,6 +60,9 @@ void OperationsWidget::setupUi()
     m_cycleTimeTab = new CycleTimeTab(m_manager->database(), this);
     m_subTabs->addTab(m_cycleTimeTab, "Cycle Time");
 
+    // Fleet Sizing (from cycle profiles and vehicle specs)
+    m_subTabs->addTab(new FleetSizingTab(m_manager, this), "Fleet Sizing");
+
     // Operations Settings
     m_subTabs->addTab(new OperationsSettingsTab(m_manager, this), "Settings");
 
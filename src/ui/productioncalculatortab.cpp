@@ -5,7 +5,10 @@
 
 #include "productioncalculatortab.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
 #include "inventorytab.h"
+#include "productiontreemodel.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -13,6 +16,9 @@
 #include <QHeaderView>
 #include <QFrame>
 #include <QMessageBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTableWidget>
 
 // =============================================================================
 // Constructor & Setup
@@ -45,22 +51,20 @@ void ProductionCalculatorTab::setupUi()
     auto *treeGroup = new QGroupBox(tr("Material Requirements"));
     auto *treeLayout = new QVBoxLayout(treeGroup);
 
-    m_treeWidget = new QTreeWidget();
-    m_treeWidget->setColumnCount(5);
-    m_treeWidget->setHeaderLabels({
-        tr("Item"), tr("Needed"), tr("In Stock"), tr("Shortfall"), tr("Cost")
-    });
-    m_treeWidget->setAlternatingRowColors(true);
-    m_treeWidget->setRootIsDecorated(true);
+    m_treeModel = new ProductionTreeModel(this);
+    m_treeView = new QTreeView();
+    m_treeView->setModel(m_treeModel);
+    m_treeView->setAlternatingRowColors(true);
+    m_treeView->setRootIsDecorated(true);
 
-    auto *header = m_treeWidget->header();
-    header->setSectionResizeMode(0, QHeaderView::Stretch);
-    header->setSectionResizeMode(1, QHeaderView::ResizeToContents);
-    header->setSectionResizeMode(2, QHeaderView::ResizeToContents);
-    header->setSectionResizeMode(3, QHeaderView::ResizeToContents);
-    header->setSectionResizeMode(4, QHeaderView::ResizeToContents);
+    auto *header = m_treeView->header();
+    header->setSectionResizeMode(ProductionTreeModel::ItemColumn, QHeaderView::Stretch);
+    header->setSectionResizeMode(ProductionTreeModel::NeededColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(ProductionTreeModel::InStockColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(ProductionTreeModel::ShortfallColumn, QHeaderView::ResizeToContents);
+    header->setSectionResizeMode(ProductionTreeModel::CostColumn, QHeaderView::ResizeToContents);
 
-    treeLayout->addWidget(m_treeWidget);
+    treeLayout->addWidget(m_treeView);
     mainLayout->addWidget(treeGroup, 1);
 
     // Legend
@@ -112,8 +116,23 @@ QWidget* ProductionCalculatorTab::createInputPanel()
     m_fullChainCheck->setToolTip(tr("Recursively expand craftable ingredients into their components"));
     layout->addWidget(m_fullChainCheck);
 
+    // One row per distinct sub-assembly
+    m_collapseDuplicatesCheck = new QCheckBox(tr("Collapse duplicates"));
+    m_collapseDuplicatesCheck->setToolTip(tr("Show each repeated sub-assembly once, with how many times it is needed"));
+    connect(m_collapseDuplicatesCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_treeModel->setCollapseDuplicates(checked);
+        m_treeView->expand(m_treeModel->index(0, 0));
+    });
+    layout->addWidget(m_collapseDuplicatesCheck);
+
     layout->addStretch();
 
+    // Batch evaluation of every recipe against inventory
+    m_craftFromStockBtn = new QPushButton(tr("What Can I Craft?"));
+    m_craftFromStockBtn->setToolTip(tr("Evaluate every recipe against current inventory"));
+    connect(m_craftFromStockBtn, &QPushButton::clicked, this, &ProductionCalculatorTab::onCraftFromStock);
+    layout->addWidget(m_craftFromStockBtn);
+
     // Calculate button
     m_calculateBtn = new QPushButton(tr("Calculate"));
     m_calculateBtn->setStyleSheet("background-color: #4caf50; color: white; font-weight: bold; padding: 8px 20px;");
@@ -212,6 +231,7 @@ QWidget* ProductionCalculatorTab::createSummaryPanel()
 
 void ProductionCalculatorTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("ProductionCalculatorTab::refreshData");
     populateRecipeCombo();
 }
 
@@ -220,12 +240,11 @@ void ProductionCalculatorTab::populateRecipeCombo()
     m_recipeCombo->blockSignals(true);
     m_recipeCombo->clear();
 
-    // Load all recipes
-    m_recipes = m_database->getAllRecipes();
-    m_recipesByOutput.clear();
+    // Share the database's compiled recipe graph; combo index = recipe index
+    m_solver.setGraph(m_database->recipeGraph());
 
-    // Build lookup map and populate combo
-    for (const auto &recipe : m_recipes) {
+    // Populate combo
+    for (const auto &recipe : m_solver.graph()->recipes()) {
         QString displayName = recipe.outputItem;
         if (recipe.outputQty > 1) {
             displayName += QString(" (×%1)").arg(recipe.outputQty);
@@ -236,11 +255,6 @@ void ProductionCalculatorTab::populateRecipeCombo()
         displayName += QString(" [%1]").arg(recipe.workbenchName);
 
         m_recipeCombo->addItem(displayName, recipe.id.value_or(0));
-
-        // Store in lookup (use first recipe if multiple exist for same output)
-        if (!m_recipesByOutput.contains(recipe.outputItem)) {
-            m_recipesByOutput[recipe.outputItem] = recipe;
-        }
     }
 
     m_recipeCombo->blockSignals(false);
@@ -264,224 +278,102 @@ void ProductionCalculatorTab::onCalculate()
 
 void ProductionCalculatorTab::calculate()
 {
+    FRONTIER_TRACE_SCOPE("ProductionCalculatorTab::calculate");
     int recipeIdx = m_recipeCombo->currentIndex();
-    if (recipeIdx < 0 || recipeIdx >= m_recipes.size()) {
+    if (recipeIdx < 0 || m_solver.isEmpty() || recipeIdx >= m_solver.graph()->recipeCount()) {
         return;
     }
 
-    const auto &recipe = m_recipes[recipeIdx];
     int quantity = m_quantitySpin->value();
     bool expandChain = m_fullChainCheck->isChecked();
 
-    // Build the production tree
-    m_rootNode = ProductionNode();
-    m_rootNode.itemName = recipe.outputItem;
-    m_rootNode.quantityNeeded = recipe.outputQty * quantity;
-    m_rootNode.quantityInInventory = getInventoryQuantity(recipe.outputItem);
-    m_rootNode.isCraftable = true;
-
-    // Build children from recipe ingredients
-    QSet<QString> visited;
-    visited.insert(recipe.outputItem);  // Prevent infinite recursion
-
-    for (const auto &ing : recipe.ingredients) {
-        ProductionNode childNode;
-        childNode.itemName = ing.itemName;
-        childNode.quantityNeeded = ing.quantity * quantity;
-        childNode.quantityInInventory = getInventoryQuantity(ing.itemName);
-
-        // Check if this ingredient is craftable
-        auto childRecipe = findRecipeForItem(ing.itemName);
-        childNode.isCraftable = childRecipe.has_value();
-
-        if (expandChain && childNode.isCraftable && !visited.contains(ing.itemName)) {
-            // Recursively expand
-            buildProductionTree(childNode, ing.quantity * quantity, expandChain, visited);
-        } else {
-            // Raw material or not expanding
-            childNode.isRawMaterial = true;
-            auto item = m_database->getItemByName(ing.itemName);
-            if (item.has_value()) {
-                childNode.unitCost = item->buyPriceInternal;
-            }
-        }
+    auto stockOf = [this](const QString &itemName) { return getInventoryQuantity(itemName); };
+    const Frontier::ItemCatalog &catalog = m_database->itemCatalog();
 
-        m_rootNode.children.append(childNode);
-    }
-
-    // Collect raw materials for summary
-    QMap<QString, int> rawMaterials;
-    collectRawMaterials(m_rootNode, rawMaterials);
-
-    // Calculate summary
-    m_summary = ProductionSummary();
-    m_summary.totalMaterialTypes = rawMaterials.size();
-    m_summary.rawMaterials = rawMaterials;
-
-    for (auto it = rawMaterials.begin(); it != rawMaterials.end(); ++it) {
-        m_summary.totalMaterialUnits += it.value();
-
-        auto item = m_database->getItemByName(it.key());
-        if (item.has_value()) {
-            m_summary.inputCost += item->buyPriceInternal * it.value();
-        }
-
-        int inStock = getInventoryQuantity(it.key());
-        if (it.value() > inStock) {
-            m_summary.shortfalls[it.key()] = it.value() - inStock;
-        }
-    }
-
-    // Output value
-    auto outputItem = m_database->getItemByName(recipe.outputItem);
-    if (outputItem.has_value()) {
-        m_summary.outputValue = outputItem->sellPriceInternal * recipe.outputQty * quantity;
-    }
-
-    m_summary.profit = m_summary.outputValue - m_summary.inputCost;
-    if (m_summary.inputCost > 0) {
-        m_summary.marginPercent = (m_summary.profit / m_summary.inputCost) * 100.0;
-    }
+    // Totals come from the aggregated pass; the tree is for display only
+    m_summary = m_solver.solve(recipeIdx, quantity, expandChain, catalog, stockOf);
+    m_treeModel->setTree(m_solver.buildTree(recipeIdx, quantity, expandChain, catalog, stockOf));
 
     // Update UI
     updateSummary(m_summary);
 
-    m_treeWidget->clear();
-    populateTreeWidget(m_rootNode);
-    m_treeWidget->expandAll();
+    // Rows below the first level are created as branches are expanded
+    m_treeView->expand(m_treeModel->index(0, 0));
 }
 
-void ProductionCalculatorTab::buildProductionTree(ProductionNode &node, int quantity,
-                                                  bool expandChain, QSet<QString> &visited)
+void ProductionCalculatorTab::onCraftFromStock()
 {
-    auto recipe = findRecipeForItem(node.itemName);
-    if (!recipe.has_value()) {
-        node.isRawMaterial = true;
-        auto item = m_database->getItemByName(node.itemName);
-        if (item.has_value()) {
-            node.unitCost = item->buyPriceInternal;
-        }
+    if (m_solver.isEmpty()) {
+        QMessageBox::information(this, tr("No Recipes"), tr("Import recipes first."));
         return;
     }
 
-    visited.insert(node.itemName);
-
-    // Calculate how many times we need to run this recipe
-    int runsNeeded = (quantity + recipe->outputQty - 1) / recipe->outputQty;  // Ceiling division
-
-    for (const auto &ing : recipe->ingredients) {
-        ProductionNode childNode;
-        childNode.itemName = ing.itemName;
-        childNode.quantityNeeded = ing.quantity * runsNeeded;
-        childNode.quantityInInventory = getInventoryQuantity(ing.itemName);
-
-        auto childRecipe = findRecipeForItem(ing.itemName);
-        childNode.isCraftable = childRecipe.has_value();
-
-        if (expandChain && childNode.isCraftable && !visited.contains(ing.itemName)) {
-            buildProductionTree(childNode, childNode.quantityNeeded, expandChain, visited);
-        } else {
-            childNode.isRawMaterial = true;
-            auto item = m_database->getItemByName(ing.itemName);
-            if (item.has_value()) {
-                childNode.unitCost = item->buyPriceInternal;
-            }
-        }
-
-        node.children.append(childNode);
-    }
-
-    visited.remove(node.itemName);  // Allow this item in other branches
-}
-
-void ProductionCalculatorTab::collectRawMaterials(const ProductionNode &node,
-                                                  QMap<QString, int> &materials)
-{
-    if (node.isRawMaterial || node.children.isEmpty()) {
-        // This is a leaf node - add to raw materials
-        materials[node.itemName] = materials.value(node.itemName, 0) + node.quantityNeeded;
-    } else {
-        // Recurse into children
-        for (const auto &child : node.children) {
-            collectRawMaterials(child, materials);
-        }
-    }
-}
-
-void ProductionCalculatorTab::populateTreeWidget(const ProductionNode &node,
-                                                 QTreeWidgetItem *parent)
-{
-    QTreeWidgetItem *item;
-    if (parent) {
-        item = new QTreeWidgetItem(parent);
-    } else {
-        item = new QTreeWidgetItem(m_treeWidget);
-    }
-
-    // Item name
-    QString displayName = node.itemName;
-    if (node.isCraftable && !node.isRawMaterial) {
-        displayName += " [Craftable]";
-    }
-    item->setText(0, displayName);
-
-    // Quantity needed
-    item->setText(1, QString("%L1").arg(node.quantityNeeded));
-    item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
-
-    // In stock
-    item->setText(2, QString("%L1").arg(node.quantityInInventory));
-    item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+    auto stockOf = [this](const QString &itemName) { return getInventoryQuantity(itemName); };
+    Frontier::CraftPlan plan = m_solver.planFromStock(m_database->itemCatalog(), stockOf);
 
-    // Shortfall
-    int shortfall = node.shortfall();
-    if (shortfall > 0) {
-        item->setText(3, QString("-%L1").arg(shortfall));
-    } else {
-        item->setText(3, "-");
-    }
-    item->setTextAlignment(3, Qt::AlignRight | Qt::AlignVCenter);
-
-    // Cost (only for raw materials)
-    if (node.isRawMaterial && node.unitCost > 0) {
-        double totalCost = node.unitCost * node.quantityNeeded;
-        item->setText(4, QString("$%L1").arg(totalCost, 0, 'f', 2));
-    } else {
-        item->setText(4, "-");
-    }
-    item->setTextAlignment(4, Qt::AlignRight | Qt::AlignVCenter);
-
-    // Color coding
-    QColor textColor;
-    if (node.isCraftable && !node.isRawMaterial) {
-        textColor = QColor("#1976d2");  // Blue for craftable
-    } else if (node.quantityInInventory >= node.quantityNeeded) {
-        textColor = QColor("#2e7d32");  // Green - sufficient
-    } else if (node.quantityInInventory > 0) {
-        textColor = QColor("#f57c00");  // Orange - partial
-    } else {
-        textColor = QColor("#c62828");  // Red - no stock
+    if (plan.options.isEmpty()) {
+        QMessageBox::information(this, tr("Nothing Craftable"),
+            tr("Current inventory does not cover the ingredients of any recipe."));
+        return;
     }
 
-    for (int col = 0; col < 5; ++col) {
-        item->setForeground(col, textColor);
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Craft From Inventory"));
+    dialog.resize(720, 480);
+    auto *layout = new QVBoxLayout(&dialog);
+
+    auto *summaryLabel = new QLabel(tr(
+        "%1 recipes can be crafted from current stock. Suggested plan (most profitable first, "
+        "sharing one stockpile): input %2, output %3, profit %4.")
+        .arg(plan.options.size())
+        .arg(QString("$%L1").arg(plan.totalInputCost, 0, 'f', 2))
+        .arg(QString("$%L1").arg(plan.totalOutputValue, 0, 'f', 2))
+        .arg(QString("$%L1").arg(plan.totalProfit, 0, 'f', 2)));
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    auto *table = new QTableWidget(plan.options.size(), 6);
+    table->setHorizontalHeaderLabels({
+        tr("Recipe"), tr("Building"), tr("Max Runs"), tr("Profit/Run"), tr("Planned Runs"), tr("Planned Profit")
+    });
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setAlternatingRowColors(true);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    auto numericItem = [](const QString &text) {
+        auto *item = new QTableWidgetItem(text);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        return item;
+    };
+
+    for (int row = 0; row < plan.options.size(); ++row) {
+        const auto &option = plan.options[row];
+        const auto &recipe = m_solver.graph()->recipe(option.recipeIndex);
+
+        table->setItem(row, 0, new QTableWidgetItem(recipe.outputItem));
+        table->setItem(row, 1, new QTableWidgetItem(recipe.workbenchName));
+        table->setItem(row, 2, numericItem(QString("%L1").arg(option.maxRuns)));
+
+        auto *profitItem = numericItem(QString("$%L1").arg(option.profitPerRun, 0, 'f', 2));
+        profitItem->setForeground(option.profitPerRun >= 0 ? QColor("#2e7d32") : QColor("#c62828"));
+        table->setItem(row, 3, profitItem);
+
+        table->setItem(row, 4, numericItem(option.plannedRuns > 0 ? QString("%L1").arg(option.plannedRuns) : "-"));
+        double plannedProfit = option.profitPerRun * option.plannedRuns;
+        table->setItem(row, 5, numericItem(option.plannedRuns > 0 ? QString("$%L1").arg(plannedProfit, 0, 'f', 2) : "-"));
     }
+    layout->addWidget(table);
 
-    // Highlight shortfall column in red if there is one
-    if (shortfall > 0) {
-        item->setForeground(3, QColor("#c62828"));
-        QFont font = item->font(3);
-        font.setBold(true);
-        item->setFont(3, font);
-    }
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addWidget(buttons);
 
-    // Add children
-    for (const auto &child : node.children) {
-        populateTreeWidget(child, item);
-    }
+    dialog.exec();
 }
 
-void ProductionCalculatorTab::updateSummary(const ProductionSummary &summary)
+void ProductionCalculatorTab::updateSummary(const Frontier::ProductionPlan &summary)
 {
     m_totalMaterialsLabel->setText(QString::number(summary.totalMaterialTypes));
     m_totalUnitsLabel->setText(QString("%L1").arg(summary.totalMaterialUnits));
@@ -511,9 +403,8 @@ void ProductionCalculatorTab::updateSummary(const ProductionSummary &summary)
 
 void ProductionCalculatorTab::clearResults()
 {
-    m_treeWidget->clear();
-    m_rootNode = ProductionNode();
-    m_summary = ProductionSummary();
+    m_treeModel->setTree(Frontier::ProductionTree());
+    m_summary = Frontier::ProductionPlan();
 
     m_totalMaterialsLabel->setText("0");
     m_totalUnitsLabel->setText("0");
@@ -536,12 +427,3 @@ int ProductionCalculatorTab::getInventoryQuantity(const QString &itemName) const
     }
     return 0;
 }
-
-std::optional<Frontier::Recipe> ProductionCalculatorTab::findRecipeForItem(const QString &itemName) const
-{
-    auto it = m_recipesByOutput.find(itemName);
-    if (it != m_recipesByOutput.end()) {
-        return it.value();
-    }
-    return std::nullopt;
-}
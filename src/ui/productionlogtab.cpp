@@ -5,7 +5,11 @@
 
 #include "productionlogtab.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/commandjournal.h"
 #include "inventorytab.h"
+#include "columntablemodel.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -29,6 +33,20 @@ ProductionLogTab::ProductionLogTab(Frontier::Database *database,
 {
     setupUi();
     refreshData();
+
+    // Logged and deleted runs are patched into the history one row at a
+    // time; anything coarser reloads it
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Production, [this]() {
+        loadHistory();
+        updateSummary();
+    });
+    m_database->changeBus().setRowPatcher(this, [this](const QVector<Frontier::RowChange> &changes) {
+        m_historyModel->applyRowChanges(changes, [this](int id) {
+            return m_database->getProductionHistoryRun(id);
+        });
+        updateSummary();
+        return true;
+    });
 }
 
 void ProductionLogTab::setupUi()
@@ -94,12 +112,10 @@ void ProductionLogTab::setupUi()
     auto *historyGroup = new QGroupBox(tr("Production History"));
     auto *historyLayout = new QVBoxLayout(historyGroup);
 
-    m_historyTable = new QTableWidget();
-    m_historyTable->setColumnCount(8);
-    m_historyTable->setHorizontalHeaderLabels({
-        tr("Date/Time"), tr("Recipe"), tr("Building"), tr("Runs"),
-        tr("Output"), tr("Value"), tr("Inv. Updated"), tr("Notes")
-    });
+    setupHistoryModel();
+
+    m_historyTable = new QTableView();
+    m_historyTable->setModel(m_historyProxy);
     m_historyTable->setAlternatingRowColors(true);
     m_historyTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_historyTable->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -117,7 +133,7 @@ void ProductionLogTab::setupUi()
     header->setSectionResizeMode(6, QHeaderView::ResizeToContents);  // Inv Updated
     header->setSectionResizeMode(7, QHeaderView::Stretch);           // Notes
 
-    connect(m_historyTable, &QTableWidget::itemSelectionChanged,
+    connect(m_historyTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &ProductionLogTab::onSelectionChanged);
 
     historyLayout->addWidget(m_historyTable);
@@ -252,6 +268,7 @@ QWidget* ProductionLogTab::createSummaryPanel()
 
 void ProductionLogTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("ProductionLogTab::refreshData");
     populateWorkbenches();
     loadHistory();
     updateSummary();
@@ -271,7 +288,7 @@ void ProductionLogTab::populateWorkbenches()
     m_workbenchCombo->blockSignals(false);
 
     // Load all recipes
-    m_recipes = m_database->getAllRecipes();
+    m_recipeGraph = m_database->recipeGraph();
     populateRecipes();
 }
 
@@ -283,13 +300,13 @@ void ProductionLogTab::populateRecipes()
     int selectedWorkbenchId = m_workbenchCombo->currentData().toInt();
     m_filteredRecipes.clear();
 
-    for (const auto &recipe : m_recipes) {
+    for (const auto &recipe : m_recipeGraph->recipes()) {
         // Filter by workbench if selected
         if (selectedWorkbenchId > 0 && recipe.workbenchId != selectedWorkbenchId) {
             continue;
         }
 
-        m_filteredRecipes.append(recipe);
+        m_filteredRecipes.append(&recipe);
 
         QString displayName = recipe.outputItem;
         if (recipe.outputQty > 1) {
@@ -306,72 +323,55 @@ void ProductionLogTab::populateRecipes()
     updatePreview();
 }
 
-void ProductionLogTab::loadHistory()
+void ProductionLogTab::setupHistoryModel()
 {
-    m_runs = m_database->getAllProductionRuns();
-
-    m_historyTable->setSortingEnabled(false);
-    m_historyTable->setRowCount(m_runs.size());
-
-    for (int row = 0; row < m_runs.size(); ++row) {
-        const auto &run = m_runs[row];
-
-        // Get recipe for cost calculation
-        auto recipe = m_database->getRecipe(run.recipeId);
-        double inputCost = 0, outputValue = 0;
-        if (recipe.has_value()) {
-            inputCost = calculateInputCost(recipe.value()) * run.quantity;
-            outputValue = calculateOutputValue(recipe.value()) * run.quantity;
-        }
-
-        // Date/Time
-        auto *dateItem = new QTableWidgetItem(run.timestamp.toString("yyyy-MM-dd hh:mm"));
-        dateItem->setData(Qt::UserRole, run.id.value_or(0));
-        m_historyTable->setItem(row, 0, dateItem);
-
-        // Recipe
-        m_historyTable->setItem(row, 1, new QTableWidgetItem(run.recipeName));
-
-        // Building
-        m_historyTable->setItem(row, 2, new QTableWidgetItem(run.workbenchName));
-
-        // Runs
-        auto *runsItem = new QTableWidgetItem(QString::number(run.quantity));
-        runsItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 3, runsItem);
-
-        // Output
-        int totalOutput = run.outputQty * run.quantity;
-        auto *outputItem = new QTableWidgetItem(QString("%L1").arg(totalOutput));
-        outputItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 4, outputItem);
-
-        // Value
-        auto *valueItem = new QTableWidgetItem(QString("$%L1").arg(outputValue, 0, 'f', 2));
-        valueItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        valueItem->setForeground(QColor("#2e7d32"));
-        m_historyTable->setItem(row, 5, valueItem);
+    using Frontier::ProductionRun;
+
+    m_historyModel = new ColumnTableModel<ProductionRun>(this);
+    m_historyModel->addColumn(tr("Date/Time"), ColumnFormat::DateTime,
+                              [](const ProductionRun &run) { return run.timestamp; });
+    m_historyModel->addColumn(tr("Recipe"), ColumnFormat::Text,
+                              [](const ProductionRun &run) { return run.recipeName; });
+    m_historyModel->addColumn(tr("Building"), ColumnFormat::Text,
+                              [](const ProductionRun &run) { return run.workbenchName; });
+    m_historyModel->addColumn(tr("Runs"), ColumnFormat::Integer,
+                              [](const ProductionRun &run) { return run.quantity; });
+    m_historyModel->addColumn(tr("Output"), ColumnFormat::Integer,
+                              [](const ProductionRun &run) { return run.totalOutputQty(); });
+    const int valueColumn = m_historyModel->addColumn(tr("Value"), ColumnFormat::Currency,
+                              [](const ProductionRun &run) { return run.totalOutputValue(); });
+    m_historyModel->setCellStyle(valueColumn, [](const ProductionRun &, int role) {
+        return role == Qt::ForegroundRole ? QVariant(QColor("#2e7d32")) : QVariant();
+    });
 
-        // Inventory Updated
-        QString invStatus;
+    // Inventory Updated: sorts Both, Outputs, Inputs, neither
+    const int inventoryColumn = m_historyModel->addColumn(tr("Inv. Updated"), ColumnFormat::Text,
+        [](const ProductionRun &run) { return int(run.deductedInputs) + 2 * int(run.addedOutputs); });
+    m_historyModel->setColumnText(inventoryColumn, [this](const ProductionRun &run) {
         if (run.deductedInputs && run.addedOutputs) {
-            invStatus = tr("✓ Both");
+            return tr("✓ Both");
         } else if (run.deductedInputs) {
-            invStatus = tr("↓ Inputs");
+            return tr("↓ Inputs");
         } else if (run.addedOutputs) {
-            invStatus = tr("↑ Outputs");
-        } else {
-            invStatus = tr("—");
+            return tr("↑ Outputs");
         }
-        auto *invItem = new QTableWidgetItem(invStatus);
-        invItem->setTextAlignment(Qt::AlignCenter);
-        m_historyTable->setItem(row, 6, invItem);
+        return tr("—");
+    });
+    m_historyModel->setCellStyle(inventoryColumn, [](const ProductionRun &, int role) {
+        return role == Qt::TextAlignmentRole ? QVariant(Qt::AlignCenter) : QVariant();
+    });
 
-        // Notes
-        m_historyTable->setItem(row, 7, new QTableWidgetItem(run.notes));
-    }
+    m_historyModel->addColumn(tr("Notes"), ColumnFormat::Text,
+                              [](const ProductionRun &run) { return run.notes; });
+    m_historyModel->setRowId([](const ProductionRun &run) { return run.id.value_or(0); });
 
-    m_historyTable->setSortingEnabled(true);
+    m_historyProxy = new ColumnSortProxy(m_historyModel, this);
+}
+
+void ProductionLogTab::loadHistory()
+{
+    // Runs arrive priced; each recipe's cost is resolved once
+    m_historyModel->setRows(m_database->getProductionHistory());
 }
 
 void ProductionLogTab::updatePreview()
@@ -385,7 +385,7 @@ void ProductionLogTab::updatePreview()
         return;
     }
 
-    const auto &recipe = m_filteredRecipes[recipeIdx];
+    const auto &recipe = *m_filteredRecipes[recipeIdx];
     int runs = m_quantitySpin->value();
 
     double inputCost = calculateInputCost(recipe) * runs;
@@ -430,14 +430,10 @@ void ProductionLogTab::updateSummary()
     int totalOutput = 0;
     double totalValue = 0;
 
-    for (const auto &run : m_runs) {
+    for (const auto &run : m_historyModel->rows()) {
         totalRuns += run.quantity;
-        totalOutput += run.outputQty * run.quantity;
-
-        auto recipe = m_database->getRecipe(run.recipeId);
-        if (recipe.has_value()) {
-            totalValue += calculateOutputValue(recipe.value()) * run.quantity;
-        }
+        totalOutput += run.totalOutputQty();
+        totalValue += run.totalOutputValue();
     }
 
     m_totalRunsLabel->setText(QString("%L1").arg(totalRuns));
@@ -467,7 +463,7 @@ void ProductionLogTab::onLogProduction()
         return;
     }
 
-    const auto &recipe = m_filteredRecipes[recipeIdx];
+    const auto &recipe = *m_filteredRecipes[recipeIdx];
     int runs = m_quantitySpin->value();
     bool deductInputs = m_deductInputsCheck->isChecked();
     bool addOutputs = m_addOutputsCheck->isChecked();
@@ -488,22 +484,46 @@ void ProductionLogTab::onLogProduction()
         }
     }
 
-    // Perform inventory operations
+    // Perform inventory operations; the stock changes undo as one step
     bool inputsDeducted = false;
     bool outputsAdded = false;
 
+    Frontier::CommandJournal &journal = m_database->journal();
+    journal.beginGroup(tr("Log production: %1").arg(recipe.outputItem));
+    if (!journal.inGroup()) {
+        QMessageBox::critical(this, tr("Error"),
+                              tr("Failed to log production run: %1").arg(journal.lastError()));
+        return;
+    }
     if (deductInputs && m_inventoryTab) {
         inputsDeducted = deductInputsFromInventory(recipe, runs);
-        if (!inputsDeducted) {
-            QMessageBox::warning(this, tr("Inventory Error"),
-                                 tr("Could not deduct all inputs from inventory.\n"
-                                    "Some items may have insufficient stock."));
-        }
     }
-
     if (addOutputs && m_inventoryTab) {
         outputsAdded = addOutputsToInventory(recipe, runs);
     }
+    // Quantity changes are queued; written here they commit or roll back
+    // with the rest of the group instead of landing later on their own
+    bool grouped = m_database->flushPendingWrites();
+    if (grouped) {
+        grouped = journal.endGroup();
+    } else {
+        journal.abortGroup();
+    }
+    if (!grouped) {
+        // The stock shown was changed in memory; read back what is stored
+        if (m_inventoryTab) {
+            m_inventoryTab->refreshData();
+        }
+        QMessageBox::critical(this, tr("Error"),
+                              tr("Failed to log production run: %1").arg(m_database->lastError()));
+        return;
+    }
+
+    if (deductInputs && m_inventoryTab && !inputsDeducted) {
+        QMessageBox::warning(this, tr("Inventory Error"),
+                             tr("Could not deduct all inputs from inventory.\n"
+                                "Some items may have insufficient stock."));
+    }
 
     // Create production run record
     Frontier::ProductionRun run;
@@ -521,9 +541,7 @@ void ProductionLogTab::onLogProduction()
         m_dateTimeEdit->setDateTime(QDateTime::currentDateTime());
         m_notesEdit->clear();
 
-        // Refresh
-        loadHistory();
-        updateSummary();
+        // History follows through the change bus
         updatePreview();
 
         emit productionLogged();
@@ -541,29 +559,25 @@ void ProductionLogTab::onLogProduction()
 
 void ProductionLogTab::onDeleteRun()
 {
-    auto selected = m_historyTable->selectedItems();
+    const QModelIndexList selected = m_historyTable->selectionModel()->selectedRows();
     if (selected.isEmpty()) {
         return;
     }
 
-    int row = selected.first()->row();
-    int runId = m_historyTable->item(row, 0)->data(Qt::UserRole).toInt();
+    int runId = selected.first().data(ColumnTableModelBase::RowIdRole).toInt();
 
     auto result = QMessageBox::question(this, tr("Delete Run"),
                                         tr("Delete this production run from history?\n\n"
                                            "Note: This will NOT reverse any inventory changes that were made."));
 
     if (result == QMessageBox::Yes) {
-        if (m_database->deleteProductionRun(runId)) {
-            loadHistory();
-            updateSummary();
-        }
+        m_database->deleteProductionRun(runId);
     }
 }
 
 void ProductionLogTab::onSelectionChanged()
 {
-    bool hasSelection = !m_historyTable->selectedItems().isEmpty();
+    bool hasSelection = m_historyTable->selectionModel()->hasSelection();
     m_deleteBtn->setEnabled(hasSelection);
 }
 
@@ -593,8 +607,8 @@ bool ProductionLogTab::addOutputsToInventory(const Frontier::Recipe &recipe, int
     int outputQty = recipe.outputQty * runs;
 
     // Find the item to get its ID
-    auto item = m_database->getItemByName(recipe.outputItem);
-    if (item.has_value() && item->id.has_value()) {
+    const Frontier::Item *item = m_database->itemCatalog().findByName(recipe.outputItem);
+    if (item && item->id.has_value()) {
         return m_inventoryTab->addOrUpdateItem(item->id.value(), outputQty);
     }
     return false;
@@ -604,8 +618,8 @@ double ProductionLogTab::calculateInputCost(const Frontier::Recipe &recipe) cons
 {
     double cost = 0;
     for (const auto &ing : recipe.ingredients) {
-        auto item = m_database->getItemByName(ing.itemName);
-        if (item.has_value()) {
+        const Frontier::Item *item = m_database->itemCatalog().findByName(ing.itemName);
+        if (item) {
             cost += item->buyPriceInternal * ing.quantity;
         }
     }
@@ -614,8 +628,8 @@ double ProductionLogTab::calculateInputCost(const Frontier::Recipe &recipe) cons
 
 double ProductionLogTab::calculateOutputValue(const Frontier::Recipe &recipe) const
 {
-    auto item = m_database->getItemByName(recipe.outputItem);
-    if (item.has_value()) {
+    const Frontier::Item *item = m_database->itemCatalog().findByName(recipe.outputItem);
+    if (item) {
         return item->sellPriceInternal * recipe.outputQty;
     }
     return 0;
@@ -12,17 +12,22 @@
 #include <QCheckBox>
 #include <QPushButton>
 #include <QLabel>
-#include <QTableWidget>
+#include <QTableView>
 #include <QDateTimeEdit>
 #include <QLineEdit>
 
+#include <memory>
+
 #include "core/types.h"
+#include "core/recipegraph.h"
 
 namespace Frontier {
 class Database;
 }
 
 class InventoryTab;
+template<typename Row> class ColumnTableModel;
+class ColumnSortProxy;
 
 class ProductionLogTab : public QWidget
 {
@@ -53,6 +58,7 @@ private:
 
     void populateWorkbenches();
     void populateRecipes();
+    void setupHistoryModel();
     void loadHistory();
     void updatePreview();
     void updateSummary();
@@ -67,9 +73,8 @@ private:
 
     // Cached data
     QVector<Frontier::Workbench> m_workbenches;
-    QVector<Frontier::Recipe> m_recipes;
-    QVector<Frontier::Recipe> m_filteredRecipes;
-    QVector<Frontier::ProductionRun> m_runs;
+    std::shared_ptr<const Frontier::RecipeGraph> m_recipeGraph;
+    QVector<const Frontier::Recipe *> m_filteredRecipes;  // point into m_recipeGraph
 
     // Input controls
     QComboBox *m_workbenchCombo;
@@ -92,8 +97,10 @@ private:
     QLabel *m_totalOutputLabel;
     QLabel *m_totalValueLabel;
 
-    // History table
-    QTableWidget *m_historyTable;
+    // History table; the model holds the runs
+    QTableView *m_historyTable;
+    ColumnTableModel<Frontier::ProductionRun> *m_historyModel;
+    ColumnSortProxy *m_historyProxy;
     QPushButton *m_deleteBtn;
 };
 
@@ -7,6 +7,7 @@
 #include "costanalysistab.h"
 #include "productioncalculatortab.h"
 #include "productionlogtab.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QLabel>
@@ -45,6 +46,7 @@ void ProductionTab::setupUi()
 
 void ProductionTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("ProductionTab::refreshData");
     if (m_calculatorTab) {
         m_calculatorTab->refreshData();
     }
@@ -0,0 +1,337 @@
+/**
+ * @file productiontreemodel.cpp
+ * @brief Lazy tree model for the production breakdown
+ */
+
+#include "productiontreemodel.h"
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <functional>
+
+namespace {
+const QColor CraftableColor("#1976d2");   // Blue
+const QColor SufficientColor("#2e7d32");  // Green
+const QColor PartialColor("#f57c00");     // Orange
+const QColor NoStockColor("#c62828");     // Red
+}
+
+ProductionTreeModel::ProductionTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+void ProductionTreeModel::setTree(Frontier::ProductionTree tree)
+{
+    beginResetModel();
+    m_tree = std::move(tree);
+    m_canonical.clear();
+    resetRows();
+    endResetModel();
+}
+
+void ProductionTreeModel::setCollapseDuplicates(bool collapse)
+{
+    if (collapse == m_collapse) {
+        return;
+    }
+
+    beginResetModel();
+    m_collapse = collapse;
+    resetRows();
+    endResetModel();
+}
+
+void ProductionTreeModel::resetRows()
+{
+    m_rows.clear();
+    if (m_tree.isEmpty()) {
+        return;
+    }
+
+    if (m_collapse && m_canonical.isEmpty()) {
+        buildCollapsed();
+    }
+
+    Row root;
+    root.node = Frontier::ProductionTree::RootIndex;
+    m_rows.append(root);
+}
+
+// =============================================================================
+// Collapsed View
+// =============================================================================
+
+void ProductionTreeModel::buildCollapsed()
+{
+    const int count = m_tree.size();
+
+    // Nodes are the same sub-assembly when item, quantity and child range
+    // match; the solver only shares a range between such nodes
+    QHash<std::pair<QString, quint64>, int> firstOf;
+    m_canonical.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const Frontier::ProductionNode &node = m_tree.node(i);
+        const quint64 shape = (static_cast<quint64>(static_cast<quint32>(node.quantityNeeded)) << 32)
+                              | static_cast<quint32>(node.firstChild);
+        m_canonical[i] = firstOf.value({node.itemName, shape}, i);
+        if (m_canonical[i] == i) {
+            firstOf.insert({node.itemName, shape}, i);
+        }
+    }
+
+    // Occurrences are paths from the root. Shared ranges make the stored
+    // nodes a DAG, so count them over a topological order rather than by
+    // walking every occurrence.
+    QVector<int> postOrder;
+    postOrder.reserve(count);
+    QVector<bool> visited(count, false);
+    std::function<void(int)> visit = [&](int index) {
+        visited[index] = true;
+        const Frontier::ProductionNode &node = m_tree.node(index);
+        for (int c = 0; c < node.childCount; ++c) {
+            const int child = m_tree.child(node, c);
+            if (!visited[child]) {
+                visit(child);
+            }
+        }
+        postOrder.append(index);
+    };
+    visit(Frontier::ProductionTree::RootIndex);
+
+    QVector<qint64> paths(count, 0);
+    paths[Frontier::ProductionTree::RootIndex] = 1;
+    for (int k = postOrder.size() - 1; k >= 0; --k) {
+        const Frontier::ProductionNode &node = m_tree.node(postOrder[k]);
+        for (int c = 0; c < node.childCount; ++c) {
+            paths[m_tree.child(node, c)] += paths[postOrder[k]];
+        }
+    }
+
+    m_occurrences.fill(0, count);
+    for (int i = 0; i < count; ++i) {
+        m_occurrences[m_canonical[i]] += paths[i];
+    }
+
+    // Each sub-assembly is placed under the first parent that reaches it;
+    // siblings are claimed before descending, so it sits as high as it can
+    m_collapsedFirst.fill(0, count);
+    m_collapsedCount.fill(0, count);
+    m_collapsedChildren.clear();
+    QVector<bool> placed(count, false);
+    placed[m_canonical[Frontier::ProductionTree::RootIndex]] = true;
+    std::function<void(int)> place = [&](int canonical) {
+        const Frontier::ProductionNode &node = m_tree.node(canonical);
+        const int first = m_collapsedChildren.size();
+        for (int c = 0; c < node.childCount; ++c) {
+            const int child = m_canonical[m_tree.child(node, c)];
+            if (!placed[child]) {
+                placed[child] = true;
+                m_collapsedChildren.append(child);
+            }
+        }
+        m_collapsedFirst[canonical] = first;
+        m_collapsedCount[canonical] = m_collapsedChildren.size() - first;
+        for (int i = 0; i < m_collapsedCount[canonical]; ++i) {
+            place(m_collapsedChildren[first + i]);
+        }
+    };
+    place(m_canonical[Frontier::ProductionTree::RootIndex]);
+}
+
+int ProductionTreeModel::displayedChildCount(const Row &row) const
+{
+    return m_collapse ? m_collapsedCount[row.node] : m_tree.node(row.node).childCount;
+}
+
+int ProductionTreeModel::displayedChild(const Row &row, int i) const
+{
+    return m_collapse ? m_collapsedChildren[m_collapsedFirst[row.node] + i]
+                      : m_tree.child(m_tree.node(row.node), i);
+}
+
+// =============================================================================
+// Structure
+// =============================================================================
+
+QModelIndex ProductionTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    if (!parent.isValid()) {
+        return (row == 0 && !m_rows.isEmpty()) ? createIndex(0, column, quintptr(0)) : QModelIndex();
+    }
+
+    const Row &owner = m_rows[int(parent.internalId())];
+    if (row >= owner.rowCount) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, quintptr(owner.firstRow + row));
+}
+
+QModelIndex ProductionTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    const int parentRow = m_rows[int(child.internalId())].parent;
+    if (parentRow < 0) {
+        return QModelIndex();
+    }
+    return createIndex(m_rows[parentRow].position, 0, quintptr(parentRow));
+}
+
+int ProductionTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+    if (!parent.isValid()) {
+        return m_rows.isEmpty() ? 0 : 1;
+    }
+    return m_rows[int(parent.internalId())].rowCount;
+}
+
+int ProductionTreeModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+bool ProductionTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+    if (!parent.isValid()) {
+        return !m_rows.isEmpty();
+    }
+    return displayedChildCount(m_rows[int(parent.internalId())]) > 0;
+}
+
+bool ProductionTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid() || parent.column() > 0) {
+        return false;
+    }
+    const Row &row = m_rows[int(parent.internalId())];
+    return row.firstRow < 0 && displayedChildCount(row) > 0;
+}
+
+void ProductionTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const int id = int(parent.internalId());
+    const int count = displayedChildCount(m_rows[id]);
+    const int first = m_rows.size();
+
+    beginInsertRows(parent, 0, count - 1);
+    m_rows.reserve(first + count);
+    for (int i = 0; i < count; ++i) {
+        Row child;
+        child.node = displayedChild(m_rows[id], i);
+        child.parent = id;
+        child.position = i;
+        child.multiplier = m_collapse ? m_occurrences[child.node] : 1;
+        m_rows.append(child);
+    }
+    m_rows[id].firstRow = first;
+    m_rows[id].rowCount = count;
+    endInsertRows();
+}
+
+// =============================================================================
+// Data
+// =============================================================================
+
+QVariant ProductionTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows[int(index.internalId())];
+    const Frontier::ProductionNode &node = m_tree.node(row.node);
+    const bool expanded = node.isCraftable && !node.isRawMaterial;
+    const qint64 needed = qint64(node.quantityNeeded) * row.multiplier;
+    const qint64 shortfall = qMax<qint64>(0, needed - node.quantityInInventory);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case ItemColumn: {
+            QString name = node.itemName;
+            if (expanded) {
+                name += " [Craftable]";
+            }
+            if (row.multiplier > 1) {
+                name += QString(" ×%L1").arg(row.multiplier);
+            }
+            return name;
+        }
+        case NeededColumn:    return QString("%L1").arg(needed);
+        case InStockColumn:   return QString("%L1").arg(node.quantityInInventory);
+        case ShortfallColumn: return shortfall > 0 ? QString("-%L1").arg(shortfall) : QString("-");
+        case CostColumn:
+            // Cost only for raw materials
+            if (node.isRawMaterial && node.unitCost > 0) {
+                return QString("$%L1").arg(node.unitCost * needed, 0, 'f', 2);
+            }
+            return QString("-");
+        }
+        break;
+
+    case MultiplierRole:
+        return row.multiplier;
+
+    case Qt::TextAlignmentRole:
+        if (index.column() != ItemColumn) {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        break;
+
+    case Qt::ForegroundRole:
+        if (index.column() == ShortfallColumn && shortfall > 0) {
+            return NoStockColor;
+        }
+        if (expanded) {
+            return CraftableColor;
+        }
+        if (node.quantityInInventory >= needed) {
+            return SufficientColor;
+        }
+        return node.quantityInInventory > 0 ? PartialColor : NoStockColor;
+
+    case Qt::FontRole:
+        if (index.column() == ShortfallColumn && shortfall > 0) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant ProductionTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractItemModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ItemColumn:      return tr("Item");
+    case NeededColumn:    return tr("Needed");
+    case InStockColumn:   return tr("In Stock");
+    case ShortfallColumn: return tr("Shortfall");
+    case CostColumn:      return tr("Cost");
+    }
+    return QVariant();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file productiontreemodel.h
+ * @brief Lazy tree model for the production breakdown
+ */
+
+#ifndef PRODUCTIONTREEMODEL_H
+#define PRODUCTIONTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+
+#include "core/productionsolver.h"
+
+/**
+ * @brief Read-only model over a solver's flat ProductionTree
+ *
+ * Rows are created per branch as the view expands it (canFetchMore and
+ * fetchMore), so a deep chain costs only the rows on screen; a collapsed
+ * branch reports children through hasChildren() but holds none. A row is
+ * an occurrence: the tree shares one node range between repeated
+ * sub-assemblies, and each place it appears gets its own rows.
+ *
+ * With collapseDuplicates set, each distinct sub-assembly (same item,
+ * quantity and expansion) gets one row at its first place in the tree,
+ * with a multiplier for how often the whole chain needs it. Needed,
+ * shortfall and cost are then totals over those occurrences; a branch
+ * already shown elsewhere is left out rather than repeated.
+ */
+class ProductionTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ItemColumn,
+        NeededColumn,
+        InStockColumn,
+        ShortfallColumn,
+        CostColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        MultiplierRole = Qt::UserRole
+    };
+
+    explicit ProductionTreeModel(QObject *parent = nullptr);
+
+    void setTree(Frontier::ProductionTree tree);
+    const Frontier::ProductionTree &tree() const { return m_tree; }
+
+    void setCollapseDuplicates(bool collapse);
+    bool collapseDuplicates() const { return m_collapse; }
+
+    // Rows created so far, for diagnostics
+    int createdRowCount() const { return m_rows.size(); }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    // One displayed row; a row's children are created together and sit
+    // in m_rows as one block
+    struct Row {
+        int node = 0;                // Index into m_tree
+        int parent = -1;             // Row id; -1 for the root
+        int position = 0;            // Row number under parent
+        int firstRow = -1;           // Child rows, once fetched
+        int rowCount = 0;
+        qint64 multiplier = 1;
+    };
+
+    void resetRows();
+    void buildCollapsed();
+    int displayedChildCount(const Row &row) const;
+    int displayedChild(const Row &row, int i) const;
+
+    Frontier::ProductionTree m_tree;
+    QVector<Row> m_rows;
+    bool m_collapse = false;
+
+    // Collapsed view, built when first needed: the canonical node for
+    // each stored node, total occurrences of each canonical node, and the
+    // canonical children each one shows as [first, first + count)
+    QVector<int> m_canonical;
+    QVector<qint64> m_occurrences;
+    QVector<int> m_collapsedFirst;
+    QVector<int> m_collapsedCount;
+    QVector<int> m_collapsedChildren;
+};
+
+#endif // PRODUCTIONTREEMODEL_H
@@ -5,6 +5,9 @@
 
 #include "recipestab.h"
 #include "core/database.h"
+#include "core/itemcatalog.h"
+#include "core/recipegraph.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -19,6 +22,8 @@ RecipesTab::RecipesTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Recipes | Frontier::DataTable::Items,
+                                      [this]() { refreshData(); });
     loadRecipes();
 }
 
@@ -144,6 +149,8 @@ void RecipesTab::setupUi()
 
 void RecipesTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("RecipesTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     // Reload workbench combo
     m_workbenchCombo->blockSignals(true);
     m_workbenchCombo->clear();
@@ -166,16 +173,15 @@ void RecipesTab::loadRecipes()
     int workbenchId = m_workbenchCombo->currentData().toInt();
     QString searchText = m_searchEdit->text().trimmed().toLower();
 
-    QVector<Frontier::Recipe> recipes;
-    if (workbenchId > 0) {
-        recipes = m_database->getRecipesByWorkbench(workbenchId);
-    } else {
-        recipes = m_database->getAllRecipes();
-    }
+    auto graph = m_database->recipeGraph();
 
     int displayedCount = 0;
 
-    for (const auto &recipe : recipes) {
+    for (const auto &recipe : graph->recipes()) {
+        if (workbenchId > 0 && recipe.workbenchId != workbenchId) {
+            continue;
+        }
+
         // Apply search filter
         if (!searchText.isEmpty()) {
             bool matches = recipe.outputItem.toLower().contains(searchText)
@@ -267,9 +273,9 @@ void RecipesTab::updateRecipeDetails(int recipeId)
     QString ingredientsHtml = "<table cellspacing='5'>";
     for (const auto &ing : recipe->ingredients) {
         // Try to get item price
-        auto item = m_database->getItemByName(ing.itemName);
+        const Frontier::Item *item = m_database->itemCatalog().findByName(ing.itemName);
         QString priceStr = "-";
-        if (item.has_value()) {
+        if (item) {
             double price = item->buyPriceDisplay > 0 ? item->buyPriceDisplay : item->buyPriceInternal;
             priceStr = QString("$%1").arg(price, 0, 'f', 0);
         }
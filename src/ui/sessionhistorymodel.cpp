@@ -0,0 +1,138 @@
+/**
+ * @file sessionhistorymodel.cpp
+ * @brief Paged list model for the movement session history
+ */
+
+#include "sessionhistorymodel.h"
+#include "core/operationsmanager.h"
+#include "core/unitconverter.h"
+
+SessionHistoryModel::SessionHistoryModel(Frontier::OperationsManager *manager, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_manager(manager)
+{
+    m_query.limit = PageSize;
+}
+
+void SessionHistoryModel::reload()
+{
+    beginResetModel();
+    m_sessions = fetchPage(0);
+    m_exhausted = m_sessions.size() < PageSize;
+    endResetModel();
+}
+
+void SessionHistoryModel::setSearch(const QString &search)
+{
+    const QString trimmed = search.trimmed();
+    if (trimmed == m_query.search) {
+        return;
+    }
+    m_query.search = trimmed;
+    reload();
+}
+
+void SessionHistoryModel::setUnitSystem(Frontier::UnitSystem system)
+{
+    if (system == m_units) {
+        return;
+    }
+    m_units = system;
+    if (!m_sessions.isEmpty()) {
+        emit dataChanged(index(1), index(m_sessions.size()));
+    }
+}
+
+QVector<Frontier::MovementSessionSummary> SessionHistoryModel::fetchPage(int offset) const
+{
+    Frontier::MovementSessionQuery page = m_query;
+    page.offset = offset;
+    return m_manager->querySessions(page);
+}
+
+bool SessionHistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_exhausted;
+}
+
+void SessionHistoryModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || m_exhausted) {
+        return;
+    }
+
+    QVector<Frontier::MovementSessionSummary> page = fetchPage(m_sessions.size());
+    m_exhausted = page.size() < PageSize;
+    if (page.isEmpty()) {
+        return;
+    }
+
+    // Row 0 is the placeholder, so session i is row i + 1
+    beginInsertRows(QModelIndex(), m_sessions.size() + 1, m_sessions.size() + page.size());
+    m_sessions.append(page);
+    endInsertRows();
+}
+
+int SessionHistoryModel::rowOfId(int sessionId) const
+{
+    for (int i = 0; i < m_sessions.size(); ++i) {
+        if (m_sessions[i].session.id.value_or(0) == sessionId) {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+int SessionHistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_sessions.size() + 1;
+}
+
+QVariant SessionHistoryModel::data(const QModelIndex &index, int role) const
+{
+    using UC = Frontier::UnitConverter;
+
+    if (!index.isValid() || index.row() > m_sessions.size()) {
+        return QVariant();
+    }
+
+    if (index.row() == 0) {
+        switch (role) {
+        case Qt::DisplayRole: return tr("-- Select Session --");
+        case SessionIdRole:   return -1;
+        }
+        return QVariant();
+    }
+
+    const Frontier::MovementSessionSummary &summary = m_sessions[index.row() - 1];
+    const Frontier::MovementSession &session = summary.session;
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        QString text = QString("#%1 - %2 [%3]")
+                           .arg(session.id.value_or(0))
+                           .arg(session.startTime.toString("yyyy-MM-dd hh:mm"))
+                           .arg(session.endTime.isValid() ? tr("Closed") : tr("Active"));
+        if (!session.mapName.isEmpty()) {
+            text += QString(" - %1").arg(session.mapName);
+        }
+        if (summary.usageCount > 0) {
+            text += QString(" - %1").arg(UC::formatVolume(summary.totalVolumeM3(), m_units, 0));
+        }
+        return text;
+    }
+
+    case SessionIdRole:
+        return session.id.value_or(0);
+
+    case Qt::ToolTipRole:
+        return tr("Loaders: %1\nTrucks: %2\nFuel: %3\nHours: %4\nEquipment entries: %5")
+            .arg(UC::formatVolume(summary.loaderVolumeM3, m_units))
+            .arg(UC::formatVolume(summary.truckVolumeM3, m_units))
+            .arg(UC::formatFuel(summary.fuelL, m_units))
+            .arg(summary.hours, 0, 'f', 2)
+            .arg(summary.usageCount);
+    }
+
+    return QVariant();
+}
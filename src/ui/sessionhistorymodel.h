@@ -0,0 +1,71 @@
+/**
+ * @file sessionhistorymodel.h
+ * @brief Paged, searchable list of movement sessions with their totals
+ */
+
+#ifndef SESSIONHISTORYMODEL_H
+#define SESSIONHISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include "core/types.h"
+
+namespace Frontier {
+class OperationsManager;
+}
+
+/**
+ * @brief List model for the session picker, read a page at a time
+ *
+ * Pages of PageSize come from OperationsManager::querySessions(), which
+ * totals volume, fuel and hours per session in the same query, so the
+ * list shows each session's totals without reading its usage rows. The
+ * combo box's popup asks for more pages as it scrolls (canFetchMore /
+ * fetchMore). setSearch() narrows the list and reloads from the first
+ * page.
+ *
+ * Row 0 is a "-- Select Session --" placeholder whose id is -1.
+ */
+class SessionHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        SessionIdRole = Qt::UserRole    // What QComboBox::currentData() reads
+    };
+
+    explicit SessionHistoryModel(Frontier::OperationsManager *manager, QObject *parent = nullptr);
+
+    // Drops loaded rows and reads the first page again
+    void reload();
+
+    // Map name or notes substring, or "#id"; empty lists every session
+    void setSearch(const QString &search);
+    QString search() const { return m_query.search; }
+
+    void setUnitSystem(Frontier::UnitSystem system);
+
+    // -1 when the session is not among the loaded rows
+    int rowOfId(int sessionId) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    static constexpr int PageSize = 100;
+
+private:
+    QVector<Frontier::MovementSessionSummary> fetchPage(int offset) const;
+
+    Frontier::OperationsManager *m_manager;
+    Frontier::MovementSessionQuery m_query;
+    Frontier::UnitSystem m_units = Frontier::UnitSystem::Metric;
+    QVector<Frontier::MovementSessionSummary> m_sessions;
+    bool m_exhausted = false;       // Last page read was short
+};
+
+#endif // SESSIONHISTORYMODEL_H
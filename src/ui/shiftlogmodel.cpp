@@ -0,0 +1,200 @@
+/**
+ * @file shiftlogmodel.cpp
+ * @brief Paged table model for the shift history
+ */
+
+#include "shiftlogmodel.h"
+#include "core/database.h"
+
+#include <QColor>
+#include <QFont>
+
+namespace {
+const QColor OngoingBackground(255, 243, 224);  // Light orange
+const QColor OngoingForeground("#f57c00");
+constexpr int ActivitiesPreviewLength = 50;
+}
+
+ShiftLogModel::ShiftLogModel(Frontier::Database *database, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_database(database)
+{
+    m_query.limit = PageSize;
+}
+
+void ShiftLogModel::reload()
+{
+    beginResetModel();
+    m_shifts = fetchPage(0);
+    m_exhausted = m_shifts.size() < PageSize;
+    endResetModel();
+}
+
+QVector<Frontier::Shift> ShiftLogModel::fetchPage(int offset) const
+{
+    Frontier::ShiftQuery page = m_query;
+    page.offset = offset;
+    return m_database->queryShifts(page);
+}
+
+bool ShiftLogModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_exhausted;
+}
+
+void ShiftLogModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || m_exhausted) {
+        return;
+    }
+
+    QVector<Frontier::Shift> page = fetchPage(m_shifts.size());
+    m_exhausted = page.size() < PageSize;
+    if (page.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_shifts.size(), m_shifts.size() + page.size() - 1);
+    m_shifts.append(page);
+    endInsertRows();
+}
+
+bool ShiftLogModel::applyRowChanges(const QVector<Frontier::RowChange> &changes)
+{
+    for (const Frontier::RowChange &change : changes) {
+        if (change.kind == Frontier::RowChange::Inserted) {
+            return false;
+        }
+    }
+
+    for (const Frontier::RowChange &change : changes) {
+        const int row = rowOfId(change.id);
+        if (row < 0) {
+            continue;
+        }
+
+        std::optional<Frontier::Shift> shift;
+        if (change.kind == Frontier::RowChange::Updated) {
+            shift = m_database->getShift(change.id);
+        }
+        if (shift) {
+            m_shifts[row] = std::move(*shift);
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+        } else {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_shifts.removeAt(row);
+            endRemoveRows();
+        }
+    }
+    return true;
+}
+
+int ShiftLogModel::rowOfId(int id) const
+{
+    for (int i = 0; i < m_shifts.size(); ++i) {
+        if (m_shifts[i].id.value_or(0) == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ShiftLogModel::sort(int column, Qt::SortOrder order)
+{
+    using OrderBy = Frontier::ShiftQuery::OrderBy;
+    switch (column) {
+    case StartColumn:      m_query.orderBy = OrderBy::StartTimeOfDay; break;
+    case EndColumn:        m_query.orderBy = OrderBy::EndTime; break;
+    case DurationColumn:   m_query.orderBy = OrderBy::Duration; break;
+    case WeatherColumn:    m_query.orderBy = OrderBy::Weather; break;
+    case ActivitiesColumn: m_query.orderBy = OrderBy::Activities; break;
+    default:               m_query.orderBy = OrderBy::StartTime; break;
+    }
+    m_query.descending = (order == Qt::DescendingOrder);
+    reload();
+}
+
+int ShiftLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_shifts.size();
+}
+
+int ShiftLogModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ShiftLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_shifts.size()) {
+        return QVariant();
+    }
+
+    const Frontier::Shift &shift = m_shifts[index.row()];
+    const bool ongoing = !shift.endTime.isValid();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case DateColumn:     return shift.startTime.date().toString("yyyy-MM-dd");
+        case StartColumn:    return shift.startTime.time().toString("hh:mm");
+        case EndColumn:      return ongoing ? tr("(ongoing)") : shift.endTime.time().toString("hh:mm");
+        case DurationColumn: return ongoing ? QString("-") : shift.durationFormatted();
+        case WeatherColumn:  return shift.weather;
+        case ActivitiesColumn:
+            if (shift.activities.length() > ActivitiesPreviewLength) {
+                return shift.activities.left(ActivitiesPreviewLength - 3) + "...";
+            }
+            return shift.activities;
+        }
+        break;
+
+    case ShiftIdRole:
+        return shift.id.value_or(0);
+
+    case Qt::BackgroundRole:
+        if (ongoing) {
+            return OngoingBackground;
+        }
+        break;
+
+    case Qt::ForegroundRole:
+        if (ongoing && index.column() == EndColumn) {
+            return OngoingForeground;
+        }
+        break;
+
+    case Qt::FontRole:
+        if (ongoing && index.column() == EndColumn) {
+            QFont font;
+            font.setItalic(true);
+            return font;
+        }
+        break;
+
+    case Qt::TextAlignmentRole:
+        if (index.column() == DurationColumn) {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant ShiftLogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case DateColumn:       return tr("Date");
+    case StartColumn:      return tr("Start");
+    case EndColumn:        return tr("End");
+    case DurationColumn:   return tr("Duration");
+    case WeatherColumn:    return tr("Weather");
+    case ActivitiesColumn: return tr("Activities");
+    }
+    return QVariant();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file shiftlogmodel.h
+ * @brief Paged table model for the shift history
+ */
+
+#ifndef SHIFTLOGMODEL_H
+#define SHIFTLOGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include "core/types.h"
+
+namespace Frontier {
+class Database;
+struct RowChange;
+}
+
+/**
+ * @brief Read-only model that loads shift history a page at a time
+ *
+ * Rows are read with Database::queryShifts() in pages of PageSize as the
+ * view scrolls (canFetchMore/fetchMore), so opening a long log reads one
+ * page rather than every shift. Sorting is done by the query: sort()
+ * changes the ORDER BY and reloads from the first page.
+ *
+ * Edits and deletes of loaded shifts are patched in place by
+ * applyRowChanges(); a new shift's place depends on the sort and the
+ * pages read so far, so inserts are left to reload().
+ */
+class ShiftLogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        DateColumn,
+        StartColumn,
+        EndColumn,
+        DurationColumn,
+        WeatherColumn,
+        ActivitiesColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        ShiftIdRole = Qt::UserRole
+    };
+
+    explicit ShiftLogModel(Frontier::Database *database, QObject *parent = nullptr);
+
+    // Drops loaded rows and reads the first page again
+    void reload();
+
+    // Patches loaded rows for change-bus Updated and Deleted events;
+    // false (nothing applied) when the batch holds an insert
+    bool applyRowChanges(const QVector<Frontier::RowChange> &changes);
+
+    const Frontier::Shift &shiftAt(int row) const { return m_shifts[row]; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    static constexpr int PageSize = 200;
+
+private:
+    QVector<Frontier::Shift> fetchPage(int offset) const;
+    int rowOfId(int id) const;
+
+    Frontier::Database *m_database;
+    Frontier::ShiftQuery m_query;
+    QVector<Frontier::Shift> m_shifts;
+    bool m_exhausted = false;        // Last page read was short
+};
+
+#endif // SHIFTLOGMODEL_H
@@ -4,7 +4,9 @@
  */
 
 #include "shiftlogtab.h"
+#include "shiftlogmodel.h"
 #include "core/database.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -25,6 +27,16 @@ ShiftLogTab::ShiftLogTab(Frontier::Database *database, QWidget *parent)
 {
     setupUi();
     refreshData();
+
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Shifts,
+                                      [this]() { refreshData(); });
+    m_database->changeBus().setRowPatcher(this, [this](const QVector<Frontier::RowChange> &changes) {
+        if (!m_historyModel->applyRowChanges(changes)) {
+            return false;
+        }
+        updateSummary();
+        return true;
+    });
 }
 
 void ShiftLogTab::setupUi()
@@ -46,19 +58,21 @@ void ShiftLogTab::setupUi()
     auto *historyGroup = new QGroupBox(tr("Shift History"));
     auto *historyLayout = new QVBoxLayout(historyGroup);
 
-    m_historyTable = new QTableWidget();
-    m_historyTable->setColumnCount(6);
-    m_historyTable->setHorizontalHeaderLabels({
-        tr("Date"), tr("Start"), tr("End"), tr("Duration"), tr("Weather"), tr("Activities")
-    });
+    m_historyModel = new ShiftLogModel(m_database, this);
+
+    m_historyTable = new QTableView();
+    m_historyTable->setModel(m_historyModel);
     m_historyTable->setAlternatingRowColors(true);
     m_historyTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_historyTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_historyTable->setSortingEnabled(true);
     m_historyTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_historyTable->verticalHeader()->setVisible(false);
 
+    // Sorting runs in SQL through ShiftLogModel::sort(); newest first by default
     auto *header = m_historyTable->horizontalHeader();
+    header->setSortIndicator(ShiftLogModel::DateColumn, Qt::DescendingOrder);
+    m_historyTable->setSortingEnabled(true);
+
     header->setSectionResizeMode(0, QHeaderView::ResizeToContents);  // Date
     header->setSectionResizeMode(1, QHeaderView::ResizeToContents);  // Start
     header->setSectionResizeMode(2, QHeaderView::ResizeToContents);  // End
@@ -66,9 +80,11 @@ void ShiftLogTab::setupUi()
     header->setSectionResizeMode(4, QHeaderView::ResizeToContents);  // Weather
     header->setSectionResizeMode(5, QHeaderView::Stretch);           // Activities
 
-    connect(m_historyTable, &QTableWidget::itemSelectionChanged,
+    connect(m_historyTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &ShiftLogTab::onSelectionChanged);
-    connect(m_historyTable, &QTableWidget::itemDoubleClicked,
+    connect(m_historyModel, &QAbstractItemModel::modelReset,
+            this, &ShiftLogTab::onSelectionChanged);
+    connect(m_historyTable, &QTableView::doubleClicked,
             this, &ShiftLogTab::onEditShift);
 
     historyLayout->addWidget(m_historyTable);
@@ -218,6 +234,26 @@ QWidget* ShiftLogTab::createSummaryPanel()
     avgLayout->addWidget(m_avgDurationLabel);
     layout->addLayout(avgLayout);
 
+    // Separator
+    auto *sep3 = new QFrame();
+    sep3->setFrameShape(QFrame::VLine);
+    layout->addWidget(sep3);
+
+    // This week / this month
+    auto *weekLayout = new QVBoxLayout();
+    weekLayout->addWidget(new QLabel(tr("This Week")));
+    m_weekTimeLabel = new QLabel("0m");
+    m_weekTimeLabel->setStyleSheet("font-size: 18px; font-weight: bold;");
+    weekLayout->addWidget(m_weekTimeLabel);
+    layout->addLayout(weekLayout);
+
+    auto *monthLayout = new QVBoxLayout();
+    monthLayout->addWidget(new QLabel(tr("This Month")));
+    m_monthTimeLabel = new QLabel("0m");
+    m_monthTimeLabel->setStyleSheet("font-size: 18px; font-weight: bold;");
+    monthLayout->addWidget(m_monthTimeLabel);
+    layout->addLayout(monthLayout);
+
     layout->addStretch();
 
     return group;
@@ -229,104 +265,55 @@ QWidget* ShiftLogTab::createSummaryPanel()
 
 void ShiftLogTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("ShiftLogTab::refreshData");
     loadShifts();
     updateSummary();
 }
 
 void ShiftLogTab::loadShifts()
 {
-    m_shifts = m_database->getAllShifts();
-
-    m_historyTable->setSortingEnabled(false);
-    m_historyTable->setRowCount(m_shifts.size());
-
-    for (int row = 0; row < m_shifts.size(); ++row) {
-        const auto &shift = m_shifts[row];
-
-        // Date
-        auto *dateItem = new QTableWidgetItem(shift.startTime.date().toString("yyyy-MM-dd"));
-        dateItem->setData(Qt::UserRole, shift.id.value_or(0));
-        m_historyTable->setItem(row, 0, dateItem);
-
-        // Start time
-        m_historyTable->setItem(row, 1, new QTableWidgetItem(shift.startTime.time().toString("hh:mm")));
-
-        // End time
-        QString endStr = shift.endTime.isValid() ? shift.endTime.time().toString("hh:mm") : tr("(ongoing)");
-        auto *endItem = new QTableWidgetItem(endStr);
-        if (!shift.endTime.isValid()) {
-            endItem->setForeground(QColor("#f57c00"));
-            endItem->setFont(QFont(endItem->font().family(), -1, -1, true));  // Italic
-        }
-        m_historyTable->setItem(row, 2, endItem);
-
-        // Duration
-        QString durationStr = shift.endTime.isValid() ? shift.durationFormatted() : "-";
-        auto *durationItem = new QTableWidgetItem(durationStr);
-        durationItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-        m_historyTable->setItem(row, 3, durationItem);
-
-        // Weather
-        m_historyTable->setItem(row, 4, new QTableWidgetItem(shift.weather));
-
-        // Activities (truncated)
-        QString activities = shift.activities;
-        if (activities.length() > 50) {
-            activities = activities.left(47) + "...";
-        }
-        m_historyTable->setItem(row, 5, new QTableWidgetItem(activities));
-
-        // Color ongoing shifts
-        if (!shift.endTime.isValid()) {
-            QColor bgColor(255, 243, 224);  // Light orange
-            for (int col = 0; col < 6; ++col) {
-                if (auto *item = m_historyTable->item(row, col)) {
-                    item->setBackground(bgColor);
-                }
-            }
-        }
-    }
-
-    m_historyTable->setSortingEnabled(true);
+    m_historyModel->reload();
 }
 
 void ShiftLogTab::updateSummary()
 {
-    int totalShifts = m_shifts.size();
-    int totalMinutes = 0;
-
-    for (const auto &shift : m_shifts) {
-        if (shift.endTime.isValid()) {
-            totalMinutes += shift.durationMinutes();
-        }
-    }
-
-    int hours = totalMinutes / 60;
-    int mins = totalMinutes % 60;
-
-    m_totalShiftsLabel->setText(QString::number(totalShifts));
-    m_totalTimeLabel->setText(QString("%1h %2m").arg(hours).arg(mins));
+    // Totals and period buckets are aggregated in SQL; nothing here walks
+    // the shift rows, so the cost does not grow with the log
+    const Frontier::ShiftTotals totals = m_database->getShiftTotals();
+
+    m_totalShiftsLabel->setText(QString::number(totals.shiftCount));
+    m_totalTimeLabel->setText(QString("%1h %2m").arg(totals.totalMinutes / 60).arg(totals.totalMinutes % 60));
+    m_avgDurationLabel->setText(totals.completedCount > 0
+                                    ? formatMinutes(static_cast<int>(totals.avgMinutes()))
+                                    : QString("-"));
+
+    const QDate today = QDate::currentDate();
+    const QDate weekStart = today.addDays(1 - today.dayOfWeek());
+    const QDate monthStart(today.year(), today.month(), 1);
+
+    auto currentBucketMinutes = [&](Frontier::ShiftPeriod period, const QDate &start) {
+        const auto buckets = m_database->getShiftAnalytics(period, start, today);
+        return buckets.isEmpty() ? 0 : buckets.first().totalMinutes;
+    };
+    m_weekTimeLabel->setText(formatMinutes(currentBucketMinutes(Frontier::ShiftPeriod::Week, weekStart)));
+    m_monthTimeLabel->setText(formatMinutes(currentBucketMinutes(Frontier::ShiftPeriod::Month, monthStart)));
+}
 
-    // Average duration (only count completed shifts)
-    int completedShifts = 0;
-    for (const auto &shift : m_shifts) {
-        if (shift.endTime.isValid()) {
-            completedShifts++;
-        }
+QString ShiftLogTab::formatMinutes(int minutes)
+{
+    if (minutes >= 60) {
+        return QString("%1h %2m").arg(minutes / 60).arg(minutes % 60);
     }
+    return QString("%1m").arg(minutes);
+}
 
-    if (completedShifts > 0) {
-        int avgMins = totalMinutes / completedShifts;
-        int avgHours = avgMins / 60;
-        int avgRemain = avgMins % 60;
-        if (avgHours > 0) {
-            m_avgDurationLabel->setText(QString("%1h %2m").arg(avgHours).arg(avgRemain));
-        } else {
-            m_avgDurationLabel->setText(QString("%1m").arg(avgMins));
-        }
-    } else {
-        m_avgDurationLabel->setText("-");
+std::optional<int> ShiftLogTab::selectedShiftId() const
+{
+    const QModelIndexList rows = m_historyTable->selectionModel()->selectedRows();
+    if (rows.isEmpty()) {
+        return std::nullopt;
     }
+    return m_historyModel->shiftAt(rows.first().row()).id;
 }
 
 // =============================================================================
@@ -426,7 +413,6 @@ void ShiftLogTab::onSaveShift()
 
     if (success) {
         clearForm();
-        refreshData();
     } else {
         QMessageBox::critical(this, tr("Error"), tr("Failed to save shift."));
     }
@@ -440,13 +426,10 @@ void ShiftLogTab::onNewShift()
 
 void ShiftLogTab::onEditShift()
 {
-    auto selected = m_historyTable->selectedItems();
-    if (selected.isEmpty()) return;
-
-    int row = selected.first()->row();
-    int shiftId = m_historyTable->item(row, 0)->data(Qt::UserRole).toInt();
+    const std::optional<int> shiftId = selectedShiftId();
+    if (!shiftId) return;
 
-    auto shift = m_database->getShift(shiftId);
+    auto shift = m_database->getShift(*shiftId);
     if (shift.has_value()) {
         populateForm(shift.value());
     }
@@ -454,11 +437,10 @@ void ShiftLogTab::onEditShift()
 
 void ShiftLogTab::onDeleteShift()
 {
-    auto selected = m_historyTable->selectedItems();
-    if (selected.isEmpty()) return;
+    const std::optional<int> selectedId = selectedShiftId();
+    if (!selectedId) return;
 
-    int row = selected.first()->row();
-    int shiftId = m_historyTable->item(row, 0)->data(Qt::UserRole).toInt();
+    const int shiftId = *selectedId;
 
     auto result = QMessageBox::question(this, tr("Delete Shift"),
                                         tr("Delete this shift from the log?"));
@@ -469,14 +451,13 @@ void ShiftLogTab::onDeleteShift()
             if (m_editingShiftId.has_value() && m_editingShiftId.value() == shiftId) {
                 clearForm();
             }
-            refreshData();
         }
     }
 }
 
 void ShiftLogTab::onSelectionChanged()
 {
-    bool hasSelection = !m_historyTable->selectedItems().isEmpty();
+    bool hasSelection = m_historyTable->selectionModel()->hasSelection();
     m_editBtn->setEnabled(hasSelection);
     m_deleteBtn->setEnabled(hasSelection);
 }
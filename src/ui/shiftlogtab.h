@@ -13,7 +13,7 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
-#include <QTableWidget>
+#include <QTableView>
 
 #include "core/types.h"
 
@@ -21,6 +21,8 @@ namespace Frontier {
 class Database;
 }
 
+class ShiftLogModel;
+
 class ShiftLogTab : public QWidget
 {
     Q_OBJECT
@@ -47,6 +49,8 @@ private:
 
     void loadShifts();
     void updateSummary();
+    std::optional<int> selectedShiftId() const;
+    static QString formatMinutes(int minutes);
     void clearForm();
     void populateForm(const Frontier::Shift &shift);
     Frontier::Shift getFormData() const;
@@ -55,7 +59,6 @@ private:
 
     // Current state
     std::optional<int> m_editingShiftId;
-    QVector<Frontier::Shift> m_shifts;
 
     // Entry form
     QDateTimeEdit *m_startTimeEdit;
@@ -74,9 +77,12 @@ private:
     QLabel *m_totalShiftsLabel;
     QLabel *m_totalTimeLabel;
     QLabel *m_avgDurationLabel;
+    QLabel *m_weekTimeLabel;
+    QLabel *m_monthTimeLabel;
 
     // History table
-    QTableWidget *m_historyTable;
+    QTableView *m_historyTable;
+    ShiftLogModel *m_historyModel;
     QPushButton *m_editBtn;
     QPushButton *m_deleteBtn;
 };
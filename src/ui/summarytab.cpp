@@ -5,6 +5,8 @@
 
 #include "summarytab.h"
 #include "core/database.h"
+#include "core/transactionstore.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -32,7 +34,9 @@ SummaryTab::SummaryTab(Frontier::Database *database, QWidget *parent)
     , m_database(database)
 {
     setupUi();
-    refreshData();
+    // First load waits until the tab is first shown
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Transactions,
+                                      [this]() { refreshData(); }, true);
 }
 
 void SummaryTab::setupUi()
@@ -199,6 +203,8 @@ QWidget* SummaryTab::createBreakdownPanel()
 
 void SummaryTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("SummaryTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     onPeriodChanged();
 }
 
@@ -256,7 +262,8 @@ void SummaryTab::updateSummary()
     QDate from = m_fromDateEdit->date();
     QDate to = m_toDateEdit->date();
 
-    Frontier::FinanceSummary summary = m_database->getFinanceSummary(from, to);
+    // Scans the in-memory ledger columns; no query after the first load
+    Frontier::FinanceSummary summary = m_database->transactionStore().summary(from, to);
 
     // Update overview
     m_totalIncomeLabel->setText(formatCurrency(summary.totalIncome));
@@ -4,6 +4,7 @@
  */
 
 #include "vehiclespecstab.h"
+#include "core/tracing.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -17,6 +18,8 @@ VehicleSpecsTab::VehicleSpecsTab(Frontier::Database *database, QWidget *parent)
     , m_proxyModel(nullptr)
 {
     setupUi();
+    m_database->changeBus().subscribe(this, Frontier::DataTable::Vehicles,
+                                      [this]() { refreshData(); });
     loadCategories();
     loadVehicles();
 }
@@ -206,6 +209,8 @@ void VehicleSpecsTab::populateTable(const QVector<Frontier::Vehicle> &vehicles)
 
 void VehicleSpecsTab::refreshData()
 {
+    FRONTIER_TRACE_SCOPE("VehicleSpecsTab::refreshData");
+    m_database->changeBus().acknowledge(this);
     loadCategories();
     loadVehicles();
 }
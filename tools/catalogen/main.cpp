@@ -0,0 +1,174 @@
+/**
+ * @file main.cpp
+ * @brief frontier_catalogen - compiles the reference JSON into C++ tables
+ *
+ * Usage:
+ *   frontier_catalogen --items data/items.json --vehicles data/vehicles.json
+ *                      --buildings data/factory_buildings.json --out embeddedcatalog_data.cpp
+ *
+ * Run by the build (FRONTIER_EMBED_CATALOG). The files are read with the
+ * importers' own loaders, so the tables hold exactly what an import would
+ * write; the output defines Frontier::defaultCatalogData() (see
+ * src/core/embeddedcatalog.h) as constant data.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QLoggingCategory>
+#include <cstdio>
+
+#include "core/embeddedcatalog.h"
+#include "core/itemimporter.h"
+#include "core/vehicleimporter.h"
+#include "core/factorybuildingimporter.h"
+#include "core/referencesnapshot.h"
+
+namespace {
+
+// A narrow string literal of the UTF-8 bytes; everything but printable
+// ASCII is an octal escape, which cannot run into the next character
+QString literal(const QString &text)
+{
+    QString out = QStringLiteral("\"");
+    for (const char byte : text.toUtf8()) {
+        const auto c = static_cast<unsigned char>(byte);
+        if (c == '"' || c == '\\') {
+            out += QLatin1Char('\\');
+            out += QLatin1Char(char(c));
+        } else if (c >= 0x20 && c < 0x7f) {
+            out += QLatin1Char(char(c));
+        } else {
+            out += QStringLiteral("\\%1").arg(c, 3, 8, QLatin1Char('0'));
+        }
+    }
+    out += QLatin1Char('"');
+    return out;
+}
+
+// Shortest text that reads back as the same double
+QString number(double value)
+{
+    return QString::number(value, 'g', 17);
+}
+
+QString boolean(bool value)
+{
+    return value ? QStringLiteral("true") : QStringLiteral("false");
+}
+
+QString checksum(const QString &path)
+{
+    return literal(QString::fromLatin1(Frontier::ReferenceSnapshot::checksumFile(path).toHex()));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("frontier_catalogen");
+    QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compiles the reference JSON files into embedded catalog tables.");
+    parser.addHelpOption();
+
+    QCommandLineOption itemsOpt("items", "Items JSON.", "path");
+    QCommandLineOption vehiclesOpt("vehicles", "Vehicles JSON.", "path");
+    QCommandLineOption buildingsOpt("buildings", "Factory buildings JSON.", "path");
+    QCommandLineOption outOpt({"o", "out"}, "C++ source to write.", "path");
+    parser.addOptions({itemsOpt, vehiclesOpt, buildingsOpt, outOpt});
+    parser.process(app);
+
+    if (!parser.isSet(outOpt)) {
+        std::fprintf(stderr, "--out is required\n");
+        return 1;
+    }
+
+    // A missing file gives an empty table, which seeds nothing
+    const QString itemsPath = parser.value(itemsOpt);
+    const QString vehiclesPath = parser.value(vehiclesOpt);
+    const QString buildingsPath = parser.value(buildingsOpt);
+    const QVector<Frontier::Item> items =
+        itemsPath.isEmpty() ? QVector<Frontier::Item>() : Frontier::ItemImporter::loadFromJson(itemsPath);
+    const QVector<Frontier::Vehicle> vehicles =
+        vehiclesPath.isEmpty() ? QVector<Frontier::Vehicle>() : Frontier::VehicleImporter::loadFromJson(vehiclesPath);
+    QString error;
+    const QVector<Frontier::FactoryBuilding> buildings = buildingsPath.isEmpty()
+        ? QVector<Frontier::FactoryBuilding>()
+        : Frontier::FactoryBuildingImporter::loadFromJson(buildingsPath, &error);
+    if (!error.isEmpty()) {
+        std::fprintf(stderr, "%s: %s\n", qPrintable(buildingsPath), qPrintable(error));
+        return 1;
+    }
+
+    QSaveFile file(parser.value(outOpt));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        std::fprintf(stderr, "Cannot write %s: %s\n", qPrintable(file.fileName()),
+                     qPrintable(file.errorString()));
+        return 1;
+    }
+
+    QTextStream out(&file);
+    out << "// Generated by frontier_catalogen from the reference JSON files. Do not edit.\n\n"
+        << "#include \"core/embeddedcatalog.h\"\n\n"
+        << "namespace Frontier {\n\nnamespace {\n\n";
+
+    out << "const EmbeddedItem Items[] = {\n";
+    for (const Frontier::Item &item : items) {
+        out << "    {" << literal(item.code) << ", " << literal(item.name) << ", "
+            << literal(item.categoryMain) << ", " << literal(item.categorySub) << ", "
+            << number(item.buyPriceInternal) << ", " << number(item.buyPriceDisplay) << ", "
+            << number(item.sellPriceInternal) << ", " << number(item.sellPriceDisplay) << ", "
+            << number(item.weight) << ", "
+            << (item.pricingGroup == Frontier::PricingGroup::Custom ? "PricingGroup::Custom"
+                                                                    : "PricingGroup::Base70")
+            << ", " << boolean(item.isPurchasable) << ", " << boolean(item.isSellable) << ", "
+            << boolean(item.isCraftable) << ", " << literal(item.notes) << "},\n";
+    }
+    // Zero-length arrays are ill-formed; the counts below exclude the sentinel
+    out << "    {}\n};\n\n";
+
+    out << "const EmbeddedVehicle Vehicles[] = {\n";
+    for (const Frontier::Vehicle &vehicle : vehicles) {
+        out << "    {" << literal(vehicle.id) << ", " << literal(vehicle.name) << ", "
+            << literal(vehicle.categoryMain) << ", " << literal(vehicle.categorySub) << ", "
+            << number(vehicle.bucketCapacityM3) << ", " << number(vehicle.truckCapacityM3) << ", "
+            << number(vehicle.tankCapacityL) << ", " << number(vehicle.fuelUseLPerHour) << ", "
+            << number(vehicle.purchasePrice) << ", " << boolean(vehicle.active) << ", "
+            << literal(vehicle.notes) << "},\n";
+    }
+    out << "    {}\n};\n\n";
+
+    out << "const EmbeddedBuilding Buildings[] = {\n";
+    for (const Frontier::FactoryBuilding &building : buildings) {
+        out << "    {" << literal(building.name) << ", " << literal(building.category) << ", "
+            << literal(building.dimensions) << ", " << literal(building.speed) << ", "
+            << number(building.powerKw) << ", " << number(building.generatedKw) << ", "
+            << number(building.capacity) << ", " << building.connections << ", "
+            << number(building.price) << ", " << literal(building.notes) << "},\n";
+    }
+    out << "    {}\n};\n\n";
+
+    out << "} // namespace\n\n"
+        << "const EmbeddedCatalogData &defaultCatalogData()\n{\n"
+        << "    static const EmbeddedCatalogData data = {\n"
+        << "        Items, " << items.size() << ", " << checksum(itemsPath) << ",\n"
+        << "        Vehicles, " << vehicles.size() << ", " << checksum(vehiclesPath) << ",\n"
+        << "        Buildings, " << buildings.size() << ", " << checksum(buildingsPath) << ",\n"
+        << "    };\n    return data;\n}\n\n"
+        << "} // namespace Frontier\n";
+    out.flush();
+
+    if (!file.commit()) {
+        std::fprintf(stderr, "Cannot write %s: %s\n", qPrintable(file.fileName()),
+                     qPrintable(file.errorString()));
+        return 1;
+    }
+    std::printf("Embedded %lld items, %lld vehicles and %lld buildings\n",
+                static_cast<long long>(items.size()), static_cast<long long>(vehicles.size()),
+                static_cast<long long>(buildings.size()));
+    return 0;
+}
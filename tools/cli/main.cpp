@@ -0,0 +1,395 @@
+/**
+ * @file main.cpp
+ * @brief frontier_cli - headless imports, reconciliation and reports
+ *
+ * Usage:
+ *   frontier_cli [--db tracker.db] [--format csv|json] [--out file] <command> ...
+ *
+ *   import <folder>                 Reference data (items.json, vehicles.json, ...)
+ *   reconcile <save.sav>...         Save history against the ledger
+ *   report finance                  Income, expenses and net profit by month
+ *   report production               Production history with today's prices
+ *   archive <year>                  Move a closed year to its archive file
+ *   export <table> --out file       Stream transactions, fuel, production,
+ *                                   shifts or cycles to a file
+ *
+ * Tables go to --out or stdout, progress and summaries to stderr, so the
+ * output can be piped. reconcile exits with 2 when it finds discrepancies
+ * and 1 when a save cannot be read.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <cstdio>
+
+#include "core/database.h"
+#include "core/dataexporter.h"
+#include "core/importpipeline.h"
+#include "core/itemcatalog.h"
+#include "core/reconciler.h"
+#include "core/saveparser.h"
+
+namespace {
+
+enum ExitCode {
+    ExitOk = 0,
+    ExitError = 1,
+    ExitDiscrepancies = 2
+};
+
+// =============================================================================
+// Output
+// =============================================================================
+
+/**
+ * @brief Rows with named columns, written as CSV or a JSON array of objects
+ */
+struct Table {
+    QStringList columns;
+    QVector<QVariantList> rows;
+
+    void addRow(QVariantList row) { rows.append(std::move(row)); }
+};
+
+QString csvField(const QVariant &value)
+{
+    QString text = value.typeId() == QMetaType::Double
+                       ? QString::number(value.toDouble(), 'f', 2)
+                       : value.toString();
+    if (text.contains(QLatin1Char(',')) || text.contains(QLatin1Char('"'))
+        || text.contains(QLatin1Char('\n'))) {
+        text.replace(QLatin1String("\""), QLatin1String("\"\""));
+        text = QLatin1Char('"') + text + QLatin1Char('"');
+    }
+    return text;
+}
+
+QByteArray renderCsv(const Table &table)
+{
+    QString out;
+    QTextStream stream(&out);
+    stream << table.columns.join(QLatin1Char(',')) << '\n';
+    for (const QVariantList &row : table.rows) {
+        QStringList fields;
+        fields.reserve(row.size());
+        for (const QVariant &value : row) {
+            fields.append(csvField(value));
+        }
+        stream << fields.join(QLatin1Char(',')) << '\n';
+    }
+    stream.flush();
+    return out.toUtf8();
+}
+
+QByteArray renderJson(const Table &table)
+{
+    QJsonArray array;
+    for (const QVariantList &row : table.rows) {
+        QJsonObject object;
+        for (int i = 0; i < table.columns.size() && i < row.size(); ++i) {
+            object.insert(table.columns[i], QJsonValue::fromVariant(row[i]));
+        }
+        array.append(object);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Indented);
+}
+
+bool writeTable(const Table &table, const QString &format, const QString &outPath)
+{
+    const QByteArray bytes = format == QLatin1String("json") ? renderJson(table) : renderCsv(table);
+
+    if (outPath.isEmpty() || outPath == QLatin1String("-")) {
+        std::fwrite(bytes.constData(), 1, size_t(bytes.size()), stdout);
+        return true;
+    }
+
+    QFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(bytes) != bytes.size()) {
+        std::fprintf(stderr, "Could not write %s: %s\n", qPrintable(outPath),
+                     qPrintable(file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+QDate parseDate(const QString &text, const QDate &fallback)
+{
+    if (text.isEmpty()) {
+        return fallback;
+    }
+    return QDate::fromString(text, Qt::ISODate);
+}
+
+// =============================================================================
+// Commands
+// =============================================================================
+
+int runImport(Frontier::Database &database, const QString &folder, Table &table)
+{
+    const Frontier::ReferenceSources sources = Frontier::ReferenceSources::fromDirectory(folder);
+    if (sources.isEmpty()) {
+        std::fprintf(stderr, "No reference files found in %s\n", qPrintable(folder));
+        return ExitError;
+    }
+
+    // The pipeline parses on the thread pool and writes from the event loop
+    Frontier::ImportPipeline pipeline(&database);
+    QEventLoop loop;
+    QObject::connect(&pipeline, &Frontier::ImportPipeline::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&pipeline, &Frontier::ImportPipeline::stageFinished,
+                     [](const Frontier::ImportStageResult &result) {
+        std::fprintf(stderr, "%s: %s\n", qPrintable(Frontier::referenceDataToString(result.data)),
+                     qPrintable(result.summary));
+    });
+    if (!pipeline.start(sources)) {
+        std::fprintf(stderr, "Import could not start\n");
+        return ExitError;
+    }
+    loop.exec();
+
+    table.columns = {"data", "ok", "summary"};
+    bool allOk = true;
+    for (const Frontier::ImportStageResult &result : pipeline.results()) {
+        table.addRow({Frontier::referenceDataToString(result.data), result.ok, result.summary});
+        allOk = allOk && result.ok;
+    }
+    return allOk ? ExitOk : ExitError;
+}
+
+int runReconcile(Frontier::Database &database, const QStringList &savePaths, int bucketDays,
+                 Table &table)
+{
+    // The ledger is read once however many saves are checked against it
+    const QVector<Frontier::Transaction> ledger = database.getAllTransactions();
+    const Frontier::ItemCatalog &catalog = database.itemCatalog();
+    const Frontier::Reconciler reconciler(catalog);
+
+    Frontier::ReconcileOptions options;
+    options.bucketDays = qMax(1, bucketDays);
+
+    table.columns = {"save", "kind", "item", "date", "save_amount", "ledger_amount", "ledger_id"};
+    int result = ExitOk;
+    for (const QString &savePath : savePaths) {
+        const Frontier::SaveGameData save = Frontier::SaveParser::parseFile(savePath);
+        if (!save.valid) {
+            std::fprintf(stderr, "Could not read %s: %s\n", qPrintable(savePath), qPrintable(save.error));
+            result = ExitError;
+            continue;
+        }
+
+        const Frontier::ReconcileReport report = reconciler.reconcile(save.transactions, ledger, options);
+        for (const Frontier::ReconcileIssue &issue : report.issues) {
+            const Frontier::SaveTransaction *tx =
+                issue.saveIndex >= 0 ? &save.transactions[issue.saveIndex] : nullptr;
+            const Frontier::Transaction *trans = issue.ledgerIndex >= 0 ? &ledger[issue.ledgerIndex] : nullptr;
+
+            QString itemName;
+            QDate date;
+            if (trans) {
+                itemName = trans->item;
+                date = trans->date;
+            }
+            if (tx) {
+                const Frontier::Item *item = catalog.findByCode(tx->itemCode);
+                itemName = item ? item->name : tx->itemCode;
+                if (tx->time.isValid()) {
+                    date = tx->time.toLocalTime().date();
+                }
+            }
+
+            table.addRow({savePath,
+                          Frontier::reconcileIssueKindToString(issue.kind),
+                          itemName,
+                          date.toString(Qt::ISODate),
+                          tx ? QVariant(qint64(tx->amount)) : QVariant(),
+                          trans ? QVariant(Frontier::Reconciler::ledgerAmount(*trans)) : QVariant(),
+                          trans && trans->id ? QVariant(*trans->id) : QVariant()});
+        }
+
+        std::fprintf(stderr, "%s: %d of %d save transactions matched, %d issue(s)\n",
+                     qPrintable(savePath), report.matched, int(save.transactions.size()),
+                     int(report.issues.size()));
+        if (!report.issues.isEmpty() && result == ExitOk) {
+            result = ExitDiscrepancies;
+        }
+    }
+    return result;
+}
+
+int runArchive(Frontier::Database &database, const QString &yearText, Table &table)
+{
+    bool ok = false;
+    const int year = yearText.toInt(&ok);
+    if (!ok || !database.archiveYear(year)) {
+        std::fprintf(stderr, "Could not archive %s: %s\n", qPrintable(yearText),
+                     qPrintable(ok ? database.lastError() : QString("not a year")));
+        return ExitError;
+    }
+
+    table.columns = {"year", "transactions", "fuel_entries", "production_runs",
+                     "company_balance", "personal_balance", "file"};
+    for (const Frontier::ArchivedYear &archived : database.archivedYears()) {
+        table.addRow({archived.year, archived.transactions, archived.fuelEntries, archived.productionRuns,
+                      archived.carriedForward.companyBalance, archived.carriedForward.personalBalance,
+                      database.archivePath(archived.year)});
+    }
+    return ExitOk;
+}
+
+int runExport(Frontier::Database &database, const QString &name, const QDate &from, const QDate &to,
+              const QString &format, const QString &path)
+{
+    static const QMap<QString, Frontier::DataTable> tables = {
+        {"transactions", Frontier::DataTable::Transactions},
+        {"fuel", Frontier::DataTable::FuelLog},
+        {"production", Frontier::DataTable::Production},
+        {"shifts", Frontier::DataTable::Shifts},
+        {"cycles", Frontier::DataTable::CycleTimes},
+    };
+    if (!tables.contains(name) || path.isEmpty()) {
+        std::fprintf(stderr, "export needs one of transactions, fuel, production, shifts or cycles, and --out\n");
+        return ExitError;
+    }
+
+    Frontier::ExportRequest request;
+    request.table = tables.value(name);
+    request.from = from;
+    request.to = to;
+    request.path = path;
+    request.format = format == QLatin1String("json") ? Frontier::ExportFormat::Json
+                                                     : Frontier::ExportFormat::Csv;
+
+    // Rows go straight to the file rather than through a Table
+    const std::atomic_bool cancelled(false);
+    const Frontier::ExportResult result = Frontier::DataExporter::exportTo(database, request, cancelled);
+    if (!result.ok) {
+        std::fprintf(stderr, "Could not export %s: %s\n", qPrintable(name), qPrintable(result.error));
+        return ExitError;
+    }
+    std::fprintf(stderr, "Exported %lld rows to %s\n", static_cast<long long>(result.rows), qPrintable(path));
+    return ExitOk;
+}
+
+int runFinanceReport(Frontier::Database &database, const QDate &from, const QDate &to, Table &table)
+{
+    table.columns = {"month", "income", "expenses", "net_profit"};
+    const QMap<QDate, Frontier::FinanceSummary> months = database.getFinanceSummariesByMonth(from, to);
+    for (auto it = months.constBegin(); it != months.constEnd(); ++it) {
+        table.addRow({it.key().toString("yyyy-MM"), it->totalIncome, it->totalExpenses, it->netProfit});
+    }
+    return ExitOk;
+}
+
+int runProductionReport(Frontier::Database &database, const QDate &from, const QDate &to, Table &table)
+{
+    table.columns = {"id", "timestamp", "recipe", "workbench", "runs", "output_qty",
+                     "input_cost", "output_value", "profit"};
+    for (const Frontier::ProductionRun &run : database.getProductionHistory()) {
+        const QDate day = run.timestamp.date();
+        if (day < from || day > to) {
+            continue;
+        }
+        table.addRow({run.id.value_or(0), run.timestamp.toString(Qt::ISODate), run.recipeName,
+                      run.workbenchName, run.quantity, run.totalOutputQty(), run.totalInputCost(),
+                      run.totalOutputValue(), run.profit()});
+    }
+    return ExitOk;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("frontier_cli");
+    QCoreApplication::setOrganizationName("Frontier");
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless Frontier Mining Tracker tasks.\n\n"
+        "Commands:\n"
+        "  import <folder>          Import reference data files from a folder\n"
+        "  reconcile <save.sav>...  Match saves' transaction history against the ledger\n"
+        "  report finance           Monthly income, expenses and net profit\n"
+        "  report production        Production history with today's prices\n"
+        "  archive <year>           Move a closed year to its own archive file\n"
+        "  export <table>           Stream transactions, fuel, production, shifts or\n"
+        "                           cycles to --out (all dates unless --from/--to)");
+    parser.addHelpOption();
+
+    QCommandLineOption dbOpt("db", "Database file.", "path", "frontier_mining.db");
+    QCommandLineOption formatOpt("format", "Output format: csv or json.", "format", "csv");
+    QCommandLineOption outOpt({"o", "out"}, "Output file (default stdout).", "path");
+    QCommandLineOption fromOpt("from", "First day of a report (yyyy-MM-dd).", "date");
+    QCommandLineOption toOpt("to", "Last day of a report (yyyy-MM-dd, default today).", "date");
+    QCommandLineOption bucketOpt("bucket-days", "Reconcile time bucket width in days.", "n", "1");
+    parser.addOptions({dbOpt, formatOpt, outOpt, fromOpt, toOpt, bucketOpt});
+    parser.addPositionalArgument("command", "import, reconcile, report, archive or export.");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.value(0);
+    const QString format = parser.value(formatOpt).toLower();
+    if (format != QLatin1String("csv") && format != QLatin1String("json")) {
+        std::fprintf(stderr, "Unknown format %s (use csv or json)\n", qPrintable(format));
+        return ExitError;
+    }
+
+    const QDate today = QDate::currentDate();
+    const QDate to = parseDate(parser.value(toOpt), today);
+    const QDate from = parseDate(parser.value(fromOpt), QDate(to.year() - 1, to.month(), 1).addMonths(1));
+    if (!from.isValid() || !to.isValid()) {
+        std::fprintf(stderr, "Dates must be yyyy-MM-dd\n");
+        return ExitError;
+    }
+
+    const QString dbPath = parser.value(dbOpt);
+    if (command != QLatin1String("import") && !QFile::exists(dbPath)) {
+        std::fprintf(stderr, "%s does not exist\n", qPrintable(dbPath));
+        return ExitError;
+    }
+
+    // initialize() also brings an older file up to the current schema
+    Frontier::Database database;
+    if (!database.initialize(dbPath)) {
+        std::fprintf(stderr, "Could not open %s: %s\n", qPrintable(dbPath),
+                     qPrintable(database.lastError()));
+        return ExitError;
+    }
+
+    Table table;
+    int result = ExitError;
+    if (command == QLatin1String("import") && args.size() == 2) {
+        result = runImport(database, args[1], table);
+    } else if (command == QLatin1String("reconcile") && args.size() >= 2) {
+        result = runReconcile(database, args.mid(1), parser.value(bucketOpt).toInt(), table);
+    } else if (command == QLatin1String("report") && args.value(1) == QLatin1String("finance")) {
+        result = runFinanceReport(database, from, to, table);
+    } else if (command == QLatin1String("report") && args.value(1) == QLatin1String("production")) {
+        result = runProductionReport(database, from, to, table);
+    } else if (command == QLatin1String("archive") && args.size() == 2) {
+        result = runArchive(database, args[1], table);
+    } else if (command == QLatin1String("export") && args.size() == 2) {
+        // Exports default to every row rather than the report window
+        const QDate exportFrom = parser.isSet(fromOpt) ? from : QDate();
+        const QDate exportTo = parser.isSet(toOpt) ? to : QDate();
+        result = runExport(database, args[1], exportFrom, exportTo, format, parser.value(outOpt));
+    } else {
+        std::fprintf(stderr, "Unknown command; see --help\n");
+        return ExitError;
+    }
+
+    if (!table.columns.isEmpty() && !writeTable(table, format, parser.value(outOpt))) {
+        result = ExitError;
+    }
+    database.close();
+    return result;
+}
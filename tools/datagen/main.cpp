@@ -0,0 +1,119 @@
+/**
+ * @file main.cpp
+ * @brief frontier_datagen - writes a large synthetic frontier_mining.db
+ *
+ * Usage:
+ *   frontier_datagen --out big.db --years 5 --transactions-per-day 80
+ *
+ * The catalog defaults to the repository's data/ files, so the generated
+ * database opens in the app with real item, vehicle and building names.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <cstdio>
+
+#include "core/database.h"
+#include "core/syntheticdata.h"
+
+#ifndef FRONTIER_DATA_DIR
+#define FRONTIER_DATA_DIR "data"
+#endif
+#ifndef FRONTIER_TOOLS_DIR
+#define FRONTIER_TOOLS_DIR "tools"
+#endif
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("frontier_datagen");
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    Frontier::SyntheticDataOptions defaults;
+    const QString dataDir = QString::fromUtf8(FRONTIER_DATA_DIR);
+    const QString toolsDir = QString::fromUtf8(FRONTIER_TOOLS_DIR);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a synthetic Frontier Mining Tracker database.");
+    parser.addHelpOption();
+
+    QCommandLineOption outOpt({"o", "out"}, "Database file to create.", "path", "frontier_mining.db");
+    QCommandLineOption forceOpt({"f", "force"}, "Overwrite the output file if it exists.");
+    QCommandLineOption itemsOpt("items", "Items JSON (empty for synthetic items).", "path",
+                                dataDir + "/items.json");
+    QCommandLineOption vehiclesOpt("vehicles", "Vehicles JSON (empty for a synthetic fleet).", "path",
+                                   dataDir + "/vehicles.json");
+    QCommandLineOption buildingsOpt("buildings", "Factory buildings JSON (empty to skip).", "path",
+                                    dataDir + "/factory_buildings.json");
+    QCommandLineOption recipesOpt("recipes", "Workbench recipes JSON (empty for synthetic recipes).",
+                                  "path", toolsDir + "/workbenches.json");
+    QCommandLineOption yearsOpt("years", "Years of history to generate.", "n",
+                                QString::number(defaults.years));
+    QCommandLineOption txOpt("transactions-per-day", "Average ledger rows per day.", "n",
+                             QString::number(defaults.transactionsPerDay));
+    QCommandLineOption shiftsOpt("shifts-per-week", "Work days per week (0-7).", "n",
+                                 QString::number(defaults.shiftsPerWeek));
+    QCommandLineOption runsOpt("runs-per-shift", "Production runs per shift.", "n",
+                               QString::number(defaults.productionRunsPerShift));
+    QCommandLineOption cyclesOpt("cycles-per-shift", "Haul cycle records per shift.", "n",
+                                 QString::number(defaults.cycleRecordsPerShift));
+    QCommandLineOption fuelOpt("fuel-per-shift", "Fuel log entries per shift.", "n",
+                               QString::number(defaults.fuelEntriesPerShift));
+    QCommandLineOption seedOpt("seed", "Random seed.", "n", QString::number(defaults.seed));
+
+    parser.addOptions({outOpt, forceOpt, itemsOpt, vehiclesOpt, buildingsOpt, recipesOpt,
+                       yearsOpt, txOpt, shiftsOpt, runsOpt, cyclesOpt, fuelOpt, seedOpt});
+    parser.process(app);
+
+    const QString outPath = parser.value(outOpt);
+    if (QFile::exists(outPath)) {
+        if (!parser.isSet(forceOpt)) {
+            std::fprintf(stderr, "%s already exists; pass --force to replace it\n", qPrintable(outPath));
+            return 1;
+        }
+        QFile::remove(outPath);
+    }
+
+    Frontier::SyntheticDataOptions options;
+    options.itemsJson = parser.value(itemsOpt);
+    options.vehiclesJson = parser.value(vehiclesOpt);
+    options.buildingsJson = parser.value(buildingsOpt);
+    options.recipesJson = parser.value(recipesOpt);
+    options.years = parser.value(yearsOpt).toInt();
+    options.transactionsPerDay = parser.value(txOpt).toInt();
+    options.shiftsPerWeek = qBound(0, parser.value(shiftsOpt).toInt(), 7);
+    options.productionRunsPerShift = parser.value(runsOpt).toInt();
+    options.cycleRecordsPerShift = parser.value(cyclesOpt).toInt();
+    options.fuelEntriesPerShift = parser.value(fuelOpt).toInt();
+    options.seed = parser.value(seedOpt).toUInt();
+
+    Frontier::Database database;
+    if (!database.initialize(outPath)) {
+        std::fprintf(stderr, "Could not create %s: %s\n", qPrintable(outPath),
+                     qPrintable(database.lastError()));
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    Frontier::SyntheticDataGenerator generator(&database);
+    if (!generator.generate(options)) {
+        std::fprintf(stderr, "Generation failed: %s\n", qPrintable(generator.lastError()));
+        return 1;
+    }
+    database.close();
+
+    const auto &stats = generator.stats();
+    std::printf("Wrote %s in %.1f s (%.1f MB)\n", qPrintable(outPath), timer.elapsed() / 1000.0,
+                QFileInfo(outPath).size() / (1024.0 * 1024.0));
+    std::printf("  items %d, vehicles %d, buildings %d, recipes %d, inventory %d\n",
+                stats.items, stats.vehicles, stats.buildings, stats.recipes, stats.inventoryRows);
+    std::printf("  transactions %d, shifts %d, sessions %d, production runs %d\n",
+                stats.transactions, stats.shifts, stats.movementSessions, stats.productionRuns);
+    std::printf("  cycle records %d, fuel entries %d\n", stats.cycleRecords, stats.fuelEntries);
+    return 0;
+}